@@ -4,14 +4,23 @@
 #include <vector>
 #include <map>
 #include <memory>
+#include <memory_resource>
+#include <optional>
+#include <utility>
 #include <nlohmann/json.hpp> // For strategy config
 
 // Required project headers (use short paths)
 #include "datatypes.hpp"
-#include "database_manager.hpp" // Needs DatabaseManager definition
+#include "candle_source.hpp"    // Candle storage interface (SQLite or columnar files)
 #include "interfaces.hpp"       // Strategy engine interfaces
 #include "indicators.hpp"       // Indicator interface
+#include "indicator_cache.hpp"  // Shared computed indicator series
 #include "portfolio.hpp"        // Portfolio class
+#include "candle_data_cache.hpp" // Shared read-only candle data
+#include "thread_pool.hpp"       // Parallel instrument evaluation
+#include "arena.hpp"             // Per-run memory for strategies, results and scratch
+#include "run_stats.hpp"         // Phase timings and counters of a run
+#include "execution_model.hpp"   // Fill timing, resting orders, slippage and fees
 
 // Forward declare specific indicator classes needed for creation
 // Alternatively, include them all or use a factory later
@@ -21,42 +30,211 @@ namespace backtester {
 
     using json = nlohmann::json;
 
+    // How the strategy is evaluated over the bars of a run
+    enum class EvaluationMode {
+        PerBar,     // IStrategy::evaluate() once per bar (reference path)
+        Vectorized  // IStrategy::generateSignals() over whole columns; falls back to PerBar if unsupported
+    };
+
+    // Streaming run: candles are loaded and processed one time window at a time, so
+    // memory is bounded by the chunk (plus warm-up) instead of the whole history.
+    // Each window spans chunk_bars bar intervals of the primary timeframe, so no
+    // instrument loads more than chunk_bars new bars at once. Indicators are
+    // recalculated per chunk over the carried warm-up bars plus the new ones.
+    //
+    // Carrying max lookback + 1 bars reproduces window indicators (SMA, WMA, BBANDS,
+    // STOCH, ...) up to floating-point rounding. Recursive ones (EMA, RSI, MACD,
+    // ATR, ADX, SUPERTREND) and session-anchored VWAP depend on all earlier bars
+    // and only converge to the full-history values. With warmup_bars = 0 a run with
+    // recursive indicators carries about 10 periods of them (10 x (lookback + 1));
+    // a smaller explicit warmup_bars is used as given, with a warning naming them.
+    // Higher-timeframe indicators are not supported.
+    struct StreamingOptions {
+        std::size_t chunk_bars = 100'000; // Bar intervals per chunk window
+        std::size_t warmup_bars = 0;      // Bars carried into the next chunk (at least max lookback + 1; 0 = automatic)
+        bool keep_equity_curve = false;   // Also keep the full equity curve (grows with the history)
+    };
+
+    // Runs one strategy over one or more instruments against a single shared Portfolio.
+    // Every instrument gets its own strategy instance (position state) and indicators;
+    // the per-instrument bar streams are merged by timestamp so trades and equity
+    // are recorded in global time order.
     class Backtester {
     public:
-        // Constructor requires a database connection reference
-        explicit Backtester(data::DatabaseManager& db_manager, double initial_capital = 100000.0);
+        // Constructor requires a candle source reference (e.g. data::DatabaseManager)
+        explicit Backtester(data::ICandleSource& candle_source, double initial_capital = 100000.0);
 
         // Main execution function
         bool run(const json& strategy_config,
                  const std::string& start_date, // Format: YYYY-MM-DD
                  const std::string& end_date);   // Format: YYYY-MM-DD
 
-        // --- TODO: Add methods to get results ---
+        // --- Results ---
         const Portfolio& getPortfolio() const; // Return portfolio details
-        // BacktestMetrics getMetrics() const; // Define BacktestMetrics struct
+        const BacktestMetrics& getMetrics() const { return metrics_; } // Metrics of the last run
+        // Phase timings and event loop counters of the last run (also after a failed run)
+        const BacktestRunStats& getRunStats() const { return run_stats_; }
+
+        // Converts YYYY-MM-DD dates to the start/end-of-day (+05:30) range used for DB queries
+        static std::pair<core::Timestamp, core::Timestamp> queryRangeForDates(const std::string& start_date,
+                                                                              const std::string& end_date);
+
+        // Expands an optional "universe" block ({"index": "<index_key>", "as_of": "YYYY-MM-DD"})
+        // into the "instruments" list using the source's index constituents as of 'as_of'
+        // (default: start_date), or ({"exchange": "NSE", "segment": "NSE_EQ"}) using the
+        // instrument master; with both, index members listed there. Explicit instruments
+        // are kept, duplicates dropped.
+        // Returns the config unchanged if it has no universe. Throws core::ConfigException
+        // if the universe resolves to no instruments.
+        static json resolveUniverse(data::ICandleSource& candle_source, const json& strategy_config,
+                                    const std::string& start_date);
+
+        // Share loaded candles with other Backtester instances (e.g. parameter sweeps).
+        // When set, loadData() goes through the cache instead of querying the DB each run.
+        void setDataCache(std::shared_ptr<CandleDataCache> cache) { data_cache_ = std::move(cache); }
+        // Share computed indicator series between runs. Without a cache each run
+        // calculates its own indicators.
+        void setIndicatorCache(std::shared_ptr<indicators::IndicatorCache> cache) { indicator_cache_ = std::move(cache); }
+        void setEvaluationMode(EvaluationMode mode) { evaluation_mode_ = mode; }
+        EvaluationMode getEvaluationMode() const { return evaluation_mode_; }
+        // Threads used to load instruments, calculate indicators and evaluate instruments
+        // concurrently (0 = all cores, default 1).
+        // Loads run in parallel only if the candle source supports concurrent queries.
+        // Only strategy evaluation runs in parallel; Portfolio updates stay on the loop thread.
+        void setInstrumentThreads(std::size_t num_threads) { instrument_threads_ = num_threads; }
+        // Trade only bars in [from, to] while loading and computing indicators over the
+        // whole run() range, so windows of one history share cached candles and
+        // indicator series, and indicators are warm at the window start
+        void setEvaluationRange(core::Timestamp from, core::Timestamp to) { evaluation_range_ = std::make_pair(from, to); }
+        void clearEvaluationRange() { evaluation_range_.reset(); }
+        // Run in bounded-memory chunks (see StreamingOptions). Streaming runs do not use
+        // the data or indicator caches; metrics come from the Portfolio's running
+        // MetricsAccumulator; only the trade log grows with the number of trades.
+        void setStreaming(const StreamingOptions& options) { streaming_ = options; }
+        void clearStreaming() { streaming_.reset(); }
+        // End the bar loop as soon as the running metrics meet one of the criteria
+        // (e.g. to prune hopeless sweep combinations). Metrics then cover the run up
+        // to that point and have stopped_early set.
+        void setStopCriteria(const StopCriteria& criteria) { stop_criteria_ = criteria; }
+        void clearStopCriteria() { stop_criteria_.reset(); }
 
     private:
-        data::DatabaseManager& db_manager_; // Use reference, doesn't own it
+        // Everything owned per instrument. Only the Portfolio is shared between instruments.
+        struct InstrumentState {
+            InstrumentState() = default;
+            explicit InstrumentState(std::pmr::memory_resource* memory) : current_values(memory), previous_values(memory) {}
+
+            std::string instrument_key;
+            std::unique_ptr<strategy_engine::IStrategy> strategy; // Own position state machine
+            // Loaded candles; shared pointer so cached series are never copied per run
+            CandleDataCache::SeriesPtr data;
+            // Indicators indexed by the slot the strategy assigned
+            // (same order as IStrategy::getRequiredIndicatorNames())
+            std::vector<std::unique_ptr<indicators::IIndicator>> indicators;
+            // Results per slot (offset by each indicator's lookback). Shared and
+            // immutable, possibly owned by the indicator cache.
+            std::vector<indicators::IndicatorCache::ResultPtr> indicator_results;
+            // Base bar of indicator_results[slot][0]: the lookback for base-timeframe
+            // indicators, the first bar a completed higher-timeframe value exists otherwise
+            std::vector<std::size_t> result_offsets;
+            std::size_t first_bar = 0; // First bar with every indicator available (max offset)
+            std::size_t end_bar = 0;   // One past the last bar the event loop visits
+            // Streaming: leading bars of 'data' carried over from the previous chunk
+            // (already evaluated), and the run-wide index of data bar 0 (order expiry
+            // counts run-wide bars)
+            std::size_t carried_bars = 0;
+            std::size_t bar_base = 0;
+
+            // --- Event loop state ---
+            std::size_t next_bar = 0;             // Next bar the merge will visit
+            bool use_signals = false;             // Signals were precomputed (vectorized mode)
+            std::vector<strategy_engine::SignalEvent> signals;
+            std::size_t next_signal = 0;
+            std::pmr::vector<double> current_values;   // Per-bar snapshot buffers (per-bar mode)
+            std::pmr::vector<double> previous_values;
+            core::Candle current_candle;
+            core::Candle previous_candle;
+            InstrumentId portfolio_id = 0;        // Index into the Portfolio's arrays and the loop's price array
+            bool active = false;                  // Part of the current event loop
+            OrderBook orders;                     // Resting orders (next-open, limit/stop entries, stops/targets)
+        };
+
+        data::ICandleSource& candle_source_; // Use reference, doesn't own it
         double initial_capital_;
+        // Holds the current run's strategy rule trees, equity curve, trade log and
+        // snapshot buffers. Declared before their owners so it outlives them.
+        core::Arena arena_;
         std::unique_ptr<Portfolio> portfolio_;
-        std::unique_ptr<strategy_engine::IStrategy> strategy_;
-
-        // Store required indicators, mapped by name (e.g., "SMA(10)")
-        std::map<std::string, std::unique_ptr<indicators::IIndicator>> indicators_;
-        // Store loaded historical data (simplified: one primary instrument/timeframe)
-        core::TimeSeries<core::Candle> primary_data_;
-        std::string primary_instrument_key_; // Store which instrument was loaded
-        // Store calculated indicator results aligned with primary_data_
-         std::map<std::string, core::TimeSeries<double>> indicator_results_;
+        std::vector<InstrumentState> instruments_; // In strategy "instruments" order
+        std::string primary_timeframe_;            // Timeframe loaded for every instrument
+        core::Timestamp query_start_;              // DB query range of the loaded data (cache key)
+        core::Timestamp query_end_;
+        std::shared_ptr<CandleDataCache> data_cache_; // Optional, shared between runs
+        std::shared_ptr<indicators::IndicatorCache> indicator_cache_; // Optional, shared between runs
+        BacktestMetrics metrics_;
+        BacktestRunStats run_stats_;
+        ClockReading run_start_;                   // Start of the current run, origin of phase times
+        EvaluationMode evaluation_mode_ = EvaluationMode::Vectorized;
+        ExecutionConfig execution_;                // From the strategy's "execution" block
+        std::vector<OrderFill> fills_;             // Per-bar scratch for OrderBook::match
+        std::optional<std::pair<core::Timestamp, core::Timestamp>> evaluation_range_; // Unset = whole range
+        std::size_t instrument_threads_ = 1;
+        std::unique_ptr<core::ThreadPool> pool_; // Created by run() when threads > 1
+        std::optional<StreamingOptions> streaming_; // Unset = load the whole range at once
+        std::optional<StopCriteria> stop_criteria_; // Unset = always run to the end
+        const char* stop_reason_ = nullptr;         // Criterion that ended the current run
 
 
         // --- Private Helper Methods ---
+        bool createStrategies(const json& strategy_config);
         bool loadData(const std::string& start_date, const std::string& end_date);
+        // Streaming counterpart of loadData + indicators + event loop, chunk by chunk
+        bool runStreaming(const std::string& start_date, const std::string& end_date);
+        // Bars [from, to] of every instrument still in the streaming run, appended to
+        // the bars it carries; queried concurrently if the source allows it
+        void loadChunk(core::Timestamp from, core::Timestamp to);
+        // One indicator of one instrument and timeframe, with every slot reading one of
+        // its outputs. Jobs only read shared candles and write their own slots, so they
+        // run concurrently.
+        struct IndicatorJob {
+            InstrumentState* instrument = nullptr;
+            std::string spec;      // Canonical indicator name, e.g. "MACD(12,26,9)"
+            std::string timeframe; // Empty = base bars
+            std::vector<std::pair<std::size_t, std::size_t>> slots; // (slot, output index)
+            std::string error;     // Set instead of throwing; the instrument is then excluded
+        };
+
         bool createAndCalculateIndicators();
+        // Creates the instrument's indicators, sizes its slots and appends its jobs
+        bool planIndicators(InstrumentState& instrument, std::vector<IndicatorJob>& jobs);
+        void runIndicatorJob(IndicatorJob& job);
+        // Higher-timeframe bars resampled from the instrument's base bars
+        CandleDataCache::ResampledPtr resampleBars(const InstrumentState& instrument, const std::string& timeframe);
+        // Higher-timeframe indicator values aligned back onto the base bars
+        // (one value per base bar from the returned offset on)
+        static core::TimeSeries<double> alignToBaseBars(const data::ResampledSeries& higher,
+                                                        const core::TimeSeries<double>& values,
+                                                        std::size_t lookback,
+                                                        std::size_t base_bars);
         void runEventLoop();
-        void executeSignal(core::Timestamp timestamp, const core::Candle& current_candle, core::SignalAction signal);
+        // Vectorized mode: precompute each instrument's signals over its whole series.
+        // Instruments whose strategy does not support it keep per-bar evaluation.
+        void precomputeSignals(core::ThreadPool* pool);
+        // Signal for the instrument's bar 'bar'; touches only that instrument's state
+        core::SignalAction evaluateBar(InstrumentState& instrument, std::size_t bar);
+        // Turns a signal at the close of bar 'bar' into a fill or a resting order
+        void executeSignal(InstrumentState& instrument, std::size_t bar, core::Timestamp timestamp,
+                           const core::Candle& current_candle, core::SignalAction signal);
+        // Fills the instrument's resting orders that bar 'bar' reaches, before it is evaluated
+        void processOrders(InstrumentState& instrument, std::size_t bar);
+        // Executes one order at 'price' (before slippage); false if there was nothing to trade
+        bool fillOrder(InstrumentState& instrument, core::Timestamp timestamp, core::SignalAction action,
+                       OrderType type, double price);
+        long long entryQuantity(const InstrumentState& instrument, double price) const;
+        // With fill feedback: tells the strategy the position it actually has (or has an entry pending for)
+        void syncStrategyPosition(InstrumentState& instrument) const;
         void calculateMetrics();
-        // Helper to create indicator instances (simple version)
+        // Indicator for a spec through IndicatorRegistry; nullptr (logged) if unknown or invalid
         std::unique_ptr<indicators::IIndicator> createIndicator(const std::string& name);
     };
 
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "candle_source.hpp"
+#include "portfolio.hpp"           // BacktestMetrics
+#include "candle_data_cache.hpp"
+#include "indicator_cache.hpp"
+#include "backtester.hpp"         // EvaluationMode
+#include "results_writer.hpp"
+
+namespace backtester {
+
+    using json = nlohmann::json;
+
+    // One strategy file of a batch. Files that fail to parse stay in the batch with
+    // 'error' set, so one broken config does not stop the other runs.
+    struct BatchStrategy {
+        std::string file;  // Path as found in the directory
+        json config;
+        std::string error; // Empty if the file parsed
+    };
+
+    struct BatchResult {
+        std::string file;
+        std::string strategy_name;
+        BacktestMetrics metrics;
+        double wall_seconds = 0.0;
+        bool success = false;
+    };
+
+    // --- BatchRunner ---
+    // Runs many strategy configs over the same date range with one data pass:
+    // candles for the union of all (instrument, timeframe) pairs are loaded once
+    // into a shared CandleDataCache, and every indicator spec is computed once per
+    // instrument through a shared IndicatorCache, however many strategies use it.
+    // Strategies then run in parallel on a thread pool, each with its own
+    // Backtester and Portfolio, reading the shared series read-only.
+    class BatchRunner {
+    public:
+        BatchRunner(data::ICandleSource& candle_source, double initial_capital, std::size_t num_threads = 0);
+
+        // Every "*.json" file directly in 'directory', sorted by file name.
+        // Throws core::ConfigException if the directory cannot be read or has no JSON files.
+        static std::vector<BatchStrategy> loadDirectory(const std::string& directory);
+
+        // Results are in the order of 'strategies'
+        std::vector<BatchResult> run(const std::vector<BatchStrategy>& strategies,
+                                     const std::string& start_date,
+                                     const std::string& end_date);
+
+        static void logResultsTable(const std::vector<BatchResult>& results);
+        static bool writeResultsCsv(const std::string& path, const std::vector<BatchResult>& results);
+
+        std::shared_ptr<CandleDataCache> getDataCache() const { return data_cache_; }
+        // Defaults to a memory-only cache; replace it to add a disk tier
+        void setIndicatorCache(std::shared_ptr<indicators::IndicatorCache> cache) { indicator_cache_ = std::move(cache); }
+        std::shared_ptr<indicators::IndicatorCache> getIndicatorCache() const { return indicator_cache_; }
+        void setEvaluationMode(EvaluationMode mode) { evaluation_mode_ = mode; }
+        // Every run's metrics, equity curve and trade log also go to this file (label: strategy name)
+        void setResultsWriter(std::shared_ptr<ResultsWriter> writer) { results_writer_ = std::move(writer); }
+
+    private:
+        data::ICandleSource& candle_source_;
+        double initial_capital_;
+        std::size_t num_threads_;
+        std::shared_ptr<CandleDataCache> data_cache_;
+        std::shared_ptr<indicators::IndicatorCache> indicator_cache_;
+        EvaluationMode evaluation_mode_ = EvaluationMode::Vectorized;
+        std::shared_ptr<ResultsWriter> results_writer_; // Optional
+    };
+
+} // namespace backtester
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <tuple>
+
+#include "datatypes.hpp"
+#include "candle_series.hpp"
+#include "compact_candle_series.hpp"
+#include "candle_resampler.hpp"
+
+namespace backtester {
+
+    // --- CandleDataCache ---
+    // Thread-safe store of loaded candle series shared read-only between
+    // Backtester instances (parameter sweeps, batch runs). Each distinct
+    // (instrument, interval, start, end) request is loaded exactly once; concurrent
+    // callers asking for a series that is still loading wait for that load.
+    // Higher timeframes resampled from a loaded series are cached the same way.
+    //
+    // With compact storage, loaded series are kept as core::CompactCandleSeries
+    // (about half the memory of the double columns) and decoded when requested.
+    // Callers asking for a series while another still holds its decoded copy share
+    // that copy; once the last holder drops it, the next request decodes again.
+    // Series that cannot be encoded losslessly are kept as loaded.
+    class CandleDataCache {
+    public:
+        using SeriesPtr = std::shared_ptr<const core::CandleSeries>;
+        using ResampledPtr = std::shared_ptr<const data::ResampledSeries>;
+        using Loader = std::function<core::CandleSeries()>;
+
+        // Applies to series loaded afterwards
+        void setCompactStorage(bool compact) { compact_storage_ = compact; }
+        bool compactStorage() const { return compact_storage_; }
+
+        // Returns the cached series, invoking 'loader' on the first request.
+        // Exceptions thrown by the loader propagate and the entry is not kept.
+        // 'tick_size' (0 = unknown) is the instrument's price step for compact storage.
+        SeriesPtr getOrLoad(const std::string& instrument_key,
+                            const std::string& interval,
+                            core::Timestamp start_time,
+                            core::Timestamp end_time,
+                            const Loader& loader,
+                            double tick_size = 0.0);
+
+        // 'base' resampled to 'target_interval', built on the first request.
+        // 'base' must be the series cached for (instrument, base_interval, start, end).
+        // Throws std::invalid_argument for intervals the resampler does not support.
+        ResampledPtr getOrResample(const std::string& instrument_key,
+                                   const std::string& base_interval,
+                                   const std::string& target_interval,
+                                   core::Timestamp start_time,
+                                   core::Timestamp end_time,
+                                   const core::CandleSeries& base);
+
+        std::size_t size() const; // Loaded series, not counting resampled ones
+        // Bytes held by the loaded series as stored (compact or not), excluding
+        // decoded copies and resampled series
+        std::size_t storedBytes() const;
+        void clear();
+
+    private:
+        using Key = std::tuple<std::string, std::string, core::Timestamp, core::Timestamp>;
+
+        // A loaded series, either as loaded or compact
+        struct StoredSeries {
+            SeriesPtr full;
+            std::optional<core::CompactCandleSeries> compact;
+            std::weak_ptr<const core::CandleSeries> decoded; // Guarded by mutex_
+        };
+        using StoredPtr = std::shared_ptr<StoredSeries>;
+
+        SeriesPtr decodeShared(StoredSeries& stored);
+
+        mutable std::mutex mutex_;
+        bool compact_storage_ = false;
+        std::map<Key, std::shared_future<StoredPtr>> entries_;
+        std::map<Key, std::shared_future<ResampledPtr>> resampled_; // Interval = resampledIntervalKey()
+    };
+
+} // namespace backtester
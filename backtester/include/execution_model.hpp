@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "datatypes.hpp"
+
+namespace backtester {
+
+    using json = nlohmann::json;
+
+    // When a market order created from a bar's signal is filled
+    enum class FillTiming {
+        SameBarClose, // At the signal bar's close (the original behaviour)
+        NextBarOpen   // At the next bar's open of the same instrument
+    };
+
+    enum class OrderType {
+        Market,
+        Limit, // Buy at or below / sell at or above the order price
+        Stop   // Buy at or above / sell at or below the order price
+    };
+
+    // Adverse price adjustment of market and stop fills (limit fills get their price or better)
+    struct SlippageModel {
+        double bps = 0.0;       // Basis points of the price
+        double per_share = 0.0; // Absolute amount per share
+
+        double apply(double price, bool is_buy) const {
+            const double adjustment = price * bps * 1e-4 + per_share;
+            return is_buy ? price + adjustment : price - adjustment;
+        }
+    };
+
+    // Charges per execution leg. All rates are fractions of the leg's turnover.
+    struct FeeSchedule {
+        double per_share = 0.0;          // Brokerage per share
+        double brokerage_rate = 0.0;      // Brokerage per turnover
+        double brokerage_cap = 0.0;       // Maximum brokerage per order (0 = no cap)
+        double stt_buy_rate = 0.0;        // Securities Transaction Tax
+        double stt_sell_rate = 0.0;
+        double exchange_rate = 0.0;       // Exchange transaction charges
+        double sebi_rate = 0.0;           // SEBI turnover fee
+        double stamp_duty_buy_rate = 0.0; // Stamp duty (buy side only)
+        double gst_rate = 0.0;            // GST on brokerage + exchange + SEBI charges
+
+        double calculate(bool is_buy, long long quantity, double price) const;
+
+        // Flat fee per share; 0.01 is what the backtester always charged
+        static FeeSchedule perShare(double amount);
+        // NSE equity with a discount broker: delivery (no brokerage, STT 0.1% both sides)
+        // and intraday (0.03% capped at Rs 20 per order, STT 0.025% on sells)
+        static FeeSchedule indiaEquityDelivery();
+        static FeeSchedule indiaEquityIntraday();
+    };
+
+    // --- Execution Config ---
+    // Parsed from the optional "execution" block of a strategy config:
+    //   "execution": {
+    //     "fill": "close" | "next_open",
+    //     "entry_order": {"type": "market" | "limit" | "stop", "offset_pct": 0.5, "valid_bars": 5},
+    //     "stop_loss_pct": 2.0, "take_profit_pct": 4.0,
+    //     "slippage": {"bps": 5, "per_share": 0.0},
+    //     "fees": "per_share" | "india_equity_delivery" | "india_equity_intraday"
+    //             | {"model": <one of those>, <any FeeSchedule field>: <value>, ...}
+    //   }
+    // Percentages are in percent (2.0 = 2%), like position_sizing. Without the block
+    // every signal fills at its bar's close with 0.01 per share commission.
+    struct ExecutionConfig {
+        FillTiming fill_timing = FillTiming::SameBarClose;
+        OrderType entry_order_type = OrderType::Market;
+        double entry_offset_pct = 0.0;  // Limit/stop entries: distance from the signal close
+        std::size_t entry_valid_bars = 0; // Limit/stop entries expire after this many bars (0 = never)
+        double stop_loss_pct = 0.0;     // Protective stop from the entry fill (0 = none)
+        double take_profit_pct = 0.0;   // Profit target from the entry fill (0 = none)
+        SlippageModel slippage;
+        FeeSchedule fees = FeeSchedule::perShare(0.01);
+
+        // Throws core::ConfigException on unknown values
+        static ExecutionConfig fromJson(const json& execution);
+
+        // True unless every order is a market order filled at the signal close with no
+        // stops. Then fills can lag or differ from the strategy's signals, so the
+        // strategy is told its actual position and evaluated bar by bar.
+        bool needsFillFeedback() const;
+    };
+
+    using OrderId = std::uint64_t;
+
+    struct PendingOrder {
+        OrderId id = 0;
+        core::SignalAction action = core::SignalAction::None; // Side and intent (entry/exit)
+        OrderType type = OrderType::Market;
+        double price = 0.0;           // Limit/stop price; unused for Market
+        std::size_t expires_after_bar = std::numeric_limits<std::size_t>::max(); // Last bar the order may fill on
+        bool protective = false;      // Stop-loss / take-profit of the open position
+
+        bool isBuy() const {
+            return action == core::SignalAction::EnterLong || action == core::SignalAction::ExitShort;
+        }
+    };
+
+    struct OrderFill {
+        PendingOrder order;
+        double price = 0.0; // Before slippage
+    };
+
+    // --- Order Book ---
+    // Resting orders of one instrument. Limit and stop orders sit in four price-sorted
+    // maps ordered so the next order to trigger is always at begin(); a bar checks
+    // each map's head and only walks the orders it actually fills, so a bar with no
+    // fills costs O(1) and each fill O(log n), however many orders rest.
+    class OrderBook {
+    public:
+        OrderId submit(PendingOrder order); // Assigns and returns the id
+        bool cancel(OrderId id);
+        void cancelIf(const std::function<bool(const PendingOrder&)>& predicate);
+        void clear();
+
+        // Orders filled by 'bar' (bar index 'bar_index'), appended to 'fills' in
+        // execution order: market orders at the open, then stops, then limits.
+        // An order is filled at the open if the bar gaps through its price, otherwise
+        // at its price. Stops go before limits, so a bar that reaches both the
+        // stop-loss and the take-profit is assumed to hit the stop first.
+        // Expired orders are dropped afterwards.
+        void match(const core::Candle& bar, std::size_t bar_index, std::vector<OrderFill>& fills);
+
+        bool empty() const { return orders_.empty(); }
+        std::size_t size() const { return orders_.size(); }
+        bool hasEntry() const;
+
+    private:
+        using AscendingPrices = std::multimap<double, OrderId>;
+        using DescendingPrices = std::multimap<double, OrderId, std::greater<double>>;
+
+        void index(const PendingOrder& order);
+        void unindex(const PendingOrder& order);
+        template <typename Map>
+        static void erase(Map& map, double price, OrderId id);
+
+        OrderId next_id_ = 1;
+        std::map<OrderId, PendingOrder> orders_;
+        std::vector<OrderId> market_;  // Filled at the next open, in submission order
+        DescendingPrices buy_limits_;  // Highest first: fills when low <= price
+        AscendingPrices sell_limits_;  // Lowest first: fills when high >= price
+        AscendingPrices buy_stops_;    // Lowest first: fills when high >= price
+        DescendingPrices sell_stops_;  // Highest first: fills when low <= price
+        std::multimap<std::size_t, OrderId> expiries_; // Orders with a finite lifetime
+    };
+
+} // namespace backtester
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "datatypes.hpp" // core::Timestamp, core::Trade
+#include "logging.hpp"   // Provides core::logging::getLogger needed by BacktestMetrics::logMetrics
+
+namespace backtester {
+
+    // --- Backtest Metrics Struct ---
+    // "_pct" fields are fractions (0.05 = 5%), as elsewhere in the backtester
+    struct BacktestMetrics {
+        double total_return_pct = 0.0;
+        double max_drawdown_pct = 0.0;
+        double total_pnl = 0.0;
+        int total_executions = 0;     // Renamed from total_trades for clarity
+        int round_trip_trades = 0;
+        double win_rate = 0.0;        // Based on round trips
+        double profit_factor = 0.0;   // Gross Profit / Gross Loss
+        double avg_win_pnl = 0.0;
+        double avg_loss_pnl = 0.0;
+
+        // --- Risk (from the per-point returns of the equity curve, 0% risk-free rate) ---
+        double sharpe_ratio = 0.0;    // Annualized mean / standard deviation of returns
+        double sortino_ratio = 0.0;   // Annualized mean / downside deviation (returns below 0)
+        double cagr_pct = 0.0;        // Compound annual growth over the first to last point
+        double calmar_ratio = 0.0;    // cagr_pct / max_drawdown_pct
+        double exposure_pct = 0.0;    // Share of equity points with an open position
+        std::size_t max_drawdown_duration_bars = 0; // Longest peak-to-recovery stretch, in equity points
+        double max_drawdown_duration_days = 0.0;    // The same stretch in calendar days
+        bool stopped_early = false;   // A StopCriteria ended the run; the metrics cover it up to there
+
+        // Helper method to log calculated metrics
+        void logMetrics() const {
+            // Ensure logger is available. Consider passing logger or using static access if guaranteed initialized.
+            auto logger = core::logging::getLogger();
+            logger->info("--- Backtest Metrics ---");
+            logger->info("Total Return: {:.2f}%", total_return_pct * 100.0);
+            logger->info("Total PnL: {:.2f}", total_pnl);
+            logger->info("Max Drawdown: {:.2f}%", max_drawdown_pct * 100.0);
+            logger->info("Total Executions: {}", total_executions);
+            logger->info("Round-Trip Trades: {}", round_trip_trades);
+            logger->info("Win Rate: {:.2f}%", win_rate * 100.0);
+            logger->info("Profit Factor: {:.2f}", profit_factor);
+            logger->info("Avg Win PnL: {:.2f}", avg_win_pnl);
+            logger->info("Avg Loss PnL: {:.2f}", avg_loss_pnl);
+            logger->info("Sharpe: {:.2f}, Sortino: {:.2f}, Calmar: {:.2f}", sharpe_ratio, sortino_ratio, calmar_ratio);
+            logger->info("CAGR: {:.2f}%", cagr_pct * 100.0);
+            logger->info("Exposure: {:.2f}%", exposure_pct * 100.0);
+            logger->info("Longest Drawdown: {} bars ({:.1f} days)", max_drawdown_duration_bars, max_drawdown_duration_days);
+            if (stopped_early) logger->info("Stopped early by a stop criterion.");
+            logger->info("------------------------");
+        }
+    };
+
+    // --- Portfolio State Struct (for equity curve) ---
+    struct PortfolioState {
+        core::Timestamp timestamp;
+        double cash = 0.0;
+        double positions_value = 0.0; // Market value of all holdings
+        double total_equity = 0.0;   // cash + positions_value
+    };
+
+    // --- MetricsAccumulator ---
+    // BacktestMetrics kept up to date one equity point and one closed trade at a
+    // time, so they are available mid-run (dashboards, early stopping) and the end of
+    // a run needs no pass over the equity curve or trade log. O(1) memory and no
+    // allocation per update: Welford mean/variance of the point-to-point returns, a
+    // running sum of squared negative returns for the downside deviation, and the
+    // running peak for drawdown depth and duration.
+    //
+    // Portfolio owns one and feeds it from recordTimestampValue() and recordTrade().
+    class MetricsAccumulator {
+    public:
+        explicit MetricsAccumulator(double initial_capital = 0.0)
+            : initial_capital_(initial_capital), peak_equity_(initial_capital) {}
+
+        void reset(double initial_capital);
+
+        // One equity point; 'in_market' = a position was open at this point
+        void addPoint(const PortfolioState& state, bool in_market);
+        void addTrade(const core::Trade& trade);
+
+        std::size_t points() const { return points_; }
+        const PortfolioState& last() const { return last_; } // Latest point (zeroed before the first)
+        double peakEquity() const { return peak_equity_; }   // Highest equity so far, starting at the initial capital
+        double maxDrawdownPct() const { return max_drawdown_pct_; }
+        double currentDrawdownPct() const;
+        std::size_t returnCount() const { return return_count_; }
+        double meanReturn() const { return mean_return_; }
+        double returnStdDev() const;  // Population standard deviation
+        double downsideDeviation() const;
+
+        // Everything but total_executions (the Portfolio counts executions).
+        // 'periods_per_year' annualizes Sharpe and Sortino (see periodsPerYear()).
+        BacktestMetrics metrics(double periods_per_year) const;
+
+        // Equity points per year for bars of 'interval': trading days (252) times
+        // bars per NSE session (375 minutes) for intraday intervals, 252 / 52 / 12
+        // for day / week / month. 1 (no annualization) for unknown intervals.
+        static double periodsPerYear(const std::string& interval);
+
+    private:
+        double initial_capital_ = 0.0;
+        std::size_t points_ = 0;
+        PortfolioState last_;
+        core::Timestamp first_time_{};
+
+        // Returns between consecutive points (from the second point on)
+        std::size_t return_count_ = 0;
+        double mean_return_ = 0.0;
+        double m2_ = 0.0;                 // Welford sum of squared deviations
+        double downside_sq_sum_ = 0.0;    // Sum of squared negative returns
+
+        double peak_equity_ = 0.0;
+        double max_drawdown_pct_ = 0.0;
+        core::Timestamp peak_time_{};     // When the current peak was set
+        std::size_t underwater_points_ = 0; // Points since the current peak
+        std::size_t max_underwater_points_ = 0;
+        std::int64_t max_underwater_ns_ = 0;
+
+        std::size_t in_market_points_ = 0;
+
+        int trades_ = 0;
+        int winning_trades_ = 0;
+        double gross_profit_ = 0.0;
+        double gross_loss_ = 0.0;         // Negative
+    };
+
+    // --- StopCriteria ---
+    // Conditions that end a run early (Backtester::setStopCriteria), checked against
+    // the running metrics after every equity point. Unset fields are not checked.
+    struct StopCriteria {
+        std::optional<double> max_drawdown_pct; // Drawdown from the peak beyond this fraction (0.25 = 25%)
+        std::optional<double> min_equity;       // Total equity below this
+
+        bool any() const { return max_drawdown_pct.has_value() || min_equity.has_value(); }
+        // Name of the first criterion 'running' meets, nullptr if none
+        const char* check(const MetricsAccumulator& running) const;
+    };
+
+} // namespace backtester
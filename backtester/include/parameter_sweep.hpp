@@ -0,0 +1,129 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "candle_source.hpp"
+#include "portfolio.hpp"           // BacktestMetrics, StopCriteria
+#include "candle_data_cache.hpp"
+#include "indicator_cache.hpp"
+#include "backtester.hpp"         // EvaluationMode
+#include "results_writer.hpp"
+
+namespace backtester {
+
+    using json = nlohmann::json;
+
+    // Parameter name -> value for one grid point (e.g. {"fast": 10, "slow": 50})
+    using ParameterSet = std::map<std::string, double>;
+
+    struct ParameterRange {
+        std::string name;
+        std::vector<double> values; // Expanded from {start,end,step} or an explicit list
+    };
+
+    // Optional pruning of the grid, e.g. {"left": "fast", "op": "<", "right": "slow"}
+    struct SweepConstraint {
+        std::string left;
+        std::string op;  // One of <, <=, >, >=, ==, !=
+        std::string right;
+        bool isSatisfied(const ParameterSet& params) const;
+    };
+
+    // Parsed form of a strategy config carrying a "sweep" block. Placeholders like
+    // "SMA(${fast})" anywhere in the strategy are substituted per combination.
+    struct SweepSpec {
+        json strategy_template;   // Strategy config with the "sweep" block removed
+        std::vector<ParameterRange> parameters;
+        std::vector<SweepConstraint> constraints;
+        std::string rank_by = "total_return_pct";
+        std::size_t top = 20;     // Rows shown in the ranked table
+        // "stop": {"max_drawdown_pct": 0.25, "min_equity": 80000}. Checked in every run,
+        // which ends as soon as one is met.
+        StopCriteria stop;
+        // "halving": {"rounds": 3, "keep": 0.5}. Successive halving: round r of 'rounds'
+        // trades every remaining combination on the first keep^(rounds - r) of the
+        // loaded data (by time), and only the best 'keep' share (ranked by rank_by) advances. The
+        // survivors of the last round run on the whole range. 0 rounds = no halving.
+        std::size_t halving_rounds = 0;
+        double halving_keep = 0.5;
+    };
+
+    struct SweepResult {
+        ParameterSet parameters;
+        BacktestMetrics metrics;
+        bool success = false;
+        // Successive halving: dropped after a round; the metrics are from that round
+        // and cover the first data_fraction of the loaded data
+        bool eliminated = false;
+        double data_fraction = 1.0;
+        // Per-instrument jobs of a distributed sweep: the only instrument traded.
+        // Empty when the run covered every instrument of the config.
+        std::string instrument;
+    };
+
+    // --- ParameterSweep ---
+    // Runs one independent Backtester/Portfolio per parameter combination on a
+    // thread pool. Candles are loaded once into a shared CandleDataCache and read
+    // concurrently by every run.
+    class ParameterSweep {
+    public:
+        ParameterSweep(data::ICandleSource& candle_source, double initial_capital, std::size_t num_threads = 0);
+
+        // Throws core::ConfigException if the config has no valid "sweep" block
+        static SweepSpec parseSpec(const json& strategy_config);
+        // Cartesian product of all ranges, filtered by the constraints
+        static std::vector<ParameterSet> expandGrid(const SweepSpec& spec);
+        // Strategy config for one combination (placeholders substituted)
+        static json instantiate(const json& strategy_template, const ParameterSet& params);
+
+        // Runs every combination; results are sorted best-first by spec.rank_by, with
+        // combinations dropped by successive halving after those that ran to the end
+        std::vector<SweepResult> run(const SweepSpec& spec,
+                                     const std::string& start_date,
+                                     const std::string& end_date);
+
+        // Ranking helpers. max_drawdown_pct and max_drawdown_duration_days rank ascending,
+        // everything else descending. Failed runs go last, stopped-early runs after the
+        // completed ones, and halving eliminations after the full-range runs (the
+        // latest rounds first).
+        static double metricValue(const BacktestMetrics& metrics, const std::string& metric_name);
+        static void rankResults(std::vector<SweepResult>& results, const std::string& metric_name);
+
+        static void logResultsTable(const std::vector<SweepResult>& results, const SweepSpec& spec);
+        static bool writeResultsCsv(const std::string& path, const std::vector<SweepResult>& results);
+
+        // Exposed so callers can reuse the loaded candles for follow-up runs
+        std::shared_ptr<CandleDataCache> getDataCache() const { return data_cache_; }
+        // Load through a cache that outlives the sweep (e.g. a long-running service)
+        void setDataCache(std::shared_ptr<CandleDataCache> cache) { data_cache_ = std::move(cache); }
+        // Indicators are computed once per spec and shared by all runs. Defaults to a
+        // memory-only cache; replace it to add a disk tier.
+        void setIndicatorCache(std::shared_ptr<indicators::IndicatorCache> cache) { indicator_cache_ = std::move(cache); }
+        std::shared_ptr<indicators::IndicatorCache> getIndicatorCache() const { return indicator_cache_; }
+        void setEvaluationMode(EvaluationMode mode) { evaluation_mode_ = mode; }
+        // Load [start_date, end_date] but trade only [from, to], as
+        // Backtester::setEvaluationRange(); halving prefixes are shares of this range
+        void setEvaluationRange(core::Timestamp from, core::Timestamp to) { evaluation_range_ = std::make_pair(from, to); }
+        void clearEvaluationRange() { evaluation_range_.reset(); }
+        // Every run's metrics, equity curve and trade log also go to this file, labelled
+        // with its parameters (and the halving round for runs on a prefix of the data)
+        void setResultsWriter(std::shared_ptr<ResultsWriter> writer) { results_writer_ = std::move(writer); }
+
+    private:
+        data::ICandleSource& candle_source_;
+        double initial_capital_;
+        std::size_t num_threads_;
+        std::shared_ptr<CandleDataCache> data_cache_;
+        std::shared_ptr<indicators::IndicatorCache> indicator_cache_;
+        EvaluationMode evaluation_mode_ = EvaluationMode::Vectorized;
+        std::optional<std::pair<core::Timestamp, core::Timestamp>> evaluation_range_;
+        std::shared_ptr<ResultsWriter> results_writer_; // Optional
+    };
+
+} // namespace backtester
@@ -1,56 +1,23 @@
 // backtester/include/portfolio.hpp
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <map>
+#include <memory_resource>
 #include <optional> // Required for std::optional if not included via datatypes.hpp already
+#include <span>
+#include <unordered_map>
 
 // Use short paths
 #include "datatypes.hpp" // Provides core::Timestamp, core::SignalAction, core::Trade
-#include "logging.hpp"   // Provides core::logging::getLogger needed by BacktestMetrics::logMetrics
+#include "logging.hpp"
+#include "metrics_accumulator.hpp" // BacktestMetrics, PortfolioState, MetricsAccumulator
 
 namespace backtester {
 
-    // --- Backtest Metrics Struct ---
-    struct BacktestMetrics {
-        double total_return_pct = 0.0;
-        double max_drawdown_pct = 0.0;
-        double total_pnl = 0.0;
-        int total_executions = 0;     // Renamed from total_trades for clarity
-        int round_trip_trades = 0;
-        double win_rate = 0.0;        // Based on round trips
-        double profit_factor = 0.0;   // Gross Profit / Gross Loss
-        double avg_win_pnl = 0.0;
-        double avg_loss_pnl = 0.0;
-        // Add more later...
-
-        // Helper method to log calculated metrics
-        void logMetrics() const {
-            // Ensure logger is available. Consider passing logger or using static access if guaranteed initialized.
-            auto logger = core::logging::getLogger();
-            logger->info("--- Backtest Metrics ---");
-            logger->info("Total Return: {:.2f}%", total_return_pct * 100.0);
-            logger->info("Total PnL: {:.2f}", total_pnl);
-            logger->info("Max Drawdown: {:.2f}%", max_drawdown_pct * 100.0);
-            logger->info("Total Executions: {}", total_executions);
-            logger->info("Round-Trip Trades: {}", round_trip_trades);
-            logger->info("Win Rate: {:.2f}%", win_rate * 100.0);
-            logger->info("Profit Factor: {:.2f}", profit_factor);
-            logger->info("Avg Win PnL: {:.2f}", avg_win_pnl);
-            logger->info("Avg Loss PnL: {:.2f}", avg_loss_pnl);
-            logger->info("------------------------");
-        }
-    };
-
-    // --- Portfolio State Struct (for equity curve) ---
-    struct PortfolioState {
-        core::Timestamp timestamp;
-        double cash = 0.0;
-        double positions_value = 0.0; // Market value of all holdings
-        double total_equity = 0.0;   // cash + positions_value
-    };
-
     // --- Open Position Info Struct --- (Defined before Portfolio class)
     // Stores details needed to calculate PnL when a position is closed
     struct OpenPositionInfo {
@@ -60,45 +27,98 @@ namespace backtester {
         double entry_commission = 0.0;// Commission paid on entry
     };
 
+    // Dense index of an instrument within one Portfolio (0, 1, 2, ... in registration order)
+    using InstrumentId = std::uint32_t;
+
     // --- Portfolio Class Definition ---
+    // Positions, open-position info and prices are flat arrays indexed by InstrumentId.
+    // The event loop registers its instruments once (addInstrument) and reserves the
+    // equity curve (reserveEquityCurve); after that recordTimestampValue() with a
+    // price array does no heap allocation. The string-keyed overloads intern the key
+    // and forward to the ID versions.
+    // The equity curve and trade log are allocated from 'memory' (a backtest passes its
+    // per-run core::Arena); the Portfolio must not outlive it.
+    // Every equity point and closed trade also goes into a MetricsAccumulator. With
+    // setKeepEquityCurve(false) only that is updated, so memory no longer grows with
+    // the number of bars (streaming backtests).
     class Portfolio {
     public:
-        explicit Portfolio(double initial_capital);
+        explicit Portfolio(double initial_capital, std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+        // --- Instruments ---
+        // Interns 'instrument_key', returning its existing ID if already known
+        InstrumentId addInstrument(const std::string& instrument_key);
+        std::optional<InstrumentId> findInstrument(const std::string& instrument_key) const;
+        const std::string& getInstrumentKey(InstrumentId id) const { return instrument_keys_[id]; }
+        std::size_t getInstrumentCount() const { return instrument_keys_.size(); }
+        // Capacity for 'points' equity curve entries (typically the bar count)
+        void reserveEquityCurve(std::size_t points) {
+            if (keep_equity_curve_) equity_curve_.reserve(points);
+        }
+        // Whether recordTimestampValue() appends to the equity curve (default true)
+        void setKeepEquityCurve(bool keep) { keep_equity_curve_ = keep; }
+        bool keepsEquityCurve() const { return keep_equity_curve_; }
 
         // --- Getters ---
         double getCash() const;
+        long long getPositionQuantity(InstrumentId id) const { return id < positions_.size() ? positions_[id] : 0; }
         long long getPositionQuantity(const std::string& instrument_key) const;
-        // Calculates current equity based on cash and market value of open positions
+        // Calculates current equity based on cash and market value of open positions.
+        // 'current_prices' is indexed by InstrumentId; IDs past its end count as unpriced.
+        double getCurrentEquity(std::span<const double> current_prices) const;
         double getCurrentEquity(const std::map<std::string, double>& current_prices) const;
-        const std::vector<PortfolioState>& getEquityCurve() const;
+        const std::pmr::vector<PortfolioState>& getEquityCurve() const; // Empty unless keepsEquityCurve()
+        // Metrics of everything recorded so far, updated as points and trades come in
+        const MetricsAccumulator& getRunningMetrics() const { return running_metrics_; }
         int getTotalExecutions() const { return execution_count_; } // Use updated member name
-        const std::vector<core::Trade>& getTradeLog() const;      // Getter for completed trades
+        const std::pmr::vector<core::Trade>& getTradeLog() const;      // Getter for completed trades
 
         // --- Modifiers ---
         // Records an execution, updates cash/positions, logs completed trades
         void recordTrade(core::Timestamp timestamp,
-                         const std::string& instrument_key,
+                         InstrumentId id,
                          core::SignalAction action, // Signal that caused trade
                          long long quantity,        // Always positive quantity executed
                          double execution_price,
                          double commission = 0.0); // Commission for THIS execution leg
+        void recordTrade(core::Timestamp timestamp,
+                         const std::string& instrument_key,
+                         core::SignalAction action,
+                         long long quantity,
+                         double execution_price,
+                         double commission = 0.0);
 
-        // Records portfolio equity state at a specific timestamp
+        // Records portfolio equity state at a specific timestamp.
+        // 'current_prices' is indexed by InstrumentId, as for getCurrentEquity().
+        void recordTimestampValue(core::Timestamp timestamp, std::span<const double> current_prices);
         void recordTimestampValue(core::Timestamp timestamp, const std::map<std::string, double>& current_prices);
 
     private:
+        // Market value of the open positions; unpriced positions count as zero
+        double positionsValue(std::span<const double> current_prices) const;
+        // Prices from a key-value map, laid out by InstrumentId (scratch buffer, string overloads only)
+        std::span<const double> pricesById(const std::map<std::string, double>& current_prices) const;
+
         double initial_capital_;
         double cash_;
-        // Map: Instrument Key -> Current Quantity held (+long / -short)
-        std::map<std::string, long long> positions_;
-        // Map: Instrument Key -> Info about the currently open position
-        std::map<std::string, OpenPositionInfo> open_positions_info_;
+        // Interned instrument keys, indexed by InstrumentId
+        std::vector<std::string> instrument_keys_;
+        std::unordered_map<std::string, InstrumentId> instrument_ids_;
+        // Current quantity held (+long / -short), indexed by InstrumentId
+        std::vector<long long> positions_;
+        // Info about the currently open position (entry_quantity 0 = none), indexed by InstrumentId
+        std::vector<OpenPositionInfo> open_positions_info_;
+        // IDs with a non-zero position, ascending; capacity kept at the instrument count
+        std::vector<InstrumentId> open_ids_;
         // Vector storing historical portfolio state (for equity curve / drawdown)
-        std::vector<PortfolioState> equity_curve_;
+        std::pmr::vector<PortfolioState> equity_curve_;
+        bool keep_equity_curve_ = true;
+        MetricsAccumulator running_metrics_;
         // Counter for total buy/sell executions
         int execution_count_ = 0;
         // Vector storing details of completed round-trip trades
-        std::vector<core::Trade> trade_log_;
+        std::pmr::vector<core::Trade> trade_log_;
+        mutable std::vector<double> price_scratch_;
     };
 
 } // namespace backtester
\ No newline at end of file
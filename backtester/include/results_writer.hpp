@@ -0,0 +1,207 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "datatypes.hpp"
+#include "portfolio.hpp" // BacktestMetrics, PortfolioState, Portfolio
+
+namespace backtester {
+
+    // --- Backtest results file format (.tpres) ---
+    // Metrics, equity curves and trade logs of any number of runs, as a stream of
+    // columnar blocks (native endianness, like .tpcol):
+    //
+    //   ResultsFileHeader                       (offset 0, 32 bytes)
+    //   { ResultsBlockHeader, payload }*        in write order
+    //   ResultsBlockHeader of kind kResultsBlockEnd (no payload) closes a complete file
+    //
+    // A payload holds the block's columns one after the other, each row_count values
+    // of the type listed below and zero-padded to a multiple of 8 bytes, so every
+    // column starts 8-byte aligned. Readers skip blocks of unknown kinds by
+    // payload_bytes; later versions only append columns.
+    //
+    //   kResultsBlockDictionary  tag = dictionary (kResultsInstrumentDictionary, kResultsLabelDictionary)
+    //     u32 byte length per entry, then the UTF-8 bytes of all entries back to back.
+    //     Entries extend the dictionary: ids count up from 0 in order of appearance,
+    //     across all its blocks. A dictionary block precedes any block using its ids.
+    //   kResultsBlockRuns  one row per run
+    //     u32 run_id, u32 label (label dictionary id), u32 flags (kResultsRunSuccess | kResultsRunStoppedEarly),
+    //     i64 total_executions, i64 round_trip_trades, i64 max_drawdown_duration_bars,
+    //     f64 total_return_pct, total_pnl, max_drawdown_pct, win_rate, profit_factor, avg_win_pnl,
+    //     avg_loss_pnl, sharpe_ratio, sortino_ratio, cagr_pct, calmar_ratio, exposure_pct,
+    //     max_drawdown_duration_days
+    //   kResultsBlockEquity  one row per equity point
+    //     u32 run_id, i64 timestamp ns (UTC), f64 cash, f64 positions_value, f64 total_equity
+    //   kResultsBlockTrades  one row per closed trade
+    //     u32 run_id, u32 instrument (instrument dictionary id), i32 entry_action (core::SignalAction),
+    //     i64 entry_time ns, i64 exit_time ns, i64 quantity,
+    //     f64 entry_price, exit_price, commission, pnl, return_pct
+    //
+    // Rows of one run may be spread over several blocks, and a block may hold rows
+    // of many runs; join on run_id.
+    inline constexpr char kResultsMagic[8] = {'T', 'P', 'R', 'E', 'S', '\0', '\0', '\0'};
+    inline constexpr std::uint32_t kResultsVersion = 1;
+
+    inline constexpr std::uint32_t kResultsBlockEnd = 0;
+    inline constexpr std::uint32_t kResultsBlockDictionary = 1;
+    inline constexpr std::uint32_t kResultsBlockRuns = 2;
+    inline constexpr std::uint32_t kResultsBlockEquity = 3;
+    inline constexpr std::uint32_t kResultsBlockTrades = 4;
+
+    inline constexpr std::uint32_t kResultsInstrumentDictionary = 0;
+    inline constexpr std::uint32_t kResultsLabelDictionary = 1;
+
+    inline constexpr std::uint32_t kResultsRunSuccess = 1u << 0;
+    inline constexpr std::uint32_t kResultsRunStoppedEarly = 1u << 1;
+
+    struct ResultsFileHeader {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t flags;  // None defined yet
+        std::uint8_t reserved[16];
+    };
+    static_assert(sizeof(ResultsFileHeader) == 32, "ResultsFileHeader must stay 32 bytes");
+
+    struct ResultsBlockHeader {
+        std::uint32_t kind;
+        std::uint32_t tag;           // Kind-specific (dictionary id), 0 otherwise
+        std::uint64_t row_count;
+        std::uint64_t payload_bytes; // Everything up to the next block header
+        std::uint32_t column_count;
+        std::uint32_t reserved;
+    };
+    static_assert(sizeof(ResultsBlockHeader) == 32, "ResultsBlockHeader must stay 32 bytes");
+
+    struct ResultsWriterOptions {
+        std::size_t batch_rows = 65'536;  // Equity / trade rows buffered before a block is written
+        std::size_t max_queued_runs = 64; // write() waits beyond this many unwritten runs (bounds memory)
+        bool equity_curves = true;
+        bool trade_logs = true;
+    };
+
+    // --- ResultsWriter ---
+    // Writes runs to one .tpres file on a background thread. write() only copies the
+    // run's metrics, equity curve and trade log into a queue, so callers (sweep
+    // workers, the CLI) never wait on encoding or disk I/O unless the queue is full.
+    // The writer thread dictionary-encodes instrument keys and run labels, gathers
+    // rows into column buffers and writes one block per batch_rows rows.
+    //
+    // The file is written under a temporary name of its own next to 'path' (see
+    // core::utils::uniqueTempPath) and renamed into place by close(), so readers
+    // never see a partial file, even with several writers of the same path.
+    // write() is safe to call from several threads.
+    class ResultsWriter {
+    public:
+        // Throws core::DataLoadException if the temporary file cannot be created
+        explicit ResultsWriter(std::string path, ResultsWriterOptions options = {});
+        ~ResultsWriter(); // close()s if still open
+
+        ResultsWriter(const ResultsWriter&) = delete;
+        ResultsWriter& operator=(const ResultsWriter&) = delete;
+
+        // Queues one run; returns its run_id (0, 1, ... in call order)
+        std::uint32_t write(const std::string& label, bool success, const BacktestMetrics& metrics,
+                            const Portfolio& portfolio);
+
+        // Writes everything queued, ends the file and renames it into place.
+        // False (logged) if any write failed; the temporary file is removed then.
+        bool close();
+
+        const std::string& path() const { return path_; }
+
+    private:
+        struct QueuedRun {
+            std::uint32_t run_id = 0;
+            std::string label;
+            bool success = false;
+            BacktestMetrics metrics;
+            std::vector<PortfolioState> equity;
+            std::vector<core::Trade> trades;
+        };
+
+        // Dictionary encoding of one string column (writer thread only)
+        struct Dictionary {
+            std::unordered_map<std::string, std::uint32_t> ids;
+            std::vector<std::string> pending; // Not written yet
+            std::uint32_t encode(const std::string& text);
+        };
+
+        void writerLoop();
+        void append(QueuedRun& run);
+        // Writes the dictionaries' new entries, then every block with at least
+        // batch_rows rows (all non-empty blocks if 'force')
+        void flushBlocks(bool force);
+        void writeDictionary(std::uint32_t dictionary_id, Dictionary& dictionary);
+        void writeBlock(std::uint32_t kind, std::uint32_t tag, std::uint64_t rows, std::uint32_t columns,
+                        const std::vector<char>& payload);
+
+        std::string path_;
+        std::string tmp_path_;
+        ResultsWriterOptions options_;
+
+        std::mutex mutex_;
+        std::condition_variable not_full_;
+        std::condition_variable not_empty_;
+        std::deque<QueuedRun> queue_;
+        std::uint32_t next_run_id_ = 0;
+        bool closing_ = false;
+        bool closed_ = false;
+        std::thread writer_;
+
+        // --- Writer thread state: the file and the column buffers of the blocks being built ---
+        std::ofstream out_;
+        bool failed_ = false;
+        Dictionary instruments_;
+        Dictionary labels_;
+        std::vector<char> payload_; // Scratch for the block being encoded
+        struct RunRow {
+            std::uint32_t run_id = 0;
+            std::uint32_t label = 0;
+            std::uint32_t flags = 0;
+            BacktestMetrics metrics;
+        };
+        std::vector<RunRow> runs_; // Split into columns when the block is written
+        struct {
+            std::vector<std::uint32_t> run_id;
+            std::vector<std::int64_t> timestamp_ns;
+            std::vector<double> cash, positions_value, total_equity;
+        } equity_;
+        struct {
+            std::vector<std::uint32_t> run_id, instrument;
+            std::vector<std::int32_t> entry_action;
+            std::vector<std::int64_t> entry_time_ns, exit_time_ns, quantity;
+            std::vector<double> entry_price, exit_price, commission, pnl, return_pct;
+        } trades_;
+        std::uint64_t runs_written_ = 0;
+        std::uint64_t equity_rows_written_ = 0;
+        std::uint64_t trade_rows_written_ = 0;
+        std::uint64_t bytes_written_ = 0;
+    };
+
+    // Everything in one .tpres file, decoded back into the backtester's types
+    struct ResultsFileContents {
+        struct Run {
+            std::uint32_t run_id = 0;
+            std::string label;
+            bool success = false;
+            BacktestMetrics metrics;
+        };
+        std::vector<Run> runs;
+        std::vector<std::pair<std::uint32_t, PortfolioState>> equity; // (run_id, point)
+        std::vector<std::pair<std::uint32_t, core::Trade>> trades;    // (run_id, trade)
+    };
+
+    // Reads a complete .tpres file; nullopt (logged) if it is missing, truncated or malformed
+    std::optional<ResultsFileContents> readResultsFile(const std::string& path);
+
+} // namespace backtester
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace backtester {
+
+    // Wall clock plus process CPU time (all threads) at one instant
+    struct ClockReading {
+        std::chrono::steady_clock::time_point wall;
+        double cpu_seconds = 0.0;
+
+        static ClockReading now();
+    };
+
+    // One timed section of Backtester::run()
+    struct PhaseTiming {
+        std::string name;
+        double start_seconds = 0.0; // Wall time since run() started
+        double wall_seconds = 0.0;
+        double cpu_seconds = 0.0;   // Process CPU time, so worker threads count too
+    };
+
+    // --- Backtest Run Stats ---
+    // Where the time of the last Backtester::run() went, plus what the event loop did.
+    // Filled in even when the run fails; phases that did not run are missing.
+    struct BacktestRunStats {
+        std::vector<PhaseTiming> phases;      // In start order ("precompute_signals" nests in "event_loop")
+        double wall_seconds = 0.0;            // Whole run()
+        double cpu_seconds = 0.0;
+
+        std::uint64_t bars_processed = 0;       // Bars visited by the event loop, all instruments
+        double bars_per_second = 0.0;           // bars_processed / event loop (or whole streaming) wall time
+        std::uint64_t strategy_evaluations = 0; // Per-bar IStrategy::evaluate() calls
+        std::uint64_t rule_evaluations = 0;     // Rule x bar evaluations (see IStrategy::getRuleEvaluationCount)
+        std::uint64_t signals = 0;              // Non-None signals handed to execution
+        std::uint64_t executions = 0;           // Portfolio executions
+        long long peak_rss_kib = 0;             // Peak resident set of the process so far (not just this run)
+
+        const PhaseTiming* findPhase(std::string_view name) const;
+
+        // Sets the totals, bars_per_second and peak_rss_kib at the end of a run
+        void finish(const ClockReading& run_start);
+
+        void logSummary() const;
+        nlohmann::json toJson() const;
+        // Trace Event Format ("X" events per phase), for chrome://tracing or Perfetto
+        nlohmann::json toChromeTrace() const;
+
+        // Write toJson() / toChromeTrace() to 'path'; false (logged) on I/O errors
+        bool writeJson(const std::string& path) const;
+        bool writeChromeTrace(const std::string& path) const;
+    };
+
+    // Appends a phase to 'stats' covering the timer's lifetime, so early returns are timed too
+    class PhaseTimer {
+    public:
+        PhaseTimer(BacktestRunStats& stats, const ClockReading& run_start, std::string name);
+        ~PhaseTimer();
+
+        PhaseTimer(const PhaseTimer&) = delete;
+        PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+    private:
+        BacktestRunStats& stats_;
+        std::size_t index_;
+        ClockReading start_;
+    };
+
+} // namespace backtester
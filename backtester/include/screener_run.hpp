@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "candle_source.hpp"
+#include "datatypes.hpp"
+#include "screener.hpp"
+
+namespace backtester {
+
+    using json = nlohmann::json;
+
+    // The screen's result at one bar time
+    struct ScreenSnapshot {
+        core::Timestamp time;
+        std::size_t passed = 0;                           // Before the top-K cut
+        std::vector<std::pair<std::string, double>> hits; // (instrument key, rank_by value), best first
+    };
+
+    struct ScreenRunResult {
+        std::string name;
+        std::vector<std::string> instruments;    // Screened universe
+        std::vector<std::string> excluded;       // No candles in range
+        std::string rank_by;                     // Empty without ranking
+        std::vector<ScreenSnapshot> snapshots;   // In time order
+    };
+
+    // --- ScreenerRun ---
+    // Runs a strategy_engine::Screener over history. The universe comes from the
+    // screen's "instruments" and "universe" block (index constituents and/or the
+    // instrument master, see Backtester::resolveUniverse); every instrument's
+    // candles on the screen's timeframe are loaded and its indicators computed over
+    // the whole range. Bars of all instruments are then replayed in time order: at
+    // each bar time the instruments with a bar update their row (the others keep
+    // their latest values, as they would live) and the screen is scanned.
+    class ScreenerRun {
+    public:
+        explicit ScreenerRun(data::ICandleSource& candle_source);
+
+        // Throws core::ConfigException for an invalid screen, an unknown indicator
+        // or an empty universe. last_bar_only scans once, on every instrument's last
+        // bar in range, instead of at every bar time.
+        ScreenRunResult run(const json& screen_config, const std::string& start_date, const std::string& end_date,
+                            bool last_bar_only = false);
+
+        static void logResult(const ScreenRunResult& result, std::size_t max_snapshots = 5);
+        // timestamp,rank,instrument_key,value,passed rows (one per hit)
+        static bool writeCsv(const std::string& path, const ScreenRunResult& result);
+
+    private:
+        data::ICandleSource& candle_source_;
+    };
+
+} // namespace backtester
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "candle_source.hpp"
+#include "portfolio.hpp"           // BacktestMetrics, PortfolioState
+#include "candle_data_cache.hpp"
+#include "indicator_cache.hpp"
+#include "parameter_sweep.hpp"     // SweepSpec, ParameterSet
+#include "backtester.hpp"         // EvaluationMode
+
+namespace backtester {
+
+    using json = nlohmann::json;
+
+    // Parsed "walk_forward" block plus the strategy's "sweep" block:
+    //   "walk_forward": {"in_sample_days": 730, "out_of_sample_days": 180, "step_days": 180}
+    // step_days defaults to out_of_sample_days (back-to-back test windows).
+    struct WalkForwardSpec {
+        SweepSpec sweep;          // Grid optimized in every in-sample window (stop criteria apply, halving does not)
+        int in_sample_days = 0;
+        int out_of_sample_days = 0;
+        int step_days = 0;
+    };
+
+    // Calendar dates (YYYY-MM-DD, inclusive) of one window
+    struct WalkForwardWindow {
+        std::string in_sample_start;
+        std::string in_sample_end;
+        std::string out_of_sample_start;
+        std::string out_of_sample_end;
+    };
+
+    struct WalkForwardWindowResult {
+        WalkForwardWindow window;
+        ParameterSet best_parameters;       // Best in-sample combination by sweep.rank_by
+        BacktestMetrics in_sample;          // Of the best combination
+        BacktestMetrics out_of_sample;      // Best combination on the test window
+        std::vector<PortfolioState> out_of_sample_equity;
+        std::size_t combinations_run = 0;
+        bool success = false;               // An in-sample winner was found and tested
+    };
+
+    struct WalkForwardResult {
+        std::vector<WalkForwardWindowResult> windows; // In window order
+        // Out-of-sample curves chained end to end: each window starts from the
+        // previous window's final equity (returns compound)
+        std::vector<PortfolioState> stitched_equity;
+        double total_return_pct = 0.0;     // Of the stitched curve
+        double max_drawdown_pct = 0.0;
+    };
+
+    // --- WalkForward ---
+    // Rolls an in-sample optimization window and the out-of-sample window after it
+    // across [start_date, end_date]. Every window is independent, so all in-sample
+    // runs of all windows go onto one work-stealing pool at once; the last in-sample
+    // run of a window picks the winner and queues that window's out-of-sample run.
+    //
+    // Every run loads and computes indicators over the full range and only trades
+    // its window (Backtester::setEvaluationRange), so candles are loaded once and
+    // each indicator spec is computed once per instrument for all windows.
+    class WalkForward {
+    public:
+        WalkForward(data::ICandleSource& candle_source, double initial_capital, std::size_t num_threads = 0);
+
+        // Throws core::ConfigException if either block is missing or invalid
+        static WalkForwardSpec parseSpec(const json& strategy_config);
+        static std::vector<WalkForwardWindow> planWindows(const WalkForwardSpec& spec,
+                                                          const std::string& start_date,
+                                                          const std::string& end_date);
+
+        WalkForwardResult run(const WalkForwardSpec& spec, const std::string& start_date, const std::string& end_date);
+
+        static void logResults(const WalkForwardResult& result, const WalkForwardSpec& spec);
+        // timestamp,cash,positions_value,total_equity rows of the stitched curve
+        static bool writeEquityCsv(const std::string& path, const WalkForwardResult& result);
+
+        void setIndicatorCache(std::shared_ptr<indicators::IndicatorCache> cache) { indicator_cache_ = std::move(cache); }
+        std::shared_ptr<CandleDataCache> getDataCache() const { return data_cache_; }
+        void setEvaluationMode(EvaluationMode mode) { evaluation_mode_ = mode; }
+
+    private:
+        data::ICandleSource& candle_source_;
+        double initial_capital_;
+        std::size_t num_threads_;
+        std::shared_ptr<CandleDataCache> data_cache_;
+        std::shared_ptr<indicators::IndicatorCache> indicator_cache_;
+        EvaluationMode evaluation_mode_ = EvaluationMode::Vectorized;
+    };
+
+} // namespace backtester
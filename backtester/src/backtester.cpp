@@ -1,24 +1,74 @@
 #include "backtester.hpp"
 #include "strategy_factory.hpp" // Need factory to create strategy
-#include "sma_indicator.hpp"    // Need concrete indicators for createIndicator factory <<< USE SHORT PATH
-#include "rsi_indicator.hpp"
+#include "indicator_registry.hpp" // Indicator specs -> instances for createIndicator
 #include "common_types.hpp" 
 #include "logging.hpp"          // <<< USE SHORT PATH
 #include "utils.hpp"            // <<< USE SHORT PATH
 #include "exceptions.hpp"       // <<< USE SHORT PATH
+#include "candle_resampler.hpp"
 
 #include <stdexcept>
 #include <iostream>
-#include <regex>       // For parsing indicator names
 #include <string>      // For std::stoi
 #include <utility>     // For std::pair
+#include <tuple>       // For std::tie
+#include <algorithm>   // For std::find, std::max
+#include <functional>  // For std::greater
+#include <queue>       // For the k-way merge heap
+#include <chrono>
+#include <limits>
 
 namespace backtester {
 
-    Backtester::Backtester(data::DatabaseManager& db_manager, double initial_capital)
-        : db_manager_(db_manager), initial_capital_(initial_capital)
+    namespace { // File-local helpers
+
+        // 'head' followed by 'tail' in newly owned columns (streaming: carried bars + next chunk)
+        core::CandleSeries appendBars(const core::CandleSeries& head, const core::CandleSeries& tail) {
+            struct Columns {
+                std::vector<std::int64_t> timestamps_ns;
+                std::vector<double> open, high, low, close, volume;
+                std::vector<std::int64_t> open_interest;
+            };
+            auto join = [](auto& out, auto first, auto second) {
+                out.reserve(first.size() + second.size());
+                out.assign(first.begin(), first.end());
+                out.insert(out.end(), second.begin(), second.end());
+            };
+            auto columns = std::make_shared<Columns>();
+            join(columns->timestamps_ns, head.timestampsNs(), tail.timestampsNs());
+            join(columns->open, head.open(), tail.open());
+            join(columns->high, head.high(), tail.high());
+            join(columns->low, head.low(), tail.low());
+            join(columns->close, head.close(), tail.close());
+            join(columns->volume, head.volume(), tail.volume());
+            // Open interest is kept only if every bar has it
+            if (tail.hasOpenInterest() && (head.empty() || head.hasOpenInterest())) {
+                join(columns->open_interest, head.openInterest(), tail.openInterest());
+            } else if (tail.empty() && head.hasOpenInterest()) {
+                columns->open_interest.assign(head.openInterest().begin(), head.openInterest().end());
+            }
+            return core::CandleSeries(columns, columns->timestamps_ns, columns->open, columns->high, columns->low,
+                                      columns->close, columns->volume, columns->open_interest);
+        }
+
+        // Periods of warm-up a streaming run carries for recursive indicators by default:
+        // EMA weights decay as (1 - 2/(n+1))^k, Wilder's RSI/ATR/ADX as (1 - 1/n)^k, so
+        // after 10 periods the seed's share is below e^-10
+        constexpr std::size_t kRecursiveWarmupPeriods = 10;
+
+        // Indicators whose value depends on every earlier bar, not just the lookback window
+        bool isRecursiveIndicator(const std::string& spec) {
+            const std::string type = indicators::parseIndicatorSpec(spec).type;
+            return type == "EMA" || type == "RSI" || type == "MACD" || type == "ATR" || type == "ADX" ||
+                   type == "SUPERTREND";
+        }
+
+    } // namespace
+
+    Backtester::Backtester(data::ICandleSource& candle_source, double initial_capital)
+        : candle_source_(candle_source), initial_capital_(initial_capital)
     {
-        portfolio_ = std::make_unique<Portfolio>(initial_capital_);
+        portfolio_ = std::make_unique<Portfolio>(initial_capital_, arena_.resource());
         core::logging::getLogger()->debug("Backtester initialized with capital: {}", initial_capital_);
     }
 
@@ -33,570 +83,1176 @@ namespace backtester {
     logger->info("Strategy Config: {}", strategy_config.dump(2)); // Log loaded config
     logger->info("Period: {} to {}", start_date, end_date);
 
-    // Reset portfolio for new run
-    portfolio_ = std::make_unique<Portfolio>(initial_capital_);
+    // Reset portfolio and results for new run. Everything the last run put in the
+    // arena is destroyed first, then its memory comes back in one release.
+    instruments_.clear();
+    portfolio_.reset();
+    arena_.release();
+    portfolio_ = std::make_unique<Portfolio>(initial_capital_, arena_.resource());
+    portfolio_->setKeepEquityCurve(!streaming_ || streaming_->keep_equity_curve);
+    metrics_ = BacktestMetrics{};
+    stop_reason_ = nullptr;
+    run_stats_ = BacktestRunStats{};
+    run_start_ = ClockReading::now();
+    // Totals are filled in however run() returns
+    struct StatsFinisher {
+        BacktestRunStats& stats;
+        const ClockReading& start;
+        ~StatsFinisher() { stats.finish(start); }
+    } stats_finisher{run_stats_, run_start_};
 
     try {
-    // 1. Load Strategy
-    strategy_ = strategy_engine::StrategyFactory::createStrategy(strategy_config);
-    if (!strategy_) {
-    logger->error("Failed to load strategy from config.");
-    return false;
-    }
-    logger->info("Strategy '{}' loaded successfully.", strategy_->getName());
-
-    // Ensure DB is connected before loading data
-    if (!db_manager_.isConnected()) {
+    // Ensure DB is connected before resolving the universe and loading data
+    if (!candle_source_.isConnected()) {
     logger->info("Connecting to DB for backtest data...");
-    if (!db_manager_.connect()) {
+    if (!candle_source_.connect()) {
         logger->error("Failed to connect to DB for backtest.");
         return false;
     }
     }
 
+    // 1. Load Strategy (one instance per instrument)
+    {
+    PhaseTimer timer(run_stats_, run_start_, "strategy_load");
+    if (!createStrategies(resolveUniverse(candle_source_, strategy_config, start_date))) {
+    logger->error("Failed to load strategy from config.");
+    return false;
+    }
+    }
+    logger->info("Strategy '{}' loaded successfully for {} instrument(s).",
+                 instruments_.front().strategy->getName(), instruments_.size());
+    execution_ = ExecutionConfig::fromJson(strategy_config.value("execution", json()));
+
+    // Worker threads for loading instruments, calculating indicators and evaluating instruments side by side
+    const std::size_t threads = core::ThreadPool::resolveThreadCount(instrument_threads_);
+    if (threads <= 1) {
+         pool_.reset();
+    } else if (!pool_ || pool_->size() != threads) {
+         pool_ = std::make_unique<core::ThreadPool>(threads);
+    }
+
+    if (streaming_) {
+    // 2-4. Load, calculate and evaluate chunk by chunk
+    if (PhaseTimer timer(run_stats_, run_start_, "streaming"); !runStreaming(start_date, end_date)) {
+    logger->error("Streaming backtest failed.");
+    return false;
+    }
+    } else {
     // 2. Load Data
-    if (!loadData(start_date, end_date)) {
+    if (PhaseTimer timer(run_stats_, run_start_, "load_data"); !loadData(start_date, end_date)) {
     logger->error("Failed to load required data for backtest period.");
     // Disconnect DB if we connected it
-    // db_manager_.disconnect(); // Or let caller manage connection
+    // candle_source_.disconnect(); // Or let caller manage connection
     return false;
     }
 
     // 3. Create & Calculate Indicators
-    if (!createAndCalculateIndicators()) {
+    if (PhaseTimer timer(run_stats_, run_start_, "indicators"); !createAndCalculateIndicators()) {
     logger->error("Failed to create/calculate required indicators.");
-    // db_manager_.disconnect();
+    // candle_source_.disconnect();
     return false;
     }
 
     logger->info("Starting event loop...");
+    {
+    PhaseTimer timer(run_stats_, run_start_, "event_loop");
     runEventLoop();
+    }
     logger->info("Event loop finished.");
+    }
+    for (const auto& instrument : instruments_) {
+    if (instrument.strategy) run_stats_.rule_evaluations += instrument.strategy->getRuleEvaluationCount();
+    }
+    run_stats_.executions = static_cast<std::uint64_t>(portfolio_->getTotalExecutions());
 
 
     // 5. Calculate Metrics (Still a stub)
+    {
+    PhaseTimer timer(run_stats_, run_start_, "metrics");
     calculateMetrics();
+    metrics_.stopped_early = (stop_reason_ != nullptr);
+    }
 
     logger->info("========================================================");
-    logger->info("Backtest Run Completed for Strategy '{}'", strategy_->getName());
+    logger->info("Backtest Run Completed for Strategy '{}'", instruments_.front().strategy->getName());
     logger->info("========================================================");
     // Optional: Log final equity or key metrics here
     return true; // Indicate run finished (though logic is incomplete)
 
     } catch (const std::exception& e) {
     logger->critical("Exception during backtest run: {}", e.what());
-    // db_manager_.disconnect(); // Ensure disconnect on error?
+    // candle_source_.disconnect(); // Ensure disconnect on error?
     return false;
     }
     // Consider adding disconnect in finally/destructor if needed
     }
 
+    std::pair<core::Timestamp, core::Timestamp> Backtester::queryRangeForDates(const std::string& start_date,
+                                                                               const std::string& end_date)
+    {
+        // Convert start/end dates (YYYY-MM-DD) to Timestamps for query
+        // Assume we query from start of start_date to *end* of end_date
+        // Adjust time/timezone details to match database storage (+05:30)
+        return {core::utils::stringToTimestamp(start_date + "T00:00:00+05:30"),
+                core::utils::stringToTimestamp(end_date + "T23:59:59+05:30")};
+    }
+
+    json Backtester::resolveUniverse(data::ICandleSource& candle_source, const json& strategy_config,
+                                     const std::string& start_date)
+    {
+        if (!strategy_config.contains("universe")) return strategy_config;
+
+        const json& universe = strategy_config["universe"];
+        const bool by_index = universe.is_object() && universe.contains("index");
+        const bool by_master = universe.is_object() && (universe.contains("exchange") || universe.contains("segment"));
+        if (!universe.is_object() || (!by_index && !by_master) ||
+            (by_index && !universe["index"].is_string()) ||
+            (universe.contains("exchange") && !universe["exchange"].is_string()) ||
+            (universe.contains("segment") && !universe["segment"].is_string())) {
+            throw core::ConfigException(
+                "'universe' must be an object with an 'index' and/or 'exchange'/'segment' (string) keys.");
+        }
+        const std::string index_key = by_index ? universe["index"].get<std::string>() : std::string();
+        const std::string as_of = universe.value("as_of", start_date);
+        const std::string exchange = universe.value("exchange", std::string());
+        const std::string segment = universe.value("segment", std::string());
+        const std::string description = by_index ? fmt::format("'{}' (as of {})", index_key, as_of)
+                                                 : fmt::format("exchange '{}' segment '{}'", exchange, segment);
+
+        json resolved = strategy_config;
+        std::vector<std::string> instruments;
+        if (resolved.contains("instruments") && resolved["instruments"].is_array()) {
+            instruments = resolved["instruments"].get<std::vector<std::string>>();
+        }
+        std::vector<std::string> members;
+        if (by_index) {
+            members = candle_source.queryIndexConstituents(index_key, as_of);
+            if (by_master) {
+                // Both given: index members that are also listed on that exchange/segment
+                const auto listed = candle_source.queryInstruments(exchange, segment);
+                std::erase_if(members, [&](const std::string& key) {
+                    return !std::binary_search(listed.begin(), listed.end(), key);
+                });
+            }
+        } else {
+            members = candle_source.queryInstruments(exchange, segment);
+        }
+        for (auto& key : members) {
+            if (std::find(instruments.begin(), instruments.end(), key) == instruments.end()) {
+                instruments.push_back(std::move(key));
+            }
+        }
+        if (instruments.empty()) {
+            throw core::ConfigException(fmt::format(
+                "Universe {} has no instruments and no explicit instruments were given.", description));
+        }
+        core::logging::getLogger()->info("Universe {} resolved to {} instruments.", description, instruments.size());
+        resolved["instruments"] = instruments;
+        resolved.erase("universe");
+        return resolved;
+    }
+
+    bool Backtester::createStrategies(const json& strategy_config) {
+        auto logger = core::logging::getLogger();
+        instruments_.clear();
+
+        auto prototype = strategy_engine::StrategyFactory::createStrategy(strategy_config, &arena_);
+        if (!prototype) return false;
+        const std::vector<std::string> keys = prototype->getRequiredInstruments();
+
+        // Each instrument needs its own position state, so every instrument gets a
+        // fresh strategy instance; the prototype is reused for the first one
+        instruments_.reserve(keys.size());
+        for (std::size_t i = 0; i < keys.size(); ++i) instruments_.emplace_back(arena_.resource());
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            instruments_[i].instrument_key = keys[i];
+            instruments_[i].strategy = (i == 0) ? std::move(prototype)
+                                                : strategy_engine::StrategyFactory::createStrategy(strategy_config, &arena_);
+            if (!instruments_[i].strategy) {
+                logger->error("Failed to create strategy instance for instrument {}.", keys[i]);
+                instruments_.clear();
+                return false;
+            }
+        }
+        return true;
+    }
+
     bool Backtester::loadData(const std::string& start_date, const std::string& end_date) {
         auto logger = core::logging::getLogger();
         logger->info("Loading historical data for backtest...");
-    
-        if (!strategy_) {
+
+        if (instruments_.empty()) {
             logger->error("Cannot load data: Strategy not loaded yet.");
             return false;
         }
-        if (!db_manager_.isConnected()) {
+        if (!candle_source_.isConnected()) {
              logger->error("Cannot load data: Database not connected.");
              // Should the backtester manage the connection? Or assume it's connected?
              // For now, assume main connects/disconnects. If fails here, return false.
              return false;
         }
-    
-        const auto& instruments = strategy_->getRequiredInstruments();
-        const auto& timeframes = strategy_->getRequiredTimeframes();
-    
-        // --- Simplified Logic: Use first instrument/timeframe ---
-        // TODO: Enhance later to handle multi-instrument / multi-timeframe strategies
-        if(instruments.empty() || timeframes.empty()) {
-             logger->error("Strategy requires no instruments or timeframes.");
+
+        const auto& timeframes = instruments_.front().strategy->getRequiredTimeframes();
+        // Every instrument is loaded on the first timeframe only; indicators on the
+        // other timeframes are resampled from these bars when they are calculated
+        if (timeframes.empty()) {
+             logger->error("Strategy requires no timeframes.");
              return false;
         }
-        primary_instrument_key_ = instruments[0]; // Store the key we loaded
-        std::string primary_timeframe = timeframes[0]; // Assumes this matches DB interval string ('day')
-        logger->info("Primary data target: {} ({})", primary_instrument_key_, primary_timeframe);
-        // --- End Simplification ---
-    
+        primary_timeframe_ = timeframes[0]; // Assumes this matches DB interval string ('day')
+
         try {
-            // Convert start/end dates (YYYY-MM-DD) to Timestamps for query
-            // Assume we query from start of start_date to *end* of end_date
-            // Adjust time/timezone details to match database storage (+05:30)
-            core::Timestamp start_ts = core::utils::stringToTimestamp(start_date + "T00:00:00+05:30");
-            core::Timestamp end_ts = core::utils::stringToTimestamp(end_date + "T23:59:59+05:30");
-    
-            logger->info("Querying database for primary data...");
-            primary_data_ = db_manager_.queryCandles(primary_instrument_key_, primary_timeframe, start_ts, end_ts);
-            logger->info("Loaded {} primary data points.", primary_data_.size());
-    
-            if (primary_data_.empty()) {
-                 logger->error("No primary historical data found for the specified range.");
+            std::tie(query_start_, query_end_) = queryRangeForDates(start_date, end_date);
+
+            auto load = [&](InstrumentState& instrument) {
+                logger->info("Data target: {} ({})", instrument.instrument_key, primary_timeframe_);
+                auto query = [&]() {
+                    logger->info("Querying database for {}...", instrument.instrument_key);
+                    return candle_source_.queryCandleSeries(instrument.instrument_key, primary_timeframe_, query_start_, query_end_);
+                };
+                if (data_cache_) {
+                    const double tick_size = data_cache_->compactStorage()
+                        ? candle_source_.queryTickSize(instrument.instrument_key).value_or(0.0) : 0.0;
+                    instrument.data = data_cache_->getOrLoad(instrument.instrument_key, primary_timeframe_, query_start_, query_end_,
+                                                             query, tick_size);
+                } else {
+                    instrument.data = std::make_shared<const core::CandleSeries>(query());
+                }
+                logger->info("Loaded {} data points for {}.", instrument.data->size(), instrument.instrument_key);
+            };
+            // Sources with per-thread connections (SQLite read pool, mmap files) load instruments in parallel
+            if (pool_ && candle_source_.supportsConcurrentQueries()) {
+                std::vector<std::future<void>> pending;
+                pending.reserve(instruments_.size());
+                for (auto& instrument : instruments_) {
+                    pending.push_back(pool_->submit([&load, &instrument]() { load(instrument); }));
+                }
+                for (auto& f : pending) f.wait(); // Let every load finish before rethrowing
+                for (auto& f : pending) f.get();
+            } else {
+                for (auto& instrument : instruments_) load(instrument);
+            }
+
+            std::size_t total_bars = 0;
+            for (const auto& instrument : instruments_) total_bars += instrument.data->size();
+
+            // Instruments without data simply never trade; the run needs at least one
+            if (total_bars == 0) {
+                 logger->error("No historical data found for any instrument in the specified range.");
                  return false; // Cannot run backtest without data
             }
             return true; // Data loaded successfully
-    
+
         } catch (const std::exception& e) {
              logger->error("Error loading data: {}", e.what());
              return false;
         }
     }
 
-    // Helper to parse indicator name and period (e.g., "SMA(10)")
-    // Returns {name, period} or {name, -1} if no period found
-    // TODO: Move this to a common indicator utility?
-    inline std::pair<std::string, int> parseIndicatorString(const std::string& indicator_str) {
-         static const std::regex indicator_regex(R"((.+)\((\d+)\))"); // e.g., SMA(10)
-         std::smatch match;
-         if (std::regex_match(indicator_str, match, indicator_regex) && match.size() == 3) {
-             try {
-                 // Convert base name to uppercase for consistent matching? Optional.
-                 // std::string base_name = match[1].str();
-                 // std::transform(base_name.begin(), base_name.end(), base_name.begin(), ::toupper);
-                 // return {base_name, std::stoi(match[2].str())};
-                  return {match[1].str(), std::stoi(match[2].str())};
-             } catch (...) { /* ignore stoi error */ }
-         }
-         // Handle names without parentheses (e.g., "ClosePrice") if needed
-         return {indicator_str, -1}; // Return full string and -1 if no period found/parsed
-     }
+    bool Backtester::runStreaming(const std::string& start_date, const std::string& end_date) {
+        auto logger = core::logging::getLogger();
+        const StreamingOptions& options = *streaming_;
+        if (options.chunk_bars == 0) {
+            logger->error("Streaming backtest needs a chunk of at least one bar.");
+            return false;
+        }
+        const auto& timeframes = instruments_.front().strategy->getRequiredTimeframes();
+        if (timeframes.empty()) {
+            logger->error("Strategy requires no timeframes.");
+            return false;
+        }
+        primary_timeframe_ = timeframes[0];
+        const auto interval = data::BarInterval::parse(primary_timeframe_);
+        if (!interval) {
+            logger->error("Streaming backtest: unknown bar interval '{}'.", primary_timeframe_);
+            return false;
+        }
 
-    std::unique_ptr<indicators::IIndicator> Backtester::createIndicator(const std::string& name) {
-         auto logger = core::logging::getLogger();
-         logger->debug("Attempting to create indicator instance for: {}", name);
+        // Bars carried into the next chunk: the longest lookback plus the bar before the
+        // first evaluated one (crossovers read the previous value). Recursive indicators
+        // depend on every earlier bar; about kRecursiveWarmupPeriods periods bring them
+        // close to their full-history values.
+        std::size_t max_lookback = 0;
+        std::size_t recursive_warmup = 0;
+        std::vector<std::string> recursive;
+        for (const auto& name : instruments_.front().strategy->getRequiredIndicatorNames()) {
+            const auto ref = strategy_engine::splitIndicatorTimeframe(name);
+            if (!ref.timeframe.empty() && ref.timeframe != primary_timeframe_) {
+                logger->error("Streaming backtest does not support higher-timeframe indicators ('{}').", name);
+                return false;
+            }
+            const std::string spec = strategy_engine::splitIndicatorOutput(ref.spec).spec;
+            auto indicator = createIndicator(spec);
+            if (!indicator) return false; // Logged by createIndicator
+            const auto lookback = static_cast<std::size_t>(indicator->getLookback());
+            max_lookback = std::max(max_lookback, lookback);
+            if (isRecursiveIndicator(spec) && std::find(recursive.begin(), recursive.end(), indicator->getName()) == recursive.end()) {
+                recursive_warmup = std::max(recursive_warmup, kRecursiveWarmupPeriods * (lookback + 1));
+                recursive.push_back(indicator->getName());
+            }
+        }
+        std::size_t warmup = std::max(options.warmup_bars, max_lookback + 1);
+        if (recursive_warmup > 0 && options.warmup_bars == 0) {
+            warmup = std::max(warmup, recursive_warmup);
+            logger->info("Streaming backtest: carrying {} bars for recursive indicator(s) {}.", warmup, fmt::join(recursive, ", "));
+        } else if (recursive_warmup > 0 && options.warmup_bars < recursive_warmup) {
+            logger->warn("Streaming backtest: {} warm-up bars are few for recursive indicator(s) {} ({} recommended); "
+                         "their values after each chunk boundary differ from a full-history run.",
+                         options.warmup_bars, fmt::join(recursive, ", "), recursive_warmup);
+        }
 
-         auto parsed = parseIndicatorString(name);
-         std::string base_name = parsed.first;
-         int period = parsed.second;
+        // Window length in time; months count 31 days, so a window never holds more than chunk_bars bars
+        std::tie(query_start_, query_end_) = queryRangeForDates(start_date, end_date);
+        const std::int64_t bar_ns = interval->nominalNs();
+        const std::int64_t window_ns = (options.chunk_bars > static_cast<std::size_t>(std::numeric_limits<std::int64_t>::max() / bar_ns))
+            ? std::numeric_limits<std::int64_t>::max() : bar_ns * static_cast<std::int64_t>(options.chunk_bars);
+        const std::int64_t end_ns = core::utils::timestampToEpochNanos(query_end_);
+        logger->info("Streaming backtest: windows of {} {} bars, {} bars carried between chunks.",
+                     options.chunk_bars, primary_timeframe_, warmup);
 
-         // Simple factory logic (expand later with more indicators)
-         if (base_name == "SMA") {
-             if (period <= 0) {
-                 logger->error("Invalid period {} for SMA indicator '{}'", period, name);
-                 return nullptr;
-             }
-             logger->debug("Creating SMAIndicator({})", period);
-             return std::make_unique<indicators::SmaIndicator>(period);
-         } else if (base_name == "RSI") {
-            if (period <= 0) {
-                  logger->error("Invalid period {} for RSI indicator '{}'", period, name);
-                  return nullptr;
+        for (auto& instrument : instruments_) {
+            instrument.data = std::make_shared<const core::CandleSeries>(); // Nothing carried yet
+            instrument.carried_bars = 0;
+            instrument.bar_base = 0;
+        }
+
+        std::size_t chunks = 0;
+        std::uint64_t loaded_bars = 0;
+        std::size_t largest_chunk = 0; // Most bars one instrument held at once
+        std::vector<bool> evaluated(instruments_.size(), false);
+        std::vector<CandleDataCache::SeriesPtr> held(instruments_.size());
+        for (std::int64_t from_ns = core::utils::timestampToEpochNanos(query_start_); from_ns <= end_ns; ++chunks) {
+            const std::int64_t to_ns = (end_ns - from_ns < window_ns) ? end_ns : from_ns + window_ns - 1;
+            loadChunk(core::utils::epochNanosToTimestamp(from_ns), core::utils::epochNanosToTimestamp(to_ns));
+            from_ns = to_ns + 1;
+
+            // Instruments without new bars, or still short of the longest lookback, sit
+            // this chunk out and keep what they have for the next one
+            std::size_t ready = 0;
+            for (std::size_t i = 0; i < instruments_.size(); ++i) {
+                InstrumentState& instrument = instruments_[i];
+                if (!instrument.data) continue; // Excluded
+                loaded_bars += instrument.data->size() - instrument.carried_bars;
+                largest_chunk = std::max(largest_chunk, instrument.data->size());
+                if (instrument.data->size() > instrument.carried_bars && instrument.data->size() > max_lookback) {
+                    ++ready;
+                    evaluated[i] = true;
+                } else {
+                    held[i] = std::move(instrument.data);
+                }
             }
-            logger->debug("Creating RsiIndicator({})", period);
-            return std::make_unique<indicators::RsiIndicator>(period);
-       }
-         // --- Add cases for other indicators ---
-         // else if (base_name == "RSI") {
-         //    if (period <= 0) { /* error */ return nullptr; }
-         //    logger->debug("Creating RsiIndicator({})", period);
-         //    return std::make_unique<indicators::RsiIndicator>(period); // Requires RsiIndicator implementation
-         // }
-         // else if (base_name == "MACD") { ... need multiple periods ... }
+            logger->debug("Streaming chunk {}: {} of {} instruments have bars to evaluate.", chunks, ready, instruments_.size());
 
-         logger->error("Unknown indicator name requested by strategy factory: {}", name);
-         return nullptr; // Failed to create
+            if (ready > 0 && createAndCalculateIndicators()) runEventLoop();
+
+            // Carry the warm-up bars over; only they (and the strategies, positions and
+            // resting orders) survive into the next chunk
+            for (std::size_t i = 0; i < instruments_.size(); ++i) {
+                InstrumentState& instrument = instruments_[i];
+                if (held[i]) instrument.data = std::move(held[i]);
+                instrument.indicator_results.clear();
+                instrument.signals.clear();
+                if (!instrument.data) continue; // Excluded (failed indicator)
+                const std::size_t size = instrument.data->size();
+                const std::size_t keep = std::min(warmup, size);
+                instrument.bar_base += size - keep;
+                instrument.data = std::make_shared<const core::CandleSeries>(instrument.data->slice(size - keep, size));
+            }
+            if (stop_reason_) break; // A stop criterion ended the run
+        }
+
+        if (loaded_bars == 0) {
+            logger->error("No historical data found for any instrument in the specified range.");
+            return false;
+        }
+        if (std::find(evaluated.begin(), evaluated.end(), true) == evaluated.end()) {
+            logger->error("No instrument has more bars than the longest indicator lookback ({}).", max_lookback);
+            return false;
+        }
+        logger->info("Streaming backtest: {} chunks, {} bars loaded, at most {} bars held per instrument.",
+                     chunks, loaded_bars, largest_chunk);
+        return true;
+    }
+
+    void Backtester::loadChunk(core::Timestamp from, core::Timestamp to) {
+        auto load = [&](InstrumentState& instrument) {
+            const core::CandleSeries next = candle_source_.queryCandleSeries(instrument.instrument_key, primary_timeframe_, from, to);
+            instrument.carried_bars = instrument.data->size();
+            instrument.data = std::make_shared<const core::CandleSeries>(appendBars(*instrument.data, next));
+        };
+        if (pool_ && candle_source_.supportsConcurrentQueries()) {
+            std::vector<std::future<void>> pending;
+            pending.reserve(instruments_.size());
+            for (auto& instrument : instruments_) {
+                if (instrument.data) pending.push_back(pool_->submit([&load, &instrument]() { load(instrument); }));
+            }
+            for (auto& f : pending) f.wait(); // Let every load finish before rethrowing
+            for (auto& f : pending) f.get();
+        } else {
+            for (auto& instrument : instruments_) {
+                if (instrument.data) load(instrument);
+            }
+        }
+    }
+
+    std::unique_ptr<indicators::IIndicator> Backtester::createIndicator(const std::string& name) {
+         auto logger = core::logging::getLogger();
+         logger->debug("Attempting to create indicator instance for: {}", name);
+         try {
+             auto indicator = indicators::IndicatorRegistry::instance().create(name);
+             logger->debug("Created {} for '{}'", indicator->getName(), name);
+             return indicator;
+         } catch (const std::invalid_argument& e) {
+             logger->error("Cannot create indicator '{}': {}", name, e.what());
+             return nullptr; // Failed to create
+         }
     }
 
     bool Backtester::createAndCalculateIndicators() {
         auto logger = core::logging::getLogger();
         logger->info("Creating and calculating required indicators...");
-        indicators_.clear();
-        indicator_results_.clear();
-    
-        if (!strategy_) {
+
+        if (instruments_.empty()) {
              logger->error("Cannot create indicators: Strategy not loaded.");
              return false;
         }
-        if (primary_data_.empty()) {
-             logger->error("Cannot calculate indicators: No primary data loaded.");
+
+        // 1. Create every indicator instance and group the slots into jobs (cheap, sequential)
+        std::vector<IndicatorJob> jobs;
+        for (auto& instrument : instruments_) {
+            if (!instrument.data) continue; // Streaming: excluded earlier, or still collecting warm-up bars
+            if (!planIndicators(instrument, jobs) && instruments_.size() > 1) {
+                logger->warn("Instrument {} is excluded from this run.", instrument.instrument_key);
+            }
+        }
+
+        // 2. Calculate the jobs concurrently. They only read the instruments' candles and
+        //    write their own slots, so the results land in slot order whatever the schedule.
+        if (pool_ && jobs.size() > 1) {
+            std::vector<std::future<void>> pending;
+            pending.reserve(jobs.size());
+            for (auto& job : jobs) pending.push_back(pool_->submit([this, &job]() { runIndicatorJob(job); }));
+            for (auto& f : pending) f.get(); // runIndicatorJob records failures in the job
+        } else {
+            for (auto& job : jobs) runIndicatorJob(job);
+        }
+
+        // 3. Merge: an instrument with a failed job is left out of the run; the run
+        //    itself only fails if no instrument is usable
+        for (const auto& job : jobs) {
+            if (job.error.empty() || !job.instrument->data) continue;
+            logger->error("{}", job.error);
+            job.instrument->data.reset();
+            if (instruments_.size() > 1) logger->warn("Instrument {} is excluded from this run.", job.instrument->instrument_key);
+        }
+        const auto usable = std::count_if(instruments_.begin(), instruments_.end(),
+                                          [](const InstrumentState& instrument) { return instrument.data != nullptr; });
+        return usable > 0;
+    }
+
+    bool Backtester::planIndicators(InstrumentState& instrument, std::vector<IndicatorJob>& jobs) {
+        auto logger = core::logging::getLogger();
+        instrument.indicators.clear();
+        instrument.indicator_results.clear();
+        instrument.result_offsets.clear();
+
+        if (!instrument.data || instrument.data->empty()) {
+             logger->error("Cannot calculate indicators: No data loaded for {}.", instrument.instrument_key);
+             instrument.data.reset(); // Marks the instrument as unusable for the event loop
              return false;
         }
-    
-        const auto& required_names = strategy_->getRequiredIndicatorNames();
+
+        const auto& required_names = instrument.strategy->getRequiredIndicatorNames();
         if (required_names.empty()) {
              logger->info("No specific indicators required by strategy.");
              return true; // Nothing to do
         }
-    
+
         logger->debug("Strategy requires indicators: {}", fmt::join(required_names, ", "));
-    
-        bool all_successful = true;
-        for (const std::string& name : required_names) {
+
+        const core::CandleSeries& bars = *instrument.data;
+        instrument.indicators.resize(required_names.size());
+        instrument.indicator_results.resize(required_names.size());
+        instrument.result_offsets.resize(required_names.size());
+        // A multi-output indicator referenced through several outputs ("MACD(12,26,9)" and
+        // "MACD(12,26,9).signal") is one job per timeframe, calculated once
+        const std::size_t first_job = jobs.size();
+        std::map<std::string, std::size_t> job_of; // Indicator name + timeframe -> index into 'jobs'
+        for (std::size_t slot = 0; slot < required_names.size(); ++slot) { // Iteration order == slot order
+             const std::string& name = required_names[slot];
              logger->debug("Processing required indicator: {}", name);
-             auto indicator = createIndicator(name); // Use helper factory method
+             const auto ref = strategy_engine::splitIndicatorTimeframe(name);
+             const auto selected = strategy_engine::splitIndicatorOutput(ref.spec);
+             const bool resampled = !ref.timeframe.empty() && ref.timeframe != primary_timeframe_;
+             auto indicator = createIndicator(selected.spec); // Use helper factory method
              if (!indicator) {
                   logger->error("Failed to create indicator instance for '{}'. Backtest cannot proceed accurately.", name);
-                  all_successful = false;
-                  // Decide: continue without indicator, or stop backtest? Let's stop for now.
-                  // To continue, use: continue;
+                  jobs.resize(first_job);
+                  instrument.data.reset();
                   return false; // Stop if any required indicator fails
              }
-    
-             logger->info("Calculating indicator: {}", indicator->getName()); // Use name from instance
-             try {
-                if (primary_data_.size() <= static_cast<size_t>(indicator->getLookback())) {
-                     logger->error("Not enough primary data ({}) to calculate indicator '{}' which needs lookback {}.",
-                                  primary_data_.size(), indicator->getName(), indicator->getLookback());
-                     all_successful = false;
-                     return false; // Stop if not enough data for calculation
-                }
-    
-                indicator->calculate(primary_data_); // Calculate using loaded data
-    
-                // Store results - make a copy
-                indicator_results_[indicator->getName()] = indicator->getResult();
-                // Store the indicator instance itself (for lookback info etc.)
-                indicators_[indicator->getName()] = std::move(indicator);
-    
-                 logger->info(" -> Calculated {} result points for {}.",
-                              indicator_results_[indicators_[name]->getName()].size(), // Get name again safely
-                              indicators_[name]->getName()); // Use name from stored indicator
-    
-             } catch (const std::exception& e) {
-                  logger->error("Exception calculating indicator '{}': {}", name, e.what());
-                  all_successful = false;
-                   return false; // Stop if calculation fails
+             std::size_t output = 0;
+             if (!selected.output.empty()) {
+                  while (output < indicator->getOutputCount() && indicator->getOutputName(output) != selected.output) ++output;
+                  if (output == indicator->getOutputCount()) {
+                       logger->error("Indicator '{}' has no output '{}' (requested as '{}').", indicator->getName(), selected.output, name);
+                       jobs.resize(first_job);
+                       instrument.data.reset();
+                       return false;
+                  }
              }
+             if (!resampled && bars.size() <= static_cast<std::size_t>(indicator->getLookback())) {
+                  logger->error("Not enough data ({}) for {} to calculate indicator '{}' which needs lookback {}.",
+                               bars.size(), instrument.instrument_key, indicator->getName(), indicator->getLookback());
+                  jobs.resize(first_job);
+                  instrument.data.reset();
+                  return false; // Stop if not enough data for calculation
+             }
+
+             const std::string timeframe = resampled ? ref.timeframe : std::string();
+             const std::string key = fmt::format("{}{}{}", indicator->getName(), strategy_engine::kIndicatorTimeframeSeparator, timeframe);
+             auto [it, inserted] = job_of.emplace(key, jobs.size());
+             if (inserted) jobs.push_back({&instrument, indicator->getName(), timeframe, {}, {}});
+             jobs[it->second].slots.push_back({slot, output});
+             // Store the indicator instance itself (for lookback info etc.)
+             instrument.indicators[slot] = std::move(indicator);
+        }
+        return true;
+    }
+
+    void Backtester::runIndicatorJob(IndicatorJob& job) {
+        auto logger = core::logging::getLogger();
+        InstrumentState& instrument = *job.instrument;
+        const core::CandleSeries& bars = *instrument.data;
+        const bool resampled = !job.timeframe.empty();
+        const auto& required_names = instrument.strategy->getRequiredIndicatorNames();
+
+        try {
+            // Calculated on the first cache miss, then shared by the job's other slots
+            std::unique_ptr<indicators::IIndicator> source;
+            CandleDataCache::ResampledPtr higher;
+            auto calculated = [&]() -> indicators::IIndicator* {
+                if (!source) {
+                    source = createIndicator(job.spec); // Canonical name, cannot fail after planning
+                    const auto lookback = static_cast<std::size_t>(source->getLookback());
+                    if (resampled) {
+                        higher = resampleBars(instrument, job.timeframe);
+                        if (higher->bars.size() > lookback) source->calculate(higher->bars);
+                    } else {
+                        source->calculate(bars);
+                    }
+                }
+                return source.get();
+            };
+
+            for (const auto& [slot, output] : job.slots) {
+                const std::string& name = required_names[slot];
+                const indicators::IIndicator& indicator = *instrument.indicators[slot];
+                const auto lookback = static_cast<std::size_t>(indicator.getLookback());
+                logger->info("Calculating indicator: {} for {}", name, instrument.instrument_key);
+
+                // The only slot of a job takes the results without a copy
+                auto compute = [&, output = output]() -> core::TimeSeries<double> {
+                    indicators::IIndicator* values_of = calculated();
+                    if (resampled && higher->bars.size() <= lookback) return {}; // Reported below
+                    core::TimeSeries<double> values = (job.slots.size() == 1) ? values_of->releaseOutput(output)
+                                                                               : values_of->getOutput(output);
+                    if (resampled) return alignToBaseBars(*higher, values, lookback, bars.size());
+                    return values;
+                };
+                // Output 0 is cached under the plain indicator name, so "BBANDS(20,2)" and
+                // "BBANDS(20,2).middle" share one entry
+                std::string cache_spec = indicator.getName();
+                if (output > 0) cache_spec += strategy_engine::kIndicatorOutputSeparator + indicator.getOutputName(output);
+                // Resampled results are aligned to the base bars, so they are cached under the base interval
+                if (resampled) cache_spec += strategy_engine::kIndicatorTimeframeSeparator + job.timeframe;
+                // Streaming chunks are not cacheable: their bars change from chunk to chunk
+                if (indicator_cache_ && !streaming_) {
+                    instrument.indicator_results[slot] = indicator_cache_->getOrCompute(
+                        instrument.instrument_key, primary_timeframe_, query_start_, query_end_,
+                        cache_spec, bars, compute);
+                } else {
+                    instrument.indicator_results[slot] = std::make_shared<const core::TimeSeries<double>>(compute());
+                }
+
+                const auto& results = *instrument.indicator_results[slot];
+                if (resampled && results.empty()) {
+                     job.error = fmt::format("Not enough {} bars for {} to calculate indicator '{}' which needs lookback {}.",
+                                             job.timeframe, instrument.instrument_key, indicator.getName(), lookback);
+                     return;
+                }
+                // Aligned results always run to the last base bar
+                instrument.result_offsets[slot] = resampled ? bars.size() - results.size() : lookback;
+                logger->info(" -> Calculated {} result points for {}.", results.size(), name);
+            }
+        } catch (const std::exception& e) {
+            job.error = fmt::format("Exception calculating indicator '{}' for {}: {}", job.spec, instrument.instrument_key, e.what());
+        }
+    }
+
+    CandleDataCache::ResampledPtr Backtester::resampleBars(const InstrumentState& instrument, const std::string& timeframe) {
+        auto logger = core::logging::getLogger();
+        const core::CandleSeries& bars = *instrument.data;
+
+        // Built from the already loaded base bars (no DB query), shared through the cache
+        CandleDataCache::ResampledPtr higher;
+        if (data_cache_) {
+            higher = data_cache_->getOrResample(instrument.instrument_key, primary_timeframe_, timeframe,
+                                                query_start_, query_end_, bars);
+        } else {
+            higher = std::make_shared<const data::ResampledSeries>(data::resampleCandles(bars, primary_timeframe_, timeframe));
         }
-        return all_successful;
+        logger->debug("Resampled {} {} bars of {} into {} {} bars.",
+                      bars.size(), primary_timeframe_, instrument.instrument_key, higher->bars.size(), timeframe);
+        return higher;
+    }
+
+    core::TimeSeries<double> Backtester::alignToBaseBars(const data::ResampledSeries& higher,
+                                                         const core::TimeSeries<double>& values, // values[k] is higher bar k + lookback
+                                                         std::size_t lookback,
+                                                         std::size_t base_bars)
+    {
+        // At base bar i only higher bars [0, completed[i]) are closed, so the value
+        // shown is the one of bar completed[i] - 1: no bar is seen before it closes
+        core::TimeSeries<double> aligned;
+        const auto& completed = higher.completed;
+        const auto first = static_cast<std::size_t>(
+            std::lower_bound(completed.begin(), completed.end(), lookback + 1) - completed.begin());
+        aligned.reserve(base_bars - first);
+        for (std::size_t i = first; i < base_bars; ++i) {
+            const std::size_t k = completed[i] - 1 - lookback;
+            aligned.push_back(k < values.size() ? values[k] : strategy_engine::kMissingIndicatorValue);
+        }
+        return aligned;
     }
 
     // --- Implement runEventLoop ---
+    // Bars of all instruments are visited in timestamp order through a k-way merge
+    // (min-heap of per-instrument cursors). All bars sharing a timestamp form one
+    // step: their strategies are evaluated first (optionally in parallel, each
+    // touching only its own InstrumentState), then the resulting signals are executed
+    // against the shared Portfolio in instrument order, and equity is recorded once.
     void Backtester::runEventLoop() {
           auto logger = core::logging::getLogger();
-     
-          // --- Prerequisite Checks ---
-          if (!strategy_) {
-          logger->error("Cannot run event loop: Strategy is not loaded.");
+
+          if (!portfolio_) {
+          logger->error("Cannot run event loop: Portfolio is not initialized.");
           return;
           }
-          if (primary_data_.empty()) {
-          logger->error("Cannot run event loop: No primary market data loaded.");
+
+          // --- Prepare instruments: lookback, buffers, price slots ---
+          std::vector<InstrumentState*> active;
+          std::size_t max_equity_points = 0; // Upper bound on distinct timestamps
+          for (auto& instrument : instruments_) {
+               if (!instrument.data) continue; // Excluded (no data / indicator failure)
+
+               std::size_t max_lookback = 0;
+               for (std::size_t slot = 0; slot < instrument.indicators.size(); ++slot) {
+                    if (instrument.indicators[slot]) { // Check if indicator pointer is valid
+                         max_lookback = std::max(max_lookback, instrument.result_offsets[slot]);
+                    } else {
+                         logger->error("Null indicator found in slot {} of {} during lookback calculation!",
+                                       slot, instrument.instrument_key);
+                    }
+               }
+               const core::CandleSeries& bars = *instrument.data;
+               if (bars.size() <= max_lookback) {
+                    logger->error("Not enough data ({}) for {} to cover maximum lookback ({}).",
+                                  bars.size(), instrument.instrument_key, max_lookback);
+                    continue;
+               }
+               std::size_t first_bar = std::max(max_lookback, instrument.carried_bars);
+               std::size_t end_bar = bars.size();
+               if (evaluation_range_) {
+                    const auto timestamps = bars.timestampsNs();
+                    const auto from_ns = core::utils::timestampToEpochNanos(evaluation_range_->first);
+                    const auto to_ns = core::utils::timestampToEpochNanos(evaluation_range_->second);
+                    first_bar = std::max(first_bar, static_cast<std::size_t>(
+                        std::lower_bound(timestamps.begin(), timestamps.end(), from_ns) - timestamps.begin()));
+                    end_bar = static_cast<std::size_t>(std::upper_bound(timestamps.begin(), timestamps.end(), to_ns) - timestamps.begin());
+                    if (first_bar >= end_bar) {
+                         logger->info("{}: no bars after lookback inside the evaluation range.", instrument.instrument_key);
+                         continue;
+                    }
+               }
+               logger->info("{}: iterating through {} bars (starting at index {} after lookback).",
+                            instrument.instrument_key, end_bar - first_bar, first_bar);
+
+               instrument.first_bar = first_bar;
+               instrument.end_bar = end_bar;
+               instrument.next_bar = instrument.first_bar;
+               instrument.use_signals = false;
+               instrument.signals.clear();
+               instrument.next_signal = 0;
+               // Per-slot value buffers, allocated once and refilled every bar
+               instrument.current_values.assign(instrument.indicators.size(), strategy_engine::kMissingIndicatorValue);
+               instrument.previous_values.assign(instrument.indicators.size(), strategy_engine::kMissingIndicatorValue);
+               instrument.current_candle = (instrument.first_bar > 0) ? bars.at(instrument.first_bar - 1) : core::Candle{};
+               instrument.previous_candle = core::Candle{};
+               instrument.portfolio_id = portfolio_->addInstrument(instrument.instrument_key);
+               instrument.active = true;
+               active.push_back(&instrument);
+               max_equity_points += instrument.end_bar - instrument.first_bar;
+          }
+          if (active.empty()) {
+          // A streaming chunk may simply lie outside the evaluation range
+          if (!streaming_) logger->error("Cannot run event loop: No instrument has enough data.");
           return;
           }
-          // Optional: Check if indicators map matches strategy requirements
-          if (indicators_.size() != strategy_->getRequiredIndicatorNames().size() && !strategy_->getRequiredIndicatorNames().empty()) {
-               logger->warn("Mismatch between created indicators ({}) and required indicators ({}). Results may be inaccurate.",
-                         indicators_.size(), strategy_->getRequiredIndicatorNames().size());
-               // Consider returning here if strict matching is needed
+          // Last close per instrument, indexed by Portfolio InstrumentId. With these
+          // sized up front, the per-bar Portfolio update never allocates.
+          std::vector<double> current_prices(portfolio_->getInstrumentCount(), 0.0);
+          portfolio_->reserveEquityCurve(max_equity_points);
+
+          // Only worth the pool when several instruments share timestamps
+          core::ThreadPool* pool = (active.size() > 1) ? pool_.get() : nullptr;
+
+          // Precomputed signals assume every signal fills at once; with fill feedback the
+          // strategy has to see its actual position before each bar
+          const bool fill_feedback = execution_.needsFillFeedback();
+          if (evaluation_mode_ == EvaluationMode::Vectorized && fill_feedback) {
+               logger->info("Execution model delays or overrides fills; evaluating strategies bar by bar.");
+          } else if (evaluation_mode_ == EvaluationMode::Vectorized) {
+               std::optional<PhaseTimer> timer; // Timed once per run, not once per streaming chunk
+               if (!streaming_) timer.emplace(run_stats_, run_start_, "precompute_signals");
+               precomputeSignals(pool);
           }
-     
-     
-          // --- Determine Maximum Lookback Period ---
-          int max_lookback = 0;
-          if (indicators_.empty()){
-          logger->info("No indicators used, lookback is 0.");
-          } else {
-          for (const auto& pair : indicators_) {
-               if (pair.second) { // Check if indicator pointer is valid
-                    max_lookback = std::max(max_lookback, pair.second->getLookback());
+
+          // --- k-way merge over the sorted per-instrument timestamp columns ---
+          using Cursor = std::pair<std::int64_t, std::size_t>; // (timestamp ns, index into 'active')
+          std::priority_queue<Cursor, std::vector<Cursor>, std::greater<Cursor>> heap;
+          for (std::size_t k = 0; k < active.size(); ++k) {
+               heap.emplace(active[k]->data->timestampsNs()[active[k]->first_bar], k);
+          }
+
+          // Below this many instruments in one step, handing work to the pool costs more than it saves
+          constexpr std::size_t kMinParallelStep = 16;
+          std::vector<std::size_t> step;                 // Instruments (indices into 'active') at this timestamp
+          std::vector<core::SignalAction> step_signals;
+          std::vector<std::future<void>> pending;
+          // Counted on the loop thread, stored in run_stats_ at the end
+          std::uint64_t bars_processed = 0;
+          std::uint64_t strategy_evaluations = 0;
+          std::uint64_t signals = 0;
+
+          while (!heap.empty()) {
+               const std::int64_t step_ns = heap.top().first;
+               step.clear();
+               // Ties pop in instrument order, so execution order is deterministic
+               while (!heap.empty() && heap.top().first == step_ns) {
+                    step.push_back(heap.top().second);
+                    heap.pop();
+               }
+
+               // --- 0. Resting orders fill against this bar before it is evaluated ---
+               if (fill_feedback) {
+                    for (std::size_t k : step) {
+                         InstrumentState& instrument = *active[k];
+                         if (instrument.orders.empty()) continue;
+                         processOrders(instrument, instrument.next_bar);
+                         syncStrategyPosition(instrument);
+                    }
+               }
+
+               // --- 1. Evaluate strategies (per-instrument state only) ---
+               step_signals.assign(step.size(), core::SignalAction::None);
+               if (pool && step.size() >= kMinParallelStep) {
+                    pending.clear();
+                    const std::size_t chunks = std::min(pool->size(), step.size());
+                    for (std::size_t c = 0; c < chunks; ++c) {
+                         pending.push_back(pool->submit([&, c]() {
+                              for (std::size_t j = c; j < step.size(); j += chunks) {
+                                   InstrumentState& instrument = *active[step[j]];
+                                   step_signals[j] = evaluateBar(instrument, instrument.next_bar);
+                              }
+                         }));
+                    }
+                    for (auto& f : pending) f.get();
                } else {
-                    logger->error("Null indicator found in map for key '{}' during lookback calculation!", pair.first);
-                    // Decide how critical this is - maybe throw or return?
-                    // return;
+                    for (std::size_t j = 0; j < step.size(); ++j) {
+                         InstrumentState& instrument = *active[step[j]];
+                         step_signals[j] = evaluateBar(instrument, instrument.next_bar);
+                    }
+               }
+
+               bars_processed += step.size();
+               for (std::size_t j = 0; j < step.size(); ++j) {
+                    if (!active[step[j]]->use_signals) ++strategy_evaluations;
+                    if (step_signals[j] != core::SignalAction::None) ++signals;
+               }
+
+               // --- 2. Execute signals and advance (shared Portfolio, loop thread only) ---
+               const core::Timestamp timestamp = active[step.front()]->data->timestamp(active[step.front()]->next_bar);
+               for (std::size_t j = 0; j < step.size(); ++j) {
+                    InstrumentState& instrument = *active[step[j]];
+                    const std::size_t bar = instrument.next_bar;
+                    const core::CandleSeries& bars = *instrument.data;
+                    if (step_signals[j] != core::SignalAction::None) {
+                         // Log the signal before attempting execution
+                         TP_LOG_INFO("Time: {}, {} Signal Generated: {}", core::utils::timestampToString(timestamp),
+                                     instrument.instrument_key, static_cast<int>(step_signals[j]));
+                         const core::Candle candle = instrument.use_signals ? bars.at(bar) : instrument.current_candle;
+                         executeSignal(instrument, bar, timestamp, candle, step_signals[j]);
+                         if (fill_feedback) syncStrategyPosition(instrument);
+                    }
+                    current_prices[instrument.portfolio_id] = bars.close()[bar];
+                    if (++instrument.next_bar < instrument.end_bar) {
+                         heap.emplace(bars.timestampsNs()[instrument.next_bar], step[j]);
+                    }
+               }
+
+               // --- 3. Record Portfolio Value for this Timestamp (End of Bar) ---
+               // Instruments without a bar at this timestamp keep their last close
+               portfolio_->recordTimestampValue(timestamp, current_prices);
+
+               if (stop_criteria_) {
+                    stop_reason_ = stop_criteria_->check(portfolio_->getRunningMetrics());
+                    if (stop_reason_) {
+                         logger->info("Stop criterion {} met at {}; ending the run early.",
+                                      stop_reason_, core::utils::timestampToString(timestamp));
+                         break;
+                    }
                }
           }
-          logger->info("Maximum indicator lookback period: {}", max_lookback);
+          for (auto& instrument : instruments_) instrument.active = false;
+          run_stats_.bars_processed += bars_processed; // Summed over streaming chunks
+          run_stats_.strategy_evaluations += strategy_evaluations;
+          run_stats_.signals += signals;
+          logger->trace("Finished event loop processing.");
+
+     } // End runEventLoop
+
+    void Backtester::precomputeSignals(core::ThreadPool* pool) {
+          auto logger = core::logging::getLogger();
+
+          // Independent per instrument (own strategy, own data), so they can run concurrently
+          auto generate = [](InstrumentState& instrument) {
+               const core::CandleSeries& bars = *instrument.data;
+               std::vector<strategy_engine::IndicatorColumn> indicator_columns(instrument.indicators.size());
+               for (std::size_t slot = 0; slot < instrument.indicators.size(); ++slot) {
+                    if (!instrument.indicators[slot]) continue; // Empty column: no values, like a missing slot per bar
+                    indicator_columns[slot].values = *instrument.indicator_results[slot];
+                    indicator_columns[slot].first_bar = instrument.result_offsets[slot];
+               }
+
+               strategy_engine::MarketDataColumns columns;
+               columns.bar_count = bars.size();
+               columns.open = bars.open();
+               columns.high = bars.high();
+               columns.low = bars.low();
+               columns.close = bars.close();
+               columns.indicators = indicator_columns;
+
+               instrument.use_signals = instrument.strategy->generateSignals(columns, instrument.first_bar, instrument.end_bar,
+                                                                             instrument.signals);
+          };
+
+          std::vector<InstrumentState*> targets;
+          for (auto& instrument : instruments_) {
+               if (instrument.active) targets.push_back(&instrument);
           }
-     
-     
-          // --- Check if enough data exists for loop ---
-          if (primary_data_.size() <= static_cast<size_t>(max_lookback)) {
-          logger->error("Not enough primary data ({}) to cover maximum lookback ({}). Cannot run event loop.",
-                         primary_data_.size(), max_lookback);
-          return;
+          if (pool && targets.size() > 1) {
+               std::vector<std::future<void>> pending;
+               pending.reserve(targets.size());
+               for (InstrumentState* instrument : targets) {
+                    pending.push_back(pool->submit([&generate, instrument]() { generate(*instrument); }));
+               }
+               for (auto& f : pending) f.get();
+          } else {
+               for (InstrumentState* instrument : targets) generate(*instrument);
+          }
+
+          std::size_t total_signals = 0;
+          for (InstrumentState* instrument : targets) {
+               if (instrument->use_signals) {
+                    total_signals += instrument->signals.size();
+               } else {
+                    logger->info("Strategy for {} does not support whole-series evaluation; using the per-bar loop.",
+                                 instrument->instrument_key);
+               }
+          }
+          logger->debug("Whole-series evaluation produced {} signals over {} instrument(s).", total_signals, targets.size());
+    }
+
+    core::SignalAction Backtester::evaluateBar(InstrumentState& instrument, std::size_t i) {
+          if (instrument.use_signals) {
+               // Precomputed: only bars with a signal do any work
+               if (instrument.next_signal < instrument.signals.size() && instrument.signals[instrument.next_signal].bar == i) {
+                    return instrument.signals[instrument.next_signal++].action;
+               }
+               return core::SignalAction::None;
           }
-     
-          // --- Main Event Loop ---
-          logger->info("Iterating through {} bars (starting at index {} after lookback)...",
-                    primary_data_.size() - max_lookback, max_lookback);
-     
-          // Start loop from the first index where ALL indicators have a valid value
-          for (size_t i = static_cast<size_t>(max_lookback); i < primary_data_.size(); ++i) {
-     
-          const core::Candle& current_candle = primary_data_[i];
-          // Get previous candle safely (will be null for the very first iteration i == max_lookback)
-          const core::Candle* previous_candle_ptr = (i > 0) ? &primary_data_[i - 1] : nullptr;
-     
-     
-          // --- 1. Create Market Data Snapshot ---
+
+          const core::CandleSeries& bars = *instrument.data;
+          [[maybe_unused]] const auto& indicator_names = instrument.strategy->getRequiredIndicatorNames(); // Trace output only
+
+          // Strategies still work on whole candles: keep the current and previous bar
+          // materialized from the columns, rolling one slot forward per bar
+          instrument.previous_candle = instrument.current_candle;
+          instrument.current_candle = bars.at(i);
+
+          // --- 1. Update Market Data Snapshot ---
+          // The snapshot only holds spans over the instrument's buffers, so there is no allocation here
           strategy_engine::MarketDataSnapshot snapshot;
-          snapshot.current_time = current_candle.timestamp;
-          snapshot.current_candle = &current_candle;
-          snapshot.previous_candle = previous_candle_ptr; // Assign previous candle pointer
-     
-          logger->trace("--- Snapshot for Bar Index: {}, Time: {} ---", i, core::utils::timestampToString(snapshot.current_time));
-     
-          // Populate indicator values map for the *current* candle time 'i'
-          // Populate previous indicator values map for the *previous* candle time 'i-1'
-          bool all_current_indicators_ready = true; // Are all indicators valid for *this* bar?
-          for (const auto& pair : indicators_) {
-               const std::string& name = pair.first;
-               const auto& indicator = pair.second;
+          snapshot.indicator_values = instrument.current_values;
+          snapshot.indicator_values_prev = instrument.previous_values;
+          snapshot.current_time = instrument.current_candle.timestamp;
+          snapshot.current_candle = &instrument.current_candle;
+          // Previous candle is null only for the very first bar of the series
+          snapshot.previous_candle = (i > 0) ? &instrument.previous_candle : nullptr;
+
+          TP_LOG_TRACE("--- Snapshot for {} Bar Index: {}, Time: {} ---", instrument.instrument_key, i,
+                       core::utils::timestampToString(snapshot.current_time));
+
+          // Fill indicator slots for the *current* candle time 'i'
+          // and the *previous* candle time 'i-1'
+          for (std::size_t slot = 0; slot < instrument.indicators.size(); ++slot) {
+               const auto& indicator = instrument.indicators[slot];
                if (!indicator) continue; // Should have been caught earlier ideally
-     
-               // Current value index = i - lookback
-               int result_index = static_cast<int>(i) - indicator->getLookback();
-               const auto& results = indicator_results_[name]; // Get results vector
-     
+
+               // Current value index = i - offset (the lookback for base-timeframe indicators)
+               int result_index = static_cast<int>(i) - static_cast<int>(instrument.result_offsets[slot]);
+               const auto& results = *instrument.indicator_results[slot]; // Get results vector
+
                // Get Current Value
                if (result_index >= 0 && static_cast<size_t>(result_index) < results.size()) {
-                    snapshot.indicator_values[name] = results[static_cast<size_t>(result_index)];
-                    logger->trace(" -> Indicator[{}]: Current Value = {:.4f} (Result Idx {})", name, snapshot.indicator_values[name], result_index);
+                    instrument.current_values[slot] = results[static_cast<size_t>(result_index)];
+                    TP_LOG_TRACE(" -> Indicator[{}]: Current Value = {:.4f} (Result Idx {})", indicator_names[slot], instrument.current_values[slot], result_index);
                } else {
-                    logger->trace(" -> Indicator[{}]: Current Value = N/A (Result Idx {})", name, result_index);
-                    all_current_indicators_ready = false;
+                    instrument.current_values[slot] = strategy_engine::kMissingIndicatorValue;
+                    TP_LOG_TRACE(" -> Indicator[{}]: Current Value = N/A (Result Idx {})", indicator_names[slot], result_index);
                }
-     
+
                // Get Previous Value
                int prev_result_index = result_index - 1;
                if (prev_result_index >= 0 && static_cast<size_t>(prev_result_index) < results.size()) {
-                    snapshot.indicator_values_prev[name] = results[static_cast<size_t>(prev_result_index)];
-                    logger->trace(" -> Indicator[{}]: Previous Value = {:.4f} (Result Idx {})", name, snapshot.indicator_values_prev[name], prev_result_index);
+                    instrument.previous_values[slot] = results[static_cast<size_t>(prev_result_index)];
+                    TP_LOG_TRACE(" -> Indicator[{}]: Previous Value = {:.4f} (Result Idx {})", indicator_names[slot], instrument.previous_values[slot], prev_result_index);
                } else {
-                    logger->trace(" -> Indicator[{}]: Previous Value = N/A (Result Idx {})", name, prev_result_index);
+                    instrument.previous_values[slot] = strategy_engine::kMissingIndicatorValue;
+                    TP_LOG_TRACE(" -> Indicator[{}]: Previous Value = N/A (Result Idx {})", indicator_names[slot], prev_result_index);
                     // If previous value is missing, crossover conditions cannot be evaluated correctly
                }
           }
-     
-          // Optional: Skip evaluation if not all *current* indicators are ready?
-          // if (!all_current_indicators_ready) {
-          //      logger->trace("Skipping evaluation due to missing current indicator data.");
-          //      // STILL need to record portfolio value for equity curve continuity
-          //      std::map<std::string, double> current_prices;
-          //      current_prices[primary_instrument_key_] = current_candle.close;
-          //      portfolio_->recordTimestampValue(snapshot.current_time, current_prices);
-          //      continue; // Skip to next bar
-          // }
-     
-     
+
           // --- 2. Evaluate Strategy ---
-          logger->trace("Evaluating strategy '{}'...", strategy_->getName());
+          TP_LOG_TRACE("Evaluating strategy '{}' for {}...", instrument.strategy->getName(), instrument.instrument_key);
           // Pass the snapshot containing current and previous indicator/candle data
-          core::SignalAction signal = strategy_->evaluate(snapshot);
-     
-     
-          // --- 3. Execute Signal ---
-          if (signal != core::SignalAction::None) {
-               // Log the signal before attempting execution
-               logger->info("Time: {}, Signal Generated: {}", core::utils::timestampToString(snapshot.current_time), static_cast<int>(signal));
-               // Pass current candle for execution price calculation
-               executeSignal(snapshot.current_time, current_candle, signal);
-          }
-     
-     
-          // --- 4. Record Portfolio Value for this Timestamp (End of Bar) ---
-          // Create map of current prices (just the primary instrument's close for now)
-          std::map<std::string, double> current_prices;
-          current_prices[primary_instrument_key_] = current_candle.close;
-          // Record equity AFTER potential trades for this bar are processed
-          portfolio_->recordTimestampValue(snapshot.current_time, current_prices);
-     
-     
-          // --- Loop End ---
-          } // End for loop through primary_data_
-          logger->trace("Finished event loop processing.");
-     
-     } // End runEventLoop
+          return instrument.strategy->evaluate(snapshot);
+    }
 
-    void Backtester::executeSignal(core::Timestamp timestamp, const core::Candle& current_candle, core::SignalAction signal) {
+    long long Backtester::entryQuantity(const InstrumentState& instrument, double price) const {
         auto logger = core::logging::getLogger();
-        if (!strategy_ || !portfolio_) {
-             logger->error("Cannot execute signal: Strategy or Portfolio not initialized.");
-             return;
-        }
-    
-        logger->debug("Executing Signal: Time={}, Signal={}, Candle Close={:.2f}",
-                     core::utils::timestampToString(timestamp), static_cast<int>(signal), current_candle.close);
-    
-        long long current_position = portfolio_->getPositionQuantity(primary_instrument_key_);
-        double execution_price = current_candle.close; // Simple fill at close
-        // TODO: Make commission configurable (e.g., strategy param or backtester setting)
-        double commission_per_share = 0.01; // Example fixed commission per share
-        long long quantity_to_trade = 0; // This will be calculated based on sizing
-    
+        const auto& strategy = instrument.strategy;
+
         // --- Get Sizing Parameters from Strategy ---
-        auto sizing_method = strategy_->getSizingMethod();
-        double sizing_value = strategy_->getSizingValue();
-        bool sizing_is_percentage = strategy_->isSizingValuePercentage();
-    
-    
-        // --- Calculate Trade Quantity based on Sizing Method ---
-        if (signal == core::SignalAction::EnterLong || signal == core::SignalAction::EnterShort) {
-             if (current_position != 0) {
-                 logger->debug("Ignoring Entry signal [{}] because position is not flat ({}).", static_cast<int>(signal), current_position);
-                 return; // Ignore entry if already in position
+        auto sizing_method = strategy->getSizingMethod();
+        double sizing_value = strategy->getSizingValue();
+        bool sizing_is_percentage = strategy->isSizingValuePercentage();
+
+        long long quantity_to_trade = 0;
+        if (sizing_method == strategy_engine::SizingMethod::Quantity) {
+            quantity_to_trade = static_cast<long long>(sizing_value);
+        } else if (sizing_method == strategy_engine::SizingMethod::CapitalBased) {
+             double capital_to_allocate = 0.0;
+             if (sizing_is_percentage) {
+                  // Use Initial Capital for max allocation % (like Streak often does)
+                  // Alternatively use current equity: portfolio_->getCurrentEquity(...) - requires prices map
+                  capital_to_allocate = initial_capital_ * (sizing_value / 100.0);
+             } else {
+                  capital_to_allocate = sizing_value; // Absolute amount
              }
-    
-             if (sizing_method == strategy_engine::SizingMethod::Quantity) {
-                 quantity_to_trade = static_cast<long long>(sizing_value);
-             } else if (sizing_method == strategy_engine::SizingMethod::CapitalBased) {
-                  double capital_to_allocate = 0.0;
-                  if (sizing_is_percentage) {
-                       // Use Initial Capital for max allocation % (like Streak often does)
-                       // Alternatively use current equity: portfolio_->getCurrentEquity(...) - requires prices map
-                       capital_to_allocate = initial_capital_ * (sizing_value / 100.0);
-                  } else {
-                       capital_to_allocate = sizing_value; // Absolute amount
-                  }
-    
-                  if (execution_price > 1e-9) { // Avoid division by zero/tiny price
-                      quantity_to_trade = static_cast<long long>(std::floor(capital_to_allocate / execution_price));
-                  } else {
-                       logger->error("Cannot calculate quantity: Execution price is too low ({}).", execution_price);
-                       quantity_to_trade = 0;
-                  }
+
+             if (price > 1e-9) { // Avoid division by zero/tiny price
+                 quantity_to_trade = static_cast<long long>(std::floor(capital_to_allocate / price));
              } else {
-                  logger->error("Unknown sizing method encountered in executeSignal.");
-                   quantity_to_trade = 0;
+                  logger->error("Cannot calculate quantity: Execution price is too low ({}).", price);
+                  quantity_to_trade = 0;
+             }
+        } else {
+             logger->error("Unknown sizing method encountered in executeSignal.");
+             quantity_to_trade = 0;
+        }
+
+        if (quantity_to_trade <= 0) {
+             logger->warn("Calculated entry quantity is zero or negative ({}). Ignoring signal.", quantity_to_trade);
+             quantity_to_trade = 0; // Ensure it's 0 if calculation failed
+        }
+        return quantity_to_trade;
+    }
+
+    bool Backtester::fillOrder(InstrumentState& instrument, core::Timestamp timestamp, core::SignalAction action,
+                               OrderType type, double price) {
+        const long long current_position = portfolio_->getPositionQuantity(instrument.portfolio_id);
+        const bool is_entry = (action == core::SignalAction::EnterLong || action == core::SignalAction::EnterShort);
+        const bool is_buy = (action == core::SignalAction::EnterLong || action == core::SignalAction::ExitShort);
+        // Limit orders fill at their price or better; market and stop fills pay the slippage
+        const double execution_price = (type == OrderType::Limit) ? price : execution_.slippage.apply(price, is_buy);
+
+        long long quantity_to_trade = 0; // Always positive; the action gives the side
+        if (is_entry) {
+             if (current_position != 0) {
+                 TP_LOG_DEBUG("Ignoring Entry [{}] because position is not flat ({}).", static_cast<int>(action), current_position);
+                 return false; // Ignore entry if already in position
              }
-    
-              if (quantity_to_trade <= 0) {
-                   logger->warn("Calculated entry quantity is zero or negative ({}). Ignoring signal.", quantity_to_trade);
-                   quantity_to_trade = 0; // Ensure it's 0 if calculation failed
-              }
-    
-        } else if (signal == core::SignalAction::ExitLong) {
+             quantity_to_trade = entryQuantity(instrument, execution_price);
+        } else if (action == core::SignalAction::ExitLong) {
              if (current_position > 0) { // Only exit if long
                  quantity_to_trade = current_position; // Exit entire position
-             } else { logger->debug("Ignoring ExitLong signal, not currently long."); return; }
-        } else if (signal == core::SignalAction::ExitShort) {
+             } else { TP_LOG_DEBUG("Ignoring ExitLong, not currently long."); return false; }
+        } else if (action == core::SignalAction::ExitShort) {
              if (current_position < 0) { // Only exit if short
                  quantity_to_trade = -current_position; // Buy back entire position (positive quantity)
-             } else { logger->debug("Ignoring ExitShort signal, not currently short."); return; }
-        } else {
+             } else { TP_LOG_DEBUG("Ignoring ExitShort, not currently short."); return false; }
+        }
+
+        if (quantity_to_trade <= 0) {
+             TP_LOG_DEBUG("No trade executed for [{}] (calculated quantity={}).", static_cast<int>(action), quantity_to_trade);
+             return false;
+        }
+
+        // Calculate commission (brokerage, taxes, charges) for this leg
+        const double commission = execution_.fees.calculate(is_buy, quantity_to_trade, execution_price);
+
+        if (is_buy) {
+             TP_LOG_INFO("-> Attempting to BUY {} shares at {:.2f}", quantity_to_trade, execution_price);
+        } else { // EnterShort or ExitLong
+             TP_LOG_INFO("-> Attempting to SELL {} shares at {:.2f} ({})", quantity_to_trade, execution_price,
+                         (action == core::SignalAction::EnterShort ? "Enter Short" : "Exit Long"));
+        }
+
+        // Pass the original action, positive quantity, price, commission
+        portfolio_->recordTrade(timestamp, instrument.portfolio_id, action, quantity_to_trade, execution_price, commission);
+
+        if (!is_entry) {
+             // Flat again: the stop-loss / target of the closed position go with it
+             instrument.orders.cancelIf([](const PendingOrder& order) { return order.protective; });
+             return true;
+        }
+        // Protective orders rest from the next bar on, priced off the actual fill
+        const bool is_long = (action == core::SignalAction::EnterLong);
+        const auto exit_action = is_long ? core::SignalAction::ExitLong : core::SignalAction::ExitShort;
+        if (execution_.stop_loss_pct > 0.0) {
+             PendingOrder stop;
+             stop.action = exit_action;
+             stop.type = OrderType::Stop;
+             stop.price = execution_price * (is_long ? 1.0 - execution_.stop_loss_pct / 100.0
+                                                     : 1.0 + execution_.stop_loss_pct / 100.0);
+             stop.protective = true;
+             instrument.orders.submit(stop);
+        }
+        if (execution_.take_profit_pct > 0.0) {
+             PendingOrder target;
+             target.action = exit_action;
+             target.type = OrderType::Limit;
+             target.price = execution_price * (is_long ? 1.0 + execution_.take_profit_pct / 100.0
+                                                       : 1.0 - execution_.take_profit_pct / 100.0);
+             target.protective = true;
+             instrument.orders.submit(target);
+        }
+        return true;
+    }
+
+    void Backtester::executeSignal(InstrumentState& instrument, std::size_t bar, core::Timestamp timestamp,
+                                   const core::Candle& current_candle, core::SignalAction signal) {
+        auto logger = core::logging::getLogger();
+        if (!instrument.strategy || !portfolio_) {
+             logger->error("Cannot execute signal: Strategy or Portfolio not initialized.");
+             return;
+        }
+
+        TP_LOG_DEBUG("Executing Signal: Time={}, Signal={}, Candle Close={:.2f}",
+                     core::utils::timestampToString(timestamp), static_cast<int>(signal), current_candle.close);
+
+        const bool is_entry = (signal == core::SignalAction::EnterLong || signal == core::SignalAction::EnterShort);
+        if (!is_entry && signal != core::SignalAction::ExitLong && signal != core::SignalAction::ExitShort) {
              return; // No action for SignalAction::None
         }
-    
-    
-        // --- Record Trade if Quantity > 0 ---
-        if (quantity_to_trade > 0) {
-             // Calculate commission for this leg
-             double commission = commission_per_share * quantity_to_trade;
-    
-             // Log attempt
-             if (signal == core::SignalAction::EnterLong || signal == core::SignalAction::ExitShort) {
-                  logger->info("-> Attempting to BUY {} shares", quantity_to_trade);
-             } else { // EnterShort or ExitLong
-                  logger->info("-> Attempting to SELL {} shares ({})", quantity_to_trade,
-                               (signal == core::SignalAction::EnterShort ? "Enter Short" : "Exit Long"));
+        const bool next_open = (execution_.fill_timing == FillTiming::NextBarOpen);
+
+        if (is_entry) {
+             if (portfolio_->getPositionQuantity(instrument.portfolio_id) != 0 || instrument.orders.hasEntry()) {
+                 TP_LOG_DEBUG("Ignoring Entry signal [{}]: position open or entry order pending.", static_cast<int>(signal));
+                 return;
              }
-    
-             // Pass the original signal, positive quantity, price, commission
-             portfolio_->recordTrade(timestamp, primary_instrument_key_, signal,
-                                     quantity_to_trade,
-                                     execution_price, commission);
-        } else {
-             logger->debug("No trade executed for signal [{}] (calculated quantity={}).", static_cast<int>(signal), quantity_to_trade);
+             PendingOrder order;
+             order.action = signal;
+             order.type = execution_.entry_order_type;
+             if (order.type == OrderType::Market) {
+                 if (!next_open) {
+                     fillOrder(instrument, timestamp, signal, OrderType::Market, current_candle.close); // Fill at close
+                     return;
+                 }
+             } else {
+                 // Long limits rest below the close and long stops above it; shorts the other way round
+                 const bool below = (signal == core::SignalAction::EnterLong) == (order.type == OrderType::Limit);
+                 const double offset = execution_.entry_offset_pct / 100.0;
+                 order.price = current_candle.close * (below ? 1.0 - offset : 1.0 + offset);
+                 if (execution_.entry_valid_bars > 0) order.expires_after_bar = instrument.bar_base + bar + execution_.entry_valid_bars;
+             }
+             instrument.orders.submit(order);
+             TP_LOG_DEBUG("Entry order [{}] queued (type {}, price {:.2f}).", static_cast<int>(signal),
+                          static_cast<int>(order.type), order.price);
+             return;
+        }
+
+        // Exit: the strategy is done with this trade, so an entry still waiting is dropped
+        instrument.orders.cancelIf([](const PendingOrder& order) { return !order.protective; });
+        if (!next_open) {
+             fillOrder(instrument, timestamp, signal, OrderType::Market, current_candle.close);
+             return;
+        }
+        PendingOrder order;
+        order.action = signal;
+        order.type = OrderType::Market;
+        instrument.orders.submit(order);
+    }
+
+    void Backtester::processOrders(InstrumentState& instrument, std::size_t bar) {
+        const core::CandleSeries& bars = *instrument.data;
+        fills_.clear();
+        instrument.orders.match(bars.at(bar), instrument.bar_base + bar, fills_);
+        const core::Timestamp timestamp = bars.timestamp(bar);
+        for (const OrderFill& fill : fills_) {
+             fillOrder(instrument, timestamp, fill.order.action, fill.order.type, fill.price);
+        }
+    }
+
+    void Backtester::syncStrategyPosition(InstrumentState& instrument) const {
+        const long long quantity = portfolio_->getPositionQuantity(instrument.portfolio_id);
+        core::PositionState position = core::PositionState::None;
+        if (quantity > 0) {
+             position = core::PositionState::Long;
+        } else if (quantity < 0) {
+             position = core::PositionState::Short;
+        } else if (instrument.orders.hasEntry()) {
+             // The strategy already acted on its entry; it counts as in the trade until the order fills or expires
+             position = instrument.strategy->getCurrentPosition();
         }
+        if (position != instrument.strategy->getCurrentPosition()) instrument.strategy->setCurrentPosition(position);
     }
 
     void Backtester::calculateMetrics() {
         auto logger = core::logging::getLogger();
         logger->info("Calculating performance metrics...");
-   
-        const auto& equity_curve = portfolio_->getEquityCurve();
-        const auto& trade_log = portfolio_->getTradeLog(); // Get the completed trades
-   
-        if (equity_curve.size() < 2) {
-            logger->warn("Not enough equity points ({}) to calculate metrics.", equity_curve.size());
+
+        // Accumulated by the Portfolio as points and trades were recorded: no pass over
+        // the equity curve (which streaming runs do not keep) or the trade log
+        const MetricsAccumulator& running = portfolio_->getRunningMetrics();
+        if (running.points() < 2) {
+            logger->warn("Not enough equity points ({}) to calculate metrics.", running.points());
             return;
         }
-   
-        BacktestMetrics metrics; // Create instance to store results
+
+        BacktestMetrics metrics = running.metrics(MetricsAccumulator::periodsPerYear(primary_timeframe_));
         metrics.total_executions = portfolio_->getTotalExecutions();
-   
-        // --- PnL and Return ---
-        double final_equity = equity_curve.back().total_equity;
-        // Ensure any open positions are marked-to-market for final equity?
-        // getCurrentEquity already does this based on last candle price passed to recordTimestampValue.
-        metrics.total_pnl = final_equity - initial_capital_;
-        metrics.total_return_pct = (initial_capital_ > 1e-9) ? metrics.total_pnl / initial_capital_ : 0.0;
-   
-        // --- Max Drawdown ---
-        double peak_equity = initial_capital_;
-        double max_drawdown = 0.0;
-        for (const auto& state : equity_curve) {
-            peak_equity = std::max(peak_equity, state.total_equity);
-            double current_drawdown = (peak_equity > 1e-9) ? (peak_equity - state.total_equity) / peak_equity : 0.0;
-            max_drawdown = std::max(max_drawdown, current_drawdown);
-        }
-        metrics.max_drawdown_pct = max_drawdown;
-   
-        // --- Trade-Based Metrics ---
-        metrics.round_trip_trades = static_cast<int>(trade_log.size()); // Count completed round trips
-        int winning_trades = 0;
-        double gross_profit = 0.0;
-        double gross_loss = 0.0;
-   
-        for (const auto& trade : trade_log) {
-             if (trade.pnl > 0) {
-                 winning_trades++;
-                 gross_profit += trade.pnl;
-             } else if (trade.pnl < 0) {
-                  gross_loss += trade.pnl; // Loss is negative
-             }
-             // Ignore trades with PnL == 0 for win rate etc.
-        }
-   
-        int losing_trades = metrics.round_trip_trades - winning_trades; // Excludes zero PnL trades
-   
-        if (metrics.round_trip_trades > 0) {
-            metrics.win_rate = static_cast<double>(winning_trades) / metrics.round_trip_trades;
-        } else {
-             metrics.win_rate = 0.0;
-        }
-   
-        if (std::abs(gross_loss) > 1e-9) {
-            metrics.profit_factor = gross_profit / std::abs(gross_loss);
-        } else if (gross_profit > 1e-9) {
-             metrics.profit_factor = std::numeric_limits<double>::infinity(); // Or some large number
-        } else {
-             metrics.profit_factor = 0.0; // Or 1.0 if no profit/loss? Define convention.
-        }
-   
-   
-         metrics.avg_win_pnl = (winning_trades > 0) ? gross_profit / winning_trades : 0.0;
-         metrics.avg_loss_pnl = (losing_trades > 0) ? gross_loss / losing_trades : 0.0; // Will be negative
-   
-   
-        // --- Sharpe Ratio (Simplified Example - Daily Data) ---
-        // Requires calculating periodic returns from the equity curve
-        if (equity_curve.size() > 1) {
-             std::vector<double> daily_returns;
-             daily_returns.reserve(equity_curve.size() - 1);
-             for (size_t i = 1; i < equity_curve.size(); ++i) {
-                  if (equity_curve[i-1].total_equity > 1e-9) { // Avoid division by zero
-                       daily_returns.push_back((equity_curve[i].total_equity / equity_curve[i-1].total_equity) - 1.0);
-                  } else {
-                       daily_returns.push_back(0.0);
-                  }
-             }
-   
-             if (daily_returns.size() > 1) {
-                  double sum_returns = std::accumulate(daily_returns.begin(), daily_returns.end(), 0.0);
-                  double mean_return = sum_returns / daily_returns.size();
-   
-                  double sq_sum = std::inner_product(daily_returns.begin(), daily_returns.end(), daily_returns.begin(), 0.0);
-                  double std_dev = std::sqrt(sq_sum / daily_returns.size() - mean_return * mean_return);
-   
-                  if (std_dev > 1e-9) {
-                       // Assuming 0% risk-free rate and ~252 trading days per year
-                       double risk_free_rate_daily = 0.0;
-                       double annualization_factor = std::sqrt(252.0); // Adjust if data isn't daily
-                       // metrics.sharpe_ratio = annualization_factor * (mean_return - risk_free_rate_daily) / std_dev;
-                       // Let's skip Sharpe for now as it adds complexity
-                  }
-             }
-        }
-   
-   
+
         // --- Log Metrics ---
         metrics.logMetrics();
-   
-        // Store metrics in Backtester? Add member variable BacktestMetrics results_;
-   }
+
+        // Keep the results available through getMetrics()
+        metrics_ = metrics;
+    }
 
     // Getter added for completeness, might need adjustment
     const Portfolio& Backtester::getPortfolio() const {
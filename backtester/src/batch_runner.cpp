@@ -0,0 +1,242 @@
+#include "batch_runner.hpp"
+#include "strategy_factory.hpp"
+#include "thread_pool.hpp"
+#include "logging.hpp"
+#include "exceptions.hpp"
+#include "spdlog/fmt/bundled/core.h" // Use direct path for safety
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <set>
+#include <tuple>
+#include <utility>
+
+namespace backtester {
+
+    namespace {
+
+        // What the data pass has to provide for one strategy
+        struct StrategyRequirements {
+            json config; // Universe resolved
+            std::string name;
+            std::vector<std::string> instruments;
+            std::string timeframe; // Base timeframe, the one candles are loaded on
+            std::vector<std::string> indicators;
+        };
+
+        StrategyRequirements inspect(data::ICandleSource& candle_source, const json& config, const std::string& start_date) {
+            StrategyRequirements req;
+            req.config = Backtester::resolveUniverse(candle_source, config, start_date);
+            auto strategy = strategy_engine::StrategyFactory::createStrategy(req.config);
+            if (!strategy) throw core::ConfigException("Failed to create strategy from config.");
+            if (strategy->getRequiredTimeframes().empty()) throw core::ConfigException("Strategy requires no timeframes.");
+            req.name = strategy->getName();
+            req.instruments = strategy->getRequiredInstruments();
+            req.timeframe = strategy->getRequiredTimeframes().front();
+            req.indicators = strategy->getRequiredIndicatorNames();
+            return req;
+        }
+
+        std::string displayName(const BatchResult& result) {
+            return result.strategy_name.empty() ? std::filesystem::path(result.file).filename().string()
+                                                : result.strategy_name;
+        }
+
+    } // end anonymous namespace
+
+    BatchRunner::BatchRunner(data::ICandleSource& candle_source, double initial_capital, std::size_t num_threads)
+        : candle_source_(candle_source),
+          initial_capital_(initial_capital),
+          num_threads_(core::ThreadPool::resolveThreadCount(num_threads)),
+          data_cache_(std::make_shared<CandleDataCache>()),
+          indicator_cache_(std::make_shared<indicators::IndicatorCache>())
+    {
+        core::logging::getLogger()->debug("BatchRunner created with {} worker threads.", num_threads_);
+    }
+
+    std::vector<BatchStrategy> BatchRunner::loadDirectory(const std::string& directory) {
+        namespace fs = std::filesystem;
+        std::error_code ec;
+        if (!fs::is_directory(directory, ec)) {
+            throw core::ConfigException("Strategy batch directory not found: " + directory);
+        }
+
+        std::vector<std::string> files;
+        for (const auto& entry : fs::directory_iterator(directory, ec)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".json") files.push_back(entry.path().string());
+        }
+        if (ec) throw core::ConfigException("Failed to read strategy batch directory " + directory + ": " + ec.message());
+        if (files.empty()) throw core::ConfigException("No strategy JSON files in " + directory);
+        std::sort(files.begin(), files.end());
+
+        auto logger = core::logging::getLogger();
+        std::vector<BatchStrategy> strategies;
+        strategies.reserve(files.size());
+        for (auto& file : files) {
+            BatchStrategy strategy;
+            strategy.file = std::move(file);
+            try {
+                std::ifstream ifs(strategy.file);
+                if (!ifs.is_open()) throw std::runtime_error("cannot open file");
+                strategy.config = json::parse(ifs);
+            } catch (const std::exception& e) {
+                strategy.error = e.what();
+                logger->error("Skipping strategy file {}: {}", strategy.file, strategy.error);
+            }
+            strategies.push_back(std::move(strategy));
+        }
+        logger->info("Loaded {} strategy file(s) from {}.", strategies.size(), directory);
+        return strategies;
+    }
+
+    std::vector<BatchResult> BatchRunner::run(const std::vector<BatchStrategy>& strategies,
+                                              const std::string& start_date,
+                                              const std::string& end_date)
+    {
+        auto logger = core::logging::getLogger();
+        std::vector<BatchResult> results(strategies.size());
+        if (strategies.empty()) return results;
+
+        if (!candle_source_.isConnected() && !candle_source_.connect()) {
+            throw core::DataLoadException("Failed to connect to DB for strategy batch.");
+        }
+
+        // 1. Resolve what every strategy needs, so candles and indicators can be shared
+        std::vector<std::unique_ptr<StrategyRequirements>> requirements(strategies.size());
+        std::set<std::pair<std::string, std::string>> series_keys;    // (instrument, timeframe)
+        std::set<std::tuple<std::string, std::string, std::string>> indicator_keys; // (instrument, timeframe, indicator)
+        std::size_t indicator_references = 0;
+        for (std::size_t i = 0; i < strategies.size(); ++i) {
+            results[i].file = strategies[i].file;
+            if (!strategies[i].error.empty()) continue;
+            try {
+                auto req = std::make_unique<StrategyRequirements>(inspect(candle_source_, strategies[i].config, start_date));
+                results[i].strategy_name = req->name;
+                for (const auto& instrument : req->instruments) {
+                    series_keys.emplace(instrument, req->timeframe);
+                    for (const auto& indicator : req->indicators) {
+                        indicator_keys.emplace(instrument, req->timeframe, indicator);
+                        ++indicator_references;
+                    }
+                }
+                requirements[i] = std::move(req);
+            } catch (const std::exception& e) {
+                logger->error("Strategy {} is invalid and will not run: {}", strategies[i].file, e.what());
+            }
+        }
+        logger->info("Strategy batch: {} strategies on {} threads, {} candle series, {} distinct indicator series ({} references).",
+                     strategies.size(), num_threads_, series_keys.size(), indicator_keys.size(), indicator_references);
+
+        core::ThreadPool pool(num_threads_);
+
+        // 2. One candle load per (instrument, timeframe); the runs only read the cache.
+        // The source is only queried from several threads if it supports it.
+        auto [start_ts, end_ts] = Backtester::queryRangeForDates(start_date, end_date);
+        auto preload = [&, start_ts = start_ts, end_ts = end_ts](const std::string& instrument, const std::string& timeframe) {
+            const double tick_size = data_cache_->compactStorage() ? candle_source_.queryTickSize(instrument).value_or(0.0) : 0.0;
+            auto series = data_cache_->getOrLoad(instrument, timeframe, start_ts, end_ts, [&]() {
+                return candle_source_.queryCandleSeries(instrument, timeframe, start_ts, end_ts);
+            }, tick_size);
+            logger->info("Batch data preloaded: {} candles for {} ({}).", series->size(), instrument, timeframe);
+        };
+        {
+            std::vector<std::future<void>> loads;
+            for (const auto& [instrument, timeframe] : series_keys) {
+                if (candle_source_.supportsConcurrentQueries()) {
+                    loads.push_back(pool.submit([&preload, &instrument = instrument, &timeframe = timeframe]() {
+                        preload(instrument, timeframe);
+                    }));
+                } else {
+                    preload(instrument, timeframe);
+                }
+            }
+            for (auto& f : loads) f.wait(); // Let every load finish before rethrowing
+            for (auto& f : loads) f.get();
+        }
+
+        // 3. Every strategy on its own Backtester/Portfolio. Indicators shared between
+        // strategies are computed by whichever run asks first; the others wait for it.
+        {
+            std::vector<std::future<void>> pending(strategies.size());
+            for (std::size_t i = 0; i < strategies.size(); ++i) {
+                if (!requirements[i]) continue;
+                pending[i] = pool.submit([&, i]() {
+                    BatchResult& result = results[i];
+                    const auto started = std::chrono::steady_clock::now();
+                    Backtester backtester(candle_source_, initial_capital_);
+                    backtester.setDataCache(data_cache_);
+                    backtester.setIndicatorCache(indicator_cache_);
+                    backtester.setEvaluationMode(evaluation_mode_);
+                    result.success = backtester.run(requirements[i]->config, start_date, end_date);
+                    result.metrics = backtester.getMetrics();
+                    result.wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+                    if (results_writer_) results_writer_->write(displayName(result), result.success, result.metrics, backtester.getPortfolio());
+                });
+            }
+            for (std::size_t i = 0; i < pending.size(); ++i) {
+                if (!pending[i].valid()) continue;
+                try {
+                    pending[i].get();
+                } catch (const std::exception& e) {
+                    logger->error("Batch strategy {} failed: {}", strategies[i].file, e.what());
+                    results[i].success = false;
+                }
+            }
+        }
+
+        logger->info("Strategy batch computed {} indicator series for {} references.",
+                     indicator_cache_ ? indicator_cache_->size() : 0, indicator_references);
+        return results;
+    }
+
+    void BatchRunner::logResultsTable(const std::vector<BatchResult>& results) {
+        auto logger = core::logging::getLogger();
+        logger->info("--- Strategy Batch Results ({} strategies) ---", results.size());
+        logger->info("{:<32} {:>10} {:>12} {:>8} {:>7} {:>8} {:>7} {:>9}",
+                     "Strategy", "Return%", "PnL", "MaxDD%", "Trades", "WinRate%", "PF", "Time(s)");
+        for (const auto& r : results) {
+            if (!r.success) {
+                logger->info("{:<32} {:>10}", displayName(r), "FAILED");
+                continue;
+            }
+            const auto& m = r.metrics;
+            logger->info("{:<32} {:>10.2f} {:>12.2f} {:>8.2f} {:>7} {:>8.2f} {:>7.2f} {:>9.3f}",
+                         displayName(r), m.total_return_pct * 100.0, m.total_pnl, m.max_drawdown_pct * 100.0,
+                         m.round_trip_trades, m.win_rate * 100.0, m.profit_factor, r.wall_seconds);
+        }
+        logger->info("------------------------");
+    }
+
+    bool BatchRunner::writeResultsCsv(const std::string& path, const std::vector<BatchResult>& results) {
+        std::ofstream out(path);
+        if (!out.is_open()) {
+            core::logging::getLogger()->error("Failed to open batch output file: {}", path);
+            return false;
+        }
+        out << "file,strategy_name,success,total_return_pct,total_pnl,max_drawdown_pct,total_executions,"
+               "round_trip_trades,win_rate,profit_factor,avg_win_pnl,avg_loss_pnl,sharpe_ratio,sortino_ratio,cagr_pct,"
+               "calmar_ratio,exposure_pct,max_drawdown_duration_days,wall_seconds\n";
+        auto quoted = [](const std::string& text) {
+            std::string escaped = "\"";
+            for (char c : text) {
+                if (c == '"') escaped += '"';
+                escaped += c;
+            }
+            return escaped + '"';
+        };
+        for (const auto& r : results) {
+            const auto& m = r.metrics;
+            out << quoted(r.file) << ',' << quoted(r.strategy_name) << ',' << (r.success ? 1 : 0)
+                << fmt::format(",{},{},{},{},{},{},{},{},{},{},{},{},{},{},{},{}\n", m.total_return_pct, m.total_pnl,
+                               m.max_drawdown_pct, m.total_executions, m.round_trip_trades, m.win_rate, m.profit_factor,
+                               m.avg_win_pnl, m.avg_loss_pnl, m.sharpe_ratio, m.sortino_ratio, m.cagr_pct,
+                               m.calmar_ratio, m.exposure_pct, m.max_drawdown_duration_days, r.wall_seconds);
+        }
+        core::logging::getLogger()->info("Batch results written to {}", path);
+        return true;
+    }
+
+} // namespace backtester
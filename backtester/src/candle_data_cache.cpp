@@ -0,0 +1,158 @@
+#include "candle_data_cache.hpp"
+#include "logging.hpp"
+
+#include <chrono>
+#include <exception>
+
+namespace backtester {
+
+    namespace { // File-local helpers
+
+        // Returns the entry for 'key', running 'make' exactly once across threads.
+        // Callers that find an entry still being built wait for it; a failed build
+        // is removed so a later call can retry.
+        template <typename Key, typename Ptr, typename Make>
+        Ptr getOrCreate(std::mutex& mutex, std::map<Key, std::shared_future<Ptr>>& entries,
+                        const Key& key, const Make& make, bool& created)
+        {
+            std::promise<Ptr> promise;
+            std::shared_future<Ptr> future;
+            created = false;
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                auto it = entries.find(key);
+                if (it != entries.end()) {
+                    future = it->second;
+                } else {
+                    future = promise.get_future().share();
+                    entries.emplace(key, future);
+                    created = true;
+                }
+            }
+
+            if (!created) {
+                return future.get(); // Waits if another thread is still building it
+            }
+
+            // Build outside the lock so other keys are not blocked
+            try {
+                promise.set_value(make());
+            } catch (...) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    entries.erase(key); // Allow a later retry
+                }
+                promise.set_exception(std::current_exception());
+            }
+            return future.get();
+        }
+
+    } // namespace
+
+    CandleDataCache::SeriesPtr CandleDataCache::getOrLoad(const std::string& instrument_key,
+                                                          const std::string& interval,
+                                                          core::Timestamp start_time,
+                                                          core::Timestamp end_time,
+                                                          const Loader& loader,
+                                                          double tick_size)
+    {
+        bool loaded = false;
+        SeriesPtr first_copy; // The loaded series itself, handed to the caller that loaded it
+        StoredPtr stored = getOrCreate(mutex_, entries_, Key{instrument_key, interval, start_time, end_time},
+            [&]() {
+                auto logger = core::logging::getLogger();
+                auto entry = std::make_shared<StoredSeries>();
+                first_copy = std::make_shared<const core::CandleSeries>(loader());
+                if (compact_storage_) entry->compact = core::CompactCandleSeries::encode(*first_copy, tick_size);
+                if (entry->compact) {
+                    entry->decoded = first_copy;
+                    logger->debug("CandleDataCache loaded {} candles for {} ({}), stored compact in {} bytes instead of {} (tick {}).",
+                                  first_copy->size(), instrument_key, interval, entry->compact->memoryBytes(),
+                                  entry->compact->decodedBytes(), entry->compact->tickSize());
+                } else {
+                    if (compact_storage_) {
+                        logger->debug("CandleDataCache: {} ({}) has prices, timestamps or volumes that do not fit "
+                                      "compact storage; keeping the full series.", instrument_key, interval);
+                    }
+                    entry->full = first_copy;
+                    logger->debug("CandleDataCache loaded {} candles for {} ({}).",
+                                  first_copy->size(), instrument_key, interval);
+                }
+                return entry;
+            }, loaded);
+        if (!loaded) core::logging::getLogger()->debug("CandleDataCache hit for {} ({}).", instrument_key, interval);
+        if (stored->full) return stored->full;
+        if (first_copy) return first_copy;
+        return decodeShared(*stored);
+    }
+
+    CandleDataCache::SeriesPtr CandleDataCache::decodeShared(StoredSeries& stored) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (auto decoded = stored.decoded.lock()) return decoded;
+        }
+        // Decode outside the lock; if another caller got there first, use its copy
+        auto decoded = std::make_shared<const core::CandleSeries>(stored.compact->decode());
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (auto existing = stored.decoded.lock()) return existing;
+        stored.decoded = decoded;
+        return decoded;
+    }
+
+    CandleDataCache::ResampledPtr CandleDataCache::getOrResample(const std::string& instrument_key,
+                                                                 const std::string& base_interval,
+                                                                 const std::string& target_interval,
+                                                                 core::Timestamp start_time,
+                                                                 core::Timestamp end_time,
+                                                                 const core::CandleSeries& base)
+    {
+        const std::string interval = data::resampledIntervalKey(base_interval, target_interval);
+        bool built = false;
+        ResampledPtr series = getOrCreate(mutex_, resampled_, Key{instrument_key, interval, start_time, end_time},
+            [&]() {
+                auto result = std::make_shared<const data::ResampledSeries>(
+                    data::resampleCandles(base, base_interval, target_interval));
+                core::logging::getLogger()->debug("CandleDataCache resampled {} {} bars into {} {} bars for {}.",
+                                                  base.size(), base_interval, result->bars.size(),
+                                                  target_interval, instrument_key);
+                return result;
+            }, built);
+        if (!built) core::logging::getLogger()->debug("CandleDataCache hit for {} ({}).", instrument_key, interval);
+        return series;
+    }
+
+    std::size_t CandleDataCache::size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return entries_.size();
+    }
+
+    std::size_t CandleDataCache::storedBytes() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::size_t bytes = 0;
+        for (const auto& [key, future] : entries_) {
+            using namespace std::chrono_literals;
+            if (future.wait_for(0s) != std::future_status::ready) continue; // Still loading
+            try {
+                const StoredPtr& stored = future.get();
+                if (stored->compact) {
+                    bytes += stored->compact->memoryBytes();
+                } else {
+                    const std::size_t per_bar = sizeof(std::int64_t) + 5 * sizeof(double) +
+                                                (stored->full->hasOpenInterest() ? sizeof(std::int64_t) : 0);
+                    bytes += stored->full->size() * per_bar;
+                }
+            } catch (const std::exception&) {
+                // Failed load, about to be removed
+            }
+        }
+        return bytes;
+    }
+
+    void CandleDataCache::clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.clear();
+        resampled_.clear();
+    }
+
+} // namespace backtester
@@ -0,0 +1,270 @@
+#include "execution_model.hpp"
+#include "exceptions.hpp"
+
+#include <algorithm>
+#include <string>
+
+namespace backtester {
+
+    namespace {
+
+        FeeSchedule feePreset(const std::string& model) {
+            if (model == "per_share") return FeeSchedule::perShare(0.01);
+            if (model == "india_equity_delivery") return FeeSchedule::indiaEquityDelivery();
+            if (model == "india_equity_intraday") return FeeSchedule::indiaEquityIntraday();
+            throw core::ConfigException("Unknown execution fee model: " + model);
+        }
+
+        double nonNegative(const json& node, const char* key, double fallback) {
+            if (!node.contains(key)) return fallback;
+            if (!node[key].is_number()) throw core::ConfigException(std::string("Execution setting '") + key + "' must be a number.");
+            const double value = node[key].get<double>();
+            if (value < 0.0) throw core::ConfigException(std::string("Execution setting '") + key + "' must not be negative.");
+            return value;
+        }
+
+        FeeSchedule parseFees(const json& fees) {
+            if (fees.is_string()) return feePreset(fees.get<std::string>());
+            if (!fees.is_object()) throw core::ConfigException("Execution 'fees' must be a model name or an object.");
+            FeeSchedule schedule = feePreset(fees.value("model", std::string("per_share")));
+            schedule.per_share = nonNegative(fees, "per_share", schedule.per_share);
+            schedule.brokerage_rate = nonNegative(fees, "brokerage_rate", schedule.brokerage_rate);
+            schedule.brokerage_cap = nonNegative(fees, "brokerage_cap", schedule.brokerage_cap);
+            schedule.stt_buy_rate = nonNegative(fees, "stt_buy_rate", schedule.stt_buy_rate);
+            schedule.stt_sell_rate = nonNegative(fees, "stt_sell_rate", schedule.stt_sell_rate);
+            schedule.exchange_rate = nonNegative(fees, "exchange_rate", schedule.exchange_rate);
+            schedule.sebi_rate = nonNegative(fees, "sebi_rate", schedule.sebi_rate);
+            schedule.stamp_duty_buy_rate = nonNegative(fees, "stamp_duty_buy_rate", schedule.stamp_duty_buy_rate);
+            schedule.gst_rate = nonNegative(fees, "gst_rate", schedule.gst_rate);
+            return schedule;
+        }
+
+    } // end anonymous namespace
+
+    // --- FeeSchedule ---
+
+    double FeeSchedule::calculate(bool is_buy, long long quantity, double price) const {
+        const double shares = static_cast<double>(quantity);
+        const double turnover = shares * price;
+        double brokerage = per_share * shares + brokerage_rate * turnover;
+        if (brokerage_cap > 0.0) brokerage = std::min(brokerage, brokerage_cap);
+        const double stt = turnover * (is_buy ? stt_buy_rate : stt_sell_rate);
+        const double exchange = turnover * exchange_rate;
+        const double sebi = turnover * sebi_rate;
+        const double stamp = is_buy ? turnover * stamp_duty_buy_rate : 0.0;
+        const double gst = gst_rate * (brokerage + exchange + sebi);
+        return brokerage + stt + exchange + sebi + stamp + gst;
+    }
+
+    FeeSchedule FeeSchedule::perShare(double amount) {
+        FeeSchedule schedule;
+        schedule.per_share = amount;
+        return schedule;
+    }
+
+    FeeSchedule FeeSchedule::indiaEquityDelivery() {
+        FeeSchedule schedule;
+        schedule.stt_buy_rate = 0.001;
+        schedule.stt_sell_rate = 0.001;
+        schedule.exchange_rate = 0.0000297;  // NSE
+        schedule.sebi_rate = 0.000001;       // Rs 10 per crore
+        schedule.stamp_duty_buy_rate = 0.00015;
+        schedule.gst_rate = 0.18;
+        return schedule;
+    }
+
+    FeeSchedule FeeSchedule::indiaEquityIntraday() {
+        FeeSchedule schedule;
+        schedule.brokerage_rate = 0.0003;
+        schedule.brokerage_cap = 20.0;
+        schedule.stt_sell_rate = 0.00025;
+        schedule.exchange_rate = 0.0000297;
+        schedule.sebi_rate = 0.000001;
+        schedule.stamp_duty_buy_rate = 0.00003;
+        schedule.gst_rate = 0.18;
+        return schedule;
+    }
+
+    // --- ExecutionConfig ---
+
+    ExecutionConfig ExecutionConfig::fromJson(const json& execution) {
+        ExecutionConfig config;
+        if (execution.is_null()) return config;
+        if (!execution.is_object()) throw core::ConfigException("Strategy 'execution' must be an object.");
+
+        const std::string fill = execution.value("fill", std::string("close"));
+        if (fill == "close") {
+            config.fill_timing = FillTiming::SameBarClose;
+        } else if (fill == "next_open") {
+            config.fill_timing = FillTiming::NextBarOpen;
+        } else {
+            throw core::ConfigException("Unknown execution 'fill' (expected 'close' or 'next_open'): " + fill);
+        }
+
+        if (execution.contains("entry_order")) {
+            const auto& entry = execution["entry_order"];
+            if (!entry.is_object()) throw core::ConfigException("Execution 'entry_order' must be an object.");
+            const std::string type = entry.value("type", std::string("market"));
+            if (type == "market") {
+                config.entry_order_type = OrderType::Market;
+            } else if (type == "limit") {
+                config.entry_order_type = OrderType::Limit;
+            } else if (type == "stop") {
+                config.entry_order_type = OrderType::Stop;
+            } else {
+                throw core::ConfigException("Unknown execution entry order type: " + type);
+            }
+            config.entry_offset_pct = nonNegative(entry, "offset_pct", 0.0);
+            config.entry_valid_bars = static_cast<std::size_t>(nonNegative(entry, "valid_bars", 0.0));
+        }
+
+        config.stop_loss_pct = nonNegative(execution, "stop_loss_pct", 0.0);
+        config.take_profit_pct = nonNegative(execution, "take_profit_pct", 0.0);
+        if (config.stop_loss_pct >= 100.0) throw core::ConfigException("Execution 'stop_loss_pct' must be below 100.");
+
+        if (execution.contains("slippage")) {
+            const auto& slippage = execution["slippage"];
+            if (!slippage.is_object()) throw core::ConfigException("Execution 'slippage' must be an object.");
+            config.slippage.bps = nonNegative(slippage, "bps", 0.0);
+            config.slippage.per_share = nonNegative(slippage, "per_share", 0.0);
+        }
+        if (execution.contains("fees")) config.fees = parseFees(execution["fees"]);
+        return config;
+    }
+
+    bool ExecutionConfig::needsFillFeedback() const {
+        return fill_timing != FillTiming::SameBarClose || entry_order_type != OrderType::Market ||
+               stop_loss_pct > 0.0 || take_profit_pct > 0.0;
+    }
+
+    // --- OrderBook ---
+
+    OrderId OrderBook::submit(PendingOrder order) {
+        order.id = next_id_++;
+        index(order);
+        if (order.expires_after_bar != std::numeric_limits<std::size_t>::max()) {
+            expiries_.emplace(order.expires_after_bar, order.id);
+        }
+        const OrderId id = order.id;
+        orders_.emplace(id, std::move(order));
+        return id;
+    }
+
+    bool OrderBook::cancel(OrderId id) {
+        auto it = orders_.find(id);
+        if (it == orders_.end()) return false;
+        unindex(it->second);
+        orders_.erase(it); // A stale expiry entry is skipped when it comes due
+        return true;
+    }
+
+    void OrderBook::cancelIf(const std::function<bool(const PendingOrder&)>& predicate) {
+        for (auto it = orders_.begin(); it != orders_.end();) {
+            if (predicate(it->second)) {
+                unindex(it->second);
+                it = orders_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    void OrderBook::clear() {
+        orders_.clear();
+        market_.clear();
+        buy_limits_.clear();
+        sell_limits_.clear();
+        buy_stops_.clear();
+        sell_stops_.clear();
+        expiries_.clear();
+    }
+
+    bool OrderBook::hasEntry() const {
+        return std::any_of(orders_.begin(), orders_.end(), [](const auto& entry) {
+            const auto action = entry.second.action;
+            return action == core::SignalAction::EnterLong || action == core::SignalAction::EnterShort;
+        });
+    }
+
+    void OrderBook::index(const PendingOrder& order) {
+        switch (order.type) {
+            case OrderType::Market:
+                market_.push_back(order.id);
+                break;
+            case OrderType::Limit:
+                if (order.isBuy()) buy_limits_.emplace(order.price, order.id);
+                else sell_limits_.emplace(order.price, order.id);
+                break;
+            case OrderType::Stop:
+                if (order.isBuy()) buy_stops_.emplace(order.price, order.id);
+                else sell_stops_.emplace(order.price, order.id);
+                break;
+        }
+    }
+
+    template <typename Map>
+    void OrderBook::erase(Map& map, double price, OrderId id) {
+        auto [first, last] = map.equal_range(price);
+        for (auto it = first; it != last; ++it) {
+            if (it->second == id) {
+                map.erase(it);
+                return;
+            }
+        }
+    }
+
+    void OrderBook::unindex(const PendingOrder& order) {
+        switch (order.type) {
+            case OrderType::Market:
+                market_.erase(std::remove(market_.begin(), market_.end(), order.id), market_.end());
+                break;
+            case OrderType::Limit:
+                if (order.isBuy()) erase(buy_limits_, order.price, order.id);
+                else erase(sell_limits_, order.price, order.id);
+                break;
+            case OrderType::Stop:
+                if (order.isBuy()) erase(buy_stops_, order.price, order.id);
+                else erase(sell_stops_, order.price, order.id);
+                break;
+        }
+    }
+
+    void OrderBook::match(const core::Candle& bar, std::size_t bar_index, std::vector<OrderFill>& fills) {
+        auto fill = [&](OrderId id, double price) {
+            auto it = orders_.find(id);
+            fills.push_back({it->second, price});
+            orders_.erase(it);
+        };
+
+        for (OrderId id : market_) fill(id, bar.open);
+        market_.clear();
+
+        // Heads of the sorted maps are the first orders to trigger; stop at the first one that does not
+        while (!buy_stops_.empty() && buy_stops_.begin()->first <= bar.high) {
+            const auto [price, id] = *buy_stops_.begin();
+            buy_stops_.erase(buy_stops_.begin());
+            fill(id, std::max(bar.open, price));
+        }
+        while (!sell_stops_.empty() && sell_stops_.begin()->first >= bar.low) {
+            const auto [price, id] = *sell_stops_.begin();
+            sell_stops_.erase(sell_stops_.begin());
+            fill(id, std::min(bar.open, price));
+        }
+        while (!buy_limits_.empty() && buy_limits_.begin()->first >= bar.low) {
+            const auto [price, id] = *buy_limits_.begin();
+            buy_limits_.erase(buy_limits_.begin());
+            fill(id, std::min(bar.open, price));
+        }
+        while (!sell_limits_.empty() && sell_limits_.begin()->first <= bar.high) {
+            const auto [price, id] = *sell_limits_.begin();
+            sell_limits_.erase(sell_limits_.begin());
+            fill(id, std::max(bar.open, price));
+        }
+
+        while (!expiries_.empty() && expiries_.begin()->first <= bar_index) {
+            cancel(expiries_.begin()->second); // No-op if it was filled or cancelled already
+            expiries_.erase(expiries_.begin());
+        }
+    }
+
+} // namespace backtester
@@ -0,0 +1,131 @@
+#include "metrics_accumulator.hpp"
+#include "candle_resampler.hpp" // data::BarInterval
+#include "utils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace backtester {
+
+    void MetricsAccumulator::reset(double initial_capital) {
+        *this = MetricsAccumulator(initial_capital);
+    }
+
+    void MetricsAccumulator::addPoint(const PortfolioState& state, bool in_market) {
+        const double equity = state.total_equity;
+        if (points_ == 0) {
+            first_time_ = state.timestamp;
+            peak_time_ = state.timestamp;
+        } else {
+            const double r = (last_.total_equity > 1e-9) ? equity / last_.total_equity - 1.0 : 0.0;
+            ++return_count_;
+            const double delta = r - mean_return_;
+            mean_return_ += delta / static_cast<double>(return_count_);
+            m2_ += delta * (r - mean_return_);
+            if (r < 0.0) downside_sq_sum_ += r * r;
+        }
+        ++points_;
+        last_ = state;
+        if (in_market) ++in_market_points_;
+
+        // Drawdown depth against the running peak, and how long equity stays below it
+        peak_equity_ = std::max(peak_equity_, equity);
+        const double drawdown = (peak_equity_ > 1e-9) ? (peak_equity_ - equity) / peak_equity_ : 0.0;
+        max_drawdown_pct_ = std::max(max_drawdown_pct_, drawdown);
+        if (equity >= peak_equity_) {
+            peak_time_ = state.timestamp;
+            underwater_points_ = 0;
+        } else {
+            ++underwater_points_;
+            max_underwater_points_ = std::max(max_underwater_points_, underwater_points_);
+            max_underwater_ns_ = std::max(max_underwater_ns_, core::utils::timestampToEpochNanos(state.timestamp) -
+                                                              core::utils::timestampToEpochNanos(peak_time_));
+        }
+    }
+
+    void MetricsAccumulator::addTrade(const core::Trade& trade) {
+        ++trades_;
+        if (trade.pnl > 0) {
+            ++winning_trades_;
+            gross_profit_ += trade.pnl;
+        } else if (trade.pnl < 0) {
+            gross_loss_ += trade.pnl; // Loss is negative
+        }
+        // Trades with PnL == 0 count as neither win nor loss
+    }
+
+    double MetricsAccumulator::currentDrawdownPct() const {
+        return (peak_equity_ > 1e-9 && points_ > 0) ? (peak_equity_ - last_.total_equity) / peak_equity_ : 0.0;
+    }
+
+    double MetricsAccumulator::returnStdDev() const {
+        return (return_count_ > 0) ? std::sqrt(m2_ / static_cast<double>(return_count_)) : 0.0;
+    }
+
+    double MetricsAccumulator::downsideDeviation() const {
+        return (return_count_ > 0) ? std::sqrt(downside_sq_sum_ / static_cast<double>(return_count_)) : 0.0;
+    }
+
+    BacktestMetrics MetricsAccumulator::metrics(double periods_per_year) const {
+        BacktestMetrics metrics;
+        if (points_ == 0) return metrics;
+
+        // --- PnL and Return ---
+        metrics.total_pnl = last_.total_equity - initial_capital_;
+        metrics.total_return_pct = (initial_capital_ > 1e-9) ? metrics.total_pnl / initial_capital_ : 0.0;
+        metrics.max_drawdown_pct = max_drawdown_pct_;
+        metrics.max_drawdown_duration_bars = max_underwater_points_;
+        metrics.max_drawdown_duration_days = static_cast<double>(max_underwater_ns_) / 86'400e9;
+        metrics.exposure_pct = static_cast<double>(in_market_points_) / static_cast<double>(points_);
+
+        // --- Trade-Based Metrics ---
+        metrics.round_trip_trades = trades_;
+        const int losing_trades = trades_ - winning_trades_; // Losses and zero-PnL trades
+        metrics.win_rate = (trades_ > 0) ? static_cast<double>(winning_trades_) / trades_ : 0.0;
+        if (std::abs(gross_loss_) > 1e-9) {
+            metrics.profit_factor = gross_profit_ / std::abs(gross_loss_);
+        } else if (gross_profit_ > 1e-9) {
+            metrics.profit_factor = std::numeric_limits<double>::infinity();
+        }
+        metrics.avg_win_pnl = (winning_trades_ > 0) ? gross_profit_ / winning_trades_ : 0.0;
+        metrics.avg_loss_pnl = (losing_trades > 0) ? gross_loss_ / losing_trades : 0.0; // Will be negative
+
+        // --- Risk ---
+        const double annualization = std::sqrt(periods_per_year);
+        const double std_dev = returnStdDev();
+        if (return_count_ > 1 && std_dev > 1e-12) metrics.sharpe_ratio = annualization * mean_return_ / std_dev;
+        const double downside = downsideDeviation();
+        if (return_count_ > 1 && downside > 1e-12) metrics.sortino_ratio = annualization * mean_return_ / downside;
+
+        const double years = static_cast<double>(core::utils::timestampToEpochNanos(last_.timestamp) -
+                                                 core::utils::timestampToEpochNanos(first_time_)) / (365.25 * 86'400e9);
+        if (years > 0.0 && initial_capital_ > 1e-9 && last_.total_equity > 0.0) {
+            metrics.cagr_pct = std::pow(last_.total_equity / initial_capital_, 1.0 / years) - 1.0;
+        }
+        if (max_drawdown_pct_ > 1e-12) metrics.calmar_ratio = metrics.cagr_pct / max_drawdown_pct_;
+        return metrics;
+    }
+
+    double MetricsAccumulator::periodsPerYear(const std::string& interval) {
+        constexpr double kTradingDays = 252.0;
+        constexpr double kSessionMinutes = 375.0; // NSE 09:15 - 15:30
+        const auto bar = data::BarInterval::parse(interval);
+        if (!bar) return 1.0;
+        switch (bar->unit) {
+            case data::BarInterval::Unit::Minute: return kTradingDays * std::max(1.0, kSessionMinutes / bar->count);
+            case data::BarInterval::Unit::Day: return kTradingDays;
+            case data::BarInterval::Unit::Week: return 52.0;
+            case data::BarInterval::Unit::Month: return 12.0;
+        }
+        return 1.0;
+    }
+
+    const char* StopCriteria::check(const MetricsAccumulator& running) const {
+        if (max_drawdown_pct && running.maxDrawdownPct() > *max_drawdown_pct) return "max_drawdown_pct";
+        if (min_equity && running.points() > 0 && running.last().total_equity < *min_equity) return "min_equity";
+        return nullptr;
+    }
+
+} // namespace backtester
@@ -0,0 +1,570 @@
+#include "parameter_sweep.hpp"
+#include "backtester.hpp"
+#include "thread_pool.hpp"
+#include "logging.hpp"
+#include "exceptions.hpp"
+#include "utils.hpp"
+#include "spdlog/fmt/bundled/core.h" // Use direct path for safety
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <future>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <set>
+
+namespace backtester {
+
+    namespace { // File-local helpers
+
+        // Refuse grids that are almost certainly a typo in the range definition
+        constexpr std::size_t kMaxCombinations = 1'000'000;
+
+        // Forwards to a source that is not safe to query from several threads, one
+        // call at a time, so sweep workers can share it
+        class SerializedCandleSource : public data::ICandleSource {
+        public:
+            explicit SerializedCandleSource(data::ICandleSource& source) : source_(source) {}
+
+            bool connect() override { std::lock_guard<std::mutex> lock(mutex_); return source_.connect(); }
+            bool isConnected() const override { std::lock_guard<std::mutex> lock(mutex_); return source_.isConnected(); }
+
+            core::TimeSeries<core::Candle> queryCandles(const std::string& instrument_key, const std::string& interval,
+                                                        core::Timestamp start_time, core::Timestamp end_time) override {
+                std::lock_guard<std::mutex> lock(mutex_);
+                return source_.queryCandles(instrument_key, interval, start_time, end_time);
+            }
+            core::CandleSeries queryCandleSeries(const std::string& instrument_key, const std::string& interval,
+                                                 core::Timestamp start_time, core::Timestamp end_time) override {
+                std::lock_guard<std::mutex> lock(mutex_);
+                return source_.queryCandleSeries(instrument_key, interval, start_time, end_time);
+            }
+            std::vector<std::string> queryIndexConstituents(const std::string& index_key, const std::string& as_of_date) override {
+                std::lock_guard<std::mutex> lock(mutex_);
+                return source_.queryIndexConstituents(index_key, as_of_date);
+            }
+            std::vector<std::string> queryInstruments(const std::string& exchange, const std::string& segment) override {
+                std::lock_guard<std::mutex> lock(mutex_);
+                return source_.queryInstruments(exchange, segment);
+            }
+            std::optional<double> queryTickSize(const std::string& instrument_key) override {
+                std::lock_guard<std::mutex> lock(mutex_);
+                return source_.queryTickSize(instrument_key);
+            }
+
+        private:
+            data::ICandleSource& source_;
+            mutable std::mutex mutex_;
+        };
+
+        std::vector<double> expandRange(const std::string& name, const json& range) {
+            std::vector<double> values;
+            if (range.is_array()) { // Explicit list: [5, 10, 20]
+                for (const auto& v : range) {
+                    if (!v.is_number() || !std::isfinite(v.get<double>())) {
+                        throw core::ConfigException("Sweep parameter '" + name + "' list must contain finite numbers.");
+                    }
+                    values.push_back(v.get<double>());
+                }
+            } else if (range.is_object() && range.contains("values")) {
+                return expandRange(name, range["values"]);
+            } else if (range.is_object()) { // Range: {"start": 5, "end": 50, "step": 5}
+                if (!range.contains("start") || !range["start"].is_number() ||
+                    !range.contains("end") || !range["end"].is_number()) {
+                    throw core::ConfigException("Sweep parameter '" + name + "' requires numeric 'start' and 'end' (or 'values').");
+                }
+                double start = range["start"].get<double>();
+                double end = range["end"].get<double>();
+                double step = range.value("step", 1.0);
+                if (!std::isfinite(start) || !std::isfinite(end) || !std::isfinite(step)) {
+                    throw core::ConfigException("Sweep parameter '" + name + "' start, end and step must be finite.");
+                }
+                if (step <= 0.0) throw core::ConfigException("Sweep parameter '" + name + "' step must be positive.");
+                if (end < start) throw core::ConfigException("Sweep parameter '" + name + "' end must be >= start.");
+                // Count steps with integers so accumulated floating point error cannot drop the end value.
+                // Bounded before the cast: a tiny step overflows size_t (or is inf) and would reserve terabytes.
+                const double steps = std::floor((end - start) / step + 1e-9);
+                if (!std::isfinite(steps) || steps >= static_cast<double>(kMaxCombinations)) {
+                    throw core::ConfigException(fmt::format("Sweep parameter '{}' has more than {} values (step {} too small?).",
+                                                            name, kMaxCombinations, step));
+                }
+                const auto count = static_cast<std::size_t>(steps) + 1;
+                values.reserve(count);
+                for (std::size_t k = 0; k < count; ++k) {
+                    values.push_back(start + static_cast<double>(k) * step);
+                }
+            } else {
+                throw core::ConfigException("Sweep parameter '" + name + "' must be an object or an array.");
+            }
+            if (values.empty()) throw core::ConfigException("Sweep parameter '" + name + "' has no values.");
+            return values;
+        }
+
+        std::string formatParameterValue(double value) {
+            return fmt::format("{}", value); // Shortest round-trip form: 10.0 -> "10", 2.5 -> "2.5"
+        }
+
+        // Replaces every ${name} in 'text'. Throws on unknown placeholders.
+        std::string substitute(const std::string& text, const ParameterSet& params) {
+            std::string out;
+            out.reserve(text.size());
+            std::size_t pos = 0;
+            while (pos < text.size()) {
+                std::size_t open = text.find("${", pos);
+                if (open == std::string::npos) {
+                    out.append(text, pos, std::string::npos);
+                    break;
+                }
+                std::size_t close = text.find('}', open + 2);
+                if (close == std::string::npos) {
+                    throw core::ConfigException("Unterminated sweep placeholder in: " + text);
+                }
+                std::string name = text.substr(open + 2, close - open - 2);
+                auto it = params.find(name);
+                if (it == params.end()) {
+                    throw core::ConfigException("Unknown sweep parameter '" + name + "' referenced in: " + text);
+                }
+                out.append(text, pos, open - pos);
+                out += formatParameterValue(it->second);
+                pos = close + 1;
+            }
+            return out;
+        }
+
+        void substituteInPlace(json& node, const ParameterSet& params) {
+            if (node.is_string()) {
+                const std::string& text = node.get_ref<const std::string&>();
+                if (text.find("${") == std::string::npos) return;
+                // A value that is exactly one placeholder becomes a number ("value": "${level}")
+                if (text.size() > 3 && text.rfind("${", 0) == 0 && text.back() == '}' &&
+                    text.find("${", 2) == std::string::npos) {
+                    auto it = params.find(text.substr(2, text.size() - 3));
+                    if (it != params.end()) {
+                        node = it->second;
+                        return;
+                    }
+                }
+                node = substitute(text, params);
+            } else if (node.is_array() || node.is_object()) {
+                for (auto& child : node) substituteInPlace(child, params);
+            }
+        }
+
+        std::optional<double> optionalNumber(const json& block, const char* key, const std::string& context) {
+            if (!block.contains(key)) return std::nullopt;
+            if (!block[key].is_number()) throw core::ConfigException(context + "." + key + " must be a number.");
+            return block[key].get<double>();
+        }
+
+        // Order of two results of one ranking (see ParameterSweep::rankResults)
+        bool ranksBefore(const SweepResult& a, const SweepResult& b, const std::string& metric_name, bool ascending) {
+            if (a.success != b.success) return a.success; // Failed runs go last
+            if (a.eliminated != b.eliminated) return !a.eliminated;
+            if (a.data_fraction != b.data_fraction) return a.data_fraction > b.data_fraction;
+            if (a.metrics.stopped_early != b.metrics.stopped_early) return !a.metrics.stopped_early;
+            double va = ParameterSweep::metricValue(a.metrics, metric_name);
+            double vb = ParameterSweep::metricValue(b.metrics, metric_name);
+            return ascending ? va < vb : va > vb;
+        }
+
+        bool ranksAscending(const std::string& metric_name) {
+            return metric_name == "max_drawdown_pct" || metric_name == "max_drawdown_duration_days";
+        }
+
+        std::string describeParameters(const ParameterSet& params) {
+            std::string out;
+            for (const auto& [name, value] : params) {
+                if (!out.empty()) out += ' ';
+                out += name + '=' + formatParameterValue(value);
+            }
+            return out;
+        }
+
+    } // end anonymous namespace
+
+    bool SweepConstraint::isSatisfied(const ParameterSet& params) const {
+        auto lhs_it = params.find(left);
+        auto rhs_it = params.find(right);
+        if (lhs_it == params.end() || rhs_it == params.end()) return true; // Validated in parseSpec
+        double lhs = lhs_it->second;
+        double rhs = rhs_it->second;
+        if (op == "<") return lhs < rhs;
+        if (op == "<=") return lhs <= rhs;
+        if (op == ">") return lhs > rhs;
+        if (op == ">=") return lhs >= rhs;
+        if (op == "==") return lhs == rhs;
+        if (op == "!=") return lhs != rhs;
+        return true;
+    }
+
+    ParameterSweep::ParameterSweep(data::ICandleSource& candle_source, double initial_capital, std::size_t num_threads)
+        : candle_source_(candle_source),
+          initial_capital_(initial_capital),
+          num_threads_(core::ThreadPool::resolveThreadCount(num_threads)),
+          data_cache_(std::make_shared<CandleDataCache>()),
+          indicator_cache_(std::make_shared<indicators::IndicatorCache>())
+    {
+        core::logging::getLogger()->debug("ParameterSweep created with {} worker threads.", num_threads_);
+    }
+
+    SweepSpec ParameterSweep::parseSpec(const json& strategy_config) {
+        if (!strategy_config.is_object() || !strategy_config.contains("sweep") || !strategy_config["sweep"].is_object()) {
+            throw core::ConfigException("Strategy config has no 'sweep' object.");
+        }
+        const auto& sweep = strategy_config["sweep"];
+        if (!sweep.contains("parameters") || !sweep["parameters"].is_object() || sweep["parameters"].empty()) {
+            throw core::ConfigException("'sweep.parameters' must be a non-empty object.");
+        }
+
+        SweepSpec spec;
+        spec.strategy_template = strategy_config;
+        spec.strategy_template.erase("sweep");
+
+        for (const auto& [name, range] : sweep["parameters"].items()) {
+            spec.parameters.push_back({name, expandRange(name, range)});
+        }
+
+        if (sweep.contains("constraints")) {
+            if (!sweep["constraints"].is_array()) throw core::ConfigException("'sweep.constraints' must be an array.");
+            for (const auto& c : sweep["constraints"]) {
+                if (!c.is_object() || !c.contains("left") || !c.contains("op") || !c.contains("right")) {
+                    throw core::ConfigException("Sweep constraints require 'left', 'op' and 'right'.");
+                }
+                SweepConstraint constraint{c["left"].get<std::string>(), c["op"].get<std::string>(), c["right"].get<std::string>()};
+                static const std::vector<std::string> valid_ops{"<", "<=", ">", ">=", "==", "!="};
+                if (std::find(valid_ops.begin(), valid_ops.end(), constraint.op) == valid_ops.end()) {
+                    throw core::ConfigException("Unknown sweep constraint operator: " + constraint.op);
+                }
+                for (const auto* side : {&constraint.left, &constraint.right}) {
+                    bool known = std::any_of(spec.parameters.begin(), spec.parameters.end(),
+                                             [&](const ParameterRange& p) { return p.name == *side; });
+                    if (!known) throw core::ConfigException("Sweep constraint references unknown parameter: " + *side);
+                }
+                spec.constraints.push_back(std::move(constraint));
+            }
+        }
+
+        spec.rank_by = sweep.value("rank_by", spec.rank_by);
+        metricValue(BacktestMetrics{}, spec.rank_by); // Validates the metric name
+        spec.top = sweep.value("top", spec.top);
+
+        if (sweep.contains("stop")) {
+            const auto& stop = sweep["stop"];
+            if (!stop.is_object()) throw core::ConfigException("'sweep.stop' must be an object.");
+            spec.stop.max_drawdown_pct = optionalNumber(stop, "max_drawdown_pct", "sweep.stop");
+            spec.stop.min_equity = optionalNumber(stop, "min_equity", "sweep.stop");
+            if (spec.stop.max_drawdown_pct && *spec.stop.max_drawdown_pct <= 0.0) {
+                throw core::ConfigException("'sweep.stop.max_drawdown_pct' must be positive.");
+            }
+        }
+        if (sweep.contains("halving")) {
+            const auto& halving = sweep["halving"];
+            if (!halving.is_object()) throw core::ConfigException("'sweep.halving' must be an object.");
+            const auto rounds = optionalNumber(halving, "rounds", "sweep.halving").value_or(0.0);
+            if (rounds < 0.0 || rounds > 16.0 || rounds != std::floor(rounds)) {
+                throw core::ConfigException("'sweep.halving.rounds' must be a whole number from 0 to 16.");
+            }
+            spec.halving_rounds = static_cast<std::size_t>(rounds);
+            spec.halving_keep = optionalNumber(halving, "keep", "sweep.halving").value_or(spec.halving_keep);
+            if (!(spec.halving_keep > 0.0 && spec.halving_keep < 1.0)) {
+                throw core::ConfigException("'sweep.halving.keep' must be between 0 and 1 (exclusive).");
+            }
+        }
+        return spec;
+    }
+
+    std::vector<ParameterSet> ParameterSweep::expandGrid(const SweepSpec& spec) {
+        std::size_t total = 1;
+        for (const auto& p : spec.parameters) {
+            total *= p.values.size();
+            if (total > kMaxCombinations) {
+                throw core::ConfigException(fmt::format("Sweep grid exceeds {} combinations.", kMaxCombinations));
+            }
+        }
+
+        std::vector<ParameterSet> grid;
+        grid.reserve(total);
+        std::vector<std::size_t> index(spec.parameters.size(), 0); // Odometer over all ranges
+        for (std::size_t n = 0; n < total; ++n) {
+            ParameterSet params;
+            for (std::size_t p = 0; p < spec.parameters.size(); ++p) {
+                params[spec.parameters[p].name] = spec.parameters[p].values[index[p]];
+            }
+            bool keep = std::all_of(spec.constraints.begin(), spec.constraints.end(),
+                                    [&](const SweepConstraint& c) { return c.isSatisfied(params); });
+            if (keep) grid.push_back(std::move(params));
+
+            for (std::size_t p = spec.parameters.size(); p-- > 0;) {
+                if (++index[p] < spec.parameters[p].values.size()) break;
+                index[p] = 0;
+            }
+        }
+        return grid;
+    }
+
+    json ParameterSweep::instantiate(const json& strategy_template, const ParameterSet& params) {
+        json config = strategy_template;
+        substituteInPlace(config, params);
+        if (config.contains("strategy_name") && config["strategy_name"].is_string()) {
+            config["strategy_name"] = config["strategy_name"].get<std::string>() + " [" + describeParameters(params) + "]";
+        }
+        return config;
+    }
+
+    std::vector<SweepResult> ParameterSweep::run(const SweepSpec& spec,
+                                                 const std::string& start_date,
+                                                 const std::string& end_date)
+    {
+        auto logger = core::logging::getLogger();
+        std::vector<ParameterSet> grid = expandGrid(spec);
+        logger->info("Parameter sweep: {} combinations on {} threads (ranked by {}).",
+                     grid.size(), num_threads_, spec.rank_by);
+        if (grid.empty()) {
+            logger->warn("Sweep grid is empty after applying constraints.");
+            return {};
+        }
+
+        if (!candle_source_.isConnected() && !candle_source_.connect()) {
+            throw core::DataLoadException("Failed to connect to DB for parameter sweep.");
+        }
+
+        core::ThreadPool pool(num_threads_);
+
+        // Resolve the universe and load the candles once up front; workers then only
+        // read the cached series. The DB is only queried from several threads at once
+        // if the source supports it (e.g. the SQLite read pool); otherwise every call
+        // the workers still make (connection checks, tick sizes, cache misses) goes
+        // through one lock.
+        SerializedCandleSource serialized_source(candle_source_);
+        data::ICandleSource& worker_source = candle_source_.supportsConcurrentQueries()
+            ? candle_source_ : static_cast<data::ICandleSource&>(serialized_source);
+        const json strategy_template = Backtester::resolveUniverse(candle_source_, spec.strategy_template, start_date);
+        // Placeholders may pick the instrument or timeframe, so preload every distinct
+        // (instrument, first timeframe) of the grid, not just the first combination's
+        std::set<std::pair<std::string, std::string>> series_keys;
+        {
+            json data_template = json::object();
+            for (const char* key : {"instruments", "timeframes"}) {
+                if (strategy_template.contains(key)) data_template[key] = strategy_template[key];
+            }
+            for (const auto& params : grid) {
+                const json config = instantiate(data_template, params);
+                if (!config.contains("instruments") || !config["instruments"].is_array() ||
+                    !config.contains("timeframes") || !config["timeframes"].is_array() || config["timeframes"].empty() ||
+                    !config["timeframes"][0].is_string()) {
+                    continue; // Rejected later by the strategy factory
+                }
+                const std::string timeframe = config["timeframes"][0].get<std::string>();
+                for (const auto& entry : config["instruments"]) {
+                    if (entry.is_string()) series_keys.emplace(entry.get<std::string>(), timeframe);
+                }
+            }
+        }
+        // First and last loaded bar over all instruments; halving prefixes are shares of it
+        std::mutex span_mutex;
+        std::optional<std::pair<std::int64_t, std::int64_t>> data_span;
+        {
+            auto [start_ts, end_ts] = Backtester::queryRangeForDates(start_date, end_date);
+            auto preload = [&, start_ts = start_ts, end_ts = end_ts](const std::string& instrument, const std::string& timeframe) {
+                const double tick_size = data_cache_->compactStorage() ? candle_source_.queryTickSize(instrument).value_or(0.0) : 0.0;
+                auto series = data_cache_->getOrLoad(instrument, timeframe, start_ts, end_ts, [&]() {
+                    return candle_source_.queryCandleSeries(instrument, timeframe, start_ts, end_ts);
+                }, tick_size);
+                logger->info("Sweep data preloaded: {} candles for {} ({}).", series->size(), instrument, timeframe);
+                if (series->size() == 0) return;
+                const auto timestamps = series->timestampsNs();
+                std::lock_guard<std::mutex> lock(span_mutex);
+                data_span = data_span ? std::make_pair(std::min(data_span->first, timestamps.front()),
+                                                       std::max(data_span->second, timestamps.back()))
+                                      : std::make_pair(timestamps.front(), timestamps.back());
+            };
+            std::vector<std::future<void>> loads;
+            for (const auto& [instrument, timeframe] : series_keys) {
+                if (candle_source_.supportsConcurrentQueries()) {
+                    loads.push_back(pool.submit([&preload, &instrument = instrument, &timeframe = timeframe]() {
+                        preload(instrument, timeframe);
+                    }));
+                } else {
+                    preload(instrument, timeframe);
+                }
+            }
+            for (auto& f : loads) f.wait(); // Let every load finish before rethrowing
+            for (auto& f : loads) f.get();
+        }
+
+        // One round: every combination in 'combos' trades [range_start, cutoff] (the whole
+        // range if unset) of the loaded data, or of the evaluation range if one is set
+        const auto range = evaluation_range_ ? *evaluation_range_ : Backtester::queryRangeForDates(start_date, end_date);
+        std::vector<SweepResult> results(grid.size());
+        auto runRound = [&](const std::vector<std::size_t>& combos, std::optional<core::Timestamp> cutoff, double fraction,
+                            const std::string& round_label) {
+            std::vector<std::future<void>> pending;
+            pending.reserve(combos.size());
+            for (std::size_t i : combos) {
+                pending.push_back(pool.submit([&, i]() {
+                    SweepResult& result = results[i];
+                    result.parameters = grid[i];
+                    result.data_fraction = fraction;
+                    Backtester backtester(worker_source, initial_capital_);
+                    backtester.setDataCache(data_cache_);
+                    backtester.setIndicatorCache(indicator_cache_);
+                    backtester.setEvaluationMode(evaluation_mode_);
+                    if (spec.stop.any()) backtester.setStopCriteria(spec.stop);
+                    if (cutoff) backtester.setEvaluationRange(range.first, *cutoff);
+                    else if (evaluation_range_) backtester.setEvaluationRange(range.first, range.second);
+                    result.success = backtester.run(instantiate(strategy_template, grid[i]), start_date, end_date);
+                    result.metrics = backtester.getMetrics();
+                    if (results_writer_) {
+                        results_writer_->write(describeParameters(grid[i]) + round_label, result.success, result.metrics,
+                                               backtester.getPortfolio());
+                    }
+                }));
+            }
+            for (std::size_t k = 0; k < pending.size(); ++k) {
+                try {
+                    pending[k].get();
+                } catch (const std::exception& e) {
+                    logger->error("Sweep combination [{}] failed: {}", describeParameters(grid[combos[k]]), e.what());
+                    results[combos[k]].success = false;
+                }
+            }
+        };
+
+        std::vector<std::size_t> remaining(grid.size());
+        std::iota(remaining.begin(), remaining.end(), std::size_t{0});
+        std::int64_t start_ns = core::utils::timestampToEpochNanos(range.first);
+        std::int64_t end_ns = core::utils::timestampToEpochNanos(range.second);
+        if (data_span) {
+            start_ns = std::max(start_ns, data_span->first);
+            end_ns = std::min(end_ns, data_span->second);
+        }
+        const std::int64_t span_ns = std::max<std::int64_t>(0, end_ns - start_ns);
+        const bool ascending = ranksAscending(spec.rank_by);
+        for (std::size_t round = 0; round < spec.halving_rounds && remaining.size() > 1; ++round) {
+            const double fraction = std::pow(spec.halving_keep, static_cast<double>(spec.halving_rounds - round));
+            const auto cutoff = core::utils::epochNanosToTimestamp(start_ns + static_cast<std::int64_t>(fraction * static_cast<double>(span_ns)));
+            logger->info("Successive halving round {}/{}: {} combinations on the first {:.2f}% of the data.",
+                         round + 1, spec.halving_rounds, remaining.size(), fraction * 100.0);
+            runRound(remaining, cutoff, fraction, fmt::format(" (halving {}/{})", round + 1, spec.halving_rounds));
+
+            // The best 'keep' share advances; failed and stopped runs never do
+            std::stable_sort(remaining.begin(), remaining.end(), [&](std::size_t a, std::size_t b) {
+                return ranksBefore(results[a], results[b], spec.rank_by, ascending);
+            });
+            const auto quota = static_cast<std::size_t>(std::ceil(static_cast<double>(remaining.size()) * spec.halving_keep));
+            std::size_t advancing = 0;
+            while (advancing < remaining.size() && advancing < quota &&
+                   results[remaining[advancing]].success && !results[remaining[advancing]].metrics.stopped_early) {
+                ++advancing;
+            }
+            for (std::size_t k = advancing; k < remaining.size(); ++k) results[remaining[k]].eliminated = true;
+            remaining.resize(advancing);
+        }
+        if (!remaining.empty()) {
+            if (spec.halving_rounds > 0) logger->info("Successive halving: {} combinations run on the whole range.", remaining.size());
+            runRound(remaining, std::nullopt, 1.0, std::string{});
+        }
+        std::size_t stopped = 0;
+        for (const auto& result : results) stopped += result.metrics.stopped_early ? 1 : 0;
+        if (spec.stop.any()) logger->info("Sweep: {} runs ended early by a stop criterion.", stopped);
+
+        logger->info("Sweep computed {} distinct indicator series.", indicator_cache_ ? indicator_cache_->size() : 0);
+        rankResults(results, spec.rank_by);
+        return results;
+    }
+
+    double ParameterSweep::metricValue(const BacktestMetrics& metrics, const std::string& metric_name) {
+        if (metric_name == "total_return_pct") return metrics.total_return_pct;
+        if (metric_name == "max_drawdown_pct") return metrics.max_drawdown_pct;
+        if (metric_name == "total_pnl") return metrics.total_pnl;
+        if (metric_name == "total_executions") return metrics.total_executions;
+        if (metric_name == "round_trip_trades") return metrics.round_trip_trades;
+        if (metric_name == "win_rate") return metrics.win_rate;
+        if (metric_name == "profit_factor") return metrics.profit_factor;
+        if (metric_name == "avg_win_pnl") return metrics.avg_win_pnl;
+        if (metric_name == "avg_loss_pnl") return metrics.avg_loss_pnl;
+        if (metric_name == "sharpe_ratio") return metrics.sharpe_ratio;
+        if (metric_name == "sortino_ratio") return metrics.sortino_ratio;
+        if (metric_name == "cagr_pct") return metrics.cagr_pct;
+        if (metric_name == "calmar_ratio") return metrics.calmar_ratio;
+        if (metric_name == "exposure_pct") return metrics.exposure_pct;
+        if (metric_name == "max_drawdown_duration_days") return metrics.max_drawdown_duration_days;
+        throw core::ConfigException("Unknown metric for ranking: " + metric_name);
+    }
+
+    void ParameterSweep::rankResults(std::vector<SweepResult>& results, const std::string& metric_name) {
+        const bool ascending = ranksAscending(metric_name);
+        std::stable_sort(results.begin(), results.end(), [&](const SweepResult& a, const SweepResult& b) {
+            return ranksBefore(a, b, metric_name, ascending);
+        });
+    }
+
+    void ParameterSweep::logResultsTable(const std::vector<SweepResult>& results, const SweepSpec& spec) {
+        auto logger = core::logging::getLogger();
+        std::size_t rows = std::min(results.size(), spec.top);
+        logger->info("--- Sweep Results (top {} of {}, ranked by {}) ---", rows, results.size(), spec.rank_by);
+        logger->info("{:>4}  {:<32} {:>10} {:>12} {:>8} {:>7} {:>8} {:>7}  {}",
+                     "Rank", "Parameters", "Return%", "PnL", "MaxDD%", "Trades", "WinRate%", "PF", "Status");
+        for (std::size_t i = 0; i < rows; ++i) {
+            const auto& r = results[i];
+            const std::string description = r.instrument.empty() ? describeParameters(r.parameters)
+                                                                 : r.instrument + ' ' + describeParameters(r.parameters);
+            if (!r.success) {
+                logger->info("{:>4}  {:<32} {:>10}", i + 1, description, "FAILED");
+                continue;
+            }
+            const auto& m = r.metrics;
+            std::string status = r.eliminated ? fmt::format("pruned at {:.2f}%", r.data_fraction * 100.0) : std::string{};
+            if (m.stopped_early) status += status.empty() ? "stopped" : ", stopped";
+            logger->info("{:>4}  {:<32} {:>10.2f} {:>12.2f} {:>8.2f} {:>7} {:>8.2f} {:>7.2f}  {}",
+                         i + 1, description, m.total_return_pct * 100.0, m.total_pnl,
+                         m.max_drawdown_pct * 100.0, m.round_trip_trades, m.win_rate * 100.0, m.profit_factor, status);
+        }
+        logger->info("------------------------");
+    }
+
+    bool ParameterSweep::writeResultsCsv(const std::string& path, const std::vector<SweepResult>& results) {
+        std::ofstream out(path);
+        if (!out.is_open()) {
+            core::logging::getLogger()->error("Failed to open sweep output file: {}", path);
+            return false;
+        }
+        // Parameter columns come from the first result (all share the same names)
+        std::vector<std::string> names;
+        if (!results.empty()) {
+            for (const auto& [name, value] : results.front().parameters) names.push_back(name);
+        }
+        // Per-instrument results (distributed sweeps) get an instrument column
+        const bool with_instrument = std::any_of(results.begin(), results.end(),
+                                                 [](const SweepResult& r) { return !r.instrument.empty(); });
+        out << "rank,success";
+        if (with_instrument) out << ",instrument";
+        for (const auto& name : names) out << ',' << name;
+        out << ",total_return_pct,total_pnl,max_drawdown_pct,total_executions,round_trip_trades,"
+               "win_rate,profit_factor,avg_win_pnl,avg_loss_pnl,sharpe_ratio,sortino_ratio,cagr_pct,calmar_ratio,"
+               "exposure_pct,max_drawdown_duration_days,stopped_early,eliminated,data_fraction\n";
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const auto& r = results[i];
+            const auto& m = r.metrics;
+            out << (i + 1) << ',' << (r.success ? 1 : 0);
+            if (with_instrument) out << ',' << r.instrument;
+            for (const auto& name : names) out << ',' << formatParameterValue(r.parameters.at(name));
+            out << fmt::format(",{},{},{},{},{},{},{},{},{},{},{},{},{},{},{},{},{},{}\n", m.total_return_pct, m.total_pnl,
+                               m.max_drawdown_pct, m.total_executions, m.round_trip_trades, m.win_rate, m.profit_factor,
+                               m.avg_win_pnl, m.avg_loss_pnl, m.sharpe_ratio, m.sortino_ratio, m.cagr_pct,
+                               m.calmar_ratio, m.exposure_pct, m.max_drawdown_duration_days,
+                               m.stopped_early ? 1 : 0, r.eliminated ? 1 : 0, r.data_fraction);
+        }
+        out.close();
+        if (!out) {
+            core::logging::getLogger()->error("Failed writing sweep output file: {}", path);
+            return false;
+        }
+        core::logging::getLogger()->info("Sweep results written to {}", path);
+        return true;
+    }
+
+} // namespace backtester
@@ -2,16 +2,19 @@
 #include "logging.hpp" // <<<--- ADD THIS
 #include "utils.hpp"   // <<<--- ADD THIS
 #include <stdexcept> // For invalid_argument
-#include <numeric>   // For std::accumulate (used in getCurrentEquity)
+#include <algorithm> // For std::lower_bound (open_ids_)
+#include <cmath>     // For std::abs
+#include <utility>   // For std::move
 
 namespace backtester {
 
 
-    Portfolio::Portfolio(double initial_capital)
-        : initial_capital_(initial_capital), cash_(initial_capital) {
+    Portfolio::Portfolio(double initial_capital, std::pmr::memory_resource* memory)
+        : initial_capital_(initial_capital), cash_(initial_capital), equity_curve_(memory), trade_log_(memory) {
         if (initial_capital <= 0) {
             throw std::invalid_argument("Initial capital must be positive.");
         }
+        running_metrics_.reset(initial_capital);
         // Optional: Record initial state at time zero?
     }
 
@@ -19,68 +22,108 @@ namespace backtester {
         return cash_;
     }
 
+    InstrumentId Portfolio::addInstrument(const std::string& instrument_key) {
+        const auto [it, inserted] = instrument_ids_.try_emplace(instrument_key, static_cast<InstrumentId>(instrument_keys_.size()));
+        if (inserted) {
+            instrument_keys_.push_back(instrument_key);
+            positions_.push_back(0);
+            open_positions_info_.emplace_back();
+            open_ids_.reserve(instrument_keys_.size()); // Opening a position never reallocates
+        }
+        return it->second;
+    }
+
+    std::optional<InstrumentId> Portfolio::findInstrument(const std::string& instrument_key) const {
+        const auto it = instrument_ids_.find(instrument_key);
+        if (it == instrument_ids_.end()) return std::nullopt;
+        return it->second;
+    }
+
     long long Portfolio::getPositionQuantity(const std::string& instrument_key) const {
-         auto it = positions_.find(instrument_key);
-         return (it != positions_.end()) ? it->second : 0;
+         const auto id = findInstrument(instrument_key);
+         return id ? positions_[*id] : 0;
      }
 
-    // Calculates total equity based on current cash and market value of positions
-    double Portfolio::getCurrentEquity(const std::map<std::string, double>& current_prices) const {
+    double Portfolio::positionsValue(std::span<const double> current_prices) const {
         double total_position_value = 0.0;
-        for(const auto& pair : positions_) {
-             const std::string& key = pair.first;
-             long long quantity = pair.second;
-             auto price_it = current_prices.find(key);
-             if (price_it != current_prices.end()) {
-                 total_position_value += quantity * price_it->second;
-             } else {
-                 // Price missing for a held position - this is problematic!
-                 // For now, we might have to assume it contributes zero or throw error.
-                 // Logging handled elsewhere perhaps.
+        for (const InstrumentId id : open_ids_) {
+             if (id < current_prices.size()) {
+                 total_position_value += positions_[id] * current_prices[id];
              }
+             // else: price missing for a held position; it contributes zero
         }
-        return cash_ + total_position_value;
+        return total_position_value;
+    }
+
+    std::span<const double> Portfolio::pricesById(const std::map<std::string, double>& current_prices) const {
+        price_scratch_.assign(instrument_keys_.size(), 0.0);
+        for (const InstrumentId id : open_ids_) {
+             auto price_it = current_prices.find(instrument_keys_[id]);
+             if (price_it != current_prices.end()) price_scratch_[id] = price_it->second;
+        }
+        return price_scratch_;
+    }
+
+    // Calculates total equity based on current cash and market value of positions
+    double Portfolio::getCurrentEquity(std::span<const double> current_prices) const {
+        return cash_ + positionsValue(current_prices);
+    }
+
+    double Portfolio::getCurrentEquity(const std::map<std::string, double>& current_prices) const {
+        return getCurrentEquity(pricesById(current_prices));
     }
 
-    const std::vector<PortfolioState>& Portfolio::getEquityCurve() const {
+    const std::pmr::vector<PortfolioState>& Portfolio::getEquityCurve() const {
         return equity_curve_;
     }
 
     // Records the portfolio state at a specific timestamp
-    void Portfolio::recordTimestampValue(core::Timestamp timestamp, const std::map<std::string, double>& current_prices) {
+    void Portfolio::recordTimestampValue(core::Timestamp timestamp, std::span<const double> current_prices) {
         // Avoid duplicate entries for the same timestamp
-        if (equity_curve_.empty() || equity_curve_.back().timestamp != timestamp) {
+        if (running_metrics_.points() == 0 || running_metrics_.last().timestamp != timestamp) {
             PortfolioState current_state;
             current_state.timestamp = timestamp;
             current_state.cash = cash_;
-
-            double pos_value = 0.0;
-            for(const auto& pair : positions_) {
-                auto price_it = current_prices.find(pair.first);
-                if (price_it != current_prices.end()) {
-                    pos_value += pair.second * price_it->second;
-                }
-            }
-            current_state.positions_value = pos_value;
+            current_state.positions_value = positionsValue(current_prices);
             current_state.total_equity = current_state.cash + current_state.positions_value;
-            equity_curve_.push_back(current_state);
+            if (keep_equity_curve_) equity_curve_.push_back(current_state);
+            running_metrics_.addPoint(current_state, !open_ids_.empty());
         }
     }
 
+    void Portfolio::recordTimestampValue(core::Timestamp timestamp, const std::map<std::string, double>& current_prices) {
+        recordTimestampValue(timestamp, pricesById(current_prices));
+    }
+
     void Portfolio::recordTrade(core::Timestamp timestamp,
         const std::string& instrument_key,
         core::SignalAction action,
+        long long quantity,
+        double execution_price,
+        double commission)
+    {
+        recordTrade(timestamp, addInstrument(instrument_key), action, quantity, execution_price, commission);
+    }
+
+    void Portfolio::recordTrade(core::Timestamp timestamp,
+        InstrumentId id,
+        core::SignalAction action,
         long long quantity, // Assumed positive from executeSignal
         double execution_price,
         double commission) // Commission for THIS execution leg
     {
         auto logger = core::logging::getLogger();
+        if (id >= instrument_keys_.size()) {
+        logger->warn("recordTrade called with unknown instrument ID: {}", id);
+        return;
+        }
         if (quantity <= 0) {
         logger->warn("Attempted to record trade with zero or negative quantity: {}", quantity);
         return;
         }
 
-        long long current_qty = getPositionQuantity(instrument_key);
+        const std::string& instrument_key = instrument_keys_[id];
+        long long current_qty = positions_[id];
         long long position_change = 0;
         double cost = 0.0; // Net change in cash
         bool is_entry = false;
@@ -137,7 +180,10 @@ namespace backtester {
 
         // --- Update Portfolio State ---
         cash_ += cost;
-        positions_[instrument_key] += position_change;
+        positions_[id] += position_change;
+        if (current_qty == 0) { // Newly open
+        open_ids_.insert(std::lower_bound(open_ids_.begin(), open_ids_.end(), id), id);
+        }
         execution_count_++; // Count every execution
 
         logger->info("Trade Executed: Time={}, Inst={}, Action={}, Qty={}, Price={:.2f}, Comm={:.2f}, Cost={:.2f}, NewCash={:.2f}, NewPosQty={}",
@@ -149,15 +195,14 @@ namespace backtester {
         commission,
         cost,
         cash_,
-        getPositionQuantity(instrument_key)
+        positions_[id]
         );
 
         // --- Log Completed Trade ---
         if (is_exit) {
-        auto it_info = open_positions_info_.find(instrument_key);
-        if (it_info != open_positions_info_.end()) {
+        OpenPositionInfo& entry_info = open_positions_info_[id];
+        if (entry_info.entry_quantity != 0) {
         // Calculate PnL for this round trip
-        const auto& entry_info = it_info->second;
         double entry_value = entry_info.entry_quantity * entry_info.entry_price;
         // Note: position_change here is negative for long exit, positive for short exit
         double exit_value = (-position_change) * execution_price; // Value of shares sold/bought back
@@ -180,11 +225,12 @@ namespace backtester {
         }
         trade.return_pct = (entry_value != 0) ? trade.pnl / std::abs(entry_value) : 0.0;
 
-        trade_log_.push_back(trade);
         logger->debug("Round Trip Trade Logged: PnL = {:.2f}", trade.pnl);
+        running_metrics_.addTrade(trade);
+        trade_log_.push_back(std::move(trade));
 
         // Clean up open position info
-        open_positions_info_.erase(it_info);
+        entry_info = OpenPositionInfo{};
         } else {
         logger->warn("Exited position for {} but no entry info found.", instrument_key);
         }
@@ -195,20 +241,20 @@ namespace backtester {
         entry_info.entry_price = execution_price;
         entry_info.entry_quantity = position_change; // Store signed quantity (+ for long, - for short)
         entry_info.entry_commission = commission;
-        open_positions_info_[instrument_key] = entry_info;
+        open_positions_info_[id] = entry_info;
         logger->debug("Entry info recorded for {}. Qty: {}, Price: {:.2f}", instrument_key, entry_info.entry_quantity, entry_info.entry_price);
         }
         // Handle partial exits / pyramiding later if needed by adjusting OpenPositionInfo
 
-        // Remove instrument from main positions_ map if flat
-        if (positions_[instrument_key] == 0) {
-        positions_.erase(instrument_key);
+        // Drop the instrument from the open set if flat
+        if (positions_[id] == 0) {
+        open_ids_.erase(std::lower_bound(open_ids_.begin(), open_ids_.end(), id));
         // Ensure open info is also removed if somehow missed by is_exit logic
-        open_positions_info_.erase(instrument_key);
+        open_positions_info_[id] = OpenPositionInfo{};
         }
     }
 
-    const std::vector<core::Trade>& Portfolio::getTradeLog() const {
+    const std::pmr::vector<core::Trade>& Portfolio::getTradeLog() const {
         // Simply return the member variable
         return trade_log_;
     }
@@ -0,0 +1,441 @@
+#include "results_writer.hpp"
+#include "exceptions.hpp"
+#include "logging.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+
+namespace backtester {
+
+    namespace { // File-local helpers
+
+        constexpr std::uint32_t kRunColumns = 19;
+        constexpr std::uint32_t kEquityColumns = 5;
+        constexpr std::uint32_t kTradeColumns = 11;
+
+        void padTo8(std::vector<char>& payload) {
+            payload.resize((payload.size() + 7) / 8 * 8, '\0');
+        }
+
+        template <typename T>
+        void appendColumn(std::vector<char>& payload, const std::vector<T>& values) {
+            const auto* bytes = reinterpret_cast<const char*>(values.data());
+            payload.insert(payload.end(), bytes, bytes + values.size() * sizeof(T));
+            padTo8(payload);
+        }
+
+        // Column of one field of every element of 'rows'
+        template <typename T, typename Row, typename Field>
+        void appendColumn(std::vector<char>& payload, const std::vector<Row>& rows, Field field) {
+            std::vector<T> values;
+            values.reserve(rows.size());
+            for (const auto& row : rows) values.push_back(static_cast<T>(field(row)));
+            appendColumn(payload, values);
+        }
+
+        // Sequential reader over a payload; every read fails once the payload runs out
+        class PayloadReader {
+        public:
+            PayloadReader(const char* data, std::size_t size) : data_(data), size_(size) {}
+
+            template <typename T>
+            bool column(std::size_t rows, std::vector<T>& out) {
+                const std::size_t bytes = rows * sizeof(T);
+                if (rows > size_ / sizeof(T) || pos_ + bytes > size_) return false;
+                out.resize(rows);
+                std::memcpy(out.data(), data_ + pos_, bytes);
+                pos_ = std::min(size_, (pos_ + bytes + 7) / 8 * 8);
+                return true;
+            }
+
+            bool bytes(std::size_t count, std::string& out) {
+                if (pos_ + count > size_) return false;
+                out.assign(data_ + pos_, count);
+                pos_ = std::min(size_, (pos_ + count + 7) / 8 * 8);
+                return true;
+            }
+
+        private:
+            const char* data_;
+            std::size_t size_;
+            std::size_t pos_ = 0;
+        };
+
+    } // end anonymous namespace
+
+    std::uint32_t ResultsWriter::Dictionary::encode(const std::string& text) {
+        auto [it, inserted] = ids.try_emplace(text, static_cast<std::uint32_t>(ids.size()));
+        if (inserted) pending.push_back(text);
+        return it->second;
+    }
+
+    ResultsWriter::ResultsWriter(std::string path, ResultsWriterOptions options)
+        : path_(std::move(path)), tmp_path_(core::utils::uniqueTempPath(path_)), options_(options)
+    {
+        options_.batch_rows = std::max<std::size_t>(options_.batch_rows, 1);
+        options_.max_queued_runs = std::max<std::size_t>(options_.max_queued_runs, 1);
+        out_.open(tmp_path_, std::ios::binary | std::ios::trunc);
+        if (!out_.is_open()) throw core::DataLoadException("Cannot create results file: " + tmp_path_);
+
+        ResultsFileHeader header{};
+        std::memcpy(header.magic, kResultsMagic, sizeof(kResultsMagic));
+        header.version = kResultsVersion;
+        out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        bytes_written_ = sizeof(header);
+
+        writer_ = std::thread([this]() { writerLoop(); });
+        core::logging::getLogger()->debug("ResultsWriter writing to {}", path_);
+    }
+
+    ResultsWriter::~ResultsWriter() {
+        close();
+    }
+
+    std::uint32_t ResultsWriter::write(const std::string& label, bool success, const BacktestMetrics& metrics,
+                                       const Portfolio& portfolio)
+    {
+        // Copied on the caller's thread, outside the lock
+        QueuedRun run;
+        run.label = label;
+        run.success = success;
+        run.metrics = metrics;
+        if (options_.equity_curves) {
+            const auto& curve = portfolio.getEquityCurve();
+            run.equity.assign(curve.begin(), curve.end());
+        }
+        if (options_.trade_logs) {
+            const auto& trades = portfolio.getTradeLog();
+            run.trades.assign(trades.begin(), trades.end());
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this]() { return queue_.size() < options_.max_queued_runs || closing_; });
+        run.run_id = next_run_id_++;
+        if (closing_) {
+            core::logging::getLogger()->error("Results file {} is already closed; run '{}' is not written.", path_, label);
+            return run.run_id;
+        }
+        const std::uint32_t run_id = run.run_id;
+        queue_.push_back(std::move(run));
+        not_empty_.notify_one();
+        return run_id;
+    }
+
+    bool ResultsWriter::close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (closed_) return !failed_;
+            closed_ = true;
+            closing_ = true;
+        }
+        not_empty_.notify_all();
+        not_full_.notify_all();
+        if (writer_.joinable()) writer_.join();
+
+        auto logger = core::logging::getLogger();
+        if (!failed_) writeBlock(kResultsBlockEnd, 0, 0, 0, {});
+        out_.close();
+        failed_ = failed_ || out_.fail();
+
+        std::error_code ec;
+        if (!failed_) {
+            std::filesystem::rename(tmp_path_, path_, ec);
+            if (ec) {
+                logger->error("Cannot finalize results file '{}': {}", path_, ec.message());
+                failed_ = true;
+            }
+        }
+        if (failed_) {
+            logger->error("Results file {} was not written.", path_);
+            std::filesystem::remove(tmp_path_, ec);
+            return false;
+        }
+        logger->info("Results written to {} ({} runs, {} equity points, {} trades, {} bytes).",
+                     path_, runs_written_, equity_rows_written_, trade_rows_written_, bytes_written_);
+        return true;
+    }
+
+    void ResultsWriter::writerLoop() {
+        for (;;) {
+            QueuedRun run;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                not_empty_.wait(lock, [this]() { return !queue_.empty() || closing_; });
+                if (queue_.empty()) break; // Closing and drained
+                run = std::move(queue_.front());
+                queue_.pop_front();
+            }
+            not_full_.notify_one();
+            if (!failed_) append(run);
+        }
+        if (!failed_) flushBlocks(true);
+    }
+
+    void ResultsWriter::append(QueuedRun& run) {
+        std::uint32_t flags = 0;
+        if (run.success) flags |= kResultsRunSuccess;
+        if (run.metrics.stopped_early) flags |= kResultsRunStoppedEarly;
+        runs_.push_back({run.run_id, labels_.encode(run.label), flags, run.metrics});
+
+        for (const auto& point : run.equity) {
+            equity_.run_id.push_back(run.run_id);
+            equity_.timestamp_ns.push_back(core::utils::timestampToEpochNanos(point.timestamp));
+            equity_.cash.push_back(point.cash);
+            equity_.positions_value.push_back(point.positions_value);
+            equity_.total_equity.push_back(point.total_equity);
+        }
+        for (const auto& trade : run.trades) {
+            trades_.run_id.push_back(run.run_id);
+            trades_.instrument.push_back(instruments_.encode(trade.instrument_key));
+            trades_.entry_action.push_back(static_cast<std::int32_t>(trade.entry_action));
+            trades_.entry_time_ns.push_back(core::utils::timestampToEpochNanos(trade.entry_time));
+            trades_.exit_time_ns.push_back(core::utils::timestampToEpochNanos(trade.exit_time));
+            trades_.quantity.push_back(trade.quantity);
+            trades_.entry_price.push_back(trade.entry_price);
+            trades_.exit_price.push_back(trade.exit_price);
+            trades_.commission.push_back(trade.commission);
+            trades_.pnl.push_back(trade.pnl);
+            trades_.return_pct.push_back(trade.return_pct);
+        }
+
+        if (runs_.size() >= options_.batch_rows || equity_.run_id.size() >= options_.batch_rows ||
+            trades_.run_id.size() >= options_.batch_rows) {
+            flushBlocks(false);
+        }
+    }
+
+    void ResultsWriter::flushBlocks(bool force) {
+        writeDictionary(kResultsInstrumentDictionary, instruments_);
+        writeDictionary(kResultsLabelDictionary, labels_);
+        auto due = [&](std::size_t rows) { return rows > 0 && (force || rows >= options_.batch_rows); };
+
+        if (due(runs_.size())) {
+            payload_.clear();
+            appendColumn<std::uint32_t>(payload_, runs_, [](const RunRow& r) { return r.run_id; });
+            appendColumn<std::uint32_t>(payload_, runs_, [](const RunRow& r) { return r.label; });
+            appendColumn<std::uint32_t>(payload_, runs_, [](const RunRow& r) { return r.flags; });
+            appendColumn<std::int64_t>(payload_, runs_, [](const RunRow& r) { return r.metrics.total_executions; });
+            appendColumn<std::int64_t>(payload_, runs_, [](const RunRow& r) { return r.metrics.round_trip_trades; });
+            appendColumn<std::int64_t>(payload_, runs_, [](const RunRow& r) { return r.metrics.max_drawdown_duration_bars; });
+            appendColumn<double>(payload_, runs_, [](const RunRow& r) { return r.metrics.total_return_pct; });
+            appendColumn<double>(payload_, runs_, [](const RunRow& r) { return r.metrics.total_pnl; });
+            appendColumn<double>(payload_, runs_, [](const RunRow& r) { return r.metrics.max_drawdown_pct; });
+            appendColumn<double>(payload_, runs_, [](const RunRow& r) { return r.metrics.win_rate; });
+            appendColumn<double>(payload_, runs_, [](const RunRow& r) { return r.metrics.profit_factor; });
+            appendColumn<double>(payload_, runs_, [](const RunRow& r) { return r.metrics.avg_win_pnl; });
+            appendColumn<double>(payload_, runs_, [](const RunRow& r) { return r.metrics.avg_loss_pnl; });
+            appendColumn<double>(payload_, runs_, [](const RunRow& r) { return r.metrics.sharpe_ratio; });
+            appendColumn<double>(payload_, runs_, [](const RunRow& r) { return r.metrics.sortino_ratio; });
+            appendColumn<double>(payload_, runs_, [](const RunRow& r) { return r.metrics.cagr_pct; });
+            appendColumn<double>(payload_, runs_, [](const RunRow& r) { return r.metrics.calmar_ratio; });
+            appendColumn<double>(payload_, runs_, [](const RunRow& r) { return r.metrics.exposure_pct; });
+            appendColumn<double>(payload_, runs_, [](const RunRow& r) { return r.metrics.max_drawdown_duration_days; });
+            writeBlock(kResultsBlockRuns, 0, runs_.size(), kRunColumns, payload_);
+            runs_written_ += runs_.size();
+            runs_.clear();
+        }
+
+        if (due(equity_.run_id.size())) {
+            payload_.clear();
+            appendColumn(payload_, equity_.run_id);
+            appendColumn(payload_, equity_.timestamp_ns);
+            appendColumn(payload_, equity_.cash);
+            appendColumn(payload_, equity_.positions_value);
+            appendColumn(payload_, equity_.total_equity);
+            writeBlock(kResultsBlockEquity, 0, equity_.run_id.size(), kEquityColumns, payload_);
+            equity_rows_written_ += equity_.run_id.size();
+            equity_ = {};
+        }
+
+        if (due(trades_.run_id.size())) {
+            payload_.clear();
+            appendColumn(payload_, trades_.run_id);
+            appendColumn(payload_, trades_.instrument);
+            appendColumn(payload_, trades_.entry_action);
+            appendColumn(payload_, trades_.entry_time_ns);
+            appendColumn(payload_, trades_.exit_time_ns);
+            appendColumn(payload_, trades_.quantity);
+            appendColumn(payload_, trades_.entry_price);
+            appendColumn(payload_, trades_.exit_price);
+            appendColumn(payload_, trades_.commission);
+            appendColumn(payload_, trades_.pnl);
+            appendColumn(payload_, trades_.return_pct);
+            writeBlock(kResultsBlockTrades, 0, trades_.run_id.size(), kTradeColumns, payload_);
+            trade_rows_written_ += trades_.run_id.size();
+            trades_ = {};
+        }
+    }
+
+    void ResultsWriter::writeDictionary(std::uint32_t dictionary_id, Dictionary& dictionary) {
+        if (dictionary.pending.empty()) return;
+        std::vector<std::uint32_t> lengths;
+        lengths.reserve(dictionary.pending.size());
+        for (const auto& entry : dictionary.pending) lengths.push_back(static_cast<std::uint32_t>(entry.size()));
+        payload_.clear();
+        appendColumn(payload_, lengths);
+        for (const auto& entry : dictionary.pending) payload_.insert(payload_.end(), entry.begin(), entry.end());
+        padTo8(payload_);
+        writeBlock(kResultsBlockDictionary, dictionary_id, dictionary.pending.size(), 2, payload_);
+        dictionary.pending.clear();
+    }
+
+    void ResultsWriter::writeBlock(std::uint32_t kind, std::uint32_t tag, std::uint64_t rows, std::uint32_t columns,
+                                   const std::vector<char>& payload)
+    {
+        ResultsBlockHeader header{};
+        header.kind = kind;
+        header.tag = tag;
+        header.row_count = rows;
+        header.payload_bytes = payload.size();
+        header.column_count = columns;
+        out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out_.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+        bytes_written_ += sizeof(header) + payload.size();
+        if (!out_ && !failed_) {
+            core::logging::getLogger()->error("Failed writing results file: {}", tmp_path_);
+            failed_ = true;
+        }
+    }
+
+    std::optional<ResultsFileContents> readResultsFile(const std::string& path) {
+        auto logger = core::logging::getLogger();
+        std::ifstream in(path, std::ios::binary);
+        if (!in.is_open()) {
+            logger->error("Cannot open results file: {}", path);
+            return std::nullopt;
+        }
+        const std::vector<char> file((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+        ResultsFileHeader header{};
+        if (file.size() < sizeof(header)) {
+            logger->error("Results file {} is too short.", path);
+            return std::nullopt;
+        }
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.magic, kResultsMagic, sizeof(kResultsMagic)) != 0 || header.version != kResultsVersion) {
+            logger->error("{} is not a version {} results file.", path, kResultsVersion);
+            return std::nullopt;
+        }
+
+        ResultsFileContents contents;
+        std::vector<std::string> dictionaries[2];
+        auto lookup = [&](std::uint32_t dictionary_id, std::uint32_t id) -> const std::string* {
+            return (id < dictionaries[dictionary_id].size()) ? &dictionaries[dictionary_id][id] : nullptr;
+        };
+        auto malformed = [&](const char* what) {
+            logger->error("Results file {} has a malformed {} block.", path, what);
+            return std::nullopt;
+        };
+
+        std::size_t pos = sizeof(header);
+        for (;;) {
+            ResultsBlockHeader block{};
+            if (file.size() - pos < sizeof(block)) {
+                logger->error("Results file {} is truncated (no end block).", path);
+                return std::nullopt;
+            }
+            std::memcpy(&block, file.data() + pos, sizeof(block));
+            pos += sizeof(block);
+            if (block.kind == kResultsBlockEnd) break;
+            if (block.payload_bytes > file.size() - pos) {
+                logger->error("Results file {} is truncated.", path);
+                return std::nullopt;
+            }
+            PayloadReader payload(file.data() + pos, static_cast<std::size_t>(block.payload_bytes));
+            pos += static_cast<std::size_t>(block.payload_bytes);
+            const auto rows = static_cast<std::size_t>(block.row_count);
+
+            if (block.kind == kResultsBlockDictionary) {
+                if (block.tag >= 2) continue; // Unknown dictionary
+                std::vector<std::uint32_t> lengths;
+                if (!payload.column(rows, lengths)) return malformed("dictionary");
+                std::uint64_t total = 0;
+                for (auto length : lengths) total += length;
+                std::string bytes;
+                if (!payload.bytes(static_cast<std::size_t>(total), bytes)) return malformed("dictionary");
+                std::size_t offset = 0;
+                for (auto length : lengths) {
+                    dictionaries[block.tag].push_back(bytes.substr(offset, length));
+                    offset += length;
+                }
+            } else if (block.kind == kResultsBlockRuns) {
+                std::vector<std::uint32_t> run_id, label, flags;
+                std::vector<std::int64_t> executions, round_trips, duration_bars;
+                std::vector<double> values[13];
+                bool ok = block.column_count >= kRunColumns &&
+                          payload.column(rows, run_id) && payload.column(rows, label) && payload.column(rows, flags) &&
+                          payload.column(rows, executions) && payload.column(rows, round_trips) &&
+                          payload.column(rows, duration_bars);
+                for (auto& column : values) ok = ok && payload.column(rows, column);
+                if (!ok) return malformed("runs");
+                for (std::size_t i = 0; i < rows; ++i) {
+                    const std::string* text = lookup(kResultsLabelDictionary, label[i]);
+                    if (!text) return malformed("runs");
+                    ResultsFileContents::Run run;
+                    run.run_id = run_id[i];
+                    run.label = *text;
+                    run.success = (flags[i] & kResultsRunSuccess) != 0;
+                    BacktestMetrics& m = run.metrics;
+                    m.stopped_early = (flags[i] & kResultsRunStoppedEarly) != 0;
+                    m.total_executions = static_cast<int>(executions[i]);
+                    m.round_trip_trades = static_cast<int>(round_trips[i]);
+                    m.max_drawdown_duration_bars = static_cast<std::size_t>(duration_bars[i]);
+                    double* fields[13] = {&m.total_return_pct, &m.total_pnl, &m.max_drawdown_pct, &m.win_rate,
+                                          &m.profit_factor, &m.avg_win_pnl, &m.avg_loss_pnl, &m.sharpe_ratio,
+                                          &m.sortino_ratio, &m.cagr_pct, &m.calmar_ratio, &m.exposure_pct,
+                                          &m.max_drawdown_duration_days};
+                    for (std::size_t f = 0; f < 13; ++f) *fields[f] = values[f][i];
+                    contents.runs.push_back(std::move(run));
+                }
+            } else if (block.kind == kResultsBlockEquity) {
+                std::vector<std::uint32_t> run_id;
+                std::vector<std::int64_t> timestamp_ns;
+                std::vector<double> cash, positions_value, total_equity;
+                if (block.column_count < kEquityColumns || !payload.column(rows, run_id) ||
+                    !payload.column(rows, timestamp_ns) || !payload.column(rows, cash) ||
+                    !payload.column(rows, positions_value) || !payload.column(rows, total_equity)) {
+                    return malformed("equity");
+                }
+                for (std::size_t i = 0; i < rows; ++i) {
+                    contents.equity.emplace_back(run_id[i], PortfolioState{core::utils::epochNanosToTimestamp(timestamp_ns[i]),
+                                                                           cash[i], positions_value[i], total_equity[i]});
+                }
+            } else if (block.kind == kResultsBlockTrades) {
+                std::vector<std::uint32_t> run_id, instrument;
+                std::vector<std::int32_t> entry_action;
+                std::vector<std::int64_t> entry_time, exit_time, quantity;
+                std::vector<double> entry_price, exit_price, commission, pnl, return_pct;
+                if (block.column_count < kTradeColumns || !payload.column(rows, run_id) ||
+                    !payload.column(rows, instrument) || !payload.column(rows, entry_action) ||
+                    !payload.column(rows, entry_time) || !payload.column(rows, exit_time) ||
+                    !payload.column(rows, quantity) || !payload.column(rows, entry_price) ||
+                    !payload.column(rows, exit_price) || !payload.column(rows, commission) ||
+                    !payload.column(rows, pnl) || !payload.column(rows, return_pct)) {
+                    return malformed("trades");
+                }
+                for (std::size_t i = 0; i < rows; ++i) {
+                    const std::string* key = lookup(kResultsInstrumentDictionary, instrument[i]);
+                    if (!key) return malformed("trades");
+                    core::Trade trade;
+                    trade.instrument_key = *key;
+                    trade.entry_action = static_cast<core::SignalAction>(entry_action[i]);
+                    trade.entry_time = core::utils::epochNanosToTimestamp(entry_time[i]);
+                    trade.exit_time = core::utils::epochNanosToTimestamp(exit_time[i]);
+                    trade.quantity = quantity[i];
+                    trade.entry_price = entry_price[i];
+                    trade.exit_price = exit_price[i];
+                    trade.commission = commission[i];
+                    trade.pnl = pnl[i];
+                    trade.return_pct = return_pct[i];
+                    contents.trades.emplace_back(run_id[i], std::move(trade));
+                }
+            }
+            // Blocks of other kinds are skipped
+        }
+        return contents;
+    }
+
+} // namespace backtester
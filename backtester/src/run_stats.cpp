@@ -0,0 +1,148 @@
+#include "run_stats.hpp"
+#include "logging.hpp"
+
+#include <fstream>
+#include <utility>
+
+#include <sys/resource.h> // getrusage
+#include <time.h>         // clock_gettime
+
+namespace backtester {
+
+    namespace {
+
+        double secondsBetween(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+            return std::chrono::duration<double>(to - from).count();
+        }
+
+        long long peakRssKib() {
+            rusage usage{};
+            if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+            return static_cast<long long>(usage.ru_maxrss); // KiB on Linux
+        }
+
+        bool writeJsonFile(const std::string& path, const nlohmann::json& value, const char* what) {
+            std::ofstream out(path);
+            if (!out.is_open()) {
+                core::logging::getLogger()->error("Failed to open {} output file: {}", what, path);
+                return false;
+            }
+            out << value.dump(2) << '\n';
+            if (!out) {
+                core::logging::getLogger()->error("Failed to write {} to {}", what, path);
+                return false;
+            }
+            core::logging::getLogger()->info("Backtest {} written to {}", what, path);
+            return true;
+        }
+
+    } // namespace
+
+    ClockReading ClockReading::now() {
+        ClockReading reading;
+        reading.wall = std::chrono::steady_clock::now();
+        timespec cpu{};
+        if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu) == 0) {
+            reading.cpu_seconds = static_cast<double>(cpu.tv_sec) + static_cast<double>(cpu.tv_nsec) * 1e-9;
+        }
+        return reading;
+    }
+
+    PhaseTimer::PhaseTimer(BacktestRunStats& stats, const ClockReading& run_start, std::string name)
+        : stats_(stats), index_(stats.phases.size()), start_(ClockReading::now())
+    {
+        // Reserve the slot now so nested phases stay in start order
+        PhaseTiming phase;
+        phase.name = std::move(name);
+        phase.start_seconds = secondsBetween(run_start.wall, start_.wall);
+        stats_.phases.push_back(std::move(phase));
+    }
+
+    PhaseTimer::~PhaseTimer() {
+        const ClockReading end = ClockReading::now();
+        PhaseTiming& phase = stats_.phases[index_];
+        phase.wall_seconds = secondsBetween(start_.wall, end.wall);
+        phase.cpu_seconds = end.cpu_seconds - start_.cpu_seconds;
+    }
+
+    const PhaseTiming* BacktestRunStats::findPhase(std::string_view name) const {
+        for (const auto& phase : phases) {
+            if (phase.name == name) return &phase;
+        }
+        return nullptr;
+    }
+
+    void BacktestRunStats::finish(const ClockReading& run_start) {
+        const ClockReading end = ClockReading::now();
+        wall_seconds = secondsBetween(run_start.wall, end.wall);
+        cpu_seconds = end.cpu_seconds - run_start.cpu_seconds;
+        const PhaseTiming* loop = findPhase("event_loop");
+        if (!loop) loop = findPhase("streaming"); // Loading and indicators included, chunk by chunk
+        bars_per_second = (loop && loop->wall_seconds > 0.0) ? static_cast<double>(bars_processed) / loop->wall_seconds : 0.0;
+        peak_rss_kib = peakRssKib();
+    }
+
+    void BacktestRunStats::logSummary() const {
+        auto logger = core::logging::getLogger();
+        logger->info("--- Backtest Run Stats ---");
+        for (const auto& phase : phases) {
+            logger->info("{:<20} wall {:>10.3f} ms  cpu {:>10.3f} ms", phase.name,
+                         phase.wall_seconds * 1e3, phase.cpu_seconds * 1e3);
+        }
+        logger->info("{:<20} wall {:>10.3f} ms  cpu {:>10.3f} ms", "total", wall_seconds * 1e3, cpu_seconds * 1e3);
+        logger->info("Bars: {} ({:.0f} bars/s), strategy evaluations: {}, rule evaluations: {}",
+                     bars_processed, bars_per_second, strategy_evaluations, rule_evaluations);
+        logger->info("Signals: {}, executions: {}, peak RSS: {:.1f} MiB",
+                     signals, executions, static_cast<double>(peak_rss_kib) / 1024.0);
+        logger->info("--------------------------");
+    }
+
+    nlohmann::json BacktestRunStats::toJson() const {
+        nlohmann::json phase_list = nlohmann::json::array();
+        for (const auto& phase : phases) {
+            phase_list.push_back({{"name", phase.name},
+                                  {"start_seconds", phase.start_seconds},
+                                  {"wall_seconds", phase.wall_seconds},
+                                  {"cpu_seconds", phase.cpu_seconds}});
+        }
+        return {{"phases", phase_list},
+                {"wall_seconds", wall_seconds},
+                {"cpu_seconds", cpu_seconds},
+                {"bars_processed", bars_processed},
+                {"bars_per_second", bars_per_second},
+                {"strategy_evaluations", strategy_evaluations},
+                {"rule_evaluations", rule_evaluations},
+                {"signals", signals},
+                {"executions", executions},
+                {"peak_rss_kib", peak_rss_kib}};
+    }
+
+    nlohmann::json BacktestRunStats::toChromeTrace() const {
+        nlohmann::json events = nlohmann::json::array();
+        auto addEvent = [&](const std::string& name, double start_seconds, double wall_seconds, double cpu_seconds) {
+            events.push_back({{"name", name},
+                              {"cat", "backtest"},
+                              {"ph", "X"},
+                              {"ts", start_seconds * 1e6}, // Microseconds
+                              {"dur", wall_seconds * 1e6},
+                              {"pid", 1},
+                              {"tid", 1},
+                              {"args", {{"cpu_ms", cpu_seconds * 1e3}}}});
+        };
+        addEvent("Backtester::run", 0.0, wall_seconds, cpu_seconds);
+        for (const auto& phase : phases) addEvent(phase.name, phase.start_seconds, phase.wall_seconds, phase.cpu_seconds);
+
+        nlohmann::json counters = toJson();
+        counters.erase("phases");
+        return {{"traceEvents", events}, {"displayTimeUnit", "ms"}, {"otherData", counters}};
+    }
+
+    bool BacktestRunStats::writeJson(const std::string& path) const {
+        return writeJsonFile(path, toJson(), "run stats");
+    }
+
+    bool BacktestRunStats::writeChromeTrace(const std::string& path) const {
+        return writeJsonFile(path, toChromeTrace(), "trace");
+    }
+
+} // namespace backtester
@@ -0,0 +1,207 @@
+#include "screener_run.hpp"
+#include "backtester.hpp"         // resolveUniverse, queryRangeForDates
+#include "indicator_registry.hpp"
+#include "common_types.hpp"
+#include "logging.hpp"
+#include "utils.hpp"
+#include "exceptions.hpp"
+#include "spdlog/fmt/bundled/core.h" // Direct path for fmt safety
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+
+namespace backtester {
+
+    namespace { // File-local helpers
+
+        // One indicator column as the registry computes it
+        struct ColumnPlan {
+            std::string spec;       // Indicator without the output selector
+            std::size_t output = 0;
+        };
+
+        // Resolves every indicator column up front, so a typo fails before any data is loaded
+        std::vector<ColumnPlan> planColumns(const std::vector<std::string>& names) {
+            std::vector<ColumnPlan> plans;
+            for (const auto& name : names) {
+                const auto selected = strategy_engine::splitIndicatorOutput(name);
+                std::unique_ptr<indicators::IIndicator> indicator;
+                try {
+                    indicator = indicators::IndicatorRegistry::instance().create(selected.spec);
+                } catch (const std::invalid_argument& e) {
+                    throw core::ConfigException(fmt::format("Cannot create screen indicator '{}': {}", name, e.what()));
+                }
+                ColumnPlan plan{selected.spec, 0};
+                if (!selected.output.empty()) {
+                    while (plan.output < indicator->getOutputCount() && indicator->getOutputName(plan.output) != selected.output) {
+                        ++plan.output;
+                    }
+                    if (plan.output == indicator->getOutputCount()) {
+                        throw core::ConfigException(fmt::format("Indicator '{}' has no output '{}' (requested as '{}').",
+                                                                indicator->getName(), selected.output, name));
+                    }
+                }
+                plans.push_back(std::move(plan));
+            }
+            return plans;
+        }
+
+        // Bar-aligned values of every column (NaN during warm-up). Each indicator spec
+        // is calculated once, however many of its outputs the screen uses.
+        std::vector<std::vector<double>> calculateColumns(const std::vector<ColumnPlan>& plans, const core::CandleSeries& bars) {
+            std::vector<std::vector<double>> columns(plans.size(), std::vector<double>(bars.size(), strategy_engine::kMissingIndicatorValue));
+            std::map<std::string, std::unique_ptr<indicators::IIndicator>> calculated;
+            for (std::size_t c = 0; c < plans.size(); ++c) {
+                auto [it, inserted] = calculated.try_emplace(plans[c].spec);
+                if (inserted) {
+                    it->second = indicators::IndicatorRegistry::instance().create(plans[c].spec);
+                    if (bars.size() > static_cast<std::size_t>(it->second->getLookback())) it->second->calculate(bars);
+                }
+                const auto& output = it->second->getOutput(plans[c].output);
+                // Results start after the warm-up bars
+                const std::size_t offset = bars.size() > output.size() ? bars.size() - output.size() : 0;
+                for (std::size_t k = 0; k < output.size() && offset + k < bars.size(); ++k) columns[c][offset + k] = output[k];
+            }
+            return columns;
+        }
+
+        core::Timestamp fromNs(std::int64_t ns) {
+            return core::Timestamp(std::chrono::duration_cast<core::Timestamp::duration>(std::chrono::nanoseconds(ns)));
+        }
+
+    } // end anonymous namespace
+
+    ScreenerRun::ScreenerRun(data::ICandleSource& candle_source)
+        : candle_source_(candle_source)
+    {
+    }
+
+    ScreenRunResult ScreenerRun::run(const json& screen_config, const std::string& start_date, const std::string& end_date,
+                                     bool last_bar_only)
+    {
+        auto logger = core::logging::getLogger();
+        strategy_engine::ScreenSpec spec;
+        try {
+            spec = strategy_engine::ScreenSpec::fromJson(screen_config);
+        } catch (const std::invalid_argument& e) {
+            throw core::ConfigException(fmt::format("Invalid screen config: {}", e.what()));
+        }
+        const json resolved = Backtester::resolveUniverse(candle_source_, screen_config, start_date);
+        if (!resolved.contains("instruments") || !resolved["instruments"].is_array() || resolved["instruments"].empty()) {
+            throw core::ConfigException("Screen config needs 'instruments' or a 'universe' block.");
+        }
+        const auto universe = resolved["instruments"].get<std::vector<std::string>>();
+        const auto plans = planColumns(spec.indicatorNames());
+        const auto [query_start, query_end] = Backtester::queryRangeForDates(start_date, end_date);
+
+        // 1. Load candles and calculate indicators per instrument
+        ScreenRunResult result;
+        result.name = spec.name;
+        result.rank_by = spec.rank_by;
+        std::vector<core::CandleSeries> bars;
+        std::vector<std::vector<std::vector<double>>> values; // [instrument][column][bar]
+        for (const auto& key : universe) {
+            core::CandleSeries series = candle_source_.queryCandleSeries(key, spec.timeframe, query_start, query_end);
+            if (series.empty()) {
+                logger->warn("Screen '{}': no {} candles for {} in range; excluded.", spec.name, spec.timeframe, key);
+                result.excluded.push_back(key);
+                continue;
+            }
+            values.push_back(calculateColumns(plans, series));
+            bars.push_back(std::move(series));
+            result.instruments.push_back(key);
+        }
+        if (result.instruments.empty()) {
+            throw core::ConfigException(fmt::format("Screen '{}': no instrument has candles between {} and {}.",
+                                                    spec.name, start_date, end_date));
+        }
+
+        strategy_engine::Screener screener(spec, result.instruments);
+        std::vector<double> row_values(plans.size());
+        auto update = [&](std::size_t row, std::size_t bar) {
+            for (std::size_t c = 0; c < plans.size(); ++c) row_values[c] = values[row][c][bar];
+            screener.update(row, bars[row].at(bar), row_values);
+        };
+        auto snapshot = [&](std::int64_t time_ns) {
+            const auto& scan = screener.scan();
+            ScreenSnapshot snap;
+            snap.time = fromNs(time_ns);
+            snap.passed = scan.passed;
+            snap.hits.reserve(scan.hits.size());
+            for (const auto& hit : scan.hits) snap.hits.emplace_back(result.instruments[hit.row], hit.value);
+            result.snapshots.push_back(std::move(snap));
+        };
+
+        // 2. Replay every instrument's bars in time order, scanning once per bar time
+        if (last_bar_only) {
+            std::int64_t latest = 0;
+            for (std::size_t row = 0; row < bars.size(); ++row) {
+                update(row, bars[row].size() - 1);
+                latest = std::max(latest, bars[row].timestampsNs().back());
+            }
+            snapshot(latest);
+        } else {
+            std::vector<std::pair<std::int64_t, std::uint32_t>> events; // (bar time, row)
+            for (std::size_t row = 0; row < bars.size(); ++row) {
+                for (const std::int64_t ts : bars[row].timestampsNs()) events.emplace_back(ts, static_cast<std::uint32_t>(row));
+            }
+            std::sort(events.begin(), events.end());
+            std::vector<std::size_t> cursor(bars.size(), 0);
+            for (std::size_t i = 0; i < events.size();) {
+                const std::int64_t time_ns = events[i].first;
+                for (; i < events.size() && events[i].first == time_ns; ++i) {
+                    const std::size_t row = events[i].second;
+                    update(row, cursor[row]++);
+                }
+                snapshot(time_ns);
+            }
+        }
+        logger->info("Screen '{}': {} instruments ({} excluded), {} scans.", spec.name, result.instruments.size(),
+                     result.excluded.size(), result.snapshots.size());
+        return result;
+    }
+
+    void ScreenerRun::logResult(const ScreenRunResult& result, std::size_t max_snapshots) {
+        auto logger = core::logging::getLogger();
+        logger->info("--- Screen Results: {} ({} instruments) ---", result.name, result.instruments.size());
+        const std::size_t first = result.snapshots.size() > max_snapshots ? result.snapshots.size() - max_snapshots : 0;
+        for (std::size_t s = first; s < result.snapshots.size(); ++s) {
+            const auto& snap = result.snapshots[s];
+            logger->info("{}  {} passed, {} shown", core::utils::timestampToString(snap.time), snap.passed, snap.hits.size());
+            for (std::size_t rank = 0; rank < snap.hits.size(); ++rank) {
+                const auto& [key, value] = snap.hits[rank];
+                if (result.rank_by.empty()) {
+                    logger->info("  {:>3}. {}", rank + 1, key);
+                } else {
+                    logger->info("  {:>3}. {:<28} {} = {:.4f}", rank + 1, key, result.rank_by, value);
+                }
+            }
+        }
+        logger->info("------------------------");
+    }
+
+    bool ScreenerRun::writeCsv(const std::string& path, const ScreenRunResult& result) {
+        std::ofstream out(path);
+        if (!out.is_open()) {
+            core::logging::getLogger()->error("Failed to open screen output file: {}", path);
+            return false;
+        }
+        out << "timestamp,rank,instrument_key,value,passed\n";
+        for (const auto& snap : result.snapshots) {
+            const std::string time = core::utils::timestampToString(snap.time);
+            for (std::size_t rank = 0; rank < snap.hits.size(); ++rank) {
+                const auto& [key, value] = snap.hits[rank];
+                const std::string value_text = result.rank_by.empty() ? std::string() : fmt::format("{}", value);
+                out << time << fmt::format(",{},{},{},{}\n", rank + 1, key, value_text, snap.passed);
+            }
+        }
+        core::logging::getLogger()->info("Screen results written to {}", path);
+        return true;
+    }
+
+} // namespace backtester
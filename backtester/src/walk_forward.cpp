@@ -0,0 +1,284 @@
+#include "walk_forward.hpp"
+#include "work_stealing_pool.hpp"
+#include "thread_pool.hpp"
+#include "logging.hpp"
+#include "exceptions.hpp"
+#include "utils.hpp"
+#include "spdlog/fmt/bundled/core.h" // Use direct path for safety
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <future>
+
+namespace backtester {
+
+    namespace { // File-local helpers
+
+        std::string describeParameters(const ParameterSet& params) {
+            std::string out;
+            for (const auto& [name, value] : params) {
+                if (!out.empty()) out += ' ';
+                out += fmt::format("{}={}", name, value);
+            }
+            return out;
+        }
+
+        int positiveDays(const json& block, const char* key, int fallback) {
+            if (!block.contains(key)) {
+                if (fallback > 0) return fallback;
+                throw core::ConfigException(std::string("'walk_forward.") + key + "' is required.");
+            }
+            if (!block[key].is_number_integer() || block[key].get<int>() <= 0) {
+                throw core::ConfigException(std::string("'walk_forward.") + key + "' must be a positive integer.");
+            }
+            return block[key].get<int>();
+        }
+
+        // In-sample combinations of one window, finished by whichever run completes last
+        struct WindowProgress {
+            std::vector<SweepResult> in_sample;
+            std::atomic<std::size_t> remaining{0};
+            std::promise<void> done;
+        };
+
+    } // end anonymous namespace
+
+    WalkForward::WalkForward(data::ICandleSource& candle_source, double initial_capital, std::size_t num_threads)
+        : candle_source_(candle_source),
+          initial_capital_(initial_capital),
+          num_threads_(core::ThreadPool::resolveThreadCount(num_threads)),
+          data_cache_(std::make_shared<CandleDataCache>()),
+          indicator_cache_(std::make_shared<indicators::IndicatorCache>())
+    {
+        core::logging::getLogger()->debug("WalkForward created with {} worker threads.", num_threads_);
+    }
+
+    WalkForwardSpec WalkForward::parseSpec(const json& strategy_config) {
+        if (!strategy_config.is_object() || !strategy_config.contains("walk_forward") ||
+            !strategy_config["walk_forward"].is_object()) {
+            throw core::ConfigException("Strategy config has no 'walk_forward' object.");
+        }
+        const json& block = strategy_config["walk_forward"];
+        json without_block = strategy_config;
+        without_block.erase("walk_forward");
+
+        WalkForwardSpec spec;
+        spec.sweep = ParameterSweep::parseSpec(without_block); // Requires the "sweep" block
+        spec.in_sample_days = positiveDays(block, "in_sample_days", 0);
+        spec.out_of_sample_days = positiveDays(block, "out_of_sample_days", 0);
+        spec.step_days = positiveDays(block, "step_days", spec.out_of_sample_days);
+        return spec;
+    }
+
+    std::vector<WalkForwardWindow> WalkForward::planWindows(const WalkForwardSpec& spec,
+                                                            const std::string& start_date,
+                                                            const std::string& end_date)
+    {
+        const auto first = core::utils::parseDate(start_date);
+        const auto last = core::utils::parseDate(end_date);
+        const std::chrono::days in_sample{spec.in_sample_days};
+        const std::chrono::days out_of_sample{spec.out_of_sample_days};
+        const std::chrono::days one{1};
+
+        std::vector<WalkForwardWindow> windows;
+        for (auto start = first; start + in_sample <= last; start += std::chrono::days{spec.step_days}) {
+            const auto test_start = start + in_sample;
+            const auto test_end = std::min(test_start + out_of_sample - one, last); // Last window may be short
+            windows.push_back({core::utils::formatDate(start), core::utils::formatDate(test_start - one),
+                               core::utils::formatDate(test_start), core::utils::formatDate(test_end)});
+        }
+        return windows;
+    }
+
+    WalkForwardResult WalkForward::run(const WalkForwardSpec& spec, const std::string& start_date, const std::string& end_date) {
+        auto logger = core::logging::getLogger();
+        WalkForwardResult result;
+
+        const std::vector<WalkForwardWindow> windows = planWindows(spec, start_date, end_date);
+        const std::vector<ParameterSet> grid = ParameterSweep::expandGrid(spec.sweep);
+        logger->info("Walk-forward: {} windows ({}d in-sample / {}d out-of-sample, step {}d) x {} combinations on {} threads.",
+                     windows.size(), spec.in_sample_days, spec.out_of_sample_days, spec.step_days, grid.size(), num_threads_);
+        if (windows.empty() || grid.empty()) {
+            logger->warn("Walk-forward has nothing to run (range shorter than one in-sample window, or empty grid).");
+            return result;
+        }
+
+        if (!candle_source_.isConnected() && !candle_source_.connect()) {
+            throw core::DataLoadException("Failed to connect to DB for walk-forward analysis.");
+        }
+
+        core::WorkStealingPool pool(num_threads_);
+
+        // Load the candles of the whole range once; every run below reads them from the cache
+        const json strategy_template = Backtester::resolveUniverse(candle_source_, spec.sweep.strategy_template, start_date);
+        const json first_config = ParameterSweep::instantiate(strategy_template, grid.front());
+        if (first_config.contains("instruments") && first_config["instruments"].is_array() &&
+            first_config.contains("timeframes") && first_config["timeframes"].is_array() && !first_config["timeframes"].empty()) {
+            const std::string timeframe = first_config["timeframes"][0].get<std::string>();
+            auto [start_ts, end_ts] = Backtester::queryRangeForDates(start_date, end_date);
+            auto preload = [&, start_ts = start_ts, end_ts = end_ts](const std::string& instrument) {
+                const double tick_size = data_cache_->compactStorage() ? candle_source_.queryTickSize(instrument).value_or(0.0) : 0.0;
+                auto series = data_cache_->getOrLoad(instrument, timeframe, start_ts, end_ts, [&]() {
+                    return candle_source_.queryCandleSeries(instrument, timeframe, start_ts, end_ts);
+                }, tick_size);
+                logger->info("Walk-forward data preloaded: {} candles for {} ({}).", series->size(), instrument, timeframe);
+            };
+            std::vector<std::future<void>> loads;
+            for (const auto& entry : first_config["instruments"]) {
+                if (!entry.is_string()) continue; // Rejected later by the strategy factory
+                std::string instrument = entry.get<std::string>();
+                if (candle_source_.supportsConcurrentQueries()) {
+                    loads.push_back(pool.submit([&preload, instrument]() { preload(instrument); }));
+                } else {
+                    preload(instrument);
+                }
+            }
+            for (auto& f : loads) f.wait(); // Let every load finish before rethrowing
+            for (auto& f : loads) f.get();
+        }
+
+        // One run of 'config' trading only [from, to] of the loaded range
+        auto backtest = [&](const json& config, const std::string& from, const std::string& to, Backtester& backtester) {
+            backtester.setDataCache(data_cache_);
+            backtester.setIndicatorCache(indicator_cache_);
+            backtester.setEvaluationMode(evaluation_mode_);
+            const auto range = Backtester::queryRangeForDates(from, to);
+            backtester.setEvaluationRange(range.first, range.second);
+            return backtester.run(config, start_date, end_date);
+        };
+
+        result.windows.resize(windows.size());
+        std::vector<WindowProgress> progress(windows.size());
+        std::vector<std::future<void>> finished;
+        finished.reserve(windows.size());
+        for (std::size_t w = 0; w < windows.size(); ++w) {
+            result.windows[w].window = windows[w];
+            progress[w].in_sample.resize(grid.size());
+            progress[w].remaining.store(grid.size());
+            finished.push_back(progress[w].done.get_future());
+        }
+
+        // Out-of-sample run of window 'w' with its in-sample winner (always fulfils 'done')
+        auto testWindow = [&](std::size_t w) {
+            WalkForwardWindowResult& window_result = result.windows[w];
+            try {
+                Backtester backtester(candle_source_, initial_capital_);
+                const json config = ParameterSweep::instantiate(strategy_template, window_result.best_parameters);
+                window_result.success = backtest(config, windows[w].out_of_sample_start, windows[w].out_of_sample_end, backtester);
+                window_result.out_of_sample = backtester.getMetrics();
+                const auto& equity = backtester.getPortfolio().getEquityCurve(); // Lives in the run's arena
+                window_result.out_of_sample_equity.assign(equity.begin(), equity.end());
+            } catch (const std::exception& e) {
+                logger->error("Walk-forward window {} out-of-sample run failed: {}", w + 1, e.what());
+                window_result.success = false;
+            }
+            progress[w].done.set_value();
+        };
+
+        // Picks the window's winner once its last in-sample run is in
+        auto finishInSample = [&](std::size_t w) {
+            WindowProgress& state = progress[w];
+            WalkForwardWindowResult& window_result = result.windows[w];
+            ParameterSweep::rankResults(state.in_sample, spec.sweep.rank_by);
+            window_result.combinations_run = state.in_sample.size();
+            if (state.in_sample.empty() || !state.in_sample.front().success) {
+                logger->error("Walk-forward window {} ({}..{}): no successful in-sample run.",
+                              w + 1, windows[w].in_sample_start, windows[w].in_sample_end);
+                state.done.set_value();
+                return;
+            }
+            window_result.best_parameters = state.in_sample.front().parameters;
+            window_result.in_sample = state.in_sample.front().metrics;
+            state.in_sample.clear();
+            pool.submit([&testWindow, w]() { testWindow(w); }); // Follow-up on this worker's own deque
+        };
+
+        for (std::size_t w = 0; w < windows.size(); ++w) {
+            for (std::size_t c = 0; c < grid.size(); ++c) {
+                pool.submit([&, w, c]() {
+                    SweepResult& run_result = progress[w].in_sample[c];
+                    run_result.parameters = grid[c];
+                    try {
+                        Backtester backtester(candle_source_, initial_capital_);
+                        if (spec.sweep.stop.any()) backtester.setStopCriteria(spec.sweep.stop);
+                        run_result.success = backtest(ParameterSweep::instantiate(strategy_template, grid[c]),
+                                                      windows[w].in_sample_start, windows[w].in_sample_end, backtester);
+                        run_result.metrics = backtester.getMetrics();
+                    } catch (const std::exception& e) {
+                        logger->error("Walk-forward window {} combination [{}] failed: {}", w + 1, describeParameters(grid[c]), e.what());
+                        run_result.success = false;
+                    }
+                    if (progress[w].remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) finishInSample(w);
+                });
+            }
+        }
+        for (auto& f : finished) f.wait();
+
+        // --- Stitch the out-of-sample curves ---
+        double equity = initial_capital_;
+        double peak = initial_capital_;
+        for (const auto& window_result : result.windows) {
+            if (!window_result.success) {
+                logger->warn("Walk-forward window {}..{} has no out-of-sample result; the stitched curve skips it.",
+                             window_result.window.out_of_sample_start, window_result.window.out_of_sample_end);
+                continue;
+            }
+            const double scale = equity / initial_capital_;
+            for (const auto& point : window_result.out_of_sample_equity) {
+                PortfolioState scaled = point;
+                scaled.cash *= scale;
+                scaled.positions_value *= scale;
+                scaled.total_equity *= scale;
+                result.stitched_equity.push_back(scaled);
+                peak = std::max(peak, scaled.total_equity);
+                if (peak > 1e-9) result.max_drawdown_pct = std::max(result.max_drawdown_pct, (peak - scaled.total_equity) / peak);
+            }
+            if (!result.stitched_equity.empty()) equity = result.stitched_equity.back().total_equity;
+        }
+        result.total_return_pct = (initial_capital_ > 1e-9) ? equity / initial_capital_ - 1.0 : 0.0;
+        logger->info("Walk-forward computed {} distinct indicator series.", indicator_cache_ ? indicator_cache_->size() : 0);
+        return result;
+    }
+
+    void WalkForward::logResults(const WalkForwardResult& result, const WalkForwardSpec& spec) {
+        auto logger = core::logging::getLogger();
+        logger->info("--- Walk-Forward Results ({} windows, optimized for {}) ---", result.windows.size(), spec.sweep.rank_by);
+        logger->info("{:>3}  {:<23} {:<23} {:<28} {:>9} {:>9} {:>8} {:>7}",
+                     "#", "In-sample", "Out-of-sample", "Parameters", "IS Ret%", "OOS Ret%", "OOS DD%", "Trades");
+        for (std::size_t i = 0; i < result.windows.size(); ++i) {
+            const auto& r = result.windows[i];
+            const std::string in_range = r.window.in_sample_start + ".." + r.window.in_sample_end;
+            const std::string out_range = r.window.out_of_sample_start + ".." + r.window.out_of_sample_end;
+            if (!r.success) {
+                logger->info("{:>3}  {:<23} {:<23} {:<28} {:>9}", i + 1, in_range, out_range,
+                             describeParameters(r.best_parameters), "FAILED");
+                continue;
+            }
+            logger->info("{:>3}  {:<23} {:<23} {:<28} {:>9.2f} {:>9.2f} {:>8.2f} {:>7}", i + 1, in_range, out_range,
+                         describeParameters(r.best_parameters), r.in_sample.total_return_pct * 100.0,
+                         r.out_of_sample.total_return_pct * 100.0, r.out_of_sample.max_drawdown_pct * 100.0,
+                         r.out_of_sample.round_trip_trades);
+        }
+        logger->info("Stitched out-of-sample: return {:.2f}%, max drawdown {:.2f}%, {} equity points",
+                     result.total_return_pct * 100.0, result.max_drawdown_pct * 100.0, result.stitched_equity.size());
+        logger->info("------------------------");
+    }
+
+    bool WalkForward::writeEquityCsv(const std::string& path, const WalkForwardResult& result) {
+        std::ofstream out(path);
+        if (!out.is_open()) {
+            core::logging::getLogger()->error("Failed to open walk-forward output file: {}", path);
+            return false;
+        }
+        out << "timestamp,cash,positions_value,total_equity\n";
+        for (const auto& point : result.stitched_equity) {
+            out << core::utils::timestampToString(point.timestamp)
+                << fmt::format(",{},{},{}\n", point.cash, point.positions_value, point.total_equity);
+        }
+        core::logging::getLogger()->info("Walk-forward equity curve written to {}", path);
+        return true;
+    }
+
+} // namespace backtester
@@ -0,0 +1,45 @@
+// End-to-end Backtester::run() for one instrument of 10k / 1M / 10M synthetic bars.
+//
+//   BM_BacktestRun_PerBar      - EvaluationMode::PerBar
+//   BM_BacktestRun_Vectorized  - EvaluationMode::Vectorized
+//
+// Bars come from an InMemoryCandleSource, so loadData() is a slice of a prebuilt
+// series and the time is strategy setup, indicators, the event loop (including
+// Portfolio and its trade logging) and metrics. Storage cost is in storage_benchmark.
+
+#include "backtester.hpp"
+#include "synthetic_data.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+
+namespace {
+
+void runBacktest(benchmark::State& state, backtester::EvaluationMode mode) {
+    const auto bars = static_cast<std::size_t>(state.range(0));
+    const auto instruments = benchmarks::syntheticInstruments(1);
+    benchmarks::InMemoryCandleSource source;
+    source.add(instruments.front(), benchmarks::syntheticSeries(bars));
+    const auto config = benchmarks::smaCrossConfig(instruments);
+
+    backtester::Backtester backtester(source, 1e9);
+    backtester.setEvaluationMode(mode);
+    for (auto _ : state) {
+        if (!backtester.run(config, benchmarks::kSyntheticStartDate, benchmarks::kSyntheticEndDate)) {
+            state.SkipWithError("Backtester::run failed");
+            break;
+        }
+        benchmark::DoNotOptimize(backtester.getMetrics().total_pnl);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * bars));
+    state.counters["executions"] = backtester.getMetrics().total_executions;
+}
+
+void BM_BacktestRun_PerBar(benchmark::State& state) { runBacktest(state, backtester::EvaluationMode::PerBar); }
+BENCHMARK(BM_BacktestRun_PerBar)->Apply(benchmarks::applyBarCounts)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+void BM_BacktestRun_Vectorized(benchmark::State& state) { runBacktest(state, backtester::EvaluationMode::Vectorized); }
+BENCHMARK(BM_BacktestRun_Vectorized)->Apply(benchmarks::applyBarCounts)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+} // namespace
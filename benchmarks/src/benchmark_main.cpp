@@ -0,0 +1,32 @@
+#include "logging.hpp"
+
+#include <benchmark/benchmark.h>
+
+#ifndef TP_BENCHMARK_GIT_COMMIT
+#define TP_BENCHMARK_GIT_COMMIT "unknown"
+#endif
+#ifndef TP_BENCHMARK_BUILD_TYPE
+#define TP_BENCHMARK_BUILD_TYPE "unknown"
+#endif
+
+// Shared main for all tp_benchmarks: the platform code logs through
+// core::logging, so the logger has to exist before any benchmark runs.
+// The file sink sits at 'info', like a normal CLI run, so trace and debug
+// statements are disabled at runtime and per-trade info lines cost what they
+// cost in a backtest. The console only shows warnings, keeping the report readable.
+//
+// The commit and build type are added to the report context, so JSON results
+// (--benchmark_out=<file> --benchmark_out_format=json, or the 'benchmark_json'
+// target) can be compared across commits.
+int main(int argc, char** argv) {
+    core::logging::initialize("tp_benchmarks", spdlog::level::warn, spdlog::level::info);
+
+    benchmark::AddCustomContext("git_commit", TP_BENCHMARK_GIT_COMMIT);
+    benchmark::AddCustomContext("build_type", TP_BENCHMARK_BUILD_TYPE);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
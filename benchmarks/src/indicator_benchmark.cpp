@@ -0,0 +1,78 @@
+// IIndicator::calculate() over a whole 10k / 1M / 10M bar series.
+//
+//   BM_SmaCalculate/<period>/<bars>
+//   BM_RsiCalculate/<period>/<bars>
+//   BM_EmaCalculate/<period>/<bars>, BM_WmaCalculate, BM_AtrCalculate, BM_AdxCalculate
+//   BM_BbandsCalculate/<period>/<bars>      (2 deviations; all three bands)
+//   BM_MacdCalculate/<period>/<bars>        (period = slow; fast = period / 2, signal 9)
+//   BM_SupertrendCalculate/<period>/<bars>  (multiplier 3; band, direction and ATR)
+//
+// Items/s is input bars. The result buffer is reallocated by every calculate()
+// call, as it is in a backtest run without an IndicatorCache.
+
+#include "sma_indicator.hpp"
+#include "rsi_indicator.hpp"
+#include "native_indicators.hpp"
+#include "synthetic_data.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+
+namespace {
+
+void applyPeriodsAndBarCounts(benchmark::internal::Benchmark* benchmark) {
+    for (const int period : {20, 200}) {
+        for (const int bars : {10'000, 1'000'000, 10'000'000}) benchmark->Args({period, bars});
+    }
+    benchmark->ArgNames({"period", "bars"})->Unit(benchmark::kMicrosecond);
+}
+
+template <typename Indicator, typename... Extra>
+void calculateIndicator(benchmark::State& state, Extra... extra) {
+    const auto series = benchmarks::syntheticSeries(static_cast<std::size_t>(state.range(1)));
+    Indicator indicator(static_cast<int>(state.range(0)), extra...);
+    for (auto _ : state) {
+        indicator.calculate(*series);
+        benchmark::DoNotOptimize(indicator.getResult().data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * series->size()));
+}
+
+void BM_SmaCalculate(benchmark::State& state) { calculateIndicator<indicators::SmaIndicator>(state); }
+BENCHMARK(BM_SmaCalculate)->Apply(applyPeriodsAndBarCounts);
+
+void BM_RsiCalculate(benchmark::State& state) { calculateIndicator<indicators::RsiIndicator>(state); }
+BENCHMARK(BM_RsiCalculate)->Apply(applyPeriodsAndBarCounts);
+
+void BM_EmaCalculate(benchmark::State& state) { calculateIndicator<indicators::EmaIndicator>(state); }
+BENCHMARK(BM_EmaCalculate)->Apply(applyPeriodsAndBarCounts);
+
+void BM_WmaCalculate(benchmark::State& state) { calculateIndicator<indicators::WmaIndicator>(state); }
+BENCHMARK(BM_WmaCalculate)->Apply(applyPeriodsAndBarCounts);
+
+void BM_BbandsCalculate(benchmark::State& state) { calculateIndicator<indicators::BollingerBandsIndicator>(state, 2.0); }
+BENCHMARK(BM_BbandsCalculate)->Apply(applyPeriodsAndBarCounts);
+
+void BM_AtrCalculate(benchmark::State& state) { calculateIndicator<indicators::AtrIndicator>(state); }
+BENCHMARK(BM_AtrCalculate)->Apply(applyPeriodsAndBarCounts);
+
+void BM_AdxCalculate(benchmark::State& state) { calculateIndicator<indicators::AdxIndicator>(state); }
+BENCHMARK(BM_AdxCalculate)->Apply(applyPeriodsAndBarCounts);
+
+void BM_SupertrendCalculate(benchmark::State& state) { calculateIndicator<indicators::SupertrendIndicator>(state, 3.0); }
+BENCHMARK(BM_SupertrendCalculate)->Apply(applyPeriodsAndBarCounts);
+
+void BM_MacdCalculate(benchmark::State& state) {
+    const auto series = benchmarks::syntheticSeries(static_cast<std::size_t>(state.range(1)));
+    const int slow = static_cast<int>(state.range(0));
+    indicators::MacdIndicator indicator(slow / 2, slow, 9);
+    for (auto _ : state) {
+        indicator.calculate(*series);
+        benchmark::DoNotOptimize(indicator.getOutput(2).data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * series->size()));
+}
+BENCHMARK(BM_MacdCalculate)->Apply(applyPeriodsAndBarCounts);
+
+} // namespace
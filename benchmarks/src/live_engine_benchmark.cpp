@@ -0,0 +1,61 @@
+// Live signal path.
+//
+//   BM_SpscQueueRoundTrip  - push then pop of one bar event on the same thread
+//                            (the uncontended cost of the ring buffer itself)
+//   BM_LiveEngineThroughput - SMA crossover on one instrument: publish kBatch bars from
+//                            the benchmark thread and wait for the worker to finish them;
+//                            reports the engine's tick-to-signal percentiles as counters
+
+#include "live_signal_engine.hpp"
+#include "spsc_queue.hpp"
+#include "synthetic_data.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <thread>
+
+namespace {
+
+constexpr std::size_t kBatch = 100'000;
+
+void BM_SpscQueueRoundTrip(benchmark::State& state) {
+    core::SpscQueue<live::MarketDataEvent> queue(1024);
+    const auto bars = benchmarks::syntheticSeries(1);
+    live::MarketDataEvent event;
+    event.bar = bars->at(0);
+    live::MarketDataEvent out;
+    for (auto _ : state) {
+        queue.tryPush(event);
+        queue.tryPop(out);
+        benchmark::DoNotOptimize(out.bar.close);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SpscQueueRoundTrip);
+
+void BM_LiveEngineThroughput(benchmark::State& state) {
+    const auto bars = benchmarks::syntheticSeries(kBatch);
+    const auto config = benchmarks::smaCrossConfig(benchmarks::syntheticInstruments(1));
+    live::LiveEngineOptions options;
+    options.input_capacity = kBatch; // Never drops, so every bar is measured
+    options.output_capacity = kBatch;
+
+    live::LiveEngineStats last;
+    for (auto _ : state) {
+        live::LiveSignalEngine engine(config, options);
+        engine.start();
+        for (std::size_t i = 0; i < kBatch; ++i) engine.publish(0, bars->at(i));
+        engine.stop();
+        live::LiveSignal signal;
+        while (engine.pollSignal(signal)) benchmark::DoNotOptimize(signal.price);
+        last = engine.stats();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kBatch));
+    state.counters["p50_us"] = static_cast<double>(last.tick_to_signal.percentile(50.0)) / 1e3;
+    state.counters["p99_us"] = static_cast<double>(last.tick_to_signal.percentile(99.0)) / 1e3;
+    state.counters["eval_p99_us"] = static_cast<double>(last.evaluation.percentile(99.0)) / 1e3;
+}
+BENCHMARK(BM_LiveEngineThroughput)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+} // namespace
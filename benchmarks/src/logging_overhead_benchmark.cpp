@@ -0,0 +1,131 @@
+// Per-bar cost of hot-path logging with trace disabled at runtime.
+//
+//   BM_PerBarLogging_Baseline   - loop body without any logging
+//   BM_PerBarLogging_Eager      - logger->trace(...) as the event loop used to do it:
+//                                 getLogger() copy + timestampToString() every bar
+//   BM_PerBarLogging_Macro      - TP_LOG_TRACE(...): one level check, arguments untouched
+//   BM_StrategyEvaluatePerBar   - Strategy::evaluate() per bar, built with the
+//                                 module's TP_HOT_PATH_LOG_LEVEL floor
+//
+// Compiled-out statements (below TP_LOG_ACTIVE_LEVEL) cost the same as the baseline.
+
+#include "logging.hpp"
+#include "utils.hpp"
+#include "datatypes.hpp"
+#include "interfaces.hpp"
+#include "strategy_factory.hpp"
+
+#include <benchmark/benchmark.h>
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kBars = 4096;
+
+std::vector<core::Candle> makeBars(std::size_t count) {
+    std::vector<core::Candle> bars(count);
+    core::Timestamp ts = core::utils::stringToTimestamp("2024-01-01T09:15:00+05:30");
+    for (std::size_t i = 0; i < count; ++i) {
+        const double price = 100.0 + 10.0 * std::sin(static_cast<double>(i) * 0.05);
+        bars[i].timestamp = ts + std::chrono::minutes(i);
+        bars[i].open = price;
+        bars[i].high = price + 0.5;
+        bars[i].low = price - 0.5;
+        bars[i].close = price + 0.1;
+        bars[i].volume = 1000;
+    }
+    return bars;
+}
+
+void BM_PerBarLogging_Baseline(benchmark::State& state) {
+    const auto bars = makeBars(kBars);
+    for (auto _ : state) {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < bars.size(); ++i) {
+            sum += bars[i].close;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * bars.size()));
+}
+BENCHMARK(BM_PerBarLogging_Baseline);
+
+void BM_PerBarLogging_Eager(benchmark::State& state) {
+    const auto bars = makeBars(kBars);
+    for (auto _ : state) {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < bars.size(); ++i) {
+            auto logger = core::logging::getLogger();
+            logger->trace("--- Snapshot for Bar Index: {}, Time: {} ---", i,
+                          core::utils::timestampToString(bars[i].timestamp));
+            sum += bars[i].close;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * bars.size()));
+}
+BENCHMARK(BM_PerBarLogging_Eager);
+
+void BM_PerBarLogging_Macro(benchmark::State& state) {
+    const auto bars = makeBars(kBars);
+    for (auto _ : state) {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < bars.size(); ++i) {
+            TP_LOG_TRACE("--- Snapshot for Bar Index: {}, Time: {} ---", i,
+                         core::utils::timestampToString(bars[i].timestamp));
+            sum += bars[i].close;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * bars.size()));
+}
+BENCHMARK(BM_PerBarLogging_Macro);
+
+void BM_StrategyEvaluatePerBar(benchmark::State& state) {
+    const nlohmann::json config = nlohmann::json::parse(R"json({
+        "strategy_name": "BenchCross",
+        "instruments": ["NSE_EQ|BENCH"],
+        "timeframes": ["1minute"],
+        "position_sizing": {"method": "Quantity", "value": 1},
+        "indicators": [{"name": "SMA(10)"}, {"name": "SMA(20)"}],
+        "entry_rules": [{"rule_name": "Enter", "action": "EnterLong",
+            "condition": {"type": "AND", "conditions": [
+                {"type": "CrossesAbove", "indicator1": "SMA(10)", "indicator2": "SMA(20)"},
+                {"type": "PriceIndicator", "price_field": "Close", "op": ">", "indicator": "SMA(20)"}]}}],
+        "exit_rules": [{"rule_name": "Exit", "action": "ExitLong",
+            "condition": {"type": "CrossesBelow", "indicator1": "SMA(10)", "indicator2": "SMA(20)"}}]
+    })json");
+    auto strategy = strategy_engine::StrategyFactory::createStrategy(config);
+    if (!strategy) {
+        state.SkipWithError("Failed to create benchmark strategy");
+        return;
+    }
+
+    const auto bars = makeBars(kBars);
+    std::vector<double> current(2), previous(2);
+    strategy_engine::MarketDataSnapshot snapshot;
+    snapshot.indicator_values = current;
+    snapshot.indicator_values_prev = previous;
+
+    for (auto _ : state) {
+        for (std::size_t i = 1; i < bars.size(); ++i) {
+            // Synthetic fast/slow values that cross regularly
+            previous = current;
+            current[0] = bars[i].close;
+            current[1] = 100.0;
+            snapshot.current_time = bars[i].timestamp;
+            snapshot.current_candle = &bars[i];
+            snapshot.previous_candle = &bars[i - 1];
+            benchmark::DoNotOptimize(strategy->evaluate(snapshot));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * (bars.size() - 1)));
+}
+BENCHMARK(BM_StrategyEvaluatePerBar);
+
+} // namespace
@@ -0,0 +1,92 @@
+// Portfolio bookkeeping per execution and per bar.
+//
+//   BM_PortfolioRecordTrade           - alternating entry/exit executions on one instrument
+//                                       (every second call closes a round trip)
+//   BM_PortfolioRecordTimestampValue  - one equity point per bar with <instruments> open
+//                                       positions priced from a std::map<std::string, double>
+//   BM_PortfolioRecordTimestampValue_Dense
+//                                     - the same through InstrumentIds and a flat price array
+//                                       with the curve reserved, as the event loop does it
+//
+// A fresh Portfolio is used per batch of kBatch calls, so the equity curve and
+// trade log grow as they would during a run instead of without bound.
+
+#include "portfolio.hpp"
+#include "synthetic_data.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kBatch = 10'000;
+
+void BM_PortfolioRecordTrade(benchmark::State& state) {
+    const auto bars = benchmarks::syntheticSeries(kBatch);
+    const std::string instrument = "NSE_EQ|BENCH0";
+    for (auto _ : state) {
+        backtester::Portfolio portfolio(1e9);
+        for (std::size_t i = 0; i < kBatch; ++i) {
+            const auto action = (i % 2 == 0) ? core::SignalAction::EnterLong : core::SignalAction::ExitLong;
+            portfolio.recordTrade(bars->timestamp(i), instrument, action, 10, bars->close()[i], 20.0);
+        }
+        benchmark::DoNotOptimize(portfolio.getTradeLog().data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * kBatch));
+}
+BENCHMARK(BM_PortfolioRecordTrade)->Unit(benchmark::kMicrosecond);
+
+void BM_PortfolioRecordTimestampValue(benchmark::State& state) {
+    const auto bars = benchmarks::syntheticSeries(kBatch);
+    const auto instruments = benchmarks::syntheticInstruments(static_cast<std::size_t>(state.range(0)));
+    std::map<std::string, double> prices;
+    for (const auto& key : instruments) prices[key] = bars->close()[0];
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        backtester::Portfolio portfolio(1e9);
+        for (const auto& key : instruments) {
+            portfolio.recordTrade(bars->timestamp(0), key, core::SignalAction::EnterLong, 10, prices[key], 0.0);
+        }
+        state.ResumeTiming();
+        for (std::size_t i = 1; i < kBatch; ++i) {
+            prices[instruments[i % instruments.size()]] = bars->close()[i];
+            portfolio.recordTimestampValue(bars->timestamp(i), prices);
+        }
+        benchmark::DoNotOptimize(portfolio.getEquityCurve().data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * (kBatch - 1)));
+}
+BENCHMARK(BM_PortfolioRecordTimestampValue)->ArgName("instruments")->Arg(1)->Arg(50)->Unit(benchmark::kMicrosecond);
+
+void BM_PortfolioRecordTimestampValue_Dense(benchmark::State& state) {
+    const auto bars = benchmarks::syntheticSeries(kBatch);
+    const auto instruments = benchmarks::syntheticInstruments(static_cast<std::size_t>(state.range(0)));
+    std::vector<double> prices(instruments.size(), bars->close()[0]);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        backtester::Portfolio portfolio(1e9);
+        for (const auto& key : instruments) {
+            const auto id = portfolio.addInstrument(key);
+            portfolio.recordTrade(bars->timestamp(0), id, core::SignalAction::EnterLong, 10, prices[id], 0.0);
+        }
+        portfolio.reserveEquityCurve(kBatch);
+        state.ResumeTiming();
+        for (std::size_t i = 1; i < kBatch; ++i) {
+            prices[i % prices.size()] = bars->close()[i];
+            portfolio.recordTimestampValue(bars->timestamp(i), std::span<const double>(prices));
+        }
+        benchmark::DoNotOptimize(portfolio.getEquityCurve().data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * (kBatch - 1)));
+}
+BENCHMARK(BM_PortfolioRecordTimestampValue_Dense)->ArgName("instruments")->Arg(1)->Arg(50)->Unit(benchmark::kMicrosecond);
+
+} // namespace
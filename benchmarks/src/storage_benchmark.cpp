@@ -0,0 +1,180 @@
+// Reading N rows of one series back from SQLite.
+//
+//   BM_QueryCandles       - DatabaseManager::queryCandles() (AoS candles)
+//   BM_QueryCandleSeries  - DatabaseManager::queryCandleSeries() (columns, what the backtester uses)
+//   BM_CompactEncode      - CompactCandleSeries::encode() of a 0.05-tick series (bytes/bar as a counter)
+//   BM_CompactDecode      - CompactCandleSeries::decode() back to columns (cache hit without a live copy)
+//
+// Each size gets its own database file in the temp directory, written once per
+// process (not timed) and removed at exit. Sizes stop at 1M rows: a 10M-row file
+// costs about a minute and ~1 GB of temp disk to set up on every run.
+
+#include "compact_candle_series.hpp"
+#include "database_manager.hpp"
+#include "synthetic_data.hpp"
+#include "utils.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstddef>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace {
+
+const std::string kInstrument = "NSE_EQ|BENCH0";
+
+// Databases by row count, deleted when the process exits
+class BenchmarkDatabases {
+public:
+    ~BenchmarkDatabases() {
+        for (auto& [rows, db] : databases_) {
+            db->disconnect();
+            std::error_code ec;
+            for (const char* suffix : {"", "-wal", "-shm"}) {
+                std::filesystem::remove(pathFor(rows).string() + suffix, ec);
+            }
+        }
+    }
+
+    // Connected database holding 'rows' synthetic bars, or nullptr on failure
+    data::DatabaseManager* get(std::size_t rows) {
+        auto& db = databases_[rows];
+        if (db) return db.get();
+
+        const auto path = pathFor(rows);
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+        auto created = std::make_unique<data::DatabaseManager>(path.string());
+        if (!created->connect() || !created->initializeSchema() ||
+            !created->saveCandles(benchmarks::syntheticCandles(rows), kInstrument, benchmarks::kSyntheticInterval)) {
+            databases_.erase(rows);
+            return nullptr;
+        }
+        db = std::move(created);
+        return db.get();
+    }
+
+private:
+    static std::filesystem::path pathFor(std::size_t rows) {
+        return std::filesystem::temp_directory_path() / ("tp_benchmark_candles_" + std::to_string(rows) + ".db");
+    }
+
+    std::map<std::size_t, std::unique_ptr<data::DatabaseManager>> databases_;
+};
+
+BenchmarkDatabases& databases() {
+    static BenchmarkDatabases instance;
+    return instance;
+}
+
+std::pair<core::Timestamp, core::Timestamp> fullRange() {
+    return {core::utils::stringToTimestamp(benchmarks::kSyntheticStartDate + "T00:00:00+05:30"),
+            core::utils::stringToTimestamp(benchmarks::kSyntheticEndDate + "T23:59:59+05:30")};
+}
+
+void applyRowCounts(benchmark::internal::Benchmark* benchmark) {
+    benchmark->Arg(10'000)->Arg(100'000)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+}
+
+void BM_QueryCandles(benchmark::State& state) {
+    const auto rows = static_cast<std::size_t>(state.range(0));
+    auto* db = databases().get(rows);
+    if (!db) {
+        state.SkipWithError("Failed to create benchmark database");
+        return;
+    }
+    const auto [start, end] = fullRange();
+    for (auto _ : state) {
+        auto candles = db->queryCandles(kInstrument, benchmarks::kSyntheticInterval, start, end);
+        if (candles.size() != rows) {
+            state.SkipWithError("Unexpected row count");
+            break;
+        }
+        benchmark::DoNotOptimize(candles.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * rows));
+}
+BENCHMARK(BM_QueryCandles)->Apply(applyRowCounts);
+
+void BM_QueryCandleSeries(benchmark::State& state) {
+    const auto rows = static_cast<std::size_t>(state.range(0));
+    auto* db = databases().get(rows);
+    if (!db) {
+        state.SkipWithError("Failed to create benchmark database");
+        return;
+    }
+    const auto [start, end] = fullRange();
+    for (auto _ : state) {
+        auto series = db->queryCandleSeries(kInstrument, benchmarks::kSyntheticInterval, start, end);
+        if (series.size() != rows) {
+            state.SkipWithError("Unexpected row count");
+            break;
+        }
+        benchmark::DoNotOptimize(series.close().data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * rows));
+}
+BENCHMARK(BM_QueryCandleSeries)->Apply(applyRowCounts);
+
+// Synthetic bars with prices on a 0.05 tick and whole volumes, like exchange data
+std::shared_ptr<const core::CandleSeries> tickAlignedSeries(std::size_t rows) {
+    struct Columns {
+        std::vector<std::int64_t> timestamps_ns;
+        std::vector<double> open, high, low, close, volume;
+    };
+    const auto source = benchmarks::syntheticSeries(rows);
+    auto columns = std::make_shared<Columns>();
+    auto onTick = [](double price) { return std::round(price * 20.0) / 20.0; };
+    columns->timestamps_ns.assign(source->timestampsNs().begin(), source->timestampsNs().end());
+    for (std::size_t i = 0; i < rows; ++i) {
+        columns->open.push_back(onTick(source->open()[i]));
+        columns->high.push_back(onTick(source->high()[i]));
+        columns->low.push_back(onTick(source->low()[i]));
+        columns->close.push_back(onTick(source->close()[i]));
+        columns->volume.push_back(std::round(source->volume()[i]));
+    }
+    return std::make_shared<const core::CandleSeries>(columns, columns->timestamps_ns, columns->open, columns->high,
+                                                      columns->low, columns->close, columns->volume);
+}
+
+void BM_CompactEncode(benchmark::State& state) {
+    const auto rows = static_cast<std::size_t>(state.range(0));
+    const auto series = tickAlignedSeries(rows);
+    std::size_t bytes = 0;
+    for (auto _ : state) {
+        auto compact = core::CompactCandleSeries::encode(*series, 0.05);
+        if (!compact) {
+            state.SkipWithError("Series did not encode");
+            break;
+        }
+        bytes = compact->memoryBytes();
+        benchmark::DoNotOptimize(bytes);
+    }
+    state.counters["bytes_per_bar"] = static_cast<double>(bytes) / static_cast<double>(rows);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * rows));
+}
+BENCHMARK(BM_CompactEncode)->Apply(applyRowCounts);
+
+void BM_CompactDecode(benchmark::State& state) {
+    const auto rows = static_cast<std::size_t>(state.range(0));
+    const auto compact = core::CompactCandleSeries::encode(*tickAlignedSeries(rows), 0.05);
+    if (!compact) {
+        state.SkipWithError("Series did not encode");
+        return;
+    }
+    for (auto _ : state) {
+        auto series = compact->decode();
+        benchmark::DoNotOptimize(series.close().data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * rows));
+}
+BENCHMARK(BM_CompactDecode)->Apply(applyRowCounts);
+
+} // namespace
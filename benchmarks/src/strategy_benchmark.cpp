@@ -0,0 +1,171 @@
+// Strategy construction and evaluation on the SMA(10)/SMA(20) crossover config.
+//
+//   BM_CreateStrategy             - StrategyFactory::createStrategy() from parsed JSON
+//                                   (a StrategyCache hit after the first iteration)
+//   BM_ParseStrategy              - StrategyFactory::parseStrategy(), the uncached JSON walk
+//   BM_CreateStrategyArena        - the same into a core::Arena released every iteration,
+//                                   as Backtester::run() does
+//   BM_StrategyEvaluate           - Strategy::evaluate() once per bar, snapshots built
+//                                   from real SMA columns the way the event loop does
+//   BM_StrategyGenerateSignals    - Strategy::generateSignals() over the whole series
+//
+// Indicators are calculated before timing starts; only evaluation is measured.
+
+#include "interfaces.hpp"
+#include "strategy_factory.hpp"
+#include "sma_indicator.hpp"
+#include "synthetic_data.hpp"
+#include "arena.hpp"
+
+#include <benchmark/benchmark.h>
+#include <nlohmann/json.hpp>
+
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+// One value per bar for each indicator slot (NaN before the lookback), plus the
+// column views generateSignals() takes
+struct PreparedInputs {
+    std::shared_ptr<const core::CandleSeries> series;
+    std::vector<std::vector<double>> per_bar;        // [slot][bar]
+    std::vector<core::TimeSeries<double>> results;   // [slot], offset by first_bar
+    std::vector<strategy_engine::IndicatorColumn> columns;
+};
+
+PreparedInputs prepare(const strategy_engine::IStrategy& strategy, std::size_t bars) {
+    static const std::map<std::string, int> kPeriods = {{"SMA(10)", 10}, {"SMA(20)", 20}};
+    PreparedInputs inputs;
+    inputs.series = benchmarks::syntheticSeries(bars);
+    for (const auto& name : strategy.getRequiredIndicatorNames()) {
+        indicators::SmaIndicator sma(kPeriods.at(name));
+        sma.calculate(*inputs.series);
+        const auto lookback = static_cast<std::size_t>(sma.getLookback());
+        auto& values = inputs.per_bar.emplace_back(bars, std::numeric_limits<double>::quiet_NaN());
+        const auto& result = sma.getResult();
+        for (std::size_t k = 0; k < result.size(); ++k) values[lookback + k] = result[k];
+        inputs.results.push_back(sma.releaseResult());
+        inputs.columns.push_back({inputs.results.back(), lookback});
+    }
+    return inputs;
+}
+
+std::unique_ptr<strategy_engine::IStrategy> createBenchmarkStrategy() {
+    return strategy_engine::StrategyFactory::createStrategy(benchmarks::smaCrossConfig({"NSE_EQ|BENCH0"}));
+}
+
+void BM_CreateStrategy(benchmark::State& state) {
+    const nlohmann::json config = benchmarks::smaCrossConfig(benchmarks::syntheticInstruments(state.range(0)));
+    for (auto _ : state) {
+        auto strategy = strategy_engine::StrategyFactory::createStrategy(config);
+        if (!strategy) {
+            state.SkipWithError("Failed to create benchmark strategy");
+            break;
+        }
+        benchmark::DoNotOptimize(strategy.get());
+    }
+}
+BENCHMARK(BM_CreateStrategy)->ArgName("instruments")->Arg(1)->Arg(50);
+
+void BM_ParseStrategy(benchmark::State& state) {
+    const nlohmann::json config = benchmarks::smaCrossConfig(benchmarks::syntheticInstruments(state.range(0)));
+    for (auto _ : state) {
+        auto strategy = strategy_engine::StrategyFactory::parseStrategy(config);
+        if (!strategy) {
+            state.SkipWithError("Failed to parse benchmark strategy");
+            break;
+        }
+        benchmark::DoNotOptimize(strategy.get());
+    }
+}
+BENCHMARK(BM_ParseStrategy)->ArgName("instruments")->Arg(1)->Arg(50);
+
+void BM_CreateStrategyArena(benchmark::State& state) {
+    const nlohmann::json config = benchmarks::smaCrossConfig(benchmarks::syntheticInstruments(state.range(0)));
+    core::Arena arena;
+    for (auto _ : state) {
+        {
+            auto strategy = strategy_engine::StrategyFactory::createStrategy(config, &arena);
+            if (!strategy) {
+                state.SkipWithError("Failed to create benchmark strategy");
+                break;
+            }
+            benchmark::DoNotOptimize(strategy.get());
+        } // Destroyed before the arena is rewound
+        arena.release();
+    }
+}
+BENCHMARK(BM_CreateStrategyArena)->ArgName("instruments")->Arg(1)->Arg(50);
+
+void BM_StrategyEvaluate(benchmark::State& state) {
+    auto strategy = createBenchmarkStrategy();
+    if (!strategy) {
+        state.SkipWithError("Failed to create benchmark strategy");
+        return;
+    }
+    const auto inputs = prepare(*strategy, static_cast<std::size_t>(state.range(0)));
+    const core::CandleSeries& series = *inputs.series;
+    const std::size_t slots = inputs.per_bar.size();
+
+    std::vector<double> current(slots), previous(slots);
+    core::Candle current_candle, previous_candle;
+    strategy_engine::MarketDataSnapshot snapshot;
+    snapshot.indicator_values = current;
+    snapshot.indicator_values_prev = previous;
+    snapshot.current_candle = &current_candle;
+    snapshot.previous_candle = &previous_candle;
+
+    std::size_t signals = 0;
+    for (auto _ : state) {
+        for (std::size_t bar = 1; bar < series.size(); ++bar) {
+            for (std::size_t slot = 0; slot < slots; ++slot) {
+                previous[slot] = inputs.per_bar[slot][bar - 1];
+                current[slot] = inputs.per_bar[slot][bar];
+            }
+            previous_candle = series.at(bar - 1);
+            current_candle = series.at(bar);
+            snapshot.current_time = current_candle.timestamp;
+            if (strategy->evaluate(snapshot) != core::SignalAction::None) ++signals;
+        }
+    }
+    benchmark::DoNotOptimize(signals);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * (series.size() - 1)));
+}
+BENCHMARK(BM_StrategyEvaluate)->Apply(benchmarks::applyBarCounts)->Unit(benchmark::kMillisecond);
+
+void BM_StrategyGenerateSignals(benchmark::State& state) {
+    auto strategy = createBenchmarkStrategy();
+    if (!strategy) {
+        state.SkipWithError("Failed to create benchmark strategy");
+        return;
+    }
+    const auto inputs = prepare(*strategy, static_cast<std::size_t>(state.range(0)));
+    const core::CandleSeries& series = *inputs.series;
+
+    strategy_engine::MarketDataColumns columns;
+    columns.bar_count = series.size();
+    columns.open = series.open();
+    columns.high = series.high();
+    columns.low = series.low();
+    columns.close = series.close();
+    columns.indicators = inputs.columns;
+
+    std::vector<strategy_engine::SignalEvent> signals;
+    for (auto _ : state) {
+        signals.clear();
+        if (!strategy->generateSignals(columns, 1, series.size(), signals)) {
+            state.SkipWithError("Strategy does not support vectorized evaluation");
+            break;
+        }
+        benchmark::DoNotOptimize(signals.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * (series.size() - 1)));
+}
+BENCHMARK(BM_StrategyGenerateSignals)->Apply(benchmarks::applyBarCounts)->Unit(benchmark::kMillisecond);
+
+} // namespace
@@ -0,0 +1,108 @@
+#include "synthetic_data.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <random>
+#include <utility>
+
+namespace benchmarks {
+
+void applyBarCounts(benchmark::internal::Benchmark* benchmark) {
+    benchmark->Arg(10'000)->Arg(1'000'000)->Arg(10'000'000);
+}
+
+std::shared_ptr<const core::CandleSeries> syntheticSeries(std::size_t count, unsigned seed) {
+    static std::mutex mutex;
+    static std::map<std::pair<std::size_t, unsigned>, std::shared_ptr<const core::CandleSeries>> built;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& entry = built[{count, seed}];
+    if (entry) return entry;
+
+    // Log-normal random walk with a slow cycle on top, so fast/slow SMAs cross
+    // regularly at every series length
+    std::mt19937_64 rng(seed);
+    std::normal_distribution<double> step(0.0, 0.001);
+    const core::Timestamp start = core::utils::stringToTimestamp(kSyntheticStartDate + "T09:15:00+05:30");
+
+    core::CandleSeries::Builder builder;
+    builder.reserve(count);
+    double log_price = std::log(100.0);
+    for (std::size_t i = 0; i < count; ++i) {
+        const double open = std::exp(log_price);
+        log_price += step(rng) + 0.0005 * std::sin(static_cast<double>(i) * 0.01);
+        const double close = std::exp(log_price);
+        core::Candle candle;
+        candle.timestamp = start + std::chrono::minutes(i);
+        candle.open = open;
+        candle.close = close;
+        candle.high = std::max(open, close) * 1.0005;
+        candle.low = std::min(open, close) * 0.9995;
+        candle.volume = 1000 + static_cast<long long>(i % 97);
+        builder.push_back(candle);
+    }
+    entry = std::make_shared<const core::CandleSeries>(builder.build());
+    return entry;
+}
+
+core::TimeSeries<core::Candle> syntheticCandles(std::size_t count, unsigned seed) {
+    return syntheticSeries(count, seed)->toCandles();
+}
+
+void InMemoryCandleSource::add(const std::string& instrument_key, std::shared_ptr<const core::CandleSeries> series) {
+    series_[instrument_key] = std::move(series);
+}
+
+core::TimeSeries<core::Candle> InMemoryCandleSource::queryCandles(const std::string& instrument_key,
+                                                                  const std::string& interval,
+                                                                  core::Timestamp start_time,
+                                                                  core::Timestamp end_time)
+{
+    return queryCandleSeries(instrument_key, interval, start_time, end_time).toCandles();
+}
+
+core::CandleSeries InMemoryCandleSource::queryCandleSeries(const std::string& instrument_key,
+                                                           const std::string& /*interval*/,
+                                                           core::Timestamp start_time,
+                                                           core::Timestamp end_time)
+{
+    const auto it = series_.find(instrument_key);
+    if (it == series_.end()) return {};
+    const core::CandleSeries& series = *it->second;
+    const auto timestamps = series.timestampsNs();
+    const auto toNs = [](core::Timestamp ts) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(ts.time_since_epoch()).count();
+    };
+    const auto first = std::lower_bound(timestamps.begin(), timestamps.end(), toNs(start_time));
+    const auto last = std::upper_bound(first, timestamps.end(), toNs(end_time));
+    return series.slice(static_cast<std::size_t>(first - timestamps.begin()),
+                        static_cast<std::size_t>(last - timestamps.begin()));
+}
+
+nlohmann::json smaCrossConfig(const std::vector<std::string>& instruments) {
+    nlohmann::json config = nlohmann::json::parse(R"json({
+        "strategy_name": "BenchSmaCross",
+        "timeframes": ["1minute"],
+        "position_sizing": {"method": "Quantity", "value": 10},
+        "indicators": [{"name": "SMA(10)"}, {"name": "SMA(20)"}],
+        "entry_rules": [{"rule_name": "Enter", "action": "EnterLong",
+            "condition": {"type": "AND", "conditions": [
+                {"type": "CrossesAbove", "indicator1": "SMA(10)", "indicator2": "SMA(20)"},
+                {"type": "PriceIndicator", "price_field": "Close", "op": "GT", "indicator": "SMA(20)"}]}}],
+        "exit_rules": [{"rule_name": "Exit", "action": "ExitLong",
+            "condition": {"type": "CrossesBelow", "indicator1": "SMA(10)", "indicator2": "SMA(20)"}}]
+    })json");
+    config["instruments"] = instruments;
+    return config;
+}
+
+std::vector<std::string> syntheticInstruments(std::size_t count) {
+    std::vector<std::string> keys;
+    keys.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) keys.push_back("NSE_EQ|BENCH" + std::to_string(i));
+    return keys;
+}
+
+} // namespace benchmarks
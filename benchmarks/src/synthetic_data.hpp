@@ -0,0 +1,67 @@
+#pragma once
+
+// Synthetic inputs shared by the pipeline benchmarks: deterministic minute bars,
+// an in-memory candle source and the strategy configs that run on them.
+
+#include "candle_source.hpp"
+#include "candle_series.hpp"
+#include "datatypes.hpp"
+
+#include <benchmark/benchmark.h>
+#include <nlohmann/json.hpp>
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace benchmarks {
+
+// Interval label of the synthetic bars (back-to-back 1-minute bars)
+inline const std::string kSyntheticInterval = "1minute";
+
+// First bar of every synthetic series and the date range that covers any of them
+inline const std::string kSyntheticStartDate = "2000-01-03";
+inline const std::string kSyntheticEndDate = "2030-12-31";
+
+// Registers the standard sizes (10k / 1M / 10M bars) as the benchmark argument
+void applyBarCounts(benchmark::internal::Benchmark* benchmark);
+
+// 'count' bars of a seeded random walk: the same 'seed' always gives the same
+// series. Built once per (count, seed) and shared, since 10M bars take a while.
+std::shared_ptr<const core::CandleSeries> syntheticSeries(std::size_t count, unsigned seed = 1);
+
+// Same bars as AoS candles (what queryCandles() returns)
+core::TimeSeries<core::Candle> syntheticCandles(std::size_t count, unsigned seed = 1);
+
+// ICandleSource over series held in memory. Queries return slices of the stored
+// series (no copy), so Backtester::run() measures the pipeline, not storage.
+class InMemoryCandleSource : public data::ICandleSource {
+public:
+    void add(const std::string& instrument_key, std::shared_ptr<const core::CandleSeries> series);
+
+    bool connect() override { return true; }
+    bool isConnected() const override { return true; }
+    bool supportsConcurrentQueries() const override { return true; }
+
+    core::TimeSeries<core::Candle> queryCandles(const std::string& instrument_key,
+                                                const std::string& interval,
+                                                core::Timestamp start_time,
+                                                core::Timestamp end_time) override;
+    core::CandleSeries queryCandleSeries(const std::string& instrument_key,
+                                         const std::string& interval,
+                                         core::Timestamp start_time,
+                                         core::Timestamp end_time) override;
+
+private:
+    std::map<std::string, std::shared_ptr<const core::CandleSeries>> series_;
+};
+
+// SMA(10)/SMA(20) crossover with a price filter on the given instruments
+nlohmann::json smaCrossConfig(const std::vector<std::string>& instruments);
+
+// Instrument keys "NSE_EQ|BENCH0".."NSE_EQ|BENCH<count-1>"
+std::vector<std::string> syntheticInstruments(std::size_t count);
+
+} // namespace benchmarks
@@ -0,0 +1,119 @@
+// Timestamp text conversion, per call, on the DB format "YYYY-MM-DDTHH:MM:SS+05:30".
+//
+//   BM_ParseTimestamp_Stream    - previous stringToTimestamp(): istringstream + get_time
+//   BM_ParseTimestamp_Fixed     - core::utils::parseTimestamp() on a string_view
+//   BM_FormatTimestamp_Stream   - previous timestampToString(): ostringstream + put_time
+//   BM_FormatTimestamp_String   - core::utils::timestampToString() (one std::string)
+//   BM_FormatTimestamp_Buffer   - core::utils::formatTimestamp() into a stack buffer
+//
+// The stream versions are kept here only as the reference for the speedup.
+
+#include "utils.hpp"
+#include "datatypes.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstddef>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kSamples = 1024;
+
+// --- Reference: the std::get_time / std::put_time implementation (no fraction, fixed offset input) ---
+core::Timestamp streamStringToTimestamp(const std::string& iso_string) {
+    std::tm tm = {};
+    std::istringstream ss(iso_string);
+    ss >> std::get_time(&tm, "%Y-%m-%dT%H:%M:%S");
+    if (ss.fail()) throw std::runtime_error("Failed to parse timestamp: " + iso_string);
+    char sign = 0;
+    int offset_h = 0, offset_m = 0;
+    char colon = ' ';
+    ss >> sign >> std::setw(2) >> offset_h >> colon >> std::setw(2) >> offset_m;
+    std::chrono::seconds offset = std::chrono::hours(offset_h) + std::chrono::minutes(offset_m);
+    if (sign == '-') offset *= -1;
+    return std::chrono::system_clock::from_time_t(timegm(&tm)) - offset;
+}
+
+std::string streamTimestampToString(const core::Timestamp& ts) {
+    const auto tt_ist = std::chrono::system_clock::to_time_t(ts + std::chrono::hours(5) + std::chrono::minutes(30));
+    std::tm time_tm;
+    gmtime_r(&tt_ist, &time_tm);
+    std::ostringstream oss;
+    oss << std::put_time(&time_tm, "%Y-%m-%dT%H:%M:%S") << "+05:30";
+    return oss.str();
+}
+
+std::vector<core::Timestamp> makeTimestamps() {
+    std::vector<core::Timestamp> timestamps(kSamples);
+    const core::Timestamp start = core::utils::stringToTimestamp("2024-01-01T09:15:00+05:30");
+    for (std::size_t i = 0; i < kSamples; ++i) timestamps[i] = start + std::chrono::minutes(i * 37);
+    return timestamps;
+}
+
+std::vector<std::string> makeStrings() {
+    std::vector<std::string> strings;
+    for (const auto& ts : makeTimestamps()) strings.push_back(core::utils::timestampToString(ts));
+    return strings;
+}
+
+void BM_ParseTimestamp_Stream(benchmark::State& state) {
+    const auto strings = makeStrings();
+    for (auto _ : state) {
+        for (const auto& s : strings) benchmark::DoNotOptimize(streamStringToTimestamp(s));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * strings.size()));
+}
+BENCHMARK(BM_ParseTimestamp_Stream);
+
+void BM_ParseTimestamp_Fixed(benchmark::State& state) {
+    const auto strings = makeStrings();
+    for (auto _ : state) {
+        for (const auto& s : strings) {
+            core::Timestamp ts;
+            benchmark::DoNotOptimize(core::utils::parseTimestamp(s, ts));
+            benchmark::DoNotOptimize(ts);
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * strings.size()));
+}
+BENCHMARK(BM_ParseTimestamp_Fixed);
+
+void BM_FormatTimestamp_Stream(benchmark::State& state) {
+    const auto timestamps = makeTimestamps();
+    for (auto _ : state) {
+        for (const auto& ts : timestamps) benchmark::DoNotOptimize(streamTimestampToString(ts));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * timestamps.size()));
+}
+BENCHMARK(BM_FormatTimestamp_Stream);
+
+void BM_FormatTimestamp_String(benchmark::State& state) {
+    const auto timestamps = makeTimestamps();
+    for (auto _ : state) {
+        for (const auto& ts : timestamps) benchmark::DoNotOptimize(core::utils::timestampToString(ts));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * timestamps.size()));
+}
+BENCHMARK(BM_FormatTimestamp_String);
+
+void BM_FormatTimestamp_Buffer(benchmark::State& state) {
+    const auto timestamps = makeTimestamps();
+    char buffer[core::utils::kTimestampStringLength];
+    for (auto _ : state) {
+        for (const auto& ts : timestamps) {
+            benchmark::DoNotOptimize(core::utils::formatTimestamp(ts, buffer));
+            benchmark::ClobberMemory();
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * timestamps.size()));
+}
+BENCHMARK(BM_FormatTimestamp_Buffer);
+
+} // namespace
@@ -0,0 +1,80 @@
+// Parsing an Upstox historical-candle response of N intraday rows.
+//
+//   BM_UpstoxParse_Dom        - json::parse() of the whole body, then walk data.candles
+//                               (how UpstoxApiClient used to do it)
+//   BM_UpstoxParse_Streaming  - data::parseUpstoxCandleJson(), rows decoded in place
+//
+// Bytes/s is over the JSON body. Both produce the same candles (the data.candle_parser
+// check compares them on irregular responses); the DOM variant additionally holds
+// the whole document in memory while it runs.
+
+#include "upstox_candle_parser.hpp"
+#include "utils.hpp"
+#include "datatypes.hpp"
+
+#include <benchmark/benchmark.h>
+#include <nlohmann/json.hpp>
+#include <spdlog/fmt/bundled/core.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string makeResponse(std::size_t rows) {
+    std::string body = R"({"status":"success","data":{"candles":[)";
+    const core::Timestamp start = core::utils::stringToTimestamp("2024-01-01T09:15:00+05:30");
+    for (std::size_t i = 0; i < rows; ++i) {
+        const double price = 100.0 + 10.0 * std::sin(static_cast<double>(i) * 0.05);
+        if (i > 0) body += ',';
+        body += fmt::format(R"(["{}",{:.2f},{:.2f},{:.2f},{:.2f},{},0])",
+                            core::utils::timestampToString(start + std::chrono::minutes(i)),
+                            price, price + 0.5, price - 0.5, price + 0.1, 1000 + i % 97);
+    }
+    body += "]}}";
+    return body;
+}
+
+void BM_UpstoxParse_Dom(benchmark::State& state) {
+    const std::string body = makeResponse(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        std::vector<core::Candle> candles;
+        const auto json = nlohmann::json::parse(body);
+        for (const auto& row : json["data"]["candles"]) {
+            core::Candle candle;
+            candle.timestamp = core::utils::stringToTimestamp(row[0].get<std::string>());
+            candle.open = row[1].get<double>();
+            candle.high = row[2].get<double>();
+            candle.low = row[3].get<double>();
+            candle.close = row[4].get<double>();
+            candle.volume = row[5].get<long long>();
+            if (row.size() > 6 && row[6].is_number()) candle.open_interest = row[6].get<long long>();
+            candles.push_back(candle);
+        }
+        benchmark::DoNotOptimize(candles.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * body.size()));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * state.range(0)));
+}
+BENCHMARK(BM_UpstoxParse_Dom)->Arg(1 << 10)->Arg(1 << 16);
+
+void BM_UpstoxParse_Streaming(benchmark::State& state) {
+    const std::string body = makeResponse(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        std::vector<core::Candle> candles;
+        candles.reserve(body.size() / 64);
+        const auto result = data::parseUpstoxCandleJson(body, [&](const core::Candle& candle) {
+            candles.push_back(candle);
+        });
+        benchmark::DoNotOptimize(result.rows);
+        benchmark::DoNotOptimize(candles.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * body.size()));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * state.range(0)));
+}
+BENCHMARK(BM_UpstoxParse_Streaming)->Arg(1 << 10)->Arg(1 << 16);
+
+} // namespace
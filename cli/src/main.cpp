@@ -7,9 +7,13 @@
 #include <exception>
 #include <chrono>
 #include <cstdlib>
+#include <cstdint>
 #include <memory>
 #include <algorithm>
 #include <fstream>     // For std::ifstream
+#include <atomic>
+#include <csignal>
+#include <thread>
 
 // Project includes (Using short paths)
 #include "logging.hpp"
@@ -17,8 +21,19 @@
 #include "datatypes.hpp"
 #include "utils.hpp"
 #include "database_manager.hpp"
+#include "columnar_candle_store.hpp"
+#include "ingest_pipeline.hpp"      // Bulk Upstox backfill
 #include "strategy_factory.hpp"
+#include "strategy_cache.hpp"   // Compiled strategies (embedded, on disk)
 #include "backtester.hpp"       // Include Backtester header
+#include "parameter_sweep.hpp"  // Grid search over strategy parameters
+#include "batch_runner.hpp"     // Many strategies over one data pass
+#include "walk_forward.hpp"     // Rolling in-sample optimization / out-of-sample test
+#include "screener_run.hpp"     // Cross-sectional screen over a universe ('screen')
+#include "http_server.hpp"
+#include "backtest_service.hpp" // Long-running backtest endpoint ('serve')
+#include "distributed_sweep.hpp"  // Sweep coordinator / worker ('sweep-worker')
+#include "replay_harness.hpp"     // Live-path latency replay ('replay')
 
 // Lib includes
 #include <spdlog/spdlog.h>
@@ -28,6 +43,11 @@
 
 using json = nlohmann::json; // Alias
 
+namespace { // File-local helpers
+    std::atomic<bool> g_stop_requested{false}; // Set by SIGINT / SIGTERM while serving
+    extern "C" void requestStop(int) { g_stop_requested = true; }
+} // end anonymous namespace
+
 int main(int argc, char* argv[]) {
     // Define logger pointer early
     std::shared_ptr<spdlog::logger> logger = nullptr;
@@ -53,34 +73,285 @@ int main(int argc, char* argv[]) {
     std::string end_date;           // Required, no default
     double initial_capital = 100000.0; // Default capital
     std::string db_path = "/home/vboxuser/market_data_vm_copy.db"; // Default DB Path
+    bool sweep_mode = false;        // Run the strategy's "sweep" grid instead of a single backtest
+    std::size_t num_threads = 0;    // 0 = hardware concurrency
+    std::string sweep_output_path;  // Optional CSV with all sweep results
+    std::string batch_dir;          // Run every strategy JSON in this directory instead of --strategy
+    std::string batch_output_path;  // Optional CSV with one row per batch strategy
+    bool walk_forward_mode = false; // Run the strategy's "walk_forward" + "sweep" blocks
+    std::string walk_forward_output_path; // Optional CSV with the stitched out-of-sample equity
+    bool use_indicator_cache = false; // Persist computed indicators next to the DB
+    std::string indicator_cache_dir;  // Overrides the default "<db>.indicators" directory
+    std::string strategy_cache_dir;   // Compiled strategies kept between launches (empty = memory only)
+    std::string columnar_dir;         // Read candles from .tpcol files instead of SQLite
+    bool per_bar_evaluation = false;  // Evaluate the strategy bar by bar instead of over whole columns
+    bool compact_candles = false;     // Keep shared candle series tick-encoded between runs
+    std::size_t stream_chunk_bars = 0;  // Single backtests: load and evaluate in chunks of this many bars (0 = off)
+    std::size_t stream_warmup_bars = 0; // Bars carried between chunks (at least the longest lookback + 1)
+    std::string stats_json_path;      // Optional run stats (phase timings, counters) as JSON
+    std::string trace_path;           // Optional Chrome trace of the run phases
+    std::string results_path;         // Optional .tpres file with every run's metrics, equity curve and trades
+    server::DistributedSweepOptions distributed_options; // --sweep on remote 'sweep-worker' processes
+    data::SqliteOptions sqlite_options; // WAL, mmap and cache settings for every SQLite connection
+    bool sqlite_no_wal = false;
+    std::int64_t sqlite_mmap_mb = sqlite_options.mmap_size_bytes >> 20;
+    int sqlite_cache_mb = sqlite_options.cache_size_kib / 1024;
 
+    // Strategy/start/end are required for backtests only, checked after parsing
+    // so that maintenance subcommands (e.g. 'migrate') can run without them
     app.add_option("-s,--strategy", strategy_file_path, "Path to the strategy JSON configuration file")
-        ->required()
         ->check(CLI::ExistingFile);
-    app.add_option("--start", start_date, "Backtest start date (YYYY-MM-DD format)")
-        ->required();
-    app.add_option("--end", end_date, "Backtest end date (YYYY-MM-DD format)")
-        ->required();
+    app.add_option("--start", start_date, "Backtest start date (YYYY-MM-DD format)");
+    app.add_option("--end", end_date, "Backtest end date (YYYY-MM-DD format)");
     app.add_option("-c,--capital", initial_capital, "Initial capital for the backtest")
         ->check(CLI::PositiveNumber);
     app.add_option("-d,--database", db_path, "Path to the SQLite market data DB file")
         ->check(CLI::ExistingFile);
+    app.add_flag("--sweep", sweep_mode, "Run a parameter sweep using the 'sweep' section of the strategy file");
+    app.add_option("-j,--threads", num_threads, "Worker threads for --sweep or across instruments (0 = all cores)");
+    app.add_option("--sweep-output", sweep_output_path, "Write all sweep results to this CSV file");
+    app.add_option("--sweep-workers", distributed_options.workers, "Run --sweep on these 'sweep-worker' processes (host:port, repeatable)")
+        ->delimiter(',');
+    app.add_flag("--sweep-per-instrument", distributed_options.per_instrument, "With --sweep-workers: one job per combination and instrument");
+    app.add_option("--sweep-batch", distributed_options.batch_size, "With --sweep-workers: jobs per request (0 = the worker's thread count)");
+    app.add_option("--sweep-secret", distributed_options.shared_secret, "With --sweep-workers: the workers' --secret (default: TP_SWEEP_SECRET)");
+    app.add_option("--batch-dir", batch_dir, "Run every strategy JSON in this directory over one shared data pass");
+    app.add_option("--batch-output", batch_output_path, "Write one row of metrics per batch strategy to this CSV file");
+    app.add_flag("--walk-forward", walk_forward_mode, "Run a walk-forward optimization using the 'walk_forward' and 'sweep' sections");
+    app.add_option("--walk-forward-output", walk_forward_output_path, "Write the stitched out-of-sample equity curve to this CSV file");
+    app.add_flag("--indicator-cache", use_indicator_cache, "Reuse indicator series saved on disk next to the database");
+    app.add_option("--indicator-cache-dir", indicator_cache_dir, "Directory for the on-disk indicator cache (implies --indicator-cache)");
+    app.add_option("--strategy-cache-dir", strategy_cache_dir, "Keep compiled strategies in this directory so later launches skip parsing them");
+    app.add_option("--columnar-dir", columnar_dir, "Load candles from columnar (.tpcol) files in this directory instead of the DB")
+        ->check(CLI::ExistingDirectory);
+    app.add_flag("--compact-candles", compact_candles, "Hold candles shared by --batch-dir/--sweep/--walk-forward runs in compact tick form");
+    app.add_option("--stream-chunk-bars", stream_chunk_bars, "Run a single backtest in bounded memory, this many bars per chunk (0 = load everything)");
+    app.add_option("--stream-warmup-bars", stream_warmup_bars, "Bars carried between stream chunks for indicator warm-up (default: longest lookback + 1, about 10 periods for recursive indicators)");
+    app.add_flag("--per-bar", per_bar_evaluation, "Evaluate strategy rules bar by bar (reference path) instead of over whole series");
+    app.add_option("--stats-json", stats_json_path, "Write phase timings and event loop counters of the run to this JSON file");
+    app.add_option("--trace", trace_path, "Write the run phases as a Chrome trace (chrome://tracing, Perfetto) to this file");
+    app.add_option("--results-out", results_path, "Write metrics, equity curves and trade logs of every single/--sweep/--batch-dir run to this columnar .tpres file");
+    app.add_flag("--db-no-wal", sqlite_no_wal, "Leave the database journal mode unchanged instead of switching to WAL");
+    app.add_option("--db-mmap-mb", sqlite_mmap_mb, "SQLite mmap_size per connection in MiB (0 = off)")
+        ->check(CLI::NonNegativeNumber);
+    app.add_option("--db-cache-mb", sqlite_cache_mb, "SQLite page cache per connection in MiB")
+        ->check(CLI::PositiveNumber);
+    app.add_option("--db-readers", sqlite_options.max_read_connections, "Maximum pooled SQLite read connections (0 = all cores)");
+
+    // --- Subcommands ---
+    CLI::App* migrate_cmd = app.add_subcommand("migrate", "Convert the database to the current schema (INTEGER timestamps)");
+    migrate_cmd->fallthrough(); // Accept -d/--database after the subcommand name
+
+    std::string export_dir;
+    std::vector<std::string> export_instruments;
+    std::string export_interval;
+    CLI::App* export_cmd = app.add_subcommand("export-columnar", "Convert SQLite candles to memory-mappable columnar files");
+    export_cmd->add_option("-o,--output-dir", export_dir, "Directory to write .tpcol files into")->required();
+    export_cmd->add_option("-i,--instrument", export_instruments, "Instrument key(s) to export (default: all)");
+    export_cmd->add_option("--interval", export_interval, "Interval to export, e.g. 'day' (default: all)");
+    export_cmd->fallthrough();
+
+    std::vector<std::string> ingest_instruments;
+    std::string ingest_instruments_file;
+    std::string ingest_index;
+    std::string ingest_interval = "day";
+    std::string ingest_from;
+    std::string ingest_to;
+    std::string ingest_token;
+    int ingest_chunk_days = 0;
+    long ingest_timeout_ms = 15000;
+    bool ingest_sync = false;
+    data::IngestOptions ingest_options;
+    CLI::App* ingest_cmd = app.add_subcommand("ingest", "Backfill historical candles from the Upstox API into the database");
+    ingest_cmd->add_option("-i,--instrument", ingest_instruments, "Instrument key(s) to fetch");
+    ingest_cmd->add_option("--instruments-file", ingest_instruments_file, "File with one instrument key per line ('#' comments)")
+        ->check(CLI::ExistingFile);
+    ingest_cmd->add_option("--index", ingest_index, "Fetch the constituents of this index (as of --to) from the index_constituents table");
+    ingest_cmd->add_option("--interval", ingest_interval, "Candle interval, e.g. 'day', '1minute', '30minute'");
+    ingest_cmd->add_option("--from", ingest_from, "First date to fetch (YYYY-MM-DD)")->required();
+    ingest_cmd->add_option("--to", ingest_to, "Last date to fetch (YYYY-MM-DD)")->required();
+    ingest_cmd->add_option("--token", ingest_token, "Upstox access token (default: $UPSTOX_ACCESS_TOKEN)");
+    ingest_cmd->add_option("--chunk-days", ingest_chunk_days, "Days per request (0 = interval default)")
+        ->check(CLI::NonNegativeNumber);
+    ingest_cmd->add_option("--fetch-workers", ingest_options.fetch_workers, "Concurrent HTTP requests")
+        ->check(CLI::PositiveNumber);
+    ingest_cmd->add_option("--rps", ingest_options.requests_per_second, "Request rate limit across all workers (0 = unlimited)")
+        ->check(CLI::NonNegativeNumber);
+    ingest_cmd->add_option("--retries", ingest_options.max_retries, "Retries per request on 429 / 5xx / network errors");
+    ingest_cmd->add_option("--batch-rows", ingest_options.batch_rows, "Candles per write transaction")
+        ->check(CLI::PositiveNumber);
+    ingest_cmd->add_option("--timeout-ms", ingest_timeout_ms, "Per-request HTTP timeout")
+        ->check(CLI::PositiveNumber);
+    ingest_cmd->add_flag("--sync", ingest_sync, "Only fetch date ranges missing from the database (uses stored coverage and gaps)");
+    ingest_cmd->fallthrough();
+
+    std::string serve_host = "127.0.0.1";
+    std::uint16_t serve_port = 8080;
+    std::size_t serve_workers = 0;
+    server::BacktestServiceOptions serve_options;
+    std::size_t serve_max_cache_mb = 0;
+    CLI::App* serve_cmd = app.add_subcommand("serve", "Serve backtests over HTTP, keeping connections, candles and indicators warm");
+    serve_cmd->add_option("--host", serve_host, "IPv4 address to listen on");
+    serve_cmd->add_option("--port", serve_port, "TCP port to listen on (0 = any free port)");
+    serve_cmd->add_option("--workers", serve_workers, "Requests served concurrently (0 = all cores)");
+    serve_cmd->add_option("--data-start", serve_options.data_start, "Start of a shared data window (YYYY-MM-DD); backtests load it whole and trade their own dates");
+    serve_cmd->add_option("--data-end", serve_options.data_end, "End of the shared data window (YYYY-MM-DD)");
+    serve_cmd->add_option("--max-cache-mb", serve_max_cache_mb, "Drop cached candles and indicators once candles exceed this many MiB (0 = no limit)");
+    serve_cmd->add_option("--max-sweep-combinations", serve_options.max_sweep_combinations, "Reject /sweep grids with more combinations (0 = no service limit)");
+    serve_cmd->fallthrough();
+
+    std::string worker_host = "127.0.0.1";
+    std::uint16_t worker_port = 8090;
+    std::string worker_secret;
+    CLI::App* worker_cmd = app.add_subcommand("sweep-worker", "Run sweep jobs sent by a --sweep-workers coordinator against the local candle data");
+    worker_cmd->add_option("--host", worker_host, "IPv4 address to listen on (other than loopback needs --secret)");
+    worker_cmd->add_option("--port", worker_port, "TCP port to listen on");
+    worker_cmd->add_option("--secret", worker_secret, "Shared secret coordinators must send (default: TP_SWEEP_SECRET)");
+    worker_cmd->fallthrough();
+
+    std::string replay_recording;
+    std::string replay_save_path;
+    int replay_ticks_per_bar = 4;
+    std::vector<std::string> replay_limits;
+    std::string replay_report_path;
+    std::string replay_hgrm_dir;
+    live::ReplayOptions replay_options;
+    CLI::App* replay_cmd = app.add_subcommand("replay", "Replay stored candles or a recorded feed through the live signal path and report latency per stage");
+    replay_cmd->add_option("--recording", replay_recording, "Feed recording (.tpfeed) to replay instead of the strategy's candles from --start to --end")
+        ->check(CLI::ExistingFile);
+    replay_cmd->add_option("--save-recording", replay_save_path, "Save the feed messages built from candles to this .tpfeed file");
+    replay_cmd->add_option("--speed", replay_options.speed, "1 = recorded pace, N = N times faster, 0 = as fast as possible")
+        ->check(CLI::NonNegativeNumber);
+    replay_cmd->add_option("--ticks-per-bar", replay_ticks_per_bar, "Trades each candle is replayed as (4 or more keep its OHLC exact)")
+        ->check(CLI::PositiveNumber);
+    replay_cmd->add_option("--max-p99-us", replay_limits, "Fail if a stage's p99 is over this, as stage=microseconds (repeatable)");
+    replay_cmd->add_option("--report-json", replay_report_path, "Write counters and per-stage latency percentiles to this JSON file");
+    replay_cmd->add_option("--hgrm-dir", replay_hgrm_dir, "Write one HdrHistogram percentile distribution (.hgrm) per stage into this directory");
+    replay_cmd->fallthrough();
+
+    std::string screen_file_path;
+    std::string screen_output_path;
+    bool screen_last_bar = false;
+    std::size_t screen_show = 5;
+    CLI::App* screen_cmd = app.add_subcommand("screen", "Run a cross-sectional screen over an instrument universe from --start to --end");
+    screen_cmd->add_option("--screen", screen_file_path, "Screen config (JSON with filters, rank_by, top and instruments / universe)")
+        ->required()->check(CLI::ExistingFile);
+    screen_cmd->add_option("--output", screen_output_path, "Write every snapshot's hits to this CSV file");
+    screen_cmd->add_flag("--last-bar", screen_last_bar, "Scan once, on each instrument's last bar in range");
+    screen_cmd->add_option("--show", screen_show, "Snapshots to log (the most recent ones)");
+    screen_cmd->fallthrough();
 
     // Parse arguments - CLI11 handles --help / -h and errors
     try {
          app.parse(argc, argv);
+         if (!*migrate_cmd && !*export_cmd && !*ingest_cmd && !*serve_cmd && !*worker_cmd) {
+             if (strategy_file_path.empty() && batch_dir.empty() && !*screen_cmd) throw CLI::RequiredError("--strategy");
+             if (!*replay_cmd || replay_recording.empty()) { // A recording brings its own time range
+                 if (start_date.empty()) throw CLI::RequiredError("--start");
+                 if (end_date.empty()) throw CLI::RequiredError("--end");
+             }
+         }
     } catch (const CLI::ParseError &e) {
          // Use app.exit to print help/error and exit on parse error
          return app.exit(e);
     }
     // --- Argument Parsing Complete ---
+    sqlite_options.wal = !sqlite_no_wal;
+    sqlite_options.mmap_size_bytes = sqlite_mmap_mb << 20;
+    sqlite_options.cache_size_kib = sqlite_cache_mb * 1024;
 
+    // Compiled strategies: those built into the binary, then the optional disk tier
+    strategy_engine::StrategyCache::shared().preloadEmbedded(strategy_engine::embeddedStrategies());
+    if (!strategy_cache_dir.empty()) {
+        logger->info("Using on-disk strategy cache: {}", strategy_cache_dir);
+        strategy_engine::StrategyCache::shared().setDiskDirectory(strategy_cache_dir);
+    }
 
     // --- Main Application Logic in a try block ---
     try {
+        if (*migrate_cmd) {
+            logger->info("Migrating database schema: {}", db_path);
+            data::DatabaseManager db_manager(db_path, sqlite_options);
+            if (!db_manager.connect()) {
+                logger->critical("Failed to connect to database for migration.");
+                return 1;
+            }
+            bool migrated = db_manager.migrateSchema();
+            db_manager.disconnect();
+            return migrated ? 0 : 1;
+        }
+        if (*export_cmd) {
+            logger->info("Exporting candles from {} to columnar files in {}", db_path, export_dir);
+            data::DatabaseManager db_manager(db_path, sqlite_options);
+            const auto exported = data::ColumnarCandleStore::exportFromDatabase(db_manager, export_dir, export_instruments,
+                                                                                 export_interval);
+            db_manager.disconnect();
+            if (exported.written == 0 && exported.failed == 0) {
+                logger->error("No candle series matched the export filters.");
+            }
+            return (exported.failed == 0 && exported.written > 0) ? 0 : 1;
+        }
+        if (*ingest_cmd) {
+            if (ingest_token.empty()) {
+                if (const char* env_token = std::getenv("UPSTOX_ACCESS_TOKEN")) ingest_token = env_token;
+            }
+            if (ingest_token.empty()) {
+                throw core::ConfigException("Ingest needs an Upstox access token (--token or UPSTOX_ACCESS_TOKEN).");
+            }
+            data::DatabaseManager db_manager(db_path, sqlite_options);
+            if (!db_manager.connect() || !db_manager.initializeSchema()) {
+                logger->critical("Failed to open database {} for ingest.", db_path);
+                return 1;
+            }
+
+            std::vector<std::string> instruments = ingest_instruments;
+            if (!ingest_instruments_file.empty()) {
+                std::ifstream ifs(ingest_instruments_file);
+                std::string line;
+                while (std::getline(ifs, line)) {
+                    line.erase(std::find(line.begin(), line.end(), '#'), line.end());
+                    line.erase(0, line.find_first_not_of(" \t\r"));
+                    line.erase(line.find_last_not_of(" \t\r") + 1);
+                    if (!line.empty()) instruments.push_back(line);
+                }
+            }
+            if (!ingest_index.empty()) {
+                auto constituents = db_manager.queryIndexConstituents(ingest_index, ingest_to);
+                logger->info("Index {} has {} constituent(s) as of {}.", ingest_index, constituents.size(), ingest_to);
+                instruments.insert(instruments.end(), constituents.begin(), constituents.end());
+            }
+            std::sort(instruments.begin(), instruments.end());
+            instruments.erase(std::unique(instruments.begin(), instruments.end()), instruments.end());
+            if (instruments.empty()) {
+                throw core::ConfigException("Ingest has no instruments (use --instrument, --instruments-file or --index).");
+            }
+
+            data::UpstoxApiClient client("", "", "", ingest_token);
+            client.setTimeoutMs(ingest_timeout_ms);
+            data::IngestPipeline pipeline(client, db_manager, ingest_options);
+            data::IngestStats stats;
+            if (ingest_sync) {
+                logger->info("Syncing {} candles for {} instrument(s), {} to {} into {}",
+                             ingest_interval, instruments.size(), ingest_from, ingest_to, db_path);
+                stats = pipeline.sync(instruments, ingest_interval, ingest_from, ingest_to, ingest_chunk_days);
+            } else {
+                auto tasks = data::planIngestTasks(instruments, ingest_interval, ingest_from, ingest_to, ingest_chunk_days);
+                logger->info("Ingesting {} candles for {} instrument(s), {} to {} ({} requests) into {}",
+                             ingest_interval, instruments.size(), ingest_from, ingest_to, tasks.size(), db_path);
+                stats = pipeline.run(tasks);
+            }
+            for (const auto& failed : stats.failed) {
+                logger->warn("  failed: {} {} {}..{}", failed.instrument_key, failed.interval, failed.from_date, failed.to_date);
+            }
+            db_manager.disconnect();
+            return stats.tasks_failed == 0 ? 0 : 1;
+        }
+
         logger->info("Trading Platform CLI starting..."); // Log now that parse succeeded
         logger->info("Arguments Parsed Successfully:");
-        logger->info("  -> Strategy File: {}", strategy_file_path);
+        if (*screen_cmd) logger->info("  -> Screen File: {}", screen_file_path);
+        else if (batch_dir.empty()) logger->info("  -> Strategy File: {}", strategy_file_path);
+        else logger->info("  -> Strategy Directory: {}", batch_dir);
         logger->info("  -> Start Date: {}", start_date);
         logger->info("  -> End Date: {}", end_date);
         logger->info("  -> Initial Capital: {:.2f}", initial_capital);
@@ -89,8 +360,118 @@ int main(int argc, char* argv[]) {
 
         // --- Database Setup (Using path from args) ---
         logger->info("Using SQLite database path: {}", db_path);
-        data::DatabaseManager db_manager(db_path); // Define db_manager
+        data::DatabaseManager db_manager(db_path, sqlite_options); // Define db_manager
+        // Optional columnar store replaces SQLite as the candle source
+        std::unique_ptr<data::ColumnarCandleStore> columnar_store;
+        if (!columnar_dir.empty()) {
+            logger->info("Using columnar candle files from: {}", columnar_dir);
+            columnar_store = std::make_unique<data::ColumnarCandleStore>(columnar_dir);
+        }
+        data::ICandleSource& candle_source = columnar_store ? static_cast<data::ICandleSource&>(*columnar_store)
+                                                            : static_cast<data::ICandleSource&>(db_manager);
+
+
+        // Optional persistent indicator cache shared by every run below
+        std::shared_ptr<indicators::IndicatorCache> indicator_cache;
+        if (use_indicator_cache || !indicator_cache_dir.empty()) {
+            if (indicator_cache_dir.empty()) indicator_cache_dir = indicators::IndicatorCache::defaultDirectoryFor(db_path);
+            logger->info("Using on-disk indicator cache: {}", indicator_cache_dir);
+            indicator_cache = std::make_shared<indicators::IndicatorCache>(indicator_cache_dir);
+        }
+
+        const auto evaluation_mode = per_bar_evaluation ? backtester::EvaluationMode::PerBar
+                                                        : backtester::EvaluationMode::Vectorized;
+
+        if (*serve_cmd) {
+            // One process answers every request: the DB stays open and loaded candles
+            // and indicators are reused until the service stops
+            serve_options.default_capital = initial_capital;
+            serve_options.sweep_threads = num_threads;
+            serve_options.evaluation_mode = evaluation_mode;
+            serve_options.max_cached_bytes = serve_max_cache_mb << 20;
+            server::BacktestService service(candle_source, db_manager, serve_options, indicator_cache);
+            service.getDataCache()->setCompactStorage(compact_candles);
+            server::HttpServerOptions http_options;
+            http_options.worker_threads = service.maxConcurrentRequests(serve_workers);
+            server::HttpServer http([&service](const server::HttpRequest& request) { return service.handle(request); },
+                                    http_options);
+            if (!http.start(serve_host, serve_port)) return 1;
+            std::signal(SIGINT, requestStop);
+            std::signal(SIGTERM, requestStop);
+            logger->info("---=== Serving backtests on http://{}:{} (Ctrl+C to stop) ===---", serve_host, http.port());
+            while (!g_stop_requested) std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            http.stop();
+            logger->info("Trading Platform CLI finished.");
+            return 0;
+        }
+        if (*worker_cmd) {
+            // Jobs read candles from this host's source; only parameters and metrics travel
+            if (worker_secret.empty()) {
+                if (const char* env_secret = std::getenv("TP_SWEEP_SECRET")) worker_secret = env_secret;
+            }
+            if (worker_secret.empty() && worker_host.rfind("127.", 0) != 0) {
+                throw core::ConfigException("Sweep worker on " + worker_host + " needs a shared secret (--secret or TP_SWEEP_SECRET).");
+            }
+            server::SweepWorkerOptions worker_options;
+            worker_options.threads = num_threads;
+            worker_options.shared_secret = worker_secret;
+            worker_options.evaluation_mode = evaluation_mode;
+            server::SweepWorker worker(candle_source, worker_options, indicator_cache);
+            server::HttpServer http([&worker](const server::HttpRequest& request) { return worker.handle(request); });
+            if (!http.start(worker_host, worker_port)) return 1;
+            std::signal(SIGINT, requestStop);
+            std::signal(SIGTERM, requestStop);
+            logger->info("---=== Sweep worker on {}:{} ({} job threads, Ctrl+C to stop) ===---", worker_host, http.port(), worker.threads());
+            while (!g_stop_requested) std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            http.stop();
+            logger->info("Trading Platform CLI finished.");
+            return 0;
+        }
+        if (*screen_cmd) {
+            logger->info("---=== Starting Screen: {} ===---", screen_file_path);
+            std::ifstream ifs(screen_file_path);
+            if (!ifs.is_open()) throw core::ConfigException(fmt::format("Failed to open screen file: {}", screen_file_path));
+            json screen_config = json::parse(ifs);
+            // Universes resolve against SQLite, like strategy universes below
+            if (screen_config.contains("universe")) {
+                if (!db_manager.isConnected() && !db_manager.connect()) {
+                    throw core::DataLoadException("Failed to connect to DB to resolve the screen universe.");
+                }
+                screen_config = backtester::Backtester::resolveUniverse(db_manager, screen_config, start_date);
+            }
+            backtester::ScreenerRun screen(candle_source);
+            const auto result = screen.run(screen_config, start_date, end_date, screen_last_bar);
+            backtester::ScreenerRun::logResult(result, screen_show);
+            const bool written = screen_output_path.empty() || backtester::ScreenerRun::writeCsv(screen_output_path, result);
+            logger->info("Trading Platform CLI finished.");
+            return written ? 0 : 1;
+        }
+        // Written on its own thread while the runs go on; close() waits for the last block
+        std::shared_ptr<backtester::ResultsWriter> results_writer;
+        if (!results_path.empty()) results_writer = std::make_shared<backtester::ResultsWriter>(results_path);
 
+        if (!batch_dir.empty()) {
+            // Many strategy files, one candle load and one computation per distinct indicator.
+            // Index universes resolve against the candle source (SQLite has the constituents).
+            logger->info("---=== Starting Strategy Batch: {} ===---", batch_dir);
+            auto strategies = backtester::BatchRunner::loadDirectory(batch_dir);
+            backtester::BatchRunner batch(candle_source, initial_capital, num_threads);
+            if (indicator_cache) batch.setIndicatorCache(indicator_cache);
+            batch.setEvaluationMode(evaluation_mode);
+            batch.getDataCache()->setCompactStorage(compact_candles);
+            if (results_writer) batch.setResultsWriter(results_writer);
+            auto results = batch.run(strategies, start_date, end_date);
+            if (results_writer) results_writer->close();
+            backtester::BatchRunner::logResultsTable(results);
+            if (!batch_output_path.empty()) {
+                backtester::BatchRunner::writeResultsCsv(batch_output_path, results);
+            }
+            const auto failed = std::count_if(results.begin(), results.end(),
+                                              [](const backtester::BatchResult& r) { return !r.success; });
+            logger->info("---=== Strategy Batch Finished ({} runs, {} failed) ===---", results.size(), failed);
+            logger->info("Trading Platform CLI finished.");
+            return failed == 0 ? 0 : 1;
+        }
 
         // ======================================================
         // --- Run Backtest ---
@@ -117,11 +498,134 @@ int main(int argc, char* argv[]) {
         // 2. Backtest Parameters are already parsed from args
         logger->info("Backtest Parameters: Capital={:.2f}, Start={}, End={}", initial_capital, start_date, end_date);
 
+        // Index universes are always resolved against SQLite (the columnar store has no
+        // constituents table), before any run so every backtest sees the same instruments.
+        if (strategy_config.contains("universe")) {
+            if (!db_manager.isConnected() && !db_manager.connect()) {
+                throw core::DataLoadException("Failed to connect to DB to resolve the strategy universe.");
+            }
+            strategy_config = backtester::Backtester::resolveUniverse(db_manager, strategy_config, start_date);
+        }
+
+        if (*replay_cmd) {
+            // Latency benchmark of the live path: feed decode, bar assembly, engine, signal out
+            for (const auto& limit : replay_limits) {
+                const auto eq = limit.find('=');
+                double microseconds = 0.0;
+                try {
+                    if (eq == std::string::npos) throw std::invalid_argument(limit);
+                    microseconds = std::stod(limit.substr(eq + 1));
+                } catch (const std::exception&) {
+                    throw core::ConfigException("--max-p99-us expects stage=microseconds, got '" + limit + "'.");
+                }
+                replay_options.max_p99_ns[limit.substr(0, eq)] = static_cast<std::int64_t>(microseconds * 1e3);
+            }
+            live::LiveSignalEngine engine(strategy_config);
+            live::FeedRecording recording;
+            if (!replay_recording.empty()) {
+                auto loaded = live::FeedRecording::load(replay_recording);
+                if (!loaded) return 1;
+                recording = std::move(*loaded);
+            } else {
+                // Stored candles become feed messages, so they take the same decode and assembly path as live ticks
+                if (!candle_source.connect()) {
+                    logger->critical("Failed to connect to the candle source for replay.");
+                    return 1;
+                }
+                const auto [query_start, query_end] = backtester::Backtester::queryRangeForDates(start_date, end_date);
+                std::vector<core::CandleSeries> series;
+                for (const auto& key : engine.instruments()) {
+                    series.push_back(candle_source.queryCandleSeries(key, engine.timeframe(), query_start, query_end));
+                    logger->info("  {}: {} {} candle(s)", key, series.back().size(), engine.timeframe());
+                }
+                recording = live::FeedRecording::fromCandles(engine.instruments(), series, engine.timeframe(),
+                                                             replay_ticks_per_bar, replay_options.feed.sessions);
+                if (!replay_save_path.empty() && !recording.save(replay_save_path)) return 1;
+            }
+            live::ReplayHarness harness(engine, replay_options);
+            const live::ReplayReport report = harness.run(recording);
+            report.log();
+            engine.logLatencyReport();
+            if (!replay_report_path.empty() && !report.writeJson(replay_report_path)) return 1;
+            if (!replay_hgrm_dir.empty() && !report.writeHistograms(replay_hgrm_dir)) return 1;
+            logger->info("---=== Replay Finished ({}) ===---", report.passed() ? "passed" : "FAILED");
+            logger->info("Trading Platform CLI finished.");
+            return report.passed() ? 0 : 1;
+        }
+
+        if (walk_forward_mode) {
+            // 3a. Walk-forward: optimize on each in-sample window, test on the window after it
+            backtester::WalkForwardSpec spec = backtester::WalkForward::parseSpec(strategy_config);
+            backtester::WalkForward walk_forward(candle_source, initial_capital, num_threads);
+            if (indicator_cache) walk_forward.setIndicatorCache(indicator_cache);
+            walk_forward.setEvaluationMode(evaluation_mode);
+            walk_forward.getDataCache()->setCompactStorage(compact_candles);
+            auto result = walk_forward.run(spec, start_date, end_date);
+            backtester::WalkForward::logResults(result, spec);
+            if (!walk_forward_output_path.empty()) {
+                backtester::WalkForward::writeEquityCsv(walk_forward_output_path, result);
+            }
+            logger->info("---=== Walk-Forward Finished ({} windows) ===---", result.windows.size());
+            logger->info("Trading Platform CLI finished.");
+            return 0;
+        }
+
+        if (sweep_mode) {
+            // 3b. Parameter sweep: many backtests over one shared data load
+            backtester::SweepSpec spec = backtester::ParameterSweep::parseSpec(strategy_config);
+            if (!distributed_options.workers.empty()) {
+                // Same grid, run on remote workers against their own candle data
+                if (distributed_options.shared_secret.empty()) {
+                    if (const char* env_secret = std::getenv("TP_SWEEP_SECRET")) distributed_options.shared_secret = env_secret;
+                }
+                server::DistributedSweep distributed(distributed_options, initial_capital);
+                auto results = distributed.run(spec, start_date, end_date);
+                backtester::ParameterSweep::logResultsTable(results, spec);
+                const bool written = sweep_output_path.empty() ||
+                                     backtester::ParameterSweep::writeResultsCsv(sweep_output_path, results);
+                logger->info("---=== Distributed Parameter Sweep Finished ({} runs) ===---", results.size());
+                logger->info("Trading Platform CLI finished.");
+                return written ? 0 : 1;
+            }
+            backtester::ParameterSweep sweep(candle_source, initial_capital, num_threads);
+            if (indicator_cache) sweep.setIndicatorCache(indicator_cache);
+            sweep.setEvaluationMode(evaluation_mode);
+            sweep.getDataCache()->setCompactStorage(compact_candles);
+            if (results_writer) sweep.setResultsWriter(results_writer);
+            auto results = sweep.run(spec, start_date, end_date);
+            if (results_writer) results_writer->close();
+            backtester::ParameterSweep::logResultsTable(results, spec);
+            const bool written = sweep_output_path.empty() ||
+                                 backtester::ParameterSweep::writeResultsCsv(sweep_output_path, results);
+            logger->info("---=== Parameter Sweep Finished ({} runs) ===---", results.size());
+            logger->info("Trading Platform CLI finished.");
+            return written ? 0 : 1;
+        }
+
 
         // 3. Create and Run Backtester
-        backtester::Backtester the_backtester(db_manager, initial_capital); // Use parsed capital
+        backtester::Backtester the_backtester(candle_source, initial_capital); // Use parsed capital
+        if (indicator_cache) the_backtester.setIndicatorCache(indicator_cache);
+        the_backtester.setEvaluationMode(evaluation_mode);
+        the_backtester.setInstrumentThreads(num_threads);
+        if (stream_chunk_bars > 0) {
+            backtester::StreamingOptions streaming;
+            streaming.chunk_bars = stream_chunk_bars;
+            streaming.warmup_bars = stream_warmup_bars;
+            the_backtester.setStreaming(streaming);
+        }
         bool success = the_backtester.run(strategy_config, start_date, end_date); // Use parsed dates
 
+        const auto& run_stats = the_backtester.getRunStats();
+        run_stats.logSummary();
+        if (!stats_json_path.empty()) run_stats.writeJson(stats_json_path);
+        if (!trace_path.empty()) run_stats.writeChromeTrace(trace_path);
+        if (results_writer) {
+            results_writer->write(strategy_config.value("strategy_name", strategy_file_path), success,
+                                  the_backtester.getMetrics(), the_backtester.getPortfolio());
+            results_writer->close();
+        }
+
         if (success) {
              logger->info("---=== Backtest Run Finished Successfully ===---");
              // TODO: Print final metrics from backtester result more formally
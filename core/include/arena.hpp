@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <utility>
+
+namespace core {
+
+    // --- Arena ---
+    // Monotonic memory for objects that live exactly as long as one run: a strategy's
+    // rule and condition tree, a backtest's equity curve, trade log and snapshot
+    // buffers. Allocating bumps a pointer inside the current block, deallocating does
+    // nothing, and release() hands everything back at once. Objects allocated one
+    // after another sit next to each other in memory.
+    //
+    // The first block survives release() and is grown to what the previous cycle
+    // used, so a run that repeats (sweep iterations) settles on a single block and
+    // stops calling the system allocator.
+    //
+    // Not thread-safe: allocate from one thread at a time.
+    class Arena {
+    public:
+        static constexpr std::size_t kDefaultInitialBytes = 64 * 1024;
+
+        explicit Arena(std::size_t initial_bytes = kDefaultInitialBytes);
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        std::pmr::memory_resource* resource() { return &*buffer_; }
+
+        // Frees every allocation. Objects placed in the arena must be destroyed
+        // (see ArenaPtr) before this is called.
+        void release();
+
+        std::size_t blockSize() const { return block_size_; }
+        // Bytes taken from the system allocator beyond the first block since the last release()
+        std::size_t overflowBytes() const { return upstream_.allocated(); }
+
+    private:
+        // Upstream of the monotonic resource; counts what it needs past the first block
+        class CountingResource : public std::pmr::memory_resource {
+        public:
+            std::size_t allocated() const { return allocated_; }
+            void reset() { allocated_ = 0; }
+        private:
+            void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+            void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+            std::size_t allocated_ = 0;
+        };
+
+        CountingResource upstream_;
+        std::unique_ptr<std::byte[]> block_;
+        std::size_t block_size_;
+        std::optional<std::pmr::monotonic_buffer_resource> buffer_;
+    };
+
+    // Deleter for makeArenaPtr objects: arena objects are destroyed in place (their
+    // memory comes back with Arena::release()), heap objects are deleted
+    struct ArenaDelete {
+        bool in_arena = false;
+
+        template <typename T>
+        void operator()(T* object) const {
+            if (in_arena) {
+                object->~T();
+            } else {
+                delete object;
+            }
+        }
+    };
+
+    template <typename T>
+    using ArenaPtr = std::unique_ptr<T, ArenaDelete>;
+
+    // Creates a T in 'arena', or with new if 'arena' is null. Types with an
+    // allocator_type (std::pmr::polymorphic_allocator<>) get the arena's allocator
+    // as their trailing constructor argument, so their strings and vectors land in
+    // the arena too.
+    template <typename T, typename... Args>
+    ArenaPtr<T> makeArenaPtr(Arena* arena, Args&&... args) {
+        if (!arena) return ArenaPtr<T>(new T(std::forward<Args>(args)...), ArenaDelete{false});
+        std::pmr::polymorphic_allocator<> allocator(arena->resource());
+        return ArenaPtr<T>(allocator.new_object<T>(std::forward<Args>(args)...), ArenaDelete{true});
+    }
+
+    // Memory resource for containers that belong in 'arena' (the default resource if null)
+    inline std::pmr::memory_resource* arenaResource(Arena* arena) {
+        return arena ? arena->resource() : std::pmr::get_default_resource();
+    }
+
+} // namespace core
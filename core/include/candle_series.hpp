@@ -0,0 +1,96 @@
+#pragma once
+
+#include "datatypes.hpp" // Candle, TimeSeries, Timestamp
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace core {
+
+    // Sentinel stored in the open interest column for candles without OI
+    inline constexpr std::int64_t kNoOpenInterest = INT64_MIN;
+
+    // --- CandleSeries ---
+    // Immutable structure-of-arrays view of a candle series: contiguous columns for
+    // timestamps (ns since epoch, UTC), open/high/low/close and volume, plus an
+    // optional open interest column. Indicators read the columns directly (e.g.
+    // close() straight into TA-Lib), so no per-indicator price buffer is needed.
+    //
+    // The columns are kept alive by a shared owner, which is either vectors built by
+    // CandleSeries::Builder or external memory such as an mmap-ed columnar file.
+    // Copies and slices are cheap and share the same storage.
+    class CandleSeries {
+    public:
+        class Builder;
+
+        CandleSeries() = default;
+
+        // Copies AoS candles into owned columns
+        static CandleSeries fromCandles(const TimeSeries<Candle>& candles);
+
+        // Wraps external columns without copying. All spans must have the same length
+        // (open_interest may be empty) and stay valid while 'owner' is alive.
+        CandleSeries(std::shared_ptr<const void> owner,
+                     std::span<const std::int64_t> timestamps_ns,
+                     std::span<const double> open,
+                     std::span<const double> high,
+                     std::span<const double> low,
+                     std::span<const double> close,
+                     std::span<const double> volume,
+                     std::span<const std::int64_t> open_interest = {});
+
+        std::size_t size() const { return timestamps_ns_.size(); }
+        bool empty() const { return timestamps_ns_.empty(); }
+
+        std::span<const std::int64_t> timestampsNs() const { return timestamps_ns_; }
+        std::span<const double> open() const { return open_; }
+        std::span<const double> high() const { return high_; }
+        std::span<const double> low() const { return low_; }
+        std::span<const double> close() const { return close_; }
+        std::span<const double> volume() const { return volume_; }
+        std::span<const std::int64_t> openInterest() const { return open_interest_; } // Empty if absent
+        bool hasOpenInterest() const { return !open_interest_.empty(); }
+
+        Timestamp timestamp(std::size_t i) const {
+            return Timestamp(std::chrono::duration_cast<Timestamp::duration>(std::chrono::nanoseconds(timestamps_ns_[i])));
+        }
+
+        // Materializes row i as a Candle (for code that still works on whole candles)
+        Candle at(std::size_t i) const;
+        TimeSeries<Candle> toCandles() const;
+
+        // Rows [first, last), sharing storage with this series
+        CandleSeries slice(std::size_t first, std::size_t last) const;
+
+    private:
+        std::shared_ptr<const void> owner_;
+        std::span<const std::int64_t> timestamps_ns_;
+        std::span<const double> open_;
+        std::span<const double> high_;
+        std::span<const double> low_;
+        std::span<const double> close_;
+        std::span<const double> volume_;
+        std::span<const std::int64_t> open_interest_;
+    };
+
+    // Appends candles column by column; build() hands the columns to a CandleSeries.
+    class CandleSeries::Builder {
+    public:
+        void reserve(std::size_t n);
+        void push_back(const Candle& candle);
+        std::size_t size() const { return timestamps_ns_.size(); }
+
+        CandleSeries build(); // Leaves the builder empty
+
+    private:
+        std::vector<std::int64_t> timestamps_ns_;
+        std::vector<double> open_, high_, low_, close_, volume_;
+        std::vector<std::int64_t> open_interest_;
+        bool has_open_interest_ = false;
+    };
+
+} // namespace core
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace core {
+
+    // --- LatencyHistogram ---
+    // Fixed-size log-linear histogram of nanosecond durations (HdrHistogram layout:
+    // 32 linear sub-buckets per power of two). Values below 64 ns are exact, larger
+    // ones are kept within ~3%; anything above ~36 minutes lands in the last bucket.
+    // record() is a few integer ops and never allocates, so it can sit on a hot path.
+    // Not thread-safe: one writer, read after that thread is done (or merge copies).
+    class LatencyHistogram {
+    public:
+        void record(std::int64_t nanoseconds);
+        void merge(const LatencyHistogram& other);
+        void reset();
+
+        std::uint64_t count() const { return count_; }
+        std::int64_t min() const { return count_ ? min_ : 0; }
+        std::int64_t max() const { return max_; }
+        double mean() const { return count_ ? static_cast<double>(sum_) / static_cast<double>(count_) : 0.0; }
+        // Smallest recorded bucket bound with at least 'percentile' % of samples at or
+        // below it (e.g. 99.9), reported as the bucket's upper bound; 0 if empty
+        std::int64_t percentile(double percentile) const;
+
+        // "n=... p50=...us p99=...us p99.9=...us max=...us"
+        std::string summary() const;
+        // HdrHistogram's percentile distribution text (.hgrm, as read by its plotting
+        // tools), one row per non-empty bucket, values divided by 'unit_ns' (1000 = us)
+        std::string percentileDistribution(double unit_ns = 1000.0) const;
+
+    private:
+        static constexpr int kSubBucketBits = 5;
+        static constexpr std::size_t kSubBuckets = std::size_t{1} << kSubBucketBits;
+        static constexpr int kMaxExponent = 35; // Buckets are 2^35 ns wide in the top power of two
+        static constexpr std::size_t kBucketCount = (kMaxExponent + 2) * kSubBuckets;
+
+        static std::size_t bucketIndex(std::uint64_t value);
+        static std::int64_t bucketUpperBound(std::size_t index);
+
+        std::array<std::uint64_t, kBucketCount> buckets_{};
+        std::uint64_t count_ = 0;
+        std::int64_t min_ = 0;
+        std::int64_t max_ = 0;
+        std::int64_t sum_ = 0;
+    };
+
+} // namespace core
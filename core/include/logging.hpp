@@ -19,4 +19,39 @@ namespace logging {
     spdlog::level::level_enum level_from_string(const std::string& level_str);
 
 } // namespace logging
-} // namespace core
\ No newline at end of file
+} // namespace core
+
+// --- Hot-path logging macros ---
+// Unlike logger->trace(...), the arguments are only evaluated when the level is
+// enabled, and levels below TP_LOG_ACTIVE_LEVEL (an SPDLOG_LEVEL_* value) are
+// compiled out entirely. Modules with per-bar code get the floor from the
+// TP_HOT_PATH_LOG_LEVEL CMake option; elsewhere nothing is compiled out.
+#ifndef TP_LOG_ACTIVE_LEVEL
+#define TP_LOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+#endif
+
+#define TP_LOG_AT(level, ...)                                             \
+    do {                                                                  \
+        auto& tp_log_logger_ = ::core::logging::getLogger();              \
+        if (tp_log_logger_->should_log(level)) {                          \
+            tp_log_logger_->log(level, __VA_ARGS__);                      \
+        }                                                                 \
+    } while (0)
+
+#if TP_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
+#define TP_LOG_TRACE(...) TP_LOG_AT(spdlog::level::trace, __VA_ARGS__)
+#else
+#define TP_LOG_TRACE(...) (void)0
+#endif
+
+#if TP_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG
+#define TP_LOG_DEBUG(...) TP_LOG_AT(spdlog::level::debug, __VA_ARGS__)
+#else
+#define TP_LOG_DEBUG(...) (void)0
+#endif
+
+#if TP_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_INFO
+#define TP_LOG_INFO(...) TP_LOG_AT(spdlog::level::info, __VA_ARGS__)
+#else
+#define TP_LOG_INFO(...) (void)0
+#endif
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+
+namespace core {
+
+    // --- SnapshotHandoff ---
+    // Consistent copies of state that one worker thread owns and writes without locks
+    // (e.g. its LatencyHistograms), for readers on other threads. A reader request()s
+    // a copy and blocks until the worker's next serve(), which fills it under the
+    // handoff's lock. The worker calls serve() once per loop iteration, where it costs
+    // one atomic load while nobody asks, so the worker's hot path stays lock-free.
+    //
+    // The handoff is open from before the worker starts (open()) until after its last
+    // serve() (close()). Outside that window request() returns nullopt at once: the
+    // worker no longer writes, and the reader copies the state itself.
+    template <typename Snapshot>
+    class SnapshotHandoff {
+    public:
+        // Before starting the worker (on the starting thread)
+        void open() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            open_ = true;
+        }
+
+        // Worker thread, after its last serve(): waiting readers return nullopt
+        void close() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                open_ = false;
+                requested_.store(false, std::memory_order_relaxed);
+            }
+            ready_.notify_all();
+        }
+
+        // Worker thread: runs 'fill(Snapshot&)' if a reader is waiting
+        template <typename Fill>
+        void serve(Fill&& fill) {
+            if (!requested_.load(std::memory_order_acquire)) return;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                fill(snapshot_);
+                requested_.store(false, std::memory_order_relaxed);
+                ++served_;
+            }
+            ready_.notify_all();
+        }
+
+        // Any thread: a copy filled after this call started, or nullopt if the
+        // handoff is (or becomes) closed first
+        std::optional<Snapshot> request() {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (!open_) return std::nullopt;
+            const std::uint64_t target = served_ + 1;
+            requested_.store(true, std::memory_order_release);
+            ready_.wait(lock, [&] { return served_ >= target || !open_; });
+            if (served_ < target) return std::nullopt;
+            return snapshot_;
+        }
+
+    private:
+        std::mutex mutex_;
+        std::condition_variable ready_;
+        std::atomic<bool> requested_{false};
+        bool open_ = false;        // Guarded by mutex_
+        std::uint64_t served_ = 0; // Guarded by mutex_
+        Snapshot snapshot_;        // Guarded by mutex_
+    };
+
+} // namespace core
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+namespace core {
+
+    // Size of the cache line the queue indices are padded to (no false sharing)
+    inline constexpr std::size_t kCacheLineSize = 64;
+
+    // --- SpscQueue ---
+    // Bounded lock-free ring buffer for exactly one producer thread and one consumer
+    // thread. tryPush()/tryPop() never block or allocate; a full queue rejects the
+    // push and the caller decides whether to drop, retry or count it.
+    //
+    // Each side owns one index and keeps a cached copy of the other, so the shared
+    // cache line is only read when the cached value says the queue looks full/empty.
+    template <typename T>
+    class SpscQueue {
+        static_assert(std::is_nothrow_copy_assignable_v<T> || std::is_nothrow_move_assignable_v<T>,
+                      "SpscQueue elements must be assignable without throwing");
+
+    public:
+        // Capacity is rounded up to a power of two (at least 2)
+        explicit SpscQueue(std::size_t capacity)
+            : capacity_(roundUpToPowerOfTwo(capacity)), mask_(capacity_ - 1),
+              slots_(std::make_unique<T[]>(capacity_)) {}
+
+        SpscQueue(const SpscQueue&) = delete;
+        SpscQueue& operator=(const SpscQueue&) = delete;
+
+        // Producer side
+        bool tryPush(const T& value) {
+            const std::size_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail - cached_head_ == capacity_) {
+                cached_head_ = head_.load(std::memory_order_acquire);
+                if (tail - cached_head_ == capacity_) return false; // Full
+            }
+            slots_[tail & mask_] = value;
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer side
+        bool tryPop(T& out) {
+            const std::size_t head = head_.load(std::memory_order_relaxed);
+            if (head == cached_tail_) {
+                cached_tail_ = tail_.load(std::memory_order_acquire);
+                if (head == cached_tail_) return false; // Empty
+            }
+            out = std::move(slots_[head & mask_]);
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Approximate when called while the other side is active, but always in
+        // 0..capacity(): head_ is read first, so the later tail_ is never behind it
+        // (reading tail_ first could wrap the unsigned difference to a huge value);
+        // the producer may have refilled popped slots meanwhile, hence the clamp.
+        std::size_t sizeApprox() const {
+            const std::size_t head = head_.load(std::memory_order_acquire);
+            const std::size_t tail = tail_.load(std::memory_order_acquire);
+            const std::size_t size = tail - head;
+            return size < capacity_ ? size : capacity_;
+        }
+        bool emptyApprox() const { return sizeApprox() == 0; }
+        std::size_t capacity() const { return capacity_; }
+
+    private:
+        static std::size_t roundUpToPowerOfTwo(std::size_t n) {
+            if (n > (std::size_t{1} << (sizeof(std::size_t) * 8 - 2))) {
+                throw std::invalid_argument("SpscQueue capacity too large.");
+            }
+            std::size_t capacity = 2;
+            while (capacity < n) capacity <<= 1;
+            return capacity;
+        }
+
+        const std::size_t capacity_;
+        const std::size_t mask_;
+        std::unique_ptr<T[]> slots_;
+
+        // Consumer-owned
+        alignas(kCacheLineSize) std::atomic<std::size_t> head_{0};
+        std::size_t cached_tail_ = 0;
+        // Producer-owned
+        alignas(kCacheLineSize) std::atomic<std::size_t> tail_{0};
+        std::size_t cached_head_ = 0;
+    };
+
+} // namespace core
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace core {
+
+    // --- ThreadPool ---
+    // Fixed-size pool of worker threads pulling tasks from a shared FIFO queue.
+    // submit() returns a future so callers can collect results (and exceptions).
+    class ThreadPool {
+    public:
+        // num_threads == 0 uses std::thread::hardware_concurrency()
+        explicit ThreadPool(std::size_t num_threads = 0);
+        ~ThreadPool(); // Drains queued tasks, then joins all workers
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        template <typename F>
+        auto submit(F&& task) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+            using Result = std::invoke_result_t<std::decay_t<F>>;
+            // packaged_task is move-only; share it so the queue can hold a std::function
+            auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+            std::future<Result> future = packaged->get_future();
+            enqueue([packaged]() { (*packaged)(); });
+            return future;
+        }
+
+        std::size_t size() const { return workers_.size(); }
+
+        // Resolves a user-supplied thread count (0 -> hardware concurrency, at least 1)
+        static std::size_t resolveThreadCount(std::size_t requested);
+
+    private:
+        void enqueue(std::function<void()> task);
+        void workerLoop();
+
+        std::vector<std::thread> workers_;
+        std::queue<std::function<void()>> tasks_;
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        bool stopping_ = false;
+    };
+
+} // namespace core
@@ -2,17 +2,56 @@
 
 #include "datatypes.hpp" // Include datatypes if utils operate on them
 #include <string>
+#include <string_view>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 
 namespace core {
 namespace utils {
 
     // Example utility: Convert Timestamp to ISO 8601 string
+    // Always IST with whole seconds: "YYYY-MM-DDTHH:MM:SS+05:30" (the DB format)
     std::string timestampToString(const Timestamp& ts);
 
     // Example utility: Parse ISO 8601 string to Timestamp
+    // Throws std::runtime_error if parseTimestamp() rejects the text.
     Timestamp stringToTimestamp(const std::string& iso_string);
 
+    // Length of what formatTimestamp() writes (no terminator)
+    inline constexpr std::size_t kTimestampStringLength = 25;
+
+    // Allocation-free timestampToString(): writes exactly kTimestampStringLength
+    // characters to 'out' and returns the end pointer. Four-digit years only.
+    char* formatTimestamp(const Timestamp& ts, char* out);
+
+    // Allocation-free, non-throwing stringToTimestamp() for the fixed form
+    // YYYY-MM-DDTHH:MM:SS[.fraction](+HH:MM|-HH:MM|Z), every field fixed-width
+    // (the offset too: "+5:30" is rejected). Fractions keep up to 9 digits (exactly,
+    // in integer nanoseconds); out-of-range days roll over into the next month like
+    // timegm(); text after the offset is ignored, unless "+HH:MM" runs on in a digit.
+    // Returns false (leaving 'out' untouched) if the text does not match.
+    bool parseTimestamp(std::string_view text, Timestamp& out);
+
+    // Lossless conversion to/from nanoseconds since the Unix epoch (UTC), as stored in
+    // INTEGER timestamp columns. Inline because it runs once per row on DB reads/writes.
+    inline std::int64_t timestampToEpochNanos(const Timestamp& ts) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(ts.time_since_epoch()).count();
+    }
+    inline Timestamp epochNanosToTimestamp(std::int64_t nanos) {
+        return Timestamp(std::chrono::duration_cast<Timestamp::duration>(std::chrono::nanoseconds(nanos)));
+    }
+
+    // Calendar dates as used on the command line and in date-range tables (YYYY-MM-DD).
+    // parseDate throws std::invalid_argument on anything else, including impossible dates.
+    std::chrono::sys_days parseDate(const std::string& yyyy_mm_dd);
+    std::string formatDate(std::chrono::sys_days date);
+
+    // Temporary name next to 'path' for write-then-rename: "<path>.<pid>-<salt>-<n>.tmp",
+    // unique per process and per call, so processes storing the same file at once
+    // never write into (or publish) each other's temporary file
+    std::string uniqueTempPath(const std::string& path);
+
     // Add other common utilities here (e.g., string manipulation, math helpers)
 
 } // namespace utils
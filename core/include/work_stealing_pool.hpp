@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace core {
+
+    // --- WorkStealingPool ---
+    // Thread pool with one task deque per worker. A task submitted from inside a
+    // worker goes to that worker's own deque (newest first, so follow-up work runs
+    // while its inputs are still in cache); tasks from other threads are dealt out
+    // round-robin. An idle worker steals the oldest task of another worker, so a
+    // few long tasks do not leave the rest of the pool waiting behind one queue.
+    //
+    // Same submit() contract as ThreadPool. Tasks must not block on futures of
+    // other tasks in the same pool; chain follow-up work by submitting it instead.
+    class WorkStealingPool {
+    public:
+        // num_threads == 0 uses std::thread::hardware_concurrency()
+        explicit WorkStealingPool(std::size_t num_threads = 0);
+        ~WorkStealingPool(); // Runs every queued task (including ones they submit), then joins
+
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+        template <typename F>
+        auto submit(F&& task) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+            using Result = std::invoke_result_t<std::decay_t<F>>;
+            auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+            std::future<Result> future = packaged->get_future();
+            enqueue([packaged]() { (*packaged)(); });
+            return future;
+        }
+
+        std::size_t size() const { return workers_.size(); }
+
+    private:
+        struct TaskQueue {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        void enqueue(std::function<void()> task);
+        // Own deque from the back, then the others from the front; false if all were empty
+        bool tryRunOne(std::size_t self);
+        void workerLoop(std::size_t index);
+
+        std::vector<std::unique_ptr<TaskQueue>> queues_;
+        std::vector<std::thread> workers_;
+        std::atomic<std::size_t> next_queue_{0}; // Round-robin target for external submits
+
+        std::mutex sleep_mutex_;
+        std::condition_variable cv_;
+        std::atomic<std::size_t> queued_{0}; // Tasks in all deques; incremented under sleep_mutex_
+        bool stopping_ = false;              // Guarded by sleep_mutex_
+    };
+
+} // namespace core
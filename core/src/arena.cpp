@@ -0,0 +1,35 @@
+#include "arena.hpp"
+
+namespace core {
+
+    Arena::Arena(std::size_t initial_bytes)
+        : block_(new std::byte[initial_bytes > 0 ? initial_bytes : 1]),
+          block_size_(initial_bytes > 0 ? initial_bytes : 1)
+    {
+        buffer_.emplace(block_.get(), block_size_, &upstream_);
+    }
+
+    void Arena::release() {
+        buffer_->release(); // Returns the overflow blocks to upstream_, rewinds the first block
+        if (upstream_.allocated() == 0) return;
+
+        // The last cycle did not fit: start the next one with a block that would have held it
+        const std::size_t wanted = block_size_ + upstream_.allocated();
+        buffer_.reset();
+        block_.reset(new std::byte[wanted]);
+        block_size_ = wanted;
+        upstream_.reset();
+        buffer_.emplace(block_.get(), block_size_, &upstream_);
+    }
+
+    void* Arena::CountingResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+        void* p = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        allocated_ += bytes;
+        return p;
+    }
+
+    void Arena::CountingResource::do_deallocate(void* p, std::size_t bytes, std::size_t alignment) {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+} // namespace core
@@ -0,0 +1,120 @@
+#include "candle_series.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+namespace core {
+
+    namespace { // File-local helpers
+
+        // Owned storage behind series produced by the Builder
+        struct OwnedColumns {
+            std::vector<std::int64_t> timestamps_ns;
+            std::vector<double> open, high, low, close, volume;
+            std::vector<std::int64_t> open_interest;
+        };
+
+    } // end anonymous namespace
+
+    CandleSeries::CandleSeries(std::shared_ptr<const void> owner,
+                               std::span<const std::int64_t> timestamps_ns,
+                               std::span<const double> open,
+                               std::span<const double> high,
+                               std::span<const double> low,
+                               std::span<const double> close,
+                               std::span<const double> volume,
+                               std::span<const std::int64_t> open_interest)
+        : owner_(std::move(owner)),
+          timestamps_ns_(timestamps_ns),
+          open_(open), high_(high), low_(low), close_(close), volume_(volume),
+          open_interest_(open_interest)
+    {
+        const std::size_t n = timestamps_ns_.size();
+        if (open_.size() != n || high_.size() != n || low_.size() != n || close_.size() != n || volume_.size() != n ||
+            (!open_interest_.empty() && open_interest_.size() != n)) {
+            throw std::invalid_argument("CandleSeries columns must all have the same length.");
+        }
+    }
+
+    CandleSeries CandleSeries::fromCandles(const TimeSeries<Candle>& candles) {
+        Builder builder;
+        builder.reserve(candles.size());
+        for (const auto& candle : candles) builder.push_back(candle);
+        return builder.build();
+    }
+
+    Candle CandleSeries::at(std::size_t i) const {
+        Candle candle;
+        candle.timestamp = timestamp(i);
+        candle.open = open_[i];
+        candle.high = high_[i];
+        candle.low = low_[i];
+        candle.close = close_[i];
+        candle.volume = static_cast<long long>(volume_[i]);
+        if (!open_interest_.empty() && open_interest_[i] != kNoOpenInterest) {
+            candle.open_interest = open_interest_[i];
+        }
+        return candle;
+    }
+
+    TimeSeries<Candle> CandleSeries::toCandles() const {
+        TimeSeries<Candle> candles;
+        candles.reserve(size());
+        for (std::size_t i = 0; i < size(); ++i) candles.push_back(at(i));
+        return candles;
+    }
+
+    CandleSeries CandleSeries::slice(std::size_t first, std::size_t last) const {
+        if (first > last || last > size()) {
+            throw std::out_of_range("CandleSeries::slice range out of bounds.");
+        }
+        const std::size_t n = last - first;
+        return CandleSeries(owner_,
+                            timestamps_ns_.subspan(first, n),
+                            open_.subspan(first, n), high_.subspan(first, n),
+                            low_.subspan(first, n), close_.subspan(first, n),
+                            volume_.subspan(first, n),
+                            open_interest_.empty() ? open_interest_ : open_interest_.subspan(first, n));
+    }
+
+    // --- Builder ---
+
+    void CandleSeries::Builder::reserve(std::size_t n) {
+        timestamps_ns_.reserve(n);
+        open_.reserve(n);
+        high_.reserve(n);
+        low_.reserve(n);
+        close_.reserve(n);
+        volume_.reserve(n);
+        open_interest_.reserve(n);
+    }
+
+    void CandleSeries::Builder::push_back(const Candle& candle) {
+        timestamps_ns_.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(candle.timestamp.time_since_epoch()).count());
+        open_.push_back(candle.open);
+        high_.push_back(candle.high);
+        low_.push_back(candle.low);
+        close_.push_back(candle.close);
+        volume_.push_back(static_cast<double>(candle.volume));
+        open_interest_.push_back(candle.open_interest.value_or(kNoOpenInterest));
+        has_open_interest_ |= candle.open_interest.has_value();
+    }
+
+    CandleSeries CandleSeries::Builder::build() {
+        auto columns = std::make_shared<OwnedColumns>();
+        columns->timestamps_ns = std::move(timestamps_ns_);
+        columns->open = std::move(open_);
+        columns->high = std::move(high_);
+        columns->low = std::move(low_);
+        columns->close = std::move(close_);
+        columns->volume = std::move(volume_);
+        if (has_open_interest_) columns->open_interest = std::move(open_interest_);
+        *this = Builder{};
+
+        // Spans into the vectors stay valid: the vectors are never modified again
+        return CandleSeries(columns,
+                            columns->timestamps_ns, columns->open, columns->high, columns->low,
+                            columns->close, columns->volume, columns->open_interest);
+    }
+
+} // namespace core
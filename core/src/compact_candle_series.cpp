@@ -0,0 +1,146 @@
+#include "compact_candle_series.hpp"
+
+#include <cmath>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <span>
+
+namespace core {
+
+    namespace { // File-local helpers
+
+        // Columns behind a decoded series
+        struct DecodedColumns {
+            std::vector<std::int64_t> timestamps_ns;
+            std::vector<double> open, high, low, close, volume;
+            std::vector<std::int64_t> open_interest;
+        };
+
+        // Ticks per price unit for 'tick_size' if that is a whole number (0.05 -> 20)
+        std::optional<std::int64_t> wholeReciprocal(double tick_size) {
+            if (!(tick_size > 0.0)) return std::nullopt;
+            const double reciprocal = 1.0 / tick_size;
+            const double rounded = std::round(reciprocal);
+            if (rounded < 1.0 || rounded > 1e9 || std::fabs(reciprocal - rounded) > 1e-9 * rounded) return std::nullopt;
+            return static_cast<std::int64_t>(rounded);
+        }
+
+        // Fills 'out' with ticks that divide back to exactly the input prices
+        bool encodePrices(std::span<const double> prices, std::int64_t ticks_per_unit, std::vector<std::int32_t>& out) {
+            const double scale = static_cast<double>(ticks_per_unit);
+            out.resize(prices.size());
+            for (std::size_t i = 0; i < prices.size(); ++i) {
+                const double ticks = std::round(prices[i] * scale);
+                // Rejects NaN too
+                if (!(ticks >= std::numeric_limits<std::int32_t>::min() && ticks <= std::numeric_limits<std::int32_t>::max())) {
+                    return false;
+                }
+                const auto value = static_cast<std::int32_t>(ticks);
+                if (static_cast<double>(value) / scale != prices[i]) return false;
+                out[i] = value;
+            }
+            return true;
+        }
+
+        void decodePrices(const std::vector<std::int32_t>& ticks, std::int64_t ticks_per_unit, std::vector<double>& out) {
+            const double scale = static_cast<double>(ticks_per_unit);
+            out.resize(ticks.size());
+            for (std::size_t i = 0; i < ticks.size(); ++i) out[i] = static_cast<double>(ticks[i]) / scale;
+        }
+
+        template <typename T>
+        std::size_t heapBytes(const std::vector<T>& column) { return column.capacity() * sizeof(T); }
+
+    } // end anonymous namespace
+
+    std::optional<CompactCandleSeries> CompactCandleSeries::encode(const CandleSeries& series, double tick_size) {
+        CompactCandleSeries compact;
+        const std::size_t n = series.size();
+        if (n == 0) return compact;
+
+        // Timestamps: coarsest unit that every (non-negative) delta is a multiple of
+        const auto timestamps = series.timestampsNs();
+        compact.first_timestamp_ns_ = timestamps[0];
+        bool timestamps_fit = false;
+        for (std::int64_t unit : {1'000'000'000LL, 1'000'000LL, 1'000LL, 1LL}) {
+            compact.time_deltas_.assign(n, 0);
+            bool fits = true;
+            for (std::size_t i = 1; i < n && fits; ++i) {
+                const std::int64_t delta = timestamps[i] - timestamps[i - 1];
+                fits = delta >= 0 && delta % unit == 0 && delta / unit <= std::numeric_limits<std::uint32_t>::max();
+                if (fits) compact.time_deltas_[i] = static_cast<std::uint32_t>(delta / unit);
+            }
+            if (fits) {
+                compact.time_unit_ns_ = unit;
+                timestamps_fit = true;
+                break;
+            }
+        }
+        if (!timestamps_fit) return std::nullopt; // Unsorted, or gaps too long for the unit
+
+        // Prices: the instrument's tick first, then decimal steps
+        std::vector<std::int64_t> candidates;
+        if (auto ticks_per_unit = wholeReciprocal(tick_size)) candidates.push_back(*ticks_per_unit);
+        for (std::int64_t decimal : {1LL, 10LL, 100LL, 1'000LL, 10'000LL}) candidates.push_back(decimal);
+        bool prices_fit = false;
+        for (std::int64_t ticks_per_unit : candidates) {
+            if (encodePrices(series.open(), ticks_per_unit, compact.open_) &&
+                encodePrices(series.high(), ticks_per_unit, compact.high_) &&
+                encodePrices(series.low(), ticks_per_unit, compact.low_) &&
+                encodePrices(series.close(), ticks_per_unit, compact.close_)) {
+                compact.ticks_per_unit_ = ticks_per_unit;
+                prices_fit = true;
+                break;
+            }
+        }
+        if (!prices_fit) return std::nullopt;
+
+        const auto volume = series.volume();
+        compact.volume_.resize(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            if (!(volume[i] >= 0.0 && volume[i] <= std::numeric_limits<std::uint32_t>::max())) return std::nullopt;
+            compact.volume_[i] = static_cast<std::uint32_t>(volume[i]);
+            if (static_cast<double>(compact.volume_[i]) != volume[i]) return std::nullopt; // Fractional volume
+        }
+
+        if (series.hasOpenInterest()) {
+            const auto open_interest = series.openInterest();
+            compact.open_interest_.assign(open_interest.begin(), open_interest.end());
+        }
+        return compact;
+    }
+
+    CandleSeries CompactCandleSeries::decode() const {
+        auto columns = std::make_shared<DecodedColumns>();
+        const std::size_t n = size();
+        columns->timestamps_ns.resize(n);
+        std::int64_t timestamp = first_timestamp_ns_;
+        for (std::size_t i = 0; i < n; ++i) {
+            timestamp += static_cast<std::int64_t>(time_deltas_[i]) * time_unit_ns_;
+            columns->timestamps_ns[i] = timestamp;
+        }
+        decodePrices(open_, ticks_per_unit_, columns->open);
+        decodePrices(high_, ticks_per_unit_, columns->high);
+        decodePrices(low_, ticks_per_unit_, columns->low);
+        decodePrices(close_, ticks_per_unit_, columns->close);
+        columns->volume.assign(volume_.begin(), volume_.end());
+        columns->open_interest = open_interest_;
+
+        // Spans into the vectors stay valid: the vectors are never modified again
+        return CandleSeries(columns,
+                            columns->timestamps_ns, columns->open, columns->high, columns->low,
+                            columns->close, columns->volume, columns->open_interest);
+    }
+
+    std::size_t CompactCandleSeries::memoryBytes() const {
+        return heapBytes(time_deltas_) + heapBytes(open_) + heapBytes(high_) + heapBytes(low_) +
+               heapBytes(close_) + heapBytes(volume_) + heapBytes(open_interest_);
+    }
+
+    std::size_t CompactCandleSeries::decodedBytes() const {
+        const std::size_t per_bar = sizeof(std::int64_t) + 5 * sizeof(double) + (hasOpenInterest() ? sizeof(std::int64_t) : 0);
+        return size() * per_bar;
+    }
+
+} // namespace core
@@ -0,0 +1,94 @@
+#include "latency_histogram.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#include "spdlog/fmt/bundled/core.h"
+
+namespace core {
+
+    std::size_t LatencyHistogram::bucketIndex(std::uint64_t value) {
+        if (value < 2 * kSubBuckets) return static_cast<std::size_t>(value); // Exact
+        const int exponent = std::bit_width(value) - 1 - kSubBucketBits;
+        if (exponent > kMaxExponent) return kBucketCount - 1;
+        const std::uint64_t mantissa = value >> exponent; // In [kSubBuckets, 2 * kSubBuckets)
+        return static_cast<std::size_t>(exponent) * kSubBuckets + static_cast<std::size_t>(mantissa);
+    }
+
+    std::int64_t LatencyHistogram::bucketUpperBound(std::size_t index) {
+        if (index < 2 * kSubBuckets) return static_cast<std::int64_t>(index);
+        const std::size_t exponent = index / kSubBuckets - 1;
+        const std::uint64_t mantissa = index % kSubBuckets + kSubBuckets;
+        return static_cast<std::int64_t>(((mantissa + 1) << exponent) - 1);
+    }
+
+    void LatencyHistogram::record(std::int64_t nanoseconds) {
+        const std::int64_t value = std::max<std::int64_t>(nanoseconds, 0);
+        ++buckets_[bucketIndex(static_cast<std::uint64_t>(value))];
+        if (count_ == 0 || value < min_) min_ = value;
+        if (value > max_) max_ = value;
+        sum_ += value;
+        ++count_;
+    }
+
+    void LatencyHistogram::merge(const LatencyHistogram& other) {
+        if (other.count_ == 0) return;
+        for (std::size_t i = 0; i < kBucketCount; ++i) buckets_[i] += other.buckets_[i];
+        min_ = (count_ == 0) ? other.min_ : std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+        sum_ += other.sum_;
+        count_ += other.count_;
+    }
+
+    void LatencyHistogram::reset() {
+        *this = LatencyHistogram{};
+    }
+
+    std::int64_t LatencyHistogram::percentile(double percentile) const {
+        if (count_ == 0) return 0;
+        const double clamped = std::clamp(percentile, 0.0, 100.0);
+        const auto target = std::max<std::uint64_t>(
+            1, static_cast<std::uint64_t>(std::ceil(clamped / 100.0 * static_cast<double>(count_))));
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < kBucketCount; ++i) {
+            seen += buckets_[i];
+            if (seen >= target) return std::min(bucketUpperBound(i), max_);
+        }
+        return max_;
+    }
+
+    std::string LatencyHistogram::summary() const {
+        return fmt::format("n={} p50={:.2f}us p99={:.2f}us p99.9={:.2f}us max={:.2f}us",
+                           count_, static_cast<double>(percentile(50.0)) / 1e3,
+                           static_cast<double>(percentile(99.0)) / 1e3,
+                           static_cast<double>(percentile(99.9)) / 1e3, static_cast<double>(max_) / 1e3);
+    }
+
+    std::string LatencyHistogram::percentileDistribution(double unit_ns) const {
+        std::string out = fmt::format("{:>12} {:>14} {:>10} {:>14}\n\n", "Value", "Percentile", "TotalCount",
+                                      "1/(1-Percentile)");
+        double variance = 0.0;
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < kBucketCount && seen < count_; ++i) {
+            if (buckets_[i] == 0) continue;
+            seen += buckets_[i];
+            const std::int64_t value = std::min(bucketUpperBound(i), max_);
+            const double deviation = static_cast<double>(value) - mean();
+            variance += deviation * deviation * static_cast<double>(buckets_[i]);
+            const double fraction = static_cast<double>(seen) / static_cast<double>(count_);
+            if (seen < count_) {
+                out += fmt::format("{:12.3f} {:1.12f} {:10d} {:14.2f}\n", static_cast<double>(value) / unit_ns,
+                                   fraction, seen, 1.0 / (1.0 - fraction));
+            } else {
+                out += fmt::format("{:12.3f} {:1.12f} {:10d}\n", static_cast<double>(value) / unit_ns, fraction, seen);
+            }
+        }
+        const double deviation = count_ ? std::sqrt(variance / static_cast<double>(count_)) : 0.0;
+        out += fmt::format("#[Mean    = {:12.3f}, StdDeviation   = {:12.3f}]\n", mean() / unit_ns, deviation / unit_ns);
+        out += fmt::format("#[Max     = {:12.3f}, Total count    = {:12d}]\n", static_cast<double>(max_) / unit_ns, count_);
+        out += fmt::format("#[Buckets = {:12d}, SubBuckets     = {:12d}]\n", kBucketCount, kSubBuckets);
+        return out;
+    }
+
+} // namespace core
@@ -0,0 +1,56 @@
+#include "thread_pool.hpp"
+#include <stdexcept>
+
+namespace core {
+
+    std::size_t ThreadPool::resolveThreadCount(std::size_t requested) {
+        if (requested > 0) return requested;
+        std::size_t hw = std::thread::hardware_concurrency();
+        return hw > 0 ? hw : 1; // hardware_concurrency may report 0
+    }
+
+    ThreadPool::ThreadPool(std::size_t num_threads) {
+        std::size_t count = resolveThreadCount(num_threads);
+        workers_.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            workers_.emplace_back([this]() { workerLoop(); });
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        for (auto& worker : workers_) {
+            if (worker.joinable()) worker.join();
+        }
+    }
+
+    void ThreadPool::enqueue(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_) {
+                throw std::runtime_error("ThreadPool::submit called on a stopping pool.");
+            }
+            tasks_.push(std::move(task));
+        }
+        cv_.notify_one();
+    }
+
+    void ThreadPool::workerLoop() {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+                if (tasks_.empty()) return; // stopping_ and nothing left to run
+                task = std::move(tasks_.front());
+                tasks_.pop();
+            }
+            task(); // Exceptions are captured by the packaged_task's future
+        }
+    }
+
+} // namespace core
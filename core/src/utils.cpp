@@ -1,155 +1,208 @@
 #include "utils.hpp"
-#include <iomanip> // For std::put_time, std::get_time
-#include <sstream> // For string streams
-#include <iomanip>    // For std::get_time
-#include <sstream>    // For std::istringstream
 #include <string>     // For std::string
 #include <stdexcept>  // For std::runtime_error
-#include <cmath>      // For std::pow
 #include <chrono>     // Ensure chrono is included
-#include <cstring>    // For timegm if needed (see below)
+#include <cstdio>     // For std::sscanf / std::snprintf
+#include <atomic>
+#include <random>
+
+#ifdef _WIN32
+#include <process.h>  // _getpid
+#else
+#include <unistd.h>   // getpid
+#endif
 
 namespace core {
 namespace utils {
 
-    // Note: Time zone handling can be complex. This example uses system's local time or UTC.
-    // Consider using a dedicated date/time library (like Howard Hinnant's date lib or Boost.DateTime)
-    // for more robust time zone management if required.
-    Timestamp stringToTimestamp(const std::string& iso_string) {
-        std::tm tm = {};
-        std::istringstream ss(iso_string);
-    
-        // 1. Parse main date/time part up to seconds
-        ss >> std::get_time(&tm, "%Y-%m-%dT%H:%M:%S");
-        if (ss.fail()) {
-            throw std::runtime_error("Failed to parse timestamp (date/time part): " + iso_string);
+    namespace { // File-local helpers
+
+        constexpr std::int64_t kSecondsPerDay = 86400;
+        constexpr std::int64_t kIstOffsetSeconds = 5 * 3600 + 30 * 60; // Display zone, see timestampToString
+
+        // Days since 1970-01-01 for a proleptic Gregorian date (H. Hinnant's
+        // days_from_civil). Valid for any day 1..31: extra days roll into the next month.
+        constexpr std::int64_t daysFromCivil(std::int64_t y, unsigned m, unsigned d) {
+            y -= m <= 2;
+            const std::int64_t era = (y >= 0 ? y : y - 399) / 400;
+            const unsigned yoe = static_cast<unsigned>(y - era * 400);
+            const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+            const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+            return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+        }
+
+        // Inverse of daysFromCivil
+        constexpr void civilFromDays(std::int64_t z, std::int64_t& y, unsigned& m, unsigned& d) {
+            z += 719468;
+            const std::int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+            const unsigned doe = static_cast<unsigned>(z - era * 146097);
+            const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+            const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+            const unsigned mp = (5 * doy + 2) / 153;
+            d = doy - (153 * mp + 2) / 5 + 1;
+            m = mp < 10 ? mp + 3 : mp - 9;
+            y = static_cast<std::int64_t>(yoe) + era * 400 + (m <= 2);
         }
-    
-        // 2. Manually parse optional fractional seconds
-        double fractional_seconds = 0.0;
-        if (ss.peek() == '.') {
-            ss.ignore(); // consume '.'
-            std::string digits;
-            int digit_count = 0;
-            while (std::isdigit(ss.peek()) && digit_count < 9) { // Limit precision (e.g., nanoseconds)
-                digits += static_cast<char>(ss.get());
-                digit_count++;
+
+        bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+        // Fixed-width decimal field at p[0..width); false if any character is not a digit
+        bool readDigits(const char* p, int width, unsigned& value) {
+            value = 0;
+            for (int i = 0; i < width; ++i) {
+                if (!isDigit(p[i])) return false;
+                value = value * 10 + static_cast<unsigned>(p[i] - '0');
             }
-            // Consume any remaining digits after precision limit
-             while (std::isdigit(ss.peek())) {
-                  ss.ignore();
-             }
-    
-            if (!digits.empty()) {
-                try {
-                    fractional_seconds = std::stod(digits) / std::pow(10.0, digits.length());
-                } catch (const std::exception& e) {
-                    throw std::runtime_error(std::string("Failed to parse timestamp (subsecond conversion): ") + e.what());
-                }
+            return true;
+        }
+
+        char* writeDigits(char* out, unsigned value, int width) {
+            for (int i = width - 1; i >= 0; --i) {
+                out[i] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            }
+            return out + width;
+        }
+
+        std::int64_t floorDiv(std::int64_t a, std::int64_t b) {
+            const std::int64_t q = a / b;
+            return (a % b != 0 && ((a < 0) != (b < 0))) ? q - 1 : q;
+        }
+
+    } // namespace
+
+    bool parseTimestamp(std::string_view text, Timestamp& out) {
+        // 1. Date and time: YYYY-MM-DDTHH:MM:SS
+        const char* p = text.data();
+        const char* end = p + text.size();
+        if (text.size() < 19 || p[4] != '-' || p[7] != '-' || p[10] != 'T' || p[13] != ':' || p[16] != ':') {
+            return false;
+        }
+        unsigned year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0;
+        if (!readDigits(p, 4, year) || !readDigits(p + 5, 2, month) || !readDigits(p + 8, 2, day) ||
+            !readDigits(p + 11, 2, hour) || !readDigits(p + 14, 2, minute) || !readDigits(p + 17, 2, second)) {
+            return false;
+        }
+        // Same ranges std::get_time accepts (a leap second rolls over)
+        if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60) {
+            return false;
+        }
+        p += 19;
+
+        // 2. Optional fraction: up to nanoseconds, further digits are dropped
+        std::int64_t fraction_ns = 0;
+        if (p < end && *p == '.') {
+            ++p;
+            std::int64_t scale = 100'000'000;
+            for (; p < end && isDigit(*p); ++p) {
+                fraction_ns += (*p - '0') * scale;
+                scale /= 10;
             }
         }
-    
-        // 3. Manually parse timezone offset (+HH:MM, -HH:MM, or Z)
-        std::chrono::seconds offset_duration = std::chrono::seconds(0);
-        char sign_or_z = 0;
-    
-        if (ss >> sign_or_z) { // Try to read the next character
-            if (sign_or_z == 'Z') {
-                // UTC
-                offset_duration = std::chrono::seconds(0);
-            } else if (sign_or_z == '+' || sign_or_z == '-') {
-                int offset_h = 0;
-                int offset_m = 0;
-                char colon = ' ';
-                // Read HH:MM after the sign
-                if (!(ss >> std::setw(2) >> offset_h >> colon >> std::setw(2) >> offset_m) || colon != ':') {
-                     throw std::runtime_error("Failed to parse timestamp (timezone offset HH:MM): " + iso_string);
-                }
-                offset_duration = std::chrono::hours(offset_h) + std::chrono::minutes(offset_m);
-                if (sign_or_z == '-') {
-                    offset_duration *= -1; // Make offset negative if sign is '-'
-                }
-            } else {
-                throw std::runtime_error("Invalid timezone indicator '" + std::string(1, sign_or_z) + "' in timestamp: " + iso_string);
+
+        // 3. Offset: Z, +HH:MM or -HH:MM (optionally after spaces). Unlike the old
+        //    stream parser, exactly two digits each: "+5:30" or "+05:300" is rejected.
+        //    Text after a complete offset ("...+05:30[Asia/Kolkata]") is ignored, as before.
+        while (p < end && *p == ' ') ++p;
+        if (p == end) return false;
+        std::int64_t offset_seconds = 0;
+        if (*p == '+' || *p == '-') {
+            unsigned offset_h = 0, offset_m = 0;
+            if (end - p < 6 || !readDigits(p + 1, 2, offset_h) || p[3] != ':' || !readDigits(p + 4, 2, offset_m) ||
+                (end - p > 6 && isDigit(p[6]))) {
+                return false;
             }
-        } else {
-            // If reading the character failed, maybe the string ended right after seconds/subseconds
-            // Treat as UTC? Or local? Or error? Let's error for now, as DB has offsets.
-             throw std::runtime_error("Timestamp missing or invalid timezone offset/indicator: " + iso_string);
+            offset_seconds = (static_cast<std::int64_t>(offset_h) * 60 + offset_m) * 60;
+            if (*p == '-') offset_seconds = -offset_seconds;
+        } else if (*p != 'Z') {
+            return false;
         }
-    
-    
-        // 4. Convert tm to time_t (UTC seconds since epoch)
-        // timegm interprets struct tm as UTC. Required because we apply the offset later.
-        // timegm is POSIX standard but not C++ standard. Use _mkgmtime on Windows.
-        #ifdef _WIN32
-            time_t tt = _mkgmtime(&tm);
-        #else
-            // Need to declare timegm if not implicitly available (e.g. some C++ standards)
-            // extern "C" time_t timegm(struct tm *tm); // Usually in <time.h> on POSIX
-            time_t tt = timegm(&tm);
-        #endif
-        if (tt == (time_t)-1) {
-             throw std::runtime_error("Failed to convert parsed date/time to UTC epoch seconds: " + iso_string);
+
+        // 4. Local fields minus offset = UTC
+        const std::int64_t seconds = daysFromCivil(year, month, day) * kSecondsPerDay +
+                                     hour * 3600 + minute * 60 + second - offset_seconds;
+        out = Timestamp(std::chrono::duration_cast<Timestamp::duration>(
+            std::chrono::seconds(seconds) + std::chrono::nanoseconds(fraction_ns)));
+        return true;
+    }
+
+    Timestamp stringToTimestamp(const std::string& iso_string) {
+        Timestamp ts;
+        if (!parseTimestamp(iso_string, ts)) {
+            throw std::runtime_error("Failed to parse timestamp (expected YYYY-MM-DDTHH:MM:SS[.fff](+HH:MM|Z)): " + iso_string);
         }
-    
-        // 5. Create base time_point (UTC) from epoch seconds
-        auto base_tp_utc = std::chrono::system_clock::from_time_t(tt);
-    
-        // 6. Add fractional seconds (as duration)
-        base_tp_utc += std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::duration<double>(fractional_seconds));
-    
-        // 7. Adjust the UTC time_point by the *inverse* of the offset to get the final UTC equivalent time_point.
-        // Example: 2015-04-20T00:00:00+05:30
-        // - Base UTC from timegm(tm) is 2015-04-20T00:00:00Z
-        // - Offset is +5h30m
-        // - Final UTC = Base UTC - Offset = 2015-04-19T18:30:00Z
-        Timestamp final_tp = base_tp_utc - offset_duration;
-    
-        return final_tp;
+        return ts;
     }
-    
+
+    char* formatTimestamp(const Timestamp& ts, char* out) {
+        // Whole seconds (rounded down) shifted to IST, then split into fields. The year
+        // is written as exactly four digits through an unsigned cast, so it is right for
+        // years 0000..9999 only; a nanosecond Timestamp spans 1677..2262 anyway.
+        const std::int64_t utc_seconds = std::chrono::floor<std::chrono::seconds>(ts).time_since_epoch().count();
+        const std::int64_t local_seconds = utc_seconds + kIstOffsetSeconds;
+        const std::int64_t days = floorDiv(local_seconds, kSecondsPerDay);
+        const auto second_of_day = static_cast<unsigned>(local_seconds - days * kSecondsPerDay);
+        std::int64_t year = 0;
+        unsigned month = 0, day = 0;
+        civilFromDays(days, year, month, day);
+
+        out = writeDigits(out, static_cast<unsigned>(year), 4);
+        *out++ = '-';
+        out = writeDigits(out, month, 2);
+        *out++ = '-';
+        out = writeDigits(out, day, 2);
+        *out++ = 'T';
+        out = writeDigits(out, second_of_day / 3600, 2);
+        *out++ = ':';
+        out = writeDigits(out, second_of_day / 60 % 60, 2);
+        *out++ = ':';
+        out = writeDigits(out, second_of_day % 60, 2);
+        // The DB format always carries the IST offset
+        for (char c : {'+', '0', '5', ':', '3', '0'}) *out++ = c;
+        return out;
+    }
+
     std::string timestampToString(const Timestamp& ts) {
-        auto tt = std::chrono::system_clock::to_time_t(ts);
-        // Note: system_clock::to_time_t gives UTC epoch seconds.
-        // We need to convert this to IST for display matching the DB.
-        // Adding the IST offset (5 hours 30 minutes) to the UTC time_point
-        // before converting to tm struct via localtime functions.
-        // This is one way to handle it without external timezone libs.
-        auto ist_time_point = ts + std::chrono::hours(5) + std::chrono::minutes(30);
-        auto tt_ist = std::chrono::system_clock::to_time_t(ist_time_point);
-    
-        // Get milliseconds from the ORIGINAL UTC timepoint 'ts' before offset adjustment
-        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(ts.time_since_epoch()) % 1000;
-        if (ms.count() < 0) ms += std::chrono::seconds{1}; // Adjust for negative remainders
-    
-        std::tm time_tm;
-        // Use thread-safe versions if available
-        #ifdef _WIN32
-            gmtime_s(&time_tm, &tt_ist); // Use gmtime_s/gmtime_r to format the adjusted time parts as if they were UTC figures
-        #elif defined(__unix__) || defined(__APPLE__)
-            gmtime_r(&tt_ist, &time_tm);
-        #else
-            std::tm* temp_tm = std::gmtime(&tt_ist);
-            if (temp_tm) {
-                time_tm = *temp_tm;
-            } else {
-                throw std::runtime_error("Failed to get gmtime representation for adjusted IST time.");
-            }
-        #endif
-    
-        std::ostringstream oss;
-        // Format as YYYY-MM-DDTHH:MM:SS using the adjusted time parts
-        oss << std::put_time(&time_tm, "%Y-%m-%dT%H:%M:%S");
-        // Append milliseconds (Optional - check if your DB strings include them)
-        // oss << '.' << std::setfill('0') << std::setw(3) << ms.count();
-    
-        // Append the required +05:30 offset string MANDATORILY to match DB format
-        // WARNING: This assumes the underlying data *should* be IST.
-        oss << "+05:30";
-        return oss.str();
+        char buffer[kTimestampStringLength];
+        return std::string(buffer, formatTimestamp(ts, buffer));
+    }
+
+    std::chrono::sys_days parseDate(const std::string& yyyy_mm_dd) {
+        int y = 0;
+        unsigned m = 0, d = 0;
+        char trailing = 0;
+        if (std::sscanf(yyyy_mm_dd.c_str(), "%4d-%2u-%2u%c", &y, &m, &d, &trailing) != 3) {
+            throw std::invalid_argument("Invalid date (expected YYYY-MM-DD): " + yyyy_mm_dd);
+        }
+        const std::chrono::year_month_day ymd{std::chrono::year{y}, std::chrono::month{m}, std::chrono::day{d}};
+        if (!ymd.ok()) {
+            throw std::invalid_argument("Invalid date (expected YYYY-MM-DD): " + yyyy_mm_dd);
+        }
+        return std::chrono::sys_days{ymd};
+    }
+
+    std::string formatDate(std::chrono::sys_days date) {
+        const std::chrono::year_month_day ymd{date};
+        char buffer[16];
+        std::snprintf(buffer, sizeof(buffer), "%04d-%02u-%02u", static_cast<int>(ymd.year()),
+                      static_cast<unsigned>(ymd.month()), static_cast<unsigned>(ymd.day()));
+        return buffer;
+    }
+
+    std::string uniqueTempPath(const std::string& path) {
+#ifdef _WIN32
+        static const long pid = static_cast<long>(_getpid());
+#else
+        static const long pid = static_cast<long>(getpid());
+#endif
+        // The salt tells apart processes with the same pid (e.g. containers sharing a volume)
+        static const unsigned salt = std::random_device{}();
+        static std::atomic<std::uint64_t> counter{0};
+        char suffix[64];
+        std::snprintf(suffix, sizeof(suffix), ".%ld-%08x-%llu.tmp", pid, salt,
+                      static_cast<unsigned long long>(counter.fetch_add(1, std::memory_order_relaxed)));
+        return path + suffix;
     }
-    
 
 } // namespace utils
 } // namespace core
\ No newline at end of file
@@ -0,0 +1,88 @@
+#include "work_stealing_pool.hpp"
+#include "thread_pool.hpp" // ThreadPool::resolveThreadCount
+#include <stdexcept>
+
+namespace core {
+
+    namespace {
+        // Which pool (and which of its deques) the current thread works for
+        thread_local const WorkStealingPool* current_pool = nullptr;
+        thread_local std::size_t current_index = 0;
+    } // namespace
+
+    WorkStealingPool::WorkStealingPool(std::size_t num_threads) {
+        const std::size_t count = ThreadPool::resolveThreadCount(num_threads);
+        queues_.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) queues_.push_back(std::make_unique<TaskQueue>());
+        workers_.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            workers_.emplace_back([this, i]() { workerLoop(i); });
+        }
+    }
+
+    WorkStealingPool::~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        for (auto& worker : workers_) {
+            if (worker.joinable()) worker.join();
+        }
+    }
+
+    void WorkStealingPool::enqueue(std::function<void()> task) {
+        const bool from_worker = (current_pool == this);
+        const std::size_t target = from_worker ? current_index
+                                               : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            // Running tasks may still chain follow-ups while the pool drains
+            if (stopping_ && !from_worker) {
+                throw std::runtime_error("WorkStealingPool::submit called on a stopping pool.");
+            }
+            {
+                std::lock_guard<std::mutex> queue_lock(queues_[target]->mutex);
+                queues_[target]->tasks.push_back(std::move(task));
+            }
+            queued_.fetch_add(1, std::memory_order_release);
+        }
+        cv_.notify_one();
+    }
+
+    bool WorkStealingPool::tryRunOne(std::size_t self) {
+        std::function<void()> task;
+        {
+            TaskQueue& own = *queues_[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+            }
+        }
+        for (std::size_t k = 1; !task && k < queues_.size(); ++k) {
+            TaskQueue& victim = *queues_[(self + k) % queues_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+            }
+        }
+        if (!task) return false;
+        queued_.fetch_sub(1, std::memory_order_acq_rel);
+        task(); // Exceptions are captured by the packaged_task's future
+        return true;
+    }
+
+    void WorkStealingPool::workerLoop(std::size_t index) {
+        current_pool = this;
+        current_index = index;
+        for (;;) {
+            if (tryRunOne(index)) continue;
+            std::unique_lock<std::mutex> lock(sleep_mutex_);
+            cv_.wait(lock, [this]() { return stopping_ || queued_.load(std::memory_order_acquire) > 0; });
+            if (stopping_ && queued_.load(std::memory_order_acquire) == 0) return; // Drained
+        }
+    }
+
+} // namespace core
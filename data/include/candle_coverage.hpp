@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "datatypes.hpp"
+
+namespace data {
+
+// Inclusive range of exchange-local calendar dates (YYYY-MM-DD)
+struct DateRange {
+    std::string from_date;
+    std::string to_date;
+};
+
+// What historical_candles holds for one (instrument, interval), as kept in the
+// candle_coverage / candle_gaps metadata tables (see DatabaseManager::refreshCoverage)
+struct SeriesCoverage {
+    std::string instrument_key;
+    std::string interval;
+    core::Timestamp first_timestamp{};  // Earliest / latest stored bar
+    core::Timestamp last_timestamp{};
+    std::string first_date;             // Their local dates
+    std::string last_date;
+    long long row_count = 0;
+    std::vector<DateRange> gaps;        // Weekdays without bars between first_date and last_date
+    std::vector<DateRange> no_data;     // Ranges the API already returned nothing for (holidays, suspensions)
+};
+
+// Runs of missing weekdays between consecutive entries of 'dates' (sorted,
+// distinct YYYY-MM-DD). Weekends and days inside 'no_data' are not reported and
+// do not split a run, so a gap spanning a weekend comes back as one range.
+std::vector<DateRange> findDateGaps(const std::vector<std::string>& dates,
+                                    const std::vector<DateRange>& no_data);
+
+// Date ranges to request so that [from_date, to_date] is complete: the whole
+// range without coverage, otherwise the part before first_date, the open gaps
+// and the part after last_date, all clipped to the range and minus no_data.
+// Intraday series re-request last_date, which may have been stored mid-session;
+// weekly/monthly series only extend at the edges.
+std::vector<DateRange> missingDateRanges(const SeriesCoverage* coverage,
+                                         const std::string& interval,
+                                         const std::string& from_date,
+                                         const std::string& to_date);
+
+} // namespace data
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "candle_series.hpp"
+
+namespace data {
+
+// Bar length in the interval strings used by the DB and Upstox
+// ("1minute", "15minute", "1hour", "day", "week", "month").
+struct BarInterval {
+    enum class Unit { Minute, Day, Week, Month };
+
+    Unit unit = Unit::Minute;
+    int count = 1; // Multiplier for Minute; always 1 for Day/Week/Month
+
+    // nullopt for strings the resampler does not understand
+    static std::optional<BarInterval> parse(const std::string& interval);
+
+    // Approximate length, only used to order intervals (a month counts as 31 days)
+    std::int64_t nominalNs() const;
+};
+
+// Buckets are computed in exchange local time (IST). Intraday buckets are anchored
+// at the session open so e.g. 15minute bars start at 09:15, 09:30, ... and never
+// cross midnight; weeks start on Monday.
+struct ResampleOptions {
+    int utc_offset_minutes = 5 * 60 + 30;
+    int session_open_minutes = 9 * 60 + 15; // Minutes after local midnight
+};
+
+// Higher-timeframe bars built from a base series, plus the alignment needed to
+// use them on the base bars without lookahead.
+struct ResampledSeries {
+    core::CandleSeries bars; // One bar per non-empty bucket, stamped with the bucket start
+
+    // completed[i] = number of resampled bars that are closed once base bar i has
+    // closed, i.e. bar completed[i] - 1 is the latest one visible at base bar i
+    // (none if 0). A bucket counts as closed when the base bar's own interval
+    // reaches the bucket end; otherwise it only becomes visible on the first base
+    // bar of a later bucket.
+    std::vector<std::uint32_t> completed;
+};
+
+// [start, end) of the 'interval' bucket containing 'timestamp_ns' (UTC ns).
+std::pair<std::int64_t, std::int64_t> bucketBounds(const BarInterval& interval, std::int64_t timestamp_ns,
+                                                   const ResampleOptions& options = {});
+
+// Aggregates 'base' (sorted, on 'base_interval') into 'target_interval' bars in a
+// single pass: first open, max high, min low, last close, summed volume, last
+// open interest. Throws std::invalid_argument if an interval is unknown or the
+// target is finer than the base.
+ResampledSeries resampleCandles(const core::CandleSeries& base,
+                                const std::string& base_interval,
+                                const std::string& target_interval,
+                                const ResampleOptions& options = {});
+
+// Interval label for series derived from another one (cache keys, file names),
+// e.g. "15minute_from_1minute".
+std::string resampledIntervalKey(const std::string& base_interval, const std::string& target_interval);
+
+} // namespace data
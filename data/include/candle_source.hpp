@@ -0,0 +1,69 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "datatypes.hpp"     // Candle, TimeSeries, Timestamp
+#include "candle_series.hpp" // Columnar CandleSeries
+
+namespace data {
+
+// Read side of historical candle storage, as used by the backtester.
+// Implemented by DatabaseManager (SQLite) and ColumnarCandleStore (mmap files).
+class ICandleSource {
+public:
+    virtual ~ICandleSource() = default;
+
+    virtual bool connect() = 0;
+    virtual bool isConnected() const = 0;
+    // True if the query methods may be called from several threads at once
+    // (e.g. to load instruments in parallel). connect() is always single-threaded.
+    virtual bool supportsConcurrentQueries() const { return false; }
+
+    // Candles with start_time <= timestamp <= end_time, in ascending time order
+    virtual core::TimeSeries<core::Candle> queryCandles(
+        const std::string& instrument_key,
+        const std::string& interval,
+        core::Timestamp start_time,
+        core::Timestamp end_time) = 0;
+
+    // Same range as a structure-of-arrays series, which is what the backtester and
+    // indicators consume. The default converts queryCandles(); sources that can fill
+    // columns directly (or map them) override it.
+    virtual core::CandleSeries queryCandleSeries(
+        const std::string& instrument_key,
+        const std::string& interval,
+        core::Timestamp start_time,
+        core::Timestamp end_time)
+    {
+        return core::CandleSeries::fromCandles(queryCandles(instrument_key, interval, start_time, end_time));
+    }
+
+    // Constituents of 'index_key' from the most recent snapshot on or before
+    // 'as_of_date' (YYYY-MM-DD), sorted by key. Sources without index data
+    // return an empty list.
+    virtual std::vector<std::string> queryIndexConstituents(const std::string& /*index_key*/,
+                                                            const std::string& /*as_of_date*/)
+    {
+        return {};
+    }
+
+    // Instrument keys from the instrument master whose exchange and segment match
+    // (an empty filter matches any), sorted by key. Sources without instrument
+    // metadata return an empty list.
+    virtual std::vector<std::string> queryInstruments(const std::string& /*exchange*/,
+                                                      const std::string& /*segment*/)
+    {
+        return {};
+    }
+
+    // Price step of the instrument (e.g. 0.05), used to store its candles compactly.
+    // Sources without instrument metadata return nullopt.
+    virtual std::optional<double> queryTickSize(const std::string& /*instrument_key*/)
+    {
+        return std::nullopt;
+    }
+};
+
+} // namespace data
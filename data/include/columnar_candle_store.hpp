@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "candle_source.hpp"
+#include "candle_series.hpp"
+#include "datatypes.hpp"
+
+namespace data {
+
+class DatabaseManager;
+
+// --- Columnar candle file format (.tpcol) ---
+// One file per (instrument, interval), native endianness, read via mmap:
+//
+//   ColumnarFileHeader                      (offset 0, 256 bytes)
+//   column 0: int64  timestamp ns (UTC)     each column starts on a 64-byte boundary
+//   column 1..5: double open/high/low/close/volume
+//   column 6: int64  open_interest          (only if kColumnarHasOpenInterest; core::kNoOpenInterest = missing)
+//   ColumnarBlockIndexEntry[block_count]    (64-byte aligned)
+//
+// Rows are sorted by timestamp. The block index stores the first/last timestamp
+// of every block_rows rows, so a range lookup touches only the pages it needs.
+// The column types match core::CandleSeries, so a mapped file is used without copying.
+inline constexpr char kColumnarMagic[8] = {'T', 'P', 'C', 'O', 'L', '\0', '\0', '\0'};
+inline constexpr std::uint32_t kColumnarVersion = 2; // v2: volume stored as double (v1 used int64)
+inline constexpr std::size_t kColumnarAlignment = 64;
+inline constexpr std::uint32_t kColumnarDefaultBlockRows = 4096;
+inline constexpr std::uint32_t kColumnarHasOpenInterest = 1u << 0;
+
+enum ColumnarColumn : std::size_t {
+    kColTimestamp = 0,
+    kColOpen,
+    kColHigh,
+    kColLow,
+    kColClose,
+    kColVolume,
+    kColOpenInterest,
+    kColumnarColumnCount
+};
+
+struct ColumnarFileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t flags;
+    std::uint64_t row_count;
+    std::uint32_t block_rows;
+    std::uint32_t block_count;
+    std::uint64_t block_index_offset;
+    std::uint64_t column_offsets[kColumnarColumnCount]; // 0 = column absent
+    char instrument_key[96];                           // NUL-terminated (checked on open), for validation
+    char interval[32];
+    std::uint8_t reserved[256 - 8 - 4 - 4 - 8 - 4 - 4 - 8 - 8 * kColumnarColumnCount - 96 - 32];
+};
+static_assert(sizeof(ColumnarFileHeader) == 256, "ColumnarFileHeader must stay 256 bytes");
+
+struct ColumnarBlockIndexEntry {
+    std::int64_t first_timestamp_ns;
+    std::int64_t last_timestamp_ns;
+    std::uint64_t first_row;
+};
+
+// Read-only memory mapping of one .tpcol file. Column spans point straight into
+// the mapping and stay valid for the lifetime of the object.
+// Must be owned by a std::shared_ptr when series() is used.
+class ColumnarCandleFile : public std::enable_shared_from_this<ColumnarCandleFile> {
+public:
+    explicit ColumnarCandleFile(const std::string& path); // Throws core::DataLoadException
+    ~ColumnarCandleFile();
+
+    ColumnarCandleFile(const ColumnarCandleFile&) = delete;
+    ColumnarCandleFile& operator=(const ColumnarCandleFile&) = delete;
+
+    const ColumnarFileHeader& header() const { return *header_; }
+    std::size_t size() const { return static_cast<std::size_t>(header_->row_count); }
+    bool hasOpenInterest() const { return (header_->flags & kColumnarHasOpenInterest) != 0; }
+
+    std::span<const std::int64_t> timestamps() const { return int64Column(kColTimestamp); }
+    std::span<const double> open() const { return doubleColumn(kColOpen); }
+    std::span<const double> high() const { return doubleColumn(kColHigh); }
+    std::span<const double> low() const { return doubleColumn(kColLow); }
+    std::span<const double> close() const { return doubleColumn(kColClose); }
+    std::span<const double> volume() const { return doubleColumn(kColVolume); }
+    std::span<const std::int64_t> openInterest() const; // Empty if absent
+
+    // Row range [first, last) with start_ns <= timestamp <= end_ns
+    std::pair<std::size_t, std::size_t> findRange(std::int64_t start_ns, std::int64_t end_ns) const;
+
+    // Copies rows [first, last) into AoS candles
+    core::TimeSeries<core::Candle> materialize(std::size_t first, std::size_t last) const;
+    // Zero-copy view of rows [first, last); keeps this mapping alive
+    core::CandleSeries series(std::size_t first, std::size_t last) const;
+
+    // Writes 'candles' (sorted by timestamp) to 'path' atomically (temp file + rename).
+    static bool write(const std::string& path,
+                      const std::string& instrument_key,
+                      const std::string& interval,
+                      const core::TimeSeries<core::Candle>& candles,
+                      std::uint32_t block_rows = kColumnarDefaultBlockRows);
+
+private:
+    std::span<const double> doubleColumn(ColumnarColumn column) const;
+    std::span<const std::int64_t> int64Column(ColumnarColumn column) const;
+    std::span<const ColumnarBlockIndexEntry> blockIndex() const;
+
+    std::string path_;
+    const std::byte* data_ = nullptr;
+    std::size_t mapped_size_ = 0;
+    const ColumnarFileHeader* header_ = nullptr;
+};
+
+// ICandleSource over a directory of .tpcol files, one per (instrument, interval).
+// Files are mapped on first use and kept mapped; safe to query from several threads.
+class ColumnarCandleStore : public ICandleSource {
+public:
+    explicit ColumnarCandleStore(std::string directory);
+
+    bool connect() override;
+    bool isConnected() const override { return connected_; }
+    bool supportsConcurrentQueries() const override { return true; }
+
+    core::TimeSeries<core::Candle> queryCandles(const std::string& instrument_key,
+                                                const std::string& interval,
+                                                core::Timestamp start_time,
+                                                core::Timestamp end_time) override;
+    // Zero-copy: the series points into the mapped file
+    core::CandleSeries queryCandleSeries(const std::string& instrument_key,
+                                         const std::string& interval,
+                                         core::Timestamp start_time,
+                                         core::Timestamp end_time) override;
+
+    // Mapped file for the series, or nullptr if no file exists
+    std::shared_ptr<const ColumnarCandleFile> openSeries(const std::string& instrument_key,
+                                                         const std::string& interval);
+
+    std::string pathFor(const std::string& instrument_key, const std::string& interval) const;
+    const std::string& getDirectory() const { return directory_; }
+
+    struct ExportStats {
+        std::size_t written = 0;
+        std::size_t failed = 0;  // Series whose file could not be written
+    };
+
+    // Converts every (instrument, interval) series in the SQLite DB to .tpcol files in
+    // 'directory'. Empty filters mean "all".
+    static ExportStats exportFromDatabase(DatabaseManager& db_manager,
+                                         const std::string& directory,
+                                         const std::vector<std::string>& instrument_filter = {},
+                                         const std::string& interval_filter = "");
+
+private:
+    std::string directory_;
+    bool connected_ = false;
+    std::mutex mutex_;
+    std::map<std::pair<std::string, std::string>, std::shared_ptr<const ColumnarCandleFile>> open_files_;
+};
+
+} // namespace data
@@ -3,6 +3,10 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <utility>
 
 // Remove DuckDB includes/forwards
 // #include "duckdb.h"
@@ -11,29 +15,58 @@
 #include <sqlite3.h> // Standard C header
 
 #include "datatypes.hpp" // Keep core types
+#include "candle_source.hpp"
+#include "sqlite_connection_pool.hpp"
+#include "candle_coverage.hpp"
 
 namespace data {
 
-class DatabaseManager {
+// Schema versions, stored in SQLite's PRAGMA user_version
+inline constexpr int kSchemaVersionTextTimestamps = 0; // historical_candles.timestamp as ISO-8601 TEXT (+05:30)
+inline constexpr int kSchemaVersionEpochNanos = 1;     // historical_candles.timestamp as INTEGER ns since epoch (UTC)
+inline constexpr int kCurrentSchemaVersion = kSchemaVersionEpochNanos;
+
+// Candles for one (instrument, interval), as handed to saveCandleBatches()
+struct CandleBatch {
+    std::string instrument_key;
+    std::string interval;
+    core::TimeSeries<core::Candle> candles;
+};
+
+// One read-write connection for schema changes and saveCandles(), plus a pool of
+// read-only connections (one per concurrent caller) for the query methods. The
+// query methods are safe to call from several threads; everything else is meant
+// for one thread at a time. Statements are prepared once per connection and reused.
+// In-memory databases have no pool; their queries share the writer under a lock.
+class DatabaseManager : public ICandleSource {
 public:
-    explicit DatabaseManager(const std::string& db_path);
-    ~DatabaseManager();
+    explicit DatabaseManager(const std::string& db_path, SqliteOptions options = {});
+    ~DatabaseManager() override;
 
-    // Delete copy constructor and assignment operator
+    // Not copyable or movable: pooled connections may be leased by other threads
     DatabaseManager(const DatabaseManager&) = delete;
     DatabaseManager& operator=(const DatabaseManager&) = delete;
-    // Default move constructor and assignment operator (optional)
-    DatabaseManager(DatabaseManager&&) = default;
-    DatabaseManager& operator=(DatabaseManager&&) = default;
 
     // Connect/Disconnect use SQLite API now
-    bool connect();
+    bool connect() override;
     void disconnect();
-    bool isConnected() const;
+    bool isConnected() const override;
+    bool supportsConcurrentQueries() const override { return true; }
 
-    // Schema init uses SQLite API now
+    const SqliteOptions& getOptions() const { return options_; }
+
+    // Schema init uses SQLite API now.
+    // New databases get the current schema; existing legacy ones are left as they are.
     bool initializeSchema();
 
+    // Schema version detected on connect (see kSchemaVersion* constants)
+    int getSchemaVersion() const { return schema_version_; }
+
+    // Rewrites a legacy TEXT-timestamp historical_candles table to INTEGER epoch
+    // nanoseconds in one transaction. No-op if already current; rolls back on any
+    // row that cannot be converted.
+    bool migrateSchema();
+
     // executeSQL uses SQLite API now
     bool executeSQL(const std::string& sql);
 
@@ -41,23 +74,89 @@ public:
         const std::string& instrument_key,
         const std::string& interval);
 
+    // Inserts every batch in a single transaction (duplicates ignored), so bulk
+    // loads pay for one commit instead of one per series. Returns the number of
+    // new rows, or -1 if anything failed and the transaction was rolled back.
+    long long saveCandleBatches(const std::vector<CandleBatch>& batches);
+
     // queryCandles signature remains, implementation changes
     core::TimeSeries<core::Candle> queryCandles(
         const std::string& instrument_key,
         const std::string& interval,
         core::Timestamp start_time,
-        core::Timestamp end_time); // Implementation later
+        core::Timestamp end_time) override;
+    core::CandleSeries queryCandleSeries(
+        const std::string& instrument_key,
+        const std::string& interval,
+        core::Timestamp start_time,
+        core::Timestamp end_time) override;
+
+    // Reads the index_constituents table (latest as_of_date <= as_of_date)
+    std::vector<std::string> queryIndexConstituents(const std::string& index_key,
+                                                    const std::string& as_of_date) override;
+
+    // Reads the instruments table, filtered by exchange / segment (empty = any)
+    std::vector<std::string> queryInstruments(const std::string& exchange,
+                                              const std::string& segment) override;
+
+    // tick_size from the instruments table; nullopt if the row or value is missing
+    std::optional<double> queryTickSize(const std::string& instrument_key) override;
+
+    // Distinct (instrument_key, interval) pairs present in historical_candles
+    std::vector<std::pair<std::string, std::string>> listCandleSeries();
+
+    // --- Coverage metadata (candle_coverage / candle_gaps tables) ---
+    // Kept by the incremental sync so it can request only what is missing.
+    // These run on the writer connection.
+
+    // Stored coverage; nullopt if the series was never scanned (or has no rows)
+    std::optional<SeriesCoverage> queryCoverage(const std::string& instrument_key, const std::string& interval);
+
+    // Rescans historical_candles for the series (one grouped pass over its
+    // primary-key range), recomputes first/last bar, row count and gaps, and
+    // stores them. Previously recorded no-data ranges are kept and excluded
+    // from the gaps. A series without rows comes back with row_count 0 (and
+    // its no-data ranges) and no stored coverage row; nullopt on error.
+    std::optional<SeriesCoverage> refreshCoverage(const std::string& instrument_key, const std::string& interval);
+
+    // Records that the API has no candles for 'range', so sync stops asking for it
+    bool markNoData(const std::string& instrument_key, const std::string& interval, const DateRange& range);
 
     // Remove attachSQLite method
     // bool attachSQLite(const std::string& sqlite_path, const std::string& attach_name = "sqlite_db");
 
 private:
     std::string database_path_;
-    // Replace DuckDB handles with SQLite handle
-    sqlite3* db_ = nullptr; // SQLite database connection handle
+    SqliteOptions options_;
+    std::unique_ptr<SqliteConnection> writer_;
+    sqlite3* db_ = nullptr; // writer_'s handle, for the schema/maintenance code
+    std::unique_ptr<SqliteConnectionPool> readers_; // Null for in-memory databases
+    std::mutex writer_mutex_; // Guards writer_ for saveCandles() and reads without a pool
     bool connected_ = false;
+    int schema_version_ = kSchemaVersionTextTimestamps;
+
+    // Runs 'body(SqliteConnection&)' on a pooled read connection (or the writer)
+    template <typename Body>
+    auto withReadConnection(Body&& body);
 
     // Maybe add helper for SQLite errors later if needed
+    int readSchemaVersion();
+    // Runs the range query and hands each row to 'on_row'; returns the row count
+    std::size_t queryCandleRows(const std::string& instrument_key,
+                                const std::string& interval,
+                                core::Timestamp start_time,
+                                core::Timestamp end_time,
+                                const std::function<void(const core::Candle&)>& on_row);
+    // saveCandles helpers, called with writer_mutex_ held inside a transaction.
+    // Insert returns the new row count or -1 on error; finish commits or rolls back.
+    long long insertCandlesLocked(const core::TimeSeries<core::Candle>& candles,
+                                  const std::string& instrument_key,
+                                  const std::string& interval);
+    bool finishTransactionLocked(bool commit);
+    bool ensureCoverageTablesLocked();
+    std::vector<DateRange> queryGapRowsLocked(const std::string& instrument_key, const std::string& interval, bool no_data);
+    bool tableExists(const std::string& table_name);
+    bool setSchemaVersion(int version);
 };
 
 } // namespace data
\ No newline at end of file
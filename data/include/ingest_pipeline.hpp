@@ -0,0 +1,128 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "database_manager.hpp"
+#include "upstox_api_client.hpp"
+
+namespace data {
+
+// One historical-candle request: an instrument over an inclusive date range
+struct IngestTask {
+    std::string instrument_key;
+    std::string interval;
+    std::string from_date; // YYYY-MM-DD
+    std::string to_date;   // YYYY-MM-DD
+};
+
+struct IngestOptions {
+    std::size_t fetch_workers = 8;      // Concurrent HTTP requests (each parses its own response)
+    double requests_per_second = 10.0;  // Shared by all workers, retries included (<= 0 = unlimited)
+    std::size_t max_retries = 3;        // Per task, for 429 / 5xx / transport errors
+    int retry_backoff_ms = 1000;        // Doubles on every retry of a task; a Retry-After header replaces it
+    long max_retry_after_ms = 60000;    // Cap on a server-requested Retry-After wait
+    std::size_t batch_rows = 250000;    // Writer commits once this many candles are buffered...
+    int flush_interval_ms = 5000;       // ...or when the oldest buffered batch is this old
+    std::size_t queue_capacity = 64;    // Parsed responses waiting for the writer (bounds memory)
+    int progress_interval_ms = 5000;    // Progress log period (0 = only the final summary)
+};
+
+struct IngestStats {
+    std::size_t tasks = 0;
+    std::size_t tasks_failed = 0;
+    std::size_t requests = 0;           // HTTP requests sent, retries included
+    std::size_t retries = 0;
+    std::size_t bytes_downloaded = 0;
+    std::size_t candles_parsed = 0;
+    long long candles_inserted = 0;     // New rows (duplicates of existing rows are ignored)
+    std::size_t transactions = 0;
+    double elapsed_seconds = 0.0;
+    // Summed over all workers, so they can exceed elapsed_seconds
+    double fetch_seconds = 0.0;
+    double parse_seconds = 0.0;
+    double write_seconds = 0.0;         // Writer thread only
+    std::vector<IngestTask> failed;     // Tasks to re-run, in no particular order
+};
+
+// Upstox caps the date range of one historical request depending on the interval;
+// these are the chunk sizes planIngestTasks() uses when none is given.
+int defaultChunkDays(const std::string& interval);
+
+// One task per instrument per chunk of at most 'chunk_days' days covering
+// [from_date, to_date] (0 = defaultChunkDays). Throws std::invalid_argument on
+// malformed dates or from_date > to_date.
+std::vector<IngestTask> planIngestTasks(const std::vector<std::string>& instrument_keys,
+                                        const std::string& interval,
+                                        const std::string& from_date,
+                                        const std::string& to_date,
+                                        int chunk_days = 0);
+
+// Incremental version of planIngestTasks(): only the date ranges each series is
+// missing according to its stored coverage (scanned first if it has none yet),
+// see missingDateRanges(). Series that are already complete get no tasks.
+std::vector<IngestTask> planSyncTasks(DatabaseManager& db,
+                                      const std::vector<std::string>& instrument_keys,
+                                      const std::string& interval,
+                                      const std::string& from_date,
+                                      const std::string& to_date,
+                                      int chunk_days = 0);
+
+// --- RateLimiter ---
+// Token bucket shared by threads. acquire() reserves the next free slot and
+// sleeps until it comes up, so callers are served in arrival order at 'per_second'
+// on average with bursts of at most 'burst'.
+class RateLimiter {
+public:
+    explicit RateLimiter(double per_second, double burst = 1.0);
+    void acquire();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    double per_second_;
+    double burst_;
+    double tokens_;
+    Clock::time_point last_refill_;
+    std::mutex mutex_;
+};
+
+// --- IngestPipeline ---
+// Bulk backfill from the Upstox historical API into SQLite. A pool of fetch
+// workers issues requests under the rate limiter and parses each response as
+// soon as it arrives, so parsing overlaps with other workers' network I/O.
+// Parsed candles go through a bounded queue to a single writer thread that
+// groups them into large transactions (DatabaseManager::saveCandleBatches).
+// A 401 stops the run: outstanding tasks are reported as failed. A transaction
+// that fails (or throws) fails the requests it held; the run goes on.
+class IngestPipeline {
+public:
+    IngestPipeline(const UpstoxApiClient& client, DatabaseManager& db, IngestOptions options = {});
+
+    // Blocks until every task is written or failed; logs progress and a summary
+    IngestStats run(const std::vector<IngestTask>& tasks);
+
+    // Incremental sync: plans with planSyncTasks(), runs the requests and
+    // refreshes the coverage of every series it touched. Past days inside a
+    // successfully fetched range that still have no bars are recorded as
+    // no-data, so holidays and pre-listing history are not requested again.
+    IngestStats sync(const std::vector<std::string>& instrument_keys,
+                     const std::string& interval,
+                     const std::string& from_date,
+                     const std::string& to_date,
+                     int chunk_days = 0);
+
+    // One-line throughput summary (used for the progress log as well)
+    static std::string formatStats(const IngestStats& stats);
+
+private:
+    const UpstoxApiClient& client_;
+    DatabaseManager& db_;
+    IngestOptions options_;
+};
+
+} // namespace data
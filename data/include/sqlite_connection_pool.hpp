@@ -0,0 +1,124 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <sqlite3.h>
+
+namespace data {
+
+// Per-connection SQLite settings (see DatabaseManager)
+struct SqliteOptions {
+    bool wal = true;                          // Switch the file to WAL so readers never block the writer
+    std::int64_t mmap_size_bytes = 256LL << 20; // PRAGMA mmap_size (0 = plain reads)
+    int cache_size_kib = 16 * 1024;           // PRAGMA cache_size, per connection
+    int busy_timeout_ms = 5000;               // Wait this long on a locked database before failing
+    std::size_t max_read_connections = 0;     // Read pool size (0 = hardware concurrency)
+};
+
+// --- SqliteConnection ---
+// One sqlite3 handle plus the statements prepared on it. A statement is prepared
+// the first time its SQL is used and reused until the connection closes, so a
+// hot query costs a reset + rebind instead of a full compile.
+// Like the handle itself (SQLITE_OPEN_NOMUTEX), it is used by one thread at a time.
+class SqliteConnection {
+public:
+    // Resets and clears the bindings of a cached statement when it goes out of
+    // scope, so the next user gets it clean and no read transaction stays open.
+    class Statement {
+    public:
+        explicit Statement(sqlite3_stmt* stmt = nullptr) : stmt_(stmt) {}
+        ~Statement();
+        Statement(Statement&& other) noexcept : stmt_(other.stmt_) { other.stmt_ = nullptr; }
+        Statement& operator=(Statement&&) = delete;
+        Statement(const Statement&) = delete;
+        Statement& operator=(const Statement&) = delete;
+
+        sqlite3_stmt* get() const { return stmt_; }
+        explicit operator bool() const { return stmt_ != nullptr; }
+        void reset(); // Resets now and lets go of the statement
+
+    private:
+        sqlite3_stmt* stmt_;
+    };
+
+    // Opens 'path' with 'flags' (NOMUTEX is always added) and applies the pragmas
+    // in 'options'. Throws core::DataLoadException if the database cannot be opened.
+    SqliteConnection(const std::string& path, int flags, const SqliteOptions& options);
+    ~SqliteConnection(); // Finalizes every cached statement, then closes the handle
+
+    SqliteConnection(const SqliteConnection&) = delete;
+    SqliteConnection& operator=(const SqliteConnection&) = delete;
+
+    sqlite3* handle() const { return db_; }
+
+    // Cached statement for 'sql'; empty (and an error logged) if it fails to prepare
+    Statement statement(const std::string& sql);
+
+    // Drops all cached statements (e.g. after the schema they were compiled against changed)
+    void clearStatements();
+    std::size_t cachedStatements() const { return statements_.size(); }
+
+private:
+    sqlite3* db_ = nullptr;
+    std::unordered_map<std::string, sqlite3_stmt*> statements_;
+};
+
+// --- SqliteConnectionPool ---
+// Read-only connections to one database file, opened lazily up to a maximum and
+// handed out one thread at a time. With the file in WAL mode, readers on these
+// connections run in parallel with each other and with a writer on a separate
+// connection. Each connection keeps its own prepared statements.
+class SqliteConnectionPool {
+public:
+    // Returns the connection to the pool when destroyed
+    class Lease {
+    public:
+        Lease(SqliteConnectionPool* pool, std::unique_ptr<SqliteConnection> connection)
+            : pool_(pool), connection_(std::move(connection)) {}
+        ~Lease();
+        Lease(Lease&&) noexcept = default;
+        Lease& operator=(Lease&&) = delete;
+
+        SqliteConnection* operator->() const { return connection_.get(); }
+        SqliteConnection& operator*() const { return *connection_; }
+
+    private:
+        SqliteConnectionPool* pool_;
+        std::unique_ptr<SqliteConnection> connection_;
+    };
+
+    SqliteConnectionPool(std::string path, SqliteOptions options);
+    ~SqliteConnectionPool(); // All leases must have been returned
+
+    SqliteConnectionPool(const SqliteConnectionPool&) = delete;
+    SqliteConnectionPool& operator=(const SqliteConnectionPool&) = delete;
+
+    // Idle connection, a newly opened one while below the maximum, or waits for a
+    // lease to come back. Throws core::DataLoadException if opening fails.
+    Lease acquire();
+
+    std::size_t maxConnections() const { return max_connections_; }
+    std::size_t openConnections() const;
+
+private:
+    void release(std::unique_ptr<SqliteConnection> connection);
+
+    std::string path_;
+    SqliteOptions options_;
+    std::size_t max_connections_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable available_;
+    std::vector<std::unique_ptr<SqliteConnection>> idle_;
+    std::size_t open_ = 0;
+};
+
+} // namespace data
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <string>
 #include <vector>
 #include <optional>
@@ -20,7 +21,19 @@ public:
     // void setAccessToken(const std::string& token);
     // bool isAccessTokenValid(); // Placeholder
 
+    // Raw HTTP outcome of one request, before any JSON parsing
+    struct RawResponse {
+        long status_code = 0;   // 0 if the request never got a response
+        std::string body;
+        std::string error;      // Transport error message (timeout, DNS, ...), empty otherwise
+        double elapsed_seconds = 0.0;
+        long retry_after_ms = -1; // Retry-After header (e.g. on 429), -1 if absent or unparsable
+
+        bool ok() const { return error.empty() && status_code == 200; }
+    };
+
     // --- Data Fetching Methods ---
+    // Fetch + parse in one call; logs and returns an empty series on any error
     core::TimeSeries<core::Candle> getHistoricalCandleData(
         const std::string& instrument_key,
         const std::string& interval,
@@ -28,6 +41,32 @@ public:
         const std::string& to_date    // YYYY-MM-DD
     );
 
+    // Just the HTTP request. Does not touch client state, so several threads may
+    // call it on one client (the bulk ingest pipeline does).
+    RawResponse fetchHistoricalCandleJson(const std::string& instrument_key,
+                                          const std::string& interval,
+                                          const std::string& from_date,
+                                          const std::string& to_date) const;
+
+    // Candles from a historical-candle response body, streamed by
+    // parseUpstoxCandleJson(); nullopt (error logged) if the body is not a
+    // successful 'data.candles' response. Malformed rows are skipped.
+    static std::optional<core::TimeSeries<core::Candle>> parseHistoricalCandleJson(const std::string& body);
+
+    // Retry-After value in milliseconds: delta-seconds ("120") or an HTTP-date
+    // ("Wed, 21 Oct 2015 07:28:00 GMT", relative to 'now'). nullopt if malformed.
+    static std::optional<long> parseRetryAfter(const std::string& value,
+                                               std::chrono::system_clock::time_point now = std::chrono::system_clock::now());
+
+    // --- Market-data feed ---
+    // One-time wss:// URL for the v3 market-data WebSocket feed
+    // (GET /v3/feed/market-data-feed/authorize); nullopt (error logged) on failure.
+    // Every (re)connect needs a fresh URL.
+    std::optional<std::string> authorizeMarketFeed() const;
+
+    bool hasAccessToken() const { return !access_token_.empty(); }
+    void setTimeoutMs(long timeout_ms) { timeout_ms_ = timeout_ms; }
+
     // --- Other potential methods ---
     // std::vector<InstrumentInfo> getInstrumentMaster(); // Placeholder
 
@@ -38,6 +77,7 @@ private:
     std::string access_token_;
     std::string api_version_ = "v2"; // Or configurable
     std::string base_url_ = "https://api.upstox.com"; // Or configurable
+    long timeout_ms_ = 15000; // Per request
 
     // Helper to perform actual HTTP GET request (implementation later)
     std::string performGetRequest(const std::string& endpoint,
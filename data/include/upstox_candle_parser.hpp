@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include "datatypes.hpp"
+
+namespace data {
+
+// Outcome of streaming one historical-candle response
+struct UpstoxCandleParseResult {
+    bool ok = false;            // Well-formed JSON with status "success" (or none) and a data.candles array
+    std::string status;         // Top-level "status", if present
+    std::string message;        // Top-level "message", or the first errors[].message
+    std::string error;          // Why parsing stopped (syntax error with byte offset), empty otherwise
+    std::size_t rows = 0;       // Candles handed to the callback
+    std::size_t skipped_rows = 0; // data.candles entries that were not [ts, o, h, l, c, v(, oi)]
+};
+
+// Single-pass parser for Upstox historical-candle responses:
+//   {"status":"success","data":{"candles":[["2024-01-01T09:15:00+05:30",o,h,l,c,v,oi],...]}}
+// Walks the buffer once without building a DOM, handing each row to 'on_candle'
+// as soon as it is complete, so memory stays at one candle plus whatever the
+// caller keeps. Rows are decoded positionally with a fast path for plain numbers;
+// anything else in a row (strings, objects, too few fields, a volume or OI beyond
+// the int64 range) skips just that row. Unpaired \u surrogates fail the response.
+// Unrelated keys are skipped without being decoded.
+UpstoxCandleParseResult parseUpstoxCandleJson(std::string_view body,
+                                              const std::function<void(const core::Candle&)>& on_candle);
+
+} // namespace data
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace data {
+
+// FeedResponse.type of the Upstox market-data feed (v3)
+enum class UpstoxFeedType : int {
+    InitialFeed = 0, // Snapshot sent after each subscription
+    LiveFeed = 1,
+    MarketInfo = 2,  // Segment status only, no feeds
+};
+
+// Last-trade data of one instrument in one feed message. Zero-copy: the
+// instrument key points into the message buffer and is only valid during the
+// callback.
+struct UpstoxFeedTick {
+    std::string_view instrument_key;
+    double ltp = 0.0;             // Last traded price
+    std::int64_t ltt_ms = 0;      // Last trade time, ms since the Unix epoch
+    std::int64_t ltq = 0;         // Last traded quantity
+    double close_price = 0.0;     // Previous session's close ("cp")
+    std::int64_t vtt = -1;        // Volume traded today (full / greeks modes), -1 if not sent
+    double open_interest = 0.0;
+    bool has_open_interest = false;
+};
+
+struct UpstoxFeedDecodeResult {
+    bool ok = false;
+    UpstoxFeedType type = UpstoxFeedType::InitialFeed;
+    std::int64_t current_ts_ms = 0; // Server time of the message
+    std::size_t feeds = 0;          // Entries in the feeds map
+    std::size_t ticks = 0;          // Feeds with last-trade data, handed to the callback
+    const char* error = nullptr;    // Static description of the malformed part, if !ok
+};
+
+// Decodes one binary FeedResponse message (MarketDataFeedV3.proto) straight from
+// the receive buffer: protobuf wire format is walked in place, unknown fields are
+// skipped and nothing is allocated, so the only per-message cost is the walk and
+// one 'on_tick' call per instrument. Feeds without LTPC (e.g. pure option greeks)
+// are counted but not reported. Ticks already handed out stay delivered if a later
+// part of the message turns out to be malformed.
+UpstoxFeedDecodeResult decodeUpstoxFeed(std::string_view message,
+                                        const std::function<void(const UpstoxFeedTick&)>& on_tick);
+
+// Appends one FeedResponse message with these ticks to 'out', in the layout the
+// feed sends: LTPC only, or a MarketFullFeed when a tick has 'vtt' or open interest.
+// For replaying stored candles through the live path and for tests.
+void appendUpstoxFeedMessage(std::string& out, UpstoxFeedType type, std::int64_t current_ts_ms,
+                             const std::vector<UpstoxFeedTick>& ticks);
+
+} // namespace data
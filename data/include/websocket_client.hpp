@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// OpenSSL handles, so the header does not pull in <openssl/ssl.h>
+typedef struct ssl_st SSL;
+typedef struct ssl_ctx_st SSL_CTX;
+
+namespace data {
+
+struct WebSocketOptions {
+    int connect_timeout_ms = 5000;                  // TCP connect, TLS and upgrade handshake together
+    int write_timeout_ms = 5000;
+    std::size_t max_message_bytes = 16 * 1024 * 1024; // Larger messages close the connection
+    bool verify_peer = true;                        // Check the server certificate and host name (wss)
+};
+
+// --- WebSocketClient ---
+// Minimal RFC 6455 client over plain TCP (ws://) or TLS (wss://, OpenSSL) for
+// feeds that push binary messages. Frames are parsed where they land in one
+// reused receive buffer, so an unfragmented message is handed out as a view into
+// that buffer without copying. Pings are answered and close frames acknowledged
+// inside receive().
+//
+// Not thread-safe: connect, send and receive from one thread.
+class WebSocketClient {
+public:
+    enum class ReadStatus { Message, Timeout, Closed };
+
+    explicit WebSocketClient(WebSocketOptions options = {});
+    ~WebSocketClient();
+
+    WebSocketClient(const WebSocketClient&) = delete;
+    WebSocketClient& operator=(const WebSocketClient&) = delete;
+
+    // Connects and performs the upgrade handshake; any open connection is closed
+    // first. False (logged) on failure.
+    bool connect(const std::string& url,
+                 const std::vector<std::pair<std::string, std::string>>& headers = {});
+    void close();
+    bool isOpen() const { return fd_ >= 0; }
+
+    bool sendText(std::string_view payload) { return sendFrame(0x1, payload); }
+    bool sendBinary(std::string_view payload) { return sendFrame(0x2, payload); }
+
+    // Waits up to 'timeout_ms' for the next complete data message. On Message,
+    // 'message' points into the client's buffer and stays valid until the next
+    // receive() or close(); 'binary' tells binary from text. Closed means the
+    // peer closed the connection or it failed (logged); reconnect to continue.
+    ReadStatus receive(std::string_view& message, bool& binary, int timeout_ms);
+
+    // Splits "ws[s]://host[:port]/path?query"; false if it is not a WebSocket URL
+    static bool parseUrl(const std::string& url, bool& secure, std::string& host, std::uint16_t& port,
+                         std::string& target);
+
+private:
+    enum class IoStatus { Ok, Timeout, Closed };
+
+    bool sendFrame(std::uint8_t opcode, std::string_view payload);
+    bool writeAll(const char* data, std::size_t size);
+    // Appends whatever arrives before the deadline (steady clock, ms) to the buffer,
+    // moving unconsumed bytes to its front when it runs out of room
+    IoStatus readMore(std::int64_t deadline_ms);
+    bool handshake(const std::string& host, std::uint16_t port, const std::string& target,
+                   const std::vector<std::pair<std::string, std::string>>& headers, std::int64_t deadline_ms);
+    ReadStatus fail(const char* what);
+
+    WebSocketOptions options_;
+    int fd_ = -1;
+    SSL_CTX* ssl_ctx_ = nullptr;
+    SSL* ssl_ = nullptr;
+    std::mt19937 mask_random_;
+
+    std::string buffer_;          // Received bytes; [read_pos_, write_pos_) not consumed yet
+    std::size_t read_pos_ = 0;
+    std::size_t write_pos_ = 0;
+    std::string fragments_;       // Payload of a fragmented message being reassembled
+    std::uint8_t fragment_opcode_ = 0;
+    std::string frame_out_;       // Reused for outgoing frames
+};
+
+} // namespace data
@@ -0,0 +1,113 @@
+#include "candle_coverage.hpp"
+#include "candle_resampler.hpp" // BarInterval
+#include "utils.hpp"            // parseDate / formatDate
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+namespace data {
+
+    namespace { // File-local helpers
+
+        using Days = std::chrono::sys_days;
+
+        struct DayRange {
+            Days from;
+            Days to;
+        };
+
+        std::vector<DayRange> toDayRanges(const std::vector<DateRange>& ranges) {
+            std::vector<DayRange> days;
+            days.reserve(ranges.size());
+            for (const auto& range : ranges) {
+                days.push_back({core::utils::parseDate(range.from_date), core::utils::parseDate(range.to_date)});
+            }
+            std::sort(days.begin(), days.end(), [](const DayRange& a, const DayRange& b) { return a.from < b.from; });
+            return days;
+        }
+
+        bool isWeekend(Days day) {
+            const unsigned weekday = std::chrono::weekday{day}.iso_encoding();
+            return weekday == 6 || weekday == 7;
+        }
+
+        bool contains(const std::vector<DayRange>& ranges, Days day) {
+            return std::any_of(ranges.begin(), ranges.end(),
+                               [day](const DayRange& range) { return range.from <= day && day <= range.to; });
+        }
+
+        DateRange toDateRange(Days from, Days to) {
+            return {core::utils::formatDate(from), core::utils::formatDate(to)};
+        }
+
+    } // namespace
+
+    std::vector<DateRange> findDateGaps(const std::vector<std::string>& dates,
+                                        const std::vector<DateRange>& no_data)
+    {
+        std::vector<DateRange> gaps;
+        const auto excluded = toDayRanges(no_data);
+        for (std::size_t i = 1; i < dates.size(); ++i) {
+            const Days previous = core::utils::parseDate(dates[i - 1]);
+            const Days next = core::utils::parseDate(dates[i]);
+            bool open = false;
+            Days run_start{};
+            Days run_end{};
+            for (Days day = previous + std::chrono::days{1}; day < next; day += std::chrono::days{1}) {
+                if (isWeekend(day) || contains(excluded, day)) continue; // Excused, keeps the run going
+                if (!open) run_start = day;
+                run_end = day;
+                open = true;
+            }
+            if (open) gaps.push_back(toDateRange(run_start, run_end));
+        }
+        return gaps;
+    }
+
+    std::vector<DateRange> missingDateRanges(const SeriesCoverage* coverage,
+                                             const std::string& interval,
+                                             const std::string& from_date,
+                                             const std::string& to_date)
+    {
+        const Days from = core::utils::parseDate(from_date);
+        const Days to = core::utils::parseDate(to_date);
+        if (from > to) return {};
+        const auto excluded = coverage ? toDayRanges(coverage->no_data) : std::vector<DayRange>{};
+
+        std::vector<DateRange> missing;
+        // [start, end] clipped to the requested range, minus the no-data ranges
+        auto add = [&](Days start, Days end) {
+            start = std::max(start, from);
+            end = std::min(end, to);
+            for (const auto& range : excluded) {
+                if (start > end) return;
+                if (range.to < start || range.from > end) continue;
+                if (range.from > start) missing.push_back(toDateRange(start, range.from - std::chrono::days{1}));
+                start = std::max(start, range.to + std::chrono::days{1});
+            }
+            if (start <= end) missing.push_back(toDateRange(start, end));
+        };
+
+        if (!coverage || coverage->row_count == 0) {
+            add(from, to);
+            return missing;
+        }
+
+        const auto spec = BarInterval::parse(interval);
+        const bool intraday = !spec || spec->unit == BarInterval::Unit::Minute;
+        const bool detect_gaps = intraday || spec->unit == BarInterval::Unit::Day;
+        const Days first = core::utils::parseDate(coverage->first_date);
+        const Days last = core::utils::parseDate(coverage->last_date);
+
+        add(from, first - std::chrono::days{1});
+        if (detect_gaps) {
+            for (const auto& gap : coverage->gaps) {
+                add(core::utils::parseDate(gap.from_date), core::utils::parseDate(gap.to_date));
+            }
+        }
+        add(intraday ? last : last + std::chrono::days{1}, to);
+        return missing;
+    }
+
+} // namespace data
@@ -0,0 +1,187 @@
+#include "candle_resampler.hpp"
+#include "utils.hpp" // For epoch nanosecond conversions
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <stdexcept>
+
+namespace data {
+
+    namespace { // File-local helpers
+
+        constexpr std::int64_t kNsPerMinute = 60LL * 1'000'000'000LL;
+        constexpr std::int64_t kNsPerDay = 24LL * 60LL * kNsPerMinute;
+
+        // Floor division (timestamps before the epoch must still round down)
+        std::int64_t floorDiv(std::int64_t a, std::int64_t b) {
+            std::int64_t q = a / b;
+            return (a % b != 0 && ((a < 0) != (b < 0))) ? q - 1 : q;
+        }
+
+        // Leading positive integer of 's' (1 if there is none); 'rest' gets the remainder
+        int leadingCount(const std::string& s, std::string& rest) {
+            std::size_t digits = 0;
+            while (digits < s.size() && std::isdigit(static_cast<unsigned char>(s[digits]))) ++digits;
+            rest = s.substr(digits);
+            if (digits == 0) return 1;
+            try {
+                return std::stoi(s.substr(0, digits));
+            } catch (...) {
+                return 0; // Out of range, rejected by the caller
+            }
+        }
+
+    } // namespace
+
+    std::optional<BarInterval> BarInterval::parse(const std::string& interval) {
+        std::string unit;
+        const int count = leadingCount(interval, unit);
+        if (count <= 0) return std::nullopt;
+
+        BarInterval result;
+        if (unit == "minute") {
+            result.unit = Unit::Minute;
+            result.count = count;
+        } else if (unit == "hour") {
+            result.unit = Unit::Minute;
+            result.count = count * 60;
+        } else if (count == 1 && unit == "day") {
+            result.unit = Unit::Day;
+        } else if (count == 1 && unit == "week") {
+            result.unit = Unit::Week;
+        } else if (count == 1 && unit == "month") {
+            result.unit = Unit::Month;
+        } else {
+            return std::nullopt;
+        }
+        // Intraday buckets are laid out within one day
+        if (result.unit == Unit::Minute && result.count > 24 * 60) return std::nullopt;
+        return result;
+    }
+
+    std::int64_t BarInterval::nominalNs() const {
+        switch (unit) {
+            case Unit::Minute: return count * kNsPerMinute;
+            case Unit::Day:    return kNsPerDay;
+            case Unit::Week:   return 7 * kNsPerDay;
+            case Unit::Month:  return 31 * kNsPerDay;
+        }
+        return 0;
+    }
+
+    std::pair<std::int64_t, std::int64_t> bucketBounds(const BarInterval& interval, std::int64_t timestamp_ns,
+                                                       const ResampleOptions& options)
+    {
+        using namespace std::chrono;
+        const std::int64_t offset_ns = options.utc_offset_minutes * kNsPerMinute;
+        const std::int64_t local_ns = timestamp_ns + offset_ns;
+        const std::int64_t day = floorDiv(local_ns, kNsPerDay);
+        const std::int64_t midnight_ns = day * kNsPerDay;
+
+        std::int64_t start = midnight_ns;
+        std::int64_t end = midnight_ns + kNsPerDay;
+        switch (interval.unit) {
+            case BarInterval::Unit::Minute: {
+                const std::int64_t width = interval.count * kNsPerMinute;
+                const std::int64_t anchor = options.session_open_minutes * kNsPerMinute;
+                const std::int64_t start_in_day = anchor + floorDiv(local_ns - midnight_ns - anchor, width) * width;
+                start = midnight_ns + std::max<std::int64_t>(start_in_day, 0);
+                end = midnight_ns + std::min(start_in_day + width, kNsPerDay);
+                break;
+            }
+            case BarInterval::Unit::Day:
+                break;
+            case BarInterval::Unit::Week: {
+                const sys_days date{days{day}};
+                const std::int64_t since_monday = static_cast<std::int64_t>(weekday{date}.iso_encoding()) - 1;
+                start = (day - since_monday) * kNsPerDay;
+                end = start + 7 * kNsPerDay;
+                break;
+            }
+            case BarInterval::Unit::Month: {
+                const year_month_day ymd{sys_days{days{day}}};
+                const year_month first = ymd.year() / ymd.month();
+                const sys_days month_start{first / 1};
+                const sys_days next_start{(first + months{1}) / 1};
+                start = static_cast<std::int64_t>(month_start.time_since_epoch().count()) * kNsPerDay;
+                end = static_cast<std::int64_t>(next_start.time_since_epoch().count()) * kNsPerDay;
+                break;
+            }
+        }
+        return {start - offset_ns, end - offset_ns};
+    }
+
+    ResampledSeries resampleCandles(const core::CandleSeries& base,
+                                    const std::string& base_interval,
+                                    const std::string& target_interval,
+                                    const ResampleOptions& options)
+    {
+        const auto base_spec = BarInterval::parse(base_interval);
+        const auto target_spec = BarInterval::parse(target_interval);
+        if (!base_spec) throw std::invalid_argument("Unknown base interval for resampling: " + base_interval);
+        if (!target_spec) throw std::invalid_argument("Unknown target interval for resampling: " + target_interval);
+        if (target_spec->nominalNs() < base_spec->nominalNs()) {
+            throw std::invalid_argument("Cannot resample " + base_interval + " bars to the finer interval " + target_interval);
+        }
+
+        const std::size_t n = base.size();
+        const auto ts = base.timestampsNs();
+        const auto open = base.open();
+        const auto high = base.high();
+        const auto low = base.low();
+        const auto close = base.close();
+        const auto volume = base.volume();
+        const auto oi = base.openInterest();
+
+        ResampledSeries result;
+        result.completed.resize(n);
+        core::CandleSeries::Builder builder;
+
+        core::Candle bucket;             // Bar being accumulated
+        double bucket_volume = 0.0;      // Summed as double, like the volume column
+        std::int64_t bucket_end = 0;
+        bool has_bucket = false;
+        std::uint32_t closed = 0;        // Buckets already handed to the builder
+
+        auto flush = [&]() {
+            bucket.volume = static_cast<long long>(bucket_volume);
+            builder.push_back(bucket);
+            ++closed;
+        };
+
+        for (std::size_t i = 0; i < n; ++i) {
+            if (!has_bucket || ts[i] >= bucket_end) {
+                if (has_bucket) flush();
+                const auto [start, end] = bucketBounds(*target_spec, ts[i], options);
+                bucket = core::Candle{};
+                bucket.timestamp = core::utils::epochNanosToTimestamp(start);
+                bucket.open = open[i];
+                bucket.high = high[i];
+                bucket.low = low[i];
+                bucket_volume = 0.0;
+                bucket_end = end;
+                has_bucket = true;
+            } else {
+                bucket.high = std::max(bucket.high, high[i]);
+                bucket.low = std::min(bucket.low, low[i]);
+            }
+            bucket.close = close[i];
+            bucket_volume += volume[i];
+            if (!oi.empty() && oi[i] != core::kNoOpenInterest) bucket.open_interest = oi[i];
+
+            // Visible from this bar on only if this bar closes the bucket
+            const std::int64_t bar_end = bucketBounds(*base_spec, ts[i], options).second;
+            result.completed[i] = closed + (bar_end >= bucket_end ? 1u : 0u);
+        }
+        if (has_bucket) flush();
+
+        result.bars = builder.build();
+        return result;
+    }
+
+    std::string resampledIntervalKey(const std::string& base_interval, const std::string& target_interval) {
+        return target_interval + "_from_" + base_interval;
+    }
+
+} // namespace data
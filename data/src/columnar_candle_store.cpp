@@ -0,0 +1,413 @@
+#include "columnar_candle_store.hpp"
+#include "database_manager.hpp"
+#include "logging.hpp"
+#include "exceptions.hpp"
+#include "utils.hpp" // For epoch nanosecond conversions
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>     // open
+#include <sys/mman.h>  // mmap, madvise
+#include <sys/stat.h>  // fstat
+#include <unistd.h>    // close
+
+namespace data {
+
+    namespace { // File-local helpers
+
+        std::uint64_t alignUp(std::uint64_t offset) {
+            return (offset + kColumnarAlignment - 1) / kColumnarAlignment * kColumnarAlignment;
+        }
+
+        // Pads the stream with zeros up to the next 64-byte boundary and returns that offset
+        std::uint64_t padTo64(std::ofstream& out, std::uint64_t offset) {
+            static const char zeros[kColumnarAlignment] = {};
+            std::uint64_t aligned = alignUp(offset);
+            out.write(zeros, static_cast<std::streamsize>(aligned - offset));
+            return aligned;
+        }
+
+        template <typename T>
+        std::uint64_t writeColumn(std::ofstream& out, std::uint64_t offset, const std::vector<T>& values) {
+            out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+            return offset + values.size() * sizeof(T);
+        }
+
+        // Keeps file names readable while staying filesystem-safe ("NSE_EQ|INE..." -> "NSE_EQ_INE...")
+        std::string sanitize(const std::string& text) {
+            std::string out;
+            out.reserve(text.size());
+            for (char c : text) {
+                out += (std::isalnum(static_cast<unsigned char>(c)) || c == '-') ? c : '_';
+            }
+            return out;
+        }
+
+        void copyName(char* dest, std::size_t capacity, const std::string& value) {
+            std::memset(dest, 0, capacity);
+            std::memcpy(dest, value.data(), std::min(value.size(), capacity - 1));
+        }
+
+    } // end anonymous namespace
+
+    // --- ColumnarCandleFile ---
+
+    ColumnarCandleFile::ColumnarCandleFile(const std::string& path) : path_(path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw core::DataLoadException("Cannot open columnar candle file: " + path);
+        }
+        struct stat st{};
+        if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(ColumnarFileHeader)) {
+            ::close(fd);
+            throw core::DataLoadException("Columnar candle file too small or unreadable: " + path);
+        }
+        mapped_size_ = static_cast<std::size_t>(st.st_size);
+        void* mapping = ::mmap(nullptr, mapped_size_, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd); // The mapping keeps its own reference to the file
+        if (mapping == MAP_FAILED) {
+            throw core::DataLoadException("Failed to mmap columnar candle file: " + path);
+        }
+        data_ = static_cast<const std::byte*>(mapping);
+        header_ = reinterpret_cast<const ColumnarFileHeader*>(data_);
+
+        auto fail = [&](const std::string& reason) {
+            ::munmap(const_cast<std::byte*>(data_), mapped_size_);
+            data_ = nullptr;
+            throw core::DataLoadException("Invalid columnar candle file '" + path + "': " + reason);
+        };
+        if (std::memcmp(header_->magic, kColumnarMagic, sizeof(kColumnarMagic)) != 0) fail("bad magic");
+        if (header_->version != kColumnarVersion) fail("unsupported version " + std::to_string(header_->version));
+        // Both names are read as C strings later on
+        if (!std::memchr(header_->instrument_key, '\0', sizeof(header_->instrument_key))) fail("unterminated instrument key");
+        if (!std::memchr(header_->interval, '\0', sizeof(header_->interval))) fail("unterminated interval");
+        for (std::size_t c = 0; c < kColumnarColumnCount; ++c) {
+            const std::uint64_t offset = header_->column_offsets[c];
+            if (offset == 0) {
+                if (c != kColOpenInterest) fail("missing column " + std::to_string(c));
+                continue;
+            }
+            if (offset % kColumnarAlignment != 0) fail("misaligned column " + std::to_string(c));
+            // Divided rather than multiplied, so a corrupt row count cannot wrap past the check
+            if (offset > mapped_size_ || header_->row_count > (mapped_size_ - offset) / sizeof(std::int64_t)) {
+                fail("truncated column " + std::to_string(c));
+            }
+        }
+        const std::uint64_t block_index_offset = header_->block_index_offset;
+        if (block_index_offset > mapped_size_ ||
+            header_->block_count > (mapped_size_ - block_index_offset) / sizeof(ColumnarBlockIndexEntry)) {
+            fail("truncated block index");
+        }
+        if (block_index_offset % alignof(ColumnarBlockIndexEntry) != 0) fail("misaligned block index");
+        // findRange() indexes the columns with these rows
+        for (const auto& block : blockIndex()) {
+            if (block.first_row >= header_->row_count) fail("block index row past the end");
+        }
+
+        // Backtests scan whole ranges front to back
+        ::madvise(const_cast<std::byte*>(data_), mapped_size_, MADV_SEQUENTIAL);
+        core::logging::getLogger()->debug("Mapped columnar file {} ({} rows, {} blocks).",
+                                          path, header_->row_count, header_->block_count);
+    }
+
+    ColumnarCandleFile::~ColumnarCandleFile() {
+        if (data_) {
+            ::munmap(const_cast<std::byte*>(data_), mapped_size_);
+        }
+    }
+
+    std::span<const double> ColumnarCandleFile::doubleColumn(ColumnarColumn column) const {
+        return {reinterpret_cast<const double*>(data_ + header_->column_offsets[column]), size()};
+    }
+
+    std::span<const std::int64_t> ColumnarCandleFile::int64Column(ColumnarColumn column) const {
+        return {reinterpret_cast<const std::int64_t*>(data_ + header_->column_offsets[column]), size()};
+    }
+
+    std::span<const std::int64_t> ColumnarCandleFile::openInterest() const {
+        if (!hasOpenInterest() || header_->column_offsets[kColOpenInterest] == 0) return {};
+        return int64Column(kColOpenInterest);
+    }
+
+    std::span<const ColumnarBlockIndexEntry> ColumnarCandleFile::blockIndex() const {
+        return {reinterpret_cast<const ColumnarBlockIndexEntry*>(data_ + header_->block_index_offset), header_->block_count};
+    }
+
+    std::pair<std::size_t, std::size_t> ColumnarCandleFile::findRange(std::int64_t start_ns, std::int64_t end_ns) const {
+        const auto ts = timestamps();
+        const auto blocks = blockIndex();
+        if (ts.empty() || blocks.empty() || start_ns > end_ns) return {0, 0};
+
+        // Narrow to the blocks overlapping [start_ns, end_ns], then search inside them only
+        auto first_block = std::lower_bound(blocks.begin(), blocks.end(), start_ns,
+            [](const ColumnarBlockIndexEntry& b, std::int64_t value) { return b.last_timestamp_ns < value; });
+        if (first_block == blocks.end()) return {ts.size(), ts.size()};
+        auto last_block = std::upper_bound(first_block, blocks.end(), end_ns,
+            [](std::int64_t value, const ColumnarBlockIndexEntry& b) { return value < b.first_timestamp_ns; });
+
+        const std::size_t lo = static_cast<std::size_t>(first_block->first_row);
+        const std::size_t hi = (last_block == blocks.end()) ? ts.size() : static_cast<std::size_t>(last_block->first_row);
+        const std::size_t first = static_cast<std::size_t>(std::lower_bound(ts.begin() + lo, ts.begin() + hi, start_ns) - ts.begin());
+        const std::size_t last = static_cast<std::size_t>(std::upper_bound(ts.begin() + first, ts.begin() + hi, end_ns) - ts.begin());
+        return {first, last};
+    }
+
+    core::TimeSeries<core::Candle> ColumnarCandleFile::materialize(std::size_t first, std::size_t last) const {
+        core::TimeSeries<core::Candle> candles;
+        if (first >= last) return candles;
+        candles.resize(last - first);
+
+        const auto ts = timestamps();
+        const auto o = open();
+        const auto h = high();
+        const auto l = low();
+        const auto c = close();
+        const auto v = volume();
+        const auto oi = openInterest();
+        for (std::size_t i = first; i < last; ++i) {
+            core::Candle& candle = candles[i - first];
+            candle.timestamp = core::utils::epochNanosToTimestamp(ts[i]);
+            candle.open = o[i];
+            candle.high = h[i];
+            candle.low = l[i];
+            candle.close = c[i];
+            candle.volume = static_cast<long long>(v[i]);
+            if (!oi.empty() && oi[i] != core::kNoOpenInterest) candle.open_interest = oi[i];
+        }
+        return candles;
+    }
+
+    core::CandleSeries ColumnarCandleFile::series(std::size_t first, std::size_t last) const {
+        if (first >= last) return {};
+        const std::size_t n = last - first;
+        const auto oi = openInterest();
+        return core::CandleSeries(shared_from_this(),
+                                  timestamps().subspan(first, n),
+                                  open().subspan(first, n), high().subspan(first, n),
+                                  low().subspan(first, n), close().subspan(first, n),
+                                  volume().subspan(first, n),
+                                  oi.empty() ? oi : oi.subspan(first, n));
+    }
+
+    bool ColumnarCandleFile::write(const std::string& path,
+                                   const std::string& instrument_key,
+                                   const std::string& interval,
+                                   const core::TimeSeries<core::Candle>& candles,
+                                   std::uint32_t block_rows)
+    {
+        auto logger = core::logging::getLogger();
+        if (block_rows == 0) block_rows = kColumnarDefaultBlockRows;
+        if (!std::is_sorted(candles.begin(), candles.end())) {
+            logger->error("Cannot write columnar file {}: candles are not sorted by timestamp.", path);
+            return false;
+        }
+
+        // Split AoS candles into columns
+        const std::size_t n = candles.size();
+        std::vector<std::int64_t> ts(n), oi(n);
+        std::vector<double> open(n), high(n), low(n), close(n), volume(n);
+        bool has_oi = false;
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto& candle = candles[i];
+            ts[i] = core::utils::timestampToEpochNanos(candle.timestamp);
+            open[i] = candle.open;
+            high[i] = candle.high;
+            low[i] = candle.low;
+            close[i] = candle.close;
+            volume[i] = static_cast<double>(candle.volume);
+            oi[i] = candle.open_interest.value_or(core::kNoOpenInterest);
+            has_oi |= candle.open_interest.has_value();
+        }
+
+        std::vector<ColumnarBlockIndexEntry> blocks;
+        for (std::size_t first = 0; first < n; first += block_rows) {
+            std::size_t last = std::min(n, first + block_rows) - 1;
+            blocks.push_back({ts[first], ts[last], static_cast<std::uint64_t>(first)});
+        }
+
+        ColumnarFileHeader header{};
+        std::memcpy(header.magic, kColumnarMagic, sizeof(kColumnarMagic));
+        header.version = kColumnarVersion;
+        header.flags = has_oi ? kColumnarHasOpenInterest : 0;
+        header.row_count = n;
+        header.block_rows = block_rows;
+        header.block_count = static_cast<std::uint32_t>(blocks.size());
+        copyName(header.instrument_key, sizeof(header.instrument_key), instrument_key);
+        copyName(header.interval, sizeof(header.interval), interval);
+
+        // Offsets are fully determined by the row count, so compute them up front
+        std::uint64_t offset = alignUp(sizeof(ColumnarFileHeader));
+        const std::size_t column_count = has_oi ? kColumnarColumnCount : kColOpenInterest;
+        for (std::size_t c = 0; c < column_count; ++c) {
+            header.column_offsets[c] = offset;
+            offset = alignUp(offset + n * sizeof(std::int64_t)); // All columns are 8 bytes wide
+        }
+        header.block_index_offset = offset;
+
+        // Own temporary name, so concurrent exports of the same series cannot interleave
+        const std::string tmp_path = core::utils::uniqueTempPath(path);
+        {
+            std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+            if (!out.is_open()) {
+                logger->error("Cannot create columnar file: {}", tmp_path);
+                return false;
+            }
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            std::uint64_t pos = padTo64(out, sizeof(header));
+            pos = padTo64(out, writeColumn(out, pos, ts));
+            pos = padTo64(out, writeColumn(out, pos, open));
+            pos = padTo64(out, writeColumn(out, pos, high));
+            pos = padTo64(out, writeColumn(out, pos, low));
+            pos = padTo64(out, writeColumn(out, pos, close));
+            pos = padTo64(out, writeColumn(out, pos, volume));
+            if (has_oi) pos = padTo64(out, writeColumn(out, pos, oi));
+            writeColumn(out, pos, blocks);
+            if (!out) {
+                logger->error("Failed writing columnar file: {}", tmp_path);
+                out.close();
+                std::error_code ec;
+                std::filesystem::remove(tmp_path, ec);
+                return false;
+            }
+        }
+        std::error_code ec;
+        std::filesystem::rename(tmp_path, path, ec);
+        if (ec) {
+            logger->error("Cannot finalize columnar file '{}': {}", path, ec.message());
+            std::filesystem::remove(tmp_path, ec);
+            return false;
+        }
+        logger->debug("Wrote columnar file {} ({} rows, {} blocks).", path, n, blocks.size());
+        return true;
+    }
+
+    // --- ColumnarCandleStore ---
+
+    ColumnarCandleStore::ColumnarCandleStore(std::string directory) : directory_(std::move(directory)) {
+        core::logging::getLogger()->debug("ColumnarCandleStore created for directory: {}", directory_);
+    }
+
+    bool ColumnarCandleStore::connect() {
+        std::error_code ec;
+        connected_ = std::filesystem::is_directory(directory_, ec);
+        if (!connected_) {
+            core::logging::getLogger()->error("Columnar candle directory does not exist: {}", directory_);
+        }
+        return connected_;
+    }
+
+    std::string ColumnarCandleStore::pathFor(const std::string& instrument_key, const std::string& interval) const {
+        return (std::filesystem::path(directory_) / (sanitize(instrument_key) + "__" + sanitize(interval) + ".tpcol")).string();
+    }
+
+    std::shared_ptr<const ColumnarCandleFile> ColumnarCandleStore::openSeries(const std::string& instrument_key,
+                                                                              const std::string& interval)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto key = std::make_pair(instrument_key, interval);
+        auto it = open_files_.find(key);
+        if (it != open_files_.end()) return it->second;
+
+        std::string path = pathFor(instrument_key, interval);
+        std::error_code ec;
+        if (!std::filesystem::exists(path, ec)) {
+            core::logging::getLogger()->warn("No columnar file for {} ({}): {}", instrument_key, interval, path);
+            return nullptr;
+        }
+        auto file = std::make_shared<const ColumnarCandleFile>(path);
+        // Sanitized names can collide; the header holds the exact key
+        if (instrument_key != file->header().instrument_key || interval != file->header().interval) {
+            throw core::DataLoadException("Columnar file " + path + " belongs to a different series (" +
+                                          file->header().instrument_key + ", " + file->header().interval + ")");
+        }
+        open_files_.emplace(key, file);
+        return file;
+    }
+
+    core::TimeSeries<core::Candle> ColumnarCandleStore::queryCandles(const std::string& instrument_key,
+                                                                     const std::string& interval,
+                                                                     core::Timestamp start_time,
+                                                                     core::Timestamp end_time)
+    {
+        auto logger = core::logging::getLogger();
+        if (!isConnected()) {
+            logger->error("Cannot query candles: Columnar store not connected.");
+            return {};
+        }
+        auto file = openSeries(instrument_key, interval);
+        if (!file) return {};
+
+        auto [first, last] = file->findRange(core::utils::timestampToEpochNanos(start_time),
+                                             core::utils::timestampToEpochNanos(end_time));
+        logger->debug("Columnar query for {} ({}): rows [{}, {}) of {}.", instrument_key, interval, first, last, file->size());
+        return file->materialize(first, last);
+    }
+
+    core::CandleSeries ColumnarCandleStore::queryCandleSeries(const std::string& instrument_key,
+                                                              const std::string& interval,
+                                                              core::Timestamp start_time,
+                                                              core::Timestamp end_time)
+    {
+        auto logger = core::logging::getLogger();
+        if (!isConnected()) {
+            logger->error("Cannot query candles: Columnar store not connected.");
+            return {};
+        }
+        auto file = openSeries(instrument_key, interval);
+        if (!file) return {};
+
+        auto [first, last] = file->findRange(core::utils::timestampToEpochNanos(start_time),
+                                             core::utils::timestampToEpochNanos(end_time));
+        logger->debug("Columnar series view for {} ({}): rows [{}, {}) of {}.", instrument_key, interval, first, last, file->size());
+        return file->series(first, last);
+    }
+
+    ColumnarCandleStore::ExportStats ColumnarCandleStore::exportFromDatabase(DatabaseManager& db_manager,
+                                                        const std::string& directory,
+                                                        const std::vector<std::string>& instrument_filter,
+                                                        const std::string& interval_filter)
+    {
+        auto logger = core::logging::getLogger();
+        if (!db_manager.isConnected() && !db_manager.connect()) {
+            throw core::DataLoadException("Failed to connect to DB for columnar export.");
+        }
+        std::error_code ec;
+        std::filesystem::create_directories(directory, ec);
+        if (ec) {
+            throw core::DataLoadException("Cannot create columnar output directory '" + directory + "': " + ec.message());
+        }
+
+        // Wide enough for any stored candle, and representable in both timestamp schemas
+        const auto range_start = core::utils::stringToTimestamp("1970-01-01T00:00:00Z");
+        const auto range_end = core::utils::stringToTimestamp("2200-01-01T00:00:00Z");
+
+        ColumnarCandleStore target(directory);
+        ExportStats stats;
+        for (const auto& [instrument_key, interval] : db_manager.listCandleSeries()) {
+            if (!instrument_filter.empty() &&
+                std::find(instrument_filter.begin(), instrument_filter.end(), instrument_key) == instrument_filter.end()) {
+                continue;
+            }
+            if (!interval_filter.empty() && interval != interval_filter) continue;
+
+            auto candles = db_manager.queryCandles(instrument_key, interval, range_start, range_end);
+            std::string path = target.pathFor(instrument_key, interval);
+            if (!ColumnarCandleFile::write(path, instrument_key, interval, candles)) {
+                logger->error("Export failed for {} ({}).", instrument_key, interval);
+                ++stats.failed;
+                continue;
+            }
+            logger->info("Exported {} candles for {} ({}) -> {}", candles.size(), instrument_key, interval, path);
+            ++stats.written;
+        }
+        logger->info("Columnar export complete: {} files written to {}, {} failed.", stats.written, directory, stats.failed);
+        return stats;
+    }
+
+} // namespace data
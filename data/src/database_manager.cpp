@@ -8,6 +8,7 @@
 #include <iostream>
 #include <chrono> // For time point conversions
 #include <atomic> 
+#include <string_view>
 #include <vector>
 #include <stdexcept>
 #include <chrono>
@@ -15,8 +16,64 @@
 namespace data
 {
 
-    DatabaseManager::DatabaseManager(const std::string &db_path)
-        : database_path_(db_path), db_(nullptr), connected_(false) // Initialize db_ to nullptr
+    namespace { // File-local helpers
+
+        // historical_candles at kSchemaVersionEpochNanos. The primary key already covers
+        // (instrument_key, interval, timestamp) range scans, so no extra index is needed.
+        std::string createCandlesEpochSql(const std::string& table_name) {
+            return "CREATE TABLE IF NOT EXISTS " + table_name + R"( (
+            instrument_key TEXT NOT NULL,
+            interval TEXT NOT NULL,
+            timestamp INTEGER NOT NULL, -- Nanoseconds since Unix epoch (UTC)
+            open REAL,
+            high REAL,
+            low REAL,
+            close REAL,
+            volume INTEGER,
+            open_interest INTEGER,
+            PRIMARY KEY (instrument_key, interval, timestamp)
+        );
+    )";
+        }
+
+        // Coverage metadata maintained by DatabaseManager::refreshCoverage()
+        const char *kCreateCoverageSql = R"(
+        CREATE TABLE IF NOT EXISTS candle_coverage (
+            instrument_key TEXT NOT NULL,
+            interval TEXT NOT NULL,
+            first_timestamp INTEGER NOT NULL, -- Nanoseconds since Unix epoch (UTC)
+            last_timestamp INTEGER NOT NULL,
+            first_date TEXT NOT NULL,         -- Local (IST) dates, YYYY-MM-DD
+            last_date TEXT NOT NULL,
+            row_count INTEGER NOT NULL,
+            updated_at TEXT NOT NULL DEFAULT CURRENT_TIMESTAMP,
+            PRIMARY KEY (instrument_key, interval)
+        );
+    )";
+        // Open gaps (no_data = 0) are rewritten on every refresh; no-data ranges are kept
+        const char *kCreateGapsSql = R"(
+        CREATE TABLE IF NOT EXISTS candle_gaps (
+            instrument_key TEXT NOT NULL,
+            interval TEXT NOT NULL,
+            from_date TEXT NOT NULL,
+            to_date TEXT NOT NULL,
+            no_data INTEGER NOT NULL DEFAULT 0,
+            PRIMARY KEY (instrument_key, interval, no_data, from_date)
+        );
+    )";
+
+        // Local (IST) midnight offset for bucketing epoch timestamps into dates
+        constexpr long long kIstOffsetNanos = (5LL * 60 + 30) * 60 * 1'000'000'000LL;
+        constexpr long long kNanosPerDay = 86'400LL * 1'000'000'000LL;
+
+        bool isInMemoryPath(const std::string& path) {
+            return path.empty() || path == ":memory:" || path.rfind("file::memory:", 0) == 0;
+        }
+
+    } // end anonymous namespace
+
+    DatabaseManager::DatabaseManager(const std::string &db_path, SqliteOptions options)
+        : database_path_(db_path), options_(options), db_(nullptr), connected_(false) // Initialize db_ to nullptr
     {
         core::logging::getLogger()->debug("DatabaseManager (SQLite) created for path: {}", db_path);
     }
@@ -37,25 +94,43 @@ namespace data
 
         core::logging::getLogger()->info("Connecting to SQLite database: {}", database_path_);
 
-        // SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE: Open for reading/writing, create if not exists
-        // SQLITE_OPEN_NOMUTEX: Use thread-safe mode if your app might be multi-threaded later
-        int rc = sqlite3_open_v2(database_path_.c_str(), &db_,
-                                 SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX,
-                                 nullptr);
-
-        if (rc != SQLITE_OK)
+        // SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE: Open for reading/writing, create if not exists.
+        // Each connection is used by one thread at a time (NOMUTEX); concurrent
+        // readers get their own connection from the pool instead.
+        try
         {
-            core::logging::getLogger()->error("Cannot open SQLite database '{}': {}", database_path_, sqlite3_errmsg(db_));
-            sqlite3_close(db_); // Close handle even if open failed (as per docs)
-            db_ = nullptr;
+            writer_ = std::make_unique<SqliteConnection>(database_path_, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, options_);
+        }
+        catch (const core::DataLoadException &e)
+        {
+            core::logging::getLogger()->error("{}", e.what());
             return false;
         }
+        db_ = writer_->handle();
 
         connected_ = true;
-        core::logging::getLogger()->info("Successfully connected to SQLite database: {}", database_path_);
-        // Optional: Set busy timeout, WAL mode, etc.
-        // sqlite3_busy_timeout(db_, 5000); // Wait 5 seconds if busy
-        // executeSQL("PRAGMA journal_mode=WAL;"); // Enable Write-Ahead Logging for better concurrency
+        const bool in_memory = isInMemoryPath(database_path_);
+        // WAL is persistent in the file and lets the read pool run alongside a writer
+        if (options_.wal && !in_memory)
+        {
+            executeSQL("PRAGMA journal_mode = WAL;");
+        }
+        schema_version_ = readSchemaVersion();
+        core::logging::getLogger()->info("Successfully connected to SQLite database: {} (schema version {})",
+                                         database_path_, schema_version_);
+        if (schema_version_ < kCurrentSchemaVersion && tableExists("historical_candles")) {
+            core::logging::getLogger()->warn("Database uses TEXT candle timestamps (slow to load). "
+                                             "Run the 'migrate' command to convert it to schema version {}.",
+                                             kCurrentSchemaVersion);
+        }
+        // Every read-only connection to ":memory:" would be a different, empty database
+        if (!in_memory)
+        {
+            readers_ = std::make_unique<SqliteConnectionPool>(database_path_, options_);
+            core::logging::getLogger()->debug("Read pool for {}: up to {} connection(s), mmap {} bytes, cache {} KiB.",
+                                              database_path_, readers_->maxConnections(),
+                                              options_.mmap_size_bytes, options_.cache_size_kib);
+        }
         return true;
     }
 
@@ -64,13 +139,9 @@ namespace data
         if (connected_)
         {
             core::logging::getLogger()->info("Disconnecting from SQLite database: {}", database_path_);
-            int rc = sqlite3_close(db_); // Use sqlite3_close_v2 for more robust error handling if needed
-            if (rc != SQLITE_OK)
-            {
-                // This usually happens if prepared statements are not finalized
-                core::logging::getLogger()->error("Error disconnecting from SQLite database: {}", sqlite3_errmsg(db_));
-                // You might still want to nullify the pointer
-            }
+            // Readers first; the writer finalizes its cached statements before closing
+            readers_.reset();
+            writer_.reset();
             db_ = nullptr;
             connected_ = false;
         }
@@ -80,6 +151,18 @@ namespace data
         }
     }
 
+    template <typename Body>
+    auto DatabaseManager::withReadConnection(Body&& body)
+    {
+        if (readers_)
+        {
+            auto lease = readers_->acquire();
+            return body(*lease);
+        }
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        return body(*writer_);
+    }
+
     bool DatabaseManager::isConnected() const
     {
         // A more robust check might involve a simple PRAGMA query, but this is usually sufficient
@@ -111,6 +194,47 @@ namespace data
         return true;
     }
 
+    int DatabaseManager::readSchemaVersion()
+    {
+        sqlite3_stmt *stmt = nullptr;
+        int version = kSchemaVersionTextTimestamps;
+        if (sqlite3_prepare_v2(db_, "PRAGMA user_version;", -1, &stmt, nullptr) == SQLITE_OK &&
+            sqlite3_step(stmt) == SQLITE_ROW)
+        {
+            version = sqlite3_column_int(stmt, 0);
+        }
+        else
+        {
+            core::logging::getLogger()->error("Failed to read schema version: {}", sqlite3_errmsg(db_));
+        }
+        sqlite3_finalize(stmt);
+        return version;
+    }
+
+    bool DatabaseManager::setSchemaVersion(int version)
+    {
+        // PRAGMA arguments cannot be bound, the value is an int we control
+        if (!executeSQL(fmt::format("PRAGMA user_version = {};", version)))
+        {
+            return false;
+        }
+        schema_version_ = version;
+        return true;
+    }
+
+    bool DatabaseManager::tableExists(const std::string &table_name)
+    {
+        sqlite3_stmt *stmt = nullptr;
+        bool exists = false;
+        if (sqlite3_prepare_v2(db_, "SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = ?;", -1, &stmt, nullptr) == SQLITE_OK)
+        {
+            sqlite3_bind_text(stmt, 1, table_name.c_str(), -1, SQLITE_STATIC);
+            exists = (sqlite3_step(stmt) == SQLITE_ROW);
+        }
+        sqlite3_finalize(stmt);
+        return exists;
+    }
+
     bool DatabaseManager::initializeSchema()
     {
         if (!isConnected())
@@ -169,9 +293,21 @@ namespace data
         // Execute each statement
         bool success = true;
         success &= executeSQL(create_instruments_sql);
-        success &= executeSQL(create_candles_sql);
-        success &= executeSQL(create_candles_index_sql); // Add index creation
+        if (!tableExists("historical_candles"))
+        {
+            // Fresh database: create the current (INTEGER timestamp) layout
+            success &= executeSQL(createCandlesEpochSql("historical_candles"));
+            success &= setSchemaVersion(kCurrentSchemaVersion);
+        }
+        else if (schema_version_ == kSchemaVersionTextTimestamps)
+        {
+            // Existing legacy table: keep it usable as-is until migrated
+            success &= executeSQL(create_candles_sql);
+            success &= executeSQL(create_candles_index_sql); // Add index creation
+        }
         success &= executeSQL(create_constituents_sql);
+        success &= executeSQL(kCreateCoverageSql);
+        success &= executeSQL(kCreateGapsSql);
 
         if (success)
         {
@@ -196,96 +332,147 @@ namespace data
         core::Timestamp end_time)
     {
         core::TimeSeries<core::Candle> candles;
+        queryCandleRows(instrument_key, interval, start_time, end_time,
+                        [&](const core::Candle& candle) { candles.push_back(candle); });
+        return candles;
+    }
+
+    core::CandleSeries DatabaseManager::queryCandleSeries(
+        const std::string& instrument_key,
+        const std::string& interval,
+        core::Timestamp start_time,
+        core::Timestamp end_time)
+    {
+        // Fill the columns straight from the rows, without an intermediate Candle vector
+        core::CandleSeries::Builder builder;
+        queryCandleRows(instrument_key, interval, start_time, end_time,
+                        [&](const core::Candle& candle) { builder.push_back(candle); });
+        return builder.build();
+    }
+
+    std::size_t DatabaseManager::queryCandleRows(
+        const std::string& instrument_key,
+        const std::string& interval,
+        core::Timestamp start_time,
+        core::Timestamp end_time,
+        const std::function<void(const core::Candle&)>& on_row)
+    {
+        std::size_t candle_count = 0;
         auto logger = core::logging::getLogger();
         if (!isConnected()) {
             logger->error("Cannot query candles: Not connected to database.");
-            return candles; // Return empty vector
+            return candle_count;
         }
     
+        // INTEGER schema: bind and read epoch nanoseconds directly, no string conversion.
+        // Legacy TEXT schema: compare IST strings and parse every row.
+        const bool integer_timestamps = (schema_version_ >= kSchemaVersionEpochNanos);
+
         // Convert C++ Timestamps to IST string format matching the database
-        std::string start_str = core::utils::timestampToString(start_time);
-        std::string end_str = core::utils::timestampToString(end_time);
-    
-        logger->debug("Querying candles for {} ({}) between TEXT '{}' and '{}'",
-                       instrument_key, interval, start_str, end_str);
+        std::string start_str;
+        std::string end_str;
+        if (integer_timestamps) {
+            logger->debug("Querying candles for {} ({}) between epoch ns {} and {}", instrument_key, interval,
+                          core::utils::timestampToEpochNanos(start_time), core::utils::timestampToEpochNanos(end_time));
+        } else {
+            start_str = core::utils::timestampToString(start_time);
+            end_str = core::utils::timestampToString(end_time);
+            logger->debug("Querying candles for {} ({}) between TEXT '{}' and '{}'",
+                           instrument_key, interval, start_str, end_str);
+        }
     
-        // Prepare the SQL statement - Compare timestamps as TEXT
+        // Prepare the SQL statement - Compare timestamps as TEXT or INTEGER (same text for both)
         const char* sql = R"(
             SELECT timestamp, open, high, low, close, volume -- No open_interest
             FROM historical_candles
             WHERE instrument_key = ?          -- Placeholder 1
               AND interval = ?                -- Placeholder 2
-              AND timestamp >= ?              -- Placeholder 3 (compare as TEXT)
-              AND timestamp <= ?              -- Placeholder 4 (compare as TEXT)
+              AND timestamp >= ?              -- Placeholder 3
+              AND timestamp <= ?              -- Placeholder 4
             ORDER BY timestamp ASC;
         )";
     
-        sqlite3_stmt *stmt = nullptr; // Prepared statement handle
-        int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr); // Prepare statement
-    
-        if (rc != SQLITE_OK) {
-            logger->error("Failed to prepare SQL statement (text compare) [{}]: {}", rc, sqlite3_errmsg(db_));
-            sqlite3_finalize(stmt); // Finalize even if prepare failed
-            return candles; // Return empty
-        } else {
-             logger->trace("Successfully prepared SQL statement for text comparison.");
-        }
-    
-        // Bind parameters
-        // Index is 1-based
-        sqlite3_bind_text(stmt, 1, instrument_key.c_str(), -1, SQLITE_STATIC);
-        sqlite3_bind_text(stmt, 2, interval.c_str(), -1, SQLITE_STATIC);
-        // Bind start/end times as TEXT strings (in matching +05:30 format)
-        sqlite3_bind_text(stmt, 3, start_str.c_str(), -1, SQLITE_STATIC);
-        sqlite3_bind_text(stmt, 4, end_str.c_str(), -1, SQLITE_STATIC);
+        // Prepared once per pooled connection; concurrent callers use different connections
+        try {
+            withReadConnection([&](SqliteConnection& connection) {
+                auto statement = connection.statement(sql);
+                if (!statement) {
+                    return; // Prepare error already logged
+                }
+                sqlite3_stmt *stmt = statement.get();
+                int rc = SQLITE_OK;
     
-        // Execute the statement step-by-step and fetch rows
-        int row_count = 0;
-        logger->trace("Starting sqlite3_step loop for candle query...");
-        while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
-            row_count++;
-            logger->trace("Processing row {}", row_count);
-            // A row of data is available
-            try {
-                core::Candle candle;
-                // Retrieve data by column index (0-based)
-                const unsigned char *ts_text = sqlite3_column_text(stmt, 0);
-                if (ts_text) {
-                    logger->trace("Raw timestamp string from DB: {}", reinterpret_cast<const char*>(ts_text));
-                    candle.timestamp = core::utils::stringToTimestamp(reinterpret_cast<const char*>(ts_text));
+                // Bind parameters
+                // Index is 1-based
+                sqlite3_bind_text(stmt, 1, instrument_key.c_str(), -1, SQLITE_STATIC);
+                sqlite3_bind_text(stmt, 2, interval.c_str(), -1, SQLITE_STATIC);
+                if (integer_timestamps) {
+                    sqlite3_bind_int64(stmt, 3, core::utils::timestampToEpochNanos(start_time));
+                    sqlite3_bind_int64(stmt, 4, core::utils::timestampToEpochNanos(end_time));
                 } else {
-                     logger->warn("NULL timestamp found in query result (row {}), skipping row.", row_count);
-                     continue; // Skip this row if timestamp is essential
-                 }
+                    // Bind start/end times as TEXT strings (in matching +05:30 format)
+                    sqlite3_bind_text(stmt, 3, start_str.c_str(), -1, SQLITE_STATIC);
+                    sqlite3_bind_text(stmt, 4, end_str.c_str(), -1, SQLITE_STATIC);
+                }
     
-                candle.open = sqlite3_column_double(stmt, 1);
-                candle.high = sqlite3_column_double(stmt, 2);
-                candle.low = sqlite3_column_double(stmt, 3);
-                candle.close = sqlite3_column_double(stmt, 4);
-                candle.volume = sqlite3_column_int64(stmt, 5);
-                candle.open_interest = std::nullopt;
+                // Execute the statement step-by-step and fetch rows
+                int row_count = 0;
+                logger->trace("Starting sqlite3_step loop for candle query...");
+                while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+                    row_count++;
+                    logger->trace("Processing row {}", row_count);
+                    // A row of data is available
+                    try {
+                        core::Candle candle;
+                        // Retrieve data by column index (0-based)
+                        if (integer_timestamps) {
+                            if (sqlite3_column_type(stmt, 0) == SQLITE_NULL) {
+                                logger->warn("NULL timestamp found in query result (row {}), skipping row.", row_count);
+                                continue;
+                            }
+                            candle.timestamp = core::utils::epochNanosToTimestamp(sqlite3_column_int64(stmt, 0));
+                        } else if (const unsigned char *ts_text = sqlite3_column_text(stmt, 0)) {
+                            logger->trace("Raw timestamp string from DB: {}", reinterpret_cast<const char*>(ts_text));
+                            const std::string_view text(reinterpret_cast<const char*>(ts_text),
+                                                        static_cast<std::size_t>(sqlite3_column_bytes(stmt, 0)));
+                            if (!core::utils::parseTimestamp(text, candle.timestamp)) {
+                                throw std::runtime_error("Failed to parse timestamp: " + std::string(text));
+                            }
+                        } else {
+                             logger->warn("NULL timestamp found in query result (row {}), skipping row.", row_count);
+                             continue; // Skip this row if timestamp is essential
+                         }
     
-                candles.push_back(candle);
+                        candle.open = sqlite3_column_double(stmt, 1);
+                        candle.high = sqlite3_column_double(stmt, 2);
+                        candle.low = sqlite3_column_double(stmt, 3);
+                        candle.close = sqlite3_column_double(stmt, 4);
+                        candle.volume = sqlite3_column_int64(stmt, 5);
+                        candle.open_interest = std::nullopt;
     
-            } catch (const std::exception& e) {
-                 logger->error("Error processing row data (row approx {}): {}", row_count, e.what());
-                 // Continue to next row on processing error? Or break? Let's continue for now.
-            }
-        } // End while loop
+                        on_row(candle);
+                        ++candle_count;
     
-        logger->trace("Finished sqlite3_step loop. Final rc = {} ({}), Total rows processed in loop = {}",
-                      rc, (rc == SQLITE_DONE ? "SQLITE_DONE" : "OTHER"), row_count);
+                    } catch (const std::exception& e) {
+                         logger->error("Error processing row data (row approx {}): {}", row_count, e.what());
+                         // Continue to next row on processing error? Or break? Let's continue for now.
+                    }
+                } // End while loop
     
-        if (rc != SQLITE_DONE) {
-            logger->error("Error stepping through query results [{}]: {}", rc, sqlite3_errmsg(db_));
-        } else {
-             logger->debug("Finished processing query results. Successfully parsed {} candles.", candles.size());
-        }
-    
-        // Finalize the statement to release resources
-        sqlite3_finalize(stmt);
+                logger->trace("Finished sqlite3_step loop. Final rc = {} ({}), Total rows processed in loop = {}",
+                              rc, (rc == SQLITE_DONE ? "SQLITE_DONE" : "OTHER"), row_count);
     
-        return candles;
+                if (rc != SQLITE_DONE) {
+                    logger->error("Error stepping through query results [{}]: {}", rc, sqlite3_errmsg(connection.handle()));
+                } else {
+                     logger->debug("Finished processing query results. Successfully parsed {} candles.", candle_count);
+                }
+            }); // Statement is reset and returned with the connection
+        } catch (const core::DataLoadException& e) {
+            logger->error("Cannot query candles: {}", e.what()); // No read connection could be opened
+        }
+
+        return candle_count;
     }
 
     bool DatabaseManager::saveCandles(const core::TimeSeries<core::Candle> &candles,
@@ -305,6 +492,70 @@ namespace data
 
         core::logging::getLogger()->debug("Attempting to save/ignore {} candles for {} ({})", candles.size(), instrument_key, interval);
 
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        // Begin transaction for efficiency
+        if (!executeSQL("BEGIN TRANSACTION;"))
+        {
+            core::logging::getLogger()->error("Failed to begin transaction for saving candles.");
+            return false;
+        }
+
+        const long long saved_count = insertCandlesLocked(candles, instrument_key, interval);
+        const bool success = finishTransactionLocked(saved_count >= 0);
+        if (success)
+        {
+            core::logging::getLogger()->info("Successfully saved {} new candles (duplicates ignored) for {} ({}).", saved_count, instrument_key, interval);
+        }
+        else
+        {
+            core::logging::getLogger()->warn("Transaction rolled back due to error during candle save for {} ({}).", instrument_key, interval);
+        }
+        return success;
+    }
+
+    long long DatabaseManager::saveCandleBatches(const std::vector<CandleBatch> &batches)
+    {
+        if (!isConnected())
+        {
+            core::logging::getLogger()->error("Cannot save candle batches: Not connected to database.");
+            return -1;
+        }
+        if (batches.empty())
+        {
+            return 0;
+        }
+
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        if (!executeSQL("BEGIN TRANSACTION;"))
+        {
+            core::logging::getLogger()->error("Failed to begin transaction for saving candle batches.");
+            return -1;
+        }
+
+        long long saved_count = 0;
+        for (const auto &batch : batches)
+        {
+            const long long saved = insertCandlesLocked(batch.candles, batch.instrument_key, batch.interval);
+            if (saved < 0)
+            {
+                saved_count = -1;
+                break;
+            }
+            saved_count += saved;
+        }
+        if (!finishTransactionLocked(saved_count >= 0))
+        {
+            core::logging::getLogger()->warn("Transaction rolled back due to error while saving {} candle batches.", batches.size());
+            return -1;
+        }
+        core::logging::getLogger()->debug("Saved {} new candles from {} batches in one transaction.", saved_count, batches.size());
+        return saved_count;
+    }
+
+    long long DatabaseManager::insertCandlesLocked(const core::TimeSeries<core::Candle> &candles,
+                                                   const std::string &instrument_key,
+                                                   const std::string &interval)
+    {
         // Prepare SQL statement for insertion, ignoring duplicates based on PRIMARY KEY
         // (instrument_key, interval, timestamp)
         const char *sql = R"(
@@ -313,35 +564,33 @@ INSERT OR IGNORE INTO historical_candles
 VALUES (?, ?, ?, ?, ?, ?, ?, ?);
 )";
 
-        sqlite3_stmt *stmt = nullptr;
-        int rc = sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr); // Prepare statement
-        if (rc != SQLITE_OK)
+        const bool integer_timestamps = (schema_version_ >= kSchemaVersionEpochNanos);
+        long long saved_count = 0;
+        // Cached on the writer, so only the first save on a connection compiles it
+        auto statement = writer_->statement(sql);
+        sqlite3_stmt *stmt = statement.get();
+        if (!stmt)
         {
-            core::logging::getLogger()->error("Failed to prepare INSERT statement [{}]: {}", rc, sqlite3_errmsg(db_));
-            sqlite3_finalize(stmt); // Finalize even if prepare failed (safe if stmt is null)
-            return false;
+            return -1; // Prepare error already logged
         }
-
-        // Begin transaction for efficiency
-        if (!executeSQL("BEGIN TRANSACTION;"))
-        {
-            core::logging::getLogger()->error("Failed to begin transaction for saving candles.");
-            sqlite3_finalize(stmt);
-            return false;
-        }
-
-        bool success = true;
-        int saved_count = 0;
+        // Key columns are the same for every row
+        sqlite3_bind_text(stmt, 1, instrument_key.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 2, interval.c_str(), -1, SQLITE_STATIC);
         for (const auto &candle : candles)
         {
             // Bind data to the prepared statement
             // Indexes are 1-based
-            sqlite3_bind_text(stmt, 1, instrument_key.c_str(), -1, SQLITE_STATIC); // Use SQLITE_STATIC for safety if string might change
-            sqlite3_bind_text(stmt, 2, interval.c_str(), -1, SQLITE_STATIC);
-
-            // Format timestamp to IST string matching DB format using updated utility
-            std::string timestamp_str = core::utils::timestampToString(candle.timestamp);
-            sqlite3_bind_text(stmt, 3, timestamp_str.c_str(), -1, SQLITE_STATIC);
+            char timestamp_text[core::utils::kTimestampStringLength]; // Must outlive sqlite3_step (SQLITE_STATIC binding)
+            if (integer_timestamps)
+            {
+                sqlite3_bind_int64(stmt, 3, core::utils::timestampToEpochNanos(candle.timestamp));
+            }
+            else
+            {
+                // Format timestamp to IST string matching DB format, without allocating
+                const char *text_end = core::utils::formatTimestamp(candle.timestamp, timestamp_text);
+                sqlite3_bind_text(stmt, 3, timestamp_text, static_cast<int>(text_end - timestamp_text), SQLITE_STATIC);
+            }
 
             sqlite3_bind_double(stmt, 4, candle.open);
             sqlite3_bind_double(stmt, 5, candle.high);
@@ -350,58 +599,573 @@ VALUES (?, ?, ?, ?, ?, ?, ?, ?);
             sqlite3_bind_int64(stmt, 8, candle.volume);
 
             // Execute the statement for this row
-            rc = sqlite3_step(stmt);
+            int rc = sqlite3_step(stmt);
             if (rc != SQLITE_DONE)
             { // SQLITE_DONE is expected for successful INSERT/IGNORE
                 core::logging::getLogger()->error("Failed to execute insert step [{}]: {}", rc, sqlite3_errmsg(db_));
-                success = false;
-                break; // Exit loop on first error
+                return -1;
             }
-            else
+            // Check if a row was actually inserted (not ignored)
+            if (sqlite3_changes(db_) > 0)
             {
-                // Check if a row was actually inserted (not ignored)
-                if (sqlite3_changes(db_) > 0)
-                {
-                    saved_count++;
-                }
+                saved_count++;
             }
 
-            // Reset the statement bindings for the next iteration
+            // Reset for the next row; bindings stay in place
             rc = sqlite3_reset(stmt);
             if (rc != SQLITE_OK)
             {
                 core::logging::getLogger()->error("Failed to reset prepared statement [{}]: {}", rc, sqlite3_errmsg(db_));
-                success = false;
-                break; // Exit loop on reset error
+                return -1;
             }
         }
+        return saved_count; // 'statement' is reset before any commit/rollback
+    }
 
-        // Finalize the statement BEFORE commit/rollback
-        sqlite3_finalize(stmt);
-
+    bool DatabaseManager::finishTransactionLocked(bool commit)
+    {
         // Commit or rollback transaction
-        const char *final_sql = success ? "COMMIT;" : "ROLLBACK;";
-        if (!executeSQL(final_sql))
+        if (commit && executeSQL("COMMIT;"))
         {
-            core::logging::getLogger()->error("Failed to {} transaction for saving candles.", success ? "COMMIT" : "ROLLBACK");
-            success = false; // Mark as failure if commit/rollback fails
-            // If commit failed, maybe try rollback? But state is likely inconsistent.
-            if (final_sql == "COMMIT;")
-                executeSQL("ROLLBACK;");
+            return true;
         }
-        else
+        if (commit)
+        {
+            core::logging::getLogger()->error("Failed to COMMIT transaction.");
+        }
+        if (!executeSQL("ROLLBACK;"))
+        {
+            core::logging::getLogger()->error("Failed to ROLLBACK transaction.");
+        }
+        return false;
+    }
+
+    std::vector<std::pair<std::string, std::string>> DatabaseManager::listCandleSeries()
+    {
+        std::vector<std::pair<std::string, std::string>> series;
+        if (!isConnected())
+        {
+            core::logging::getLogger()->error("Cannot list candle series: Not connected to database.");
+            return series;
+        }
+        const char *sql = "SELECT DISTINCT instrument_key, interval FROM historical_candles ORDER BY instrument_key, interval;";
+        std::lock_guard<std::mutex> lock(writer_mutex_); // Maintenance query, runs on the writer
+        auto statement = writer_->statement(sql);
+        if (!statement)
+        {
+            return series; // Prepare error already logged
+        }
+        while (sqlite3_step(statement.get()) == SQLITE_ROW)
+        {
+            const unsigned char *key = sqlite3_column_text(statement.get(), 0);
+            const unsigned char *interval = sqlite3_column_text(statement.get(), 1);
+            if (key && interval)
+            {
+                series.emplace_back(reinterpret_cast<const char *>(key), reinterpret_cast<const char *>(interval));
+            }
+        }
+        return series;
+    }
+
+    std::vector<std::string> DatabaseManager::queryIndexConstituents(const std::string& index_key,
+                                                                     const std::string& as_of_date)
+    {
+        std::vector<std::string> constituents;
+        if (!isConnected())
+        {
+            core::logging::getLogger()->error("Cannot query index constituents: Not connected to database.");
+            return constituents;
+        }
+        // as_of_date is TEXT YYYY-MM-DD, so string comparison orders by date
+        const char *sql =
+            "SELECT constituent_key FROM index_constituents "
+            "WHERE index_key = ?1 AND as_of_date = "
+            "(SELECT MAX(as_of_date) FROM index_constituents WHERE index_key = ?1 AND as_of_date <= ?2) "
+            "ORDER BY constituent_key;";
+        try
+        {
+            withReadConnection([&](SqliteConnection &connection) {
+                auto statement = connection.statement(sql);
+                if (!statement)
+                {
+                    return; // Prepare error already logged
+                }
+                sqlite3_stmt *stmt = statement.get();
+                sqlite3_bind_text(stmt, 1, index_key.c_str(), -1, SQLITE_TRANSIENT);
+                sqlite3_bind_text(stmt, 2, as_of_date.c_str(), -1, SQLITE_TRANSIENT);
+                while (sqlite3_step(stmt) == SQLITE_ROW)
+                {
+                    const unsigned char *key = sqlite3_column_text(stmt, 0);
+                    if (key)
+                    {
+                        constituents.emplace_back(reinterpret_cast<const char *>(key));
+                    }
+                }
+            });
+        }
+        catch (const core::DataLoadException &e)
+        {
+            core::logging::getLogger()->error("Cannot query index constituents: {}", e.what());
+            return constituents;
+        }
+        core::logging::getLogger()->info("Index '{}' has {} constituents as of {}.", index_key, constituents.size(), as_of_date);
+        return constituents;
+    }
+
+    std::vector<std::string> DatabaseManager::queryInstruments(const std::string& exchange,
+                                                               const std::string& segment)
+    {
+        std::vector<std::string> keys;
+        if (!isConnected())
+        {
+            core::logging::getLogger()->error("Cannot query instruments: Not connected to database.");
+            return keys;
+        }
+        const char *sql =
+            "SELECT instrument_key FROM instruments "
+            "WHERE (?1 = '' OR exchange = ?1) AND (?2 = '' OR segment = ?2) "
+            "ORDER BY instrument_key;";
+        try
+        {
+            withReadConnection([&](SqliteConnection &connection) {
+                auto statement = connection.statement(sql);
+                if (!statement)
+                {
+                    return; // Prepare error already logged
+                }
+                sqlite3_stmt *stmt = statement.get();
+                sqlite3_bind_text(stmt, 1, exchange.c_str(), -1, SQLITE_TRANSIENT);
+                sqlite3_bind_text(stmt, 2, segment.c_str(), -1, SQLITE_TRANSIENT);
+                while (sqlite3_step(stmt) == SQLITE_ROW)
+                {
+                    const unsigned char *key = sqlite3_column_text(stmt, 0);
+                    if (key)
+                    {
+                        keys.emplace_back(reinterpret_cast<const char *>(key));
+                    }
+                }
+            });
+        }
+        catch (const core::DataLoadException &e)
+        {
+            core::logging::getLogger()->error("Cannot query instruments: {}", e.what());
+            return keys;
+        }
+        core::logging::getLogger()->info("Instrument master has {} instruments for exchange '{}', segment '{}'.",
+                                         keys.size(), exchange.empty() ? "*" : exchange, segment.empty() ? "*" : segment);
+        return keys;
+    }
+
+    std::optional<double> DatabaseManager::queryTickSize(const std::string& instrument_key)
+    {
+        if (!isConnected())
+        {
+            core::logging::getLogger()->error("Cannot query tick size: Not connected to database.");
+            return std::nullopt;
+        }
+        const char *sql = "SELECT tick_size FROM instruments WHERE instrument_key = ?1;";
+        std::optional<double> tick_size;
+        try
+        {
+            withReadConnection([&](SqliteConnection &connection) {
+                auto statement = connection.statement(sql);
+                if (!statement)
+                {
+                    return; // Prepare error already logged
+                }
+                sqlite3_stmt *stmt = statement.get();
+                sqlite3_bind_text(stmt, 1, instrument_key.c_str(), -1, SQLITE_TRANSIENT);
+                if (sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_type(stmt, 0) != SQLITE_NULL)
+                {
+                    tick_size = sqlite3_column_double(stmt, 0);
+                }
+            });
+        }
+        catch (const core::DataLoadException &e)
+        {
+            core::logging::getLogger()->error("Cannot query tick size: {}", e.what());
+            return std::nullopt;
+        }
+        return tick_size;
+    }
+
+    bool DatabaseManager::ensureCoverageTablesLocked()
+    {
+        return executeSQL(kCreateCoverageSql) && executeSQL(kCreateGapsSql);
+    }
+
+    std::vector<DateRange> DatabaseManager::queryGapRowsLocked(const std::string &instrument_key,
+                                                               const std::string &interval,
+                                                               bool no_data)
+    {
+        std::vector<DateRange> ranges;
+        const char *sql = "SELECT from_date, to_date FROM candle_gaps "
+                          "WHERE instrument_key = ? AND interval = ? AND no_data = ? ORDER BY from_date;";
+        auto statement = writer_->statement(sql);
+        if (!statement)
+        {
+            return ranges; // Prepare error already logged
+        }
+        sqlite3_stmt *stmt = statement.get();
+        sqlite3_bind_text(stmt, 1, instrument_key.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 2, interval.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int(stmt, 3, no_data ? 1 : 0);
+        while (sqlite3_step(stmt) == SQLITE_ROW)
+        {
+            ranges.push_back({reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0)),
+                              reinterpret_cast<const char *>(sqlite3_column_text(stmt, 1))});
+        }
+        return ranges;
+    }
+
+    std::optional<SeriesCoverage> DatabaseManager::queryCoverage(const std::string &instrument_key,
+                                                                 const std::string &interval)
+    {
+        if (!isConnected())
+        {
+            core::logging::getLogger()->error("Cannot query coverage: Not connected to database.");
+            return std::nullopt;
+        }
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        if (!tableExists("candle_coverage") || !tableExists("candle_gaps"))
+        {
+            return std::nullopt; // Never scanned
+        }
+        const char *sql = "SELECT first_timestamp, last_timestamp, first_date, last_date, row_count "
+                          "FROM candle_coverage WHERE instrument_key = ? AND interval = ?;";
+        SeriesCoverage coverage;
+        {
+            auto statement = writer_->statement(sql);
+            if (!statement)
+            {
+                return std::nullopt;
+            }
+            sqlite3_stmt *stmt = statement.get();
+            sqlite3_bind_text(stmt, 1, instrument_key.c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_bind_text(stmt, 2, interval.c_str(), -1, SQLITE_TRANSIENT);
+            if (sqlite3_step(stmt) != SQLITE_ROW)
+            {
+                return std::nullopt;
+            }
+            coverage.instrument_key = instrument_key;
+            coverage.interval = interval;
+            coverage.first_timestamp = core::utils::epochNanosToTimestamp(sqlite3_column_int64(stmt, 0));
+            coverage.last_timestamp = core::utils::epochNanosToTimestamp(sqlite3_column_int64(stmt, 1));
+            coverage.first_date = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 2));
+            coverage.last_date = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 3));
+            coverage.row_count = sqlite3_column_int64(stmt, 4);
+        }
+        coverage.gaps = queryGapRowsLocked(instrument_key, interval, false);
+        coverage.no_data = queryGapRowsLocked(instrument_key, interval, true);
+        return coverage;
+    }
+
+    std::optional<SeriesCoverage> DatabaseManager::refreshCoverage(const std::string &instrument_key,
+                                                                   const std::string &interval)
+    {
+        auto logger = core::logging::getLogger();
+        if (!isConnected())
+        {
+            logger->error("Cannot refresh coverage: Not connected to database.");
+            return std::nullopt;
+        }
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        if (!ensureCoverageTablesLocked())
         {
+            return std::nullopt;
+        }
+
+        // One row per local date: bars that day and their first/last timestamp
+        const bool integer_timestamps = (schema_version_ >= kSchemaVersionEpochNanos);
+        const char *sql = integer_timestamps
+            ? "SELECT (timestamp + ?3) / ?4 AS day, COUNT(*), MIN(timestamp), MAX(timestamp) FROM historical_candles "
+              "WHERE instrument_key = ?1 AND interval = ?2 GROUP BY day ORDER BY day;"
+            : "SELECT substr(timestamp, 1, 10) AS day, COUNT(*), MIN(timestamp), MAX(timestamp) FROM historical_candles "
+              "WHERE instrument_key = ?1 AND interval = ?2 GROUP BY day ORDER BY day;";
+
+        SeriesCoverage coverage;
+        coverage.instrument_key = instrument_key;
+        coverage.interval = interval;
+        std::vector<std::string> dates;
+        try
+        {
+            auto statement = writer_->statement(sql);
+            if (!statement)
+            {
+                return std::nullopt; // Prepare error already logged
+            }
+            sqlite3_stmt *stmt = statement.get();
+            sqlite3_bind_text(stmt, 1, instrument_key.c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_bind_text(stmt, 2, interval.c_str(), -1, SQLITE_TRANSIENT);
+            if (integer_timestamps)
+            {
+                sqlite3_bind_int64(stmt, 3, kIstOffsetNanos);
+                sqlite3_bind_int64(stmt, 4, kNanosPerDay);
+            }
+            auto readTimestamp = [&](int column) {
+                if (integer_timestamps)
+                {
+                    return core::utils::epochNanosToTimestamp(sqlite3_column_int64(stmt, column));
+                }
+                return core::utils::stringToTimestamp(reinterpret_cast<const char *>(sqlite3_column_text(stmt, column)));
+            };
+            while (sqlite3_step(stmt) == SQLITE_ROW)
+            {
+                if (integer_timestamps)
+                {
+                    dates.push_back(core::utils::formatDate(std::chrono::sys_days{std::chrono::days{sqlite3_column_int64(stmt, 0)}}));
+                }
+                else
+                {
+                    dates.emplace_back(reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0)));
+                }
+                if (coverage.row_count == 0)
+                {
+                    coverage.first_timestamp = readTimestamp(2);
+                }
+                coverage.last_timestamp = readTimestamp(3);
+                coverage.row_count += sqlite3_column_int64(stmt, 1);
+            }
+        }
+        catch (const std::exception &e)
+        {
+            logger->error("Failed to scan coverage for {} ({}): {}", instrument_key, interval, e.what());
+            return std::nullopt;
+        }
+
+        if (!executeSQL("BEGIN TRANSACTION;"))
+        {
+            return std::nullopt;
+        }
+        bool success = true;
+        {
+            auto statement = writer_->statement("DELETE FROM candle_gaps WHERE instrument_key = ? AND interval = ? AND no_data = 0;");
+            success = static_cast<bool>(statement);
             if (success)
             {
-                core::logging::getLogger()->info("Successfully saved {} new candles (duplicates ignored) for {} ({}).", saved_count, instrument_key, interval);
+                sqlite3_bind_text(statement.get(), 1, instrument_key.c_str(), -1, SQLITE_TRANSIENT);
+                sqlite3_bind_text(statement.get(), 2, interval.c_str(), -1, SQLITE_TRANSIENT);
+                success = sqlite3_step(statement.get()) == SQLITE_DONE;
             }
-            else
+        }
+        coverage.no_data = queryGapRowsLocked(instrument_key, interval, true);
+        if (success && coverage.row_count == 0)
+        {
+            auto statement = writer_->statement("DELETE FROM candle_coverage WHERE instrument_key = ? AND interval = ?;");
+            success = static_cast<bool>(statement);
+            if (success)
             {
-                core::logging::getLogger()->warn("Transaction rolled back due to error during candle save for {} ({}).", instrument_key, interval);
+                sqlite3_bind_text(statement.get(), 1, instrument_key.c_str(), -1, SQLITE_TRANSIENT);
+                sqlite3_bind_text(statement.get(), 2, interval.c_str(), -1, SQLITE_TRANSIENT);
+                success = sqlite3_step(statement.get()) == SQLITE_DONE;
             }
         }
+        else if (success)
+        {
+            coverage.first_date = dates.front();
+            coverage.last_date = dates.back();
+            coverage.gaps = findDateGaps(dates, coverage.no_data);
 
-        return success;
+            auto statement = writer_->statement(
+                "INSERT OR REPLACE INTO candle_coverage "
+                "(instrument_key, interval, first_timestamp, last_timestamp, first_date, last_date, row_count) "
+                "VALUES (?, ?, ?, ?, ?, ?, ?);");
+            success = static_cast<bool>(statement);
+            if (success)
+            {
+                sqlite3_stmt *stmt = statement.get();
+                sqlite3_bind_text(stmt, 1, instrument_key.c_str(), -1, SQLITE_TRANSIENT);
+                sqlite3_bind_text(stmt, 2, interval.c_str(), -1, SQLITE_TRANSIENT);
+                sqlite3_bind_int64(stmt, 3, core::utils::timestampToEpochNanos(coverage.first_timestamp));
+                sqlite3_bind_int64(stmt, 4, core::utils::timestampToEpochNanos(coverage.last_timestamp));
+                sqlite3_bind_text(stmt, 5, coverage.first_date.c_str(), -1, SQLITE_TRANSIENT);
+                sqlite3_bind_text(stmt, 6, coverage.last_date.c_str(), -1, SQLITE_TRANSIENT);
+                sqlite3_bind_int64(stmt, 7, coverage.row_count);
+                success = sqlite3_step(stmt) == SQLITE_DONE;
+            }
+            auto insert_gap = writer_->statement(
+                "INSERT OR IGNORE INTO candle_gaps (instrument_key, interval, from_date, to_date, no_data) VALUES (?, ?, ?, ?, 0);");
+            success = success && insert_gap;
+            for (std::size_t i = 0; success && i < coverage.gaps.size(); ++i)
+            {
+                sqlite3_stmt *stmt = insert_gap.get();
+                sqlite3_bind_text(stmt, 1, instrument_key.c_str(), -1, SQLITE_TRANSIENT);
+                sqlite3_bind_text(stmt, 2, interval.c_str(), -1, SQLITE_TRANSIENT);
+                sqlite3_bind_text(stmt, 3, coverage.gaps[i].from_date.c_str(), -1, SQLITE_TRANSIENT);
+                sqlite3_bind_text(stmt, 4, coverage.gaps[i].to_date.c_str(), -1, SQLITE_TRANSIENT);
+                success = sqlite3_step(stmt) == SQLITE_DONE;
+                sqlite3_reset(stmt);
+            }
+        }
+        if (!finishTransactionLocked(success))
+        {
+            logger->error("Failed to store coverage for {} ({}): {}", instrument_key, interval, sqlite3_errmsg(db_));
+            return std::nullopt;
+        }
+        logger->debug("Coverage {} ({}): {} rows, {}..{}, {} gap(s), {} no-data range(s).", instrument_key, interval,
+                      coverage.row_count, coverage.first_date, coverage.last_date, coverage.gaps.size(), coverage.no_data.size());
+        return coverage;
+    }
+
+    bool DatabaseManager::markNoData(const std::string &instrument_key, const std::string &interval, const DateRange &range)
+    {
+        if (!isConnected())
+        {
+            core::logging::getLogger()->error("Cannot record no-data range: Not connected to database.");
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        if (!ensureCoverageTablesLocked())
+        {
+            return false;
+        }
+        auto statement = writer_->statement(
+            "INSERT OR REPLACE INTO candle_gaps (instrument_key, interval, from_date, to_date, no_data) VALUES (?, ?, ?, ?, 1);");
+        if (!statement)
+        {
+            return false;
+        }
+        sqlite3_stmt *stmt = statement.get();
+        sqlite3_bind_text(stmt, 1, instrument_key.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 2, interval.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 3, range.from_date.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 4, range.to_date.c_str(), -1, SQLITE_TRANSIENT);
+        if (sqlite3_step(stmt) != SQLITE_DONE)
+        {
+            core::logging::getLogger()->error("Failed to record no-data range for {} ({}): {}", instrument_key, interval, sqlite3_errmsg(db_));
+            return false;
+        }
+        return true;
+    }
+
+    bool DatabaseManager::migrateSchema()
+    {
+        auto logger = core::logging::getLogger();
+        if (!isConnected())
+        {
+            logger->error("Cannot migrate schema: Not connected to database.");
+            return false;
+        }
+        if (schema_version_ >= kCurrentSchemaVersion)
+        {
+            logger->info("Database schema is already at version {}; nothing to migrate.", schema_version_);
+            return true;
+        }
+        if (!tableExists("historical_candles"))
+        {
+            logger->info("No historical_candles table found; creating current schema instead.");
+            return initializeSchema();
+        }
+
+        logger->info("Migrating historical_candles from TEXT to INTEGER epoch timestamps (schema {} -> {})...",
+                     schema_version_, kCurrentSchemaVersion);
+
+        if (!executeSQL("BEGIN TRANSACTION;"))
+        {
+            logger->error("Failed to begin transaction for schema migration.");
+            return false;
+        }
+
+        sqlite3_stmt *select_stmt = nullptr;
+        sqlite3_stmt *insert_stmt = nullptr;
+        bool success = executeSQL("DROP TABLE IF EXISTS historical_candles_migrating;") &&
+                       executeSQL(createCandlesEpochSql("historical_candles_migrating"));
+
+        const char *select_sql = R"(
+            SELECT instrument_key, interval, timestamp, open, high, low, close, volume, open_interest
+            FROM historical_candles;
+        )";
+        const char *insert_sql = R"(
+INSERT OR IGNORE INTO historical_candles_migrating
+(instrument_key, interval, timestamp, open, high, low, close, volume, open_interest)
+VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?);
+)";
+        if (success &&
+            (sqlite3_prepare_v2(db_, select_sql, -1, &select_stmt, nullptr) != SQLITE_OK ||
+             sqlite3_prepare_v2(db_, insert_sql, -1, &insert_stmt, nullptr) != SQLITE_OK))
+        {
+            logger->error("Failed to prepare migration statements: {}", sqlite3_errmsg(db_));
+            success = false;
+        }
+
+        long long migrated_count = 0;
+        int rc = SQLITE_DONE;
+        while (success && (rc = sqlite3_step(select_stmt)) == SQLITE_ROW)
+        {
+            const unsigned char *ts_text = sqlite3_column_text(select_stmt, 2);
+            if (!ts_text)
+            {
+                logger->error("NULL timestamp in historical_candles (row {}); aborting migration.", migrated_count + 1);
+                success = false;
+                break;
+            }
+            const std::string_view text(reinterpret_cast<const char *>(ts_text),
+                                        static_cast<std::size_t>(sqlite3_column_bytes(select_stmt, 2)));
+            core::Timestamp ts;
+            if (!core::utils::parseTimestamp(text, ts))
+            {
+                logger->error("Cannot convert timestamp '{}'; aborting migration.", text);
+                success = false;
+                break;
+            }
+            const std::int64_t ts_nanos = core::utils::timestampToEpochNanos(ts);
+
+            // Copy the key/price columns through unchanged (sqlite3_value keeps their storage class)
+            for (int col : {0, 1})
+            {
+                sqlite3_bind_value(insert_stmt, col + 1, sqlite3_column_value(select_stmt, col));
+            }
+            sqlite3_bind_int64(insert_stmt, 3, ts_nanos);
+            for (int col = 3; col <= 8; ++col)
+            {
+                sqlite3_bind_value(insert_stmt, col + 1, sqlite3_column_value(select_stmt, col));
+            }
+
+            if (sqlite3_step(insert_stmt) != SQLITE_DONE)
+            {
+                logger->error("Failed to insert migrated row: {}", sqlite3_errmsg(db_));
+                success = false;
+                break;
+            }
+            sqlite3_reset(insert_stmt);
+            if (++migrated_count % 1000000 == 0)
+            {
+                logger->info(" -> {} rows migrated...", migrated_count);
+            }
+        }
+        if (success && rc != SQLITE_DONE)
+        {
+            logger->error("Error reading legacy candles [{}]: {}", rc, sqlite3_errmsg(db_));
+            success = false;
+        }
+
+        // Finalize statements BEFORE altering tables / commit
+        sqlite3_finalize(select_stmt);
+        sqlite3_finalize(insert_stmt);
+
+        success = success &&
+                  executeSQL("DROP TABLE historical_candles;") && // Also drops idx_candles_timestamp
+                  executeSQL("ALTER TABLE historical_candles_migrating RENAME TO historical_candles;") &&
+                  setSchemaVersion(kCurrentSchemaVersion);
+
+        if (!success)
+        {
+            executeSQL("ROLLBACK;");
+            schema_version_ = readSchemaVersion(); // PRAGMA user_version is transactional, re-read it
+            logger->error("Schema migration failed; database left unchanged.");
+            return false;
+        }
+        if (!executeSQL("COMMIT;"))
+        {
+            executeSQL("ROLLBACK;");
+            schema_version_ = readSchemaVersion();
+            logger->error("Failed to commit schema migration; database left unchanged.");
+            return false;
+        }
+
+        logger->info("Schema migration complete: {} candles converted to INTEGER epoch timestamps.", migrated_count);
+        executeSQL("VACUUM;"); // Reclaim the space of the old table (outside the transaction)
+        return true;
     }
 
 } // namespace data
\ No newline at end of file
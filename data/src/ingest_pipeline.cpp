@@ -0,0 +1,460 @@
+#include "ingest_pipeline.hpp"
+#include "candle_resampler.hpp" // BarInterval, for the default chunk sizes
+#include "logging.hpp"
+#include "thread_pool.hpp"
+#include "utils.hpp"          // parseDate / formatDate
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <utility>
+
+namespace data {
+
+    namespace { // File-local helpers
+
+        using Clock = std::chrono::steady_clock;
+
+        double secondsSince(Clock::time_point start) {
+            return std::chrono::duration<double>(Clock::now() - start).count();
+        }
+
+        // Response worth retrying: throttled, server-side failure or no response at all
+        bool isTransient(const UpstoxApiClient::RawResponse& response) {
+            return !response.error.empty() || response.status_code == 429 || response.status_code >= 500;
+        }
+
+        // Parsed response on its way from a fetch worker to the writer
+        struct ParsedChunk {
+            std::size_t task_index = 0;
+            CandleBatch batch;
+        };
+
+        // Multi-producer / single-consumer FIFO with a capacity, so fetch workers
+        // block instead of piling up parsed candles while the writer commits.
+        class BoundedQueue {
+        public:
+            explicit BoundedQueue(std::size_t capacity) : capacity_(std::max<std::size_t>(capacity, 1)) {}
+
+            void push(ParsedChunk chunk) {
+                std::unique_lock<std::mutex> lock(mutex_);
+                not_full_.wait(lock, [this] { return items_.size() < capacity_; });
+                items_.push_back(std::move(chunk));
+                not_empty_.notify_one();
+            }
+
+            // Next chunk, or nullopt on timeout or once closed and drained
+            std::optional<ParsedChunk> popFor(std::chrono::milliseconds timeout) {
+                std::unique_lock<std::mutex> lock(mutex_);
+                if (!not_empty_.wait_for(lock, timeout, [this] { return !items_.empty() || closed_; })) {
+                    return std::nullopt;
+                }
+                if (items_.empty()) return std::nullopt;
+                ParsedChunk chunk = std::move(items_.front());
+                items_.pop_front();
+                not_full_.notify_one();
+                return chunk;
+            }
+
+            void close() {
+                std::lock_guard<std::mutex> lock(mutex_);
+                closed_ = true;
+                not_empty_.notify_all();
+            }
+
+            bool drained() {
+                std::lock_guard<std::mutex> lock(mutex_);
+                return closed_ && items_.empty();
+            }
+
+        private:
+            std::size_t capacity_;
+            std::deque<ParsedChunk> items_;
+            bool closed_ = false;
+            std::mutex mutex_;
+            std::condition_variable not_full_;
+            std::condition_variable not_empty_;
+        };
+
+        // Live counters, updated by workers and the writer and read for progress
+        struct Counters {
+            std::atomic<std::size_t> tasks_fetched{0};
+            std::atomic<std::size_t> tasks_failed{0};
+            std::atomic<std::size_t> requests{0};
+            std::atomic<std::size_t> retries{0};
+            std::atomic<std::size_t> bytes_downloaded{0};
+            std::atomic<std::size_t> candles_parsed{0};
+            std::atomic<long long> candles_inserted{0};
+            std::atomic<std::size_t> transactions{0};
+            std::atomic<std::int64_t> fetch_ns{0};
+            std::atomic<std::int64_t> parse_ns{0};
+            std::atomic<std::int64_t> write_ns{0};
+
+            IngestStats snapshot(std::size_t tasks, Clock::time_point start) const {
+                IngestStats stats;
+                stats.tasks = tasks;
+                stats.tasks_failed = tasks_failed.load();
+                stats.requests = requests.load();
+                stats.retries = retries.load();
+                stats.bytes_downloaded = bytes_downloaded.load();
+                stats.candles_parsed = candles_parsed.load();
+                stats.candles_inserted = candles_inserted.load();
+                stats.transactions = transactions.load();
+                stats.elapsed_seconds = secondsSince(start);
+                stats.fetch_seconds = fetch_ns.load() * 1e-9;
+                stats.parse_seconds = parse_ns.load() * 1e-9;
+                stats.write_seconds = write_ns.load() * 1e-9;
+                return stats;
+            }
+        };
+
+        std::int64_t nanosSince(Clock::time_point start) {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+        }
+
+        // Consecutive requests of at most 'chunk_days' days covering [from, to]
+        void appendChunks(std::vector<IngestTask>& tasks, const std::string& instrument, const std::string& interval,
+                          std::chrono::sys_days from, std::chrono::sys_days to, int chunk_days)
+        {
+            for (auto chunk_start = from; chunk_start <= to; chunk_start += std::chrono::days{chunk_days}) {
+                const auto chunk_end = std::min(to, chunk_start + std::chrono::days{chunk_days - 1});
+                tasks.push_back({instrument, interval, core::utils::formatDate(chunk_start), core::utils::formatDate(chunk_end)});
+            }
+        }
+
+        // Today's date at the exchange (IST); data for it may not be published yet
+        std::chrono::sys_days exchangeToday() {
+            const auto now = std::chrono::system_clock::now() + std::chrono::minutes(5 * 60 + 30);
+            return std::chrono::floor<std::chrono::days>(now);
+        }
+
+    } // namespace
+
+    int defaultChunkDays(const std::string& interval) {
+        const auto spec = BarInterval::parse(interval);
+        if (!spec || spec->unit == BarInterval::Unit::Minute) return 30; // Intraday: one month per request
+        if (spec->unit == BarInterval::Unit::Day) return 365;
+        return 3650; // Weekly / monthly bars
+    }
+
+    std::vector<IngestTask> planIngestTasks(const std::vector<std::string>& instrument_keys,
+                                            const std::string& interval,
+                                            const std::string& from_date,
+                                            const std::string& to_date,
+                                            int chunk_days)
+    {
+        const auto from = core::utils::parseDate(from_date);
+        const auto to = core::utils::parseDate(to_date);
+        if (from > to) throw std::invalid_argument("Ingest start date " + from_date + " is after end date " + to_date);
+        if (chunk_days <= 0) chunk_days = defaultChunkDays(interval);
+
+        std::vector<IngestTask> tasks;
+        for (const auto& instrument : instrument_keys) {
+            appendChunks(tasks, instrument, interval, from, to, chunk_days);
+        }
+        return tasks;
+    }
+
+    std::vector<IngestTask> planSyncTasks(DatabaseManager& db,
+                                          const std::vector<std::string>& instrument_keys,
+                                          const std::string& interval,
+                                          const std::string& from_date,
+                                          const std::string& to_date,
+                                          int chunk_days)
+    {
+        if (core::utils::parseDate(from_date) > core::utils::parseDate(to_date)) {
+            throw std::invalid_argument("Sync start date " + from_date + " is after end date " + to_date);
+        }
+        if (chunk_days <= 0) chunk_days = defaultChunkDays(interval);
+
+        std::vector<IngestTask> tasks;
+        std::size_t up_to_date = 0;
+        for (const auto& instrument : instrument_keys) {
+            auto coverage = db.queryCoverage(instrument, interval);
+            if (!coverage) coverage = db.refreshCoverage(instrument, interval); // First sync of this series
+            const auto missing = missingDateRanges(coverage ? &*coverage : nullptr, interval, from_date, to_date);
+            if (missing.empty()) ++up_to_date;
+            for (const auto& range : missing) {
+                appendChunks(tasks, instrument, interval, core::utils::parseDate(range.from_date),
+                             core::utils::parseDate(range.to_date), chunk_days);
+            }
+        }
+        core::logging::getLogger()->info("Sync plan: {} of {} series already complete for {}..{}, {} request(s) needed.",
+                                         up_to_date, instrument_keys.size(), from_date, to_date, tasks.size());
+        return tasks;
+    }
+
+    // --- RateLimiter ---
+
+    RateLimiter::RateLimiter(double per_second, double burst)
+        : per_second_(per_second),
+          burst_(std::max(burst, 1.0)),
+          tokens_(std::max(burst, 1.0)),
+          last_refill_(Clock::now())
+    {}
+
+    void RateLimiter::acquire() {
+        if (per_second_ <= 0.0) return;
+        Clock::duration wait{0};
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            const auto now = Clock::now();
+            tokens_ = std::min(burst_, tokens_ + std::chrono::duration<double>(now - last_refill_).count() * per_second_);
+            last_refill_ = now;
+            // Take the token even if it is not there yet; the deficit is our place in line
+            tokens_ -= 1.0;
+            if (tokens_ < 0.0) {
+                wait = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(-tokens_ / per_second_));
+            }
+        }
+        if (wait.count() > 0) std::this_thread::sleep_for(wait);
+    }
+
+    // --- IngestPipeline ---
+
+    IngestPipeline::IngestPipeline(const UpstoxApiClient& client, DatabaseManager& db, IngestOptions options)
+        : client_(client), db_(db), options_(options)
+    {}
+
+    IngestStats IngestPipeline::run(const std::vector<IngestTask>& tasks) {
+        auto logger = core::logging::getLogger();
+        const auto start = Clock::now();
+        Counters counters;
+        std::atomic<bool> unauthorized{false};
+        std::mutex failed_mutex;
+        std::vector<std::size_t> failed_tasks;
+        auto recordFailure = [&](std::size_t task_index) {
+            counters.tasks_failed.fetch_add(1);
+            std::lock_guard<std::mutex> lock(failed_mutex);
+            failed_tasks.push_back(task_index);
+        };
+
+        if (!db_.isConnected()) {
+            logger->error("Cannot run ingest: Not connected to database.");
+            IngestStats stats = counters.snapshot(tasks.size(), start);
+            stats.tasks_failed = tasks.size();
+            stats.failed = tasks;
+            return stats;
+        }
+
+        const std::size_t workers = std::max<std::size_t>(1, std::min(options_.fetch_workers, tasks.size()));
+        logger->info("Ingesting {} request(s) with {} fetch worker(s), {} req/s limit, {} rows per transaction.",
+                     tasks.size(), workers, options_.requests_per_second, options_.batch_rows);
+
+        RateLimiter limiter(options_.requests_per_second);
+        BoundedQueue queue(options_.queue_capacity);
+
+        // --- Writer: the only thread touching the database ---
+        std::thread writer([&]() {
+            std::vector<CandleBatch> pending;
+            std::vector<std::size_t> pending_tasks;
+            std::size_t pending_rows = 0;
+            Clock::time_point oldest_pending{};
+            auto last_progress = Clock::now();
+            const auto flush_interval = std::chrono::milliseconds(options_.flush_interval_ms);
+            const auto progress_interval = std::chrono::milliseconds(options_.progress_interval_ms);
+
+            // A failed or throwing transaction fails its requests; the writer keeps
+            // draining the queue either way, so fetch workers never block on it
+            auto failPending = [&]() {
+                logger->error("Ingest transaction with {} candles from {} request(s) failed; they are reported as failed.",
+                              pending_rows, pending_tasks.size());
+                for (std::size_t task_index : pending_tasks) recordFailure(task_index);
+                pending.clear();
+                pending_tasks.clear();
+                pending_rows = 0;
+            };
+            auto flush = [&]() {
+                if (pending.empty()) return;
+                const auto write_start = Clock::now();
+                long long inserted = -1;
+                try {
+                    inserted = db_.saveCandleBatches(pending);
+                } catch (const std::exception& e) {
+                    logger->error("Ingest transaction threw: {}", e.what());
+                }
+                counters.write_ns.fetch_add(nanosSince(write_start));
+                if (inserted < 0) {
+                    failPending();
+                    return;
+                }
+                counters.candles_inserted.fetch_add(inserted);
+                counters.transactions.fetch_add(1);
+                pending.clear();
+                pending_tasks.clear();
+                pending_rows = 0;
+            };
+
+            while (!queue.drained()) {
+                try {
+                    if (auto chunk = queue.popFor(std::chrono::milliseconds(200))) {
+                        if (pending.empty()) oldest_pending = Clock::now();
+                        pending_rows += chunk->batch.candles.size();
+                        pending_tasks.push_back(chunk->task_index);
+                        pending.push_back(std::move(chunk->batch));
+                    }
+                    const auto now = Clock::now();
+                    if (pending_rows >= options_.batch_rows || (!pending.empty() && now - oldest_pending >= flush_interval)) {
+                        flush();
+                    }
+                    if (options_.progress_interval_ms > 0 && now - last_progress >= progress_interval) {
+                        last_progress = now;
+                        const IngestStats progress = counters.snapshot(tasks.size(), start);
+                        logger->info("Ingest progress: {}/{} request(s) fetched | {}",
+                                     counters.tasks_fetched.load(), tasks.size(), formatStats(progress));
+                    }
+                } catch (const std::exception& e) { // E.g. bad_alloc while buffering
+                    logger->error("Ingest writer error: {}", e.what());
+                    failPending();
+                }
+            }
+            flush();
+        });
+
+        // --- Fetch workers: request (with retries), parse, hand over ---
+        {
+            core::ThreadPool pool(workers);
+            std::vector<std::future<void>> pending_fetches;
+            pending_fetches.reserve(tasks.size());
+            for (std::size_t task_index = 0; task_index < tasks.size(); ++task_index) {
+                pending_fetches.push_back(pool.submit([&, task_index]() {
+                    const IngestTask& task = tasks[task_index];
+                    try {
+                        UpstoxApiClient::RawResponse response;
+                        int backoff_ms = options_.retry_backoff_ms;
+                        for (std::size_t attempt = 0;; ++attempt) {
+                            if (unauthorized.load()) {
+                                recordFailure(task_index);
+                                return;
+                            }
+                            limiter.acquire();
+                            const auto fetch_start = Clock::now();
+                            response = client_.fetchHistoricalCandleJson(task.instrument_key, task.interval,
+                                                                         task.from_date, task.to_date);
+                            counters.fetch_ns.fetch_add(nanosSince(fetch_start));
+                            counters.requests.fetch_add(1);
+                            counters.bytes_downloaded.fetch_add(response.body.size());
+                            if (!isTransient(response) || attempt >= options_.max_retries) break;
+                            counters.retries.fetch_add(1);
+                            // The server's Retry-After (429 / 503) wins over our own backoff
+                            const long wait_ms = response.retry_after_ms >= 0
+                                                     ? std::min<long>(response.retry_after_ms, options_.max_retry_after_ms)
+                                                     : backoff_ms;
+                            TP_LOG_DEBUG("Retrying {} {}..{} in {} ms (status {}{}{}).", task.instrument_key,
+                                         task.from_date, task.to_date, wait_ms, response.status_code,
+                                         response.error.empty() ? "" : ", ", response.error);
+                            std::this_thread::sleep_for(std::chrono::milliseconds(wait_ms));
+                            backoff_ms *= 2;
+                        }
+
+                        if (!response.ok()) {
+                            if (response.status_code == 401 && !unauthorized.exchange(true)) {
+                                logger->critical("Upstox API returned 401 Unauthorized; stopping ingest. "
+                                                 "Access token may be invalid or expired.");
+                            }
+                            if (response.status_code != 401) {
+                                logger->error("Ingest request failed for {} {}..{}: status {}{}{}", task.instrument_key,
+                                              task.from_date, task.to_date, response.status_code,
+                                              response.error.empty() ? "" : ", ", response.error);
+                            }
+                            recordFailure(task_index);
+                            return;
+                        }
+
+                        const auto parse_start = Clock::now();
+                        auto candles = UpstoxApiClient::parseHistoricalCandleJson(response.body);
+                        counters.parse_ns.fetch_add(nanosSince(parse_start));
+                        if (!candles) {
+                            recordFailure(task_index); // Parse error already logged
+                            return;
+                        }
+                        counters.tasks_fetched.fetch_add(1);
+                        counters.candles_parsed.fetch_add(candles->size());
+                        if (candles->empty()) return; // Holidays, not yet listed, ...
+                        queue.push({task_index, CandleBatch{task.instrument_key, task.interval, std::move(*candles)}});
+                    } catch (const std::exception& e) {
+                        logger->error("Ingest request for {} {}..{} failed: {}", task.instrument_key,
+                                      task.from_date, task.to_date, e.what());
+                        recordFailure(task_index);
+                    }
+                }));
+            }
+            for (auto& fetch : pending_fetches) fetch.get();
+        }
+        queue.close();
+        writer.join();
+
+        IngestStats stats = counters.snapshot(tasks.size(), start);
+        std::sort(failed_tasks.begin(), failed_tasks.end());
+        for (std::size_t task_index : failed_tasks) stats.failed.push_back(tasks[task_index]);
+        logger->info("Ingest finished: {}", formatStats(stats));
+        if (stats.tasks_failed > 0) {
+            logger->warn("{} of {} ingest request(s) failed.", stats.tasks_failed, stats.tasks);
+        }
+        return stats;
+    }
+
+    IngestStats IngestPipeline::sync(const std::vector<std::string>& instrument_keys,
+                                     const std::string& interval,
+                                     const std::string& from_date,
+                                     const std::string& to_date,
+                                     int chunk_days)
+    {
+        const auto tasks = planSyncTasks(db_, instrument_keys, interval, from_date, to_date, chunk_days);
+        IngestStats stats = run(tasks);
+
+        // Successful requests per instrument (tasks are grouped by instrument)
+        std::set<std::tuple<std::string, std::string, std::string>> failed;
+        for (const auto& task : stats.failed) failed.emplace(task.instrument_key, task.from_date, task.to_date);
+        std::vector<std::pair<std::string, std::vector<const IngestTask*>>> fetched;
+        for (const auto& task : tasks) {
+            if (fetched.empty() || fetched.back().first != task.instrument_key) fetched.push_back({task.instrument_key, {}});
+            if (!failed.count({task.instrument_key, task.from_date, task.to_date})) fetched.back().second.push_back(&task);
+        }
+
+        // Only days before today count as final: today's bars may not be published yet.
+        // Weekly/monthly bars are dated by period start, so they are not checked day by day.
+        const auto spec = BarInterval::parse(interval);
+        const bool daily_or_finer = !spec || spec->unit == BarInterval::Unit::Minute || spec->unit == BarInterval::Unit::Day;
+        const auto last_final_day = exchangeToday() - std::chrono::days{1};
+        std::size_t no_data_ranges = 0;
+        for (const auto& [instrument, instrument_tasks] : fetched) {
+            auto coverage = db_.refreshCoverage(instrument, interval);
+            if (!coverage || !daily_or_finer || instrument_tasks.empty()) continue;
+            std::size_t marked = 0;
+            for (const IngestTask* task : instrument_tasks) {
+                const auto to = std::min(core::utils::parseDate(task->to_date), last_final_day);
+                if (core::utils::parseDate(task->from_date) > to) continue;
+                // Day-level complement of the stored bars within what the API just answered for
+                for (const auto& range : missingDateRanges(&*coverage, "day", task->from_date, core::utils::formatDate(to))) {
+                    marked += db_.markNoData(instrument, interval, range) ? 1 : 0;
+                }
+            }
+            if (marked > 0) db_.refreshCoverage(instrument, interval); // Drop the gaps that are now explained
+            no_data_ranges += marked;
+        }
+        core::logging::getLogger()->info("Sync refreshed coverage of {} series; {} range(s) without data recorded.",
+                                         fetched.size(), no_data_ranges);
+        return stats;
+    }
+
+    std::string IngestPipeline::formatStats(const IngestStats& stats) {
+        const double elapsed = std::max(stats.elapsed_seconds, 1e-9);
+        return fmt::format("{} req ({} retries, {} failed tasks), {:.1f} MiB, {} candles parsed, {} inserted in {} txn | "
+                           "{:.1f} req/s, {:.0f} candles/s, {:.2f} MiB/s | fetch {:.1f}s, parse {:.1f}s, write {:.1f}s, wall {:.1f}s",
+                           stats.requests, stats.retries, stats.tasks_failed,
+                           stats.bytes_downloaded / (1024.0 * 1024.0), stats.candles_parsed,
+                           stats.candles_inserted, stats.transactions,
+                           stats.requests / elapsed, stats.candles_parsed / elapsed,
+                           stats.bytes_downloaded / (1024.0 * 1024.0) / elapsed,
+                           stats.fetch_seconds, stats.parse_seconds, stats.write_seconds, stats.elapsed_seconds);
+    }
+
+} // namespace data
@@ -0,0 +1,138 @@
+#include "sqlite_connection_pool.hpp"
+#include "logging.hpp"
+#include "exceptions.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace data {
+
+    namespace { // File-local helpers
+
+        // PRAGMA values cannot be bound; every value here is a number we control
+        void applyPragma(sqlite3* db, const std::string& pragma) {
+            char* error_msg = nullptr;
+            if (sqlite3_exec(db, pragma.c_str(), nullptr, nullptr, &error_msg) != SQLITE_OK) {
+                core::logging::getLogger()->warn("SQLite '{}' failed: {}", pragma, error_msg ? error_msg : "unknown error");
+            }
+            sqlite3_free(error_msg);
+        }
+
+    } // namespace
+
+    // --- SqliteConnection ---
+
+    SqliteConnection::Statement::~Statement() {
+        reset();
+    }
+
+    void SqliteConnection::Statement::reset() {
+        if (stmt_) {
+            sqlite3_reset(stmt_);
+            sqlite3_clear_bindings(stmt_);
+            stmt_ = nullptr;
+        }
+    }
+
+    SqliteConnection::SqliteConnection(const std::string& path, int flags, const SqliteOptions& options) {
+        int rc = sqlite3_open_v2(path.c_str(), &db_, flags | SQLITE_OPEN_NOMUTEX, nullptr);
+        if (rc != SQLITE_OK) {
+            std::string message = db_ ? sqlite3_errmsg(db_) : sqlite3_errstr(rc);
+            sqlite3_close(db_); // Close handle even if open failed (as per docs)
+            db_ = nullptr;
+            throw core::DataLoadException(fmt::format("Cannot open SQLite database '{}': {}", path, message));
+        }
+
+        sqlite3_busy_timeout(db_, options.busy_timeout_ms);
+        applyPragma(db_, fmt::format("PRAGMA mmap_size = {};", options.mmap_size_bytes));
+        applyPragma(db_, fmt::format("PRAGMA cache_size = -{};", options.cache_size_kib)); // Negative = KiB
+    }
+
+    SqliteConnection::~SqliteConnection() {
+        clearStatements();
+        if (db_ && sqlite3_close(db_) != SQLITE_OK) {
+            core::logging::getLogger()->error("Error closing SQLite connection: {}", sqlite3_errmsg(db_));
+        }
+    }
+
+    SqliteConnection::Statement SqliteConnection::statement(const std::string& sql) {
+        auto it = statements_.find(sql);
+        if (it != statements_.end()) return Statement(it->second);
+
+        sqlite3_stmt* stmt = nullptr;
+        // PERSISTENT: the statement is expected to live for the whole connection
+        int rc = sqlite3_prepare_v3(db_, sql.c_str(), -1, SQLITE_PREPARE_PERSISTENT, &stmt, nullptr);
+        if (rc != SQLITE_OK) {
+            core::logging::getLogger()->error("Failed to prepare SQL statement [{}]: {}", rc, sqlite3_errmsg(db_));
+            sqlite3_finalize(stmt);
+            return Statement();
+        }
+        statements_.emplace(sql, stmt);
+        return Statement(stmt);
+    }
+
+    void SqliteConnection::clearStatements() {
+        for (auto& [sql, stmt] : statements_) sqlite3_finalize(stmt);
+        statements_.clear();
+    }
+
+    // --- SqliteConnectionPool ---
+
+    SqliteConnectionPool::Lease::~Lease() {
+        if (pool_ && connection_) pool_->release(std::move(connection_));
+    }
+
+    SqliteConnectionPool::SqliteConnectionPool(std::string path, SqliteOptions options)
+        : path_(std::move(path)), options_(options),
+          max_connections_(options.max_read_connections > 0
+                               ? options.max_read_connections
+                               : std::max<std::size_t>(1, std::thread::hardware_concurrency()))
+    {
+    }
+
+    SqliteConnectionPool::~SqliteConnectionPool() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (idle_.size() != open_) {
+            core::logging::getLogger()->error("SqliteConnectionPool destroyed with {} connection(s) still leased.",
+                                              open_ - idle_.size());
+        }
+    }
+
+    SqliteConnectionPool::Lease SqliteConnectionPool::acquire() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        available_.wait(lock, [&]() { return !idle_.empty() || open_ < max_connections_; });
+        if (!idle_.empty()) {
+            auto connection = std::move(idle_.back());
+            idle_.pop_back();
+            return Lease(this, std::move(connection));
+        }
+
+        // Open outside the lock; the slot is reserved so the maximum still holds
+        const std::size_t slot = ++open_;
+        lock.unlock();
+        try {
+            auto connection = std::make_unique<SqliteConnection>(path_, SQLITE_OPEN_READONLY, options_);
+            core::logging::getLogger()->debug("Opened read connection {} of {} to {}.", slot, max_connections_, path_);
+            return Lease(this, std::move(connection));
+        } catch (...) {
+            lock.lock();
+            --open_;
+            available_.notify_one();
+            throw;
+        }
+    }
+
+    std::size_t SqliteConnectionPool::openConnections() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return open_;
+    }
+
+    void SqliteConnectionPool::release(std::unique_ptr<SqliteConnection> connection) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            idle_.push_back(std::move(connection));
+        }
+        available_.notify_one();
+    }
+
+} // namespace data
@@ -1,11 +1,19 @@
 #include "upstox_api_client.hpp"
+#include "upstox_candle_parser.hpp"
 #include "logging.hpp"
 #include "exceptions.hpp"
 #include "utils.hpp" 
 // Include necessary headers for HTTP client and JSON AFTER adding dependencies
 #include <cpr/cpr.h> // Example if using CPR
-#include <nlohmann/json.hpp> // Example if using nlohmann/json
 
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <ctime>
+#include <iomanip>   // std::get_time, for Retry-After dates
+#include <locale>
+#include <sstream>
 #include <stdexcept> // For runtime_error etc.
 
 namespace data {
@@ -45,42 +53,18 @@ if (access_token_.empty()) {
     return candles; // Return empty
 }
 
-// --- Construct the API Endpoint ---
-// IMPORTANT: Verify the exact endpoint path and parameter order from Upstox V2 docs!
-// This is based on common patterns, but might need adjustment.
-// Example: /v2/historical-candle/INSTRUMENT_KEY/INTERVAL/TO_DATE/FROM_DATE
- // URL Encoding is crucial for instrument keys containing special characters like '|'
-std::string endpoint = fmt::format("/v2/historical-candle/{}/{}/{}/{}",
-                                   cpr::util::urlEncode(instrument_key),
-                                   cpr::util::urlEncode(interval),
-                                   to_date, // Dates usually don't need encoding
-                                   from_date);
-
-std::string full_url = base_url_ + endpoint;
-logger->debug("Requesting Upstox URL: {}", full_url);
-
-// --- Prepare Headers ---
-cpr::Header headers = {
-    {"Accept", "application/json"},
-    {"Api-Version", api_version_}, // e.g., "v2"
-    {"Authorization", "Bearer " + access_token_}
-};
-
-// --- Make the GET Request ---
-// Add timeout (e.g., 15 seconds)
-cpr::Response response = cpr::Get(cpr::Url{full_url}, headers, cpr::Timeout{15000});
+RawResponse response = fetchHistoricalCandleJson(instrument_key, interval, from_date, to_date);
 
 // --- Process the Response ---
-logger->debug("Upstox API Response Status: {}, Body size: {}", response.status_code, response.text.length());
+logger->debug("Upstox API Response Status: {}, Body size: {}", response.status_code, response.body.length());
 
-if (response.error) {
-    logger->error("Upstox API request failed (CPR error): Code={}, Message='{}'",
-                  static_cast<int>(response.error.code), response.error.message);
+if (!response.error.empty()) {
+    logger->error("Upstox API request failed (CPR error): Message='{}'", response.error);
     return candles;
 }
 
 if (response.status_code != 200) {
-    logger->error("Upstox API request failed: Status Code={}, Body='{}'", response.status_code, response.text);
+    logger->error("Upstox API request failed: Status Code={}, Body='{}'", response.status_code, response.body);
      if (response.status_code == 401) {
           logger->critical("Upstox API returned 401 Unauthorized. Access token may be invalid or expired.");
           // Potentially clear the token or trigger re-authentication
@@ -89,80 +73,154 @@ if (response.status_code != 200) {
     return candles;
 }
 
-// --- Parse JSON Response ---
-try {
-    nlohmann::json json_response = nlohmann::json::parse(response.text);
+if (auto parsed = parseHistoricalCandleJson(response.body)) {
+    candles = std::move(*parsed);
+}
+logger->debug("Parsed {} candles successfully.", candles.size());
+return candles;
+}
 
-    // Check Upstox specific status within JSON
-    if (json_response.contains("status") && json_response["status"] != "success") {
-        std::string api_error_msg = json_response.value("message", "Unknown API error message");
-        logger->error("Upstox API returned non-success status: Status='{}', Message='{}'",
-                      json_response["status"].get<std::string>(), api_error_msg);
-        return candles;
+UpstoxApiClient::RawResponse UpstoxApiClient::fetchHistoricalCandleJson(const std::string& instrument_key,
+                                                                        const std::string& interval,
+                                                                        const std::string& from_date,
+                                                                        const std::string& to_date) const
+{
+    // --- Construct the API Endpoint ---
+    // IMPORTANT: Verify the exact endpoint path and parameter order from Upstox V2 docs!
+    // Example: /v2/historical-candle/INSTRUMENT_KEY/INTERVAL/TO_DATE/FROM_DATE
+    // URL Encoding is crucial for instrument keys containing special characters like '|'
+    std::string endpoint = fmt::format("/v2/historical-candle/{}/{}/{}/{}",
+                                       cpr::util::urlEncode(instrument_key),
+                                       cpr::util::urlEncode(interval),
+                                       to_date, // Dates usually don't need encoding
+                                       from_date);
+
+    std::string full_url = base_url_ + endpoint;
+    TP_LOG_DEBUG("Requesting Upstox URL: {}", full_url);
+
+    // --- Prepare Headers ---
+    cpr::Header headers = {
+        {"Accept", "application/json"},
+        {"Api-Version", api_version_}, // e.g., "v2"
+        {"Authorization", "Bearer " + access_token_}
+    };
+
+    cpr::Response response = cpr::Get(cpr::Url{full_url}, headers, cpr::Timeout{timeout_ms_});
+
+    RawResponse raw;
+    raw.status_code = response.status_code;
+    raw.elapsed_seconds = response.elapsed;
+    if (response.error) {
+        raw.error = fmt::format("code {}: {}", static_cast<int>(response.error.code), response.error.message);
     }
-
-    // Navigate to the candle data - **VERIFY THIS PATH AGAINST ACTUAL API RESPONSE**
-    if (!json_response.contains("data") || !json_response["data"].contains("candles")) {
-        logger->error("Unexpected JSON structure: 'data.candles' not found.");
-        return candles;
+    if (const auto it = response.header.find("Retry-After"); it != response.header.end()) {
+        raw.retry_after_ms = parseRetryAfter(it->second).value_or(-1);
     }
+    raw.body = std::move(response.text);
+    return raw;
+}
 
-    const auto& json_candles = json_response["data"]["candles"];
-    if (!json_candles.is_array()) {
-         logger->error("Unexpected JSON structure: 'data.candles' is not an array.");
-         return candles;
+std::optional<long> UpstoxApiClient::parseRetryAfter(const std::string& value, std::chrono::system_clock::time_point now)
+{
+    const auto first = value.find_first_not_of(" \t");
+    if (first == std::string::npos) return std::nullopt;
+    const std::string text = value.substr(first, value.find_last_not_of(" \t") - first + 1);
+
+    // delta-seconds
+    if (std::all_of(text.begin(), text.end(), [](unsigned char c) { return std::isdigit(c) != 0; })) {
+        if (text.size() > 6) return 999999L * 1000L; // Over 11 days; saturate instead of overflowing
+        return std::stol(text) * 1000L;
     }
 
-    logger->info("Received {} candles from Upstox API.", json_candles.size());
-
-    // --- Convert JSON Candles to core::Candle ---
-    for (const auto& json_candle : json_candles) {
-        if (!json_candle.is_array() || json_candle.size() < 6) { // Expecting [timestamp, o, h, l, c, v, (oi maybe)]
-            logger->warn("Skipping invalid candle data format in JSON array.");
-            continue;
-        }
-        try {
-            core::Candle candle;
-            // Index 0: Timestamp (string) - Assuming IST format like DB
-            std::string ts_str = json_candle[0].get<std::string>();
-            candle.timestamp = core::utils::stringToTimestamp(ts_str); // Use our existing parser
-
-            // Index 1-4: OHLC (should be numbers or strings convertible to double)
-            candle.open  = json_candle[1].get<double>();
-            candle.high  = json_candle[2].get<double>();
-            candle.low   = json_candle[3].get<double>();
-            candle.close = json_candle[4].get<double>();
-
-            // Index 5: Volume (should be number or string convertible to long long)
-            candle.volume = json_candle[5].get<long long>();
-
-            // Index 6: Open Interest (Optional - check if Upstox provides it)
-            // If present and needed, add parsing here. Currently ignored.
-            candle.open_interest = std::nullopt;
-
-            candles.push_back(candle);
-
-        } catch (const nlohmann::json::exception& e) {
-            logger->error("Error parsing individual candle JSON data: {}", e.what());
-        } catch (const std::exception& e) {
-            logger->error("Error converting candle data: {}", e.what());
-        }
-    } // End loop through json_candles
+    // IMF-fixdate, the only HTTP-date form senders may generate
+    std::tm tm{};
+    std::istringstream in(text);
+    in.imbue(std::locale::classic());
+    in >> std::get_time(&tm, "%a, %d %b %Y %H:%M:%S GMT");
+    if (in.fail()) return std::nullopt;
+    const std::chrono::year_month_day date{std::chrono::year{tm.tm_year + 1900}, std::chrono::month(tm.tm_mon + 1),
+                                           std::chrono::day(tm.tm_mday)};
+    if (!date.ok()) return std::nullopt;
+    const auto at = std::chrono::sys_days{date} + std::chrono::hours{tm.tm_hour} + std::chrono::minutes{tm.tm_min} +
+                    std::chrono::seconds{tm.tm_sec};
+    const auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(at - now).count();
+    return std::max<long>(0, static_cast<long>(wait)); // A date in the past means "now"
+}
 
-} catch (const nlohmann::json::parse_error& e) {
-    logger->error("Failed to parse JSON response from Upstox API: {}", e.what());
-    logger->error("Response Text (first 500 chars): {}", response.text.substr(0, 500));
-} catch (const std::exception& e) {
-    logger->error("Unexpected error processing API response: {}", e.what());
+std::optional<core::TimeSeries<core::Candle>> UpstoxApiClient::parseHistoricalCandleJson(const std::string& body)
+{
+auto logger = core::logging::getLogger();
+core::TimeSeries<core::Candle> candles;
+// Rows are ~60 bytes of JSON; one guess avoids most regrowth without a counting pass
+candles.reserve(body.size() / 64);
+
+// --- Stream the response straight into candles (no JSON DOM) ---
+const UpstoxCandleParseResult result = parseUpstoxCandleJson(body, [&](const core::Candle& candle) {
+    candles.push_back(candle);
+});
+
+if (!result.error.empty()) {
+    logger->error("Failed to parse JSON response from Upstox API: {}", result.error);
+    logger->error("Response Text (first 500 chars): {}", body.substr(0, 500));
+    return std::nullopt;
 }
+// Check Upstox specific status within JSON
+if (!result.status.empty() && result.status != "success") {
+    logger->error("Upstox API returned non-success status: Status='{}', Message='{}'",
+                  result.status, result.message.empty() ? "Unknown API error message" : result.message);
+    return std::nullopt;
+}
+if (!result.ok) {
+    logger->error("Unexpected JSON structure: 'data.candles' array not found.");
+    return std::nullopt;
+}
+if (result.skipped_rows > 0) {
+    logger->warn("Skipped {} invalid candle rows in Upstox response.", result.skipped_rows);
+}
+TP_LOG_DEBUG("Received {} candles from Upstox API.", result.rows);
 
 // Sort just in case API doesn't guarantee order (optional)
 // std::sort(candles.begin(), candles.end(), [](const auto& a, const auto& b){ return a.timestamp < b.timestamp; });
 
-logger->debug("Parsed {} candles successfully.", candles.size());
 return candles;
 }
 
+std::optional<std::string> UpstoxApiClient::authorizeMarketFeed() const
+{
+    auto logger = core::logging::getLogger();
+    if (access_token_.empty()) {
+        logger->error("Cannot authorize the Upstox market feed: Access token is missing.");
+        return std::nullopt;
+    }
+
+    const std::string full_url = base_url_ + "/v3/feed/market-data-feed/authorize";
+    cpr::Header headers = {
+        {"Accept", "application/json"},
+        {"Authorization", "Bearer " + access_token_}
+    };
+    cpr::Response response = cpr::Get(cpr::Url{full_url}, headers, cpr::Timeout{timeout_ms_});
+    if (response.error) {
+        logger->error("Upstox feed authorization failed (CPR error): Message='{}'", response.error.message);
+        return std::nullopt;
+    }
+    if (response.status_code != 200) {
+        logger->error("Upstox feed authorization failed: Status Code={}, Body='{}'", response.status_code,
+                      response.text.substr(0, 500));
+        return std::nullopt;
+    }
+
+    // {"status":"success","data":{"authorized_redirect_uri":"wss://..."}}
+    const nlohmann::json body = nlohmann::json::parse(response.text, nullptr, false);
+    if (body.is_object() && body.contains("data") && body["data"].is_object()) {
+        const auto& data = body["data"];
+        if (data.contains("authorized_redirect_uri") && data["authorized_redirect_uri"].is_string()) {
+            return data["authorized_redirect_uri"].get<std::string>();
+        }
+    }
+    logger->error("Unexpected Upstox feed authorization response: {}", response.text.substr(0, 500));
+    return std::nullopt;
+}
+
 
 std::string UpstoxApiClient::performGetRequest(const std::string& endpoint,
                                                const std::vector<std::pair<std::string, std::string>>& params)
@@ -0,0 +1,364 @@
+#include "upstox_candle_parser.hpp"
+#include "utils.hpp" // parseTimestamp
+
+#include <spdlog/fmt/bundled/core.h>
+
+#include <charconv>
+#include <cstdint>
+
+namespace data {
+
+    namespace { // File-local helpers
+
+        constexpr int kMaxDepth = 256; // Nesting limit for skipped values
+
+        bool isNumberStart(char c) { return c == '-' || (c >= '0' && c <= '9'); }
+        bool isNumberChar(char c) {
+            return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+        }
+
+        void appendUtf8(std::string& out, std::uint32_t cp) {
+            if (cp < 0x80) {
+                out += static_cast<char>(cp);
+            } else if (cp < 0x800) {
+                out += static_cast<char>(0xC0 | (cp >> 6));
+                out += static_cast<char>(0x80 | (cp & 0x3F));
+            } else if (cp < 0x10000) {
+                out += static_cast<char>(0xE0 | (cp >> 12));
+                out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (cp & 0x3F));
+            } else {
+                out += static_cast<char>(0xF0 | (cp >> 18));
+                out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+                out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (cp & 0x3F));
+            }
+        }
+
+        // Cursor over the response buffer. On the first error it records a message
+        // and jumps to the end, so every later call fails fast.
+        class Scanner {
+        public:
+            explicit Scanner(std::string_view text)
+                : begin_(text.data()), p_(text.data()), end_(text.data() + text.size()) {}
+
+            bool failed() const { return !error_.empty(); }
+            const std::string& error() const { return error_; }
+            bool atEnd() { skipWhitespace(); return p_ == end_; }
+
+            bool fail(const char* what) {
+                if (error_.empty()) error_ = fmt::format("{} at byte {}", what, p_ - begin_);
+                p_ = end_;
+                return false;
+            }
+
+            char peek() {
+                skipWhitespace();
+                return p_ < end_ ? *p_ : '\0';
+            }
+
+            bool consume(char c) {
+                if (peek() != c) return false;
+                ++p_;
+                return true;
+            }
+
+            bool expect(char c, const char* what) { return consume(c) || fail(what); }
+
+            // String at the cursor. Without escapes 'out' points into the buffer;
+            // otherwise the decoded text is built in 'scratch' and 'out' views that.
+            bool readString(std::string_view& out, std::string& scratch) {
+                if (!consume('"')) return fail("Expected string");
+                const char* start = p_;
+                while (p_ < end_ && *p_ != '"' && *p_ != '\\') ++p_;
+                if (p_ < end_ && *p_ == '"') {
+                    out = std::string_view(start, static_cast<std::size_t>(p_ - start));
+                    ++p_;
+                    return true;
+                }
+                scratch.assign(start, p_);
+                while (p_ < end_) {
+                    const char c = *p_++;
+                    if (c == '"') {
+                        out = scratch;
+                        return true;
+                    }
+                    if (c != '\\') {
+                        scratch += c;
+                        continue;
+                    }
+                    if (p_ == end_) break;
+                    switch (const char e = *p_++) {
+                        case '"': case '\\': case '/': scratch += e; break;
+                        case 'b': scratch += '\b'; break;
+                        case 'f': scratch += '\f'; break;
+                        case 'n': scratch += '\n'; break;
+                        case 'r': scratch += '\r'; break;
+                        case 't': scratch += '\t'; break;
+                        case 'u': {
+                            std::uint32_t cp = 0;
+                            if (!readHex4(cp)) return false;
+                            // A high surrogate must be followed by a low one; a lone surrogate is
+                            // not a code point (nlohmann rejects both as well)
+                            if (cp >= 0xDC00 && cp <= 0xDFFF) return fail("Unpaired low surrogate in \\u escape");
+                            if (cp >= 0xD800 && cp <= 0xDBFF) {
+                                if (end_ - p_ < 6 || p_[0] != '\\' || p_[1] != 'u') {
+                                    return fail("Unpaired high surrogate in \\u escape");
+                                }
+                                p_ += 2;
+                                std::uint32_t low = 0;
+                                if (!readHex4(low)) return false;
+                                if (low < 0xDC00 || low > 0xDFFF) return fail("Invalid low surrogate in \\u escape");
+                                cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                            }
+                            appendUtf8(scratch, cp);
+                            break;
+                        }
+                        default: return fail("Invalid escape in string");
+                    }
+                }
+                return fail("Unterminated string");
+            }
+
+            // Raw characters of the number at the cursor (validated by the caller's conversion)
+            bool readNumber(std::string_view& token) {
+                skipWhitespace();
+                const char* start = p_;
+                while (p_ < end_ && isNumberChar(*p_)) ++p_;
+                if (p_ == start) return fail("Expected number");
+                token = std::string_view(start, static_cast<std::size_t>(p_ - start));
+                return true;
+            }
+
+            bool skipValue(int depth = 0) {
+                if (depth > kMaxDepth) return fail("Nesting too deep");
+                const char c = peek();
+                if (c == '{') {
+                    ++p_;
+                    if (consume('}')) return true;
+                    do {
+                        std::string_view key;
+                        if (!readString(key, scratch_) || !expect(':', "Expected ':'") || !skipValue(depth + 1)) return false;
+                    } while (consume(','));
+                    return expect('}', "Expected ',' or '}'");
+                }
+                if (c == '[') {
+                    ++p_;
+                    if (consume(']')) return true;
+                    do {
+                        if (!skipValue(depth + 1)) return false;
+                    } while (consume(','));
+                    return expect(']', "Expected ',' or ']'");
+                }
+                if (c == '"') {
+                    std::string_view ignored;
+                    return readString(ignored, scratch_);
+                }
+                if (isNumberStart(c)) {
+                    std::string_view ignored;
+                    return readNumber(ignored);
+                }
+                return readLiteral("true") || readLiteral("false") || readLiteral("null") || fail("Unexpected character");
+            }
+
+        private:
+            void skipWhitespace() {
+                while (p_ < end_ && (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' || *p_ == '\t')) ++p_;
+            }
+
+            bool readLiteral(std::string_view literal) {
+                if (static_cast<std::size_t>(end_ - p_) < literal.size() || std::string_view(p_, literal.size()) != literal) {
+                    return false;
+                }
+                p_ += literal.size();
+                return true;
+            }
+
+            bool readHex4(std::uint32_t& value) {
+                if (end_ - p_ < 4) return fail("Truncated \\u escape");
+                const auto [ptr, ec] = std::from_chars(p_, p_ + 4, value, 16);
+                if (ec != std::errc() || ptr != p_ + 4) return fail("Invalid \\u escape");
+                p_ += 4;
+                return true;
+            }
+
+            const char* begin_;
+            const char* p_;
+            const char* end_;
+            std::string error_;
+            std::string scratch_; // For strings that are skipped
+        };
+
+        bool toDouble(std::string_view token, double& value) {
+            const auto [ptr, ec] = std::from_chars(token.data(), token.data() + token.size(), value);
+            return ec == std::errc() && ptr == token.data() + token.size();
+        }
+
+        // Integers usually, but accept "1234.0" / "1.2e3" as well (truncated). A value
+        // outside long long's range (or NaN) is an error: the cast would be undefined.
+        bool toInt64(std::string_view token, long long& value) {
+            const auto [ptr, ec] = std::from_chars(token.data(), token.data() + token.size(), value);
+            if (ec == std::errc() && ptr == token.data() + token.size()) return true;
+            double as_double = 0.0;
+            if (!toDouble(token, as_double)) return false;
+            // -2^63 and 2^63 are exact doubles; NaN fails both comparisons
+            if (!(as_double >= -9223372036854775808.0 && as_double < 9223372036854775808.0)) return false;
+            value = static_cast<long long>(as_double);
+            return true;
+        }
+
+        class ResponseParser {
+        public:
+            ResponseParser(std::string_view body, const std::function<void(const core::Candle&)>& on_candle)
+                : scanner_(body), on_candle_(on_candle) {}
+
+            UpstoxCandleParseResult run() {
+                parseRoot();
+                if (!scanner_.failed() && !scanner_.atEnd()) scanner_.fail("Trailing characters after JSON value");
+                result_.error = scanner_.error();
+                result_.ok = !scanner_.failed() && found_candles_ &&
+                             (result_.status.empty() || result_.status == "success");
+                return std::move(result_);
+            }
+
+        private:
+            // Calls 'on_member(key)' for each member of the object at the cursor;
+            // the callback must consume the value.
+            template <typename OnMember>
+            void parseObject(OnMember&& on_member) {
+                if (!scanner_.expect('{', "Expected object")) return;
+                if (scanner_.consume('}')) return;
+                do {
+                    std::string_view key;
+                    if (!scanner_.readString(key, key_scratch_) || !scanner_.expect(':', "Expected ':'")) return;
+                    on_member(key);
+                    if (scanner_.failed()) return;
+                } while (scanner_.consume(','));
+                scanner_.expect('}', "Expected ',' or '}'");
+            }
+
+            template <typename OnElement>
+            void parseArray(OnElement&& on_element) {
+                if (!scanner_.expect('[', "Expected array")) return;
+                if (scanner_.consume(']')) return;
+                do {
+                    on_element();
+                    if (scanner_.failed()) return;
+                } while (scanner_.consume(','));
+                scanner_.expect(']', "Expected ',' or ']'");
+            }
+
+            void readStringInto(std::string& out) {
+                std::string_view value;
+                if (scanner_.readString(value, value_scratch_)) out.assign(value);
+            }
+
+            void parseRoot() {
+                parseObject([&](std::string_view key) {
+                    const char next = scanner_.peek();
+                    if (key == "status" && next == '"') {
+                        readStringInto(result_.status);
+                    } else if (key == "message" && next == '"') {
+                        readStringInto(result_.message); // Takes precedence over errors[].message
+                    } else if (key == "errors" && next == '[') {
+                        parseErrors();
+                    } else if (key == "data" && next == '{') {
+                        parseObject([&](std::string_view data_key) {
+                            if (data_key == "candles" && scanner_.peek() == '[') {
+                                found_candles_ = true;
+                                parseArray([&] { parseRow(); });
+                            } else {
+                                scanner_.skipValue();
+                            }
+                        });
+                    } else {
+                        scanner_.skipValue();
+                    }
+                });
+            }
+
+            // {"errors":[{"errorCode":"...","message":"..."}]}: keeps the first message
+            void parseErrors() {
+                parseArray([&] {
+                    if (scanner_.peek() != '{') {
+                        scanner_.skipValue();
+                        return;
+                    }
+                    parseObject([&](std::string_view key) {
+                        if (key == "message" && scanner_.peek() == '"' && result_.message.empty()) {
+                            readStringInto(result_.message);
+                        } else {
+                            scanner_.skipValue();
+                        }
+                    });
+                });
+            }
+
+            // [ts, open, high, low, close, volume(, oi)] decoded in place
+            void parseRow() {
+                if (scanner_.peek() != '[') {
+                    ++result_.skipped_rows;
+                    scanner_.skipValue();
+                    return;
+                }
+                core::Candle candle;
+                bool valid = true;
+                int field = 0;
+                parseArray([&] {
+                    const char next = scanner_.peek();
+                    std::string_view token;
+                    if (field == 0) {
+                        if (next == '"' && scanner_.readString(token, value_scratch_)) {
+                            valid = core::utils::parseTimestamp(token, candle.timestamp);
+                        } else {
+                            valid = false;
+                            scanner_.skipValue();
+                        }
+                    } else if (field <= 6 && isNumberStart(next) && scanner_.readNumber(token)) {
+                        long long integer = 0;
+                        switch (field) {
+                            case 1: valid = valid && toDouble(token, candle.open); break;
+                            case 2: valid = valid && toDouble(token, candle.high); break;
+                            case 3: valid = valid && toDouble(token, candle.low); break;
+                            case 4: valid = valid && toDouble(token, candle.close); break;
+                            case 5: valid = valid && toInt64(token, candle.volume); break;
+                            case 6:
+                                if (toInt64(token, integer)) {
+                                    candle.open_interest = integer;
+                                } else {
+                                    valid = false;
+                                }
+                                break;
+                        }
+                    } else {
+                        if (field <= 5) valid = false; // OI may be null; extra fields are ignored
+                        scanner_.skipValue();
+                    }
+                    ++field;
+                });
+                if (scanner_.failed()) return;
+                if (valid && field >= 6) {
+                    on_candle_(candle);
+                    ++result_.rows;
+                } else {
+                    ++result_.skipped_rows;
+                }
+            }
+
+            Scanner scanner_;
+            const std::function<void(const core::Candle&)>& on_candle_;
+            UpstoxCandleParseResult result_;
+            bool found_candles_ = false;
+            std::string key_scratch_;
+            std::string value_scratch_;
+        };
+
+    } // namespace
+
+    UpstoxCandleParseResult parseUpstoxCandleJson(std::string_view body,
+                                                  const std::function<void(const core::Candle&)>& on_candle)
+    {
+        return ResponseParser(body, on_candle).run();
+    }
+
+} // namespace data
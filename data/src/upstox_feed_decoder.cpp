@@ -0,0 +1,312 @@
+#include "upstox_feed_decoder.hpp"
+
+#include <cstring>
+#include <string>
+
+namespace data {
+
+namespace { // File-local helpers
+
+enum WireType : std::uint32_t { kVarint = 0, kFixed64 = 1, kLengthDelimited = 2, kFixed32 = 5 };
+
+// Forward-only reader over one protobuf message. Every read checks bounds; the
+// first failure sets 'error' and makes next() return false from then on.
+struct WireReader {
+    const unsigned char* pos;
+    const unsigned char* end;
+    const char* error = nullptr;
+
+    explicit WireReader(std::string_view bytes)
+        : pos(reinterpret_cast<const unsigned char*>(bytes.data())), end(pos + bytes.size()) {}
+
+    bool fail(const char* what) {
+        if (!error) error = what;
+        pos = end;
+        return false;
+    }
+
+    bool varint(std::uint64_t& out) {
+        out = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (pos == end) return fail("truncated varint");
+            const unsigned char byte = *pos++;
+            out |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) return true;
+        }
+        return fail("varint longer than 10 bytes");
+    }
+
+    // Reads the next field key; false at the end of the message or on error
+    bool next(std::uint32_t& field, std::uint32_t& wire_type) {
+        if (pos == end || error) return false;
+        std::uint64_t key = 0;
+        if (!varint(key)) return false;
+        field = static_cast<std::uint32_t>(key >> 3);
+        wire_type = static_cast<std::uint32_t>(key & 0x7);
+        if (field == 0) return fail("field number 0");
+        return true;
+    }
+
+    bool fixed64(std::uint64_t& out) {
+        if (end - pos < 8) return fail("truncated fixed64");
+        std::memcpy(&out, pos, 8); // Little-endian on the wire, as on every supported target
+        pos += 8;
+        return true;
+    }
+
+    bool lengthDelimited(std::string_view& out) {
+        std::uint64_t length = 0;
+        if (!varint(length)) return false;
+        if (length > static_cast<std::uint64_t>(end - pos)) return fail("length past the end of the message");
+        out = std::string_view(reinterpret_cast<const char*>(pos), static_cast<std::size_t>(length));
+        pos += length;
+        return true;
+    }
+
+    bool skip(std::uint32_t wire_type) {
+        std::uint64_t ignored = 0;
+        std::string_view ignored_bytes;
+        switch (wire_type) {
+            case kVarint: return varint(ignored);
+            case kFixed64: return fixed64(ignored);
+            case kLengthDelimited: return lengthDelimited(ignored_bytes);
+            case kFixed32:
+                if (end - pos < 4) return fail("truncated fixed32");
+                pos += 4;
+                return true;
+            default: return fail("unsupported wire type");
+        }
+    }
+
+    // Typed reads of a field whose key was just consumed; a wrong wire type is an error
+    bool readDouble(std::uint32_t wire_type, double& out) {
+        if (wire_type != kFixed64) return fail("double field with wrong wire type");
+        std::uint64_t bits = 0;
+        if (!fixed64(bits)) return false;
+        std::memcpy(&out, &bits, sizeof(out));
+        return true;
+    }
+
+    bool readInt64(std::uint32_t wire_type, std::int64_t& out) {
+        if (wire_type != kVarint) return fail("int64 field with wrong wire type");
+        std::uint64_t value = 0;
+        if (!varint(value)) return false;
+        out = static_cast<std::int64_t>(value);
+        return true;
+    }
+
+    bool readMessage(std::uint32_t wire_type, std::string_view& out) {
+        if (wire_type != kLengthDelimited) return fail("message field with wrong wire type");
+        return lengthDelimited(out);
+    }
+};
+
+// message LTPC { double ltp = 1; int64 ltt = 2; int64 ltq = 3; double cp = 4; }
+const char* decodeLtpc(std::string_view bytes, UpstoxFeedTick& tick) {
+    WireReader reader(bytes);
+    std::uint32_t field = 0, wire_type = 0;
+    while (reader.next(field, wire_type)) {
+        switch (field) {
+            case 1: reader.readDouble(wire_type, tick.ltp); break;
+            case 2: reader.readInt64(wire_type, tick.ltt_ms); break;
+            case 3: reader.readInt64(wire_type, tick.ltq); break;
+            case 4: reader.readDouble(wire_type, tick.close_price); break;
+            default: reader.skip(wire_type); break;
+        }
+    }
+    return reader.error;
+}
+
+// The LTPC, volume-traded-today and open-interest fields of MarketFullFeed
+// (1, 6, 7), IndexFullFeed (1, -, -) and FirstLevelWithGreeks (1, 4, 5)
+const char* decodeQuoteFeed(std::string_view bytes, std::uint32_t vtt_field, std::uint32_t oi_field,
+                            UpstoxFeedTick& tick, bool& has_ltpc) {
+    WireReader reader(bytes);
+    std::uint32_t field = 0, wire_type = 0;
+    while (reader.next(field, wire_type)) {
+        std::string_view nested;
+        if (field == 1) {
+            if (!reader.readMessage(wire_type, nested)) break;
+            if (const char* error = decodeLtpc(nested, tick)) return error;
+            has_ltpc = true;
+        } else if (vtt_field != 0 && field == vtt_field) {
+            reader.readInt64(wire_type, tick.vtt);
+        } else if (oi_field != 0 && field == oi_field) {
+            if (reader.readDouble(wire_type, tick.open_interest)) tick.has_open_interest = true;
+        } else {
+            reader.skip(wire_type);
+        }
+    }
+    return reader.error;
+}
+
+// message FullFeed { oneof { MarketFullFeed marketFF = 1; IndexFullFeed indexFF = 2; } }
+const char* decodeFullFeed(std::string_view bytes, UpstoxFeedTick& tick, bool& has_ltpc) {
+    WireReader reader(bytes);
+    std::uint32_t field = 0, wire_type = 0;
+    while (reader.next(field, wire_type)) {
+        std::string_view nested;
+        if (field == 1 || field == 2) {
+            if (!reader.readMessage(wire_type, nested)) break;
+            const char* error = (field == 1) ? decodeQuoteFeed(nested, 6, 7, tick, has_ltpc)
+                                             : decodeQuoteFeed(nested, 0, 0, tick, has_ltpc);
+            if (error) return error;
+        } else {
+            reader.skip(wire_type);
+        }
+    }
+    return reader.error;
+}
+
+// message Feed { oneof { LTPC ltpc = 1; FullFeed fullFeed = 2; FirstLevelWithGreeks firstLevelWithGreeks = 3; }
+//                RequestMode requestMode = 4; }
+const char* decodeFeed(std::string_view bytes, UpstoxFeedTick& tick, bool& has_ltpc) {
+    WireReader reader(bytes);
+    std::uint32_t field = 0, wire_type = 0;
+    while (reader.next(field, wire_type)) {
+        std::string_view nested;
+        const char* error = nullptr;
+        switch (field) {
+            case 1:
+                if (!reader.readMessage(wire_type, nested)) break;
+                error = decodeLtpc(nested, tick);
+                has_ltpc = true;
+                break;
+            case 2:
+                if (!reader.readMessage(wire_type, nested)) break;
+                error = decodeFullFeed(nested, tick, has_ltpc);
+                break;
+            case 3:
+                if (!reader.readMessage(wire_type, nested)) break;
+                error = decodeQuoteFeed(nested, 4, 5, tick, has_ltpc);
+                break;
+            default:
+                reader.skip(wire_type);
+                break;
+        }
+        if (error) return error;
+    }
+    return reader.error;
+}
+
+// --- Encoding (replay and tests) ---
+
+void appendVarint(std::string& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+void appendKey(std::string& out, std::uint32_t field, WireType wire_type) {
+    appendVarint(out, (static_cast<std::uint64_t>(field) << 3) | wire_type);
+}
+
+void appendInt64(std::string& out, std::uint32_t field, std::int64_t value) {
+    appendKey(out, field, kVarint);
+    appendVarint(out, static_cast<std::uint64_t>(value));
+}
+
+void appendDouble(std::string& out, std::uint32_t field, double value) {
+    appendKey(out, field, kFixed64);
+    char bytes[8];
+    std::memcpy(bytes, &value, sizeof(bytes));
+    out.append(bytes, sizeof(bytes));
+}
+
+void appendBytes(std::string& out, std::uint32_t field, std::string_view bytes) {
+    appendKey(out, field, kLengthDelimited);
+    appendVarint(out, bytes.size());
+    out.append(bytes);
+}
+
+} // end anonymous namespace
+
+// message FeedResponse { Type type = 1; map<string, Feed> feeds = 2; int64 currentTs = 3;
+//                        MarketInfo marketInfo = 4; }
+UpstoxFeedDecodeResult decodeUpstoxFeed(std::string_view message,
+                                        const std::function<void(const UpstoxFeedTick&)>& on_tick)
+{
+    UpstoxFeedDecodeResult result;
+    WireReader reader(message);
+    std::uint32_t field = 0, wire_type = 0;
+    while (reader.next(field, wire_type)) {
+        if (field == 1) {
+            std::int64_t type = 0;
+            if (reader.readInt64(wire_type, type)) result.type = static_cast<UpstoxFeedType>(type);
+        } else if (field == 3) {
+            reader.readInt64(wire_type, result.current_ts_ms);
+        } else if (field == 2) {
+            // Map entry: { string key = 1; Feed value = 2; }, in either order
+            std::string_view entry;
+            if (!reader.readMessage(wire_type, entry)) break;
+            ++result.feeds;
+            WireReader entry_reader(entry);
+            std::string_view key, value;
+            std::uint32_t entry_field = 0, entry_wire_type = 0;
+            while (entry_reader.next(entry_field, entry_wire_type)) {
+                if (entry_field == 1) entry_reader.readMessage(entry_wire_type, key);
+                else if (entry_field == 2) entry_reader.readMessage(entry_wire_type, value);
+                else entry_reader.skip(entry_wire_type);
+            }
+            if (entry_reader.error) {
+                result.error = entry_reader.error;
+                return result;
+            }
+
+            UpstoxFeedTick tick;
+            tick.instrument_key = key;
+            bool has_ltpc = false;
+            if (const char* error = decodeFeed(value, tick, has_ltpc)) {
+                result.error = error;
+                return result;
+            }
+            if (has_ltpc && !key.empty()) {
+                ++result.ticks;
+                on_tick(tick);
+            }
+        } else {
+            reader.skip(wire_type);
+        }
+    }
+    result.error = reader.error;
+    result.ok = (reader.error == nullptr);
+    return result;
+}
+
+void appendUpstoxFeedMessage(std::string& out, UpstoxFeedType type, std::int64_t current_ts_ms,
+                             const std::vector<UpstoxFeedTick>& ticks)
+{
+    std::string body, entry, feed, ltpc, full;
+    appendInt64(body, 1, static_cast<std::int64_t>(type));
+    for (const auto& tick : ticks) {
+        ltpc.clear();
+        appendDouble(ltpc, 1, tick.ltp);
+        appendInt64(ltpc, 2, tick.ltt_ms);
+        appendInt64(ltpc, 3, tick.ltq);
+        appendDouble(ltpc, 4, tick.close_price);
+
+        feed.clear();
+        if (tick.vtt >= 0 || tick.has_open_interest) {
+            full.clear();
+            appendBytes(full, 1, ltpc);
+            if (tick.vtt >= 0) appendInt64(full, 6, tick.vtt);
+            if (tick.has_open_interest) appendDouble(full, 7, tick.open_interest);
+            std::string full_feed;
+            appendBytes(full_feed, 1, full); // FullFeed.marketFF
+            appendBytes(feed, 2, full_feed);
+        } else {
+            appendBytes(feed, 1, ltpc);
+        }
+
+        entry.clear();
+        appendBytes(entry, 1, tick.instrument_key);
+        appendBytes(entry, 2, feed);
+        appendBytes(body, 2, entry);
+    }
+    appendInt64(body, 3, current_ts_ms);
+    out.append(body);
+}
+
+} // namespace data
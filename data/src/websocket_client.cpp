@@ -0,0 +1,460 @@
+#include "websocket_client.hpp"
+#include "logging.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/ssl.h>
+#include <openssl/x509v3.h>
+
+namespace data {
+
+namespace { // File-local helpers
+
+constexpr std::string_view kHandshakeGuid = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"; // RFC 6455 section 1.3
+constexpr std::size_t kReadChunk = 64 * 1024;
+constexpr std::size_t kMaxHandshakeBytes = 16 * 1024;
+
+std::int64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Waits until 'fd' is ready for 'events' or the deadline passes
+bool waitFor(int fd, short events, std::int64_t deadline_ms) {
+    for (;;) {
+        const std::int64_t left = deadline_ms - nowMs();
+        pollfd entry{fd, events, 0};
+        const int ready = ::poll(&entry, 1, left > 0 ? static_cast<int>(left) : 0);
+        if (ready < 0 && errno == EINTR) continue;
+        return ready > 0;
+    }
+}
+
+std::string base64(const unsigned char* bytes, std::size_t size) {
+    std::string out(4 * ((size + 2) / 3), '\0');
+    const int written = EVP_EncodeBlock(reinterpret_cast<unsigned char*>(out.data()), bytes, static_cast<int>(size));
+    out.resize(written > 0 ? static_cast<std::size_t>(written) : 0);
+    return out;
+}
+
+// Sec-WebSocket-Accept the server must answer for 'key'
+std::string expectedAccept(const std::string& key) {
+    const std::string input = key + std::string(kHandshakeGuid);
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int digest_size = 0;
+    EVP_Digest(input.data(), input.size(), digest, &digest_size, EVP_sha1(), nullptr);
+    return base64(digest, digest_size);
+}
+
+bool iequals(std::string_view a, std::string_view b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+        return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+    });
+}
+
+std::string sslErrorString() {
+    const unsigned long code = ERR_get_error();
+    if (code == 0) return "unknown TLS error";
+    char text[256];
+    ERR_error_string_n(code, text, sizeof(text));
+    return text;
+}
+
+} // end anonymous namespace
+
+WebSocketClient::WebSocketClient(WebSocketOptions options)
+    : options_(options), mask_random_(std::random_device{}()) {}
+
+WebSocketClient::~WebSocketClient() {
+    close();
+    if (ssl_ctx_) SSL_CTX_free(ssl_ctx_);
+}
+
+bool WebSocketClient::parseUrl(const std::string& url, bool& secure, std::string& host, std::uint16_t& port,
+                               std::string& target) {
+    std::size_t pos = 0;
+    if (url.rfind("wss://", 0) == 0) {
+        secure = true;
+        pos = 6;
+    } else if (url.rfind("ws://", 0) == 0) {
+        secure = false;
+        pos = 5;
+    } else {
+        return false;
+    }
+    const std::size_t path_start = std::min(url.find_first_of("/?", pos), url.size());
+    std::string authority = url.substr(pos, path_start - pos);
+    target = path_start < url.size() ? url.substr(path_start) : "/";
+    if (target.front() == '?') target.insert(target.begin(), '/');
+
+    port = secure ? 443 : 80;
+    const std::size_t colon = authority.rfind(':');
+    if (colon != std::string::npos && authority.find(']') == std::string::npos) {
+        const std::string digits = authority.substr(colon + 1);
+        if (digits.empty() || digits.size() > 5 || !std::all_of(digits.begin(), digits.end(), ::isdigit)) return false;
+        const unsigned long value = std::stoul(digits);
+        if (value == 0 || value > 65535) return false;
+        port = static_cast<std::uint16_t>(value);
+        authority.resize(colon);
+    }
+    host = std::move(authority);
+    return !host.empty();
+}
+
+void WebSocketClient::close() {
+    if (ssl_) {
+        SSL_shutdown(ssl_); // Best effort close_notify; the socket is non-blocking
+        SSL_free(ssl_);
+        ssl_ = nullptr;
+    }
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = -1;
+    read_pos_ = 0;
+    write_pos_ = 0;
+    fragment_opcode_ = 0;
+}
+
+bool WebSocketClient::connect(const std::string& url,
+                              const std::vector<std::pair<std::string, std::string>>& headers) {
+    auto logger = core::logging::getLogger();
+    close();
+    bool secure = false;
+    std::string host, target;
+    std::uint16_t port = 0;
+    if (!parseUrl(url, secure, host, port, target)) {
+        logger->error("WebSocket: not a ws:// or wss:// URL.");
+        return false;
+    }
+    const std::int64_t deadline = nowMs() + options_.connect_timeout_ms;
+
+    // --- TCP ---
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    const std::string service = std::to_string(port);
+    if (const int rc = ::getaddrinfo(host.c_str(), service.c_str(), &hints, &addresses); rc != 0) {
+        logger->warn("WebSocket: cannot resolve {}: {}", host, ::gai_strerror(rc));
+        return false;
+    }
+    for (addrinfo* address = addresses; address && fd_ < 0; address = address->ai_next) {
+        const int fd = ::socket(address->ai_family, address->ai_socktype | SOCK_CLOEXEC | SOCK_NONBLOCK, address->ai_protocol);
+        if (fd < 0) continue;
+        int rc = ::connect(fd, address->ai_addr, address->ai_addrlen);
+        if (rc != 0 && errno == EINPROGRESS && waitFor(fd, POLLOUT, deadline)) {
+            int error = 0;
+            socklen_t length = sizeof(error);
+            ::getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length);
+            rc = error == 0 ? 0 : -1;
+        }
+        if (rc != 0) {
+            ::close(fd);
+            continue;
+        }
+        const int one = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        fd_ = fd; // Stays non-blocking; every read and write polls with a deadline
+    }
+    ::freeaddrinfo(addresses);
+    if (fd_ < 0) {
+        logger->warn("WebSocket: cannot connect to {}:{}.", host, port);
+        return false;
+    }
+
+    // --- TLS ---
+    if (secure) {
+        if (!ssl_ctx_) {
+            ssl_ctx_ = SSL_CTX_new(TLS_client_method());
+            if (!ssl_ctx_) {
+                logger->error("WebSocket: cannot create TLS context: {}", sslErrorString());
+                close();
+                return false;
+            }
+            SSL_CTX_set_min_proto_version(ssl_ctx_, TLS1_2_VERSION);
+            SSL_CTX_set_default_verify_paths(ssl_ctx_);
+        }
+        ssl_ = SSL_new(ssl_ctx_);
+        SSL_set_fd(ssl_, fd_);
+        SSL_set_tlsext_host_name(ssl_, host.c_str());
+        if (options_.verify_peer) {
+            SSL_set_verify(ssl_, SSL_VERIFY_PEER, nullptr);
+            SSL_set1_host(ssl_, host.c_str());
+        }
+        for (;;) {
+            const int rc = SSL_connect(ssl_);
+            if (rc == 1) break;
+            const int error = SSL_get_error(ssl_, rc);
+            const bool ready = (error == SSL_ERROR_WANT_READ)  ? waitFor(fd_, POLLIN, deadline)
+                             : (error == SSL_ERROR_WANT_WRITE) ? waitFor(fd_, POLLOUT, deadline)
+                                                               : false;
+            if (!ready) {
+                logger->warn("WebSocket: TLS handshake with {} failed: {}", host, sslErrorString());
+                close();
+                return false;
+            }
+        }
+    }
+
+    if (!handshake(host, port, target, headers, deadline)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool WebSocketClient::handshake(const std::string& host, std::uint16_t port, const std::string& target,
+                                const std::vector<std::pair<std::string, std::string>>& headers,
+                                std::int64_t deadline_ms) {
+    auto logger = core::logging::getLogger();
+    unsigned char nonce[16];
+    for (auto& byte : nonce) byte = static_cast<unsigned char>(mask_random_());
+    const std::string key = base64(nonce, sizeof(nonce));
+
+    std::string request = "GET " + target + " HTTP/1.1\r\n";
+    request += "Host: " + host + ((port == 80 || port == 443) ? "" : ":" + std::to_string(port)) + "\r\n";
+    request += "Upgrade: websocket\r\nConnection: Upgrade\r\n";
+    request += "Sec-WebSocket-Key: " + key + "\r\nSec-WebSocket-Version: 13\r\n";
+    for (const auto& [name, value] : headers) request += name + ": " + value + "\r\n";
+    request += "\r\n";
+    if (!writeAll(request.data(), request.size())) {
+        logger->warn("WebSocket: sending the upgrade request to {} failed.", host);
+        return false;
+    }
+
+    std::size_t header_end;
+    while ((header_end = std::string_view(buffer_.data(), write_pos_).find("\r\n\r\n")) == std::string_view::npos) {
+        if (write_pos_ > kMaxHandshakeBytes || readMore(deadline_ms) != IoStatus::Ok) {
+            logger->warn("WebSocket: no upgrade response from {}.", host);
+            return false;
+        }
+    }
+    const std::string_view head(buffer_.data(), header_end);
+    // "HTTP/1.1 101 Switching Protocols"
+    if (head.size() < 12 || head.substr(0, 5) != "HTTP/" || head.substr(9, 3) != "101") {
+        logger->warn("WebSocket: {} refused the upgrade: {}", host, head.substr(0, head.find("\r\n")));
+        return false;
+    }
+    bool accept_ok = false;
+    const std::string expected = expectedAccept(key);
+    for (std::size_t pos = head.find("\r\n") + 2; pos < head.size();) {
+        std::size_t end = head.find("\r\n", pos);
+        if (end == std::string_view::npos) end = head.size();
+        const std::string_view line = head.substr(pos, end - pos);
+        if (const std::size_t colon = line.find(':'); colon != std::string_view::npos) {
+            std::string_view value = line.substr(colon + 1);
+            while (!value.empty() && value.front() == ' ') value.remove_prefix(1);
+            while (!value.empty() && value.back() == ' ') value.remove_suffix(1);
+            if (iequals(line.substr(0, colon), "sec-websocket-accept")) accept_ok = (value == expected);
+        }
+        pos = end + 2;
+    }
+    if (!accept_ok) {
+        logger->warn("WebSocket: {} answered the upgrade without a valid Sec-WebSocket-Accept.", host);
+        return false;
+    }
+    read_pos_ = header_end + 4; // Frames may already follow the headers
+    return true;
+}
+
+bool WebSocketClient::writeAll(const char* data, std::size_t size) {
+    const std::int64_t deadline = nowMs() + options_.write_timeout_ms;
+    while (size > 0) {
+        if (ssl_) {
+            const int written = SSL_write(ssl_, data, static_cast<int>(std::min<std::size_t>(size, 1 << 30)));
+            if (written > 0) {
+                data += written;
+                size -= static_cast<std::size_t>(written);
+                continue;
+            }
+            const int error = SSL_get_error(ssl_, written);
+            const bool ready = (error == SSL_ERROR_WANT_READ)  ? waitFor(fd_, POLLIN, deadline)
+                             : (error == SSL_ERROR_WANT_WRITE) ? waitFor(fd_, POLLOUT, deadline)
+                                                               : false;
+            if (!ready) return false;
+        } else {
+            const ssize_t sent = ::send(fd_, data, size, MSG_NOSIGNAL);
+            if (sent > 0) {
+                data += sent;
+                size -= static_cast<std::size_t>(sent);
+                continue;
+            }
+            if (sent < 0 && errno == EINTR) continue;
+            if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) && waitFor(fd_, POLLOUT, deadline)) continue;
+            return false;
+        }
+    }
+    return true;
+}
+
+WebSocketClient::IoStatus WebSocketClient::readMore(std::int64_t deadline_ms) {
+    // Make room at the end: move unconsumed bytes to the front, grow only for large frames
+    if (buffer_.size() - write_pos_ < kReadChunk / 4) {
+        if (read_pos_ > 0) {
+            std::memmove(buffer_.data(), buffer_.data() + read_pos_, write_pos_ - read_pos_);
+            write_pos_ -= read_pos_;
+            read_pos_ = 0;
+        }
+        if (buffer_.size() - write_pos_ < kReadChunk / 4) buffer_.resize(write_pos_ + kReadChunk);
+    }
+    char* target = buffer_.data() + write_pos_;
+    const std::size_t room = buffer_.size() - write_pos_;
+    for (;;) {
+        if (ssl_) {
+            const int received = SSL_read(ssl_, target, static_cast<int>(std::min<std::size_t>(room, 1 << 30)));
+            if (received > 0) {
+                write_pos_ += static_cast<std::size_t>(received);
+                return IoStatus::Ok;
+            }
+            const int error = SSL_get_error(ssl_, received);
+            if (error == SSL_ERROR_WANT_READ || error == SSL_ERROR_WANT_WRITE) {
+                if (waitFor(fd_, error == SSL_ERROR_WANT_READ ? POLLIN : POLLOUT, deadline_ms)) continue;
+                return IoStatus::Timeout;
+            }
+        } else {
+            const ssize_t received = ::recv(fd_, target, room, 0);
+            if (received > 0) {
+                write_pos_ += static_cast<std::size_t>(received);
+                return IoStatus::Ok;
+            }
+            if (received < 0 && errno == EINTR) continue;
+            if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                if (waitFor(fd_, POLLIN, deadline_ms)) continue;
+                return IoStatus::Timeout;
+            }
+        }
+        return IoStatus::Closed;
+    }
+}
+
+bool WebSocketClient::sendFrame(std::uint8_t opcode, std::string_view payload) {
+    if (fd_ < 0) return false;
+    frame_out_.clear();
+    frame_out_.push_back(static_cast<char>(0x80 | opcode)); // FIN, never fragmented
+    const std::size_t size = payload.size();
+    if (size < 126) {
+        frame_out_.push_back(static_cast<char>(0x80 | size));
+    } else if (size <= 0xFFFF) {
+        frame_out_.push_back(static_cast<char>(0x80 | 126));
+        frame_out_.push_back(static_cast<char>(size >> 8));
+        frame_out_.push_back(static_cast<char>(size & 0xFF));
+    } else {
+        frame_out_.push_back(static_cast<char>(0x80 | 127));
+        for (int shift = 56; shift >= 0; shift -= 8) frame_out_.push_back(static_cast<char>((size >> shift) & 0xFF));
+    }
+    // Client frames are always masked (RFC 6455 section 5.3)
+    const std::uint32_t mask_word = static_cast<std::uint32_t>(mask_random_());
+    char mask[4];
+    std::memcpy(mask, &mask_word, sizeof(mask));
+    frame_out_.append(mask, sizeof(mask));
+    const std::size_t payload_start = frame_out_.size();
+    frame_out_.append(payload);
+    for (std::size_t i = 0; i < size; ++i) frame_out_[payload_start + i] ^= mask[i & 3];
+    if (!writeAll(frame_out_.data(), frame_out_.size())) {
+        core::logging::getLogger()->warn("WebSocket: sending a frame failed.");
+        close();
+        return false;
+    }
+    return true;
+}
+
+WebSocketClient::ReadStatus WebSocketClient::fail(const char* what) {
+    core::logging::getLogger()->warn("WebSocket: {}", what);
+    close();
+    return ReadStatus::Closed;
+}
+
+WebSocketClient::ReadStatus WebSocketClient::receive(std::string_view& message, bool& binary, int timeout_ms) {
+    if (fd_ < 0) return ReadStatus::Closed;
+    const std::int64_t deadline = nowMs() + timeout_ms;
+    for (;;) {
+        // --- Parse one frame from the buffered bytes ---
+        const std::size_t available = write_pos_ - read_pos_;
+        if (available >= 2) {
+            auto* frame = reinterpret_cast<unsigned char*>(buffer_.data() + read_pos_);
+            const bool fin = (frame[0] & 0x80) != 0;
+            const std::uint8_t opcode = frame[0] & 0x0F;
+            const bool masked = (frame[1] & 0x80) != 0;
+            std::uint64_t length = frame[1] & 0x7F;
+            std::size_t header = 2;
+            if (length == 126) header = 4;
+            else if (length == 127) header = 10;
+            if (masked) header += 4;
+            if (available >= header) {
+                if (length == 126) {
+                    length = (static_cast<std::uint64_t>(frame[2]) << 8) | frame[3];
+                } else if (length == 127) {
+                    length = 0;
+                    for (int i = 2; i < 10; ++i) length = (length << 8) | frame[i];
+                }
+                if (length > options_.max_message_bytes) return fail("frame larger than max_message_bytes");
+                if (available - header >= length) {
+                    char* payload = buffer_.data() + read_pos_ + header;
+                    if (masked) {
+                        const unsigned char* mask = frame + header - 4;
+                        for (std::uint64_t i = 0; i < length; ++i) payload[i] ^= static_cast<char>(mask[i & 3]);
+                    }
+                    const std::string_view body(payload, static_cast<std::size_t>(length));
+                    read_pos_ += header + static_cast<std::size_t>(length);
+
+                    if (opcode == 0x8) { // Close: echo the status code, then drop the connection
+                        sendFrame(0x8, body.substr(0, std::min<std::size_t>(body.size(), 2)));
+                        close();
+                        return ReadStatus::Closed;
+                    }
+                    if (opcode == 0x9) { // Ping. sendFrame() reuses frame_out_, never buffer_
+                        if (!sendFrame(0xA, body)) return ReadStatus::Closed;
+                        continue;
+                    }
+                    if (opcode == 0xA) continue; // Unsolicited pong
+                    if (opcode == 0x1 || opcode == 0x2) {
+                        if (fragment_opcode_ != 0) return fail("new message inside a fragmented one");
+                        if (fin) { // The common case: handed out in place
+                            message = body;
+                            binary = (opcode == 0x2);
+                            return ReadStatus::Message;
+                        }
+                        fragment_opcode_ = opcode;
+                        fragments_.assign(body);
+                        continue;
+                    }
+                    if (opcode == 0x0) {
+                        if (fragment_opcode_ == 0) return fail("continuation frame without a message");
+                        if (fragments_.size() + body.size() > options_.max_message_bytes) {
+                            return fail("message larger than max_message_bytes");
+                        }
+                        fragments_.append(body);
+                        if (!fin) continue;
+                        message = fragments_;
+                        binary = (fragment_opcode_ == 0x2);
+                        fragment_opcode_ = 0;
+                        return ReadStatus::Message;
+                    }
+                    return fail("unknown frame opcode");
+                }
+            }
+        }
+
+        // --- Need more bytes (may move the buffer: views handed out are now stale) ---
+        switch (readMore(deadline)) {
+            case IoStatus::Ok: break;
+            case IoStatus::Timeout: return ReadStatus::Timeout;
+            case IoStatus::Closed: return fail("connection closed by the peer");
+        }
+    }
+}
+
+} // namespace data
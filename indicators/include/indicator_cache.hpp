@@ -0,0 +1,68 @@
+#pragma once
+
+#include "datatypes.hpp" // Needs Candle, TimeSeries
+#include "candle_series.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <tuple>
+
+namespace indicators {
+
+    // --- IndicatorCache ---
+    // Thread-safe store of computed indicator series, shared read-only between
+    // backtest runs. Entries are keyed by (instrument, interval, date range,
+    // indicator spec such as "SMA(20)"), so a sweep or a batch of strategies on the
+    // same data computes each indicator once.
+    //
+    // Optional disk tier: when constructed with a directory, computed series are also
+    // written there as small binary files and reused by later processes. Each file
+    // records a fingerprint of the input candles and is ignored if the data changed.
+    class IndicatorCache {
+    public:
+        using ResultPtr = std::shared_ptr<const core::TimeSeries<double>>;
+        using Compute = std::function<core::TimeSeries<double>()>;
+
+        // Empty directory = memory only
+        explicit IndicatorCache(std::string disk_directory = "");
+
+        // Returns the cached series for the key, invoking 'compute' on a miss.
+        // 'input' is only read to fingerprint the data for the disk tier.
+        // Exceptions thrown by 'compute' propagate and nothing is cached.
+        ResultPtr getOrCompute(const std::string& instrument_key,
+                               const std::string& interval,
+                               core::Timestamp start_time,
+                               core::Timestamp end_time,
+                               const std::string& indicator_spec,
+                               const core::CandleSeries& input,
+                               const Compute& compute);
+
+        std::size_t size() const;
+        void clear(); // Memory tier only; files on disk are kept
+        const std::string& getDiskDirectory() const { return disk_directory_; }
+
+        // Conventional disk location for a market data DB: "<db_path>.indicators"
+        static std::string defaultDirectoryFor(const std::string& db_path);
+
+        // FNV-1a over the timestamp and OHLCV columns of the input series
+        static std::uint64_t fingerprint(const core::CandleSeries& input);
+
+    private:
+        using Key = std::tuple<std::string, std::string, core::Timestamp, core::Timestamp, std::string>;
+
+        std::string diskPath(const Key& key) const;
+        std::optional<core::TimeSeries<double>> loadFromDisk(const std::string& path, std::uint64_t input_fingerprint) const;
+        void storeToDisk(const std::string& path, std::uint64_t input_fingerprint, const core::TimeSeries<double>& values) const;
+
+        std::string disk_directory_;
+        mutable std::mutex mutex_;
+        std::map<Key, std::shared_future<ResultPtr>> entries_;
+    };
+
+} // namespace indicators
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace indicators::kernels {
+
+    // Native indicator kernels over the columns of a core::CandleSeries.
+    //
+    // Inputs are read in place and outputs are written to caller-provided buffers,
+    // so a multi-output indicator fills all of its result vectors without temporary
+    // copies. Element-wise steps (true range, typical price, band offsets) are plain
+    // loops over contiguous spans that the compiler can vectorize; the recurrences
+    // (EMA, Wilder smoothing) are single forward passes.
+    //
+    // Where TA-Lib has the same function, the kernel follows its default-compatibility
+    // recurrence in the same operation order, so the values match TA-Lib's.
+    // Output k always belongs to input index k + lookback; output sizes are given below
+    // and callers must pass at least that many elements.
+
+    // max(high - low, |high - prev close|, |low - prev close|); out[0] = high[0] - low[0].
+    // out.size() == high.size()
+    void trueRange(std::span<const double> high, std::span<const double> low, std::span<const double> close,
+                   std::span<double> out);
+
+    // (high + low + close) / 3. out.size() == high.size()
+    void typicalPrice(std::span<const double> high, std::span<const double> low, std::span<const double> close,
+                      std::span<double> out);
+
+    // Simple moving average (TA_SMA). out.size() == in.size() - period + 1
+    void sma(std::span<const double> in, int period, std::span<double> out);
+
+    // Exponential moving average seeded with the SMA of the first 'period' values (TA_EMA).
+    // out.size() == in.size() - period + 1
+    void ema(std::span<const double> in, int period, std::span<double> out);
+
+    // Linearly weighted moving average, newest value weighted 'period' (TA_WMA).
+    // out.size() == in.size() - period + 1
+    void wma(std::span<const double> in, int period, std::span<double> out);
+
+    // Rolling mean and population standard deviation in one pass (TA_BBANDS' inputs).
+    // mean.size() == stddev.size() == in.size() - period + 1
+    void meanStdDev(std::span<const double> in, int period, std::span<double> mean, std::span<double> stddev);
+
+    // Rolling highest / lowest value over 'period' (TA_MAX / TA_MIN), O(n) with a monotonic queue.
+    // out.size() == in.size() - period + 1
+    void rollingMax(std::span<const double> in, int period, std::span<double> out);
+    void rollingMin(std::span<const double> in, int period, std::span<double> out);
+
+    // Wilder-smoothed average true range (TA_ATR), seeded with the mean of the first
+    // 'period' true ranges. out.size() == high.size() - period
+    void atr(std::span<const double> high, std::span<const double> low, std::span<const double> close,
+             int period, std::span<double> out);
+
+    // Volume-weighted average of the typical price, restarting at the first bar of
+    // each session. A session is one UTC calendar day (Indian cash sessions fall inside
+    // one). Bars before any volume report the typical price. out.size() == high.size()
+    void sessionVwap(std::span<const std::int64_t> timestamps_ns, std::span<const double> high,
+                     std::span<const double> low, std::span<const double> close, std::span<const double> volume,
+                     std::span<double> out);
+
+} // namespace indicators::kernels
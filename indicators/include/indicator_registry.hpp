@@ -0,0 +1,73 @@
+#pragma once
+
+#include "indicators.hpp" // Base interface
+#include <functional>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace indicators {
+
+// Indicator spec split into type and arguments: "BBANDS(20,2.5)" -> {"BBANDS", {20, 2.5}}
+struct IndicatorSpec {
+    std::string type;          // Upper case
+    std::vector<double> args;
+
+    // Canonical text: "TYPE(a,b)" with arguments in shortest form (2.0 -> "2"), or
+    // just "TYPE" without arguments. Equals getName() of the indicator it creates.
+    std::string toString() const;
+};
+
+// Hand-written parser for "TYPE" and "TYPE(arg, arg, ...)". The type is letters,
+// digits and '_' starting with a letter, matched case-insensitively; arguments are
+// decimal numbers. Throws std::invalid_argument naming the offending position.
+IndicatorSpec parseIndicatorSpec(std::string_view text);
+
+// --- IndicatorRegistry ---
+// Maps an indicator type ("SMA", "BBANDS", ...) to its factory and argument
+// defaults. Specs are resolved to canonical form before anything is created, so
+// "sma(10)", "SMA( 10 )" and "SMA(10.0)" all name the indicator "SMA(10)" and share
+// IndicatorCache entries, and "MACD" means "MACD(12,26,9)".
+//
+// instance() holds every built-in indicator; add() registers more (or replaces
+// one). Lookups may run concurrently with each other and with add().
+class IndicatorRegistry {
+public:
+    using Factory = std::function<std::unique_ptr<IIndicator>(const std::vector<double>& args)>;
+
+    struct Entry {
+        std::size_t required_args = 0; // Leading arguments without a default
+        std::vector<double> defaults;  // For the remaining ones; required_args + defaults.size() is the maximum
+        Factory factory;               // Receives the full argument list (defaults filled in)
+    };
+
+    // The process-wide registry with the built-in indicators
+    static IndicatorRegistry& instance();
+
+    IndicatorRegistry() = default; // Empty; see instance()
+
+    void add(const std::string& type, Entry entry);
+    bool contains(std::string_view type) const;
+    std::vector<std::string> types() const; // Sorted
+
+    // Parses 'text', checks the argument count and fills in defaults.
+    // Throws std::invalid_argument for malformed specs, unknown types and wrong arity.
+    IndicatorSpec resolve(std::string_view text) const;
+    std::string canonicalize(std::string_view text) const { return resolve(text).toString(); }
+
+    // New, uncalculated indicator for 'text'. Throws std::invalid_argument as resolve()
+    // does, or when the factory rejects the arguments (e.g. a negative period).
+    std::unique_ptr<IIndicator> create(std::string_view text) const;
+
+    // Argument helper for factories: a whole number in [1, 1e6] or std::invalid_argument
+    static int periodArgument(double value, const char* what);
+
+private:
+    mutable std::shared_mutex mutex_;
+    std::map<std::string, Entry, std::less<>> entries_;
+};
+
+} // namespace indicators
@@ -1,5 +1,6 @@
 #pragma once
 #include "datatypes.hpp" // Needs Candle, TimeSeries
+#include "candle_series.hpp" // Columnar input series
 #include <string>
 #include <vector>
 #include <any> // Or use specific types for results
@@ -24,7 +25,8 @@ public:
 
     // Calculate the indicator based on input candle data
     // It should store the result internally.
-    virtual void calculate(const core::TimeSeries<core::Candle>& input) = 0;
+    // Columns (e.g. input.close()) can be passed to TA-Lib directly, without copying.
+    virtual void calculate(const core::CandleSeries& input) = 0;
 
     // Get the calculated results.
     // Returns a vector of doubles. The size might be smaller than input
@@ -32,8 +34,49 @@ public:
     // Consider returning a struct with alignment info if needed.
     virtual const core::TimeSeries<double>& getResult() const = 0;
 
-    // Optional: Add methods for specific results if indicator returns multiple lines (e.g., MACD)
-    // virtual const core::TimeSeries<double>& getSignalLine() const = 0; // Example for MACD
+    // Moves the calculated results out of the indicator (leaving it empty),
+    // for callers that keep the series elsewhere (e.g. IndicatorCache) and
+    // should not hold a second copy.
+    virtual core::TimeSeries<double> releaseResult() = 0;
+
+    // --- Multiple outputs ---
+    // Indicators with several lines (Bollinger Bands, MACD, ADX, ...) compute all of
+    // them in one calculate(). Output 0 is what getResult() returns; every output
+    // starts at getLookback(). Strategies select one by name, e.g. "BBANDS(20,2).upper".
+    // The defaults describe a single-output indicator.
+    virtual std::size_t getOutputCount() const { return 1; }
+    virtual std::string getOutputName(std::size_t /*index*/) const { return {}; }
+    virtual const core::TimeSeries<double>& getOutput(std::size_t /*index*/) const { return getResult(); }
+    virtual core::TimeSeries<double> releaseOutput(std::size_t /*index*/) { return releaseResult(); }
+};
+
+// Incremental counterpart of IIndicator for live, bar-by-bar use:
+// each update() is O(1) and returns the value for the bar just appended.
+// Implementations replay the TA-Lib recurrences in the same operation order, so
+// feeding the bars of a series one by one gives exactly the batch results
+// (value k equals getResult()[k - getLookback()]), provided both are built with
+// the same floating-point settings (no -ffast-math / FMA contraction differences).
+class IStreamingIndicator {
+public:
+    virtual ~IStreamingIndicator() = default;
+
+    virtual std::string getName() const = 0;
+    virtual int getLookback() const = 0;
+
+    // Forget all history
+    virtual void reset() = 0;
+
+    // Append one bar; returns the latest value, or NaN while fewer than
+    // getLookback() + 1 bars have been seen
+    virtual double update(const core::Candle& candle) = 0;
+
+    virtual bool isReady() const = 0;
+    virtual double currentValue() const = 0; // NaN until ready
+
+    // Feed historical bars (e.g. at session start) before switching to live updates
+    virtual void warmUp(const core::CandleSeries& history) {
+        for (std::size_t i = 0; i < history.size(); ++i) update(history.at(i));
+    }
 };
 
 } // namespace indicators
\ No newline at end of file
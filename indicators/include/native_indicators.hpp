@@ -0,0 +1,134 @@
+#pragma once
+
+#include "indicators.hpp" // Base interface
+#include <string>
+#include <vector>
+
+namespace indicators {
+
+// Base of the indicators computed by the native kernels (indicator_kernels.hpp).
+// Holds one result vector per output; calculate() sizes them all to
+// input.size() - lookback and lets compute() fill them in a single pass.
+class NativeIndicator : public IIndicator {
+public:
+    std::string getName() const override { return name_; }
+    int getLookback() const override { return lookback_; }
+    void calculate(const core::CandleSeries& input) final;
+    const core::TimeSeries<double>& getResult() const override { return outputs_.front(); }
+    core::TimeSeries<double> releaseResult() override;
+
+    std::size_t getOutputCount() const override { return outputs_.size(); }
+    std::string getOutputName(std::size_t index) const override { return output_names_.at(index); }
+    const core::TimeSeries<double>& getOutput(std::size_t index) const override { return outputs_.at(index); }
+    core::TimeSeries<double> releaseOutput(std::size_t index) override;
+
+protected:
+    NativeIndicator(std::string name, int lookback, std::vector<std::string> output_names);
+
+    // Writes every output; each already holds input.size() - getLookback() elements
+    virtual void compute(const core::CandleSeries& input, std::vector<core::TimeSeries<double>>& outputs) = 0;
+
+private:
+    std::string name_;
+    int lookback_;
+    std::vector<std::string> output_names_; // Parallel to outputs_
+    std::vector<core::TimeSeries<double>> outputs_;
+};
+
+// EMA(period) of the close, seeded with the SMA of the first 'period' closes
+class EmaIndicator : public NativeIndicator {
+public:
+    explicit EmaIndicator(int period);
+protected:
+    void compute(const core::CandleSeries& input, std::vector<core::TimeSeries<double>>& outputs) override;
+private:
+    int period_;
+};
+
+// WMA(period) of the close
+class WmaIndicator : public NativeIndicator {
+public:
+    explicit WmaIndicator(int period);
+protected:
+    void compute(const core::CandleSeries& input, std::vector<core::TimeSeries<double>>& outputs) override;
+private:
+    int period_;
+};
+
+// BBANDS(period, deviations): outputs middle (SMA), upper, lower
+class BollingerBandsIndicator : public NativeIndicator {
+public:
+    BollingerBandsIndicator(int period, double deviations);
+protected:
+    void compute(const core::CandleSeries& input, std::vector<core::TimeSeries<double>>& outputs) override;
+private:
+    int period_;
+    double deviations_;
+};
+
+// MACD(fast, slow, signal): outputs macd, signal, hist. Both EMAs start at the
+// first bar of the slow window, as in TA_MACD.
+class MacdIndicator : public NativeIndicator {
+public:
+    MacdIndicator(int fast_period, int slow_period, int signal_period);
+protected:
+    void compute(const core::CandleSeries& input, std::vector<core::TimeSeries<double>>& outputs) override;
+private:
+    int fast_period_;
+    int slow_period_;
+    int signal_period_;
+};
+
+// ATR(period), Wilder smoothing
+class AtrIndicator : public NativeIndicator {
+public:
+    explicit AtrIndicator(int period);
+protected:
+    void compute(const core::CandleSeries& input, std::vector<core::TimeSeries<double>>& outputs) override;
+private:
+    int period_;
+};
+
+// SUPERTREND(period, multiplier): outputs value (the trailing band), direction
+// (+1 up / -1 down) and the ATR(period) it was built from
+class SupertrendIndicator : public NativeIndicator {
+public:
+    SupertrendIndicator(int period, double multiplier);
+protected:
+    void compute(const core::CandleSeries& input, std::vector<core::TimeSeries<double>>& outputs) override;
+private:
+    int period_;
+    double multiplier_;
+};
+
+// STOCH(k_period, k_smoothing, d_period): outputs k (slow %K) and d, SMA smoothed as TA_STOCH's defaults
+class StochasticIndicator : public NativeIndicator {
+public:
+    StochasticIndicator(int k_period, int k_smoothing, int d_period);
+protected:
+    void compute(const core::CandleSeries& input, std::vector<core::TimeSeries<double>>& outputs) override;
+private:
+    int k_period_;
+    int k_smoothing_;
+    int d_period_;
+};
+
+// VWAP: session (UTC day) anchored volume-weighted typical price
+class VwapIndicator : public NativeIndicator {
+public:
+    VwapIndicator();
+protected:
+    void compute(const core::CandleSeries& input, std::vector<core::TimeSeries<double>>& outputs) override;
+};
+
+// ADX(period): outputs adx, plus_di, minus_di (same recurrence as TA_ADX / TA_PLUS_DI / TA_MINUS_DI)
+class AdxIndicator : public NativeIndicator {
+public:
+    explicit AdxIndicator(int period);
+protected:
+    void compute(const core::CandleSeries& input, std::vector<core::TimeSeries<double>>& outputs) override;
+private:
+    int period_;
+};
+
+} // namespace indicators
@@ -1,13 +1,17 @@
 #pragma once
 
 #include "indicators.hpp" // Use short path
+#include <limits>
 #include <vector>
 #include <string>
 #include <stdexcept>
 
 namespace indicators {
 
-class RsiIndicator : public IIndicator {
+// Batch (IIndicator) and incremental (IStreamingIndicator) RSI.
+// The streaming state is the previous close and Wilder's smoothed average
+// gain/loss, updated with the same recurrence as TA-Lib's TA_RSI.
+class RsiIndicator : public IIndicator, public IStreamingIndicator {
 public:
     // Constructor: Requires the period for the RSI
     explicit RsiIndicator(int period);
@@ -17,14 +21,29 @@ public:
 
     std::string getName() const override;
     int getLookback() const override;
-    void calculate(const core::TimeSeries<core::Candle>& input) override;
+    void calculate(const core::CandleSeries& input) override;
     const core::TimeSeries<double>& getResult() const override;
+    core::TimeSeries<double> releaseResult() override;
+
+    // IStreamingIndicator
+    void reset() override;
+    double update(const core::Candle& candle) override;
+    bool isReady() const override { return ready_; }
+    double currentValue() const override { return current_value_; }
 
 private:
     const int period_;
     int lookback_;
     std::string name_;
     core::TimeSeries<double> results_;
+
+    // Streaming state
+    std::size_t seen_ = 0;     // Bars seen since reset()
+    double prev_value_ = 0.0;  // Previous close
+    double prev_gain_ = 0.0;   // Wilder average gain (sum during the initial period)
+    double prev_loss_ = 0.0;   // Wilder average loss (sum during the initial period)
+    double current_value_ = std::numeric_limits<double>::quiet_NaN();
+    bool ready_ = false;
 };
 
 } // namespace indicators
\ No newline at end of file
@@ -1,13 +1,17 @@
 #pragma once
 
 #include "indicators.hpp" // Base interface
+#include <limits>
 #include <vector>
 #include <string>
 #include <stdexcept> // For potential errors
 
 namespace indicators {
 
-class SmaIndicator : public IIndicator {
+// Batch (IIndicator) and incremental (IStreamingIndicator) SMA.
+// The streaming state is a ring buffer of the last 'period' closes plus the
+// running sum, updated in the same order as TA-Lib's TA_INT_SMA.
+class SmaIndicator : public IIndicator, public IStreamingIndicator {
 public:
     // Constructor: Requires the period for the SMA
     explicit SmaIndicator(int period);
@@ -17,14 +21,29 @@ public:
 
     std::string getName() const override;
     int getLookback() const override;
-    void calculate(const core::TimeSeries<core::Candle>& input) override;
+    void calculate(const core::CandleSeries& input) override;
     const core::TimeSeries<double>& getResult() const override;
+    core::TimeSeries<double> releaseResult() override;
+
+    // IStreamingIndicator
+    void reset() override;
+    double update(const core::Candle& candle) override;
+    bool isReady() const override { return ready_; }
+    double currentValue() const override { return current_value_; }
 
 private:
     const int period_;          // SMA period (e.g., 50, 200)
     int lookback_;              // Calculated TA-Lib lookback
     std::string name_;          // Indicator name (e.g., "SMA(50)")
     core::TimeSeries<double> results_; // Stores the calculated SMA values
+
+    // Streaming state
+    std::vector<double> window_;  // Last 'period' closes (ring buffer)
+    std::size_t head_ = 0;        // Next slot to overwrite == oldest value once full
+    std::size_t seen_ = 0;        // Bars seen since reset()
+    double period_total_ = 0.0;   // Running sum, as in TA-Lib
+    double current_value_ = std::numeric_limits<double>::quiet_NaN();
+    bool ready_ = false;
 };
 
 } // namespace indicators
\ No newline at end of file
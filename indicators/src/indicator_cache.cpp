@@ -0,0 +1,240 @@
+#include "indicator_cache.hpp"
+#include "logging.hpp"
+#include "utils.hpp"          // uniqueTempPath
+#include "spdlog/fmt/bundled/core.h" // Direct path for fmt safety
+
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <system_error>
+
+namespace indicators {
+
+    namespace { // File-local helpers
+
+        // On-disk layout (native endianness, the cache is machine-local):
+        //   char[4] magic "TPIC" | u32 version | u64 input fingerprint | u64 value count | double values[count]
+        constexpr char kFileMagic[4] = {'T', 'P', 'I', 'C'};
+        constexpr std::uint32_t kFileVersion = 1;
+
+        constexpr std::uint64_t kFnvOffset = 1469598103934665603ULL;
+        constexpr std::uint64_t kFnvPrime = 1099511628211ULL;
+
+        void fnvBytes(std::uint64_t& hash, const void* data, std::size_t size) {
+            const auto* bytes = static_cast<const unsigned char*>(data);
+            for (std::size_t i = 0; i < size; ++i) {
+                hash ^= bytes[i];
+                hash *= kFnvPrime;
+            }
+        }
+
+        template <typename T>
+        void fnvMix(std::uint64_t& hash, const T& value) {
+            fnvBytes(hash, &value, sizeof(T));
+        }
+
+        template <typename T>
+        void fnvColumn(std::uint64_t& hash, std::span<const T> column) {
+            fnvBytes(hash, column.data(), column.size_bytes());
+        }
+
+        std::uint64_t fnvString(const std::string& text) {
+            std::uint64_t hash = kFnvOffset;
+            for (char c : text) fnvMix(hash, c);
+            return hash;
+        }
+
+        // Keeps file names readable while staying filesystem-safe ("NSE_EQ|INE..." -> "NSE_EQ_INE...")
+        std::string sanitize(const std::string& text) {
+            std::string out;
+            out.reserve(text.size());
+            for (char c : text) {
+                out += (std::isalnum(static_cast<unsigned char>(c)) || c == '-') ? c : '_';
+            }
+            return out;
+        }
+
+        long long toEpochSeconds(core::Timestamp ts) {
+            return std::chrono::duration_cast<std::chrono::seconds>(ts.time_since_epoch()).count();
+        }
+
+    } // end anonymous namespace
+
+    IndicatorCache::IndicatorCache(std::string disk_directory)
+        : disk_directory_(std::move(disk_directory))
+    {
+        if (!disk_directory_.empty()) {
+            std::error_code ec;
+            std::filesystem::create_directories(disk_directory_, ec);
+            if (ec) {
+                core::logging::getLogger()->warn("Cannot create indicator cache directory '{}': {}. Disk tier disabled.",
+                                                 disk_directory_, ec.message());
+                disk_directory_.clear();
+            } else {
+                core::logging::getLogger()->debug("IndicatorCache disk tier at '{}'.", disk_directory_);
+            }
+        }
+    }
+
+    std::string IndicatorCache::defaultDirectoryFor(const std::string& db_path) {
+        return db_path + ".indicators";
+    }
+
+    std::uint64_t IndicatorCache::fingerprint(const core::CandleSeries& input) {
+        std::uint64_t hash = kFnvOffset;
+        fnvMix(hash, static_cast<std::uint64_t>(input.size()));
+        fnvColumn(hash, input.timestampsNs());
+        fnvColumn(hash, input.open());
+        fnvColumn(hash, input.high());
+        fnvColumn(hash, input.low());
+        fnvColumn(hash, input.close());
+        fnvColumn(hash, input.volume());
+        return hash;
+    }
+
+    IndicatorCache::ResultPtr IndicatorCache::getOrCompute(const std::string& instrument_key,
+                                                           const std::string& interval,
+                                                           core::Timestamp start_time,
+                                                           core::Timestamp end_time,
+                                                           const std::string& indicator_spec,
+                                                           const core::CandleSeries& input,
+                                                           const Compute& compute)
+    {
+        auto logger = core::logging::getLogger();
+        Key key{instrument_key, interval, start_time, end_time, indicator_spec};
+        std::promise<ResultPtr> promise;
+        std::shared_future<ResultPtr> future;
+        bool is_owner = false;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = entries_.find(key);
+            if (it != entries_.end()) {
+                future = it->second;
+            } else {
+                future = promise.get_future().share();
+                entries_.emplace(key, future);
+                is_owner = true;
+            }
+        }
+
+        if (!is_owner) {
+            logger->debug("IndicatorCache hit for {} on {} ({}).", indicator_spec, instrument_key, interval);
+            return future.get(); // Waits if another thread is still computing
+        }
+
+        // Compute (or read from disk) outside the lock so other keys are not blocked
+        try {
+            ResultPtr result;
+            if (!disk_directory_.empty()) {
+                std::uint64_t input_fingerprint = fingerprint(input);
+                std::string path = diskPath(key);
+                if (auto stored = loadFromDisk(path, input_fingerprint)) {
+                    logger->debug("IndicatorCache loaded {} from disk ({} values).", indicator_spec, stored->size());
+                    result = std::make_shared<const core::TimeSeries<double>>(std::move(*stored));
+                } else {
+                    result = std::make_shared<const core::TimeSeries<double>>(compute());
+                    storeToDisk(path, input_fingerprint, *result);
+                }
+            } else {
+                result = std::make_shared<const core::TimeSeries<double>>(compute());
+            }
+            promise.set_value(result);
+        } catch (...) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                entries_.erase(key); // Allow a later retry
+            }
+            promise.set_exception(std::current_exception());
+        }
+        return future.get();
+    }
+
+    std::size_t IndicatorCache::size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return entries_.size();
+    }
+
+    void IndicatorCache::clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.clear();
+    }
+
+    std::string IndicatorCache::diskPath(const Key& key) const {
+        const auto& [instrument, interval, start_time, end_time, spec] = key;
+        std::string readable = fmt::format("{}_{}_{}_{}_{}", instrument, interval,
+                                           toEpochSeconds(start_time), toEpochSeconds(end_time), spec);
+        // The hash of the unsanitized key keeps distinct keys from colliding after sanitize()
+        std::string file_name = fmt::format("{}_{:016x}.bin", sanitize(readable), fnvString(readable));
+        return (std::filesystem::path(disk_directory_) / file_name).string();
+    }
+
+    std::optional<core::TimeSeries<double>> IndicatorCache::loadFromDisk(const std::string& path,
+                                                                         std::uint64_t input_fingerprint) const
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in.is_open()) return std::nullopt;
+
+        char magic[4] = {};
+        std::uint32_t version = 0;
+        std::uint64_t stored_fingerprint = 0;
+        std::uint64_t count = 0;
+        in.read(magic, sizeof(magic));
+        in.read(reinterpret_cast<char*>(&version), sizeof(version));
+        in.read(reinterpret_cast<char*>(&stored_fingerprint), sizeof(stored_fingerprint));
+        in.read(reinterpret_cast<char*>(&count), sizeof(count));
+        if (!in || std::memcmp(magic, kFileMagic, sizeof(kFileMagic)) != 0 || version != kFileVersion) {
+            core::logging::getLogger()->warn("Ignoring unreadable indicator cache file: {}", path);
+            return std::nullopt;
+        }
+        if (stored_fingerprint != input_fingerprint) {
+            core::logging::getLogger()->debug("Indicator cache file is stale (input data changed): {}", path);
+            return std::nullopt;
+        }
+
+        core::TimeSeries<double> values(static_cast<std::size_t>(count));
+        in.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(count * sizeof(double)));
+        if (!in) {
+            core::logging::getLogger()->warn("Truncated indicator cache file: {}", path);
+            return std::nullopt;
+        }
+        return values;
+    }
+
+    void IndicatorCache::storeToDisk(const std::string& path, std::uint64_t input_fingerprint,
+                                     const core::TimeSeries<double>& values) const
+    {
+        // Write to a temporary file of our own and rename, so concurrent processes never
+        // read a partial file and never publish each other's half-written one
+        const std::string tmp_path = core::utils::uniqueTempPath(path);
+        std::error_code ec;
+        {
+            std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+            if (!out.is_open()) {
+                core::logging::getLogger()->warn("Cannot write indicator cache file: {}", tmp_path);
+                return;
+            }
+            std::uint64_t count = values.size();
+            out.write(kFileMagic, sizeof(kFileMagic));
+            out.write(reinterpret_cast<const char*>(&kFileVersion), sizeof(kFileVersion));
+            out.write(reinterpret_cast<const char*>(&input_fingerprint), sizeof(input_fingerprint));
+            out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+            out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(count * sizeof(double)));
+            out.close();
+            if (!out) {
+                core::logging::getLogger()->warn("Failed writing indicator cache file: {}", tmp_path);
+                std::filesystem::remove(tmp_path, ec);
+                return;
+            }
+        }
+        std::filesystem::rename(tmp_path, path, ec);
+        if (ec) {
+            core::logging::getLogger()->warn("Cannot finalize indicator cache file '{}': {}", path, ec.message());
+            std::filesystem::remove(tmp_path, ec);
+        }
+    }
+
+} // namespace indicators
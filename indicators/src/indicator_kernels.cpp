@@ -0,0 +1,180 @@
+#include "indicator_kernels.hpp"
+
+#include <cmath>
+#include <vector>
+
+namespace indicators::kernels {
+
+    namespace {
+        constexpr std::int64_t kNanosPerDay = 86'400'000'000'000LL;
+
+        // TA-Lib's TA_IS_ZERO_OR_NEG threshold
+        bool isZeroOrNegative(double value) { return value < 0.00000001; }
+
+        std::int64_t utcDay(std::int64_t timestamp_ns) {
+            const std::int64_t day = timestamp_ns / kNanosPerDay;
+            return (timestamp_ns % kNanosPerDay < 0) ? day - 1 : day; // Floor for pre-1970 bars
+        }
+
+        // Sliding extreme over 'period' values: 'better(a, b)' is true if a replaces b
+        template <typename Better>
+        void rollingExtreme(std::span<const double> in, int period, std::span<double> out, Better better) {
+            const std::size_t window = static_cast<std::size_t>(period);
+            // Candidate indices with strictly worse values behind them, as a ring of 'window' slots
+            std::vector<std::size_t> ring(window);
+            std::size_t head = 0;
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < in.size(); ++i) {
+                if (count > 0 && ring[head] + window <= i) { // Oldest candidate left the window
+                    head = (head + 1) % window;
+                    --count;
+                }
+                while (count > 0 && !better(in[ring[(head + count - 1) % window]], in[i])) --count;
+                ring[(head + count) % window] = i;
+                ++count;
+                if (i + 1 >= window) out[i + 1 - window] = in[ring[head]];
+            }
+        }
+    } // end anonymous namespace
+
+    void trueRange(std::span<const double> high, std::span<const double> low, std::span<const double> close,
+                   std::span<double> out)
+    {
+        if (high.empty()) return;
+        out[0] = high[0] - low[0];
+        for (std::size_t i = 1; i < high.size(); ++i) {
+            // Same comparisons as TA-Lib's TRUE_RANGE macro
+            double range = high[i] - low[i];
+            const double up = std::fabs(high[i] - close[i - 1]);
+            const double down = std::fabs(low[i] - close[i - 1]);
+            range = up > range ? up : range;
+            out[i] = down > range ? down : range;
+        }
+    }
+
+    void typicalPrice(std::span<const double> high, std::span<const double> low, std::span<const double> close,
+                      std::span<double> out)
+    {
+        for (std::size_t i = 0; i < high.size(); ++i) out[i] = (high[i] + low[i] + close[i]) / 3.0;
+    }
+
+    void sma(std::span<const double> in, int period, std::span<double> out) {
+        const std::size_t window = static_cast<std::size_t>(period);
+        if (in.size() < window) return;
+        double total = 0.0;
+        for (std::size_t i = 0; i + 1 < window; ++i) total += in[i];
+        for (std::size_t i = window - 1, k = 0; i < in.size(); ++i, ++k) {
+            total += in[i];
+            out[k] = total / period;
+            total -= in[k];
+        }
+    }
+
+    void ema(std::span<const double> in, int period, std::span<double> out) {
+        const std::size_t window = static_cast<std::size_t>(period);
+        if (in.size() < window) return;
+        const double k = 2.0 / (period + 1);
+        double total = 0.0;
+        for (std::size_t i = 0; i < window; ++i) total += in[i];
+        double value = total / period;
+        out[0] = value;
+        for (std::size_t i = window, o = 1; i < in.size(); ++i, ++o) {
+            value = ((in[i] - value) * k) + value;
+            out[o] = value;
+        }
+    }
+
+    void wma(std::span<const double> in, int period, std::span<double> out) {
+        const std::size_t window = static_cast<std::size_t>(period);
+        if (in.size() < window) return;
+        // Running plain sum and weighted sum: adding the new value with weight 'period'
+        // and subtracting the plain sum shifts every older weight down by one
+        const double divider = static_cast<double>(period) * (period + 1) / 2.0;
+        double plain = 0.0;
+        double weighted = 0.0;
+        for (std::size_t i = 0; i + 1 < window; ++i) {
+            plain += in[i];
+            weighted += in[i] * static_cast<double>(i + 1);
+        }
+        double trailing = 0.0;
+        for (std::size_t i = window - 1, k = 0; i < in.size(); ++i, ++k) {
+            plain += in[i];
+            plain -= trailing;
+            weighted += in[i] * period;
+            trailing = in[k];
+            out[k] = weighted / divider;
+            weighted -= plain;
+        }
+    }
+
+    void meanStdDev(std::span<const double> in, int period, std::span<double> mean, std::span<double> stddev) {
+        const std::size_t window = static_cast<std::size_t>(period);
+        if (in.size() < window) return;
+        double total = 0.0;
+        double total_squares = 0.0;
+        for (std::size_t i = 0; i + 1 < window; ++i) {
+            total += in[i];
+            total_squares += in[i] * in[i];
+        }
+        for (std::size_t i = window - 1, k = 0; i < in.size(); ++i, ++k) {
+            total += in[i];
+            total_squares += in[i] * in[i];
+            const double average = total / period;
+            const double variance = total_squares / period - average * average;
+            mean[k] = average;
+            stddev[k] = isZeroOrNegative(variance) ? 0.0 : std::sqrt(variance);
+            total -= in[k];
+            total_squares -= in[k] * in[k];
+        }
+    }
+
+    void rollingMax(std::span<const double> in, int period, std::span<double> out) {
+        rollingExtreme(in, period, out, [](double a, double b) { return a > b; });
+    }
+
+    void rollingMin(std::span<const double> in, int period, std::span<double> out) {
+        rollingExtreme(in, period, out, [](double a, double b) { return a < b; });
+    }
+
+    void atr(std::span<const double> high, std::span<const double> low, std::span<const double> close,
+             int period, std::span<double> out)
+    {
+        const std::size_t window = static_cast<std::size_t>(period);
+        if (high.size() <= window) return;
+        std::vector<double> ranges(high.size());
+        trueRange(high, low, close, ranges);
+
+        double total = 0.0;
+        for (std::size_t i = 1; i <= window; ++i) total += ranges[i];
+        double value = total / period;
+        out[0] = value;
+        for (std::size_t i = window + 1, k = 1; i < high.size(); ++i, ++k) {
+            value *= period - 1;
+            value += ranges[i];
+            value /= period;
+            out[k] = value;
+        }
+    }
+
+    void sessionVwap(std::span<const std::int64_t> timestamps_ns, std::span<const double> high,
+                     std::span<const double> low, std::span<const double> close, std::span<const double> volume,
+                     std::span<double> out)
+    {
+        typicalPrice(high, low, close, out); // Overwritten in place below
+        double price_volume = 0.0;
+        double total_volume = 0.0;
+        std::int64_t session = 0;
+        for (std::size_t i = 0; i < out.size(); ++i) {
+            const std::int64_t day = utcDay(timestamps_ns[i]);
+            if (i == 0 || day != session) {
+                session = day;
+                price_volume = 0.0;
+                total_volume = 0.0;
+            }
+            price_volume += out[i] * volume[i];
+            total_volume += volume[i];
+            if (total_volume > 0.0) out[i] = price_volume / total_volume;
+        }
+    }
+
+} // namespace indicators::kernels
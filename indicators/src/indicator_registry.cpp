@@ -0,0 +1,192 @@
+#include "indicator_registry.hpp"
+#include "sma_indicator.hpp"
+#include "rsi_indicator.hpp"
+#include "native_indicators.hpp"
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <mutex>
+#include <stdexcept>
+#include "spdlog/fmt/bundled/core.h" // Direct path for fmt safety
+
+namespace indicators {
+
+namespace {
+    bool isSpace(char c) { return c == ' ' || c == '\t'; }
+    bool isTypeStart(char c) { return std::isalpha(static_cast<unsigned char>(c)) != 0; }
+    bool isTypeChar(char c) { return std::isalnum(static_cast<unsigned char>(c)) != 0 || c == '_'; }
+
+    std::string upper(std::string_view text) {
+        std::string out(text);
+        for (char& c : out) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        return out;
+    }
+
+    [[noreturn]] void fail(std::string_view text, std::size_t pos, const char* what) {
+        throw std::invalid_argument(fmt::format("Invalid indicator spec '{}': {} at position {}.", text, what, pos));
+    }
+
+    IndicatorRegistry::Entry entry(std::size_t required_args, std::vector<double> defaults, IndicatorRegistry::Factory factory) {
+        return {required_args, std::move(defaults), std::move(factory)};
+    }
+
+    void registerBuiltins(IndicatorRegistry& registry) {
+        using R = IndicatorRegistry;
+        registry.add("SMA", entry(1, {}, [](const auto& a) {
+            return std::make_unique<SmaIndicator>(R::periodArgument(a[0], "SMA period"));
+        }));
+        registry.add("RSI", entry(1, {}, [](const auto& a) {
+            return std::make_unique<RsiIndicator>(R::periodArgument(a[0], "RSI period"));
+        }));
+        registry.add("EMA", entry(1, {}, [](const auto& a) {
+            return std::make_unique<EmaIndicator>(R::periodArgument(a[0], "EMA period"));
+        }));
+        registry.add("WMA", entry(1, {}, [](const auto& a) {
+            return std::make_unique<WmaIndicator>(R::periodArgument(a[0], "WMA period"));
+        }));
+        registry.add("BBANDS", entry(1, {2.0}, [](const auto& a) {
+            return std::make_unique<BollingerBandsIndicator>(R::periodArgument(a[0], "BBANDS period"), a[1]);
+        }));
+        registry.add("MACD", entry(0, {12, 26, 9}, [](const auto& a) {
+            return std::make_unique<MacdIndicator>(R::periodArgument(a[0], "MACD fast period"),
+                                                   R::periodArgument(a[1], "MACD slow period"),
+                                                   R::periodArgument(a[2], "MACD signal period"));
+        }));
+        registry.add("ATR", entry(1, {}, [](const auto& a) {
+            return std::make_unique<AtrIndicator>(R::periodArgument(a[0], "ATR period"));
+        }));
+        registry.add("SUPERTREND", entry(0, {10, 3.0}, [](const auto& a) {
+            return std::make_unique<SupertrendIndicator>(R::periodArgument(a[0], "SUPERTREND period"), a[1]);
+        }));
+        registry.add("STOCH", entry(0, {5, 3, 3}, [](const auto& a) {
+            return std::make_unique<StochasticIndicator>(R::periodArgument(a[0], "STOCH %K period"),
+                                                         R::periodArgument(a[1], "STOCH %K smoothing"),
+                                                         R::periodArgument(a[2], "STOCH %D period"));
+        }));
+        registry.add("VWAP", entry(0, {}, [](const auto&) { return std::make_unique<VwapIndicator>(); }));
+        registry.add("ADX", entry(1, {}, [](const auto& a) {
+            return std::make_unique<AdxIndicator>(R::periodArgument(a[0], "ADX period"));
+        }));
+    }
+} // end anonymous namespace
+
+// --- IndicatorSpec ---
+
+std::string IndicatorSpec::toString() const {
+    if (args.empty()) return type;
+    std::string out = type;
+    for (std::size_t i = 0; i < args.size(); ++i) out += fmt::format("{}{}", i == 0 ? '(' : ',', args[i]);
+    return out + ')';
+}
+
+IndicatorSpec parseIndicatorSpec(std::string_view text) {
+    std::size_t pos = 0;
+    auto skipSpaces = [&]() { while (pos < text.size() && isSpace(text[pos])) ++pos; };
+
+    skipSpaces();
+    if (pos == text.size() || !isTypeStart(text[pos])) fail(text, pos, "expected an indicator name");
+    const std::size_t type_start = pos;
+    while (pos < text.size() && isTypeChar(text[pos])) ++pos;
+
+    IndicatorSpec spec;
+    spec.type = upper(text.substr(type_start, pos - type_start));
+    skipSpaces();
+    if (pos < text.size() && text[pos] == '(') {
+        ++pos;
+        skipSpaces();
+        if (pos < text.size() && text[pos] == ')') {
+            ++pos; // "TYPE()" == "TYPE"
+        } else {
+            for (;;) {
+                skipSpaces();
+                double value = 0.0;
+                const auto [end, error] = std::from_chars(text.data() + pos, text.data() + text.size(), value);
+                if (error != std::errc() || !std::isfinite(value)) fail(text, pos, "expected a number");
+                pos = static_cast<std::size_t>(end - text.data());
+                spec.args.push_back(value);
+                skipSpaces();
+                if (pos < text.size() && text[pos] == ',') {
+                    ++pos;
+                    continue;
+                }
+                if (pos < text.size() && text[pos] == ')') {
+                    ++pos;
+                    break;
+                }
+                fail(text, pos, "expected ',' or ')'");
+            }
+        }
+        skipSpaces();
+    }
+    if (pos != text.size()) fail(text, pos, "unexpected character");
+    return spec;
+}
+
+// --- IndicatorRegistry ---
+
+IndicatorRegistry& IndicatorRegistry::instance() {
+    static IndicatorRegistry registry;
+    static std::once_flag built_ins;
+    std::call_once(built_ins, []() { registerBuiltins(registry); });
+    return registry;
+}
+
+void IndicatorRegistry::add(const std::string& type, Entry entry) {
+    if (!entry.factory) throw std::invalid_argument("Indicator factory for '" + type + "' is empty.");
+    const IndicatorSpec parsed = parseIndicatorSpec(type); // Same name rules (and case) as specs
+    if (!parsed.args.empty()) throw std::invalid_argument("Indicator type '" + type + "' must not have arguments.");
+    std::unique_lock lock(mutex_);
+    entries_.insert_or_assign(parsed.type, std::move(entry));
+}
+
+bool IndicatorRegistry::contains(std::string_view type) const {
+    const std::string key = upper(type);
+    std::shared_lock lock(mutex_);
+    return entries_.find(key) != entries_.end();
+}
+
+std::vector<std::string> IndicatorRegistry::types() const {
+    std::shared_lock lock(mutex_);
+    std::vector<std::string> out;
+    out.reserve(entries_.size());
+    for (const auto& [type, entry] : entries_) out.push_back(type);
+    return out;
+}
+
+IndicatorSpec IndicatorRegistry::resolve(std::string_view text) const {
+    IndicatorSpec spec = parseIndicatorSpec(text);
+    std::shared_lock lock(mutex_);
+    auto it = entries_.find(spec.type);
+    if (it == entries_.end()) throw std::invalid_argument(fmt::format("Unknown indicator type '{}'.", spec.type));
+
+    const Entry& entry = it->second;
+    const std::size_t max_args = entry.required_args + entry.defaults.size();
+    if (spec.args.size() < entry.required_args || spec.args.size() > max_args) {
+        const std::string expected = (max_args == entry.required_args)
+            ? fmt::format("{}", max_args)
+            : fmt::format("{} to {}", entry.required_args, max_args);
+        throw std::invalid_argument(fmt::format("{} takes {} arguments, got {} in '{}'.",
+                                                spec.type, expected, spec.args.size(), text));
+    }
+    for (std::size_t i = spec.args.size(); i < max_args; ++i) spec.args.push_back(entry.defaults[i - entry.required_args]);
+    return spec;
+}
+
+std::unique_ptr<IIndicator> IndicatorRegistry::create(std::string_view text) const {
+    const IndicatorSpec spec = resolve(text);
+    Factory factory;
+    {
+        std::shared_lock lock(mutex_);
+        factory = entries_.find(spec.type)->second.factory; // Copied so add() may run meanwhile
+    }
+    return factory(spec.args);
+}
+
+int IndicatorRegistry::periodArgument(double value, const char* what) {
+    if (!(value >= 1.0 && value <= 1e6) || value != std::floor(value)) {
+        throw std::invalid_argument(fmt::format("{} must be a whole number between 1 and 1000000, got {}.", what, value));
+    }
+    return static_cast<int>(value);
+}
+
+} // namespace indicators
@@ -0,0 +1,334 @@
+#include "native_indicators.hpp"
+#include "indicator_kernels.hpp"
+#include "logging.hpp"
+#include <cmath>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include "spdlog/fmt/bundled/core.h" // Direct path for fmt safety
+
+namespace indicators {
+
+namespace {
+    // TA-Lib's TA_IS_ZERO threshold
+    bool isZero(double value) { return -0.00000001 < value && value < 0.00000001; }
+
+    int requirePositive(int value, const char* what) {
+        if (value <= 0) throw std::invalid_argument(fmt::format("{} must be positive.", what));
+        return value;
+    }
+
+    double requireNonNegative(double value, const char* what) {
+        if (!(value >= 0.0)) throw std::invalid_argument(fmt::format("{} must not be negative.", what));
+        return value;
+    }
+} // end anonymous namespace
+
+// --- NativeIndicator ---
+
+NativeIndicator::NativeIndicator(std::string name, int lookback, std::vector<std::string> output_names)
+    : name_(std::move(name)), lookback_(lookback), output_names_(std::move(output_names)),
+      outputs_(output_names_.size())
+{
+    core::logging::getLogger()->debug("{} created: Lookback={}, Outputs={}", name_, lookback_, outputs_.size());
+}
+
+void NativeIndicator::calculate(const core::CandleSeries& input) {
+    auto logger = core::logging::getLogger();
+    logger->trace("Calculating {}...", name_);
+    for (auto& output : outputs_) output.clear();
+
+    if (input.size() <= static_cast<std::size_t>(lookback_)) {
+        logger->debug("Input size ({}) is less than or equal to lookback ({}) for {}. No results generated.",
+                      input.size(), lookback_, name_);
+        return;
+    }
+    const std::size_t output_size = input.size() - static_cast<std::size_t>(lookback_);
+    for (auto& output : outputs_) output.resize(output_size);
+    compute(input, outputs_);
+    logger->trace("Successfully calculated {} results for {}", output_size, name_);
+}
+
+core::TimeSeries<double> NativeIndicator::releaseResult() {
+    return std::exchange(outputs_.front(), {});
+}
+
+core::TimeSeries<double> NativeIndicator::releaseOutput(std::size_t index) {
+    return std::exchange(outputs_.at(index), {});
+}
+
+// --- EMA / WMA ---
+
+EmaIndicator::EmaIndicator(int period)
+    : NativeIndicator(fmt::format("EMA({})", period), requirePositive(period, "EMA period") - 1, {""}),
+      period_(period) {}
+
+void EmaIndicator::compute(const core::CandleSeries& input, std::vector<core::TimeSeries<double>>& outputs) {
+    kernels::ema(input.close(), period_, outputs[0]);
+}
+
+WmaIndicator::WmaIndicator(int period)
+    : NativeIndicator(fmt::format("WMA({})", period), requirePositive(period, "WMA period") - 1, {""}),
+      period_(period) {}
+
+void WmaIndicator::compute(const core::CandleSeries& input, std::vector<core::TimeSeries<double>>& outputs) {
+    kernels::wma(input.close(), period_, outputs[0]);
+}
+
+// --- Bollinger Bands ---
+
+BollingerBandsIndicator::BollingerBandsIndicator(int period, double deviations)
+    : NativeIndicator(fmt::format("BBANDS({},{})", period, deviations),
+                      requirePositive(period, "BBANDS period") - 1, {"middle", "upper", "lower"}),
+      period_(period), deviations_(requireNonNegative(deviations, "BBANDS deviations")) {}
+
+void BollingerBandsIndicator::compute(const core::CandleSeries& input, std::vector<core::TimeSeries<double>>& outputs) {
+    auto& middle = outputs[0];
+    auto& upper = outputs[1];
+    auto& lower = outputs[2];
+    kernels::meanStdDev(input.close(), period_, middle, upper); // Standard deviation parked in 'upper'
+    for (std::size_t k = 0; k < middle.size(); ++k) {
+        const double offset = deviations_ * upper[k];
+        upper[k] = middle[k] + offset;
+        lower[k] = middle[k] - offset;
+    }
+}
+
+// --- MACD ---
+
+MacdIndicator::MacdIndicator(int fast_period, int slow_period, int signal_period)
+    : NativeIndicator(fmt::format("MACD({},{},{})", fast_period, slow_period, signal_period),
+                      (requirePositive(slow_period, "MACD slow period") - 1) +
+                          (requirePositive(signal_period, "MACD signal period") - 1),
+                      {"macd", "signal", "hist"}),
+      fast_period_(requirePositive(fast_period, "MACD fast period")), slow_period_(slow_period),
+      signal_period_(signal_period)
+{
+    if (fast_period_ >= slow_period_) {
+        throw std::invalid_argument("MACD fast period must be shorter than the slow period.");
+    }
+}
+
+void MacdIndicator::compute(const core::CandleSeries& input, std::vector<core::TimeSeries<double>>& outputs) {
+    // One pass: both EMAs, the MACD line and its signal EMA advance together, so the
+    // MACD line is never materialized in full.
+    const auto close = input.close();
+    auto& macd = outputs[0];
+    auto& signal = outputs[1];
+    auto& hist = outputs[2];
+    const std::size_t slow = static_cast<std::size_t>(slow_period_);
+    const std::size_t fast = static_cast<std::size_t>(fast_period_);
+    const std::size_t signal_window = static_cast<std::size_t>(signal_period_);
+    const double fast_k = 2.0 / (fast_period_ + 1);
+    const double slow_k = 2.0 / (slow_period_ + 1);
+    const double signal_k = 2.0 / (signal_period_ + 1);
+
+    // Both EMAs are seeded with an SMA ending at the last bar of the first slow window
+    double slow_total = 0.0;
+    for (std::size_t i = 0; i < slow; ++i) slow_total += close[i];
+    double fast_total = 0.0;
+    for (std::size_t i = slow - fast; i < slow; ++i) fast_total += close[i];
+    double slow_ema = slow_total / slow_period_;
+    double fast_ema = fast_total / fast_period_;
+
+    double signal_total = 0.0;
+    double signal_ema = 0.0;
+    for (std::size_t i = slow - 1, line = 0; i < close.size(); ++i, ++line) {
+        if (i >= slow) {
+            fast_ema = ((close[i] - fast_ema) * fast_k) + fast_ema;
+            slow_ema = ((close[i] - slow_ema) * slow_k) + slow_ema;
+        }
+        const double value = fast_ema - slow_ema;
+        if (line + 1 < signal_window) {
+            signal_total += value;
+            continue;
+        }
+        if (line + 1 == signal_window) {
+            signal_ema = (signal_total + value) / signal_period_;
+        } else {
+            signal_ema = ((value - signal_ema) * signal_k) + signal_ema;
+        }
+        const std::size_t k = line + 1 - signal_window;
+        macd[k] = value;
+        signal[k] = signal_ema;
+        hist[k] = value - signal_ema;
+    }
+}
+
+// --- ATR / Supertrend ---
+
+AtrIndicator::AtrIndicator(int period)
+    : NativeIndicator(fmt::format("ATR({})", period), requirePositive(period, "ATR period"), {""}),
+      period_(period) {}
+
+void AtrIndicator::compute(const core::CandleSeries& input, std::vector<core::TimeSeries<double>>& outputs) {
+    kernels::atr(input.high(), input.low(), input.close(), period_, outputs[0]);
+}
+
+SupertrendIndicator::SupertrendIndicator(int period, double multiplier)
+    : NativeIndicator(fmt::format("SUPERTREND({},{})", period, multiplier),
+                      requirePositive(period, "SUPERTREND period"), {"value", "direction", "atr"}),
+      period_(period), multiplier_(requireNonNegative(multiplier, "SUPERTREND multiplier")) {}
+
+void SupertrendIndicator::compute(const core::CandleSeries& input, std::vector<core::TimeSeries<double>>& outputs) {
+    const auto high = input.high();
+    const auto low = input.low();
+    const auto close = input.close();
+    auto& value = outputs[0];
+    auto& direction = outputs[1];
+    auto& atr = outputs[2];
+    kernels::atr(high, low, close, period_, atr);
+
+    // Each band only moves toward the price until the close crosses it; the trend
+    // flips when the close crosses the band it is trailing
+    const std::size_t offset = static_cast<std::size_t>(period_);
+    double upper = 0.0;
+    double lower = 0.0;
+    double trend = 1.0;
+    for (std::size_t k = 0; k < atr.size(); ++k) {
+        const std::size_t i = k + offset;
+        const double mid = (high[i] + low[i]) / 2.0;
+        const double basic_upper = mid + multiplier_ * atr[k];
+        const double basic_lower = mid - multiplier_ * atr[k];
+        if (k == 0) {
+            upper = basic_upper;
+            lower = basic_lower;
+            trend = close[i] >= mid ? 1.0 : -1.0;
+        } else {
+            const double prev_close = close[i - 1];
+            upper = (basic_upper < upper || prev_close > upper) ? basic_upper : upper;
+            lower = (basic_lower > lower || prev_close < lower) ? basic_lower : lower;
+            if (trend < 0.0) trend = close[i] > upper ? 1.0 : -1.0;
+            else trend = close[i] < lower ? -1.0 : 1.0;
+        }
+        value[k] = trend > 0.0 ? lower : upper;
+        direction[k] = trend;
+    }
+}
+
+// --- Stochastic ---
+
+StochasticIndicator::StochasticIndicator(int k_period, int k_smoothing, int d_period)
+    : NativeIndicator(fmt::format("STOCH({},{},{})", k_period, k_smoothing, d_period),
+                      (requirePositive(k_period, "STOCH %K period") - 1) +
+                          (requirePositive(k_smoothing, "STOCH %K smoothing") - 1) +
+                          (requirePositive(d_period, "STOCH %D period") - 1),
+                      {"k", "d"}),
+      k_period_(k_period), k_smoothing_(k_smoothing), d_period_(d_period) {}
+
+void StochasticIndicator::compute(const core::CandleSeries& input, std::vector<core::TimeSeries<double>>& outputs) {
+    const auto close = input.close();
+    const std::size_t raw_size = input.size() - static_cast<std::size_t>(k_period_ - 1);
+    std::vector<double> highest(raw_size);
+    std::vector<double> lowest(raw_size);
+    kernels::rollingMax(input.high(), k_period_, highest);
+    kernels::rollingMin(input.low(), k_period_, lowest);
+
+    std::vector<double> fast_k(raw_size);
+    for (std::size_t k = 0; k < raw_size; ++k) {
+        const double range = (highest[k] - lowest[k]) / 100.0;
+        fast_k[k] = range != 0.0 ? (close[k + k_period_ - 1] - lowest[k]) / range : 0.0;
+    }
+
+    std::vector<double> slow_k(raw_size - static_cast<std::size_t>(k_smoothing_ - 1));
+    kernels::sma(fast_k, k_smoothing_, slow_k);
+    kernels::sma(slow_k, d_period_, outputs[1]);
+    const std::size_t skip = static_cast<std::size_t>(d_period_ - 1);
+    for (std::size_t k = 0; k < outputs[0].size(); ++k) outputs[0][k] = slow_k[k + skip];
+}
+
+// --- VWAP ---
+
+VwapIndicator::VwapIndicator() : NativeIndicator("VWAP", 0, {""}) {}
+
+void VwapIndicator::compute(const core::CandleSeries& input, std::vector<core::TimeSeries<double>>& outputs) {
+    kernels::sessionVwap(input.timestampsNs(), input.high(), input.low(), input.close(), input.volume(), outputs[0]);
+}
+
+// --- ADX ---
+
+AdxIndicator::AdxIndicator(int period)
+    : NativeIndicator(fmt::format("ADX({})", period), 2 * requirePositive(period, "ADX period") - 1,
+                      {"adx", "plus_di", "minus_di"}),
+      period_(period) {}
+
+void AdxIndicator::compute(const core::CandleSeries& input, std::vector<core::TimeSeries<double>>& outputs) {
+    // Same sequence as TA_ADX: Wilder-smoothed +DM, -DM and true range, DX averaged
+    // over the first 'period' values, then smoothed into ADX
+    const auto high = input.high();
+    const auto low = input.low();
+    const auto close = input.close();
+    auto& adx = outputs[0];
+    auto& plus_di_out = outputs[1];
+    auto& minus_di_out = outputs[2];
+    const double period = period_;
+
+    double prev_high = high[0];
+    double prev_low = low[0];
+    double prev_close = close[0];
+    double plus_dm = 0.0;
+    double minus_dm = 0.0;
+    double true_range = 0.0;
+    double plus_di = 0.0;
+    double minus_di = 0.0;
+
+    // Advances one bar; 'smooth' applies Wilder decay before adding the new values
+    auto step = [&](std::size_t today, bool smooth) {
+        const double diff_plus = high[today] - prev_high;
+        const double diff_minus = prev_low - low[today];
+        prev_high = high[today];
+        prev_low = low[today];
+        if (smooth) {
+            minus_dm -= minus_dm / period;
+            plus_dm -= plus_dm / period;
+        }
+        if (diff_minus > 0 && diff_plus < diff_minus) minus_dm += diff_minus;
+        else if (diff_plus > 0 && diff_plus > diff_minus) plus_dm += diff_plus;
+
+        double range = prev_high - prev_low;
+        const double up = std::fabs(prev_high - prev_close);
+        const double down = std::fabs(prev_low - prev_close);
+        range = up > range ? up : range;
+        range = down > range ? down : range;
+        true_range = smooth ? true_range - (true_range / period) + range : true_range + range;
+        prev_close = close[today];
+    };
+    // DX of the current smoothed values; false if it is undefined
+    auto directional = [&](double& dx) {
+        if (isZero(true_range)) {
+            plus_di = minus_di = 0.0;
+            return false;
+        }
+        minus_di = 100.0 * (minus_dm / true_range);
+        plus_di = 100.0 * (plus_dm / true_range);
+        const double total = minus_di + plus_di;
+        if (isZero(total)) return false;
+        dx = 100.0 * (std::fabs(minus_di - plus_di) / total);
+        return true;
+    };
+
+    std::size_t today = 0;
+    for (int i = period_ - 1; i > 0; --i) step(++today, false);
+
+    double dx_total = 0.0;
+    for (int i = period_; i > 0; --i) {
+        step(++today, true);
+        double dx = 0.0;
+        if (directional(dx)) dx_total += dx;
+    }
+    double value = dx_total / period;
+    adx[0] = value;
+    plus_di_out[0] = plus_di;
+    minus_di_out[0] = minus_di;
+
+    for (std::size_t k = 1; k < adx.size(); ++k) {
+        step(++today, true);
+        double dx = 0.0;
+        if (directional(dx)) value = ((value * (period - 1)) + dx) / period;
+        adx[k] = value;
+        plus_di_out[k] = plus_di;
+        minus_di_out[k] = minus_di;
+    }
+}
+
+} // namespace indicators
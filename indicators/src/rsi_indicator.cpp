@@ -3,6 +3,9 @@
 #include "logging.hpp"     // Use short path
 #include "ta_libc.h"  // TA-Lib C API header
 #include <vector>
+#include <span>
+#include <utility>
+#include <limits>
 #include <stdexcept>
 #include "spdlog/fmt/bundled/core.h" // Direct path for fmt safety
 
@@ -21,6 +24,7 @@ RsiIndicator::RsiIndicator(int period) : period_(period), lookback_(0) {
 
     name_ = fmt::format("RSI({})", period_);
     results_.clear();
+    reset();
     core::logging::getLogger()->debug("RsiIndicator created: Name='{}', Period={}, Lookback={}", name_, period_, lookback_);
 }
 
@@ -36,7 +40,11 @@ const core::TimeSeries<double>& RsiIndicator::getResult() const {
     return results_;
 }
 
-void RsiIndicator::calculate(const core::TimeSeries<core::Candle>& input) {
+core::TimeSeries<double> RsiIndicator::releaseResult() {
+    return std::exchange(results_, {});
+}
+
+void RsiIndicator::calculate(const core::CandleSeries& input) {
     auto logger = core::logging::getLogger();
     logger->trace("Calculating {}...", name_);
     results_.clear();
@@ -48,12 +56,8 @@ void RsiIndicator::calculate(const core::TimeSeries<core::Candle>& input) {
         return;
     }
 
-    // Prepare input array (closing prices)
-    std::vector<double> close_prices;
-    close_prices.reserve(input.size());
-    for (const auto& candle : input) {
-        close_prices.push_back(candle.close);
-    }
+    // Closing prices are already contiguous in the series, TA-Lib reads them in place
+    std::span<const double> close_prices = input.close();
 
     // Prepare output array
     int output_size = static_cast<int>(close_prices.size()) - lookback_;
@@ -99,4 +103,62 @@ void RsiIndicator::calculate(const core::TimeSeries<core::Candle>& input) {
     logger->trace("Successfully calculated {} results for {}", results_.size(), name_);
 }
 
+// --- Streaming ---
+
+namespace {
+    // TA-Lib's TA_IS_ZERO threshold
+    bool isZero(double value) { return -0.00000001 < value && value < 0.00000001; }
+
+    double rsiFromAverages(double avg_gain, double avg_loss) {
+        const double total = avg_gain + avg_loss;
+        return isZero(total) ? 0.0 : 100.0 * (avg_gain / total);
+    }
+} // end anonymous namespace
+
+void RsiIndicator::reset() {
+    seen_ = 0;
+    prev_value_ = 0.0;
+    prev_gain_ = 0.0;
+    prev_loss_ = 0.0;
+    current_value_ = std::numeric_limits<double>::quiet_NaN();
+    ready_ = false;
+}
+
+double RsiIndicator::update(const core::Candle& candle) {
+    // Mirrors TA_RSI (default compatibility): plain sums of gains/losses over the
+    // first 'period' changes, divided by period, then Wilder smoothing.
+    const double value = candle.close;
+    const std::size_t period = static_cast<std::size_t>(period_);
+    ++seen_;
+    if (seen_ == 1) {
+        prev_value_ = value;
+        return current_value_; // Still NaN
+    }
+
+    const double change = value - prev_value_;
+    prev_value_ = value;
+
+    if (seen_ <= period + 1) {
+        if (change < 0) prev_loss_ -= change;
+        else prev_gain_ += change;
+        if (seen_ < period + 1) {
+            return current_value_; // Still NaN
+        }
+        prev_loss_ /= period_;
+        prev_gain_ /= period_;
+    } else {
+        prev_loss_ *= (period_ - 1);
+        prev_gain_ *= (period_ - 1);
+        if (change < 0) prev_loss_ -= change;
+        else prev_gain_ += change;
+        prev_loss_ /= period_;
+        prev_gain_ /= period_;
+    }
+
+    // With a TA-Lib unstable period the batch output starts later; stay NaN until then
+    ready_ = seen_ > static_cast<std::size_t>(lookback_);
+    current_value_ = ready_ ? rsiFromAverages(prev_gain_, prev_loss_) : std::numeric_limits<double>::quiet_NaN();
+    return current_value_;
+}
+
 } // namespace indicators
\ No newline at end of file
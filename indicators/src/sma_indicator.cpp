@@ -3,6 +3,9 @@
 #include "logging.hpp"    // For logging errors
 #include "ta_libc.h"            // Include TA-Lib C API header
 #include <vector>
+#include <span>
+#include <utility>
+#include <limits>
 #include <stdexcept>                   // For std::runtime_error
 #include <spdlog/spdlog.h>                 // For formatting error messages
 
@@ -22,6 +25,7 @@ SmaIndicator::SmaIndicator(int period) : period_(period), lookback_(0) {
 
     name_ = fmt::format("SMA({})", period_);
     results_.clear(); // Ensure results are initially empty
+    reset();
      core::logging::getLogger()->debug("SmaIndicator created: Name='{}', Period={}, Lookback={}", name_, period_, lookback_);
 }
 
@@ -37,7 +41,11 @@ const core::TimeSeries<double>& SmaIndicator::getResult() const {
     return results_;
 }
 
-void SmaIndicator::calculate(const core::TimeSeries<core::Candle>& input) {
+core::TimeSeries<double> SmaIndicator::releaseResult() {
+    return std::exchange(results_, {});
+}
+
+void SmaIndicator::calculate(const core::CandleSeries& input) {
     auto logger = core::logging::getLogger();
     logger->trace("Calculating {}...", name_);
     results_.clear(); // Clear previous results
@@ -49,12 +57,8 @@ void SmaIndicator::calculate(const core::TimeSeries<core::Candle>& input) {
         return; // Not enough data to calculate anything
     }
 
-    // Prepare input array (closing prices) for TA-Lib
-    std::vector<double> close_prices;
-    close_prices.reserve(input.size());
-    for (const auto& candle : input) {
-        close_prices.push_back(candle.close);
-    }
+    // Closing prices are already contiguous in the series, TA-Lib reads them in place
+    std::span<const double> close_prices = input.close();
 
     // Prepare output array
     // TA-Lib output size = input size - lookback
@@ -106,4 +110,33 @@ void SmaIndicator::calculate(const core::TimeSeries<core::Candle>& input) {
     logger->trace("Successfully calculated {} results for {}", results_.size(), name_);
 }
 
+// --- Streaming ---
+
+void SmaIndicator::reset() {
+    window_.assign(static_cast<std::size_t>(period_), 0.0);
+    head_ = 0;
+    seen_ = 0;
+    period_total_ = 0.0;
+    current_value_ = std::numeric_limits<double>::quiet_NaN();
+    ready_ = false;
+}
+
+double SmaIndicator::update(const core::Candle& candle) {
+    // Same sequence as TA_INT_SMA: add the new close, emit total / period,
+    // then drop the oldest close of the window.
+    const double value = candle.close;
+    window_[head_] = value;
+    head_ = (head_ + 1) % window_.size();
+    ++seen_;
+
+    period_total_ += value;
+    if (seen_ < window_.size()) {
+        return current_value_; // Still NaN
+    }
+    current_value_ = period_total_ / period_;
+    period_total_ -= window_[head_]; // Oldest of the last 'period' closes
+    ready_ = seen_ > static_cast<std::size_t>(lookback_);
+    return current_value_;
+}
+
 } // namespace indicators
\ No newline at end of file
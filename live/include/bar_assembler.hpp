@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "datatypes.hpp"
+#include "candle_resampler.hpp"   // BarInterval, bucketBounds
+#include "live_signal_engine.hpp" // InstrumentId
+
+namespace live {
+
+    // --- BarAssembler ---
+    // Builds bars of one interval from individual trades, per instrument, with the
+    // bucket layout of data::resampleCandles(): bars are stamped with their bucket
+    // start and intraday buckets are anchored at the session open, so live bars line
+    // up with the historical ones the strategy was warmed up on.
+    //
+    // A bar is complete when a trade lands in a later bucket, or (for instruments
+    // that went quiet) when closeExpired() finds its bucket ended. Trades for a
+    // bucket that is already complete are rejected, so bars leave in time order.
+    // Not thread-safe.
+    class BarAssembler {
+    public:
+        enum class TradeOutcome {
+            Updated,   // Added to the current bar
+            Completed, // Started a new bar; 'completed' holds the previous one
+            Late,      // Before the current or an already completed bucket; ignored
+        };
+
+        // Throws core::ConfigException for an interval data::BarInterval cannot parse
+        BarAssembler(const std::string& interval, std::size_t instrument_count,
+                     data::ResampleOptions options = {});
+
+        // Trade of 'quantity' at 'price' at 'time_ns' (UTC ns since the epoch).
+        // 'open_interest' replaces the bar's open interest when set.
+        TradeOutcome addTrade(InstrumentId instrument, std::int64_t time_ns, double price, long long quantity,
+                              std::optional<long long> open_interest, core::Candle& completed);
+
+        // Completes every bar whose bucket ended at or before 'now_ns' - 'grace_ns'
+        // (trades arriving later for it are Late) and appends it to 'out'.
+        // Returns the number of bars appended.
+        std::size_t closeExpired(std::int64_t now_ns, std::int64_t grace_ns,
+                                 std::vector<std::pair<InstrumentId, core::Candle>>& out);
+
+        const data::BarInterval& interval() const { return interval_; }
+
+    private:
+        struct InstrumentBar {
+            core::Candle bar;
+            std::int64_t bucket_start = 0;
+            std::int64_t bucket_end = 0;
+            std::int64_t closed_until = 0; // End of the latest completed bucket
+            bool open = false;
+        };
+
+        data::BarInterval interval_;
+        data::ResampleOptions options_;
+        std::vector<InstrumentBar> bars_;
+    };
+
+} // namespace live
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "candle_series.hpp"
+#include "candle_resampler.hpp"   // ResampleOptions
+
+namespace live {
+
+    // --- FeedRecording ---
+    // Raw market-feed messages with the time each one arrived, in arrival order: what
+    // UpstoxMarketFeed writes with 'record_path' and what ReplayHarness plays back.
+    // Messages are stored back to back in one buffer.
+    //
+    // File layout (.tpfeed, native endianness):
+    //   char[4] magic "TPFR" | u32 version | { i64 time_ns | u32 length | bytes[length] }*
+    class FeedRecording {
+    public:
+        struct Record {
+            std::int64_t time_ns = 0; // Arrival time, UTC ns since the epoch
+            std::size_t offset = 0;
+            std::uint32_t length = 0;
+        };
+
+        // Times must not decrease; std::invalid_argument otherwise
+        void add(std::int64_t time_ns, std::string_view message);
+
+        std::size_t size() const { return records_.size(); }
+        bool empty() const { return records_.empty(); }
+        std::int64_t timeNs(std::size_t i) const { return records_[i].time_ns; }
+        std::string_view message(std::size_t i) const {
+            return std::string_view(bytes_).substr(records_[i].offset, records_[i].length);
+        }
+        std::size_t bytes() const { return message_bytes_; } // Sum of the message lengths
+
+        // Errors are logged; save() returns false, load() nullopt
+        bool save(const std::string& path) const;
+        static std::optional<FeedRecording> load(const std::string& path);
+
+        // Feed messages that rebuild stored candles: each bar becomes 'ticks_per_bar'
+        // trades spread over its bucket (open, then low and high in the order that
+        // fits the bar's direction, then close; 4 or more reproduce the bar's OHLC
+        // exactly), its volume split between them. Trades of all instruments at the
+        // same time share one message. 'series[i]' belongs to 'instrument_keys[i]'.
+        // Throws core::ConfigException for an unknown interval, std::invalid_argument
+        // for mismatched inputs or ticks_per_bar < 1.
+        static FeedRecording fromCandles(const std::vector<std::string>& instrument_keys,
+                                         const std::vector<core::CandleSeries>& series,
+                                         const std::string& interval, int ticks_per_bar = 4,
+                                         const data::ResampleOptions& sessions = {});
+
+    private:
+        std::string bytes_;
+        std::vector<Record> records_;
+        std::size_t message_bytes_ = 0;
+    };
+
+    // Appends feed messages to a .tpfeed file as they arrive (buffered; flush() or
+    // destroy to make them durable). Not thread-safe.
+    class FeedRecorder {
+    public:
+        // Logs an error and leaves isOpen() false if the file cannot be created
+        explicit FeedRecorder(const std::string& path);
+
+        bool isOpen() const { return out_.is_open() && !failed_; }
+        void write(std::int64_t time_ns, std::string_view message);
+        void flush();
+        std::uint64_t recorded() const { return recorded_; }
+
+    private:
+        std::string path_;
+        std::ofstream out_;
+        bool failed_ = false;
+        std::uint64_t recorded_ = 0;
+    };
+
+} // namespace live
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "datatypes.hpp"
+#include "candle_series.hpp"
+#include "indicators.hpp"        // IStreamingIndicator
+#include "screener.hpp"
+#include "live_signal_engine.hpp" // InstrumentId
+
+namespace live {
+
+    // --- LiveScreener ---
+    // Live counterpart of backtester::ScreenerRun: every completed bar updates that
+    // instrument's streaming indicators and its row of the screen, and scan()
+    // evaluates the screen across the whole universe on the latest values. Fed the
+    // same bars, its scan() after the last bar matches ScreenerRun's last snapshot.
+    //
+    // Only SMA / RSI indicators are supported (see createStreamingIndicator). The
+    // universe is the screen's "instruments" list; resolve a "universe" block
+    // beforehand with backtester::Backtester::resolveUniverse().
+    //
+    // Not thread-safe: onBar() and scan() from one thread, e.g. the feed consumer.
+    class LiveScreener {
+    public:
+        // Throws core::ConfigException if the screen is invalid, lists no instruments
+        // or needs an indicator without a streaming implementation
+        explicit LiveScreener(const nlohmann::json& screen_config);
+
+        const std::vector<std::string>& instruments() const { return screener_.instruments(); }
+        std::optional<InstrumentId> findInstrument(const std::string& instrument_key) const;
+        const std::string& timeframe() const { return screener_.spec().timeframe; }
+
+        // Feeds history into the instrument's indicators and takes its last bar as the
+        // instrument's current row
+        void warmUp(InstrumentId instrument, const core::CandleSeries& history);
+        // One completed bar on timeframe(); throws std::invalid_argument for an unknown id
+        void onBar(InstrumentId instrument, const core::Candle& bar);
+
+        // The result stays valid until the next scan()
+        const strategy_engine::ScreenResult& scan() { return screener_.scan(); }
+        const strategy_engine::Screener& screener() const { return screener_; }
+
+    private:
+        struct InstrumentState {
+            // Indexed like Screener::indicatorNames()
+            std::vector<std::unique_ptr<indicators::IStreamingIndicator>> indicators;
+            std::vector<double> values;
+        };
+
+        static strategy_engine::Screener buildScreener(const nlohmann::json& screen_config);
+
+        strategy_engine::Screener screener_;
+        std::vector<InstrumentState> states_;
+    };
+
+} // namespace live
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "datatypes.hpp"
+#include "candle_series.hpp"
+#include "interfaces.hpp"        // IStrategy
+#include "indicators.hpp"        // IStreamingIndicator
+#include "latency_histogram.hpp"
+#include "snapshot_handoff.hpp"
+#include "spsc_queue.hpp"
+
+namespace live {
+
+    using json = nlohmann::json;
+
+    // Dense index into LiveSignalEngine::instruments()
+    using InstrumentId = std::uint32_t;
+
+    // "SMA(20)" / "RSI(14)" (any case) -> streaming indicator; nullptr for anything else
+    std::unique_ptr<indicators::IStreamingIndicator> createStreamingIndicator(const std::string& spec);
+
+    // Monotonic clock in nanoseconds, the time base of all latencies below
+    std::int64_t nowNanos();
+
+    // One completed bar from the market-data thread
+    struct MarketDataEvent {
+        InstrumentId instrument = 0;
+        core::Candle bar;
+        std::int64_t ingest_ns = 0;    // When the data behind the bar arrived (see publish())
+        std::int64_t published_ns = 0; // nowNanos() when publish() was called
+    };
+
+    // A non-None strategy decision
+    struct LiveSignal {
+        InstrumentId instrument = 0;
+        core::Timestamp bar_time;
+        core::SignalAction action = core::SignalAction::None;
+        double price = 0.0;         // Close of the bar that triggered it
+        std::int64_t ingest_ns = 0;
+        std::int64_t signal_ns = 0; // nowNanos() when the signal was queued
+    };
+
+    struct LiveEngineOptions {
+        std::size_t input_capacity = 1 << 16;  // Bars in flight (rounded up to a power of two)
+        std::size_t output_capacity = 1 << 12; // Unread signals
+        int worker_cpu = -1;                   // Pin the worker to this CPU (Linux only; -1 = no pinning)
+        bool busy_poll = true;                 // Spin on an empty queue instead of yielding
+        std::int64_t evaluation_budget_ns = 100'000; // Evaluations slower than this count as over budget
+    };
+
+    struct LiveEngineStats {
+        std::uint64_t bars_processed = 0;
+        std::uint64_t signals = 0;
+        std::uint64_t input_dropped = 0;  // publish() calls rejected by a full input queue
+        std::uint64_t output_dropped = 0; // Signals lost to a full output queue
+        std::uint64_t over_budget = 0;    // Bars whose evaluation exceeded evaluation_budget_ns
+        core::LatencyHistogram tick_to_signal; // Ingest -> decision, every bar (None decisions too)
+        core::LatencyHistogram evaluation;     // Indicator updates + IStrategy::evaluate() per bar
+        // The stages of tick_to_signal
+        core::LatencyHistogram queue_wait;     // publish() -> picked up by the worker
+        core::LatencyHistogram indicators;     // Streaming indicator updates
+        core::LatencyHistogram strategy;       // IStrategy::evaluate()
+    };
+
+    // --- LiveSignalEngine ---
+    // Real-time counterpart of the Backtester's per-bar loop. A market-data thread
+    // publish()es completed bars into a lock-free SPSC queue; one worker thread
+    // updates the streaming indicators, evaluates the instrument's strategy with the
+    // same snapshot the backtester builds, and queues non-None signals on a second
+    // SPSC queue that one consumer thread drains with pollSignal().
+    //
+    // Every instrument in the strategy's "instruments" list gets its own strategy
+    // instance and indicators, as in Backtester. Only base-timeframe SMA / RSI
+    // indicators are supported; the engine neither sizes nor executes orders.
+    //
+    // Threading: publish() from exactly one thread, pollSignal() from exactly one
+    // thread; everything else from the thread that owns the engine.
+    class LiveSignalEngine {
+    public:
+        // Throws core::ConfigException if the strategy cannot be built or needs an
+        // indicator without a streaming implementation
+        explicit LiveSignalEngine(const json& strategy_config, LiveEngineOptions options = {});
+        ~LiveSignalEngine(); // stop()
+
+        LiveSignalEngine(const LiveSignalEngine&) = delete;
+        LiveSignalEngine& operator=(const LiveSignalEngine&) = delete;
+
+        const std::vector<std::string>& instruments() const { return instrument_keys_; }
+        std::optional<InstrumentId> findInstrument(const std::string& instrument_key) const;
+        // Timeframe the strategy runs on (its first required timeframe); bars must match it
+        const std::string& timeframe() const { return timeframe_; }
+
+        // Feeds history into the instrument's indicators (and previous bar) without
+        // evaluating the strategy, so trading starts flat with ready indicators.
+        // Only while stopped.
+        void warmUp(InstrumentId instrument, const core::CandleSeries& history);
+
+        void start();
+        // Processes every bar already published, then joins the worker
+        void stop();
+        bool isRunning() const { return worker_.joinable(); }
+
+        // Producer side. False (and counted) if the input queue is full. 'received_ns'
+        // is the nowNanos() at which the data behind the bar arrived (e.g. the feed
+        // message that completed it), so latencies cover the producer's work too;
+        // 0 means now.
+        bool publish(InstrumentId instrument, const core::Candle& bar, std::int64_t received_ns = 0);
+        // Bars published but not yet processed (approximate while running)
+        std::size_t inputQueueDepth() const { return events_.sizeApprox(); }
+        // Consumer side. False if no signal is waiting.
+        bool pollSignal(LiveSignal& out) { return signals_.tryPop(out); }
+
+        // Counters are live. While running, the histograms are a copy the worker makes
+        // between two bars (stats() waits for it), so they are consistent at any time.
+        LiveEngineStats stats() const;
+        void logLatencyReport() const;
+
+    private:
+        struct InstrumentState {
+            std::unique_ptr<strategy_engine::IStrategy> strategy;
+            // Slot-indexed, as in IStrategy::getRequiredIndicatorNames()
+            std::vector<std::unique_ptr<indicators::IStreamingIndicator>> indicators;
+            std::vector<double> current_values;
+            std::vector<double> previous_values;
+            core::Candle current_candle;
+            core::Candle previous_candle;
+            bool has_current = false;
+        };
+
+        void workerLoop();
+        void advanceIndicators(InstrumentState& state, const core::Candle& bar);
+        void process(const MarketDataEvent& event);
+
+        LiveEngineOptions options_;
+        std::string timeframe_;
+        std::vector<std::string> instrument_keys_;
+        std::unordered_map<std::string, InstrumentId> instrument_ids_;
+        std::vector<InstrumentState> states_; // Worker-owned while running
+
+        core::SpscQueue<MarketDataEvent> events_;
+        core::SpscQueue<LiveSignal> signals_;
+
+        std::thread worker_;
+        std::atomic<bool> stopping_{false};
+
+        // Written by one thread each, read by anyone
+        std::atomic<std::uint64_t> bars_processed_{0};
+        std::atomic<std::uint64_t> signals_emitted_{0};
+        std::atomic<std::uint64_t> input_dropped_{0};
+        std::atomic<std::uint64_t> output_dropped_{0};
+        std::atomic<std::uint64_t> over_budget_{0};
+        core::LatencyHistogram tick_to_signal_; // Worker-owned
+        core::LatencyHistogram evaluation_;     // Worker-owned
+        core::LatencyHistogram queue_wait_;     // Worker-owned
+        core::LatencyHistogram indicators_;     // Worker-owned
+        core::LatencyHistogram strategy_;       // Worker-owned
+        mutable core::SnapshotHandoff<LiveEngineStats> histogram_handoff_; // The histograms above, for stats()
+
+        void copyHistograms(LiveEngineStats& stats) const;
+    };
+
+} // namespace live
@@ -0,0 +1,252 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "datatypes.hpp"
+#include "common_types.hpp"      // SizingMethod
+#include "latency_histogram.hpp"
+#include "live_signal_engine.hpp"
+#include "snapshot_handoff.hpp"
+
+#include <nlohmann/json.hpp>
+
+namespace live {
+
+    enum class OrderSide { Buy, Sell };
+
+    // One order handed to the broker: the net of an instrument's signals in one tick
+    struct OrderRequest {
+        std::uint64_t client_order_id = 0;   // Unique per gateway, in submission order
+        InstrumentId instrument = 0;
+        std::string instrument_key;
+        OrderSide side = OrderSide::Buy;
+        long long quantity = 0;              // Always positive
+        double reference_price = 0.0;        // Close of the signalling bar (market orders)
+        core::Timestamp bar_time;
+        std::int64_t signal_ns = 0;          // Earliest signal of the batch (nowNanos())
+        std::int64_t submit_ns = 0;          // Handed to the transport
+    };
+
+    // What became of an order. Accepted means the broker acknowledged (placed) it,
+    // not that it filled.
+    enum class OrderOutcome {
+        Accepted,
+        Rejected,   // Refused by the broker, or certainly never reached it
+        Unknown     // May have reached the broker (e.g. timed out after sending)
+    };
+
+    struct OrderResult {
+        std::uint64_t client_order_id = 0;
+        OrderOutcome outcome = OrderOutcome::Rejected;
+        std::string broker_order_id;
+        std::string error;                   // Why it was refused, or why the outcome is unknown
+        std::int64_t completed_ns = 0;       // Response received (nowNanos())
+    };
+
+    // --- IOrderTransport ---
+    // Delivers orders to a broker. submitAsync() must only queue the batch and return:
+    // the gateway calls it between strategy signals. 'done' is called exactly once per
+    // order, from any thread, when the broker answered or the attempt failed.
+    //
+    // Every order reaches the broker with its client_order_id (e.g. in an order tag),
+    // and a transport never resends an order by itself. That id is what
+    // reconcileAsync() looks an Unknown order up by, in the broker's order book:
+    // 'done' is again called once per order, Unknown if the broker cannot tell yet.
+    class IOrderTransport {
+    public:
+        using Completion = std::function<void(const OrderResult&)>;
+        virtual ~IOrderTransport() = default;
+        virtual void submitAsync(std::vector<OrderRequest> batch, Completion done) = 0;
+        virtual void reconcileAsync(std::vector<OrderRequest> orders, Completion done) = 0;
+    };
+
+    // --- PreTradeRiskLimits ---
+    // Limits applied to every order before it leaves the gateway. All fields are
+    // atomics, so an operator or risk thread can tighten them (or hit the kill
+    // switch) while the gateway runs, without locks on the order path.
+    // A limit of 0 is not checked.
+    class PreTradeRiskLimits {
+    public:
+        explicit PreTradeRiskLimits(std::size_t instrument_count);
+
+        void setTradingEnabled(bool enabled) { trading_enabled_.store(enabled, std::memory_order_relaxed); }
+        void setMaxOrderQuantity(long long quantity) { max_order_quantity_.store(quantity, std::memory_order_relaxed); }
+        void setMaxOrderNotional(double notional) { max_order_notional_.store(notional, std::memory_order_relaxed); }
+        void setMaxPosition(long long quantity) { max_position_.store(quantity, std::memory_order_relaxed); } // Absolute, per instrument
+        void setMaxOpenOrders(std::uint32_t orders) { max_open_orders_.store(orders, std::memory_order_relaxed); }
+
+        bool tradingEnabled() const { return trading_enabled_.load(std::memory_order_relaxed); }
+        std::uint32_t openOrders() const { return open_orders_.load(std::memory_order_relaxed); }
+        // Position including orders in flight and accepted ones, all assumed to fill
+        long long projectedPosition(InstrumentId instrument) const {
+            return positions_[instrument].load(std::memory_order_relaxed);
+        }
+
+        // Checks the order and, if it passes, reserves it (open order, projected
+        // position). Returns nullptr if accepted, otherwise the limit it breaks.
+        // With trading disabled every order is refused, exits included.
+        // admit() and complete() are called by the gateway thread only.
+        const char* admit(const OrderRequest& order);
+        // The outcome is known; a refused order releases its projected position
+        void complete(const OrderRequest& order, bool accepted);
+
+    private:
+        std::atomic<bool> trading_enabled_{true};
+        std::atomic<long long> max_order_quantity_{0};
+        std::atomic<double> max_order_notional_{0.0};
+        std::atomic<long long> max_position_{0};
+        std::atomic<std::uint32_t> max_open_orders_{0};
+        std::atomic<std::uint32_t> open_orders_{0};
+        std::unique_ptr<std::atomic<long long>[]> positions_;
+        std::size_t instrument_count_ = 0;
+    };
+
+    // How many shares an entry buys or sells, as in Backtester::entryQuantity()
+    struct OrderSizing {
+        strategy_engine::SizingMethod method = strategy_engine::SizingMethod::Quantity;
+        double value = 1.0;
+        bool percentage = false;  // CapitalBased: 'value' is a % of 'capital'
+        double capital = 0.0;
+
+        long long quantityFor(double price) const;
+        // The strategy config's "position_sizing" with 'capital' for percentages.
+        // Throws core::ConfigException if the strategy cannot be built.
+        static OrderSizing fromStrategy(const nlohmann::json& strategy_config, double capital);
+    };
+
+    struct OrderGatewayOptions {
+        OrderSizing sizing;
+        bool busy_poll = false;   // Spin on an empty signal queue instead of yielding
+        int reconcile_interval_ms = 1000; // Between broker lookups of an order whose outcome is unknown
+    };
+
+    struct OrderGatewayStats {
+        std::uint64_t signals = 0;
+        std::uint64_t orders_submitted = 0;
+        std::uint64_t orders_netted_out = 0;  // Instrument batches that left the position unchanged
+        std::uint64_t risk_rejected = 0;
+        std::uint64_t blocked = 0;            // Instrument batches held back by an order of unknown outcome
+        std::uint64_t broker_accepted = 0;    // Acknowledged, not necessarily filled
+        std::uint64_t broker_rejected = 0;    // Refused by the broker or never sent
+        std::uint64_t broker_unknown = 0;     // Orders whose outcome was unknown at first
+        std::uint64_t unresolved = 0;         // Of those, still unknown now
+        core::LatencyHistogram signal_to_submit; // Strategy decision -> handed to the transport
+        core::LatencyHistogram submit_to_ack;    // Handed to the transport -> broker response
+        core::LatencyHistogram signal_to_ack;    // End to end
+    };
+
+    // --- OrderGateway ---
+    // Turns LiveSignalEngine signals into broker orders on its own thread:
+    //   1. drains every signal waiting in the engine's output queue,
+    //   2. nets the signals of each (instrument, bar) against the gateway's position
+    //      book into at most one order (e.g. ExitLong + EnterShort = one sell),
+    //   3. checks each order against PreTradeRiskLimits,
+    //   4. hands the batch to the IOrderTransport, which answers asynchronously.
+    // A slow broker therefore never holds up the engine or the next tick's signals.
+    // Completions are collected under a short lock and recorded by the gateway thread.
+    //
+    // An order whose outcome is Unknown keeps its reservation (open order, projected
+    // position), and the gateway sends no new orders for its instrument until
+    // reconcileAsync() finds out what the broker did with it.
+    //
+    // The position book assumes every accepted order fills. It does not follow fills:
+    // a market order the exchange rejects or cancels after the broker acknowledged it
+    // leaves projectedPosition() wrong, and a later exit sized from it (ExitLong sells
+    // the whole projected position) can then open a naked short. Whoever runs the
+    // gateway must check the broker's order book and stop trading (setTradingEnabled)
+    // on such a reject.
+    //
+    // The gateway is the engine's only pollSignal() consumer while it runs.
+    class OrderGateway {
+    public:
+        OrderGateway(LiveSignalEngine& engine, IOrderTransport& transport, OrderGatewayOptions options = {});
+        ~OrderGateway(); // stop()
+
+        OrderGateway(const OrderGateway&) = delete;
+        OrderGateway& operator=(const OrderGateway&) = delete;
+
+        PreTradeRiskLimits& riskLimits() { return risk_; }
+
+        void start();
+        // Routes every signal already queued, waits for outstanding broker answers
+        // (up to 'drain_timeout_ms'), then joins the gateway thread
+        void stop(int drain_timeout_ms = 5000);
+        bool isRunning() const { return thread_.joinable(); }
+
+        // Counters are live. While running, the histograms are a copy the gateway
+        // thread makes between two polls (stats() waits for it).
+        OrderGatewayStats stats() const;
+        void logLatencyReport() const;
+        // Counters and latency percentiles (ns) as JSON, for dashboards and CI
+        nlohmann::json latencyJson() const;
+        // Writes latencyJson() to 'path'; false (logged) on I/O errors
+        bool writeLatencyJson(const std::string& path) const;
+
+    private:
+        // Broker answers waiting for the gateway thread. Shared with the completion
+        // callbacks, so a transport answering after the gateway is gone stays safe.
+        struct CompletionInbox {
+            std::mutex mutex;
+            std::vector<OrderResult> results;
+            std::atomic<std::size_t> pending{0}; // results.size(), readable without the lock
+        };
+
+        // An order of unknown outcome; next_lookup_ns is 0 while a lookup is in flight
+        struct UnresolvedOrder {
+            OrderRequest order;
+            std::int64_t next_lookup_ns = 0;
+        };
+
+        void run();
+        void routeSignals(std::vector<LiveSignal>& signals);
+        // Entries only from flat, exits close the whole position (as in Backtester)
+        long long applySignal(long long position, const LiveSignal& signal) const;
+        IOrderTransport::Completion completionSink() const;
+        void drainCompletions();
+        void resolve(const OrderRequest& order, const OrderResult& result);
+        void markUnresolved(const OrderRequest& order, const std::string& reason);
+        // Hands the unresolved orders due for a lookup to the transport
+        void reconcileDue();
+        void copyHistograms(OrderGatewayStats& stats) const;
+
+        LiveSignalEngine& engine_;
+        IOrderTransport& transport_;
+        OrderGatewayOptions options_;
+        // Also the gateway's position book: projected positions assume in-flight orders fill
+        PreTradeRiskLimits risk_;
+
+        std::thread thread_;
+        std::atomic<bool> stopping_{false};
+        std::atomic<int> drain_timeout_ms_{5000};
+        std::uint64_t next_order_id_ = 1;
+
+        std::unordered_map<std::uint64_t, OrderRequest> in_flight_; // Gateway thread only
+        std::unordered_map<std::uint64_t, UnresolvedOrder> unresolved_; // Gateway thread only
+        std::vector<std::uint32_t> unresolved_per_instrument_;           // Gateway thread only
+        std::shared_ptr<CompletionInbox> inbox_;
+
+        std::atomic<std::uint64_t> signals_{0};
+        std::atomic<std::uint64_t> orders_submitted_{0};
+        std::atomic<std::uint64_t> orders_netted_out_{0};
+        std::atomic<std::uint64_t> risk_rejected_{0};
+        std::atomic<std::uint64_t> blocked_{0};
+        std::atomic<std::uint64_t> broker_accepted_{0};
+        std::atomic<std::uint64_t> broker_rejected_{0};
+        std::atomic<std::uint64_t> broker_unknown_{0};
+        std::atomic<std::uint64_t> unresolved_count_{0}; // unresolved_.size()
+        core::LatencyHistogram signal_to_submit_; // Gateway thread
+        core::LatencyHistogram submit_to_ack_;
+        core::LatencyHistogram signal_to_ack_;
+        mutable core::SnapshotHandoff<OrderGatewayStats> histogram_handoff_; // The histograms above, for stats()
+    };
+
+} // namespace live
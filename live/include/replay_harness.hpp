@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "feed_recording.hpp"
+#include "latency_histogram.hpp"
+#include "live_signal_engine.hpp"
+#include "upstox_market_feed.hpp"
+
+namespace live {
+
+    struct ReplayOptions {
+        double speed = 0.0;                 // 1 = recorded pace, N = N times faster, 0 = as fast as possible
+        std::size_t max_queue_depth = 1024; // Replay waits while this many bars are queued (0 = never);
+                                            // keep it below the engine's input capacity so no bar is dropped
+        UpstoxMarketFeedOptions feed;       // Sessions and bar_close_grace_ms; read_timeout_ms is the
+                                            // recording time between quiet-bar checks
+        std::map<std::string, std::int64_t> max_p99_ns; // Stage -> p99 limit; a stage over its limit fails the run
+    };
+
+    struct ReplayStage {
+        std::string name;
+        core::LatencyHistogram histogram;
+        std::int64_t max_p99_ns = 0; // 0 = no limit
+    };
+
+    struct ReplayReport {
+        std::size_t messages = 0;
+        std::uint64_t ticks = 0;
+        std::uint64_t bars = 0;
+        std::uint64_t signals = 0;
+        std::uint64_t dropped = 0;           // Bars and signals lost to full engine queues
+        double source_seconds = 0.0;         // Time span of the recording
+        double wall_seconds = 0.0;
+        double messages_per_second = 0.0;    // Wall-clock throughput
+        std::uint64_t signal_checksum = 0;   // FNV-1a over (instrument, bar time, action) of every signal, in order
+        std::vector<ReplayStage> stages;     // In ReplayHarness::stageNames() order
+        std::vector<std::string> failures;   // One line per stage over its p99 limit
+
+        bool passed() const { return failures.empty(); }
+        const ReplayStage* stage(const std::string& name) const;
+
+        void log() const;
+        nlohmann::json toJson() const;
+        // Errors are logged and return false
+        bool writeJson(const std::string& path) const;
+        // One HdrHistogram percentile distribution file per stage: <directory>/<stage>.hgrm (microseconds)
+        bool writeHistograms(const std::string& directory) const;
+    };
+
+    // --- ReplayHarness ---
+    // Plays a FeedRecording through the live path, the same code the Upstox feed runs:
+    // every message is decoded and assembled into bars by an UpstoxMarketFeed (driven
+    // without a connection), bars go through the LiveSignalEngine's input queue, and a
+    // consumer thread drains the signals as an order gateway would. Quiet bars close
+    // by the recording's clock, so a run is deterministic: the same recording and
+    // strategy give the same signals, in the same order, at any speed.
+    //
+    // Latency per stage (ns):
+    //   decode         message received -> protobuf decoded              (per message)
+    //   bar_assembly   ordering checks and bar updates of its ticks      (per message)
+    //   queue_wait     bar published -> picked up by the engine worker   (per bar)
+    //   indicators     streaming indicator updates                       (per bar)
+    //   evaluate       IStrategy::evaluate()                             (per bar)
+    //   signal_out     signal queued -> read by the consumer             (per signal)
+    //   tick_to_signal message received -> decision                      (per bar)
+    //   end_to_end     message received -> signal read by the consumer   (per signal)
+    class ReplayHarness {
+    public:
+        static const std::vector<std::string>& stageNames();
+
+        // Throws core::ConfigException for a p99 limit on an unknown stage.
+        // 'engine' must be stopped and not have processed bars yet.
+        ReplayHarness(LiveSignalEngine& engine, ReplayOptions options);
+
+        // Starts the engine, replays every message, closes the bars still open and
+        // stops the engine. Once per engine.
+        ReplayReport run(const FeedRecording& recording);
+
+    private:
+        LiveSignalEngine& engine_;
+        ReplayOptions options_;
+    };
+
+} // namespace live
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "bar_assembler.hpp"
+#include "candle_resampler.hpp"   // ResampleOptions
+#include "feed_recording.hpp"
+#include "latency_histogram.hpp"
+#include "live_signal_engine.hpp"
+#include "upstox_feed_decoder.hpp"
+#include "websocket_client.hpp"
+
+namespace live {
+
+    struct UpstoxMarketFeedOptions {
+        std::string access_token;      // Authorizes every (re)connect
+        std::string feed_url;          // Connect here instead of authorizing (a relay, a recorded-feed server)
+        std::string mode = "ltpc";     // Subscription mode: "ltpc", "full", "option_greeks", "full_d30"
+        int read_timeout_ms = 200;     // How often quiet bars and stop() are checked
+        std::int64_t bar_close_grace_ms = 1500; // A quiet bar closes this long after its bucket ended
+        int reconnect_initial_ms = 500;         // Doubles up to reconnect_max_ms while connects fail
+        int reconnect_max_ms = 30000;
+        int stats_interval_ms = 60000;          // Feed statistics log period (0 = never)
+        data::ResampleOptions sessions;         // Bucket layout, as for the historical bars
+        data::WebSocketOptions websocket;
+        std::string record_path;                // Also write every feed message here (a .tpfeed for replay)
+    };
+
+    struct UpstoxFeedStats {
+        std::uint64_t messages = 0;
+        std::uint64_t bytes = 0;
+        std::uint64_t ticks = 0;              // Instrument updates decoded
+        std::uint64_t decode_errors = 0;      // Malformed messages (the ticks before the error are kept)
+        std::uint64_t unknown_instruments = 0; // Ticks for instruments the engine does not trade
+        std::uint64_t stale_ticks = 0;        // Older than or repeating the instrument's last trade
+        std::uint64_t late_ticks = 0;         // For a bar that was already published
+        std::uint64_t bars_published = 0;
+        std::uint64_t bars_dropped = 0;       // Rejected by the engine's full input queue
+        std::uint64_t connects = 0;           // Successful connections, the first one included
+        std::uint64_t connect_failures = 0;
+        double messages_per_second = 0.0;     // Since start()
+        std::size_t queue_depth = 0;          // Engine input queue, sampled after each publish
+        std::size_t max_queue_depth = 0;
+        core::LatencyHistogram decode;        // Per message: protobuf decoding
+        core::LatencyHistogram assembly;      // Per message: ordering checks and bar updates of its ticks
+    };
+
+    // --- UpstoxMarketFeed ---
+    // Upstox v3 market-data WebSocket feed -> LiveSignalEngine bars, on its own thread:
+    // authorizes and connects, subscribes the engine's instruments, decodes every
+    // protobuf message in place (data::decodeUpstoxFeed), turns trades into bars of
+    // the engine's timeframe (BarAssembler) and publish()es completed bars into the
+    // engine's lock-free input queue. The feed thread is the engine's only producer.
+    //
+    // On a dropped connection it reconnects with backoff and subscribes again. The
+    // snapshot Upstox sends after a subscription, and anything else older than or
+    // repeating an instrument's last trade, is dropped, so bars stay in order across
+    // reconnects. In "full" modes the traded-volume counter also recovers volume
+    // traded while disconnected; in "ltpc" mode those trades are lost.
+    class UpstoxMarketFeed {
+    public:
+        // Throws core::ConfigException if the engine's timeframe is not a bar interval
+        UpstoxMarketFeed(LiveSignalEngine& engine, UpstoxMarketFeedOptions options);
+        ~UpstoxMarketFeed(); // stop()
+
+        UpstoxMarketFeed(const UpstoxMarketFeed&) = delete;
+        UpstoxMarketFeed& operator=(const UpstoxMarketFeed&) = delete;
+
+        void start();
+        // Disconnects within about read_timeout_ms; bars still being built are not published
+        void stop();
+        bool isRunning() const { return thread_.joinable(); }
+
+        // Counters are live; the histograms are only consistent once stop() returned
+        UpstoxFeedStats stats() const;
+        void logStats() const;
+
+        // Feed subscription request for 'instrument_keys' (sent as a binary frame)
+        static std::string subscriptionRequest(const std::vector<std::string>& instrument_keys,
+                                               const std::string& mode);
+
+        // Drive the feed without a connection (replay, tests); only while not started.
+        // processMessage() handles one binary feed message received at nowNanos()
+        // 'received_ns'; closeBars() publishes the bars whose bucket ended more than
+        // bar_close_grace_ms before 'now_ns' (UTC ns, the clock of the trade times).
+        void processMessage(std::string_view message, std::int64_t received_ns);
+        void closeBars(std::int64_t now_ns);
+
+    private:
+        // Last trade seen per instrument, for dropping stale and duplicate ticks
+        struct TradeCursor {
+            std::int64_t ltt_ms = -1;
+            std::int64_t vtt = -1;
+            double ltp = 0.0;
+            std::int64_t ltq = 0;
+        };
+
+        // Heterogeneous lookup, so string_view keys from the decoder never allocate
+        struct KeyHash {
+            using is_transparent = void;
+            std::size_t operator()(std::string_view key) const { return std::hash<std::string_view>{}(key); }
+        };
+
+        void run();
+        bool connect(data::WebSocketClient& socket);
+        void onTick(const data::UpstoxFeedTick& tick);
+        void publish(InstrumentId instrument, const core::Candle& bar, std::int64_t received_ns);
+        void closeQuietBars();
+        void sleepBackoff(int milliseconds);
+
+        LiveSignalEngine& engine_;
+        UpstoxMarketFeedOptions options_;
+        std::unordered_map<std::string, InstrumentId, KeyHash, std::equal_to<>> instrument_ids_;
+
+        // Feed-thread state
+        BarAssembler assembler_;
+        std::vector<TradeCursor> cursors_;
+        std::vector<std::pair<InstrumentId, core::Candle>> expired_; // Reused by closeBars()
+        std::vector<data::UpstoxFeedTick> message_ticks_;            // Ticks of the message being processed
+        std::function<void(const data::UpstoxFeedTick&)> on_tick_;   // Bound once, no per-message allocation
+        std::int64_t message_received_ns_ = 0;
+        std::unique_ptr<FeedRecorder> recorder_;
+        core::LatencyHistogram decode_;
+        core::LatencyHistogram assembly_;
+
+        std::thread thread_;
+        std::atomic<bool> stopping_{false};
+        std::int64_t started_ns_ = 0;
+
+        std::atomic<std::uint64_t> messages_{0};
+        std::atomic<std::uint64_t> bytes_{0};
+        std::atomic<std::uint64_t> ticks_{0};
+        std::atomic<std::uint64_t> decode_errors_{0};
+        std::atomic<std::uint64_t> unknown_instruments_{0};
+        std::atomic<std::uint64_t> stale_ticks_{0};
+        std::atomic<std::uint64_t> late_ticks_{0};
+        std::atomic<std::uint64_t> bars_published_{0};
+        std::atomic<std::uint64_t> bars_dropped_{0};
+        std::atomic<std::uint64_t> connects_{0};
+        std::atomic<std::uint64_t> connect_failures_{0};
+        std::atomic<std::size_t> queue_depth_{0};
+        std::atomic<std::size_t> max_queue_depth_{0};
+    };
+
+} // namespace live
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "order_gateway.hpp" // IOrderTransport
+
+namespace live {
+
+    struct UpstoxOrderTransportOptions {
+        std::string access_token;
+        std::string base_url = "https://api.upstox.com";
+        std::size_t connections = 4;   // Orders in flight at once, one kept-alive session each
+        long timeout_ms = 5000;        // Per order; a timeout leaves the order's outcome unknown
+        long connect_timeout_ms = 2000;
+        std::string product = "I";     // "I" intraday, "D" delivery
+        std::string tag;               // Prefix of every order's tag in the Upstox order book (keep it short)
+        long not_found_grace_ms = 30000; // An unknown order missing from the order book this long after sending was never placed
+    };
+
+    // --- UpstoxOrderTransport ---
+    // Places market orders through the Upstox v2 REST API (POST /v2/order/place).
+    // submitAsync() only queues; a fixed set of connection threads, each with its own
+    // cpr::Session (libcurl keeps the TLS connection alive between requests), send
+    // the orders and report each response. A slow answer therefore only occupies one
+    // connection while the others keep sending.
+    //
+    // Every order is tagged with orderTag(): the tag prefix, a token of this
+    // transport instance and the client_order_id. A request that may have reached
+    // Upstox without an answer (timeout, connection lost after sending, HTTP 5xx) is
+    // reported Unknown; reconcileAsync() then finds the order by its tag in
+    // GET /v2/order/retrieve-all (the day's order book).
+    class UpstoxOrderTransport : public IOrderTransport {
+    public:
+        explicit UpstoxOrderTransport(UpstoxOrderTransportOptions options);
+        ~UpstoxOrderTransport() override; // Fails queued orders, waits for the ones being sent
+
+        UpstoxOrderTransport(const UpstoxOrderTransport&) = delete;
+        UpstoxOrderTransport& operator=(const UpstoxOrderTransport&) = delete;
+
+        void submitAsync(std::vector<OrderRequest> batch, Completion done) override;
+        void reconcileAsync(std::vector<OrderRequest> orders, Completion done) override;
+
+        // Request body for one order (exposed for logging and inspection)
+        std::string orderBody(const OrderRequest& order) const;
+        std::string orderTag(const OrderRequest& order) const;
+        // Outcome of an /order/place response
+        static OrderResult parsePlaceOrderResponse(std::uint64_t client_order_id, long status_code,
+                                                   const std::string& body);
+        // Outcome of each order according to an /order/retrieve-all response
+        std::vector<OrderResult> parseOrderBookResponse(const std::vector<OrderRequest>& orders, long status_code,
+                                                        const std::string& body, std::int64_t now_ns) const;
+
+    private:
+        struct QueuedOrder {
+            OrderRequest order;
+            std::shared_ptr<const Completion> done; // Shared by the orders of one batch
+        };
+        struct QueuedLookup {
+            std::vector<OrderRequest> orders;
+            Completion done;
+        };
+
+        void connectionLoop();
+        void lookUp(const QueuedLookup& lookup);
+
+        UpstoxOrderTransportOptions options_;
+        std::string place_url_;
+        std::string order_book_url_;
+        std::string tag_prefix_; // options_.tag and this instance's token
+
+        std::mutex mutex_;
+        std::condition_variable ready_;
+        std::deque<QueuedOrder> queue_;
+        std::deque<QueuedLookup> lookups_; // Sent when no order is waiting
+        bool stopping_ = false;
+        std::vector<std::thread> connections_;
+    };
+
+} // namespace live
@@ -0,0 +1,66 @@
+#include "bar_assembler.hpp"
+#include "exceptions.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace live {
+
+    BarAssembler::BarAssembler(const std::string& interval, std::size_t instrument_count, data::ResampleOptions options)
+        : options_(options), bars_(instrument_count)
+    {
+        const auto parsed = data::BarInterval::parse(interval);
+        if (!parsed) throw core::ConfigException("Bar assembler: unknown interval '" + interval + "'.");
+        interval_ = *parsed;
+        for (auto& state : bars_) state.closed_until = std::numeric_limits<std::int64_t>::min();
+    }
+
+    BarAssembler::TradeOutcome BarAssembler::addTrade(InstrumentId instrument, std::int64_t time_ns, double price,
+                                                      long long quantity, std::optional<long long> open_interest,
+                                                      core::Candle& completed) {
+        InstrumentBar& state = bars_[instrument];
+        // Fast path: the trade falls into the bar being built
+        if (state.open && time_ns >= state.bucket_start && time_ns < state.bucket_end) {
+            state.bar.high = std::max(state.bar.high, price);
+            state.bar.low = std::min(state.bar.low, price);
+            state.bar.close = price;
+            state.bar.volume += quantity;
+            if (open_interest) state.bar.open_interest = open_interest;
+            return TradeOutcome::Updated;
+        }
+        if ((state.open && time_ns < state.bucket_start) || time_ns < state.closed_until) return TradeOutcome::Late;
+
+        TradeOutcome outcome = TradeOutcome::Updated;
+        if (state.open) {
+            completed = state.bar;
+            state.closed_until = state.bucket_end;
+            outcome = TradeOutcome::Completed;
+        }
+        const auto [start, end] = data::bucketBounds(interval_, time_ns, options_);
+        state.bucket_start = start;
+        state.bucket_end = end;
+        state.bar = core::Candle{};
+        state.bar.timestamp = core::utils::epochNanosToTimestamp(start);
+        state.bar.open = state.bar.high = state.bar.low = state.bar.close = price;
+        state.bar.volume = quantity;
+        state.bar.open_interest = open_interest;
+        state.open = true;
+        return outcome;
+    }
+
+    std::size_t BarAssembler::closeExpired(std::int64_t now_ns, std::int64_t grace_ns,
+                                           std::vector<std::pair<InstrumentId, core::Candle>>& out) {
+        std::size_t closed = 0;
+        for (std::size_t i = 0; i < bars_.size(); ++i) {
+            InstrumentBar& state = bars_[i];
+            if (!state.open || state.bucket_end > now_ns - grace_ns) continue;
+            out.emplace_back(static_cast<InstrumentId>(i), state.bar);
+            state.closed_until = state.bucket_end;
+            state.open = false;
+            ++closed;
+        }
+        return closed;
+    }
+
+} // namespace live
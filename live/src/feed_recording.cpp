@@ -0,0 +1,216 @@
+#include "feed_recording.hpp"
+#include "exceptions.hpp"
+#include "logging.hpp"
+#include "upstox_feed_decoder.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+
+namespace live {
+
+    namespace { // File-local helpers
+
+        constexpr char kFileMagic[4] = {'T', 'P', 'F', 'R'};
+        constexpr std::uint32_t kFileVersion = 1;
+        constexpr std::size_t kHeaderSize = sizeof(kFileMagic) + sizeof(kFileVersion);
+        constexpr std::size_t kRecordHeaderSize = sizeof(std::int64_t) + sizeof(std::uint32_t);
+
+        // One synthetic trade of FeedRecording::fromCandles()
+        struct SyntheticTrade {
+            std::int64_t time_ms = 0;
+            std::uint32_t instrument = 0;
+            std::uint32_t sequence = 0; // Position within its bar
+            double price = 0.0;
+            long long quantity = 0;
+            std::optional<std::int64_t> open_interest;
+        };
+
+        // Trade prices for one bar: open, the extreme it reaches first, the other
+        // extreme, close; fewer ticks drop the extremes, more repeat the close
+        void barPath(double open, double high, double low, double close, int ticks, std::vector<double>& out) {
+            out.clear();
+            if (ticks == 1) {
+                out.push_back(close);
+                return;
+            }
+            const bool rising = close >= open;
+            out.push_back(open);
+            if (ticks >= 3) out.push_back(rising ? low : high);
+            if (ticks >= 4) out.push_back(rising ? high : low);
+            while (static_cast<int>(out.size()) < ticks) out.push_back(close);
+        }
+
+    } // end anonymous namespace
+
+    void FeedRecording::add(std::int64_t time_ns, std::string_view message) {
+        if (!records_.empty() && time_ns < records_.back().time_ns) {
+            throw std::invalid_argument("FeedRecording::add(): message times must not decrease.");
+        }
+        if (message.size() > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::invalid_argument("FeedRecording::add(): message too large.");
+        }
+        records_.push_back({time_ns, bytes_.size(), static_cast<std::uint32_t>(message.size())});
+        bytes_.append(message);
+        message_bytes_ += message.size();
+    }
+
+    bool FeedRecording::save(const std::string& path) const {
+        auto logger = core::logging::getLogger();
+        FeedRecorder recorder(path);
+        if (!recorder.isOpen()) return false;
+        for (std::size_t i = 0; i < records_.size(); ++i) recorder.write(records_[i].time_ns, message(i));
+        recorder.flush();
+        if (!recorder.isOpen()) return false;
+        logger->info("Saved {} feed message(s) ({} bytes) to {}", records_.size(), message_bytes_, path);
+        return true;
+    }
+
+    std::optional<FeedRecording> FeedRecording::load(const std::string& path) {
+        auto logger = core::logging::getLogger();
+        std::ifstream in(path, std::ios::binary);
+        if (!in.is_open()) {
+            logger->error("Cannot open feed recording: {}", path);
+            return std::nullopt;
+        }
+        FeedRecording recording;
+        recording.bytes_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+
+        // The messages stay where they are in the file image; only the index is built
+        const std::string& bytes = recording.bytes_;
+        std::uint32_t version = 0;
+        if (bytes.size() >= kHeaderSize) std::memcpy(&version, bytes.data() + sizeof(kFileMagic), sizeof(version));
+        if (bytes.size() < kHeaderSize || std::memcmp(bytes.data(), kFileMagic, sizeof(kFileMagic)) != 0 ||
+            version != kFileVersion) {
+            logger->error("Not a feed recording (or an unsupported version): {}", path);
+            return std::nullopt;
+        }
+        std::size_t pos = kHeaderSize;
+        while (pos < bytes.size()) {
+            Record record;
+            if (bytes.size() - pos < kRecordHeaderSize) break;
+            std::memcpy(&record.time_ns, bytes.data() + pos, sizeof(record.time_ns));
+            std::memcpy(&record.length, bytes.data() + pos + sizeof(record.time_ns), sizeof(record.length));
+            pos += kRecordHeaderSize;
+            if (bytes.size() - pos < record.length) {
+                pos -= kRecordHeaderSize;
+                break;
+            }
+            record.offset = pos;
+            pos += record.length;
+            recording.records_.push_back(record);
+            recording.message_bytes_ += record.length;
+        }
+        if (pos != bytes.size()) {
+            // A recorder that was killed leaves a partial last record; everything before it is good
+            logger->warn("Feed recording {} ends in a truncated record; replaying the first {} message(s).",
+                         path, recording.records_.size());
+        }
+        return recording;
+    }
+
+    FeedRecording FeedRecording::fromCandles(const std::vector<std::string>& instrument_keys,
+                                             const std::vector<core::CandleSeries>& series,
+                                             const std::string& interval, int ticks_per_bar,
+                                             const data::ResampleOptions& sessions)
+    {
+        if (instrument_keys.size() != series.size()) {
+            throw std::invalid_argument("FeedRecording::fromCandles(): one candle series per instrument is required.");
+        }
+        if (ticks_per_bar < 1) throw std::invalid_argument("FeedRecording::fromCandles(): ticks_per_bar must be at least 1.");
+        const auto bar_interval = data::BarInterval::parse(interval);
+        if (!bar_interval) throw core::ConfigException("Feed recording: unknown interval '" + interval + "'.");
+
+        std::vector<SyntheticTrade> trades;
+        std::vector<double> path;
+        for (std::size_t i = 0; i < series.size(); ++i) {
+            const core::CandleSeries& bars = series[i];
+            const auto timestamps = bars.timestampsNs();
+            for (std::size_t row = 0; row < bars.size(); ++row) {
+                const auto [start, end] = data::bucketBounds(*bar_interval, timestamps[row], sessions);
+                barPath(bars.open()[row], bars.high()[row], bars.low()[row], bars.close()[row], ticks_per_bar, path);
+                const long long volume = std::llround(bars.volume()[row]);
+                const long long per_tick = volume / ticks_per_bar;
+                for (int k = 0; k < ticks_per_bar; ++k) {
+                    SyntheticTrade trade;
+                    trade.time_ms = (start + (end - start) / ticks_per_bar * k) / 1'000'000;
+                    trade.instrument = static_cast<std::uint32_t>(i);
+                    trade.sequence = static_cast<std::uint32_t>(k);
+                    trade.price = path[static_cast<std::size_t>(k)];
+                    trade.quantity = per_tick + (k == 0 ? volume - per_tick * ticks_per_bar : 0);
+                    if (bars.hasOpenInterest()) trade.open_interest = bars.openInterest()[row];
+                    trades.push_back(trade);
+                }
+            }
+        }
+        std::sort(trades.begin(), trades.end(), [](const SyntheticTrade& a, const SyntheticTrade& b) {
+            if (a.time_ms != b.time_ms) return a.time_ms < b.time_ms;
+            if (a.instrument != b.instrument) return a.instrument < b.instrument;
+            return a.sequence < b.sequence;
+        });
+
+        FeedRecording recording;
+        std::vector<data::UpstoxFeedTick> ticks;
+        std::string message;
+        for (std::size_t first = 0; first < trades.size();) {
+            std::size_t last = first;
+            ticks.clear();
+            while (last < trades.size() && trades[last].time_ms == trades[first].time_ms) {
+                const SyntheticTrade& trade = trades[last++];
+                data::UpstoxFeedTick tick;
+                tick.instrument_key = instrument_keys[trade.instrument];
+                tick.ltp = trade.price;
+                tick.ltt_ms = trade.time_ms;
+                tick.ltq = trade.quantity;
+                if (trade.open_interest) {
+                    tick.open_interest = static_cast<double>(*trade.open_interest);
+                    tick.has_open_interest = true;
+                }
+                ticks.push_back(tick);
+            }
+            message.clear();
+            data::appendUpstoxFeedMessage(message, data::UpstoxFeedType::LiveFeed, trades[first].time_ms, ticks);
+            recording.add(trades[first].time_ms * 1'000'000, message);
+            first = last;
+        }
+        return recording;
+    }
+
+    FeedRecorder::FeedRecorder(const std::string& path)
+        : path_(path), out_(path, std::ios::binary | std::ios::trunc)
+    {
+        if (!out_.is_open()) {
+            core::logging::getLogger()->error("Cannot create feed recording: {}", path);
+            return;
+        }
+        out_.write(kFileMagic, sizeof(kFileMagic));
+        out_.write(reinterpret_cast<const char*>(&kFileVersion), sizeof(kFileVersion));
+    }
+
+    void FeedRecorder::write(std::int64_t time_ns, std::string_view message) {
+        if (!isOpen()) return;
+        const auto length = static_cast<std::uint32_t>(message.size());
+        out_.write(reinterpret_cast<const char*>(&time_ns), sizeof(time_ns));
+        out_.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        out_.write(message.data(), static_cast<std::streamsize>(message.size()));
+        if (!out_) {
+            core::logging::getLogger()->error("Failed writing feed recording {}; recording stopped.", path_);
+            failed_ = true;
+            return;
+        }
+        ++recorded_;
+    }
+
+    void FeedRecorder::flush() {
+        if (!isOpen()) return;
+        out_.flush();
+        if (!out_) {
+            core::logging::getLogger()->error("Failed writing feed recording {}; recording stopped.", path_);
+            failed_ = true;
+        }
+    }
+
+} // namespace live
@@ -0,0 +1,70 @@
+#include "live_screener.hpp"
+#include "exceptions.hpp"
+#include "logging.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+namespace live {
+
+    strategy_engine::Screener LiveScreener::buildScreener(const nlohmann::json& screen_config) {
+        strategy_engine::ScreenSpec spec;
+        try {
+            spec = strategy_engine::ScreenSpec::fromJson(screen_config);
+        } catch (const std::invalid_argument& e) {
+            throw core::ConfigException(std::string("Live screener: invalid screen config: ") + e.what());
+        }
+        if (!screen_config.contains("instruments") || !screen_config["instruments"].is_array()) {
+            throw core::ConfigException("Live screener: screen '" + spec.name + "' has no 'instruments' list.");
+        }
+        try {
+            return strategy_engine::Screener(std::move(spec), screen_config["instruments"].get<std::vector<std::string>>());
+        } catch (const std::exception& e) {
+            throw core::ConfigException(std::string("Live screener: ") + e.what());
+        }
+    }
+
+    LiveScreener::LiveScreener(const nlohmann::json& screen_config)
+        : screener_(buildScreener(screen_config))
+    {
+        const auto& indicator_names = screener_.indicatorNames();
+        for (const auto& name : indicator_names) {
+            if (!createStreamingIndicator(name)) {
+                throw core::ConfigException("Live screener: no streaming implementation for indicator '" + name + "'.");
+            }
+        }
+        states_.resize(screener_.instruments().size());
+        for (auto& state : states_) {
+            for (const auto& name : indicator_names) state.indicators.push_back(createStreamingIndicator(name));
+            state.values.assign(indicator_names.size(), strategy_engine::kMissingIndicatorValue);
+        }
+        core::logging::getLogger()->info("Live screener ready: screen '{}' on {} instrument(s), {} indicator(s), timeframe {}.",
+                                         screener_.spec().name, states_.size(), indicator_names.size(), timeframe());
+    }
+
+    std::optional<InstrumentId> LiveScreener::findInstrument(const std::string& instrument_key) const {
+        if (const auto row = screener_.findInstrument(instrument_key)) return static_cast<InstrumentId>(*row);
+        return std::nullopt;
+    }
+
+    void LiveScreener::warmUp(InstrumentId instrument, const core::CandleSeries& history) {
+        if (instrument >= states_.size()) throw std::invalid_argument("LiveScreener::warmUp(): unknown instrument id.");
+        if (history.empty()) return;
+        InstrumentState& state = states_[instrument];
+        for (std::size_t slot = 0; slot < state.indicators.size(); ++slot) {
+            state.indicators[slot]->warmUp(history);
+            state.values[slot] = state.indicators[slot]->currentValue();
+        }
+        screener_.update(instrument, history.at(history.size() - 1), state.values);
+    }
+
+    void LiveScreener::onBar(InstrumentId instrument, const core::Candle& bar) {
+        if (instrument >= states_.size()) throw std::invalid_argument("LiveScreener::onBar(): unknown instrument id.");
+        InstrumentState& state = states_[instrument];
+        for (std::size_t slot = 0; slot < state.indicators.size(); ++slot) {
+            state.values[slot] = state.indicators[slot]->update(bar);
+        }
+        screener_.update(instrument, bar, state.values);
+    }
+
+} // namespace live
@@ -0,0 +1,283 @@
+#include "live_signal_engine.hpp"
+#include "exceptions.hpp"
+#include "logging.hpp"
+#include "strategy_factory.hpp"
+#include "sma_indicator.hpp"
+#include "rsi_indicator.hpp"
+#include "indicator_registry.hpp" // parseIndicatorSpec
+
+#include <chrono>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__linux__)
+#include <pthread.h> // pthread_setaffinity_np
+#include <sched.h>
+#endif
+
+namespace live {
+
+    namespace {
+
+        inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#else
+            std::this_thread::yield();
+#endif
+        }
+
+        void pinCurrentThread(int cpu) {
+            auto logger = core::logging::getLogger();
+#if defined(__linux__)
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            CPU_SET(cpu, &cpus);
+            const int rc = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+            if (rc != 0) {
+                logger->warn("Could not pin live worker to CPU {} (error {}); running unpinned.", cpu, rc);
+                return;
+            }
+            logger->info("Live worker pinned to CPU {}.", cpu);
+#else
+            logger->warn("CPU pinning is not supported on this platform; live worker runs unpinned (requested CPU {}).", cpu);
+#endif
+        }
+
+    } // namespace
+
+    std::unique_ptr<indicators::IStreamingIndicator> createStreamingIndicator(const std::string& spec) {
+        indicators::IndicatorSpec parsed;
+        int period = 0;
+        try {
+            parsed = indicators::parseIndicatorSpec(spec);
+            if (parsed.args.size() != 1) return nullptr;
+            period = indicators::IndicatorRegistry::periodArgument(parsed.args[0], "Period");
+        } catch (const std::invalid_argument&) {
+            return nullptr;
+        }
+        if (parsed.type == "SMA") return std::make_unique<indicators::SmaIndicator>(period);
+        if (parsed.type == "RSI") return std::make_unique<indicators::RsiIndicator>(period);
+        return nullptr;
+    }
+
+    std::int64_t nowNanos() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    LiveSignalEngine::LiveSignalEngine(const json& strategy_config, LiveEngineOptions options)
+        : options_(options), events_(options.input_capacity), signals_(options.output_capacity)
+    {
+        std::unique_ptr<strategy_engine::IStrategy> prototype;
+        try {
+            prototype = strategy_engine::StrategyFactory::createStrategy(strategy_config);
+        } catch (const std::exception& e) {
+            throw core::ConfigException(std::string("Live engine: invalid strategy config: ") + e.what());
+        }
+        if (!prototype) throw core::ConfigException("Live engine: failed to create strategy from config.");
+
+        const auto& timeframes = prototype->getRequiredTimeframes();
+        if (timeframes.empty()) throw core::ConfigException("Live engine: strategy requires no timeframes.");
+        timeframe_ = timeframes.front();
+
+        instrument_keys_ = prototype->getRequiredInstruments();
+        if (instrument_keys_.empty()) throw core::ConfigException("Live engine: strategy has no instruments.");
+
+        const auto& indicator_names = prototype->getRequiredIndicatorNames();
+        for (const auto& name : indicator_names) {
+            const auto ref = strategy_engine::splitIndicatorTimeframe(name);
+            if (!ref.timeframe.empty() && ref.timeframe != timeframe_) {
+                throw core::ConfigException("Live engine: indicator '" + name +
+                                            "' is on another timeframe; only base-timeframe indicators are supported.");
+            }
+            if (!createStreamingIndicator(ref.spec)) {
+                throw core::ConfigException("Live engine: no streaming implementation for indicator '" + name + "'.");
+            }
+        }
+
+        // One strategy instance (position state) and indicator set per instrument
+        states_.resize(instrument_keys_.size());
+        for (std::size_t i = 0; i < instrument_keys_.size(); ++i) {
+            instrument_ids_.emplace(instrument_keys_[i], static_cast<InstrumentId>(i));
+            InstrumentState& state = states_[i];
+            state.strategy = (i == 0) ? std::move(prototype) : strategy_engine::StrategyFactory::createStrategy(strategy_config);
+            if (!state.strategy) {
+                throw core::ConfigException("Live engine: failed to create strategy instance for " + instrument_keys_[i] + ".");
+            }
+            for (const auto& name : indicator_names) {
+                state.indicators.push_back(createStreamingIndicator(strategy_engine::splitIndicatorTimeframe(name).spec));
+            }
+            state.current_values.assign(indicator_names.size(), strategy_engine::kMissingIndicatorValue);
+            state.previous_values.assign(indicator_names.size(), strategy_engine::kMissingIndicatorValue);
+        }
+
+        core::logging::getLogger()->info("Live engine ready: strategy '{}' on {} instrument(s), {} indicator(s), timeframe {}.",
+                                         states_.front().strategy->getName(), states_.size(), indicator_names.size(), timeframe_);
+    }
+
+    LiveSignalEngine::~LiveSignalEngine() {
+        stop();
+    }
+
+    std::optional<InstrumentId> LiveSignalEngine::findInstrument(const std::string& instrument_key) const {
+        auto it = instrument_ids_.find(instrument_key);
+        if (it == instrument_ids_.end()) return std::nullopt;
+        return it->second;
+    }
+
+    void LiveSignalEngine::warmUp(InstrumentId instrument, const core::CandleSeries& history) {
+        if (isRunning()) throw std::logic_error("LiveSignalEngine::warmUp() called while running.");
+        if (instrument >= states_.size()) throw std::invalid_argument("LiveSignalEngine::warmUp(): unknown instrument id.");
+        InstrumentState& state = states_[instrument];
+        for (std::size_t i = 0; i < history.size(); ++i) advanceIndicators(state, history.at(i));
+        core::logging::getLogger()->info("Warmed up {} with {} bars.", instrument_keys_[instrument], history.size());
+    }
+
+    void LiveSignalEngine::start() {
+        if (isRunning()) return;
+        stopping_.store(false, std::memory_order_relaxed);
+        histogram_handoff_.open();
+        worker_ = std::thread([this]() {
+            if (options_.worker_cpu >= 0) pinCurrentThread(options_.worker_cpu);
+            workerLoop();
+        });
+    }
+
+    void LiveSignalEngine::stop() {
+        if (!isRunning()) return;
+        stopping_.store(true, std::memory_order_release);
+        worker_.join();
+        worker_ = std::thread();
+    }
+
+    bool LiveSignalEngine::publish(InstrumentId instrument, const core::Candle& bar, std::int64_t received_ns) {
+        if (instrument >= states_.size()) throw std::invalid_argument("LiveSignalEngine::publish(): unknown instrument id.");
+        MarketDataEvent event;
+        event.instrument = instrument;
+        event.bar = bar;
+        event.published_ns = nowNanos();
+        event.ingest_ns = received_ns > 0 ? received_ns : event.published_ns;
+        if (events_.tryPush(event)) return true;
+        input_dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    void LiveSignalEngine::workerLoop() {
+        MarketDataEvent event;
+        for (;;) {
+            histogram_handoff_.serve([this](LiveEngineStats& stats) { copyHistograms(stats); });
+            if (events_.tryPop(event)) {
+                process(event);
+                continue;
+            }
+            if (stopping_.load(std::memory_order_acquire)) {
+                // Bars published before stop() are still processed
+                while (events_.tryPop(event)) process(event);
+                histogram_handoff_.close();
+                return;
+            }
+            if (options_.busy_poll) {
+                cpuRelax();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void LiveSignalEngine::advanceIndicators(InstrumentState& state, const core::Candle& bar) {
+        // Same roll as Backtester::evaluateBar: previous = the value one bar back
+        state.previous_values.swap(state.current_values);
+        for (std::size_t slot = 0; slot < state.indicators.size(); ++slot) {
+            state.current_values[slot] = state.indicators[slot]->update(bar);
+        }
+        if (state.has_current) state.previous_candle = state.current_candle;
+        state.current_candle = bar;
+        state.has_current = true;
+    }
+
+    void LiveSignalEngine::process(const MarketDataEvent& event) {
+        InstrumentState& state = states_[event.instrument];
+        const std::int64_t evaluation_start = nowNanos();
+
+        const bool has_previous = state.has_current;
+        advanceIndicators(state, event.bar);
+        const std::int64_t indicators_done = nowNanos();
+
+        strategy_engine::MarketDataSnapshot snapshot;
+        snapshot.current_time = state.current_candle.timestamp;
+        snapshot.current_candle = &state.current_candle;
+        snapshot.previous_candle = has_previous ? &state.previous_candle : nullptr;
+        snapshot.indicator_values = state.current_values;
+        snapshot.indicator_values_prev = state.previous_values;
+        const core::SignalAction action = state.strategy->evaluate(snapshot);
+
+        const std::int64_t decided = nowNanos();
+        const std::int64_t evaluation_ns = decided - evaluation_start;
+        evaluation_.record(evaluation_ns);
+        tick_to_signal_.record(decided - event.ingest_ns);
+        queue_wait_.record(evaluation_start - event.published_ns);
+        indicators_.record(indicators_done - evaluation_start);
+        strategy_.record(decided - indicators_done);
+        if (evaluation_ns > options_.evaluation_budget_ns) over_budget_.fetch_add(1, std::memory_order_relaxed);
+        bars_processed_.fetch_add(1, std::memory_order_relaxed);
+
+        if (action == core::SignalAction::None) return;
+        TP_LOG_DEBUG("Live signal {} for {} at {:.2f}", static_cast<int>(action), instrument_keys_[event.instrument],
+                     state.current_candle.close);
+
+        LiveSignal signal;
+        signal.instrument = event.instrument;
+        signal.bar_time = state.current_candle.timestamp;
+        signal.action = action;
+        signal.price = state.current_candle.close;
+        signal.ingest_ns = event.ingest_ns;
+        signal.signal_ns = decided;
+        if (signals_.tryPush(signal)) {
+            signals_emitted_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            output_dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    LiveEngineStats LiveSignalEngine::stats() const {
+        // The worker records histograms without locks; while it runs, it makes the copy itself
+        LiveEngineStats stats;
+        if (auto served = histogram_handoff_.request()) {
+            stats = std::move(*served);
+        } else {
+            copyHistograms(stats); // Not running: nothing writes them
+        }
+        stats.bars_processed = bars_processed_.load(std::memory_order_relaxed);
+        stats.signals = signals_emitted_.load(std::memory_order_relaxed);
+        stats.input_dropped = input_dropped_.load(std::memory_order_relaxed);
+        stats.output_dropped = output_dropped_.load(std::memory_order_relaxed);
+        stats.over_budget = over_budget_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    void LiveSignalEngine::copyHistograms(LiveEngineStats& stats) const {
+        stats.tick_to_signal = tick_to_signal_;
+        stats.evaluation = evaluation_;
+        stats.queue_wait = queue_wait_;
+        stats.indicators = indicators_;
+        stats.strategy = strategy_;
+    }
+
+    void LiveSignalEngine::logLatencyReport() const {
+        auto logger = core::logging::getLogger();
+        const LiveEngineStats s = stats();
+        logger->info("--- Live Engine Latency ---");
+        logger->info("Bars: {}, signals: {}, dropped in/out: {}/{}", s.bars_processed, s.signals,
+                     s.input_dropped, s.output_dropped);
+        logger->info("tick-to-signal  {}", s.tick_to_signal.summary());
+        logger->info("  queue wait    {}", s.queue_wait.summary());
+        logger->info("  indicators    {}", s.indicators.summary());
+        logger->info("  strategy      {}", s.strategy.summary());
+        logger->info("evaluation      {}", s.evaluation.summary());
+        logger->info("Over the {:.0f}us evaluation budget: {} bar(s)",
+                     static_cast<double>(options_.evaluation_budget_ns) / 1e3, s.over_budget);
+        logger->info("---------------------------");
+    }
+
+} // namespace live
@@ -0,0 +1,436 @@
+#include "order_gateway.hpp"
+#include "exceptions.hpp"
+#include "logging.hpp"
+#include "strategy_factory.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <utility>
+
+namespace live {
+
+    namespace { // File-local helpers
+
+        inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#endif
+        }
+
+        long long signedQuantity(const OrderRequest& order) {
+            return order.side == OrderSide::Buy ? order.quantity : -order.quantity;
+        }
+
+        const char* sideName(const OrderRequest& order) {
+            return order.side == OrderSide::Buy ? "BUY" : "SELL";
+        }
+
+        nlohmann::json histogramJson(const core::LatencyHistogram& histogram) {
+            return {
+                {"count", histogram.count()},
+                {"mean", histogram.mean()},
+                {"min", histogram.min()},
+                {"p50", histogram.percentile(50.0)},
+                {"p90", histogram.percentile(90.0)},
+                {"p99", histogram.percentile(99.0)},
+                {"p99_9", histogram.percentile(99.9)},
+                {"max", histogram.max()},
+            };
+        }
+
+    } // end anonymous namespace
+
+    // --- PreTradeRiskLimits ---
+
+    PreTradeRiskLimits::PreTradeRiskLimits(std::size_t instrument_count)
+        : positions_(std::make_unique<std::atomic<long long>[]>(instrument_count)),
+          instrument_count_(instrument_count)
+    {
+        for (std::size_t i = 0; i < instrument_count_; ++i) positions_[i].store(0, std::memory_order_relaxed);
+    }
+
+    const char* PreTradeRiskLimits::admit(const OrderRequest& order) {
+        if (order.instrument >= instrument_count_) return "unknown instrument";
+        if (!trading_enabled_.load(std::memory_order_relaxed)) return "trading disabled";
+        if (order.quantity <= 0) return "non-positive quantity";
+
+        const long long max_quantity = max_order_quantity_.load(std::memory_order_relaxed);
+        if (max_quantity > 0 && order.quantity > max_quantity) return "max order quantity";
+
+        const double max_notional = max_order_notional_.load(std::memory_order_relaxed);
+        if (max_notional > 0.0 && static_cast<double>(order.quantity) * order.reference_price > max_notional) {
+            return "max order notional";
+        }
+
+        // Orders that reduce the absolute position are always within the position limit
+        const long long current = positions_[order.instrument].load(std::memory_order_relaxed);
+        const long long projected = current + signedQuantity(order);
+        const long long max_position = max_position_.load(std::memory_order_relaxed);
+        if (max_position > 0 && std::llabs(projected) > max_position && std::llabs(projected) > std::llabs(current)) {
+            return "max position";
+        }
+
+        const std::uint32_t max_open = max_open_orders_.load(std::memory_order_relaxed);
+        if (max_open > 0 && open_orders_.load(std::memory_order_relaxed) >= max_open) return "max open orders";
+
+        positions_[order.instrument].store(projected, std::memory_order_relaxed);
+        open_orders_.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    void PreTradeRiskLimits::complete(const OrderRequest& order, bool accepted) {
+        if (order.instrument >= instrument_count_) return;
+        if (!accepted) positions_[order.instrument].fetch_sub(signedQuantity(order), std::memory_order_relaxed);
+        open_orders_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // --- OrderSizing ---
+
+    long long OrderSizing::quantityFor(double price) const {
+        if (method == strategy_engine::SizingMethod::Quantity) return static_cast<long long>(value);
+        const double allocation = percentage ? capital * (value / 100.0) : value;
+        if (price <= 1e-9) return 0;
+        return static_cast<long long>(std::floor(allocation / price));
+    }
+
+    OrderSizing OrderSizing::fromStrategy(const nlohmann::json& strategy_config, double capital) {
+        std::unique_ptr<strategy_engine::IStrategy> strategy;
+        try {
+            strategy = strategy_engine::StrategyFactory::createStrategy(strategy_config);
+        } catch (const std::exception& e) {
+            throw core::ConfigException(std::string("Order gateway: invalid strategy config: ") + e.what());
+        }
+        if (!strategy) throw core::ConfigException("Order gateway: failed to create strategy from config.");
+
+        OrderSizing sizing;
+        sizing.method = strategy->getSizingMethod();
+        sizing.value = strategy->getSizingValue();
+        sizing.percentage = strategy->isSizingValuePercentage();
+        sizing.capital = capital;
+        return sizing;
+    }
+
+    // --- OrderGateway ---
+
+    OrderGateway::OrderGateway(LiveSignalEngine& engine, IOrderTransport& transport, OrderGatewayOptions options)
+        : engine_(engine), transport_(transport), options_(options),
+          risk_(engine.instruments().size()), unresolved_per_instrument_(engine.instruments().size(), 0),
+          inbox_(std::make_shared<CompletionInbox>()) {}
+
+    OrderGateway::~OrderGateway() {
+        stop();
+    }
+
+    void OrderGateway::start() {
+        if (thread_.joinable()) return;
+        stopping_.store(false, std::memory_order_relaxed);
+        histogram_handoff_.open();
+        thread_ = std::thread([this] { run(); });
+    }
+
+    void OrderGateway::stop(int drain_timeout_ms) {
+        if (!thread_.joinable()) return;
+        drain_timeout_ms_.store(drain_timeout_ms, std::memory_order_relaxed);
+        stopping_.store(true, std::memory_order_release);
+        thread_.join();
+    }
+
+    void OrderGateway::run() {
+        std::vector<LiveSignal> signals;
+        signals.reserve(256);
+        auto drainSignals = [&] {
+            LiveSignal signal;
+            while (engine_.pollSignal(signal)) signals.push_back(signal);
+            if (signals.empty()) return false;
+            routeSignals(signals);
+            signals.clear();
+            return true;
+        };
+        auto serveStats = [this] {
+            histogram_handoff_.serve([this](OrderGatewayStats& stats) { copyHistograms(stats); });
+        };
+
+        while (!stopping_.load(std::memory_order_acquire)) {
+            serveStats();
+            const bool routed = drainSignals();
+            if (inbox_->pending.load(std::memory_order_acquire) > 0) drainCompletions();
+            if (!unresolved_.empty()) reconcileDue();
+            if (!routed) {
+                if (options_.busy_poll) cpuRelax();
+                else std::this_thread::yield();
+            }
+        }
+
+        // Signals queued before stop(), then the broker's answers to everything sent
+        drainSignals();
+        const auto deadline = std::chrono::steady_clock::now() +
+                              std::chrono::milliseconds(drain_timeout_ms_.load(std::memory_order_relaxed));
+        drainCompletions();
+        while ((!in_flight_.empty() || !unresolved_.empty()) && std::chrono::steady_clock::now() < deadline) {
+            serveStats();
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            drainCompletions();
+            reconcileDue();
+        }
+        histogram_handoff_.close();
+        auto logger = core::logging::getLogger();
+        if (!in_flight_.empty()) {
+            logger->warn("Order gateway stopped with {} order(s) still awaiting a broker response.", in_flight_.size());
+        }
+        for (const auto& [id, unresolved] : unresolved_) {
+            logger->error("Order gateway stopped with order {} ({} {} x{}) of unknown outcome: check the broker's order book.",
+                          id, unresolved.order.instrument_key, sideName(unresolved.order), unresolved.order.quantity);
+        }
+    }
+
+    long long OrderGateway::applySignal(long long position, const LiveSignal& signal) const {
+        switch (signal.action) {
+            case core::SignalAction::EnterLong:
+                return position == 0 ? options_.sizing.quantityFor(signal.price) : position;
+            case core::SignalAction::EnterShort:
+                return position == 0 ? -options_.sizing.quantityFor(signal.price) : position;
+            case core::SignalAction::ExitLong:
+                return position > 0 ? 0 : position;
+            case core::SignalAction::ExitShort:
+                return position < 0 ? 0 : position;
+            default:
+                return position;
+        }
+    }
+
+    void OrderGateway::routeSignals(std::vector<LiveSignal>& signals) {
+        auto logger = core::logging::getLogger();
+        signals_.fetch_add(signals.size(), std::memory_order_relaxed);
+
+        // Group by (instrument, bar); the sort is stable so a tick's signals keep their order
+        std::stable_sort(signals.begin(), signals.end(), [](const LiveSignal& a, const LiveSignal& b) {
+            if (a.instrument != b.instrument) return a.instrument < b.instrument;
+            return a.bar_time < b.bar_time;
+        });
+
+        std::vector<OrderRequest> batch;
+        const auto& keys = engine_.instruments();
+        for (std::size_t begin = 0; begin < signals.size();) {
+            std::size_t end = begin + 1;
+            while (end < signals.size() && signals[end].instrument == signals[begin].instrument &&
+                   signals[end].bar_time == signals[begin].bar_time) {
+                ++end;
+            }
+            const LiveSignal& first = signals[begin];
+            const long long position = risk_.projectedPosition(first.instrument);
+            long long target = position;
+            std::int64_t signal_ns = first.signal_ns;
+            for (std::size_t i = begin; i < end; ++i) {
+                target = applySignal(target, signals[i]);
+                signal_ns = std::min(signal_ns, signals[i].signal_ns);
+            }
+            const LiveSignal& last = signals[end - 1];
+            begin = end;
+
+            const long long delta = target - position;
+            if (delta == 0) {
+                orders_netted_out_.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            if (unresolved_per_instrument_[first.instrument] > 0) {
+                // The position depends on an order the broker has not confirmed either way
+                blocked_.fetch_add(1, std::memory_order_relaxed);
+                logger->warn("Order gateway: {} signal at {} dropped, an earlier order's outcome is unknown.",
+                             keys[first.instrument], core::utils::timestampToString(last.bar_time));
+                continue;
+            }
+
+            OrderRequest order;
+            order.client_order_id = next_order_id_++;
+            order.instrument = first.instrument;
+            order.instrument_key = keys[first.instrument];
+            order.side = delta > 0 ? OrderSide::Buy : OrderSide::Sell;
+            order.quantity = std::llabs(delta);
+            order.reference_price = last.price;
+            order.bar_time = last.bar_time;
+            order.signal_ns = signal_ns;
+
+            if (const char* reason = risk_.admit(order)) {
+                risk_rejected_.fetch_add(1, std::memory_order_relaxed);
+                logger->warn("Order gateway: {} {} x{} refused by pre-trade risk: {}.", order.instrument_key,
+                             sideName(order), order.quantity, reason);
+                continue;
+            }
+            batch.push_back(std::move(order));
+        }
+        if (batch.empty()) return;
+
+        const std::int64_t submit_ns = nowNanos();
+        for (auto& order : batch) {
+            order.submit_ns = submit_ns;
+            signal_to_submit_.record(submit_ns - order.signal_ns);
+            in_flight_.emplace(order.client_order_id, order);
+        }
+        orders_submitted_.fetch_add(batch.size(), std::memory_order_relaxed);
+        transport_.submitAsync(std::move(batch), completionSink());
+    }
+
+    IOrderTransport::Completion OrderGateway::completionSink() const {
+        std::shared_ptr<CompletionInbox> inbox = inbox_;
+        return [inbox](const OrderResult& result) {
+            std::lock_guard<std::mutex> lock(inbox->mutex);
+            inbox->results.push_back(result);
+            inbox->pending.store(inbox->results.size(), std::memory_order_release);
+        };
+    }
+
+    void OrderGateway::drainCompletions() {
+        std::vector<OrderResult> results;
+        {
+            std::lock_guard<std::mutex> lock(inbox_->mutex);
+            results.swap(inbox_->results);
+            inbox_->pending.store(0, std::memory_order_relaxed);
+        }
+        for (const OrderResult& result : results) {
+            if (const auto it = in_flight_.find(result.client_order_id); it != in_flight_.end()) {
+                const OrderRequest& order = it->second;
+                const std::int64_t completed_ns = result.completed_ns > 0 ? result.completed_ns : nowNanos();
+                submit_to_ack_.record(completed_ns - order.submit_ns);
+                signal_to_ack_.record(completed_ns - order.signal_ns);
+                if (result.outcome == OrderOutcome::Unknown) markUnresolved(order, result.error);
+                else resolve(order, result);
+                in_flight_.erase(it);
+                continue;
+            }
+            const auto unresolved = unresolved_.find(result.client_order_id);
+            if (unresolved == unresolved_.end()) {
+                core::logging::getLogger()->warn("Order gateway: response for unknown order {}.", result.client_order_id);
+                continue;
+            }
+            if (result.outcome == OrderOutcome::Unknown) {
+                // Ask again later
+                unresolved->second.next_lookup_ns = nowNanos() + std::int64_t{options_.reconcile_interval_ms} * 1'000'000;
+                continue;
+            }
+            const OrderRequest order = unresolved->second.order;
+            unresolved_.erase(unresolved);
+            unresolved_count_.store(unresolved_.size(), std::memory_order_relaxed);
+            --unresolved_per_instrument_[order.instrument];
+            core::logging::getLogger()->info("Order gateway: order {} ({}) reconciled as {}.", order.client_order_id,
+                                             order.instrument_key, result.outcome == OrderOutcome::Accepted ? "accepted" : "rejected");
+            resolve(order, result);
+        }
+    }
+
+    void OrderGateway::resolve(const OrderRequest& order, const OrderResult& result) {
+        const bool accepted = result.outcome == OrderOutcome::Accepted;
+        risk_.complete(order, accepted);
+        if (accepted) {
+            broker_accepted_.fetch_add(1, std::memory_order_relaxed);
+            TP_LOG_DEBUG("Order gateway: order {} ({}) accepted as '{}'.", order.client_order_id,
+                         order.instrument_key, result.broker_order_id);
+        } else {
+            broker_rejected_.fetch_add(1, std::memory_order_relaxed);
+            core::logging::getLogger()->error("Order gateway: {} {} x{} rejected: {}", order.instrument_key,
+                                              sideName(order), order.quantity, result.error);
+        }
+    }
+
+    void OrderGateway::markUnresolved(const OrderRequest& order, const std::string& reason) {
+        // Its reservation stays until the broker's order book says what happened
+        UnresolvedOrder unresolved;
+        unresolved.order = order;
+        unresolved.next_lookup_ns = nowNanos() + std::int64_t{options_.reconcile_interval_ms} * 1'000'000;
+        unresolved_.emplace(order.client_order_id, std::move(unresolved));
+        unresolved_count_.store(unresolved_.size(), std::memory_order_relaxed);
+        ++unresolved_per_instrument_[order.instrument];
+        broker_unknown_.fetch_add(1, std::memory_order_relaxed);
+        core::logging::getLogger()->error("Order gateway: {} {} x{} outcome unknown ({}); no new {} orders until it is reconciled.",
+                                          order.instrument_key, sideName(order), order.quantity, reason, order.instrument_key);
+    }
+
+    void OrderGateway::reconcileDue() {
+        const std::int64_t now = nowNanos();
+        std::vector<OrderRequest> due;
+        for (auto& [id, unresolved] : unresolved_) {
+            if (unresolved.next_lookup_ns == 0 || unresolved.next_lookup_ns > now) continue;
+            due.push_back(unresolved.order);
+            unresolved.next_lookup_ns = 0;
+        }
+        if (!due.empty()) transport_.reconcileAsync(std::move(due), completionSink());
+    }
+
+    OrderGatewayStats OrderGateway::stats() const {
+        // The gateway thread records histograms without locks; while it runs, it makes the copy itself
+        OrderGatewayStats s;
+        if (auto served = histogram_handoff_.request()) {
+            s = std::move(*served);
+        } else {
+            copyHistograms(s); // Not running: nothing writes them
+        }
+        s.signals = signals_.load(std::memory_order_relaxed);
+        s.orders_submitted = orders_submitted_.load(std::memory_order_relaxed);
+        s.orders_netted_out = orders_netted_out_.load(std::memory_order_relaxed);
+        s.risk_rejected = risk_rejected_.load(std::memory_order_relaxed);
+        s.blocked = blocked_.load(std::memory_order_relaxed);
+        s.broker_accepted = broker_accepted_.load(std::memory_order_relaxed);
+        s.broker_rejected = broker_rejected_.load(std::memory_order_relaxed);
+        s.broker_unknown = broker_unknown_.load(std::memory_order_relaxed);
+        s.unresolved = unresolved_count_.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    void OrderGateway::copyHistograms(OrderGatewayStats& stats) const {
+        stats.signal_to_submit = signal_to_submit_;
+        stats.submit_to_ack = submit_to_ack_;
+        stats.signal_to_ack = signal_to_ack_;
+    }
+
+    void OrderGateway::logLatencyReport() const {
+        auto logger = core::logging::getLogger();
+        const OrderGatewayStats s = stats();
+        logger->info("--- Order Gateway Latency ---");
+        logger->info("Signals: {}, orders: {}, netted out: {}, risk rejected: {}, blocked: {}", s.signals, s.orders_submitted,
+                     s.orders_netted_out, s.risk_rejected, s.blocked);
+        logger->info("Broker accepted/rejected/unknown: {}/{}/{} ({} still unresolved)", s.broker_accepted, s.broker_rejected,
+                     s.broker_unknown, s.unresolved);
+        logger->info("signal-to-submit {}", s.signal_to_submit.summary());
+        logger->info("submit-to-ack    {}", s.submit_to_ack.summary());
+        logger->info("signal-to-ack    {}", s.signal_to_ack.summary());
+        logger->info("-----------------------------");
+    }
+
+    nlohmann::json OrderGateway::latencyJson() const {
+        const OrderGatewayStats s = stats();
+        return {
+            {"signals", s.signals},
+            {"orders_submitted", s.orders_submitted},
+            {"orders_netted_out", s.orders_netted_out},
+            {"risk_rejected", s.risk_rejected},
+            {"blocked", s.blocked},
+            {"broker_accepted", s.broker_accepted},
+            {"broker_rejected", s.broker_rejected},
+            {"broker_unknown", s.broker_unknown},
+            {"unresolved", s.unresolved},
+            {"latency_ns", {
+                {"signal_to_submit", histogramJson(s.signal_to_submit)},
+                {"submit_to_ack", histogramJson(s.submit_to_ack)},
+                {"signal_to_ack", histogramJson(s.signal_to_ack)},
+            }},
+        };
+    }
+
+    bool OrderGateway::writeLatencyJson(const std::string& path) const {
+        std::ofstream out(path);
+        if (!out) {
+            core::logging::getLogger()->error("Cannot open '{}' for the order latency report.", path);
+            return false;
+        }
+        out << latencyJson().dump(2) << '\n';
+        if (!out) {
+            core::logging::getLogger()->error("Failed writing order latency report '{}'.", path);
+            return false;
+        }
+        return true;
+    }
+
+} // namespace live
@@ -0,0 +1,265 @@
+#include "replay_harness.hpp"
+#include "exceptions.hpp"
+#include "logging.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <system_error>
+#include <thread>
+
+namespace live {
+
+    namespace { // File-local helpers
+
+        constexpr std::uint64_t kFnvOffset = 1469598103934665603ULL;
+        constexpr std::uint64_t kFnvPrime = 1099511628211ULL;
+
+        template <typename T>
+        void fnvMix(std::uint64_t& hash, const T& value) {
+            const auto* bytes = reinterpret_cast<const unsigned char*>(&value);
+            for (std::size_t i = 0; i < sizeof(T); ++i) {
+                hash ^= bytes[i];
+                hash *= kFnvPrime;
+            }
+        }
+
+        nlohmann::json histogramJson(const core::LatencyHistogram& histogram) {
+            return {
+                {"count", histogram.count()},
+                {"mean", histogram.mean()},
+                {"min", histogram.min()},
+                {"p50", histogram.percentile(50.0)},
+                {"p90", histogram.percentile(90.0)},
+                {"p99", histogram.percentile(99.0)},
+                {"p99_9", histogram.percentile(99.9)},
+                {"max", histogram.max()},
+            };
+        }
+
+        // Sleeps most of the way, then yields, so paced replays hit their send times closely
+        void waitUntil(std::int64_t target_ns) {
+            for (;;) {
+                const std::int64_t remaining = target_ns - nowNanos();
+                if (remaining <= 0) return;
+                if (remaining > 2'000'000) {
+                    std::this_thread::sleep_for(std::chrono::nanoseconds(remaining - 1'000'000));
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+    } // end anonymous namespace
+
+    const std::vector<std::string>& ReplayHarness::stageNames() {
+        static const std::vector<std::string> names = {
+            "decode", "bar_assembly", "queue_wait", "indicators", "evaluate", "signal_out", "tick_to_signal", "end_to_end",
+        };
+        return names;
+    }
+
+    ReplayHarness::ReplayHarness(LiveSignalEngine& engine, ReplayOptions options)
+        : engine_(engine), options_(std::move(options))
+    {
+        const auto& names = stageNames();
+        for (const auto& [stage, limit] : options_.max_p99_ns) {
+            if (std::find(names.begin(), names.end(), stage) == names.end()) {
+                throw core::ConfigException("Replay: p99 limit for unknown stage '" + stage + "'.");
+            }
+            if (limit <= 0) throw core::ConfigException("Replay: p99 limit for '" + stage + "' must be positive.");
+        }
+    }
+
+    ReplayReport ReplayHarness::run(const FeedRecording& recording) {
+        auto logger = core::logging::getLogger();
+        UpstoxMarketFeed feed(engine_, options_.feed); // Driven from here, never started
+
+        // Consumer: what an order gateway would see
+        core::LatencyHistogram signal_out, end_to_end;
+        std::uint64_t checksum = kFnvOffset;
+        std::uint64_t signals = 0;
+        std::atomic<bool> engine_stopped{false};
+        auto consume = [&](const LiveSignal& signal) {
+            const std::int64_t now = nowNanos();
+            signal_out.record(now - signal.signal_ns);
+            end_to_end.record(now - signal.ingest_ns);
+            fnvMix(checksum, signal.instrument);
+            fnvMix(checksum, core::utils::timestampToEpochNanos(signal.bar_time));
+            fnvMix(checksum, static_cast<int>(signal.action));
+            ++signals;
+        };
+
+        engine_.start();
+        std::thread consumer([&] {
+            LiveSignal signal;
+            for (;;) {
+                if (engine_.pollSignal(signal)) {
+                    consume(signal);
+                    continue;
+                }
+                if (engine_stopped.load(std::memory_order_acquire)) {
+                    while (engine_.pollSignal(signal)) consume(signal);
+                    return;
+                }
+                std::this_thread::yield();
+            }
+        });
+
+        logger->info("Replaying {} feed message(s) ({} bytes) at {}", recording.size(), recording.bytes(),
+                     options_.speed > 0.0 ? fmt::format("{}x", options_.speed) : std::string("maximum speed"));
+        const std::int64_t wall_start = nowNanos();
+        const std::int64_t source_start = recording.empty() ? 0 : recording.timeNs(0);
+        const std::int64_t check_interval_ns = static_cast<std::int64_t>(options_.feed.read_timeout_ms) * 1'000'000;
+        std::int64_t last_check = source_start;
+        for (std::size_t i = 0; i < recording.size(); ++i) {
+            const std::int64_t source_ns = recording.timeNs(i);
+            if (options_.speed > 0.0) {
+                waitUntil(wall_start + static_cast<std::int64_t>(static_cast<double>(source_ns - source_start) / options_.speed));
+            }
+            // Back-pressure instead of drops, so max-speed runs stay deterministic
+            if (options_.max_queue_depth > 0) {
+                while (engine_.inputQueueDepth() >= options_.max_queue_depth) std::this_thread::yield();
+            }
+            feed.processMessage(recording.message(i), nowNanos());
+            if (source_ns - last_check >= check_interval_ns) {
+                feed.closeBars(source_ns);
+                last_check = source_ns;
+            }
+        }
+        feed.closeBars(std::numeric_limits<std::int64_t>::max()); // The recording is over: every bar is complete
+        engine_.stop();
+        engine_stopped.store(true, std::memory_order_release);
+        consumer.join();
+        const std::int64_t wall_ns = nowNanos() - wall_start;
+
+        const UpstoxFeedStats feed_stats = feed.stats();
+        const LiveEngineStats engine_stats = engine_.stats();
+        ReplayReport report;
+        report.messages = recording.size();
+        report.ticks = feed_stats.ticks;
+        report.bars = engine_stats.bars_processed;
+        report.signals = signals;
+        report.dropped = feed_stats.bars_dropped + engine_stats.output_dropped;
+        if (recording.size() > 1) {
+            report.source_seconds = static_cast<double>(recording.timeNs(recording.size() - 1) - source_start) / 1e9;
+        }
+        report.wall_seconds = static_cast<double>(wall_ns) / 1e9;
+        if (wall_ns > 0) report.messages_per_second = static_cast<double>(report.messages) * 1e9 / static_cast<double>(wall_ns);
+        report.signal_checksum = checksum;
+
+        const core::LatencyHistogram* histograms[] = {
+            &feed_stats.decode, &feed_stats.assembly, &engine_stats.queue_wait, &engine_stats.indicators,
+            &engine_stats.strategy, &signal_out, &engine_stats.tick_to_signal, &end_to_end,
+        };
+        const auto& names = stageNames();
+        for (std::size_t i = 0; i < names.size(); ++i) {
+            ReplayStage stage;
+            stage.name = names[i];
+            stage.histogram = *histograms[i];
+            if (const auto limit = options_.max_p99_ns.find(stage.name); limit != options_.max_p99_ns.end()) {
+                stage.max_p99_ns = limit->second;
+                const std::int64_t p99 = stage.histogram.percentile(99.0);
+                if (stage.histogram.count() > 0 && p99 > stage.max_p99_ns) {
+                    report.failures.push_back(fmt::format("{} p99 {:.2f}us is over the {:.2f}us limit", stage.name,
+                                                          static_cast<double>(p99) / 1e3,
+                                                          static_cast<double>(stage.max_p99_ns) / 1e3));
+                }
+            }
+            report.stages.push_back(std::move(stage));
+        }
+        if (report.dropped > 0) {
+            logger->warn("Replay dropped {} bar(s)/signal(s) on full engine queues; the signal checksum is not comparable.",
+                         report.dropped);
+        }
+        return report;
+    }
+
+    const ReplayStage* ReplayReport::stage(const std::string& name) const {
+        for (const auto& s : stages) {
+            if (s.name == name) return &s;
+        }
+        return nullptr;
+    }
+
+    void ReplayReport::log() const {
+        auto logger = core::logging::getLogger();
+        logger->info("--- Replay Latency ---");
+        logger->info("Messages: {} ({:.0f}/s over {:.2f}s, recording spans {:.0f}s), ticks: {}", messages,
+                     messages_per_second, wall_seconds, source_seconds, ticks);
+        logger->info("Bars: {}, signals: {}, dropped: {}, signal checksum: {:016x}", bars, signals, dropped,
+                     signal_checksum);
+        for (const auto& s : stages) {
+            if (s.max_p99_ns > 0) {
+                logger->info("{:<15} {} (p99 limit {:.2f}us)", s.name, s.histogram.summary(),
+                             static_cast<double>(s.max_p99_ns) / 1e3);
+            } else {
+                logger->info("{:<15} {}", s.name, s.histogram.summary());
+            }
+        }
+        for (const auto& failure : failures) logger->error("Replay threshold failed: {}", failure);
+        logger->info("----------------------");
+    }
+
+    nlohmann::json ReplayReport::toJson() const {
+        nlohmann::json latency = nlohmann::json::object();
+        for (const auto& s : stages) {
+            nlohmann::json stage_json = histogramJson(s.histogram);
+            if (s.max_p99_ns > 0) stage_json["max_p99"] = s.max_p99_ns;
+            latency[s.name] = std::move(stage_json);
+        }
+        return {
+            {"messages", messages},
+            {"ticks", ticks},
+            {"bars", bars},
+            {"signals", signals},
+            {"dropped", dropped},
+            {"source_seconds", source_seconds},
+            {"wall_seconds", wall_seconds},
+            {"messages_per_second", messages_per_second},
+            {"signal_checksum", fmt::format("{:016x}", signal_checksum)},
+            {"passed", passed()},
+            {"failures", failures},
+            {"latency_ns", std::move(latency)},
+        };
+    }
+
+    bool ReplayReport::writeJson(const std::string& path) const {
+        std::ofstream out(path);
+        if (!out) {
+            core::logging::getLogger()->error("Cannot open '{}' for the replay report.", path);
+            return false;
+        }
+        out << toJson().dump(2) << '\n';
+        if (!out) {
+            core::logging::getLogger()->error("Failed writing replay report '{}'.", path);
+            return false;
+        }
+        return true;
+    }
+
+    bool ReplayReport::writeHistograms(const std::string& directory) const {
+        auto logger = core::logging::getLogger();
+        std::error_code ec;
+        std::filesystem::create_directories(directory, ec);
+        if (ec) {
+            logger->error("Cannot create histogram directory '{}': {}", directory, ec.message());
+            return false;
+        }
+        for (const auto& s : stages) {
+            const std::string path = (std::filesystem::path(directory) / (s.name + ".hgrm")).string();
+            std::ofstream out(path);
+            out << s.histogram.percentileDistribution();
+            if (!out) {
+                logger->error("Failed writing latency histogram '{}'.", path);
+                return false;
+            }
+        }
+        return true;
+    }
+
+} // namespace live
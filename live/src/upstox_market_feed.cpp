@@ -0,0 +1,278 @@
+#include "upstox_market_feed.hpp"
+#include "exceptions.hpp"
+#include "logging.hpp"
+#include "upstox_api_client.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+namespace live {
+
+    namespace { // File-local helpers
+
+        std::int64_t wallClockNanos() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::system_clock::now().time_since_epoch()).count();
+        }
+
+    } // end anonymous namespace
+
+    UpstoxMarketFeed::UpstoxMarketFeed(LiveSignalEngine& engine, UpstoxMarketFeedOptions options)
+        : engine_(engine), options_(std::move(options)),
+          assembler_(engine.timeframe(), engine.instruments().size(), options_.sessions),
+          cursors_(engine.instruments().size())
+    {
+        const auto& keys = engine_.instruments();
+        for (std::size_t i = 0; i < keys.size(); ++i) instrument_ids_.emplace(keys[i], static_cast<InstrumentId>(i));
+        // Decoding only collects the ticks, so decode and bar assembly are timed apart
+        on_tick_ = [this](const data::UpstoxFeedTick& tick) { message_ticks_.push_back(tick); };
+    }
+
+    UpstoxMarketFeed::~UpstoxMarketFeed() {
+        stop();
+    }
+
+    std::string UpstoxMarketFeed::subscriptionRequest(const std::vector<std::string>& instrument_keys,
+                                                      const std::string& mode) {
+        static constexpr char kHex[] = "0123456789abcdef";
+        std::random_device random;
+        std::string guid(20, '0');
+        for (auto& c : guid) c = kHex[random() & 0xF];
+        const nlohmann::json request = {
+            {"guid", guid},
+            {"method", "sub"},
+            {"data", {{"mode", mode}, {"instrumentKeys", instrument_keys}}},
+        };
+        return request.dump();
+    }
+
+    void UpstoxMarketFeed::start() {
+        if (thread_.joinable()) return;
+        if (!options_.record_path.empty() && !recorder_) {
+            recorder_ = std::make_unique<FeedRecorder>(options_.record_path);
+            if (!recorder_->isOpen()) recorder_.reset(); // Logged; the feed runs without recording
+        }
+        stopping_.store(false, std::memory_order_relaxed);
+        started_ns_ = nowNanos();
+        thread_ = std::thread([this] { run(); });
+    }
+
+    void UpstoxMarketFeed::stop() {
+        if (!thread_.joinable()) return;
+        stopping_.store(true, std::memory_order_release);
+        thread_.join();
+        if (recorder_) recorder_->flush();
+    }
+
+    bool UpstoxMarketFeed::connect(data::WebSocketClient& socket) {
+        auto logger = core::logging::getLogger();
+        std::string url = options_.feed_url;
+        if (url.empty()) {
+            // The authorized URL is single-use, so every connect asks for a new one
+            data::UpstoxApiClient client("", "", "", options_.access_token);
+            auto authorized = client.authorizeMarketFeed();
+            if (!authorized) return false;
+            url = std::move(*authorized);
+        }
+        if (!socket.connect(url)) return false;
+        if (!socket.sendBinary(subscriptionRequest(engine_.instruments(), options_.mode))) {
+            logger->warn("Upstox feed: sending the subscription failed.");
+            return false;
+        }
+        logger->info("Upstox feed: connected, subscribed {} instrument(s) in '{}' mode.",
+                     engine_.instruments().size(), options_.mode);
+        return true;
+    }
+
+    void UpstoxMarketFeed::sleepBackoff(int milliseconds) {
+        const auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(milliseconds);
+        while (!stopping_.load(std::memory_order_acquire) && std::chrono::steady_clock::now() < until) {
+            closeQuietBars(); // Bars keep closing by the clock while disconnected
+            std::this_thread::sleep_for(std::chrono::milliseconds(std::min(options_.read_timeout_ms, milliseconds)));
+        }
+    }
+
+    void UpstoxMarketFeed::run() {
+        auto logger = core::logging::getLogger();
+        data::WebSocketClient socket(options_.websocket);
+        int backoff_ms = options_.reconnect_initial_ms;
+        std::int64_t last_log_ns = nowNanos();
+        std::uint64_t last_log_messages = 0;
+
+        while (!stopping_.load(std::memory_order_acquire)) {
+            if (!socket.isOpen()) {
+                if (!connect(socket)) {
+                    connect_failures_.fetch_add(1, std::memory_order_relaxed);
+                    logger->warn("Upstox feed: connect failed, retrying in {} ms.", backoff_ms);
+                    sleepBackoff(backoff_ms);
+                    backoff_ms = std::min(backoff_ms * 2, options_.reconnect_max_ms);
+                    continue;
+                }
+                connects_.fetch_add(1, std::memory_order_relaxed);
+                backoff_ms = options_.reconnect_initial_ms;
+            }
+
+            std::string_view message;
+            bool binary = false;
+            switch (socket.receive(message, binary, options_.read_timeout_ms)) {
+                case data::WebSocketClient::ReadStatus::Message:
+                    if (binary) {
+                        processMessage(message, nowNanos());
+                        if (recorder_) recorder_->write(wallClockNanos(), message);
+                    } else logger->debug("Upstox feed: text message: {}", message.substr(0, 200));
+                    break;
+                case data::WebSocketClient::ReadStatus::Timeout:
+                    break;
+                case data::WebSocketClient::ReadStatus::Closed:
+                    logger->warn("Upstox feed: connection lost, reconnecting.");
+                    break;
+            }
+            closeQuietBars();
+
+            if (options_.stats_interval_ms > 0) {
+                const std::int64_t now = nowNanos();
+                if (now - last_log_ns >= static_cast<std::int64_t>(options_.stats_interval_ms) * 1'000'000) {
+                    const std::uint64_t messages = messages_.load(std::memory_order_relaxed);
+                    logger->info("Upstox feed: {:.0f} msg/s, decode {}, engine queue {} (max {}), bars {}",
+                                 static_cast<double>(messages - last_log_messages) * 1e9 / static_cast<double>(now - last_log_ns),
+                                 decode_.summary(), queue_depth_.load(std::memory_order_relaxed),
+                                 max_queue_depth_.load(std::memory_order_relaxed),
+                                 bars_published_.load(std::memory_order_relaxed));
+                    last_log_ns = now;
+                    last_log_messages = messages;
+                }
+            }
+        }
+        socket.close();
+    }
+
+    void UpstoxMarketFeed::processMessage(std::string_view message, std::int64_t received_ns) {
+        messages_.fetch_add(1, std::memory_order_relaxed);
+        bytes_.fetch_add(message.size(), std::memory_order_relaxed);
+        message_ticks_.clear();
+        const data::UpstoxFeedDecodeResult result = data::decodeUpstoxFeed(message, on_tick_);
+        if (!result.ok) {
+            decode_errors_.fetch_add(1, std::memory_order_relaxed);
+            TP_LOG_DEBUG("Upstox feed: malformed message ({} bytes): {}", message.size(), result.error);
+        }
+        const std::int64_t decoded_ns = nowNanos();
+        decode_.record(decoded_ns - received_ns);
+
+        // The ticks' keys still point into 'message'
+        message_received_ns_ = received_ns;
+        for (const auto& tick : message_ticks_) onTick(tick);
+        assembly_.record(nowNanos() - decoded_ns);
+    }
+
+    void UpstoxMarketFeed::onTick(const data::UpstoxFeedTick& tick) {
+        ticks_.fetch_add(1, std::memory_order_relaxed);
+        const auto it = instrument_ids_.find(tick.instrument_key);
+        if (it == instrument_ids_.end()) {
+            unknown_instruments_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        const InstrumentId instrument = it->second;
+        TradeCursor& cursor = cursors_[instrument];
+
+        // Ordering: nothing older than, or repeating, the last trade applied
+        const bool has_volume_counter = tick.vtt >= 0;
+        if (tick.ltt_ms < cursor.ltt_ms ||
+            (tick.ltt_ms == cursor.ltt_ms &&
+             (has_volume_counter ? tick.vtt <= cursor.vtt : (tick.ltp == cursor.ltp && tick.ltq == cursor.ltq)))) {
+            stale_ticks_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        // Volume since the previous tick: from the day's traded volume when the mode
+        // sends it (a smaller value is a new session), otherwise the last trade size
+        long long quantity = tick.ltq;
+        if (has_volume_counter && cursor.vtt >= 0) {
+            quantity = tick.vtt >= cursor.vtt ? tick.vtt - cursor.vtt : tick.vtt;
+        }
+        cursor.ltt_ms = tick.ltt_ms;
+        if (has_volume_counter) cursor.vtt = tick.vtt;
+        cursor.ltp = tick.ltp;
+        cursor.ltq = tick.ltq;
+
+        std::optional<long long> open_interest;
+        if (tick.has_open_interest) open_interest = static_cast<long long>(tick.open_interest);
+        core::Candle completed;
+        switch (assembler_.addTrade(instrument, tick.ltt_ms * 1'000'000, tick.ltp, quantity, open_interest, completed)) {
+            case BarAssembler::TradeOutcome::Completed:
+                publish(instrument, completed, message_received_ns_);
+                break;
+            case BarAssembler::TradeOutcome::Late:
+                late_ticks_.fetch_add(1, std::memory_order_relaxed);
+                break;
+            case BarAssembler::TradeOutcome::Updated:
+                break;
+        }
+    }
+
+    void UpstoxMarketFeed::publish(InstrumentId instrument, const core::Candle& bar, std::int64_t received_ns) {
+        if (engine_.publish(instrument, bar, received_ns)) {
+            bars_published_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            bars_dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+        const std::size_t depth = engine_.inputQueueDepth();
+        queue_depth_.store(depth, std::memory_order_relaxed);
+        if (depth > max_queue_depth_.load(std::memory_order_relaxed)) {
+            max_queue_depth_.store(depth, std::memory_order_relaxed);
+        }
+    }
+
+    void UpstoxMarketFeed::closeQuietBars() {
+        closeBars(wallClockNanos());
+    }
+
+    void UpstoxMarketFeed::closeBars(std::int64_t now_ns) {
+        expired_.clear();
+        if (assembler_.closeExpired(now_ns, options_.bar_close_grace_ms * 1'000'000, expired_) == 0) return;
+        for (const auto& [instrument, bar] : expired_) publish(instrument, bar, 0); // Closed by the clock: ingested now
+    }
+
+    UpstoxFeedStats UpstoxMarketFeed::stats() const {
+        UpstoxFeedStats s;
+        s.messages = messages_.load(std::memory_order_relaxed);
+        s.bytes = bytes_.load(std::memory_order_relaxed);
+        s.ticks = ticks_.load(std::memory_order_relaxed);
+        s.decode_errors = decode_errors_.load(std::memory_order_relaxed);
+        s.unknown_instruments = unknown_instruments_.load(std::memory_order_relaxed);
+        s.stale_ticks = stale_ticks_.load(std::memory_order_relaxed);
+        s.late_ticks = late_ticks_.load(std::memory_order_relaxed);
+        s.bars_published = bars_published_.load(std::memory_order_relaxed);
+        s.bars_dropped = bars_dropped_.load(std::memory_order_relaxed);
+        s.connects = connects_.load(std::memory_order_relaxed);
+        s.connect_failures = connect_failures_.load(std::memory_order_relaxed);
+        if (started_ns_ > 0) {
+            const double elapsed_seconds = static_cast<double>(nowNanos() - started_ns_) / 1e9;
+            if (elapsed_seconds > 0.0) s.messages_per_second = static_cast<double>(s.messages) / elapsed_seconds;
+        }
+        s.queue_depth = queue_depth_.load(std::memory_order_relaxed);
+        s.max_queue_depth = max_queue_depth_.load(std::memory_order_relaxed);
+        s.decode = decode_;
+        s.assembly = assembly_;
+        return s;
+    }
+
+    void UpstoxMarketFeed::logStats() const {
+        auto logger = core::logging::getLogger();
+        const UpstoxFeedStats s = stats();
+        logger->info("--- Upstox Market Feed ---");
+        logger->info("Messages: {} ({:.0f}/s, {} bytes), ticks: {}, decode errors: {}", s.messages,
+                     s.messages_per_second, s.bytes, s.ticks, s.decode_errors);
+        logger->info("Ticks dropped: {} stale, {} late, {} unknown instrument", s.stale_ticks, s.late_ticks,
+                     s.unknown_instruments);
+        logger->info("Bars published: {}, dropped (engine queue full): {}", s.bars_published, s.bars_dropped);
+        logger->info("Connects: {}, failed: {}; engine queue depth {} (max {})", s.connects, s.connect_failures,
+                     s.queue_depth, s.max_queue_depth);
+        logger->info("decode          {}", s.decode.summary());
+        logger->info("bar assembly    {}", s.assembly.summary());
+        logger->info("--------------------------");
+    }
+
+} // namespace live
@@ -0,0 +1,293 @@
+#include "upstox_order_transport.hpp"
+#include "logging.hpp"
+
+#include <cpr/cpr.h>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+namespace live {
+
+    namespace { // File-local helpers
+
+        std::string toBase36(std::uint64_t value) {
+            static const char digits[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+            std::string text;
+            do {
+                text.insert(text.begin(), digits[value % 36]);
+                value /= 36;
+            } while (value > 0);
+            return text;
+        }
+
+        // Errors raised before the request could have left this host; anything else
+        // (timeouts, a connection lost while sending or receiving) may have placed the order
+        bool neverSent(cpr::ErrorCode code) {
+            switch (code) {
+                case cpr::ErrorCode::CONNECTION_FAILURE:
+                case cpr::ErrorCode::HOST_RESOLUTION_FAILURE:
+                case cpr::ErrorCode::PROXY_RESOLUTION_FAILURE:
+                case cpr::ErrorCode::SSL_CONNECT_ERROR:
+                case cpr::ErrorCode::SSL_CACERT_ERROR:
+                case cpr::ErrorCode::SSL_LOCAL_CERTIFICATE_ERROR:
+                case cpr::ErrorCode::SSL_REMOTE_CERTIFICATE_ERROR:
+                case cpr::ErrorCode::INVALID_URL_FORMAT:
+                case cpr::ErrorCode::UNSUPPORTED_PROTOCOL:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+    } // end anonymous namespace
+
+    UpstoxOrderTransport::UpstoxOrderTransport(UpstoxOrderTransportOptions options)
+        : options_(std::move(options)), place_url_(options_.base_url + "/v2/order/place"),
+          order_book_url_(options_.base_url + "/v2/order/retrieve-all")
+    {
+        // Client order ids restart with every gateway: the token keeps tags unique across restarts
+        const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        tag_prefix_ = options_.tag + toBase36(static_cast<std::uint64_t>(seconds));
+        if (options_.access_token.empty()) {
+            core::logging::getLogger()->warn("UpstoxOrderTransport created without access token.");
+        }
+        const std::size_t connections = std::max<std::size_t>(1, options_.connections);
+        connections_.reserve(connections);
+        for (std::size_t i = 0; i < connections; ++i) {
+            connections_.emplace_back([this] { connectionLoop(); });
+        }
+    }
+
+    UpstoxOrderTransport::~UpstoxOrderTransport() {
+        std::deque<QueuedOrder> unsent;
+        std::deque<QueuedLookup> lookups;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+            unsent.swap(queue_);
+            lookups.swap(lookups_);
+        }
+        ready_.notify_all();
+        for (auto& connection : connections_) connection.join();
+        for (const auto& queued : unsent) {
+            OrderResult result;
+            result.client_order_id = queued.order.client_order_id;
+            result.error = "transport shut down before sending";
+            result.completed_ns = nowNanos();
+            (*queued.done)(result);
+        }
+        for (const auto& lookup : lookups) {
+            for (const auto& order : lookup.orders) {
+                OrderResult result;
+                result.client_order_id = order.client_order_id;
+                result.outcome = OrderOutcome::Unknown;
+                result.error = "transport shut down before the order book lookup";
+                result.completed_ns = nowNanos();
+                lookup.done(result);
+            }
+        }
+    }
+
+    void UpstoxOrderTransport::submitAsync(std::vector<OrderRequest> batch, Completion done) {
+        auto shared_done = std::make_shared<const Completion>(std::move(done));
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto& order : batch) queue_.push_back({std::move(order), shared_done});
+        }
+        if (batch.size() == 1) ready_.notify_one();
+        else ready_.notify_all();
+    }
+
+    void UpstoxOrderTransport::reconcileAsync(std::vector<OrderRequest> orders, Completion done) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            lookups_.push_back({std::move(orders), std::move(done)});
+        }
+        ready_.notify_one();
+    }
+
+    std::string UpstoxOrderTransport::orderTag(const OrderRequest& order) const {
+        return tag_prefix_ + '-' + toBase36(order.client_order_id);
+    }
+
+    std::string UpstoxOrderTransport::orderBody(const OrderRequest& order) const {
+        nlohmann::json body = {
+            {"quantity", order.quantity},
+            {"product", options_.product},
+            {"validity", "DAY"},
+            {"price", 0},
+            {"instrument_token", order.instrument_key},
+            {"order_type", "MARKET"},
+            {"transaction_type", order.side == OrderSide::Buy ? "BUY" : "SELL"},
+            {"disclosed_quantity", 0},
+            {"trigger_price", 0},
+            {"is_amo", false},
+            {"tag", orderTag(order)},
+        };
+        return body.dump();
+    }
+
+    OrderResult UpstoxOrderTransport::parsePlaceOrderResponse(std::uint64_t client_order_id, long status_code,
+                                                              const std::string& body) {
+        OrderResult result;
+        result.client_order_id = client_order_id;
+        const nlohmann::json parsed = nlohmann::json::parse(body, nullptr, false);
+        if (status_code == 200 && parsed.is_object() && parsed.value("status", "") == "success") {
+            const auto data = parsed.find("data");
+            if (data != parsed.end() && data->is_object() && data->contains("order_id") && (*data)["order_id"].is_string()) {
+                result.outcome = OrderOutcome::Accepted;
+                result.broker_order_id = (*data)["order_id"].get<std::string>();
+                return result;
+            }
+            // Success without an order id: placed or not, only the order book can tell
+            result.outcome = OrderOutcome::Unknown;
+            result.error = "success response without an order id";
+            return result;
+        }
+        // A server error may come from a gateway in front of an order that was placed
+        if (status_code >= 500) result.outcome = OrderOutcome::Unknown;
+        // {"status": "error", "errors": [{"errorCode": "...", "message": "..."}]}
+        std::string message;
+        if (parsed.is_object()) {
+            const auto errors = parsed.find("errors");
+            if (errors != parsed.end() && errors->is_array() && !errors->empty() && (*errors)[0].is_object()) {
+                message = (*errors)[0].value("message", "");
+            }
+        }
+        result.error = "HTTP " + std::to_string(status_code) + (message.empty() ? "" : ": " + message);
+        return result;
+    }
+
+    void UpstoxOrderTransport::connectionLoop() {
+        auto logger = core::logging::getLogger();
+        // One session per connection thread, reused for every order it sends
+        cpr::Session session;
+        session.SetUrl(cpr::Url{place_url_});
+        session.SetHeader(cpr::Header{
+            {"Accept", "application/json"},
+            {"Content-Type", "application/json"},
+            {"Authorization", "Bearer " + options_.access_token}
+        });
+        session.SetTimeout(cpr::Timeout{options_.timeout_ms});
+        session.SetConnectTimeout(cpr::ConnectTimeout{options_.connect_timeout_ms});
+
+        for (;;) {
+            QueuedOrder queued;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                ready_.wait(lock, [this] { return stopping_ || !queue_.empty() || !lookups_.empty(); });
+                if (queue_.empty()) {
+                    if (lookups_.empty()) return; // Stopping
+                    QueuedLookup lookup = std::move(lookups_.front());
+                    lookups_.pop_front();
+                    lock.unlock();
+                    lookUp(lookup);
+                    continue;
+                }
+                queued = std::move(queue_.front());
+                queue_.pop_front();
+            }
+
+            session.SetBody(cpr::Body{orderBody(queued.order)});
+            cpr::Response response = session.Post();
+
+            OrderResult result;
+            if (response.error) {
+                result.client_order_id = queued.order.client_order_id;
+                result.outcome = neverSent(response.error.code) ? OrderOutcome::Rejected : OrderOutcome::Unknown;
+                result.error = fmt::format("code {}: {}", static_cast<int>(response.error.code), response.error.message);
+            } else {
+                result = parsePlaceOrderResponse(queued.order.client_order_id, response.status_code, response.text);
+                if (response.status_code == 401) {
+                    logger->critical("Upstox order API returned 401 Unauthorized. Access token may be invalid or expired.");
+                }
+            }
+            result.completed_ns = nowNanos();
+            (*queued.done)(result);
+        }
+    }
+
+    void UpstoxOrderTransport::lookUp(const QueuedLookup& lookup) {
+        // Rare (only after a lost answer), so a one-off request rather than the order session
+        cpr::Response response = cpr::Get(cpr::Url{order_book_url_},
+                                          cpr::Header{{"Accept", "application/json"},
+                                                      {"Authorization", "Bearer " + options_.access_token}},
+                                          cpr::Timeout{options_.timeout_ms},
+                                          cpr::ConnectTimeout{options_.connect_timeout_ms});
+        const std::int64_t now_ns = nowNanos();
+        std::vector<OrderResult> results;
+        if (response.error) {
+            for (const auto& order : lookup.orders) {
+                OrderResult result;
+                result.client_order_id = order.client_order_id;
+                result.outcome = OrderOutcome::Unknown;
+                result.error = fmt::format("order book lookup failed, code {}: {}", static_cast<int>(response.error.code),
+                                           response.error.message);
+                results.push_back(std::move(result));
+            }
+        } else {
+            results = parseOrderBookResponse(lookup.orders, response.status_code, response.text, now_ns);
+        }
+        for (auto& result : results) {
+            result.completed_ns = now_ns;
+            lookup.done(result);
+        }
+    }
+
+    std::vector<OrderResult> UpstoxOrderTransport::parseOrderBookResponse(const std::vector<OrderRequest>& orders,
+                                                                          long status_code, const std::string& body,
+                                                                          std::int64_t now_ns) const {
+        // {"status": "success", "data": [{"order_id", "tag", "status", "status_message", ...}]}
+        const nlohmann::json parsed = nlohmann::json::parse(body, nullptr, false);
+        const nlohmann::json* book = nullptr;
+        if (status_code == 200 && parsed.is_object() && parsed.value("status", "") == "success") {
+            const auto data = parsed.find("data");
+            if (data != parsed.end() && (data->is_array() || data->is_null())) book = &*data;
+        }
+
+        std::vector<OrderResult> results;
+        results.reserve(orders.size());
+        for (const auto& order : orders) {
+            OrderResult result;
+            result.client_order_id = order.client_order_id;
+            result.outcome = OrderOutcome::Unknown;
+            if (!book) {
+                result.error = "order book lookup returned HTTP " + std::to_string(status_code);
+                results.push_back(std::move(result));
+                continue;
+            }
+            const std::string tag = orderTag(order);
+            const nlohmann::json* entry = nullptr;
+            if (book->is_array()) {
+                for (const auto& candidate : *book) {
+                    if (candidate.is_object() && candidate.value("tag", "") == tag) {
+                        entry = &candidate;
+                        break;
+                    }
+                }
+            }
+            if (entry) {
+                // In the book: placed. Rejected or cancelled by now releases the reservation.
+                const std::string status = entry->value("status", "");
+                result.broker_order_id = entry->value("order_id", "");
+                if (status == "rejected" || status == "cancelled") {
+                    result.outcome = OrderOutcome::Rejected;
+                    result.error = status + ": " + entry->value("status_message", "");
+                } else {
+                    result.outcome = OrderOutcome::Accepted;
+                }
+            } else if (now_ns - order.submit_ns > std::int64_t{options_.not_found_grace_ms} * 1'000'000) {
+                result.outcome = OrderOutcome::Rejected;
+                result.error = "tag " + tag + " not in the order book";
+            } else {
+                result.error = "tag " + tag + " not in the order book yet";
+            }
+            results.push_back(std::move(result));
+        }
+        return results;
+    }
+
+} // namespace live
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include "candle_source.hpp"
+#include "candle_data_cache.hpp"
+#include "indicator_cache.hpp"
+#include "backtester.hpp"
+#include "http_server.hpp"
+
+#include <nlohmann/json.hpp>
+
+namespace server {
+
+    using json = nlohmann::json;
+
+    struct BacktestServiceOptions {
+        double default_capital = 100000.0;       // When a request has no "capital"
+        std::size_t sweep_threads = 0;          // Workers of one /sweep (0 = all cores)
+        std::size_t instrument_threads = 1;     // Backtester::setInstrumentThreads() per /backtest
+        // Optional data window (YYYY-MM-DD). When set, every /backtest loads and computes
+        // indicators over the whole window and only trades the requested range, so all
+        // requests share one cached load per instrument whatever their dates.
+        // Requests outside the window are rejected.
+        std::string data_start;
+        std::string data_end;
+        // Cached candles beyond this many stored bytes are dropped (with the in-memory
+        // indicators) after the request that crossed it; 0 = no limit
+        std::size_t max_cached_bytes = 0;
+        // /sweep grids with more combinations (before constraints) are rejected; 0 = no
+        // limit beyond ParameterSweep's own
+        std::size_t max_sweep_combinations = 10'000;
+        backtester::EvaluationMode evaluation_mode = backtester::EvaluationMode::Vectorized;
+    };
+
+    // --- BacktestService ---
+    // Long-running backtest endpoint. Keeps the candle source connected and one
+    // CandleDataCache / IndicatorCache across requests, so only the first request for
+    // an instrument and range pays for loading and indicator computation.
+    //
+    //   GET  /health    {"status": "ok", cache sizes, request counters}
+    //   POST /backtest  {"strategy": {...}, "start": "YYYY-MM-DD", "end": "YYYY-MM-DD",
+    //                    "capital": 100000, "per_bar": false, "equity_curve": false, "trades": false}
+    //                   -> {"success", "metrics", "stats", optional "equity_curve" / "trades"}
+    //   POST /sweep     {"strategy": {... with a "sweep" block}, "start", "end", "capital"}
+    //                   -> {"runs", "results": the spec's top rows, best first}
+    //                   (same data window rule as /backtest; grids up to max_sweep_combinations)
+    //
+    // Malformed requests get 400 {"error": "..."}. handle() is thread-safe: backtests
+    // run concurrently on the HTTP workers; sweeps use their own pool, one at a time.
+    class BacktestService {
+    public:
+        // 'universe_source' resolves "universe" blocks (index constituents) and is only
+        // connected on the first request with one; pass the candle source itself if it
+        // has them. Throws core::DataLoadException if the candle source cannot connect.
+        BacktestService(data::ICandleSource& candle_source, data::ICandleSource& universe_source,
+                        BacktestServiceOptions options = {},
+                        std::shared_ptr<indicators::IndicatorCache> indicator_cache = nullptr);
+
+        HttpResponse handle(const HttpRequest& request);
+
+        // Requests are only served concurrently if the candle source supports concurrent
+        // queries; size the HTTP worker pool with this
+        std::size_t maxConcurrentRequests(std::size_t requested) const;
+
+        std::shared_ptr<backtester::CandleDataCache> getDataCache() const { return data_cache_; }
+        std::shared_ptr<indicators::IndicatorCache> getIndicatorCache() const { return indicator_cache_; }
+
+    private:
+        json health() const;
+        json resolveUniverse(const json& strategy, const std::string& start_date);
+        json runBacktest(const json& request);
+        json runSweep(const json& request);
+        void trimCaches();
+
+        data::ICandleSource& candle_source_;
+        data::ICandleSource& universe_source_;
+        BacktestServiceOptions options_;
+        std::shared_ptr<backtester::CandleDataCache> data_cache_;
+        std::shared_ptr<indicators::IndicatorCache> indicator_cache_;
+        std::optional<std::pair<core::Timestamp, core::Timestamp>> data_window_;
+
+        std::mutex universe_mutex_; // Universe resolution may query a source without concurrent reads
+        std::mutex sweep_mutex_;    // One sweep at a time; each already uses every sweep thread
+        std::atomic<std::uint64_t> requests_{0};
+        std::atomic<std::uint64_t> backtests_{0};
+        std::atomic<std::uint64_t> sweeps_{0};
+        std::atomic<std::uint64_t> failed_{0};
+    };
+
+} // namespace server
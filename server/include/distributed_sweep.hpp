@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "candle_source.hpp"
+#include "candle_data_cache.hpp"
+#include "indicator_cache.hpp"
+#include "parameter_sweep.hpp" // SweepSpec, SweepResult
+#include "http_server.hpp"
+#include "thread_pool.hpp"
+
+#include <nlohmann/json.hpp>
+
+namespace server {
+
+    // --- Distributed sweep protocol (JSON over HTTP/1.1) ---
+    //   POST /sweep/prepare  {"id": "<content hash>", "strategy": {...resolved template},
+    //                         "start": "YYYY-MM-DD", "end": "YYYY-MM-DD", "capital": 1e5, "stop": {...}}
+    //                        -> {"id", "threads": worker pool size}
+    //   POST /sweep/jobs     {"id": "<prepared id>", "jobs": [{"job": 17, "params": {"fast": 10},
+    //                                                         "instrument": "NSE_EQ|X" (optional)}]}
+    //                        -> {"results": [{"job": 17, "success": true, "metrics": {...}}]}
+    //                        409 if the id is not prepared (e.g. the worker restarted)
+    //   GET  /health         {"status": "ok", "threads", "prepared", "jobs_run"}
+    // The strategy travels once per worker in /sweep/prepare; every job is only a
+    // parameter set (and instrument), and every result only its BacktestMetrics.
+    // The worker checks that the prepare id is the hash of the rest of the request.
+    // With a shared secret, every request must carry it in kSweepSecretHeader (401
+    // otherwise): plain HTTP, so it keeps out strangers on a trusted network only.
+
+    inline constexpr const char* kSweepSecretHeader = "X-Sweep-Secret";
+
+    struct SweepWorkerOptions {
+        std::size_t threads = 0;               // Jobs run at once (0 = all cores)
+        std::string shared_secret;             // Required in kSweepSecretHeader (empty = not checked)
+        std::size_t max_prepared_sweeps = 16;  // Oldest prepared sweeps are forgotten beyond this
+        backtester::EvaluationMode evaluation_mode = backtester::EvaluationMode::Vectorized;
+    };
+
+    // --- SweepWorker ---
+    // Worker side: runs the jobs it is sent against its own candle source (typically
+    // a columnar store on shared or local disk), so candles never cross the network.
+    // Loaded candles and indicators are cached across jobs and sweeps.
+    class SweepWorker {
+    public:
+        SweepWorker(data::ICandleSource& candle_source, SweepWorkerOptions options = {},
+                    std::shared_ptr<indicators::IndicatorCache> indicator_cache = nullptr);
+
+        // HttpServer handler; thread-safe
+        HttpResponse handle(const HttpRequest& request);
+
+        std::size_t threads() const { return pool_.size(); }
+
+    private:
+        struct PreparedSweep {
+            std::string id;
+            nlohmann::json strategy_template;
+            std::string start_date;
+            std::string end_date;
+            double capital = 0.0;
+            backtester::StopCriteria stop;
+        };
+
+        nlohmann::json prepare(const nlohmann::json& request);
+        HttpResponse runJobs(const nlohmann::json& request);
+
+        data::ICandleSource& candle_source_;
+        SweepWorkerOptions options_;
+        std::shared_ptr<backtester::CandleDataCache> data_cache_;
+        std::shared_ptr<indicators::IndicatorCache> indicator_cache_;
+        core::ThreadPool pool_;
+
+        mutable std::mutex mutex_;
+        std::list<std::shared_ptr<const PreparedSweep>> prepared_; // Most recently used first
+        std::uint64_t jobs_run_ = 0;
+    };
+
+    struct DistributedSweepOptions {
+        std::vector<std::string> workers;   // "host:port" of each SweepWorker
+        std::string shared_secret;          // Sent in kSweepSecretHeader (the workers' shared_secret)
+        std::size_t batch_size = 0;         // Jobs per request (0 = the worker's thread count)
+        bool per_instrument = false;        // One job per (combination, instrument) instead of per combination
+        int connect_timeout_ms = 3000;
+        int request_timeout_seconds = 600;  // A batch taking longer counts as a worker failure
+        // Once no job is left to hand out, idle workers also run jobs that have been
+        // in flight this long elsewhere; the first result wins
+        double straggler_seconds = 30.0;
+        std::size_t max_attempts = 3;        // Dispatches of one job before it is reported failed
+        std::size_t max_worker_failures = 3; // Consecutive failed requests before a worker is dropped
+    };
+
+    // --- DistributedSweep ---
+    // Coordinator side of a parameter (or per-instrument universe) sweep: expands the
+    // grid, hands batches of jobs to SweepWorkers over kept-alive connections (one
+    // dispatch thread per worker, pulling from a shared queue so faster workers take
+    // more) and collects the metrics. Jobs of a failed request are queued again for
+    // the other workers; jobs stuck on a slow worker are duplicated once the queue is
+    // empty.
+    //
+    // The strategy config must already have its universe resolved. Successive
+    // halving needs every round's results before the next and is not supported.
+    class DistributedSweep {
+    public:
+        DistributedSweep(DistributedSweepOptions options, double initial_capital);
+
+        // Results ranked as ParameterSweep::run() ranks them; SweepResult::instrument is
+        // set for per-instrument jobs. Throws core::ConfigException for halving specs,
+        // unparsable worker endpoints or a per-instrument sweep without instruments.
+        std::vector<backtester::SweepResult> run(const backtester::SweepSpec& spec,
+                                                 const std::string& start_date,
+                                                 const std::string& end_date);
+
+    private:
+        DistributedSweepOptions options_;
+        double initial_capital_;
+    };
+
+} // namespace server
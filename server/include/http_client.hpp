@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+
+#include "http_server.hpp" // HttpResponse
+
+namespace server {
+
+    struct HttpClientOptions {
+        int connect_timeout_ms = 3000;
+        int request_timeout_ms = 60000; // Sending the request and receiving the whole response
+        std::map<std::string, std::string> headers; // Sent with every request (e.g. credentials)
+    };
+
+    // --- HttpClient ---
+    // Blocking HTTP/1.1 client for one host:port (plain TCP, no TLS) that keeps its
+    // connection alive between requests, e.g. a coordinator talking to a worker. A
+    // request on a connection the server has since closed is retried once on a new
+    // connection. Not thread-safe: use one client per thread.
+    class HttpClient {
+    public:
+        HttpClient(std::string host, std::uint16_t port, HttpClientOptions options = {});
+        ~HttpClient();
+
+        HttpClient(const HttpClient&) = delete;
+        HttpClient& operator=(const HttpClient&) = delete;
+
+        // nullopt (logged at debug level) if the server cannot be reached, times out
+        // or sends a malformed response; the connection is closed then
+        std::optional<HttpResponse> request(const std::string& method, const std::string& path,
+                                            const std::string& body = "",
+                                            const std::string& content_type = "application/json");
+        void close();
+
+        const std::string& host() const { return host_; }
+        std::uint16_t port() const { return port_; }
+
+        // Splits "host:port"; false if there is no valid port
+        static bool parseEndpoint(const std::string& endpoint, std::string& host, std::uint16_t& port);
+
+    private:
+        bool connect();
+        // One attempt on the current connection; 'received_any' reports whether the
+        // server answered at all (a silent close on a reused connection is retried)
+        std::optional<HttpResponse> exchange(const std::string& request_bytes, bool& received_any);
+
+        std::string host_;
+        std::uint16_t port_;
+        HttpClientOptions options_;
+        int fd_ = -1;
+        std::string buffer_; // Received bytes not consumed yet
+    };
+
+} // namespace server
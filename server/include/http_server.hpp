@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+#include "thread_pool.hpp"
+
+namespace server {
+
+    struct HttpRequest {
+        std::string method;  // "GET", "POST", ...
+        std::string path;    // Target without the query string
+        std::string query;   // After '?', undecoded
+        std::map<std::string, std::string> headers; // Names lower-cased
+        std::string body;
+    };
+
+    struct HttpResponse {
+        int status = 200;
+        std::string content_type = "application/json";
+        std::string body;
+    };
+
+    using HttpHandler = std::function<HttpResponse(const HttpRequest&)>;
+
+    struct HttpServerOptions {
+        std::size_t worker_threads = 0;        // Connections served at once (0 = all cores)
+        std::size_t max_body_bytes = 8 << 20;  // Larger requests get 413
+        int keep_alive_seconds = 5;            // Idle time before a kept-alive connection is closed
+    };
+
+    // --- HttpServer ---
+    // Minimal HTTP/1.1 server on POSIX sockets for local services: one accept thread
+    // hands every connection to a worker pool, which reads requests (Content-Length
+    // bodies, keep-alive and pipelining; no chunked uploads or TLS) and answers each
+    // with the handler's response. The handler is called from several workers at
+    // once and must be thread-safe.
+    //
+    // A kept-alive connection holds its worker until it goes idle for
+    // keep_alive_seconds, so worker_threads also bounds the number of open clients
+    // being served; further connections wait in the pool's queue.
+    class HttpServer {
+    public:
+        HttpServer(HttpHandler handler, HttpServerOptions options = {});
+        ~HttpServer(); // stop()s
+
+        HttpServer(const HttpServer&) = delete;
+        HttpServer& operator=(const HttpServer&) = delete;
+
+        // Binds host:port (port 0 = any free port) and starts accepting.
+        // False (logged) if the address cannot be bound.
+        bool start(const std::string& host, std::uint16_t port);
+        // Stops accepting, closes open connections and waits for running requests
+        void stop();
+
+        bool running() const { return running_.load(); }
+        std::uint16_t port() const { return port_; } // Bound port once started
+
+        static const char* reasonPhrase(int status);
+
+    private:
+        void acceptLoop();
+        void serveConnection(int fd);
+
+        HttpHandler handler_;
+        HttpServerOptions options_;
+        std::atomic<bool> running_{false};
+        int listen_fd_ = -1;
+        std::uint16_t port_ = 0;
+        std::thread accept_thread_;
+        std::unique_ptr<core::ThreadPool> pool_;
+
+        std::mutex connections_mutex_;
+        std::set<int> connections_; // Open connection sockets, shut down by stop()
+    };
+
+} // namespace server
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "metrics_accumulator.hpp" // BacktestMetrics, StopCriteria
+
+#include <nlohmann/json.hpp>
+
+namespace server {
+
+    // JSON form of the backtester's result types, shared by the HTTP endpoints and
+    // the distributed sweep protocol. Field names match BacktestMetrics.
+    nlohmann::json metricsToJson(const backtester::BacktestMetrics& metrics);
+    // Missing fields keep their defaults; throws nlohmann::json::exception on wrong types
+    backtester::BacktestMetrics metricsFromJson(const nlohmann::json& value);
+
+    // {"max_drawdown_pct": ..., "min_equity": ...}, unset criteria omitted
+    nlohmann::json stopCriteriaToJson(const backtester::StopCriteria& criteria);
+    backtester::StopCriteria stopCriteriaFromJson(const nlohmann::json& value);
+
+} // namespace server
@@ -0,0 +1,288 @@
+#include "backtest_service.hpp"
+#include "metrics_json.hpp"
+#include "logging.hpp"
+#include "exceptions.hpp"
+#include "utils.hpp"
+#include "parameter_sweep.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+namespace server {
+
+    namespace { // File-local helpers
+
+        HttpResponse jsonResponse(int status, const json& body) {
+            return {status, "application/json", body.dump()};
+        }
+
+        HttpResponse errorResponse(int status, const std::string& message) {
+            return jsonResponse(status, json{{"error", message}});
+        }
+
+        std::string requireDate(const json& request, const char* field) {
+            if (!request.contains(field) || !request[field].is_string()) {
+                throw std::invalid_argument(std::string("'") + field + "' (YYYY-MM-DD) is required.");
+            }
+            return request[field].get<std::string>();
+        }
+
+        // Query range of [start_date, end_date]; std::invalid_argument for malformed dates
+        std::pair<core::Timestamp, core::Timestamp> rangeForDates(const std::string& start_date, const std::string& end_date) {
+            std::pair<core::Timestamp, core::Timestamp> range;
+            try {
+                range = backtester::Backtester::queryRangeForDates(start_date, end_date);
+            } catch (const std::runtime_error&) {
+                throw std::invalid_argument("Dates must be YYYY-MM-DD (got '" + start_date + "', '" + end_date + "').");
+            }
+            if (range.first > range.second) throw std::invalid_argument("'start' is after 'end'.");
+            return range;
+        }
+
+        const json& requireStrategy(const json& request) {
+            if (!request.contains("strategy") || !request["strategy"].is_object()) {
+                throw std::invalid_argument("'strategy' (strategy config object) is required.");
+            }
+            return request["strategy"];
+        }
+
+        double capitalOf(const json& request, double default_capital) {
+            if (!request.contains("capital")) return default_capital;
+            if (!request["capital"].is_number() || request["capital"].get<double>() <= 0.0) {
+                throw std::invalid_argument("'capital' must be a positive number.");
+            }
+            return request["capital"].get<double>();
+        }
+
+        double elapsedMs(std::chrono::steady_clock::time_point since) {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - since).count();
+        }
+
+    } // end anonymous namespace
+
+    BacktestService::BacktestService(data::ICandleSource& candle_source, data::ICandleSource& universe_source,
+                                     BacktestServiceOptions options,
+                                     std::shared_ptr<indicators::IndicatorCache> indicator_cache)
+        : candle_source_(candle_source),
+          universe_source_(universe_source),
+          options_(std::move(options)),
+          data_cache_(std::make_shared<backtester::CandleDataCache>()),
+          indicator_cache_(indicator_cache ? std::move(indicator_cache) : std::make_shared<indicators::IndicatorCache>())
+    {
+        // Connect once up front; every request reuses the connections (and read pool)
+        if (!candle_source_.isConnected() && !candle_source_.connect()) {
+            throw core::DataLoadException("Backtest service: failed to connect to the candle source.");
+        }
+        if (options_.data_start.empty() != options_.data_end.empty()) {
+            throw core::ConfigException("Backtest service: the data window needs both a start and an end date.");
+        }
+        if (!options_.data_start.empty()) {
+            try {
+                data_window_ = rangeForDates(options_.data_start, options_.data_end);
+            } catch (const std::invalid_argument& e) {
+                throw core::ConfigException(std::string("Backtest service data window: ") + e.what());
+            }
+            core::logging::getLogger()->info("Backtest service data window: {} to {}.", options_.data_start, options_.data_end);
+        }
+    }
+
+    std::size_t BacktestService::maxConcurrentRequests(std::size_t requested) const {
+        return candle_source_.supportsConcurrentQueries() ? core::ThreadPool::resolveThreadCount(requested) : 1;
+    }
+
+    HttpResponse BacktestService::handle(const HttpRequest& request) {
+        auto logger = core::logging::getLogger();
+        ++requests_;
+
+        const bool is_backtest = request.path == "/backtest";
+        const bool is_sweep = request.path == "/sweep";
+        if (request.path == "/health") {
+            if (request.method != "GET") return errorResponse(405, "Use GET for /health.");
+            return jsonResponse(200, health());
+        }
+        if (!is_backtest && !is_sweep) return errorResponse(404, "Unknown endpoint: " + request.path);
+        if (request.method != "POST") return errorResponse(405, "Use POST for " + request.path + ".");
+
+        const auto started = std::chrono::steady_clock::now();
+        try {
+            const json body = json::parse(request.body);
+            if (!body.is_object()) throw std::invalid_argument("Request body must be a JSON object.");
+            json result = is_backtest ? runBacktest(body) : runSweep(body);
+            result["elapsed_ms"] = elapsedMs(started);
+            logger->info("{} {} served in {:.1f} ms.", request.method, request.path, result["elapsed_ms"].get<double>());
+            trimCaches();
+            return jsonResponse(200, result);
+        } catch (const json::exception& e) {
+            ++failed_;
+            return errorResponse(400, std::string("Invalid JSON: ") + e.what());
+        } catch (const std::invalid_argument& e) {
+            ++failed_;
+            return errorResponse(400, e.what());
+        } catch (const core::ConfigException& e) {
+            ++failed_;
+            return errorResponse(400, e.what());
+        } catch (const std::exception& e) {
+            ++failed_;
+            logger->error("{} {} failed: {}", request.method, request.path, e.what());
+            return errorResponse(500, e.what());
+        }
+    }
+
+    json BacktestService::health() const {
+        return {
+            {"status", "ok"},
+            {"candle_series", data_cache_->size()},
+            {"candle_bytes", data_cache_->storedBytes()},
+            {"indicator_series", indicator_cache_->size()},
+            {"requests", requests_.load()},
+            {"backtests", backtests_.load()},
+            {"sweeps", sweeps_.load()},
+            {"failed", failed_.load()},
+        };
+    }
+
+    json BacktestService::resolveUniverse(const json& strategy, const std::string& start_date) {
+        if (!strategy.contains("universe")) return strategy;
+        std::lock_guard<std::mutex> lock(universe_mutex_);
+        if (!universe_source_.isConnected() && !universe_source_.connect()) {
+            throw core::DataLoadException("Backtest service: failed to connect to the universe source.");
+        }
+        return backtester::Backtester::resolveUniverse(universe_source_, strategy, start_date);
+    }
+
+    json BacktestService::runBacktest(const json& request) {
+        const json& strategy = requireStrategy(request);
+        const std::string start_date = requireDate(request, "start");
+        const std::string end_date = requireDate(request, "end");
+        const auto range = rangeForDates(start_date, end_date);
+        const double capital = capitalOf(request, options_.default_capital);
+        if (data_window_ && (range.first < data_window_->first || range.second > data_window_->second)) {
+            throw std::invalid_argument("Dates must lie inside the service's data window (" +
+                                        options_.data_start + " to " + options_.data_end + ").");
+        }
+
+        const json config = resolveUniverse(strategy, start_date);
+
+        backtester::Backtester backtester(candle_source_, capital);
+        backtester.setDataCache(data_cache_);
+        backtester.setIndicatorCache(indicator_cache_);
+        backtester.setInstrumentThreads(options_.instrument_threads);
+        backtester.setEvaluationMode(request.value("per_bar", false) ? backtester::EvaluationMode::PerBar
+                                                                     : options_.evaluation_mode);
+        bool success;
+        if (data_window_) {
+            // Load the whole window (cached once for every request), trade the requested dates
+            backtester.setEvaluationRange(range.first, range.second);
+            success = backtester.run(config, options_.data_start, options_.data_end);
+        } else {
+            success = backtester.run(config, start_date, end_date);
+        }
+        ++backtests_;
+        if (!success) ++failed_;
+
+        json result = {
+            {"success", success},
+            {"metrics", metricsToJson(backtester.getMetrics())},
+            {"stats", backtester.getRunStats().toJson()},
+        };
+        const auto& portfolio = backtester.getPortfolio();
+        if (request.value("equity_curve", false)) {
+            json curve = json::array();
+            for (const auto& point : portfolio.getEquityCurve()) {
+                curve.push_back({{"time", core::utils::timestampToString(point.timestamp)},
+                                 {"cash", point.cash},
+                                 {"positions_value", point.positions_value},
+                                 {"total_equity", point.total_equity}});
+            }
+            result["equity_curve"] = std::move(curve);
+        }
+        if (request.value("trades", false)) {
+            json trades = json::array();
+            for (const auto& trade : portfolio.getTradeLog()) {
+                trades.push_back({{"instrument", trade.instrument_key},
+                                  {"side", trade.entry_action == core::SignalAction::EnterShort ? "short" : "long"},
+                                  {"entry_time", core::utils::timestampToString(trade.entry_time)},
+                                  {"exit_time", core::utils::timestampToString(trade.exit_time)},
+                                  {"quantity", trade.quantity},
+                                  {"entry_price", trade.entry_price},
+                                  {"exit_price", trade.exit_price},
+                                  {"commission", trade.commission},
+                                  {"pnl", trade.pnl},
+                                  {"return_pct", trade.return_pct}});
+            }
+            result["trades"] = std::move(trades);
+        }
+        return result;
+    }
+
+    json BacktestService::runSweep(const json& request) {
+        const json& strategy = requireStrategy(request);
+        const std::string start_date = requireDate(request, "start");
+        const std::string end_date = requireDate(request, "end");
+        const auto range = rangeForDates(start_date, end_date);
+        const double capital = capitalOf(request, options_.default_capital);
+        if (data_window_ && (range.first < data_window_->first || range.second > data_window_->second)) {
+            throw std::invalid_argument("Dates must lie inside the service's data window (" +
+                                        options_.data_start + " to " + options_.data_end + ").");
+        }
+
+        const json config = resolveUniverse(strategy, start_date);
+        const backtester::SweepSpec spec = backtester::ParameterSweep::parseSpec(config);
+        if (options_.max_sweep_combinations > 0) {
+            // Upper bound before constraints, checked without expanding the grid
+            std::size_t combinations = 1;
+            for (const auto& parameter : spec.parameters) {
+                const std::size_t values = parameter.values.size();
+                if (values != 0 && combinations > options_.max_sweep_combinations / values) {
+                    combinations = options_.max_sweep_combinations + 1;
+                    break;
+                }
+                combinations *= values;
+            }
+            if (combinations > options_.max_sweep_combinations) {
+                throw std::invalid_argument("The sweep grid exceeds the service's limit of " +
+                                            std::to_string(options_.max_sweep_combinations) + " combinations.");
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(sweep_mutex_);
+        backtester::ParameterSweep sweep(candle_source_, capital, options_.sweep_threads);
+        sweep.setDataCache(data_cache_);
+        sweep.setIndicatorCache(indicator_cache_);
+        sweep.setEvaluationMode(options_.evaluation_mode);
+        std::vector<backtester::SweepResult> results;
+        if (data_window_) {
+            // As /backtest: one cached load of the window, trading the requested dates
+            sweep.setEvaluationRange(range.first, range.second);
+            results = sweep.run(spec, options_.data_start, options_.data_end);
+        } else {
+            results = sweep.run(spec, start_date, end_date);
+        }
+        ++sweeps_;
+
+        json rows = json::array();
+        for (std::size_t i = 0; i < results.size() && i < spec.top; ++i) {
+            const auto& r = results[i];
+            rows.push_back({{"parameters", r.parameters},
+                            {"success", r.success},
+                            {"eliminated", r.eliminated},
+                            {"data_fraction", r.data_fraction},
+                            {"metrics", metricsToJson(r.metrics)}});
+        }
+        return {{"runs", results.size()}, {"rank_by", spec.rank_by}, {"results", std::move(rows)}};
+    }
+
+    void BacktestService::trimCaches() {
+        if (options_.max_cached_bytes == 0) return;
+        const std::size_t stored = data_cache_->storedBytes();
+        if (stored <= options_.max_cached_bytes) return;
+        // Runs in flight keep their series alive through their own shared pointers
+        core::logging::getLogger()->info("Backtest service: {} cached candle bytes exceed the {} byte limit; clearing caches.",
+                                         stored, options_.max_cached_bytes);
+        data_cache_->clear();
+        indicator_cache_->clear();
+    }
+
+} // namespace server
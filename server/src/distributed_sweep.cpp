@@ -0,0 +1,467 @@
+#include "distributed_sweep.hpp"
+#include "http_client.hpp"
+#include "metrics_json.hpp"
+#include "backtester.hpp"
+#include "logging.hpp"
+#include "exceptions.hpp"
+
+#include "spdlog/fmt/bundled/core.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <thread>
+
+namespace server {
+
+    using json = nlohmann::json;
+
+    namespace { // File-local helpers
+
+        using Clock = std::chrono::steady_clock;
+
+        HttpResponse jsonResponse(int status, const json& body) {
+            return {status, "application/json", body.dump()};
+        }
+
+        HttpResponse errorResponse(int status, const std::string& message) {
+            return jsonResponse(status, json{{"error", message}});
+        }
+
+        // FNV-1a, names a prepared sweep by its content
+        std::string contentHash(const std::string& text) {
+            std::uint64_t hash = 14695981039346656037ull;
+            for (unsigned char c : text) {
+                hash ^= c;
+                hash *= 1099511628211ull;
+            }
+            return fmt::format("{:016x}", hash);
+        }
+
+        // Id of a /sweep/prepare body: the hash of everything but the id (object keys
+        // are sorted, so the coordinator and the worker dump the same text)
+        std::string prepareId(json request) {
+            request.erase("id");
+            return contentHash(request.dump());
+        }
+
+        // Compares without an early exit, so response times do not leak the secret
+        bool secretMatches(const std::string& given, const std::string& expected) {
+            if (given.size() != expected.size()) return false;
+            unsigned char difference = 0;
+            for (std::size_t i = 0; i < given.size(); ++i) {
+                difference |= static_cast<unsigned char>(given[i] ^ expected[i]);
+            }
+            return difference == 0;
+        }
+
+        // Coordinator-side bookkeeping of one job
+        struct JobSlot {
+            enum class State { Queued, Running, Done } state = State::Queued;
+            std::size_t attempts = 0;
+            Clock::time_point dispatched{};
+            bool duplicated = false; // Already handed to a second worker as a straggler
+        };
+
+    } // end anonymous namespace
+
+    // ======================================================
+    // --- SweepWorker ---
+    // ======================================================
+
+    SweepWorker::SweepWorker(data::ICandleSource& candle_source, SweepWorkerOptions options,
+                             std::shared_ptr<indicators::IndicatorCache> indicator_cache)
+        : candle_source_(candle_source),
+          options_(options),
+          data_cache_(std::make_shared<backtester::CandleDataCache>()),
+          indicator_cache_(indicator_cache ? std::move(indicator_cache) : std::make_shared<indicators::IndicatorCache>()),
+          pool_(options.threads)
+    {
+        if (!candle_source_.isConnected() && !candle_source_.connect()) {
+            throw core::DataLoadException("Sweep worker: failed to connect to the candle source.");
+        }
+    }
+
+    HttpResponse SweepWorker::handle(const HttpRequest& request) {
+        if (!options_.shared_secret.empty()) {
+            const auto it = request.headers.find("x-sweep-secret"); // Names arrive lower-cased
+            if (it == request.headers.end() || !secretMatches(it->second, options_.shared_secret)) {
+                core::logging::getLogger()->warn("Sweep worker: refused {} {} without the shared secret.", request.method, request.path);
+                return errorResponse(401, std::string("Missing or wrong ") + kSweepSecretHeader + " header.");
+            }
+        }
+        if (request.path == "/health") {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return jsonResponse(200, {{"status", "ok"}, {"threads", pool_.size()},
+                                      {"prepared", prepared_.size()}, {"jobs_run", jobs_run_}});
+        }
+        if (request.path != "/sweep/prepare" && request.path != "/sweep/jobs") {
+            return errorResponse(404, "Unknown endpoint: " + request.path);
+        }
+        if (request.method != "POST") return errorResponse(405, "Use POST for " + request.path + ".");
+        try {
+            const json body = json::parse(request.body);
+            if (request.path == "/sweep/prepare") return jsonResponse(200, prepare(body));
+            return runJobs(body);
+        } catch (const json::exception& e) {
+            return errorResponse(400, std::string("Invalid request: ") + e.what());
+        } catch (const core::ConfigException& e) {
+            return errorResponse(400, e.what());
+        }
+    }
+
+    json SweepWorker::prepare(const json& request) {
+        auto logger = core::logging::getLogger();
+        auto sweep = std::make_shared<PreparedSweep>();
+        sweep->id = request.at("id").get<std::string>();
+        // The id names the content in later /sweep/jobs calls; a mismatch would run
+        // jobs of one sweep against another's strategy
+        if (sweep->id != prepareId(request)) {
+            throw core::ConfigException("Sweep id " + sweep->id + " does not match the prepared content.");
+        }
+        sweep->strategy_template = request.at("strategy");
+        sweep->start_date = request.at("start").get<std::string>();
+        sweep->end_date = request.at("end").get<std::string>();
+        sweep->capital = request.at("capital").get<double>();
+        sweep->stop = stopCriteriaFromJson(request.value("stop", json::object()));
+        if (!sweep->strategy_template.is_object()) throw core::ConfigException("'strategy' must be an object.");
+
+        // Load the candles once up front (also keeps concurrent jobs from querying a
+        // source that does not support it); jobs then only read the cache
+        const json& config = sweep->strategy_template;
+        if (config.contains("instruments") && config["instruments"].is_array() &&
+            config.contains("timeframes") && config["timeframes"].is_array() && !config["timeframes"].empty() &&
+            config["timeframes"][0].is_string()) {
+            const std::string timeframe = config["timeframes"][0].get<std::string>();
+            const auto [start_ts, end_ts] = backtester::Backtester::queryRangeForDates(sweep->start_date, sweep->end_date);
+            auto preload = [&, start_ts = start_ts, end_ts = end_ts](const std::string& instrument) {
+                data_cache_->getOrLoad(instrument, timeframe, start_ts, end_ts, [&]() {
+                    return candle_source_.queryCandleSeries(instrument, timeframe, start_ts, end_ts);
+                });
+            };
+            std::vector<std::future<void>> loads;
+            for (const auto& entry : config["instruments"]) {
+                if (!entry.is_string()) continue;
+                const std::string instrument = entry.get<std::string>();
+                if (candle_source_.supportsConcurrentQueries()) {
+                    loads.push_back(pool_.submit([&preload, instrument]() { preload(instrument); }));
+                } else {
+                    preload(instrument);
+                }
+            }
+            for (auto& f : loads) f.wait();
+            for (auto& f : loads) f.get();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        prepared_.remove_if([&](const auto& entry) { return entry->id == sweep->id; });
+        prepared_.push_front(sweep);
+        while (prepared_.size() > std::max<std::size_t>(options_.max_prepared_sweeps, 1)) prepared_.pop_back();
+        logger->info("Sweep worker: prepared sweep {} ({} to {}, {} cached series).",
+                     sweep->id, sweep->start_date, sweep->end_date, data_cache_->size());
+        return {{"id", sweep->id}, {"threads", pool_.size()}};
+    }
+
+    HttpResponse SweepWorker::runJobs(const json& request) {
+        const std::string id = request.at("id").get<std::string>();
+        std::shared_ptr<const PreparedSweep> sweep;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = std::find_if(prepared_.begin(), prepared_.end(), [&](const auto& entry) { return entry->id == id; });
+            if (it != prepared_.end()) {
+                sweep = *it;
+                prepared_.splice(prepared_.begin(), prepared_, it);
+            }
+        }
+        if (!sweep) return errorResponse(409, "Sweep " + id + " is not prepared on this worker.");
+
+        const json& jobs = request.at("jobs");
+        std::vector<std::future<json>> pending;
+        pending.reserve(jobs.size());
+        for (const auto& job : jobs) {
+            const auto job_id = job.at("job").get<std::uint64_t>();
+            const auto params = job.at("params").get<backtester::ParameterSet>();
+            const std::string instrument = job.value("instrument", std::string{});
+            pending.push_back(pool_.submit([this, sweep, job_id, params, instrument]() {
+                json config = backtester::ParameterSweep::instantiate(sweep->strategy_template, params);
+                if (!instrument.empty()) config["instruments"] = json::array({instrument});
+                backtester::Backtester backtester(candle_source_, sweep->capital);
+                backtester.setDataCache(data_cache_);
+                backtester.setIndicatorCache(indicator_cache_);
+                backtester.setEvaluationMode(options_.evaluation_mode);
+                if (sweep->stop.any()) backtester.setStopCriteria(sweep->stop);
+                const bool success = backtester.run(config, sweep->start_date, sweep->end_date);
+                return json{{"job", job_id}, {"success", success}, {"metrics", metricsToJson(backtester.getMetrics())}};
+            }));
+        }
+
+        json results = json::array();
+        for (std::size_t k = 0; k < pending.size(); ++k) {
+            try {
+                results.push_back(pending[k].get());
+            } catch (const std::exception& e) {
+                core::logging::getLogger()->error("Sweep worker: job {} failed: {}", jobs[k].at("job").dump(), e.what());
+                results.push_back({{"job", jobs[k].at("job")}, {"success", false}, {"error", e.what()}});
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            jobs_run_ += pending.size();
+        }
+        return jsonResponse(200, {{"results", std::move(results)}});
+    }
+
+    // ======================================================
+    // --- DistributedSweep ---
+    // ======================================================
+
+    DistributedSweep::DistributedSweep(DistributedSweepOptions options, double initial_capital)
+        : options_(std::move(options)), initial_capital_(initial_capital) {}
+
+    std::vector<backtester::SweepResult> DistributedSweep::run(const backtester::SweepSpec& spec,
+                                                               const std::string& start_date,
+                                                               const std::string& end_date)
+    {
+        auto logger = core::logging::getLogger();
+        if (spec.halving_rounds > 0) {
+            throw core::ConfigException("Successive halving ('sweep.halving') is not supported by distributed sweeps.");
+        }
+        if (options_.workers.empty()) throw core::ConfigException("Distributed sweep needs at least one worker.");
+        struct Endpoint {
+            std::string host;
+            std::uint16_t port = 0;
+        };
+        std::vector<Endpoint> endpoints;
+        for (const auto& worker : options_.workers) {
+            Endpoint endpoint;
+            if (!HttpClient::parseEndpoint(worker, endpoint.host, endpoint.port)) {
+                throw core::ConfigException("Invalid sweep worker endpoint (expected host:port): " + worker);
+            }
+            endpoints.push_back(std::move(endpoint));
+        }
+
+        // Jobs: every combination, or every (combination, instrument)
+        const std::vector<backtester::ParameterSet> grid = backtester::ParameterSweep::expandGrid(spec);
+        std::vector<std::string> instruments{std::string{}};
+        if (options_.per_instrument) {
+            const json& listed = spec.strategy_template.value("instruments", json::array());
+            if (!listed.is_array() || listed.empty()) {
+                throw core::ConfigException("A per-instrument sweep needs an 'instruments' list (or a resolved universe).");
+            }
+            instruments = listed.get<std::vector<std::string>>();
+        }
+        std::vector<backtester::SweepResult> results;
+        results.reserve(grid.size() * instruments.size());
+        for (const auto& params : grid) {
+            for (const auto& instrument : instruments) {
+                backtester::SweepResult result;
+                result.parameters = params;
+                result.instrument = instrument;
+                results.push_back(std::move(result));
+            }
+        }
+        logger->info("Distributed sweep: {} jobs ({} combinations x {} instrument sets) on {} workers (ranked by {}).",
+                     results.size(), grid.size(), instruments.size(), endpoints.size(), spec.rank_by);
+        if (results.empty()) {
+            logger->warn("Sweep grid is empty after applying constraints.");
+            return {};
+        }
+
+        json prepare = {{"strategy", spec.strategy_template}, {"start", start_date}, {"end", end_date},
+                        {"capital", initial_capital_}, {"stop", stopCriteriaToJson(spec.stop)}};
+        const std::string sweep_id = prepareId(prepare);
+        prepare["id"] = sweep_id;
+        const std::string prepare_body = prepare.dump();
+
+        // --- Shared dispatch state ---
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::deque<std::size_t> queue(results.size());
+        for (std::size_t i = 0; i < queue.size(); ++i) queue[i] = i;
+        std::vector<JobSlot> slots(results.size());
+        std::size_t done = 0;
+        const std::size_t progress_step = std::max<std::size_t>(results.size() / 10, 1);
+        std::size_t next_progress = progress_step;
+        std::size_t redispatched = 0;
+
+        // Settles a job (first result wins); caller holds the lock
+        auto finish = [&](std::size_t i, bool success, const backtester::BacktestMetrics& metrics) {
+            if (slots[i].state == JobSlot::State::Done) return;
+            slots[i].state = JobSlot::State::Done;
+            results[i].success = success;
+            results[i].metrics = metrics;
+            ++done;
+            if (done >= next_progress && done < results.size()) {
+                logger->info("Distributed sweep: {}/{} jobs done.", done, results.size());
+                next_progress = done + progress_step;
+            }
+        };
+        // Puts unfinished jobs of a failed request back at the front of the queue
+        auto requeue = [&](const std::vector<std::size_t>& taken) {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (auto it = taken.rbegin(); it != taken.rend(); ++it) {
+                JobSlot& slot = slots[*it];
+                if (slot.state == JobSlot::State::Done) continue;
+                if (slot.attempts >= options_.max_attempts) {
+                    logger->error("Distributed sweep: job {} failed {} times, giving up.", *it, slot.attempts);
+                    finish(*it, false, {});
+                    continue;
+                }
+                slot.state = JobSlot::State::Queued;
+                queue.push_front(*it);
+                ++redispatched;
+            }
+            changed.notify_all();
+        };
+
+        const auto straggler_age = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(options_.straggler_seconds));
+        auto dispatch = [&](const Endpoint& endpoint) {
+            const std::string name = endpoint.host + ':' + std::to_string(endpoint.port);
+            HttpClientOptions client_options;
+            client_options.connect_timeout_ms = options_.connect_timeout_ms;
+            client_options.request_timeout_ms = options_.request_timeout_seconds * 1000;
+            if (!options_.shared_secret.empty()) client_options.headers[kSweepSecretHeader] = options_.shared_secret;
+            HttpClient client(endpoint.host, endpoint.port, client_options);
+            bool prepared = false;
+            std::size_t batch_size = options_.batch_size;
+            std::size_t failures = 0;
+            std::size_t jobs_run = 0;
+            auto failed = [&](const std::string& why) {
+                ++failures;
+                logger->warn("Distributed sweep: worker {} {} ({}/{}).", name, why, failures, options_.max_worker_failures);
+                if (failures >= options_.max_worker_failures) return false;
+                std::this_thread::sleep_for(std::chrono::milliseconds(250 * failures));
+                prepared = false; // The worker may have restarted
+                return true;
+            };
+
+            for (;;) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (done == results.size()) break;
+                }
+                if (!prepared) {
+                    auto response = client.request("POST", "/sweep/prepare", prepare_body);
+                    if (!response || response->status != 200) {
+                        if (!failed(response ? "rejected the sweep: " + response->body : "is unreachable")) break;
+                        continue;
+                    }
+                    const json reply = json::parse(response->body, nullptr, false);
+                    const std::size_t threads = reply.is_object() ? reply.value("threads", std::size_t{1}) : 1;
+                    if (options_.batch_size == 0) batch_size = std::max<std::size_t>(threads, 1);
+                    prepared = true;
+                    logger->info("Distributed sweep: worker {} ready ({} threads, {} jobs per request).", name, threads, batch_size);
+                }
+
+                // Next batch: queued jobs first, then duplicates of stragglers
+                std::vector<std::size_t> taken;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    for (;;) {
+                        if (done == results.size()) break;
+                        const auto now = Clock::now();
+                        while (!queue.empty() && taken.size() < batch_size) {
+                            const std::size_t i = queue.front();
+                            queue.pop_front();
+                            if (slots[i].state == JobSlot::State::Done) continue;
+                            slots[i].state = JobSlot::State::Running;
+                            slots[i].dispatched = now;
+                            ++slots[i].attempts;
+                            taken.push_back(i);
+                        }
+                        if (taken.empty()) {
+                            for (std::size_t i = 0; i < slots.size() && taken.size() < batch_size; ++i) {
+                                JobSlot& slot = slots[i];
+                                if (slot.state == JobSlot::State::Running && !slot.duplicated && now - slot.dispatched >= straggler_age) {
+                                    slot.duplicated = true;
+                                    taken.push_back(i);
+                                }
+                            }
+                            if (!taken.empty()) {
+                                logger->info("Distributed sweep: worker {} also runs {} straggling jobs.", name, taken.size());
+                            }
+                        }
+                        if (!taken.empty()) break;
+                        changed.wait_for(lock, std::chrono::milliseconds(500));
+                    }
+                }
+                if (taken.empty()) break; // Everything done
+
+                json jobs = json::array();
+                for (std::size_t i : taken) {
+                    json job = {{"job", i}, {"params", results[i].parameters}};
+                    if (!results[i].instrument.empty()) job["instrument"] = results[i].instrument;
+                    jobs.push_back(std::move(job));
+                }
+                auto response = client.request("POST", "/sweep/jobs", json{{"id", sweep_id}, {"jobs", std::move(jobs)}}.dump());
+                if (response && response->status == 409) {
+                    // The worker restarted or evicted the sweep: not the jobs' fault, prepare again
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        for (std::size_t i : taken) {
+                            if (slots[i].state == JobSlot::State::Running && slots[i].attempts > 0) --slots[i].attempts;
+                        }
+                    }
+                    requeue(taken);
+                    if (!failed("lost the prepared sweep")) break;
+                    continue;
+                }
+                if (!response || response->status != 200) {
+                    requeue(taken);
+                    if (!failed(response ? fmt::format("answered {}", response->status) : std::string("failed or timed out"))) break;
+                    continue;
+                }
+                failures = 0;
+
+                const json reply = json::parse(response->body, nullptr, false);
+                std::vector<std::size_t> missing;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    std::vector<bool> answered(taken.size(), false);
+                    if (reply.is_object() && reply.contains("results") && reply["results"].is_array()) {
+                        for (const auto& entry : reply["results"]) {
+                            if (!entry.is_object() || !entry.contains("job") || !entry["job"].is_number_unsigned()) continue;
+                            const auto i = entry["job"].get<std::size_t>();
+                            const auto pos = std::find(taken.begin(), taken.end(), i);
+                            if (pos == taken.end()) continue;
+                            answered[pos - taken.begin()] = true;
+                            backtester::BacktestMetrics metrics;
+                            try {
+                                if (entry.contains("metrics")) metrics = metricsFromJson(entry["metrics"]);
+                            } catch (const json::exception&) {
+                                answered[pos - taken.begin()] = false;
+                                continue;
+                            }
+                            finish(i, entry.value("success", false), metrics);
+                            ++jobs_run;
+                        }
+                    }
+                    for (std::size_t k = 0; k < taken.size(); ++k) if (!answered[k]) missing.push_back(taken[k]);
+                    changed.notify_all();
+                }
+                if (!missing.empty()) {
+                    requeue(missing);
+                    if (!failed(fmt::format("left {} jobs unanswered", missing.size()))) break;
+                }
+            }
+            logger->info("Distributed sweep: worker {} finished {} jobs.", name, jobs_run);
+            changed.notify_all();
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(endpoints.size());
+        for (const auto& endpoint : endpoints) threads.emplace_back(dispatch, std::cref(endpoint));
+        for (auto& thread : threads) thread.join();
+
+        if (done < results.size()) {
+            logger->error("Distributed sweep: every worker failed; {} of {} jobs did not run.", results.size() - done, results.size());
+        }
+        logger->info("Distributed sweep: {} jobs done, {} re-dispatched after worker failures.", done, redispatched);
+        backtester::ParameterSweep::rankResults(results, spec.rank_by);
+        return results;
+    }
+
+} // namespace server
@@ -0,0 +1,213 @@
+#include "http_client.hpp"
+#include "logging.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <string_view>
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace server {
+
+    namespace { // File-local helpers
+
+        using Clock = std::chrono::steady_clock;
+
+        int remainingMs(Clock::time_point deadline) {
+            const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+            return left > 0 ? static_cast<int>(left) : 0;
+        }
+
+        // Waits until 'fd' is ready for 'events' or the deadline passes
+        bool waitFor(int fd, short events, Clock::time_point deadline) {
+            for (;;) {
+                pollfd entry{fd, events, 0};
+                const int ready = ::poll(&entry, 1, remainingMs(deadline));
+                if (ready < 0 && errno == EINTR) continue;
+                return ready > 0;
+            }
+        }
+
+        bool iequals(std::string_view a, std::string_view b) {
+            return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+                return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+            });
+        }
+
+    } // end anonymous namespace
+
+    HttpClient::HttpClient(std::string host, std::uint16_t port, HttpClientOptions options)
+        : host_(std::move(host)), port_(port), options_(options) {}
+
+    HttpClient::~HttpClient() {
+        close();
+    }
+
+    bool HttpClient::parseEndpoint(const std::string& endpoint, std::string& host, std::uint16_t& port) {
+        const std::size_t colon = endpoint.rfind(':');
+        if (colon == std::string::npos || colon == 0 || colon + 1 == endpoint.size() || endpoint.size() - colon > 6) return false;
+        const std::string digits = endpoint.substr(colon + 1);
+        if (!std::all_of(digits.begin(), digits.end(), ::isdigit)) return false;
+        const unsigned long value = std::stoul(digits);
+        if (value == 0 || value > 65535) return false;
+        host = endpoint.substr(0, colon);
+        port = static_cast<std::uint16_t>(value);
+        return true;
+    }
+
+    void HttpClient::close() {
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+        buffer_.clear();
+    }
+
+    bool HttpClient::connect() {
+        auto logger = core::logging::getLogger();
+        close();
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* addresses = nullptr;
+        const std::string service = std::to_string(port_);
+        if (const int rc = ::getaddrinfo(host_.c_str(), service.c_str(), &hints, &addresses); rc != 0) {
+            logger->debug("HTTP client: cannot resolve {}: {}", host_, ::gai_strerror(rc));
+            return false;
+        }
+
+        const auto deadline = Clock::now() + std::chrono::milliseconds(options_.connect_timeout_ms);
+        for (addrinfo* address = addresses; address && fd_ < 0; address = address->ai_next) {
+            const int fd = ::socket(address->ai_family, address->ai_socktype | SOCK_CLOEXEC | SOCK_NONBLOCK, address->ai_protocol);
+            if (fd < 0) continue;
+            int rc = ::connect(fd, address->ai_addr, address->ai_addrlen);
+            if (rc != 0 && errno == EINPROGRESS && waitFor(fd, POLLOUT, deadline)) {
+                int error = 0;
+                socklen_t length = sizeof(error);
+                ::getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length);
+                rc = error == 0 ? 0 : -1;
+            }
+            if (rc != 0) {
+                ::close(fd);
+                continue;
+            }
+            ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+            const int one = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            fd_ = fd;
+        }
+        ::freeaddrinfo(addresses);
+        if (fd_ < 0) logger->debug("HTTP client: cannot connect to {}:{}.", host_, port_);
+        return fd_ >= 0;
+    }
+
+    std::optional<HttpResponse> HttpClient::request(const std::string& method, const std::string& path,
+                                                    const std::string& body, const std::string& content_type) {
+        std::string request_bytes = method + ' ' + path + " HTTP/1.1\r\n";
+        request_bytes += "Host: " + host_ + ':' + std::to_string(port_) + "\r\n";
+        for (const auto& [name, value] : options_.headers) request_bytes += name + ": " + value + "\r\n";
+        if (!body.empty() || method == "POST" || method == "PUT") {
+            request_bytes += "Content-Type: " + content_type + "\r\n";
+            request_bytes += "Content-Length: " + std::to_string(body.size()) + "\r\n";
+        }
+        request_bytes += "\r\n";
+        request_bytes += body;
+
+        const bool reused = fd_ >= 0;
+        if (!reused && !connect()) return std::nullopt;
+        bool received_any = false;
+        auto response = exchange(request_bytes, received_any);
+        if (!response && reused && !received_any) {
+            // The server most likely closed the idle connection; one fresh attempt
+            if (!connect()) return std::nullopt;
+            response = exchange(request_bytes, received_any);
+        }
+        return response;
+    }
+
+    std::optional<HttpResponse> HttpClient::exchange(const std::string& request_bytes, bool& received_any) {
+        auto logger = core::logging::getLogger();
+        const auto deadline = Clock::now() + std::chrono::milliseconds(options_.request_timeout_ms);
+        auto fail = [&](const char* what) -> std::optional<HttpResponse> {
+            logger->debug("HTTP client {}:{}: {}", host_, port_, what);
+            close();
+            return std::nullopt;
+        };
+
+        std::string_view pending(request_bytes);
+        while (!pending.empty()) {
+            if (!waitFor(fd_, POLLOUT, deadline)) return fail("send timed out");
+            const ssize_t sent = ::send(fd_, pending.data(), pending.size(), MSG_NOSIGNAL);
+            if (sent < 0 && errno == EINTR) continue;
+            if (sent <= 0) return fail("send failed");
+            pending.remove_prefix(static_cast<std::size_t>(sent));
+        }
+
+        char chunk[16 * 1024];
+        auto fill = [&]() {
+            for (;;) {
+                if (!waitFor(fd_, POLLIN, deadline)) return false;
+                const ssize_t received = ::recv(fd_, chunk, sizeof(chunk), 0);
+                if (received < 0 && errno == EINTR) continue;
+                if (received <= 0) return false;
+                received_any = true;
+                buffer_.append(chunk, static_cast<std::size_t>(received));
+                return true;
+            }
+        };
+
+        std::size_t header_end;
+        while ((header_end = buffer_.find("\r\n\r\n")) == std::string::npos) {
+            if (!fill()) return fail("connection closed or timed out before the response headers");
+        }
+        const std::string_view head(buffer_.data(), header_end);
+        // "HTTP/1.1 200 OK"
+        if (head.size() < 12 || head.substr(0, 7) != "HTTP/1." || !std::isdigit(static_cast<unsigned char>(head[9]))) {
+            return fail("malformed status line");
+        }
+        HttpResponse response;
+        response.status = std::stoi(std::string(head.substr(9, 3)));
+        response.content_type.clear();
+        std::optional<std::size_t> content_length;
+        bool close_after = false;
+        for (std::size_t pos = std::min(head.find("\r\n"), head.size()) + 2; pos < head.size();) {
+            std::size_t end = head.find("\r\n", pos);
+            if (end == std::string_view::npos) end = head.size();
+            const std::string_view line = head.substr(pos, end - pos);
+            if (const std::size_t colon = line.find(':'); colon != std::string_view::npos) {
+                const std::string_view name = line.substr(0, colon);
+                std::string_view value = line.substr(colon + 1);
+                while (!value.empty() && value.front() == ' ') value.remove_prefix(1);
+                if (iequals(name, "content-length")) {
+                    if (value.empty() || value.size() > 18 || !std::all_of(value.begin(), value.end(), ::isdigit)) {
+                        return fail("invalid Content-Length");
+                    }
+                    content_length = std::stoull(std::string(value));
+                } else if (iequals(name, "content-type")) {
+                    response.content_type = std::string(value);
+                } else if (iequals(name, "connection")) {
+                    close_after = iequals(value, "close");
+                }
+            }
+            pos = end + 2;
+        }
+        if (!content_length) return fail("response without Content-Length");
+
+        const std::size_t body_start = header_end + 4;
+        while (buffer_.size() - body_start < *content_length) {
+            if (!fill()) return fail("connection closed or timed out in the response body");
+        }
+        response.body = buffer_.substr(body_start, *content_length);
+        buffer_.erase(0, body_start + *content_length);
+        if (close_after) close();
+        return response;
+    }
+
+} // namespace server
@@ -0,0 +1,288 @@
+#include "http_server.hpp"
+#include "logging.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <optional>
+#include <string_view>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace server {
+
+    namespace { // File-local helpers
+
+        constexpr std::size_t kMaxHeaderBytes = 64 * 1024;
+        constexpr int kAcceptPollMs = 200; // How often the accept loop checks for stop()
+
+        std::string lowerCase(std::string_view text) {
+            std::string out(text);
+            std::transform(out.begin(), out.end(), out.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            return out;
+        }
+
+        std::string_view trim(std::string_view text) {
+            while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+            while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) text.remove_suffix(1);
+            return text;
+        }
+
+        bool sendAll(int fd, std::string_view data) {
+            while (!data.empty()) {
+                const ssize_t sent = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+                if (sent < 0 && errno == EINTR) continue;
+                if (sent <= 0) return false;
+                data.remove_prefix(static_cast<std::size_t>(sent));
+            }
+            return true;
+        }
+
+        void sendResponse(int fd, const HttpResponse& response, bool keep_alive) {
+            std::string out = "HTTP/1.1 " + std::to_string(response.status) + ' ' + HttpServer::reasonPhrase(response.status) + "\r\n";
+            out += "Content-Type: " + response.content_type + "\r\n";
+            out += "Content-Length: " + std::to_string(response.body.size()) + "\r\n";
+            out += keep_alive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+            out += response.body;
+            sendAll(fd, out);
+        }
+
+        HttpResponse errorResponse(int status, const std::string& message) {
+            std::string escaped;
+            for (char c : message) {
+                if (c == '"' || c == '\\') escaped += '\\';
+                escaped += (static_cast<unsigned char>(c) < 0x20) ? ' ' : c;
+            }
+            return {status, "application/json", "{\"error\":\"" + escaped + "\"}"};
+        }
+
+        // Outcome of reading one request off a connection
+        struct ReadResult {
+            std::optional<HttpRequest> request;
+            int error_status = 0; // Set for malformed requests (answered, then the connection closes)
+            std::string error;
+        };
+
+        // Reads one request; 'buffer' keeps bytes of the next pipelined request.
+        // Neither request nor error: the peer closed or went idle.
+        ReadResult readRequest(int fd, std::string& buffer, std::size_t max_body_bytes) {
+            ReadResult result;
+            char chunk[16 * 1024];
+            auto fill = [&]() {
+                for (;;) {
+                    const ssize_t received = ::recv(fd, chunk, sizeof(chunk), 0);
+                    if (received < 0 && errno == EINTR) continue;
+                    if (received <= 0) return false; // Closed, idle timeout or error
+                    buffer.append(chunk, static_cast<std::size_t>(received));
+                    return true;
+                }
+            };
+
+            std::size_t header_end;
+            while ((header_end = buffer.find("\r\n\r\n")) == std::string::npos) {
+                if (buffer.size() > kMaxHeaderBytes) {
+                    result.error_status = 431;
+                    result.error = "Request headers too large.";
+                    return result;
+                }
+                if (!fill()) return result;
+            }
+
+            HttpRequest request;
+            const std::string_view head(buffer.data(), header_end);
+            const std::size_t line_end = std::min(head.find("\r\n"), head.size());
+            const std::string_view request_line = head.substr(0, line_end);
+            const std::size_t method_end = request_line.find(' ');
+            const std::size_t target_end = request_line.rfind(' ');
+            if (method_end == std::string_view::npos || target_end == method_end ||
+                request_line.substr(target_end + 1).rfind("HTTP/1.", 0) != 0) {
+                result.error_status = 400;
+                result.error = "Malformed request line.";
+                return result;
+            }
+            request.method = std::string(request_line.substr(0, method_end));
+            std::string_view target = request_line.substr(method_end + 1, target_end - method_end - 1);
+            if (const std::size_t question = target.find('?'); question != std::string_view::npos) {
+                request.query = std::string(target.substr(question + 1));
+                target = target.substr(0, question);
+            }
+            request.path = std::string(target);
+            if (request_line.substr(target_end + 1) == "HTTP/1.0") request.headers["connection"] = "close";
+
+            for (std::size_t pos = line_end + 2; pos < head.size();) {
+                std::size_t end = head.find("\r\n", pos);
+                if (end == std::string_view::npos) end = head.size();
+                const std::string_view line = head.substr(pos, end - pos);
+                const std::size_t colon = line.find(':');
+                if (colon != std::string_view::npos) {
+                    request.headers[lowerCase(trim(line.substr(0, colon)))] = std::string(trim(line.substr(colon + 1)));
+                }
+                pos = end + 2;
+            }
+
+            if (request.headers.count("transfer-encoding")) {
+                result.error_status = 501;
+                result.error = "Chunked request bodies are not supported; send Content-Length.";
+                return result;
+            }
+            std::size_t body_length = 0;
+            if (auto it = request.headers.find("content-length"); it != request.headers.end()) {
+                const std::string& value = it->second;
+                if (value.empty() || value.size() > 18 || !std::all_of(value.begin(), value.end(), ::isdigit)) {
+                    result.error_status = 400;
+                    result.error = "Invalid Content-Length.";
+                    return result;
+                }
+                body_length = std::stoull(value);
+            }
+            if (body_length > max_body_bytes) {
+                result.error_status = 413;
+                result.error = "Request body too large.";
+                return result;
+            }
+
+            const std::size_t body_start = header_end + 4;
+            while (buffer.size() - body_start < body_length) {
+                if (!fill()) return result;
+            }
+            request.body = buffer.substr(body_start, body_length);
+            buffer.erase(0, body_start + body_length);
+            result.request = std::move(request);
+            return result;
+        }
+
+    } // end anonymous namespace
+
+    HttpServer::HttpServer(HttpHandler handler, HttpServerOptions options)
+        : handler_(std::move(handler)), options_(options) {}
+
+    HttpServer::~HttpServer() {
+        stop();
+    }
+
+    bool HttpServer::start(const std::string& host, std::uint16_t port) {
+        auto logger = core::logging::getLogger();
+        if (running_) return true;
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        if (::inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1) {
+            logger->error("HTTP server: '{}' is not an IPv4 address.", host);
+            return false;
+        }
+
+        listen_fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (listen_fd_ < 0) {
+            logger->error("HTTP server: socket() failed: {}", std::strerror(errno));
+            return false;
+        }
+        const int one = 1;
+        ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            ::listen(listen_fd_, 128) != 0) {
+            logger->error("HTTP server: cannot listen on {}:{}: {}", host, port, std::strerror(errno));
+            ::close(listen_fd_);
+            listen_fd_ = -1;
+            return false;
+        }
+        socklen_t length = sizeof(address);
+        ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&address), &length);
+        port_ = ntohs(address.sin_port);
+
+        pool_ = std::make_unique<core::ThreadPool>(options_.worker_threads);
+        running_ = true;
+        accept_thread_ = std::thread([this]() { acceptLoop(); });
+        logger->info("HTTP server listening on {}:{} ({} workers).", host, port_, pool_->size());
+        return true;
+    }
+
+    void HttpServer::stop() {
+        if (!running_.exchange(false)) return;
+        if (accept_thread_.joinable()) accept_thread_.join();
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        {
+            // Wakes workers blocked reading idle connections; running requests still finish
+            std::lock_guard<std::mutex> lock(connections_mutex_);
+            for (int fd : connections_) ::shutdown(fd, SHUT_RD);
+        }
+        pool_.reset(); // Drains queued connections, joins the workers
+        core::logging::getLogger()->info("HTTP server on port {} stopped.", port_);
+    }
+
+    void HttpServer::acceptLoop() {
+        while (running_) {
+            pollfd listening{listen_fd_, POLLIN, 0};
+            const int ready = ::poll(&listening, 1, kAcceptPollMs);
+            if (ready <= 0) continue; // Timeout (check running_) or EINTR
+            const int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+            if (fd < 0) continue;
+            {
+                std::lock_guard<std::mutex> lock(connections_mutex_);
+                connections_.insert(fd);
+            }
+            pool_->submit([this, fd]() { serveConnection(fd); });
+        }
+    }
+
+    void HttpServer::serveConnection(int fd) {
+        const int one = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        timeval idle{options_.keep_alive_seconds, 0};
+        ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &idle, sizeof(idle));
+
+        std::string buffer;
+        while (running_) {
+            ReadResult read = readRequest(fd, buffer, options_.max_body_bytes);
+            if (read.error_status != 0) {
+                sendResponse(fd, errorResponse(read.error_status, read.error), false);
+                break;
+            }
+            if (!read.request) break;
+            const HttpRequest& request = *read.request;
+            const auto connection = request.headers.find("connection");
+            const bool keep_alive = running_ && (connection == request.headers.end() || lowerCase(connection->second) != "close");
+
+            HttpResponse response;
+            try {
+                response = handler_(request);
+            } catch (const std::exception& e) {
+                core::logging::getLogger()->error("HTTP {} {} failed: {}", request.method, request.path, e.what());
+                response = errorResponse(500, e.what());
+            }
+            sendResponse(fd, response, keep_alive);
+            if (!keep_alive) break;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(connections_mutex_);
+            connections_.erase(fd);
+        }
+        ::close(fd);
+    }
+
+    const char* HttpServer::reasonPhrase(int status) {
+        switch (status) {
+            case 200: return "OK";
+            case 400: return "Bad Request";
+            case 401: return "Unauthorized";
+            case 404: return "Not Found";
+            case 405: return "Method Not Allowed";
+            case 413: return "Payload Too Large";
+            case 431: return "Request Header Fields Too Large";
+            case 500: return "Internal Server Error";
+            case 501: return "Not Implemented";
+            case 503: return "Service Unavailable";
+            default: return "Unknown";
+        }
+    }
+
+} // namespace server
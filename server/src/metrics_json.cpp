@@ -0,0 +1,63 @@
+#include "metrics_json.hpp"
+
+namespace server {
+
+    nlohmann::json metricsToJson(const backtester::BacktestMetrics& m) {
+        return {
+            {"total_return_pct", m.total_return_pct},
+            {"total_pnl", m.total_pnl},
+            {"max_drawdown_pct", m.max_drawdown_pct},
+            {"total_executions", m.total_executions},
+            {"round_trip_trades", m.round_trip_trades},
+            {"win_rate", m.win_rate},
+            {"profit_factor", m.profit_factor},
+            {"avg_win_pnl", m.avg_win_pnl},
+            {"avg_loss_pnl", m.avg_loss_pnl},
+            {"sharpe_ratio", m.sharpe_ratio},
+            {"sortino_ratio", m.sortino_ratio},
+            {"cagr_pct", m.cagr_pct},
+            {"calmar_ratio", m.calmar_ratio},
+            {"exposure_pct", m.exposure_pct},
+            {"max_drawdown_duration_bars", m.max_drawdown_duration_bars},
+            {"max_drawdown_duration_days", m.max_drawdown_duration_days},
+            {"stopped_early", m.stopped_early},
+        };
+    }
+
+    backtester::BacktestMetrics metricsFromJson(const nlohmann::json& value) {
+        backtester::BacktestMetrics m;
+        m.total_return_pct = value.value("total_return_pct", m.total_return_pct);
+        m.total_pnl = value.value("total_pnl", m.total_pnl);
+        m.max_drawdown_pct = value.value("max_drawdown_pct", m.max_drawdown_pct);
+        m.total_executions = value.value("total_executions", m.total_executions);
+        m.round_trip_trades = value.value("round_trip_trades", m.round_trip_trades);
+        m.win_rate = value.value("win_rate", m.win_rate);
+        m.profit_factor = value.value("profit_factor", m.profit_factor);
+        m.avg_win_pnl = value.value("avg_win_pnl", m.avg_win_pnl);
+        m.avg_loss_pnl = value.value("avg_loss_pnl", m.avg_loss_pnl);
+        m.sharpe_ratio = value.value("sharpe_ratio", m.sharpe_ratio);
+        m.sortino_ratio = value.value("sortino_ratio", m.sortino_ratio);
+        m.cagr_pct = value.value("cagr_pct", m.cagr_pct);
+        m.calmar_ratio = value.value("calmar_ratio", m.calmar_ratio);
+        m.exposure_pct = value.value("exposure_pct", m.exposure_pct);
+        m.max_drawdown_duration_bars = value.value("max_drawdown_duration_bars", m.max_drawdown_duration_bars);
+        m.max_drawdown_duration_days = value.value("max_drawdown_duration_days", m.max_drawdown_duration_days);
+        m.stopped_early = value.value("stopped_early", m.stopped_early);
+        return m;
+    }
+
+    nlohmann::json stopCriteriaToJson(const backtester::StopCriteria& criteria) {
+        nlohmann::json out = nlohmann::json::object();
+        if (criteria.max_drawdown_pct) out["max_drawdown_pct"] = *criteria.max_drawdown_pct;
+        if (criteria.min_equity) out["min_equity"] = *criteria.min_equity;
+        return out;
+    }
+
+    backtester::StopCriteria stopCriteriaFromJson(const nlohmann::json& value) {
+        backtester::StopCriteria criteria;
+        if (value.contains("max_drawdown_pct")) criteria.max_drawdown_pct = value["max_drawdown_pct"].get<double>();
+        if (value.contains("min_equity")) criteria.min_equity = value["min_equity"].get<double>();
+        return criteria;
+    }
+
+} // namespace server
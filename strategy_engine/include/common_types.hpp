@@ -1,6 +1,10 @@
 #pragma once
 #include "datatypes.hpp"     // Use short path (Provides core types)
 #include "common_types.hpp"  // <<<--- ADD THIS INCLUDE (Provides SizingMethod enum)
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <string>
 
 namespace strategy_engine {
 
@@ -26,6 +30,45 @@ namespace strategy_engine {
         CapitalBased   // Allocate max capital (absolute or % of initial)
         // Add RiskBased later if needed
     };
-    
+
+    // Index of an indicator in a strategy's required indicator list.
+    // Resolved once by StrategyFactory so conditions never look up names per bar.
+    using IndicatorSlot = std::size_t;
+    using IndicatorSlotMap = std::map<std::string, IndicatorSlot>;
+
+    // Value stored in a slot when the indicator has no result for that bar
+    inline constexpr double kMissingIndicatorValue = std::numeric_limits<double>::quiet_NaN();
+
+    // Indicator names may name a higher timeframe after '@', e.g. "SMA(20)@15minute".
+    // Without a suffix the indicator runs on the strategy's first (base) timeframe.
+    inline constexpr char kIndicatorTimeframeSeparator = '@';
+
+    struct IndicatorTimeframeRef {
+        std::string spec;      // Indicator without the suffix, e.g. "SMA(20)"
+        std::string timeframe; // Empty = base timeframe
+    };
+
+    inline IndicatorTimeframeRef splitIndicatorTimeframe(const std::string& name) {
+        const auto at = name.rfind(kIndicatorTimeframeSeparator);
+        if (at == std::string::npos) return {name, {}};
+        return {name.substr(0, at), name.substr(at + 1)};
+    }
+
+    // Multi-output indicators name one output after '.', e.g. "BBANDS(20,2).upper" or
+    // "MACD(12,26,9).signal@15minute". Without a selector the first output is used.
+    // Only a '.' after the closing parenthesis counts, so "BBANDS(20,2.5)" has none.
+    inline constexpr char kIndicatorOutputSeparator = '.';
+
+    struct IndicatorOutputRef {
+        std::string spec;   // Indicator without the selector, e.g. "BBANDS(20,2)"
+        std::string output; // Empty = first output
+    };
+
+    inline IndicatorOutputRef splitIndicatorOutput(const std::string& spec) {
+        const auto close = spec.rfind(')');
+        const auto dot = spec.find(kIndicatorOutputSeparator, close == std::string::npos ? 0 : close);
+        if (dot == std::string::npos) return {spec, {}};
+        return {spec.substr(0, dot), spec.substr(dot + 1)};
+    }
 
 } // namespace strategy_engine
\ No newline at end of file
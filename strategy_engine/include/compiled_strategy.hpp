@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "interfaces.hpp"
+#include "common_types.hpp"
+#include "condition_program.hpp"
+#include "arena.hpp"
+
+namespace strategy_engine {
+
+    class Strategy;
+
+    // One rule of a CompiledStrategy: its condition as the postfix ConditionProgram ops
+    struct CompiledRule {
+        std::string name;
+        core::SignalAction action = core::SignalAction::None;
+        std::vector<ConditionProgram::Op> ops;
+    };
+
+    // --- CompiledStrategy ---
+    // Everything StrategyFactory derives from a strategy config except the instrument
+    // list: the resolved indicator names (index = slot), sizing, and every rule's
+    // compiled condition program. instantiate() builds a ready Strategy from it
+    // without touching JSON, so a strategy is parsed and validated once and then
+    // created per instrument, per run or per process launch from this form.
+    //
+    // Serialized layout (native endianness):
+    //   char[4] magic "TPST" | u32 version | name | timeframes | indicator names |
+    //   u8 sizing method | f64 sizing value | u8 is_percentage | entry rules | exit rules
+    // Strings are u32 length + bytes, lists a u32 count; a rule is name, u8 action,
+    // u32 op count and per op: u8 code, cmp, price_a, price_b | u32 slot_a, slot_b | f64 value.
+    struct CompiledStrategy {
+        // Bump when the factory's semantics or the layout change: serialized forms
+        // of another version are rejected, and cache files are rebuilt from JSON
+        static constexpr std::uint32_t kFormatVersion = 1;
+
+        std::string name;
+        std::vector<std::string> timeframes;
+        std::vector<std::string> indicator_names;
+        SizingMethod sizing_method = SizingMethod::Quantity;
+        double sizing_value = 1.0;
+        bool is_sizing_value_percentage = false;
+        std::vector<CompiledRule> entry_rules;
+        std::vector<CompiledRule> exit_rules;
+
+        // Throws std::invalid_argument if a rule is not a strategy_engine::Rule
+        static CompiledStrategy fromStrategy(const Strategy& strategy);
+
+        // A new Strategy trading 'instruments'. Condition trees are rebuilt from the
+        // programs (chains of AND/OR become one flat node, which compiles to the
+        // same program); with an arena everything is allocated there, as with
+        // StrategyFactory::createStrategy().
+        std::unique_ptr<IStrategy> instantiate(std::vector<std::string> instruments, core::Arena* arena = nullptr) const;
+
+        std::string serialize() const;
+        // nullopt for truncated or malformed input, another format version, or
+        // programs that do not reduce to one value or use slots out of range
+        static std::optional<CompiledStrategy> deserialize(std::string_view bytes);
+    };
+
+} // namespace strategy_engine
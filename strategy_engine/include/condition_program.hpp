@@ -0,0 +1,91 @@
+#pragma once
+
+#include "interfaces.hpp"
+#include "common_types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace strategy_engine {
+
+    // --- ConditionProgram ---
+    // Flat, postfix form of an ICondition tree, built once at factory time.
+    // Leaves push a bool, And/Or pop two and push one, so evaluating a bar is a
+    // single pass over a contiguous op array with no virtual calls, no string
+    // lookups and no allocation. Indicator slots and price fields are resolved
+    // when the program is built.
+    //
+    // Semantics match the ICondition tree exactly (the tree stays the reference
+    // implementation): missing indicator values are NaN and every comparison
+    // against NaN is false; price leaves are false when the snapshot has no
+    // current candle. And/Or do not short-circuit, which is safe because
+    // conditions have no side effects.
+    class ConditionProgram {
+    public:
+        enum class OpCode : std::uint8_t {
+            PushFalse,            // Placeholder for a null child condition
+            FieldVsValue,         // candle.field_a  <cmp> value
+            FieldVsField,         // candle.field_a  <cmp> candle.field_b
+            FieldVsIndicator,     // candle.field_a  <cmp> indicator[slot_b]
+            IndicatorVsValue,     // indicator[slot_a] <cmp> value
+            IndicatorVsIndicator, // indicator[slot_a] <cmp> indicator[slot_b]
+            CrossAbove,           // slot_a crossed above slot_b on this bar
+            CrossBelow,           // slot_a crossed below slot_b on this bar
+            And,
+            Or
+        };
+
+        using CandleField = double core::Candle::*;
+
+        struct Op {
+            OpCode code = OpCode::PushFalse;
+            ComparisonOp cmp = ComparisonOp::GT;
+            IndicatorSlot slot_a = 0;
+            IndicatorSlot slot_b = 0;
+            CandleField field_a = nullptr;
+            CandleField field_b = nullptr;
+            PriceField price_a = PriceField::Close; // Same fields, for column evaluation
+            PriceField price_b = PriceField::Close;
+            double value = 0.0;
+        };
+
+        // Deepest nesting a program may have; keeps the evaluation stack on the C stack
+        static constexpr std::size_t kMaxStackDepth = 64;
+
+        // Lowers 'condition' (via ICondition::compile). Throws std::invalid_argument
+        // if the tree does not reduce to exactly one value or nests too deeply.
+        static ConditionProgram compile(const ICondition& condition);
+
+        bool evaluate(const MarketDataSnapshot& snapshot) const;
+        // Evaluates bars [begin, end) in one pass per op over whole columns.
+        // mask[j] is what evaluate() returns for bar begin + j. Throws
+        // std::invalid_argument if the price columns are shorter than 'end'.
+        ColumnMask evaluateColumns(const MarketDataColumns& columns, std::size_t begin, std::size_t end) const;
+
+        const std::vector<Op>& ops() const { return ops_; }
+        std::size_t maxStackDepth() const { return max_depth_; }
+        bool empty() const { return ops_.empty(); }
+
+        // --- Emitters used by ICondition::compile ---
+        void emitFalse();
+        void emitFieldVsValue(PriceField field, ComparisonOp cmp, double value);
+        void emitFieldVsField(PriceField lhs, ComparisonOp cmp, PriceField rhs);
+        void emitFieldVsIndicator(PriceField field, ComparisonOp cmp, IndicatorSlot slot);
+        void emitIndicatorVsValue(IndicatorSlot slot, ComparisonOp cmp, double value);
+        void emitIndicatorVsIndicator(IndicatorSlot lhs, ComparisonOp cmp, IndicatorSlot rhs);
+        void emitCross(IndicatorSlot lhs, bool above, IndicatorSlot rhs);
+        void emitAnd(); // Combines the two values on top of the stack
+        void emitOr();
+
+        static CandleField candleField(PriceField field);
+
+    private:
+        void pushLeaf(const Op& op);
+        void pushCombine(OpCode code);
+
+        std::vector<Op> ops_;
+        std::size_t depth_ = 0;
+        std::size_t max_depth_ = 0;
+    };
+
+} // namespace strategy_engine
@@ -2,6 +2,7 @@
 
 #include "interfaces.hpp" // Include the base interface
 #include "common_types.hpp"
+#include <memory_resource>
 #include <string>
 #include <stdexcept>
 #include <variant> // To hold either a double value or a second indicator name
@@ -12,25 +13,33 @@ namespace strategy_engine {
     // Compares an indicator's value against a fixed value OR another indicator's value.
     class IndicatorCondition : public ICondition {
     public:
+        using allocator_type = std::pmr::polymorphic_allocator<>; // Names go where the condition is allocated
+
         // Constructor: Compare indicator to a fixed value
-        // e.g., IndicatorCondition("RSI(14)", ComparisonOp::LT, 30.0) -> "RSI(14) < 30.0"
-        IndicatorCondition(const std::string& indicator_name1, ComparisonOp op, double value);
+        // e.g., IndicatorCondition("RSI(14)", 0, ComparisonOp::LT, 30.0) -> "RSI(14) < 30.0"
+        IndicatorCondition(const std::string& indicator_name1, IndicatorSlot slot1, ComparisonOp op, double value,
+                           const allocator_type& allocator = {});
 
         // Constructor: Compare indicator to another indicator
-        // e.g., IndicatorCondition("SMA(50)", ComparisonOp::GT, "SMA(200)") -> "SMA(50) > SMA(200)"
-        IndicatorCondition(const std::string& indicator_name1, ComparisonOp op, const std::string& indicator_name2);
+        // e.g., IndicatorCondition("SMA(50)", 0, ComparisonOp::GT, "SMA(200)", 1) -> "SMA(50) > SMA(200)"
+        IndicatorCondition(const std::string& indicator_name1, IndicatorSlot slot1, ComparisonOp op,
+                           const std::string& indicator_name2, IndicatorSlot slot2,
+                           const allocator_type& allocator = {});
 
         virtual ~IndicatorCondition() override = default;
 
         // ICondition interface implementation
         bool evaluate(const MarketDataSnapshot& snapshot) const override;
         std::string describe() const override;
+        void compile(ConditionProgram& program) const override;
 
     private:
-        std::string indicator_name1_;
+        std::pmr::string indicator_name1_;
+        IndicatorSlot slot1_;
         ComparisonOp op_;
         // Use std::variant to hold either the comparison value or the second indicator name
-        std::variant<double, std::string> rhs_;
+        std::variant<double, std::pmr::string> rhs_;
+        IndicatorSlot slot2_ = 0; // Only meaningful when comparing to another indicator
         bool compare_to_value_; // Flag to know which type is in rhs_
 
         // Helper
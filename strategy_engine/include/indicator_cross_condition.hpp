@@ -2,6 +2,7 @@
 
 #include "interfaces.hpp"
 #include "common_types.hpp" // For ComparisonOp (though maybe not needed)
+#include <memory_resource>
 #include <string>
 #include <stdexcept>
 
@@ -17,21 +18,29 @@ namespace strategy_engine {
     // Checks if indicator1 crossed above/below indicator2 in the current step.
     class IndicatorCrossCondition : public ICondition {
     public:
-        // Constructor: e.g., IndicatorCrossCondition("SMA(10)", CrossType::CrossesAbove, "SMA(20)")
+        using allocator_type = std::pmr::polymorphic_allocator<>; // Names go where the condition is allocated
+
+        // Constructor: e.g., IndicatorCrossCondition("SMA(10)", 0, CrossType::CrossesAbove, "SMA(20)", 1)
         IndicatorCrossCondition(std::string indicator1_name,
+                                IndicatorSlot indicator1_slot,
                                 CrossType cross_type,
-                                std::string indicator2_name);
+                                std::string indicator2_name,
+                                IndicatorSlot indicator2_slot,
+                                const allocator_type& allocator = {});
 
         virtual ~IndicatorCrossCondition() override = default;
 
         // ICondition interface implementation
         bool evaluate(const MarketDataSnapshot& snapshot) const override;
         std::string describe() const override;
+        void compile(ConditionProgram& program) const override;
 
     private:
-        std::string indicator1_name_;
+        std::pmr::string indicator1_name_;
+        IndicatorSlot indicator1_slot_;
         CrossType cross_type_;
-        std::string indicator2_name_;
+        std::pmr::string indicator2_name_;
+        IndicatorSlot indicator2_slot_;
 
         // Helper
          std::string crosstype_to_string(CrossType type) const;
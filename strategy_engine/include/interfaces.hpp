@@ -3,11 +3,14 @@
 #include <vector>
 #include <string>
 #include <memory> // For std::unique_ptr
-#include <map>    // For potential indicator results map
+#include <span>   // For slot-indexed indicator columns
+#include <cstddef>
+#include <cstdint>
 
 // Forward declarations or include necessary core types
 #include "datatypes.hpp" // Provides Candle, SignalAction, TimeSeries etc.
 #include "common_types.hpp"  // <<<--- ADD THIS INCLUDE (Provides enums like SizingMethod)
+#include "arena.hpp"         // Rules and conditions may live in a per-run arena
 
 namespace strategy_engine {
 
@@ -17,13 +20,50 @@ namespace strategy_engine {
         core::Timestamp current_time;
         const core::Candle* previous_candle = nullptr;
         const core::Candle* current_candle = nullptr; // Pointer to current primary candle
-        // Map to hold indicator results (e.g., "SMA(10)" -> 123.45)
-        // Using double directly for simplicity now, could use TimeSeries<double>::value_type
-        std::map<std::string, double> indicator_values;
-        // TODO: Add access to previous candles/indicators if needed by conditions
-        std::map<std::string, double> indicator_values_prev; // <<<--- ADDED
+        // Indicator values indexed by slot (the position of the indicator in
+        // IStrategy::getRequiredIndicatorNames()). The backing buffers are owned
+        // by the caller and reused bar to bar; missing values are NaN.
+        std::span<const double> indicator_values;
+        std::span<const double> indicator_values_prev;
+
+        double indicatorValue(IndicatorSlot slot) const {
+            return slot < indicator_values.size() ? indicator_values[slot] : kMissingIndicatorValue;
+        }
+        double previousIndicatorValue(IndicatorSlot slot) const {
+            return slot < indicator_values_prev.size() ? indicator_values_prev[slot] : kMissingIndicatorValue;
+        }
+    };
+
+    // --- Whole-series (vectorized) evaluation inputs ---
+    // One indicator's results: values[k] belongs to bar first_bar + k.
+    // Bars outside that range have no value (NaN in the per-bar snapshot).
+    struct IndicatorColumn {
+        std::span<const double> values;
+        std::size_t first_bar = 0;
     };
 
+    // Column view of a bar series plus its indicators, indexed by slot like
+    // MarketDataSnapshot::indicator_values. Price columns have bar_count entries.
+    struct MarketDataColumns {
+        std::size_t bar_count = 0;
+        std::span<const double> open;
+        std::span<const double> high;
+        std::span<const double> low;
+        std::span<const double> close;
+        std::span<const IndicatorColumn> indicators;
+    };
+
+    // One byte per bar (0 or 1), so AND/OR over whole masks vectorize
+    using ColumnMask = std::vector<std::uint8_t>;
+
+    // A signal produced by whole-series evaluation, at an absolute bar index
+    struct SignalEvent {
+        std::size_t bar = 0;
+        core::SignalAction action = core::SignalAction::None;
+    };
+
+    class ConditionProgram; // condition_program.hpp
+
     // --- Condition Interface ---
     // Represents a single logical condition (e.g., price > SMA, RSI < 30)
     class ICondition {
@@ -33,8 +73,14 @@ namespace strategy_engine {
         virtual bool evaluate(const MarketDataSnapshot& snapshot) const = 0;
         // Optional: Get a description of the condition
         virtual std::string describe() const = 0;
+        // Appends this condition's ops to 'program' (postfix; leaves exactly one
+        // value on the program's stack). evaluate() remains the reference semantics.
+        virtual void compile(ConditionProgram& program) const = 0;
     };
 
+    // Owning pointer to a condition on the heap or in a core::Arena (see StrategyFactory)
+    using ConditionPtr = core::ArenaPtr<ICondition>;
+
     // --- Rule Interface ---
     // Represents an entry or exit rule, typically composed of one or more conditions
     class IRule {
@@ -48,8 +94,16 @@ namespace strategy_engine {
             // Get the name of the rule (implemented by derived classes like Rule)
             virtual std::string getName() const = 0;
             // --- END ADDITION ---
+            // Action returned when the rule's condition holds
+            virtual core::SignalAction getAction() const = 0;
+            // Evaluates the condition for bars [begin, end) into 'mask' (one entry per bar).
+            // Returns false if this rule only supports per-bar evaluation.
+            virtual bool evaluateColumns(const MarketDataColumns& /*columns*/, std::size_t /*begin*/,
+                                         std::size_t /*end*/, ColumnMask& /*mask*/) const { return false; }
     };
 
+    using RulePtr = core::ArenaPtr<IRule>;
+
     // --- Strategy Interface ---
     // Represents a complete trading strategy
     class IStrategy {
@@ -60,9 +114,24 @@ namespace strategy_engine {
             virtual std::string getName() const = 0;
             virtual const std::vector<std::string>& getRequiredInstruments() const = 0;
             virtual const std::vector<std::string>& getRequiredTimeframes() const = 0;
+            // Index in this vector is the indicator's slot in MarketDataSnapshot
             virtual const std::vector<std::string>& getRequiredIndicatorNames() const = 0;
             virtual core::SignalAction evaluate(const MarketDataSnapshot& snapshot) = 0;
             virtual core::PositionState getCurrentPosition() const = 0;
+            // Overrides the position state when fills differ from the signals (orders that
+            // fill later or never, stop-outs), so the next evaluate() starts from the real position
+            virtual void setCurrentPosition(core::PositionState /*position*/) {}
+
+            // Whole-series alternative to calling evaluate() once per bar: appends the
+            // signals evaluate() would return for bars [begin, end), in bar order, and
+            // leaves the position state as evaluate() would. Returns false (without
+            // changing any state) if the strategy needs per-bar evaluation.
+            virtual bool generateSignals(const MarketDataColumns& /*columns*/, std::size_t /*begin*/,
+                                         std::size_t /*end*/, std::vector<SignalEvent>& /*signals*/) { return false; }
+
+            // Rules evaluated so far, counting one per rule per bar for both
+            // evaluate() and generateSignals(). For run statistics only.
+            virtual std::uint64_t getRuleEvaluationCount() const { return 0; }
     
             // --- ADD THESE SIZING GETTERS BACK ---
             virtual SizingMethod getSizingMethod() const = 0;
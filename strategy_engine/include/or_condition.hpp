@@ -2,7 +2,7 @@
 
 #include "interfaces.hpp"
 #include <vector>
-#include <memory> // For std::unique_ptr
+#include <memory_resource>
 #include <string>
 #include <numeric> // For std::accumulate (optional for describe)
 
@@ -13,17 +13,20 @@ namespace strategy_engine {
     // Evaluates to true if ANY contained conditions evaluate to true.
     class OrCondition : public ICondition {
     public:
+        using allocator_type = std::pmr::polymorphic_allocator<>; // Arena placement, see core::makeArenaPtr
+
         // Constructor takes ownership of a vector of conditions
-        explicit OrCondition(std::vector<std::unique_ptr<ICondition>> conditions);
+        explicit OrCondition(std::pmr::vector<ConditionPtr> conditions, const allocator_type& allocator = {});
 
         virtual ~OrCondition() override = default;
 
         // ICondition interface implementation
         bool evaluate(const MarketDataSnapshot& snapshot) const override;
         std::string describe() const override;
+        void compile(ConditionProgram& program) const override;
 
     private:
-        std::vector<std::unique_ptr<ICondition>> conditions_;
+        std::pmr::vector<ConditionPtr> conditions_;
     };
 
 } // namespace strategy_engine
\ No newline at end of file
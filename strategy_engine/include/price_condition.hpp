@@ -24,6 +24,7 @@ namespace strategy_engine {
         // ICondition interface implementation
         bool evaluate(const MarketDataSnapshot& snapshot) const override;
         std::string describe() const override;
+        void compile(ConditionProgram& program) const override;
 
     private:
         PriceField field1_;
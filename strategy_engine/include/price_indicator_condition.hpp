@@ -2,6 +2,7 @@
 
 #include "interfaces.hpp"
 #include "common_types.hpp" // For PriceField, ComparisonOp
+#include <memory_resource>
 #include <string>
 #include <stdexcept>
 
@@ -11,19 +12,24 @@ namespace strategy_engine {
     // Compares a candle price field against a named indicator's value.
     class PriceIndicatorCondition : public ICondition {
     public:
-        // Constructor: e.g., PriceIndicatorCondition(PriceField::Close, ComparisonOp::GT, "SMA(10)") -> "Close > SMA(10)"
-        PriceIndicatorCondition(PriceField price_field, ComparisonOp op, std::string indicator_name);
+        using allocator_type = std::pmr::polymorphic_allocator<>; // Names go where the condition is allocated
+
+        // Constructor: e.g., PriceIndicatorCondition(PriceField::Close, ComparisonOp::GT, "SMA(10)", 0) -> "Close > SMA(10)"
+        PriceIndicatorCondition(PriceField price_field, ComparisonOp op, std::string indicator_name, IndicatorSlot indicator_slot,
+                                const allocator_type& allocator = {});
 
         virtual ~PriceIndicatorCondition() override = default;
 
         // ICondition interface implementation
         bool evaluate(const MarketDataSnapshot& snapshot) const override;
         std::string describe() const override;
+        void compile(ConditionProgram& program) const override;
 
     private:
         PriceField price_field_;
         ComparisonOp op_;
-        std::string indicator_name_;
+        std::pmr::string indicator_name_;
+        IndicatorSlot indicator_slot_;
 
         // Helpers (can be shared later)
         double get_price_value(const core::Candle& candle, PriceField field) const;
@@ -1,20 +1,26 @@
 #pragma once
 
 #include "interfaces.hpp" // Includes ICondition, IRule, SignalAction etc.
+#include "condition_program.hpp"
 #include <string>
-#include <memory> // For std::unique_ptr
+#include <memory_resource>
 
 namespace strategy_engine {
 
     // --- Rule Class ---
     // Represents a single trading rule (e.g., an entry rule or an exit rule).
     // It holds a condition and the action to take if the condition evaluates to true.
+    // The condition tree is compiled into a ConditionProgram on construction and
+    // evaluate() runs the program; evaluateReference() walks the original tree.
     class Rule : public IRule {
     public:
+        using allocator_type = std::pmr::polymorphic_allocator<>; // The name goes where the rule is allocated
+
         // Constructor: Takes a name, ownership of a condition object, and the action.
-        Rule(std::string rule_name,
-             std::unique_ptr<ICondition> condition,
-             core::SignalAction action_on_true);
+        Rule(const std::string& rule_name,
+             ConditionPtr condition,
+             core::SignalAction action_on_true,
+             const allocator_type& allocator = {});
 
         virtual ~Rule() override = default;
 
@@ -22,12 +28,22 @@ namespace strategy_engine {
         core::SignalAction evaluate(const MarketDataSnapshot& snapshot) const override;
         std::string describe() const override;
 
+        core::SignalAction getAction() const override { return action_; }
+        // Runs the compiled program over whole columns
+        bool evaluateColumns(const MarketDataColumns& columns, std::size_t begin,
+                             std::size_t end, ColumnMask& mask) const override;
+
+        // Same result as evaluate(), computed through the ICondition tree
+        core::SignalAction evaluateReference(const MarketDataSnapshot& snapshot) const;
+        const ConditionProgram& getProgram() const { return program_; }
+
         // Getter for the rule name
-        std::string getName() const override { return name_; }
+        std::string getName() const override { return std::string(name_); }
 
     private:
-        std::string name_;
-        std::unique_ptr<ICondition> condition_; // The condition to evaluate
+        std::pmr::string name_;
+        ConditionPtr condition_;                // The condition to evaluate
+        ConditionProgram program_;              // Compiled form of condition_
         core::SignalAction action_;             // Action to return if condition is true
     };
 
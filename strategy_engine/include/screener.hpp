@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "datatypes.hpp"
+#include "common_types.hpp"
+
+namespace strategy_engine {
+
+    // One cross-sectional filter: column <op> value, or column <op> column2
+    struct ScreenFilter {
+        std::string column;  // "open", "high", "low", "close", "volume" or an indicator, e.g. "SMA(200)"
+        ComparisonOp op = ComparisonOp::GT;
+        std::string column2; // Compared with this column when set, otherwise with 'value'
+        double value = 0.0;
+    };
+
+    // --- ScreenSpec ---
+    // A screen over a universe of instruments, evaluated on every instrument's latest
+    // bar at once, e.g. "top 20 by RSI(14) among those with close > SMA(200)":
+    //   { "screener_name": "RsiLeaders", "timeframe": "day",
+    //     "universe": { "index": "NSE_INDEX|Nifty 50" },
+    //     "filters": [ { "column": "close", "op": ">", "column2": "SMA(200)" },
+    //                  { "column": "RSI(14)", "op": "<", "value": 80 } ],
+    //     "rank_by": "RSI(14)", "order": "desc", "top": 20 }
+    // The universe block (and "instruments") is resolved by the runners, which know
+    // the data source; see backtester::ScreenerRun.
+    struct ScreenSpec {
+        std::string name;
+        std::string timeframe = "day";
+        std::vector<ScreenFilter> filters; // All must hold
+        std::string rank_by;               // Empty = no ranking: every passing instrument, in universe order
+        bool descending = true;
+        std::size_t top = 0;               // 0 = every instrument that passes
+
+        // Distinct indicator columns the filters and rank_by use, sorted
+        std::vector<std::string> indicatorNames() const;
+
+        // Throws std::invalid_argument for a malformed screen (unknown operator or
+        // order, no filters and no rank_by, indicators on another timeframe)
+        static ScreenSpec fromJson(const nlohmann::json& config);
+    };
+
+    // --- ScreenMatrix ---
+    // Latest values of every instrument (rows) for every screened field (columns),
+    // stored column by column so a filter is one contiguous scan. NaN = no value.
+    class ScreenMatrix {
+    public:
+        ScreenMatrix(std::size_t rows, std::size_t columns);
+
+        std::size_t rows() const { return rows_; }
+        std::size_t columns() const { return columns_; }
+
+        double& at(std::size_t row, std::size_t column) { return values_[column * rows_ + row]; }
+        double at(std::size_t row, std::size_t column) const { return values_[column * rows_ + row]; }
+        std::span<const double> column(std::size_t column) const {
+            return std::span<const double>(values_).subspan(column * rows_, rows_);
+        }
+
+        void clearRow(std::size_t row);
+
+    private:
+        std::size_t rows_ = 0;
+        std::size_t columns_ = 0;
+        std::vector<double> values_;
+    };
+
+    struct ScreenHit {
+        std::size_t row = 0;     // Index into Screener::instruments()
+        double value = kMissingIndicatorValue; // rank_by value (NaN without ranking)
+    };
+
+    struct ScreenResult {
+        std::vector<ScreenHit> hits; // Best first (universe order without ranking), at most 'top'
+        std::size_t passed = 0;      // Instruments passing every filter, before the top-K cut
+    };
+
+    // --- Screener ---
+    // Keeps each instrument's latest bar and indicator values in a ScreenMatrix and
+    // evaluates the screen across all of them: every filter is a branch-free scan
+    // down its column into a byte mask, then the passing rows are ranked with a
+    // partial sort that only orders the top K. Rows without a value in a filtered
+    // or ranked column do not pass (NaN compares false), so instruments that have
+    // not traded yet or are still warming up drop out by themselves.
+    //
+    // Columns: open, high, low, close, volume, then spec.indicatorNames().
+    // Not thread-safe; update() and scan() from one thread.
+    class Screener {
+    public:
+        static constexpr std::size_t kPriceColumns = 5;
+
+        // Throws std::invalid_argument for an empty or duplicated instrument list
+        Screener(ScreenSpec spec, std::vector<std::string> instruments);
+
+        const ScreenSpec& spec() const { return spec_; }
+        const std::vector<std::string>& instruments() const { return instruments_; }
+        // Order of the values update() takes
+        const std::vector<std::string>& indicatorNames() const { return indicator_names_; }
+        std::optional<std::size_t> findInstrument(const std::string& instrument_key) const;
+        // Column of "close", "SMA(200)", ...; nullopt if the screen does not use it
+        std::optional<std::size_t> findColumn(const std::string& name) const;
+
+        // Latest bar of one instrument with its indicator values in indicatorNames()
+        // order (missing values NaN). Throws std::invalid_argument for a bad row or
+        // the wrong number of values.
+        void update(std::size_t row, const core::Candle& bar, std::span<const double> indicator_values);
+        void clear(std::size_t row) { matrix_.clearRow(row); }
+
+        const ScreenMatrix& matrix() const { return matrix_; }
+
+        // The result stays valid until the next scan()
+        const ScreenResult& scan();
+
+    private:
+        struct ResolvedFilter {
+            std::size_t column = 0;
+            ComparisonOp op = ComparisonOp::GT;
+            std::optional<std::size_t> column2;
+            double value = 0.0;
+        };
+
+        std::size_t resolveColumn(const std::string& name) const;
+
+        ScreenSpec spec_;
+        std::vector<std::string> instruments_;
+        std::unordered_map<std::string, std::size_t> rows_;
+        std::vector<std::string> indicator_names_;
+        std::vector<ResolvedFilter> filters_;
+        std::optional<std::size_t> rank_column_;
+        ScreenMatrix matrix_;
+
+        // Reused by every scan()
+        std::vector<std::uint8_t> mask_;
+        ScreenResult result_;
+    };
+
+} // namespace strategy_engine
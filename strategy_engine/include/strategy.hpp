@@ -6,7 +6,9 @@
 #include <string>
 #include <vector>
 #include <memory>      // For std::unique_ptr
+#include <memory_resource>
 #include <map>         // For parameters
+#include <cstdint>
 
 namespace strategy_engine {
 
@@ -21,8 +23,8 @@ namespace strategy_engine {
             std::vector<std::string> required_instruments,
             std::vector<std::string> required_timeframes,
             std::vector<std::string> required_indicator_names,
-            std::vector<std::unique_ptr<IRule>> entry_rules,
-            std::vector<std::unique_ptr<IRule>> exit_rules,
+            std::pmr::vector<RulePtr> entry_rules,
+            std::pmr::vector<RulePtr> exit_rules,
             SizingMethod sizing_method,
             double sizing_value,
             bool is_sizing_value_percentage // Flag for CapitalBased method
@@ -36,13 +38,23 @@ namespace strategy_engine {
         const std::vector<std::string>& getRequiredTimeframes() const override;
         const std::vector<std::string>& getRequiredIndicatorNames() const override;
         core::SignalAction evaluate(const MarketDataSnapshot& snapshot) override;
+        // Builds one mask per rule, then steps the position state machine only
+        // through the bars where a relevant mask is set
+        bool generateSignals(const MarketDataColumns& columns, std::size_t begin,
+                             std::size_t end, std::vector<SignalEvent>& signals) override;
 
         SizingMethod getSizingMethod() const override { return sizing_method_; }
         double getSizingValue() const override { return sizing_value_; }
         bool isSizingValuePercentage() const override { return is_sizing_value_percentage_; }
+        std::uint64_t getRuleEvaluationCount() const override { return rule_evaluations_; }
         
+        // Rules in evaluation order (CompiledStrategy::fromStrategy reads their programs)
+        const std::pmr::vector<RulePtr>& getEntryRules() const { return entry_rules_; }
+        const std::pmr::vector<RulePtr>& getExitRules() const { return exit_rules_; }
+
         // Get current position state (needed for backtester/execution)
         core::PositionState getCurrentPosition() const; 
+        void setCurrentPosition(core::PositionState position) override { current_position_ = position; }
 
     private:
         std::string name_;
@@ -50,10 +62,12 @@ namespace strategy_engine {
         std::vector<std::string> required_instruments_;
         std::vector<std::string> required_timeframes_;
         std::vector<std::string> required_indicator_names_;
-        std::vector<std::unique_ptr<IRule>> entry_rules_;
-        std::vector<std::unique_ptr<IRule>> exit_rules_;
+        // Rules keep the memory resource they were built with (an arena or the heap)
+        std::pmr::vector<RulePtr> entry_rules_;
+        std::pmr::vector<RulePtr> exit_rules_;
 
         core::PositionState current_position_ = core::PositionState::None; // Track current state
+        std::uint64_t rule_evaluations_ = 0;
         SizingMethod sizing_method_;
         double sizing_value_;
         bool is_sizing_value_percentage_;
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "compiled_strategy.hpp"
+
+namespace strategy_engine {
+
+    // A strategy compiled into the binary at build time (see TP_EMBED_STRATEGIES)
+    struct EmbeddedStrategy {
+        const char* source = "";     // File it was compiled from, e.g. "sma_10_20_corss.json"
+        std::uint64_t key = 0;       // StrategyCache::key() of that file
+        std::string_view serialized; // CompiledStrategy::serialize() output
+    };
+
+    // Strategies compiled from strategies/*.json. Defined by the generated
+    // strategy_embedded library (empty when TP_EMBED_STRATEGIES is OFF).
+    const std::vector<EmbeddedStrategy>& embeddedStrategies();
+
+    struct StrategyCacheStats {
+        std::uint64_t hits = 0;      // Served from memory (including preloaded strategies)
+        std::uint64_t disk_hits = 0; // Loaded from the disk tier
+        std::uint64_t misses = 0;    // Parsed from JSON
+        std::uint64_t failures = 0;  // Invalid configs (never cached)
+        std::size_t entries = 0;
+    };
+
+    // --- StrategyCache ---
+    // Thread-safe store of compiled strategies keyed by a hash of the config keys
+    // StrategyFactory reads. The instrument list is not part of the key: a universe
+    // or a per-instrument backtest compiles the rules once and instantiates them for
+    // each instrument list. StrategyFactory::createStrategy() goes through shared().
+    //
+    // Optional disk tier: with a directory, each compiled strategy is also written as
+    // <directory>/<key>.tpstrat and reused by later processes, which then skip JSON
+    // parsing and validation for strategies they have seen before.
+    class StrategyCache {
+    public:
+        using CompiledPtr = std::shared_ptr<const CompiledStrategy>;
+
+        // The process-wide cache
+        static StrategyCache& shared();
+
+        // At most 'capacity' parsed strategies are kept (oldest dropped first);
+        // preloaded ones do not count and are never dropped
+        explicit StrategyCache(std::size_t capacity = 256);
+
+        // Compiled form of 'config': from memory, from disk, or parsed with
+        // StrategyFactory::parseStrategy() on a miss. nullptr if the config is invalid
+        // (errors are logged by the parser); failures are not cached.
+        CompiledPtr compile(const nlohmann::json& config);
+
+        void preload(std::uint64_t key, CompiledPtr compiled);
+        // Deserializes and preloads each strategy; returns how many were accepted
+        std::size_t preloadEmbedded(const std::vector<EmbeddedStrategy>& strategies);
+
+        // Empty = memory only. Logs a warning and stays memory-only if the directory cannot be created.
+        void setDiskDirectory(const std::string& directory);
+        std::string diskDirectory() const;
+
+        std::size_t size() const;
+        StrategyCacheStats stats() const;
+        void clear(); // Memory only, preloaded strategies included; files on disk are kept
+
+        // FNV-1a over the canonical form (object keys in order, values with their
+        // JSON types) of 'strategy_name', 'timeframes', 'position_sizing',
+        // 'entry_rules' and 'exit_rules', and CompiledStrategy::kFormatVersion
+        static std::uint64_t key(const nlohmann::json& config);
+
+    private:
+        struct Entry {
+            CompiledPtr compiled;
+            bool pinned = false; // Preloaded
+        };
+
+        CompiledPtr insert(std::uint64_t key, CompiledPtr compiled, bool pinned);
+        CompiledPtr loadFromDisk(const std::string& path) const;
+        void storeToDisk(const std::string& path, const CompiledStrategy& compiled) const;
+
+        const std::size_t capacity_;
+        mutable std::mutex mutex_;
+        std::unordered_map<std::uint64_t, Entry> entries_;
+        std::deque<std::uint64_t> insertion_order_; // Unpinned keys, oldest first
+        std::string disk_directory_;
+        StrategyCacheStats stats_;
+    };
+
+} // namespace strategy_engine
@@ -8,6 +8,8 @@
 
 // Forward declare or include interfaces
 #include "interfaces.hpp"
+#include "common_types.hpp"
+#include "arena.hpp"
 
 namespace strategy_engine {
 
@@ -15,13 +17,24 @@ namespace strategy_engine {
 
     class StrategyFactory {
     public:
-        // Static method to create a strategy from a JSON config object
-        static std::unique_ptr<IStrategy> createStrategy(const json& config);
+        // Static method to create a strategy from a JSON config object.
+        // With an arena, every rule and condition (with its names and child list) is
+        // allocated there, one after another; the strategy must be destroyed before
+        // the arena is released, and destroying it frees nothing beyond the Strategy
+        // object itself. Without one they come from the heap.
+        // The config is parsed and validated once per StrategyCache::shared() entry;
+        // later calls with the same rules instantiate the cached compiled form.
+        // Returns nullptr (errors logged) for an invalid config.
+        static std::unique_ptr<IStrategy> createStrategy(const json& config, core::Arena* arena = nullptr);
+
+        // Uncached: walks and validates the JSON on every call (what the cache runs on a miss)
+        static std::unique_ptr<IStrategy> parseStrategy(const json& config, core::Arena* arena = nullptr);
 
     private:
-        // Private helper methods for parsing components (can be implemented later)
-        static std::unique_ptr<ICondition> parseCondition(const json& condition_config);
-        static std::unique_ptr<IRule> parseRule(const json& rule_config);
+        // Private helper methods for parsing components.
+        // Indicator names are resolved to slots through 'slots' while parsing.
+        static ConditionPtr parseCondition(const json& condition_config, const IndicatorSlotMap& slots, core::Arena* arena);
+        static RulePtr parseRule(const json& rule_config, const IndicatorSlotMap& slots, core::Arena* arena);
         // Helper to get required indicator names from conditions (recursive)
         static void collectIndicatorNames(const json& condition_config, std::set<std::string>& names); // Changed vector to set
     };
@@ -1,10 +1,11 @@
 #include "and_condition.hpp"
+#include "condition_program.hpp"
 #include <sstream> // For describe()
 
 namespace strategy_engine {
 
-AndCondition::AndCondition(std::vector<std::unique_ptr<ICondition>> conditions)
-    : conditions_(std::move(conditions)) // Take ownership via move
+AndCondition::AndCondition(std::pmr::vector<ConditionPtr> conditions, const allocator_type& allocator)
+    : conditions_(std::move(conditions), allocator) // Take ownership via move
 {
     if (conditions_.empty()) {
         // Or should an empty AND condition be true? Let's forbid it for now.
@@ -21,6 +22,17 @@ bool AndCondition::evaluate(const MarketDataSnapshot& snapshot) const {
     return true; // All conditions evaluated to true
 }
 
+void AndCondition::compile(ConditionProgram& program) const {
+    for (size_t i = 0; i < conditions_.size(); ++i) {
+        if (conditions_[i]) {
+            conditions_[i]->compile(program);
+        } else {
+            program.emitFalse(); // Null child makes the AND false, as in evaluate()
+        }
+        if (i > 0) program.emitAnd();
+    }
+}
+
 std::string AndCondition::describe() const {
     if (conditions_.empty()) {
          return "(Empty AND)"; // Should not happen with constructor check
@@ -0,0 +1,345 @@
+#include "compiled_strategy.hpp"
+#include "strategy.hpp"
+#include "rule.hpp"
+#include "price_condition.hpp"
+#include "indicator_condition.hpp"
+#include "price_indicator_condition.hpp"
+#include "indicator_cross_condition.hpp"
+#include "and_condition.hpp"
+#include "or_condition.hpp"
+
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace strategy_engine {
+
+    namespace { // File-local helpers
+
+        using OpCode = ConditionProgram::OpCode;
+
+        constexpr char kMagic[4] = {'T', 'P', 'S', 'T'};
+
+        template <typename T>
+        void appendRaw(std::string& out, const T& value) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        void appendString(std::string& out, const std::string& value) {
+            appendRaw(out, static_cast<std::uint32_t>(value.size()));
+            out.append(value);
+        }
+
+        void appendStrings(std::string& out, const std::vector<std::string>& values) {
+            appendRaw(out, static_cast<std::uint32_t>(values.size()));
+            for (const auto& value : values) appendString(out, value);
+        }
+
+        void appendRules(std::string& out, const std::vector<CompiledRule>& rules) {
+            appendRaw(out, static_cast<std::uint32_t>(rules.size()));
+            for (const auto& rule : rules) {
+                appendString(out, rule.name);
+                appendRaw(out, static_cast<std::uint8_t>(rule.action));
+                appendRaw(out, static_cast<std::uint32_t>(rule.ops.size()));
+                for (const auto& op : rule.ops) {
+                    appendRaw(out, static_cast<std::uint8_t>(op.code));
+                    appendRaw(out, static_cast<std::uint8_t>(op.cmp));
+                    appendRaw(out, static_cast<std::uint8_t>(op.price_a));
+                    appendRaw(out, static_cast<std::uint8_t>(op.price_b));
+                    appendRaw(out, static_cast<std::uint32_t>(op.slot_a));
+                    appendRaw(out, static_cast<std::uint32_t>(op.slot_b));
+                    appendRaw(out, op.value);
+                }
+            }
+        }
+
+        // Bounds-checked cursor over serialized bytes; any short read clears ok
+        class ByteReader {
+        public:
+            explicit ByteReader(std::string_view bytes) : bytes_(bytes) {}
+
+            template <typename T>
+            T read() {
+                static_assert(std::is_trivially_copyable_v<T>);
+                T value{};
+                if (!ok_ || bytes_.size() - pos_ < sizeof(T)) {
+                    ok_ = false;
+                    return value;
+                }
+                std::memcpy(&value, bytes_.data() + pos_, sizeof(T));
+                pos_ += sizeof(T);
+                return value;
+            }
+
+            std::string readString() {
+                const auto length = read<std::uint32_t>();
+                if (!ok_ || bytes_.size() - pos_ < length) {
+                    ok_ = false;
+                    return {};
+                }
+                std::string value(bytes_.substr(pos_, length));
+                pos_ += length;
+                return value;
+            }
+
+            // Element counts are bounded by what is left, so garbage cannot reserve gigabytes
+            std::uint32_t readCount(std::size_t min_element_size) {
+                const auto count = read<std::uint32_t>();
+                if (ok_ && static_cast<std::size_t>(count) * min_element_size > bytes_.size() - pos_) ok_ = false;
+                return ok_ ? count : 0;
+            }
+
+            bool ok() const { return ok_; }
+            bool atEnd() const { return pos_ == bytes_.size(); }
+
+        private:
+            std::string_view bytes_;
+            std::size_t pos_ = 0;
+            bool ok_ = true;
+        };
+
+        constexpr std::size_t kSerializedOpSize = 4 * sizeof(std::uint8_t) + 2 * sizeof(std::uint32_t) + sizeof(double);
+
+        std::vector<std::string> readStrings(ByteReader& reader) {
+            std::vector<std::string> values(reader.readCount(sizeof(std::uint32_t)));
+            for (auto& value : values) value = reader.readString();
+            return values;
+        }
+
+        bool usesSlotA(OpCode code) {
+            return code == OpCode::IndicatorVsValue || code == OpCode::IndicatorVsIndicator ||
+                   code == OpCode::CrossAbove || code == OpCode::CrossBelow;
+        }
+
+        bool usesSlotB(OpCode code) {
+            return code == OpCode::FieldVsIndicator || code == OpCode::IndicatorVsIndicator ||
+                   code == OpCode::CrossAbove || code == OpCode::CrossBelow;
+        }
+
+        // Reads one rule and checks it can be rebuilt: known enums, slots in range
+        // and a program that leaves exactly one value on the stack
+        bool readRule(ByteReader& reader, std::size_t slot_count, CompiledRule& rule) {
+            rule.name = reader.readString();
+            const auto action = reader.read<std::uint8_t>();
+            if (action == static_cast<std::uint8_t>(core::SignalAction::None) ||
+                action > static_cast<std::uint8_t>(core::SignalAction::ExitShort)) {
+                return false;
+            }
+            rule.action = static_cast<core::SignalAction>(action);
+
+            rule.ops.resize(reader.readCount(kSerializedOpSize));
+            std::size_t depth = 0;
+            for (auto& op : rule.ops) {
+                const auto code = reader.read<std::uint8_t>();
+                const auto cmp = reader.read<std::uint8_t>();
+                const auto price_a = reader.read<std::uint8_t>();
+                const auto price_b = reader.read<std::uint8_t>();
+                op.slot_a = reader.read<std::uint32_t>();
+                op.slot_b = reader.read<std::uint32_t>();
+                op.value = reader.read<double>();
+                if (!reader.ok() || code > static_cast<std::uint8_t>(OpCode::Or) ||
+                    cmp > static_cast<std::uint8_t>(ComparisonOp::EQ) ||
+                    price_a > static_cast<std::uint8_t>(PriceField::Close) ||
+                    price_b > static_cast<std::uint8_t>(PriceField::Close)) {
+                    return false;
+                }
+                op.code = static_cast<OpCode>(code);
+                op.cmp = static_cast<ComparisonOp>(cmp);
+                op.price_a = static_cast<PriceField>(price_a);
+                op.price_b = static_cast<PriceField>(price_b);
+                if ((usesSlotA(op.code) && op.slot_a >= slot_count) || (usesSlotB(op.code) && op.slot_b >= slot_count)) {
+                    return false;
+                }
+                switch (op.code) {
+                    case OpCode::FieldVsValue:
+                    case OpCode::FieldVsIndicator:
+                        op.field_a = ConditionProgram::candleField(op.price_a);
+                        break;
+                    case OpCode::FieldVsField:
+                        op.field_a = ConditionProgram::candleField(op.price_a);
+                        op.field_b = ConditionProgram::candleField(op.price_b);
+                        break;
+                    default:
+                        break;
+                }
+                if (op.code == OpCode::And || op.code == OpCode::Or) {
+                    if (depth < 2) return false;
+                    --depth;
+                } else if (++depth > ConditionProgram::kMaxStackDepth) {
+                    return false;
+                }
+            }
+            return reader.ok() && depth == 1;
+        }
+
+        bool readRules(ByteReader& reader, std::size_t slot_count, std::vector<CompiledRule>& rules) {
+            rules.resize(reader.readCount(sizeof(std::uint32_t)));
+            for (auto& rule : rules) {
+                if (!readRule(reader, slot_count, rule)) return false;
+            }
+            return reader.ok();
+        }
+
+        // A condition being rebuilt: a finished subtree, or an AND/OR still taking children
+        struct PendingCondition {
+            ConditionPtr condition;            // Null for a PushFalse placeholder
+            OpCode chain = OpCode::PushFalse;  // And/Or while 'children' is open
+            std::pmr::vector<ConditionPtr> children;
+        };
+
+        ConditionPtr finish(PendingCondition&& pending, core::Arena* arena) {
+            if (pending.chain == OpCode::And) return core::makeArenaPtr<AndCondition>(arena, std::move(pending.children));
+            if (pending.chain == OpCode::Or) return core::makeArenaPtr<OrCondition>(arena, std::move(pending.children));
+            return std::move(pending.condition);
+        }
+
+        ConditionPtr makeLeaf(const ConditionProgram::Op& op, const std::vector<std::string>& names, core::Arena* arena) {
+            switch (op.code) {
+                case OpCode::PushFalse:
+                    return nullptr;
+                case OpCode::FieldVsValue:
+                    return core::makeArenaPtr<PriceCondition>(arena, op.price_a, op.cmp, op.value);
+                case OpCode::FieldVsField:
+                    return core::makeArenaPtr<PriceCondition>(arena, op.price_a, op.cmp, op.price_b);
+                case OpCode::FieldVsIndicator:
+                    return core::makeArenaPtr<PriceIndicatorCondition>(arena, op.price_a, op.cmp, names[op.slot_b], op.slot_b);
+                case OpCode::IndicatorVsValue:
+                    return core::makeArenaPtr<IndicatorCondition>(arena, names[op.slot_a], op.slot_a, op.cmp, op.value);
+                case OpCode::IndicatorVsIndicator:
+                    return core::makeArenaPtr<IndicatorCondition>(arena, names[op.slot_a], op.slot_a, op.cmp,
+                                                                  names[op.slot_b], op.slot_b);
+                case OpCode::CrossAbove:
+                case OpCode::CrossBelow:
+                    return core::makeArenaPtr<IndicatorCrossCondition>(
+                        arena, names[op.slot_a], op.slot_a,
+                        op.code == OpCode::CrossAbove ? CrossType::CrossesAbove : CrossType::CrossesBelow,
+                        names[op.slot_b], op.slot_b);
+                case OpCode::And:
+                case OpCode::Or:
+                    break;
+            }
+            throw std::invalid_argument("Compiled strategy: combinator is not a leaf condition.");
+        }
+
+        ConditionPtr rebuildCondition(const std::vector<ConditionProgram::Op>& ops,
+                                      const std::vector<std::string>& names, core::Arena* arena) {
+            std::vector<PendingCondition> stack;
+            for (const auto& op : ops) {
+                if (op.code != OpCode::And && op.code != OpCode::Or) {
+                    PendingCondition leaf;
+                    leaf.condition = makeLeaf(op, names, arena);
+                    stack.push_back(std::move(leaf));
+                    continue;
+                }
+                if (stack.size() < 2) throw std::invalid_argument("Compiled strategy: condition program underflows.");
+                PendingCondition rhs = std::move(stack.back());
+                stack.pop_back();
+                if (stack.back().chain == op.code) {
+                    stack.back().children.push_back(finish(std::move(rhs), arena)); // Extend the open chain
+                    continue;
+                }
+                PendingCondition lhs = std::move(stack.back());
+                stack.pop_back();
+                PendingCondition chain{nullptr, op.code, std::pmr::vector<ConditionPtr>(core::arenaResource(arena))};
+                chain.children.push_back(finish(std::move(lhs), arena));
+                chain.children.push_back(finish(std::move(rhs), arena));
+                stack.push_back(std::move(chain)); // Moving keeps the children in the arena
+            }
+            if (stack.size() != 1) throw std::invalid_argument("Compiled strategy: condition program does not reduce to one value.");
+            ConditionPtr condition = finish(std::move(stack.back()), arena);
+            if (!condition) throw std::invalid_argument("Compiled strategy: rule has no condition.");
+            return condition;
+        }
+
+        std::pmr::vector<RulePtr> rebuildRules(const std::vector<CompiledRule>& rules,
+                                               const std::vector<std::string>& names, core::Arena* arena) {
+            std::pmr::vector<RulePtr> rebuilt(core::arenaResource(arena));
+            rebuilt.reserve(rules.size());
+            for (const auto& rule : rules) {
+                rebuilt.push_back(core::makeArenaPtr<Rule>(arena, rule.name, rebuildCondition(rule.ops, names, arena), rule.action));
+            }
+            return rebuilt;
+        }
+
+        std::vector<CompiledRule> compileRules(const std::pmr::vector<RulePtr>& rules) {
+            std::vector<CompiledRule> compiled;
+            compiled.reserve(rules.size());
+            for (const auto& rule : rules) {
+                const auto* concrete = dynamic_cast<const Rule*>(rule.get());
+                if (!concrete) throw std::invalid_argument("Compiled strategy: only strategy_engine::Rule rules can be compiled.");
+                compiled.push_back({concrete->getName(), concrete->getAction(), concrete->getProgram().ops()});
+            }
+            return compiled;
+        }
+
+    } // end anonymous namespace
+
+    CompiledStrategy CompiledStrategy::fromStrategy(const Strategy& strategy) {
+        CompiledStrategy compiled;
+        compiled.name = strategy.getName();
+        compiled.timeframes = strategy.getRequiredTimeframes();
+        compiled.indicator_names = strategy.getRequiredIndicatorNames();
+        compiled.sizing_method = strategy.getSizingMethod();
+        compiled.sizing_value = strategy.getSizingValue();
+        compiled.is_sizing_value_percentage = strategy.isSizingValuePercentage();
+        compiled.entry_rules = compileRules(strategy.getEntryRules());
+        compiled.exit_rules = compileRules(strategy.getExitRules());
+        return compiled;
+    }
+
+    std::unique_ptr<IStrategy> CompiledStrategy::instantiate(std::vector<std::string> instruments, core::Arena* arena) const {
+        return std::make_unique<Strategy>(
+            name,
+            std::move(instruments),
+            timeframes,
+            indicator_names,
+            rebuildRules(entry_rules, indicator_names, arena),
+            rebuildRules(exit_rules, indicator_names, arena),
+            sizing_method,
+            sizing_value,
+            is_sizing_value_percentage);
+    }
+
+    std::string CompiledStrategy::serialize() const {
+        std::string out;
+        out.append(kMagic, sizeof(kMagic));
+        appendRaw(out, kFormatVersion);
+        appendString(out, name);
+        appendStrings(out, timeframes);
+        appendStrings(out, indicator_names);
+        appendRaw(out, static_cast<std::uint8_t>(sizing_method));
+        appendRaw(out, sizing_value);
+        appendRaw(out, static_cast<std::uint8_t>(is_sizing_value_percentage ? 1 : 0));
+        appendRules(out, entry_rules);
+        appendRules(out, exit_rules);
+        return out;
+    }
+
+    std::optional<CompiledStrategy> CompiledStrategy::deserialize(std::string_view bytes) {
+        if (bytes.size() < sizeof(kMagic) || std::memcmp(bytes.data(), kMagic, sizeof(kMagic)) != 0) return std::nullopt;
+        ByteReader reader(bytes.substr(sizeof(kMagic)));
+        if (reader.read<std::uint32_t>() != kFormatVersion) return std::nullopt;
+
+        CompiledStrategy compiled;
+        compiled.name = reader.readString();
+        compiled.timeframes = readStrings(reader);
+        compiled.indicator_names = readStrings(reader);
+        const auto sizing_method = reader.read<std::uint8_t>();
+        compiled.sizing_value = reader.read<double>();
+        const auto is_percentage = reader.read<std::uint8_t>();
+        if (!reader.ok() || sizing_method > static_cast<std::uint8_t>(SizingMethod::CapitalBased) || is_percentage > 1) {
+            return std::nullopt;
+        }
+        compiled.sizing_method = static_cast<SizingMethod>(sizing_method);
+        compiled.is_sizing_value_percentage = is_percentage == 1;
+        if (!readRules(reader, compiled.indicator_names.size(), compiled.entry_rules) ||
+            !readRules(reader, compiled.indicator_names.size(), compiled.exit_rules) || !reader.atEnd()) {
+            return std::nullopt;
+        }
+        return compiled;
+    }
+
+} // namespace strategy_engine
@@ -0,0 +1,372 @@
+#include "condition_program.hpp"
+#include "spdlog/fmt/bundled/core.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+
+namespace strategy_engine {
+
+namespace {
+
+// Stand-in for a missing current candle: every comparison against NaN is
+// false, which is what the tree's price conditions return in that case.
+const core::Candle& missingCandle() {
+    static const core::Candle candle = [] {
+        core::Candle c;
+        c.open = c.high = c.low = c.close = kMissingIndicatorValue;
+        return c;
+    }();
+    return candle;
+}
+
+inline bool compareValues(ComparisonOp cmp, double lhs, double rhs) {
+    switch (cmp) {
+        case ComparisonOp::GT:  return lhs > rhs;
+        case ComparisonOp::LT:  return lhs < rhs;
+        case ComparisonOp::GTE: return lhs >= rhs;
+        case ComparisonOp::LTE: return lhs <= rhs;
+        case ComparisonOp::EQ:  return std::fabs(lhs - rhs) < 1e-9; // Same tolerance as the conditions
+    }
+    return false;
+}
+
+// --- Column kernels ---
+// lhs/rhs map a local index j to a value; the comparison is hoisted out of the
+// loop so each instantiation is a branch-free loop the compiler can vectorize.
+template <typename Lhs, typename Rhs>
+void compareKernel(ComparisonOp cmp, std::uint8_t* out, std::size_t lo, std::size_t hi, Lhs lhs, Rhs rhs) {
+    switch (cmp) {
+        case ComparisonOp::GT:  for (std::size_t j = lo; j < hi; ++j) out[j] = lhs(j) > rhs(j); break;
+        case ComparisonOp::LT:  for (std::size_t j = lo; j < hi; ++j) out[j] = lhs(j) < rhs(j); break;
+        case ComparisonOp::GTE: for (std::size_t j = lo; j < hi; ++j) out[j] = lhs(j) >= rhs(j); break;
+        case ComparisonOp::LTE: for (std::size_t j = lo; j < hi; ++j) out[j] = lhs(j) <= rhs(j); break;
+        case ComparisonOp::EQ:
+            for (std::size_t j = lo; j < hi; ++j) out[j] = std::fabs(lhs(j) - rhs(j)) < 1e-9;
+            break;
+    }
+}
+
+std::span<const double> priceColumn(const MarketDataColumns& columns, PriceField field) {
+    switch (field) {
+        case PriceField::Open:  return columns.open;
+        case PriceField::High:  return columns.high;
+        case PriceField::Low:   return columns.low;
+        case PriceField::Close: return columns.close;
+    }
+    return {};
+}
+
+// Slot's column, or an empty one (no values anywhere) for unknown slots
+IndicatorColumn indicatorColumn(const MarketDataColumns& columns, IndicatorSlot slot) {
+    return slot < columns.indicators.size() ? columns.indicators[slot] : IndicatorColumn{};
+}
+
+// Bars [first_bar, first_bar + size) that have a value, clipped to [begin, end)
+// and returned as local indices. 'history' extra bars are required before each
+// bar (1 for crosses, which also read the previous value).
+struct LocalRange {
+    std::size_t lo;
+    std::size_t hi;
+};
+
+LocalRange validRange(const IndicatorColumn& column, std::size_t history, std::size_t begin, std::size_t end) {
+    const std::size_t first = column.first_bar + history;
+    const std::size_t last = column.first_bar + column.values.size(); // exclusive
+    const std::size_t lo = std::max(first, begin);
+    const std::size_t hi = std::min(last, end);
+    return lo < hi ? LocalRange{lo - begin, hi - begin} : LocalRange{0, 0};
+}
+
+LocalRange intersect(LocalRange a, LocalRange b) {
+    const std::size_t lo = std::max(a.lo, b.lo);
+    const std::size_t hi = std::min(a.hi, b.hi);
+    return lo < hi ? LocalRange{lo, hi} : LocalRange{0, 0};
+}
+
+} // anonymous namespace
+
+ConditionProgram ConditionProgram::compile(const ICondition& condition) {
+    ConditionProgram program;
+    condition.compile(program);
+    if (program.depth_ != 1) {
+        throw std::invalid_argument(fmt::format(
+            "Condition '{}' did not compile to a single value (stack depth {}).",
+            condition.describe(), program.depth_));
+    }
+    program.ops_.shrink_to_fit();
+    return program;
+}
+
+ConditionProgram::CandleField ConditionProgram::candleField(PriceField field) {
+    switch (field) {
+        case PriceField::Open:  return &core::Candle::open;
+        case PriceField::High:  return &core::Candle::high;
+        case PriceField::Low:   return &core::Candle::low;
+        case PriceField::Close: return &core::Candle::close;
+    }
+    throw std::invalid_argument("Invalid PriceField in condition program.");
+}
+
+void ConditionProgram::pushLeaf(const Op& op) {
+    if (depth_ + 1 > kMaxStackDepth) {
+        throw std::invalid_argument(fmt::format(
+            "Condition nests deeper than the supported {} levels.", kMaxStackDepth));
+    }
+    ops_.push_back(op);
+    ++depth_;
+    if (depth_ > max_depth_) max_depth_ = depth_;
+}
+
+void ConditionProgram::pushCombine(OpCode code) {
+    if (depth_ < 2) {
+        throw std::invalid_argument("And/Or op needs two operands on the condition stack.");
+    }
+    Op op;
+    op.code = code;
+    ops_.push_back(op);
+    --depth_;
+}
+
+void ConditionProgram::emitFalse() {
+    pushLeaf(Op{});
+}
+
+void ConditionProgram::emitFieldVsValue(PriceField field, ComparisonOp cmp, double value) {
+    Op op;
+    op.code = OpCode::FieldVsValue;
+    op.cmp = cmp;
+    op.field_a = candleField(field);
+    op.price_a = field;
+    op.value = value;
+    pushLeaf(op);
+}
+
+void ConditionProgram::emitFieldVsField(PriceField lhs, ComparisonOp cmp, PriceField rhs) {
+    Op op;
+    op.code = OpCode::FieldVsField;
+    op.cmp = cmp;
+    op.field_a = candleField(lhs);
+    op.field_b = candleField(rhs);
+    op.price_a = lhs;
+    op.price_b = rhs;
+    pushLeaf(op);
+}
+
+void ConditionProgram::emitFieldVsIndicator(PriceField field, ComparisonOp cmp, IndicatorSlot slot) {
+    Op op;
+    op.code = OpCode::FieldVsIndicator;
+    op.cmp = cmp;
+    op.field_a = candleField(field);
+    op.price_a = field;
+    op.slot_b = slot;
+    pushLeaf(op);
+}
+
+void ConditionProgram::emitIndicatorVsValue(IndicatorSlot slot, ComparisonOp cmp, double value) {
+    Op op;
+    op.code = OpCode::IndicatorVsValue;
+    op.cmp = cmp;
+    op.slot_a = slot;
+    op.value = value;
+    pushLeaf(op);
+}
+
+void ConditionProgram::emitIndicatorVsIndicator(IndicatorSlot lhs, ComparisonOp cmp, IndicatorSlot rhs) {
+    Op op;
+    op.code = OpCode::IndicatorVsIndicator;
+    op.cmp = cmp;
+    op.slot_a = lhs;
+    op.slot_b = rhs;
+    pushLeaf(op);
+}
+
+void ConditionProgram::emitCross(IndicatorSlot lhs, bool above, IndicatorSlot rhs) {
+    Op op;
+    op.code = above ? OpCode::CrossAbove : OpCode::CrossBelow;
+    op.slot_a = lhs;
+    op.slot_b = rhs;
+    pushLeaf(op);
+}
+
+void ConditionProgram::emitAnd() { pushCombine(OpCode::And); }
+void ConditionProgram::emitOr() { pushCombine(OpCode::Or); }
+
+bool ConditionProgram::evaluate(const MarketDataSnapshot& snapshot) const {
+    const core::Candle& candle = snapshot.current_candle ? *snapshot.current_candle : missingCandle();
+
+    std::array<bool, kMaxStackDepth> stack;
+    std::size_t top = 0; // Number of values on the stack
+
+    for (const Op& op : ops_) {
+        switch (op.code) {
+            case OpCode::PushFalse:
+                stack[top++] = false;
+                break;
+            case OpCode::FieldVsValue:
+                stack[top++] = compareValues(op.cmp, candle.*op.field_a, op.value);
+                break;
+            case OpCode::FieldVsField:
+                stack[top++] = compareValues(op.cmp, candle.*op.field_a, candle.*op.field_b);
+                break;
+            case OpCode::FieldVsIndicator:
+                stack[top++] = compareValues(op.cmp, candle.*op.field_a, snapshot.indicatorValue(op.slot_b));
+                break;
+            case OpCode::IndicatorVsValue:
+                stack[top++] = compareValues(op.cmp, snapshot.indicatorValue(op.slot_a), op.value);
+                break;
+            case OpCode::IndicatorVsIndicator:
+                stack[top++] = compareValues(op.cmp, snapshot.indicatorValue(op.slot_a),
+                                             snapshot.indicatorValue(op.slot_b));
+                break;
+            case OpCode::CrossAbove: {
+                // NaN in any of the four values makes both comparisons false
+                const double prev1 = snapshot.previousIndicatorValue(op.slot_a);
+                const double prev2 = snapshot.previousIndicatorValue(op.slot_b);
+                const double now1 = snapshot.indicatorValue(op.slot_a);
+                const double now2 = snapshot.indicatorValue(op.slot_b);
+                stack[top++] = (prev1 <= prev2) & (now1 > now2);
+                break;
+            }
+            case OpCode::CrossBelow: {
+                const double prev1 = snapshot.previousIndicatorValue(op.slot_a);
+                const double prev2 = snapshot.previousIndicatorValue(op.slot_b);
+                const double now1 = snapshot.indicatorValue(op.slot_a);
+                const double now2 = snapshot.indicatorValue(op.slot_b);
+                stack[top++] = (prev1 >= prev2) & (now1 < now2);
+                break;
+            }
+            case OpCode::And:
+                --top;
+                stack[top - 1] = stack[top - 1] & stack[top];
+                break;
+            case OpCode::Or:
+                --top;
+                stack[top - 1] = stack[top - 1] | stack[top];
+                break;
+        }
+    }
+    return top == 1 && stack[0];
+}
+
+ColumnMask ConditionProgram::evaluateColumns(const MarketDataColumns& columns,
+                                             std::size_t begin, std::size_t end) const {
+    if (end < begin || end > columns.bar_count) {
+        throw std::invalid_argument(fmt::format(
+            "Invalid bar range [{}, {}) for {} bars.", begin, end, columns.bar_count));
+    }
+    const std::size_t n = end - begin;
+    if (ops_.empty()) return ColumnMask(n, 0);
+
+    auto price = [&](PriceField field) {
+        auto column = priceColumn(columns, field);
+        if (column.size() < end) {
+            throw std::invalid_argument("Price column shorter than the evaluated bar range.");
+        }
+        return column.data() + begin; // Indexed by local bar j
+    };
+
+    // One mask per stack level, reused by every op at that level
+    std::vector<ColumnMask> stack(max_depth_, ColumnMask(n, 0));
+    std::size_t top = 0;
+
+    for (const Op& op : ops_) {
+        switch (op.code) {
+            case OpCode::And:
+            case OpCode::Or: {
+                --top;
+                std::uint8_t* dst = stack[top - 1].data();
+                const std::uint8_t* src = stack[top].data();
+                if (op.code == OpCode::And) {
+                    for (std::size_t j = 0; j < n; ++j) dst[j] &= src[j];
+                } else {
+                    for (std::size_t j = 0; j < n; ++j) dst[j] |= src[j];
+                }
+                continue;
+            }
+            default:
+                break;
+        }
+
+        // Leaf: bars without a value stay 0, matching the NaN behaviour of evaluate()
+        std::uint8_t* out = stack[top++].data();
+        std::fill(out, out + n, std::uint8_t{0});
+
+        switch (op.code) {
+            case OpCode::PushFalse:
+                break;
+            case OpCode::FieldVsValue: {
+                const double* a = price(op.price_a);
+                const double value = op.value;
+                compareKernel(op.cmp, out, 0, n, [a](std::size_t j) { return a[j]; },
+                              [value](std::size_t) { return value; });
+                break;
+            }
+            case OpCode::FieldVsField: {
+                const double* a = price(op.price_a);
+                const double* b = price(op.price_b);
+                compareKernel(op.cmp, out, 0, n, [a](std::size_t j) { return a[j]; },
+                              [b](std::size_t j) { return b[j]; });
+                break;
+            }
+            case OpCode::FieldVsIndicator: {
+                const double* a = price(op.price_a);
+                const IndicatorColumn col = indicatorColumn(columns, op.slot_b);
+                const LocalRange r = validRange(col, 0, begin, end);
+                const double* b = col.values.data();
+                const std::size_t shift = begin - col.first_bar; // j -> index into b (wraps, but only valid j are used)
+                compareKernel(op.cmp, out, r.lo, r.hi, [a](std::size_t j) { return a[j]; },
+                              [b, shift](std::size_t j) { return b[j + shift]; });
+                break;
+            }
+            case OpCode::IndicatorVsValue: {
+                const IndicatorColumn col = indicatorColumn(columns, op.slot_a);
+                const LocalRange r = validRange(col, 0, begin, end);
+                const double* a = col.values.data();
+                const std::size_t shift = begin - col.first_bar;
+                const double value = op.value;
+                compareKernel(op.cmp, out, r.lo, r.hi, [a, shift](std::size_t j) { return a[j + shift]; },
+                              [value](std::size_t) { return value; });
+                break;
+            }
+            case OpCode::IndicatorVsIndicator: {
+                const IndicatorColumn col_a = indicatorColumn(columns, op.slot_a);
+                const IndicatorColumn col_b = indicatorColumn(columns, op.slot_b);
+                const LocalRange r = intersect(validRange(col_a, 0, begin, end), validRange(col_b, 0, begin, end));
+                const double* a = col_a.values.data();
+                const double* b = col_b.values.data();
+                const std::size_t shift_a = begin - col_a.first_bar;
+                const std::size_t shift_b = begin - col_b.first_bar;
+                compareKernel(op.cmp, out, r.lo, r.hi, [a, shift_a](std::size_t j) { return a[j + shift_a]; },
+                              [b, shift_b](std::size_t j) { return b[j + shift_b]; });
+                break;
+            }
+            case OpCode::CrossAbove:
+            case OpCode::CrossBelow: {
+                const IndicatorColumn col_a = indicatorColumn(columns, op.slot_a);
+                const IndicatorColumn col_b = indicatorColumn(columns, op.slot_b);
+                const LocalRange r = intersect(validRange(col_a, 1, begin, end), validRange(col_b, 1, begin, end));
+                const double* a = col_a.values.data();
+                const double* b = col_b.values.data();
+                const std::size_t shift_a = begin - col_a.first_bar;
+                const std::size_t shift_b = begin - col_b.first_bar;
+                if (op.code == OpCode::CrossAbove) {
+                    for (std::size_t j = r.lo; j < r.hi; ++j) {
+                        out[j] = (a[j + shift_a - 1] <= b[j + shift_b - 1]) & (a[j + shift_a] > b[j + shift_b]);
+                    }
+                } else {
+                    for (std::size_t j = r.lo; j < r.hi; ++j) {
+                        out[j] = (a[j + shift_a - 1] >= b[j + shift_b - 1]) & (a[j + shift_a] < b[j + shift_b]);
+                    }
+                }
+                break;
+            }
+            case OpCode::And:
+            case OpCode::Or:
+                break; // Handled above
+        }
+    }
+    return std::move(stack[0]);
+}
+
+} // namespace strategy_engine
@@ -1,15 +1,17 @@
 #include "indicator_condition.hpp"
+#include "condition_program.hpp"
 #include "logging.hpp"    // Use short path
 #include "spdlog/fmt/bundled/core.h"     // Use short path (via spdlog includes - check if direct include needed)
 #include "spdlog/fmt/bundled/core.h" // Use direct path as safe fallback <<< USE THIS
-#include <cmath>         // For std::fabs
+#include <cmath>         // For std::fabs, std::isnan
 #include <stdexcept>     // For std::bad_variant_access
 
 namespace strategy_engine {
 
 // Constructor for comparing indicator to value
-IndicatorCondition::IndicatorCondition(const std::string& indicator_name1, ComparisonOp op, double value)
-    : indicator_name1_(indicator_name1), op_(op), rhs_(value), compare_to_value_(true)
+IndicatorCondition::IndicatorCondition(const std::string& indicator_name1, IndicatorSlot slot1, ComparisonOp op, double value,
+                                       const allocator_type& allocator)
+    : indicator_name1_(indicator_name1, allocator), slot1_(slot1), op_(op), rhs_(value), compare_to_value_(true)
 {
     if (indicator_name1_.empty()) {
         throw std::invalid_argument("Indicator name 1 cannot be empty.");
@@ -17,54 +19,40 @@ IndicatorCondition::IndicatorCondition(const std::string& indicator_name1, Compa
 }
 
 // Constructor for comparing indicator to indicator
-IndicatorCondition::IndicatorCondition(const std::string& indicator_name1, ComparisonOp op, const std::string& indicator_name2)
-     : indicator_name1_(indicator_name1), op_(op), rhs_(indicator_name2), compare_to_value_(false)
+IndicatorCondition::IndicatorCondition(const std::string& indicator_name1, IndicatorSlot slot1, ComparisonOp op,
+                                       const std::string& indicator_name2, IndicatorSlot slot2,
+                                       const allocator_type& allocator)
+     : indicator_name1_(indicator_name1, allocator), slot1_(slot1), op_(op),
+       rhs_(std::in_place_type<std::pmr::string>, indicator_name2, allocator), slot2_(slot2), compare_to_value_(false)
 {
      if (indicator_name1_.empty() || indicator_name2.empty()) {
          throw std::invalid_argument("Indicator names cannot be empty.");
      }
-      if (indicator_name1_ == indicator_name2) {
+      if (indicator_name1 == indicator_name2) {
            throw std::invalid_argument("Cannot compare an indicator to itself in IndicatorCondition.");
       }
 }
 
 
 bool IndicatorCondition::evaluate(const MarketDataSnapshot& snapshot) const {
-    auto logger = core::logging::getLogger();
-
-    // Find the value of the first indicator in the snapshot
-    auto it1 = snapshot.indicator_values.find(indicator_name1_);
-    if (it1 == snapshot.indicator_values.end()) {
-        logger->trace("IndicatorCondition evaluate failed: LHS indicator '{}' not found in snapshot.", indicator_name1_);
+    // Read the value of the first indicator from its slot
+    double lhs_value = snapshot.indicatorValue(slot1_);
+    if (std::isnan(lhs_value)) {
+        TP_LOG_TRACE("IndicatorCondition evaluate failed: LHS indicator '{}' has no value in snapshot.", indicator_name1_);
         return false; // Cannot evaluate if indicator value is missing
     }
-    double lhs_value = it1->second;
 
     double rhs_value = 0.0;
     if (compare_to_value_) {
-        // Get the value from the variant
-        try {
-             rhs_value = std::get<double>(rhs_);
-        } catch (const std::bad_variant_access& ex) {
-             logger->error("Internal error: Variant access failed in IndicatorCondition (value). {}", ex.what());
-             return false; // Should not happen
-        }
+        // Get the value from the variant (always a double in this mode)
+        rhs_value = *std::get_if<double>(&rhs_);
     } else {
-        // Get the name of the second indicator and find its value
-         std::string indicator_name2;
-         try {
-             indicator_name2 = std::get<std::string>(rhs_);
-         } catch (const std::bad_variant_access& ex) {
-             logger->error("Internal error: Variant access failed in IndicatorCondition (name). {}", ex.what());
-             return false; // Should not happen
-         }
-
-        auto it2 = snapshot.indicator_values.find(indicator_name2);
-        if (it2 == snapshot.indicator_values.end()) {
-            logger->trace("IndicatorCondition evaluate failed: RHS indicator '{}' not found in snapshot.", indicator_name2);
+        rhs_value = snapshot.indicatorValue(slot2_);
+        if (std::isnan(rhs_value)) {
+            TP_LOG_TRACE("IndicatorCondition evaluate failed: RHS indicator '{}' has no value in snapshot.",
+                                              *std::get_if<std::pmr::string>(&rhs_));
             return false; // Cannot evaluate if second indicator value is missing
         }
-        rhs_value = it2->second;
     }
 
     // Perform the comparison
@@ -77,7 +65,7 @@ bool IndicatorCondition::evaluate(const MarketDataSnapshot& snapshot) const {
             // Use tolerance for floating point equality
             return std::fabs(lhs_value - rhs_value) < 1e-9; // Adjust tolerance if needed
         default:
-             logger->error("Invalid ComparisonOp in IndicatorCondition::evaluate");
+             core::logging::getLogger()->error("Invalid ComparisonOp in IndicatorCondition::evaluate");
             return false;
     }
 
@@ -98,6 +86,14 @@ bool IndicatorCondition::evaluate(const MarketDataSnapshot& snapshot) const {
  }
  // --- End Helper ---
 
+void IndicatorCondition::compile(ConditionProgram& program) const {
+    if (compare_to_value_) {
+        program.emitIndicatorVsValue(slot1_, op_, *std::get_if<double>(&rhs_));
+    } else {
+        program.emitIndicatorVsIndicator(slot1_, op_, slot2_);
+    }
+}
+
 std::string IndicatorCondition::describe() const {
     if (compare_to_value_) {
          try {
@@ -105,7 +101,7 @@ std::string IndicatorCondition::describe() const {
          } catch (const std::bad_variant_access&) { return "Error describing condition"; }
     } else {
          try {
-            return fmt::format("{} {} {}", indicator_name1_, op_to_string(op_), std::get<std::string>(rhs_));
+            return fmt::format("{} {} {}", indicator_name1_, op_to_string(op_), std::get<std::pmr::string>(rhs_));
           } catch (const std::bad_variant_access&) { return "Error describing condition"; }
     }
 }
@@ -1,15 +1,22 @@
 #include "indicator_cross_condition.hpp"
+#include "condition_program.hpp"
 #include "logging.hpp"    // Use short path
 #include "spdlog/fmt/bundled/core.h" // Use direct path for safety
+#include <cmath>     // For std::isnan
 
 namespace strategy_engine {
 
 IndicatorCrossCondition::IndicatorCrossCondition(std::string indicator1_name,
+                                               IndicatorSlot indicator1_slot,
                                                CrossType cross_type,
-                                               std::string indicator2_name)
-    : indicator1_name_(std::move(indicator1_name)),
+                                               std::string indicator2_name,
+                                               IndicatorSlot indicator2_slot,
+                                               const allocator_type& allocator)
+    : indicator1_name_(indicator1_name, allocator),
+      indicator1_slot_(indicator1_slot),
       cross_type_(cross_type),
-      indicator2_name_(std::move(indicator2_name))
+      indicator2_name_(indicator2_name, allocator),
+      indicator2_slot_(indicator2_slot)
 {
      if (indicator1_name_.empty() || indicator2_name_.empty()) {
          throw std::invalid_argument("Indicator names cannot be empty for IndicatorCrossCondition.");
@@ -20,32 +27,20 @@ IndicatorCrossCondition::IndicatorCrossCondition(std::string indicator1_name,
 }
 
 bool IndicatorCrossCondition::evaluate(const MarketDataSnapshot& snapshot) const {
-    auto logger = core::logging::getLogger();
-
-    // Get current values
-    auto it1_now = snapshot.indicator_values.find(indicator1_name_);
-    auto it2_now = snapshot.indicator_values.find(indicator2_name_);
-
-    // Get previous values
-    auto it1_prev = snapshot.indicator_values_prev.find(indicator1_name_);
-    auto it2_prev = snapshot.indicator_values_prev.find(indicator2_name_);
+    // Get current and previous values from the resolved slots
+    double val1_now = snapshot.indicatorValue(indicator1_slot_);
+    double val2_now = snapshot.indicatorValue(indicator2_slot_);
+    double val1_prev = snapshot.previousIndicatorValue(indicator1_slot_);
+    double val2_prev = snapshot.previousIndicatorValue(indicator2_slot_);
 
     // Check if all four values are available
-    if (it1_now == snapshot.indicator_values.end() ||
-        it2_now == snapshot.indicator_values.end() ||
-        it1_prev == snapshot.indicator_values_prev.end() ||
-        it2_prev == snapshot.indicator_values_prev.end())
+    if (std::isnan(val1_now) || std::isnan(val2_now) || std::isnan(val1_prev) || std::isnan(val2_prev))
     {
-         logger->trace("IndicatorCrossCondition evaluate failed: Missing current or previous indicator values ('{}', '{}').",
+         TP_LOG_TRACE("IndicatorCrossCondition evaluate failed: Missing current or previous indicator values ('{}', '{}').",
                        indicator1_name_, indicator2_name_);
          return false;
     }
 
-    double val1_now = it1_now->second;
-    double val2_now = it2_now->second;
-    double val1_prev = it1_prev->second;
-    double val2_prev = it2_prev->second;
-
     // Check for crossover type
     if (cross_type_ == CrossType::CrossesAbove) {
         // Was below or equal previously, AND is above now
@@ -60,6 +55,10 @@ bool IndicatorCrossCondition::evaluate(const MarketDataSnapshot& snapshot) const
      return (type == CrossType::CrossesAbove) ? "CrossesAbove" : "CrossesBelow";
  }
 
+void IndicatorCrossCondition::compile(ConditionProgram& program) const {
+    program.emitCross(indicator1_slot_, cross_type_ == CrossType::CrossesAbove, indicator2_slot_);
+}
+
 std::string IndicatorCrossCondition::describe() const {
     return fmt::format("{} {} {}",
                        indicator1_name_,
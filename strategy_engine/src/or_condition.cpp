@@ -1,10 +1,11 @@
 #include "or_condition.hpp"
+#include "condition_program.hpp"
 #include <sstream> // For describe()
 
 namespace strategy_engine {
 
-OrCondition::OrCondition(std::vector<std::unique_ptr<ICondition>> conditions)
-    : conditions_(std::move(conditions)) // Take ownership via move
+OrCondition::OrCondition(std::pmr::vector<ConditionPtr> conditions, const allocator_type& allocator)
+    : conditions_(std::move(conditions), allocator) // Take ownership via move
 {
      if (conditions_.empty()) {
          // Or should an empty OR condition be false? Let's forbid it.
@@ -21,6 +22,17 @@ bool OrCondition::evaluate(const MarketDataSnapshot& snapshot) const {
     return false; // All conditions evaluated to false (or were null)
 }
 
+void OrCondition::compile(ConditionProgram& program) const {
+    for (size_t i = 0; i < conditions_.size(); ++i) {
+        if (conditions_[i]) {
+            conditions_[i]->compile(program);
+        } else {
+            program.emitFalse();
+        }
+        if (i > 0) program.emitOr();
+    }
+}
+
  std::string OrCondition::describe() const {
      if (conditions_.empty()) {
          return "(Empty OR)";
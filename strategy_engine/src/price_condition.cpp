@@ -1,4 +1,5 @@
 #include "price_condition.hpp"
+#include "condition_program.hpp"
 #include "logging.hpp" // Use short path now
 #include "spdlog/fmt/bundled/core.h" // Use full relative path to bundled fmt header <<<--- CORRECT FIX
 #include <cmath>      // For std::fabs with floating point EQ comparison
@@ -36,7 +37,7 @@ bool PriceCondition::evaluate(const MarketDataSnapshot& snapshot) const {
     if (!snapshot.current_candle) {
         // Cannot evaluate if there's no current candle data
         // Log this? Or assume caller handles valid snapshots? Let's log trace.
-         core::logging::getLogger()->trace("PriceCondition evaluate failed: Snapshot has no current candle.");
+         TP_LOG_TRACE("PriceCondition evaluate failed: Snapshot has no current candle.");
         return false;
     }
 
@@ -81,6 +82,14 @@ bool PriceCondition::evaluate(const MarketDataSnapshot& snapshot) const {
  }
  // --- End Helper ---
 
+void PriceCondition::compile(ConditionProgram& program) const {
+    if (compare_to_value_) {
+        program.emitFieldVsValue(field1_, op_, value_);
+    } else {
+        program.emitFieldVsField(field1_, op_, field2_);
+    }
+}
+
 
 std::string PriceCondition::describe() const {
     if (compare_to_value_) {
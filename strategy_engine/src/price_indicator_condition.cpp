@@ -1,12 +1,14 @@
 #include "price_indicator_condition.hpp"
+#include "condition_program.hpp"
 #include "logging.hpp" // Use short path
 #include "spdlog/fmt/bundled/core.h" // Use direct path for safety
-#include <cmath>     // For std::fabs
+#include <cmath>     // For std::fabs, std::isnan
 
 namespace strategy_engine {
 
-PriceIndicatorCondition::PriceIndicatorCondition(PriceField price_field, ComparisonOp op, std::string indicator_name)
-    : price_field_(price_field), op_(op), indicator_name_(std::move(indicator_name))
+PriceIndicatorCondition::PriceIndicatorCondition(PriceField price_field, ComparisonOp op, std::string indicator_name, IndicatorSlot indicator_slot,
+                                                 const allocator_type& allocator)
+    : price_field_(price_field), op_(op), indicator_name_(indicator_name, allocator), indicator_slot_(indicator_slot)
 {
      if (indicator_name_.empty()) {
         throw std::invalid_argument("Indicator name cannot be empty for PriceIndicatorCondition.");
@@ -26,10 +28,8 @@ PriceIndicatorCondition::PriceIndicatorCondition(PriceField price_field, Compari
 
 
 bool PriceIndicatorCondition::evaluate(const MarketDataSnapshot& snapshot) const {
-    auto logger = core::logging::getLogger();
-
     if (!snapshot.current_candle) {
-         logger->trace("PriceIndicatorCondition evaluate failed: Snapshot has no current candle.");
+         TP_LOG_TRACE("PriceIndicatorCondition evaluate failed: Snapshot has no current candle.");
          return false;
     }
 
@@ -37,12 +37,11 @@ bool PriceIndicatorCondition::evaluate(const MarketDataSnapshot& snapshot) const
     double lhs_value = get_price_value(*snapshot.current_candle, price_field_);
 
     // Get Indicator Value
-    auto it = snapshot.indicator_values.find(indicator_name_);
-    if (it == snapshot.indicator_values.end()) {
-        logger->trace("PriceIndicatorCondition evaluate failed: Indicator '{}' not found in snapshot.", indicator_name_);
+    double rhs_value = snapshot.indicatorValue(indicator_slot_);
+    if (std::isnan(rhs_value)) {
+        TP_LOG_TRACE("PriceIndicatorCondition evaluate failed: Indicator '{}' has no value in snapshot.", indicator_name_);
         return false; // Cannot evaluate if indicator value is missing
     }
-    double rhs_value = it->second;
 
 
     // Perform the comparison
@@ -54,7 +53,7 @@ bool PriceIndicatorCondition::evaluate(const MarketDataSnapshot& snapshot) const
         case ComparisonOp::EQ:
             return std::fabs(lhs_value - rhs_value) < 1e-9;
         default:
-             logger->error("Invalid ComparisonOp in PriceIndicatorCondition::evaluate");
+             core::logging::getLogger()->error("Invalid ComparisonOp in PriceIndicatorCondition::evaluate");
              return false;
     }
 }
@@ -82,6 +81,10 @@ bool PriceIndicatorCondition::evaluate(const MarketDataSnapshot& snapshot) const
   }
   // --- End Helper ---
 
+void PriceIndicatorCondition::compile(ConditionProgram& program) const {
+    program.emitFieldVsIndicator(price_field_, op_, indicator_slot_);
+}
+
 std::string PriceIndicatorCondition::describe() const {
     return fmt::format("{} {} {}",
                        field_to_string(price_field_),
@@ -5,10 +5,11 @@
 
 namespace strategy_engine {
 
-Rule::Rule(std::string rule_name,
-           std::unique_ptr<ICondition> condition,
-           core::SignalAction action_on_true)
-    : name_(std::move(rule_name)), // Use move for efficiency
+Rule::Rule(const std::string& rule_name,
+           ConditionPtr condition,
+           core::SignalAction action_on_true,
+           const allocator_type& allocator)
+    : name_(rule_name, allocator),
       condition_(std::move(condition)), // Take ownership
       action_(action_on_true)
 {
@@ -23,20 +24,27 @@ Rule::Rule(std::string rule_name,
          // Rule must have a specific action associated if condition is true
           throw std::invalid_argument(fmt::format("Action cannot be 'None' for Rule '{}'.", name_));
     }
+    program_ = ConditionProgram::compile(*condition_);
 }
 
 core::SignalAction Rule::evaluate(const MarketDataSnapshot& snapshot) const {
-    // Condition pointer was checked in constructor, should be valid
-    bool condition_result = condition_->evaluate(snapshot);
+    bool condition_result = program_.evaluate(snapshot);
 
-    core::logging::getLogger()->trace("Rule '{}' evaluated condition '{}' -> {}",
-                                    name_, condition_->describe(), condition_result);
+    TP_LOG_TRACE("Rule '{}' evaluated condition '{}' -> {}",
+                 name_, condition_->describe(), condition_result);
 
-    if (condition_result) {
-        return action_; // Condition is true, return the rule's action
-    } else {
-        return core::SignalAction::None; // Condition is false, no action triggered by this rule
-    }
+    return condition_result ? action_ : core::SignalAction::None;
+}
+
+bool Rule::evaluateColumns(const MarketDataColumns& columns, std::size_t begin,
+                           std::size_t end, ColumnMask& mask) const {
+    mask = program_.evaluateColumns(columns, begin, end);
+    return true;
+}
+
+core::SignalAction Rule::evaluateReference(const MarketDataSnapshot& snapshot) const {
+    // Condition pointer was checked in constructor, should be valid
+    return condition_->evaluate(snapshot) ? action_ : core::SignalAction::None;
 }
 
 // Helper to convert SignalAction enum to string (consider moving to core/utils?)
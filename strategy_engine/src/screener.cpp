@@ -0,0 +1,249 @@
+#include "screener.hpp"
+#include "spdlog/fmt/bundled/core.h" // Direct path for fmt safety
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <set>
+#include <stdexcept>
+
+namespace strategy_engine {
+
+    namespace { // File-local helpers
+
+        // Column order of the price fields; indicators follow
+        constexpr const char* kPriceColumnNames[Screener::kPriceColumns] = {"open", "high", "low", "close", "volume"};
+
+        std::string toLower(std::string text) {
+            std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return std::tolower(c); });
+            return text;
+        }
+
+        std::optional<std::size_t> priceColumn(const std::string& name) {
+            const std::string lower = toLower(name);
+            for (std::size_t i = 0; i < Screener::kPriceColumns; ++i) {
+                if (lower == kPriceColumnNames[i]) return i;
+            }
+            return std::nullopt;
+        }
+
+        // Same spellings as strategy conditions
+        ComparisonOp stringToCompOp(const std::string& op_str) {
+            if (op_str == ">" || op_str == "GT") return ComparisonOp::GT;
+            if (op_str == "<" || op_str == "LT") return ComparisonOp::LT;
+            if (op_str == ">=" || op_str == "GTE") return ComparisonOp::GTE;
+            if (op_str == "<=" || op_str == "LTE") return ComparisonOp::LTE;
+            if (op_str == "==" || op_str == "EQ") return ComparisonOp::EQ;
+            throw std::invalid_argument("Unknown comparison operator string: " + op_str);
+        }
+
+        void requireSingleTimeframe(const std::string& column) {
+            if (!splitIndicatorTimeframe(column).timeframe.empty()) {
+                throw std::invalid_argument(fmt::format(
+                    "Screen column '{}' names another timeframe; a screen runs on its 'timeframe' only.", column));
+            }
+        }
+
+        // mask[j] &= lhs(j) <cmp> rhs(j); the comparison is hoisted out of the loop so
+        // each instantiation is a branch-free loop the compiler can vectorize
+        template <typename Lhs, typename Rhs>
+        void andCompare(ComparisonOp cmp, std::uint8_t* mask, std::size_t n, Lhs lhs, Rhs rhs) {
+            switch (cmp) {
+                case ComparisonOp::GT:  for (std::size_t j = 0; j < n; ++j) mask[j] &= lhs(j) > rhs(j); break;
+                case ComparisonOp::LT:  for (std::size_t j = 0; j < n; ++j) mask[j] &= lhs(j) < rhs(j); break;
+                case ComparisonOp::GTE: for (std::size_t j = 0; j < n; ++j) mask[j] &= lhs(j) >= rhs(j); break;
+                case ComparisonOp::LTE: for (std::size_t j = 0; j < n; ++j) mask[j] &= lhs(j) <= rhs(j); break;
+                case ComparisonOp::EQ:
+                    for (std::size_t j = 0; j < n; ++j) mask[j] &= std::fabs(lhs(j) - rhs(j)) < 1e-9; // Conditions' tolerance
+                    break;
+            }
+        }
+
+    } // end anonymous namespace
+
+    // --- ScreenSpec ---
+
+    std::vector<std::string> ScreenSpec::indicatorNames() const {
+        std::set<std::string> names;
+        auto add = [&](const std::string& column) {
+            if (!column.empty() && !priceColumn(column)) names.insert(column);
+        };
+        for (const auto& filter : filters) {
+            add(filter.column);
+            add(filter.column2);
+        }
+        add(rank_by);
+        return std::vector<std::string>(names.begin(), names.end());
+    }
+
+    ScreenSpec ScreenSpec::fromJson(const nlohmann::json& config) {
+        if (!config.is_object()) throw std::invalid_argument("Screen config must be a JSON object.");
+        if (!config.contains("screener_name") || !config["screener_name"].is_string()) {
+            throw std::invalid_argument("Screen config missing 'screener_name'.");
+        }
+        ScreenSpec spec;
+        spec.name = config["screener_name"].get<std::string>();
+        if (config.contains("timeframe")) {
+            if (!config["timeframe"].is_string()) throw std::invalid_argument("Screen 'timeframe' must be a string.");
+            spec.timeframe = config["timeframe"].get<std::string>();
+        }
+
+        if (config.contains("filters")) {
+            if (!config["filters"].is_array()) throw std::invalid_argument("Screen 'filters' must be an array.");
+            for (const auto& filter_config : config["filters"]) {
+                if (!filter_config.is_object() || !filter_config.contains("column") || !filter_config["column"].is_string() ||
+                    !filter_config.contains("op") || !filter_config["op"].is_string()) {
+                    throw std::invalid_argument("Screen filter requires 'column' (string) and 'op' (string).");
+                }
+                ScreenFilter filter;
+                filter.column = filter_config["column"].get<std::string>();
+                filter.op = stringToCompOp(filter_config["op"].get<std::string>());
+                if (filter_config.contains("value") && filter_config["value"].is_number()) {
+                    filter.value = filter_config["value"].get<double>();
+                } else if (filter_config.contains("column2") && filter_config["column2"].is_string()) {
+                    filter.column2 = filter_config["column2"].get<std::string>();
+                    requireSingleTimeframe(filter.column2);
+                } else {
+                    throw std::invalid_argument(fmt::format(
+                        "Screen filter on '{}' requires 'value' (number) or 'column2' (string).", filter.column));
+                }
+                requireSingleTimeframe(filter.column);
+                spec.filters.push_back(std::move(filter));
+            }
+        }
+
+        if (config.contains("rank_by")) {
+            if (!config["rank_by"].is_string()) throw std::invalid_argument("Screen 'rank_by' must be a string.");
+            spec.rank_by = config["rank_by"].get<std::string>();
+            requireSingleTimeframe(spec.rank_by);
+        }
+        const std::string order = toLower(config.value("order", std::string("desc")));
+        if (order != "desc" && order != "asc") throw std::invalid_argument("Screen 'order' must be \"asc\" or \"desc\".");
+        spec.descending = order == "desc";
+        if (config.contains("top")) {
+            if (!config["top"].is_number_integer() || config["top"].get<long long>() < 0) {
+                throw std::invalid_argument("Screen 'top' must be a non-negative integer.");
+            }
+            spec.top = config["top"].get<std::size_t>();
+        }
+        if (spec.filters.empty() && spec.rank_by.empty()) {
+            throw std::invalid_argument("Screen needs at least one filter or a 'rank_by' column.");
+        }
+        return spec;
+    }
+
+    // --- ScreenMatrix ---
+
+    ScreenMatrix::ScreenMatrix(std::size_t rows, std::size_t columns)
+        : rows_(rows), columns_(columns), values_(rows * columns, kMissingIndicatorValue)
+    {
+    }
+
+    void ScreenMatrix::clearRow(std::size_t row) {
+        for (std::size_t c = 0; c < columns_; ++c) at(row, c) = kMissingIndicatorValue;
+    }
+
+    // --- Screener ---
+
+    Screener::Screener(ScreenSpec spec, std::vector<std::string> instruments)
+        : spec_(std::move(spec)),
+          instruments_(std::move(instruments)),
+          indicator_names_(spec_.indicatorNames()),
+          matrix_(instruments_.size(), kPriceColumns + indicator_names_.size())
+    {
+        if (instruments_.empty()) throw std::invalid_argument(fmt::format("Screen '{}' has no instruments.", spec_.name));
+        for (std::size_t row = 0; row < instruments_.size(); ++row) {
+            if (!rows_.emplace(instruments_[row], row).second) {
+                throw std::invalid_argument(fmt::format("Screen '{}' lists instrument '{}' twice.", spec_.name, instruments_[row]));
+            }
+        }
+        for (const auto& filter : spec_.filters) {
+            ResolvedFilter resolved;
+            resolved.column = resolveColumn(filter.column);
+            resolved.op = filter.op;
+            if (!filter.column2.empty()) resolved.column2 = resolveColumn(filter.column2);
+            resolved.value = filter.value;
+            filters_.push_back(resolved);
+        }
+        if (!spec_.rank_by.empty()) rank_column_ = resolveColumn(spec_.rank_by);
+        mask_.resize(instruments_.size());
+        result_.hits.reserve(instruments_.size());
+    }
+
+    std::size_t Screener::resolveColumn(const std::string& name) const {
+        if (const auto price = priceColumn(name)) return *price;
+        const auto it = std::lower_bound(indicator_names_.begin(), indicator_names_.end(), name);
+        return kPriceColumns + static_cast<std::size_t>(it - indicator_names_.begin()); // Always present
+    }
+
+    std::optional<std::size_t> Screener::findInstrument(const std::string& instrument_key) const {
+        const auto it = rows_.find(instrument_key);
+        if (it == rows_.end()) return std::nullopt;
+        return it->second;
+    }
+
+    std::optional<std::size_t> Screener::findColumn(const std::string& name) const {
+        if (const auto price = priceColumn(name)) return *price;
+        const auto it = std::lower_bound(indicator_names_.begin(), indicator_names_.end(), name);
+        if (it == indicator_names_.end() || *it != name) return std::nullopt;
+        return kPriceColumns + static_cast<std::size_t>(it - indicator_names_.begin());
+    }
+
+    void Screener::update(std::size_t row, const core::Candle& bar, std::span<const double> indicator_values) {
+        if (row >= instruments_.size()) throw std::invalid_argument("Screener::update(): row out of range.");
+        if (indicator_values.size() != indicator_names_.size()) {
+            throw std::invalid_argument(fmt::format("Screener::update(): expected {} indicator values, got {}.",
+                                                    indicator_names_.size(), indicator_values.size()));
+        }
+        matrix_.at(row, 0) = bar.open;
+        matrix_.at(row, 1) = bar.high;
+        matrix_.at(row, 2) = bar.low;
+        matrix_.at(row, 3) = bar.close;
+        matrix_.at(row, 4) = static_cast<double>(bar.volume);
+        for (std::size_t i = 0; i < indicator_values.size(); ++i) matrix_.at(row, kPriceColumns + i) = indicator_values[i];
+    }
+
+    const ScreenResult& Screener::scan() {
+        const std::size_t n = instruments_.size();
+        std::fill(mask_.begin(), mask_.end(), std::uint8_t{1});
+        for (const auto& filter : filters_) {
+            const double* lhs = matrix_.column(filter.column).data();
+            if (filter.column2) {
+                const double* rhs = matrix_.column(*filter.column2).data();
+                andCompare(filter.op, mask_.data(), n, [lhs](std::size_t j) { return lhs[j]; },
+                           [rhs](std::size_t j) { return rhs[j]; });
+            } else {
+                const double value = filter.value;
+                andCompare(filter.op, mask_.data(), n, [lhs](std::size_t j) { return lhs[j]; },
+                           [value](std::size_t) { return value; });
+            }
+        }
+
+        result_.hits.clear();
+        if (rank_column_) {
+            const double* rank = matrix_.column(*rank_column_).data();
+            for (std::size_t j = 0; j < n; ++j) {
+                if (mask_[j] && !std::isnan(rank[j])) result_.hits.push_back({j, rank[j]});
+            }
+        } else {
+            for (std::size_t j = 0; j < n; ++j) {
+                if (mask_[j]) result_.hits.push_back({j, kMissingIndicatorValue});
+            }
+        }
+        result_.passed = result_.hits.size();
+
+        const std::size_t keep = spec_.top > 0 ? std::min(spec_.top, result_.hits.size()) : result_.hits.size();
+        if (rank_column_) {
+            // Ties go to the earlier instrument, so results do not depend on the sort
+            const bool descending = spec_.descending;
+            std::partial_sort(result_.hits.begin(), result_.hits.begin() + static_cast<std::ptrdiff_t>(keep), result_.hits.end(),
+                              [descending](const ScreenHit& a, const ScreenHit& b) {
+                                  if (a.value != b.value) return descending ? a.value > b.value : a.value < b.value;
+                                  return a.row < b.row;
+                              });
+        }
+        result_.hits.resize(keep);
+        return result_;
+    }
+
+} // namespace strategy_engine
@@ -1,6 +1,7 @@
 #include "strategy.hpp"
 #include "logging.hpp" // Use short path
 #include <stdexcept>  // For std::invalid_argument
+#include <algorithm>  // For std::find
 #include "common_types.hpp"
 
 namespace strategy_engine {
@@ -11,8 +12,8 @@ Strategy::Strategy(
     std::vector<std::string> required_instruments,
     std::vector<std::string> required_timeframes,
     std::vector<std::string> required_indicator_names,
-    std::vector<std::unique_ptr<IRule>> entry_rules,
-    std::vector<std::unique_ptr<IRule>> exit_rules,
+    std::pmr::vector<RulePtr> entry_rules,
+    std::pmr::vector<RulePtr> exit_rules,
     SizingMethod sizing_method,
     double sizing_value,
     bool is_sizing_value_percentage
@@ -47,35 +48,36 @@ const std::vector<std::string>& Strategy::getRequiredIndicatorNames() const { re
 
 
 core::SignalAction Strategy::evaluate(const MarketDataSnapshot& snapshot) {
-    auto logger = core::logging::getLogger();
-    logger->trace("Evaluating strategy '{}', current position: {}", name_, static_cast<int>(current_position_));
+    TP_LOG_TRACE("Evaluating strategy '{}', current position: {}", name_, static_cast<int>(current_position_));
 
     core::SignalAction resulting_action = core::SignalAction::None;
 
     // --- Evaluate Rules based on Current Position ---
     if (current_position_ == core::PositionState::None) {
         // Currently Flat: Check ENTRY rules
-        logger->trace("Checking entry rules for strategy '{}'", name_);
+        TP_LOG_TRACE("Checking entry rules for strategy '{}'", name_);
         for (const auto& rule : entry_rules_) {
             if (!rule) continue; // Skip null rules
+            ++rule_evaluations_;
             core::SignalAction action = rule->evaluate(snapshot);
             if (action == core::SignalAction::EnterLong || action == core::SignalAction::EnterShort) {
-                logger->debug("Strategy '{}': Entry rule '{}' triggered -> {}", name_, rule->getName(), static_cast<int>(action));
+                TP_LOG_DEBUG("Strategy '{}': Entry rule '{}' triggered -> {}", name_, rule->getName(), static_cast<int>(action));
                 resulting_action = action;
                 break; // Take the first entry signal
             }
         }
     } else {
         // Currently Long or Short: Check EXIT rules
-         logger->trace("Checking exit rules for strategy '{}'", name_);
+         TP_LOG_TRACE("Checking exit rules for strategy '{}'", name_);
          for (const auto& rule : exit_rules_) {
              if (!rule) continue; // Skip null rules
+             ++rule_evaluations_;
              core::SignalAction action = rule->evaluate(snapshot);
              // Check if the exit action matches the current position
              if ((current_position_ == core::PositionState::Long && action == core::SignalAction::ExitLong) ||
                  (current_position_ == core::PositionState::Short && action == core::SignalAction::ExitShort))
              {
-                  logger->debug("Strategy '{}': Exit rule '{}' triggered -> {}", name_, rule->getName(), static_cast<int>(action));
+                  TP_LOG_DEBUG("Strategy '{}': Exit rule '{}' triggered -> {}", name_, rule->getName(), static_cast<int>(action));
                   resulting_action = action;
                   break; // Take the first valid exit signal
              }
@@ -101,12 +103,86 @@ core::SignalAction Strategy::evaluate(const MarketDataSnapshot& snapshot) {
             break;
     }
 
-    logger->trace("Strategy '{}' evaluation complete. Action: {}, New Position: {}",
+    TP_LOG_TRACE("Strategy '{}' evaluation complete. Action: {}, New Position: {}",
                   name_, static_cast<int>(resulting_action), static_cast<int>(current_position_));
 
     return resulting_action;
 }
 
+bool Strategy::generateSignals(const MarketDataColumns& columns, std::size_t begin,
+                               std::size_t end, std::vector<SignalEvent>& signals) {
+    auto logger = core::logging::getLogger();
+    if (end < begin || end > columns.bar_count) {
+        throw std::invalid_argument("Strategy::generateSignals: invalid bar range.");
+    }
+    const std::size_t n = end - begin;
+
+    // Rules that can fire in each position state, in evaluation order, mirroring
+    // the filters in evaluate(): entries only count when flat, exits only when
+    // they match the open position.
+    struct RuleMask {
+        core::SignalAction action;
+        ColumnMask mask;
+    };
+    std::uint64_t evaluated = 0; // Only counted once every rule supported columns
+    std::vector<RuleMask> entry_masks;
+    ColumnMask any_entry(n, 0), any_exit_long(n, 0), any_exit_short(n, 0);
+
+    for (const auto& rule : entry_rules_) {
+        if (!rule) continue;
+        const core::SignalAction action = rule->getAction();
+        if (action != core::SignalAction::EnterLong && action != core::SignalAction::EnterShort) continue;
+        RuleMask entry{action, {}};
+        if (!rule->evaluateColumns(columns, begin, end, entry.mask)) return false;
+        evaluated += n;
+        for (std::size_t j = 0; j < n; ++j) any_entry[j] |= entry.mask[j];
+        entry_masks.push_back(std::move(entry));
+    }
+    for (const auto& rule : exit_rules_) {
+        if (!rule) continue;
+        const core::SignalAction action = rule->getAction();
+        if (action != core::SignalAction::ExitLong && action != core::SignalAction::ExitShort) continue;
+        ColumnMask mask;
+        if (!rule->evaluateColumns(columns, begin, end, mask)) return false;
+        evaluated += n;
+        ColumnMask& target = (action == core::SignalAction::ExitLong) ? any_exit_long : any_exit_short;
+        for (std::size_t j = 0; j < n; ++j) target[j] |= mask[j];
+    }
+
+    rule_evaluations_ += evaluated;
+
+    // Jump from one triggering bar to the next instead of visiting every bar
+    std::size_t signal_count = 0;
+    std::size_t j = 0;
+    while (j < n) {
+        const ColumnMask& trigger = current_position_ == core::PositionState::None ? any_entry
+                                  : current_position_ == core::PositionState::Long ? any_exit_long
+                                  : any_exit_short;
+        j = static_cast<std::size_t>(std::find(trigger.begin() + j, trigger.end(), std::uint8_t{1}) - trigger.begin());
+        if (j >= n) break;
+
+        core::SignalAction action = core::SignalAction::None;
+        if (current_position_ == core::PositionState::None) {
+            for (const auto& entry : entry_masks) { // First entry rule wins, as in evaluate()
+                if (entry.mask[j]) { action = entry.action; break; }
+            }
+            current_position_ = (action == core::SignalAction::EnterLong) ? core::PositionState::Long
+                                                                          : core::PositionState::Short;
+        } else {
+            action = (current_position_ == core::PositionState::Long) ? core::SignalAction::ExitLong
+                                                                      : core::SignalAction::ExitShort;
+            current_position_ = core::PositionState::None;
+        }
+        signals.push_back(SignalEvent{begin + j, action});
+        ++signal_count;
+        ++j;
+    }
+
+    logger->debug("Strategy '{}': whole-series evaluation of {} bars produced {} signals.",
+                  name_, n, signal_count);
+    return true;
+}
+
 core::PositionState Strategy::getCurrentPosition() const {
     return current_position_;
 }
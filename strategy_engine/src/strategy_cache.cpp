@@ -0,0 +1,272 @@
+#include "strategy_cache.hpp"
+#include "strategy_factory.hpp"
+#include "strategy.hpp"
+#include "logging.hpp"
+#include "utils.hpp"          // uniqueTempPath
+#include "spdlog/fmt/bundled/core.h" // Direct path for fmt safety
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+
+namespace strategy_engine {
+
+    namespace { // File-local helpers
+
+        constexpr std::uint64_t kFnvOffset = 1469598103934665603ULL;
+        constexpr std::uint64_t kFnvPrime = 1099511628211ULL;
+
+        void fnvBytes(std::uint64_t& hash, const void* data, std::size_t size) {
+            const auto* bytes = static_cast<const unsigned char*>(data);
+            for (std::size_t i = 0; i < size; ++i) {
+                hash ^= bytes[i];
+                hash *= kFnvPrime;
+            }
+        }
+
+        template <typename T>
+        void fnvMix(std::uint64_t& hash, const T& value) {
+            fnvBytes(hash, &value, sizeof(T));
+        }
+
+        void fnvString(std::uint64_t& hash, const std::string& text) {
+            fnvMix(hash, static_cast<std::uint64_t>(text.size()));
+            fnvBytes(hash, text.data(), text.size());
+        }
+
+        // Type tag, then the value; object members come in key order (nlohmann::json
+        // keeps them sorted), so formatting and member order do not change the hash
+        void fnvJson(std::uint64_t& hash, const nlohmann::json& value) {
+            fnvMix(hash, static_cast<std::uint8_t>(value.type()));
+            switch (value.type()) {
+                case nlohmann::json::value_t::object:
+                    fnvMix(hash, static_cast<std::uint64_t>(value.size()));
+                    for (auto it = value.begin(); it != value.end(); ++it) {
+                        fnvString(hash, it.key());
+                        fnvJson(hash, it.value());
+                    }
+                    break;
+                case nlohmann::json::value_t::array:
+                    fnvMix(hash, static_cast<std::uint64_t>(value.size()));
+                    for (const auto& element : value) fnvJson(hash, element);
+                    break;
+                case nlohmann::json::value_t::string:
+                    fnvString(hash, value.get_ref<const std::string&>());
+                    break;
+                case nlohmann::json::value_t::boolean:
+                    fnvMix(hash, value.get<bool>());
+                    break;
+                case nlohmann::json::value_t::number_integer:
+                    fnvMix(hash, value.get<std::int64_t>());
+                    break;
+                case nlohmann::json::value_t::number_unsigned:
+                    fnvMix(hash, value.get<std::uint64_t>());
+                    break;
+                case nlohmann::json::value_t::number_float:
+                    fnvMix(hash, value.get<double>());
+                    break;
+                default: // null, binary, discarded
+                    break;
+            }
+        }
+
+        // The config keys StrategyFactory reads, apart from 'instruments'
+        constexpr const char* kKeyMembers[] = {"strategy_name", "timeframes", "position_sizing", "entry_rules", "exit_rules"};
+
+    } // end anonymous namespace
+
+    StrategyCache& StrategyCache::shared() {
+        static StrategyCache cache;
+        return cache;
+    }
+
+    StrategyCache::StrategyCache(std::size_t capacity)
+        : capacity_(capacity)
+    {
+    }
+
+    std::uint64_t StrategyCache::key(const nlohmann::json& config) {
+        std::uint64_t hash = kFnvOffset;
+        fnvMix(hash, CompiledStrategy::kFormatVersion);
+        if (!config.is_object()) {
+            fnvJson(hash, config);
+            return hash;
+        }
+        for (const char* member : kKeyMembers) {
+            fnvString(hash, member);
+            const auto it = config.find(member);
+            if (it == config.end()) {
+                fnvMix(hash, static_cast<std::uint8_t>(0xff)); // Absent differs from any value
+            } else {
+                fnvJson(hash, *it);
+            }
+        }
+        return hash;
+    }
+
+    StrategyCache::CompiledPtr StrategyCache::compile(const nlohmann::json& config) {
+        auto logger = core::logging::getLogger();
+        const std::uint64_t cache_key = key(config);
+        std::string disk_path;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (auto it = entries_.find(cache_key); it != entries_.end()) {
+                ++stats_.hits;
+                return it->second.compiled;
+            }
+            if (!disk_directory_.empty()) {
+                disk_path = (std::filesystem::path(disk_directory_) / fmt::format("{:016x}.tpstrat", cache_key)).string();
+            }
+        }
+
+        // Load or parse outside the lock; two threads missing on the same key both
+        // compile it and the first insert wins
+        if (!disk_path.empty()) {
+            if (CompiledPtr stored = loadFromDisk(disk_path)) {
+                logger->debug("StrategyCache loaded '{}' from {}.", stored->name, disk_path);
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    ++stats_.disk_hits;
+                }
+                return insert(cache_key, std::move(stored), false);
+            }
+        }
+
+        auto parsed = StrategyFactory::parseStrategy(config);
+        const auto* strategy = dynamic_cast<const Strategy*>(parsed.get());
+        if (!strategy) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++stats_.failures;
+            return nullptr;
+        }
+        auto compiled = std::make_shared<const CompiledStrategy>(CompiledStrategy::fromStrategy(*strategy));
+        if (!disk_path.empty()) storeToDisk(disk_path, *compiled);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++stats_.misses;
+        }
+        return insert(cache_key, std::move(compiled), false);
+    }
+
+    StrategyCache::CompiledPtr StrategyCache::insert(std::uint64_t key, CompiledPtr compiled, bool pinned) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto [it, inserted] = entries_.try_emplace(key, Entry{compiled, pinned});
+        if (!inserted) {
+            if (!pinned) return it->second.compiled; // Another thread got there first
+            if (!it->second.pinned) {
+                insertion_order_.erase(std::find(insertion_order_.begin(), insertion_order_.end(), key));
+            }
+            it->second = Entry{compiled, true};
+            return compiled;
+        }
+        if (pinned) return compiled;
+        insertion_order_.push_back(key);
+        while (insertion_order_.size() > capacity_) {
+            entries_.erase(insertion_order_.front());
+            insertion_order_.pop_front();
+        }
+        return compiled;
+    }
+
+    void StrategyCache::preload(std::uint64_t key, CompiledPtr compiled) {
+        if (compiled) insert(key, std::move(compiled), true);
+    }
+
+    std::size_t StrategyCache::preloadEmbedded(const std::vector<EmbeddedStrategy>& strategies) {
+        auto logger = core::logging::getLogger();
+        std::size_t accepted = 0;
+        for (const auto& embedded : strategies) {
+            auto compiled = CompiledStrategy::deserialize(embedded.serialized);
+            if (!compiled) {
+                logger->warn("Ignoring embedded strategy from '{}': built for another format version or corrupt.",
+                             embedded.source);
+                continue;
+            }
+            preload(embedded.key, std::make_shared<const CompiledStrategy>(std::move(*compiled)));
+            ++accepted;
+        }
+        if (accepted > 0) logger->debug("StrategyCache preloaded {} embedded strategy(ies).", accepted);
+        return accepted;
+    }
+
+    void StrategyCache::setDiskDirectory(const std::string& directory) {
+        std::string resolved = directory;
+        if (!resolved.empty()) {
+            std::error_code ec;
+            std::filesystem::create_directories(resolved, ec);
+            if (ec) {
+                core::logging::getLogger()->warn("Cannot create strategy cache directory '{}': {}. Disk tier disabled.",
+                                                 resolved, ec.message());
+                resolved.clear();
+            }
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        disk_directory_ = std::move(resolved);
+    }
+
+    std::string StrategyCache::diskDirectory() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return disk_directory_;
+    }
+
+    std::size_t StrategyCache::size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return entries_.size();
+    }
+
+    StrategyCacheStats StrategyCache::stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        StrategyCacheStats stats = stats_;
+        stats.entries = entries_.size();
+        return stats;
+    }
+
+    void StrategyCache::clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.clear();
+        insertion_order_.clear();
+    }
+
+    StrategyCache::CompiledPtr StrategyCache::loadFromDisk(const std::string& path) const {
+        std::ifstream in(path, std::ios::binary);
+        if (!in.is_open()) return nullptr;
+        const std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        auto compiled = CompiledStrategy::deserialize(bytes);
+        if (!compiled) {
+            core::logging::getLogger()->warn("Ignoring unreadable strategy cache file (recompiling): {}", path);
+            return nullptr;
+        }
+        return std::make_shared<const CompiledStrategy>(std::move(*compiled));
+    }
+
+    void StrategyCache::storeToDisk(const std::string& path, const CompiledStrategy& compiled) const {
+        // Write to a temporary file of our own and rename, so concurrent processes never
+        // read a partial file and never publish each other's half-written one
+        const std::string tmp_path = core::utils::uniqueTempPath(path);
+        {
+            std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+            if (!out.is_open()) {
+                core::logging::getLogger()->warn("Cannot write strategy cache file: {}", tmp_path);
+                return;
+            }
+            const std::string bytes = compiled.serialize();
+            out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+            out.close();
+            if (!out) {
+                core::logging::getLogger()->warn("Failed writing strategy cache file: {}", tmp_path);
+                std::error_code ec;
+                std::filesystem::remove(tmp_path, ec);
+                return;
+            }
+        }
+        std::error_code ec;
+        std::filesystem::rename(tmp_path, path, ec);
+        if (ec) {
+            core::logging::getLogger()->warn("Cannot finalize strategy cache file '{}': {}", path, ec.message());
+            std::filesystem::remove(tmp_path, ec);
+        }
+    }
+
+} // namespace strategy_engine
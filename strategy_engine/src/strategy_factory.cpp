@@ -11,11 +11,13 @@
 #include "spdlog/fmt/bundled/core.h" // Use direct path for safety
 #include "price_indicator_condition.hpp"
 #include "indicator_cross_condition.hpp"
+#include "strategy_cache.hpp"
 #include <stdexcept>              // For std::invalid_argument
 #include <vector>
 #include <string>
 #include <memory>
 #include <set> // To help collect unique indicator names
+#include <algorithm> // For std::find
 
 
 namespace strategy_engine {
@@ -60,11 +62,19 @@ namespace strategy_engine {
             if (lower_str == "capitalbased") return SizingMethod::CapitalBased;
             throw std::invalid_argument("Unknown position sizing method: " + method_str);
        }
+
+        IndicatorSlot lookupSlot(const IndicatorSlotMap& slots, const std::string& indicator_name) {
+            auto it = slots.find(indicator_name);
+            if (it == slots.end()) {
+                throw std::invalid_argument("No indicator slot assigned for: " + indicator_name);
+            }
+            return it->second;
+        }
     
     } // end anonymous namespace
     
     // --- Recursive Helper to Parse Conditions ---
-    std::unique_ptr<ICondition> StrategyFactory::parseCondition(const json& config) {
+    ConditionPtr StrategyFactory::parseCondition(const json& config, const IndicatorSlotMap& slots, core::Arena* arena) {
         if (!config.is_object() || !config.contains("type") || !config["type"].is_string()) {
             throw std::invalid_argument("Condition config must be an object with a 'type' (string).");
         }
@@ -83,10 +93,10 @@ namespace strategy_engine {
     
                 if (config.contains("value") && config["value"].is_number()) {
                     double value = config["value"].get<double>();
-                    return std::make_unique<PriceCondition>(field1, op, value);
+                    return core::makeArenaPtr<PriceCondition>(arena, field1, op, value);
                 } else if (config.contains("field2") && config["field2"].is_string()) {
                     PriceField field2 = stringToPriceField(config["field2"].get<std::string>());
-                    return std::make_unique<PriceCondition>(field1, op, field2);
+                    return core::makeArenaPtr<PriceCondition>(arena, field1, op, field2);
                 } else {
                     throw std::invalid_argument("Price condition requires 'value' (number) or 'field2' (string).");
                 }
@@ -100,10 +110,11 @@ namespace strategy_engine {
     
                 if (config.contains("value") && config["value"].is_number()) {
                     double value = config["value"].get<double>();
-                    return std::make_unique<IndicatorCondition>(indicator1, op, value);
+                    return core::makeArenaPtr<IndicatorCondition>(arena, indicator1, lookupSlot(slots, indicator1), op, value);
                 } else if (config.contains("indicator2") && config["indicator2"].is_string()) {
                     std::string indicator2 = config["indicator2"].get<std::string>();
-                    return std::make_unique<IndicatorCondition>(indicator1, op, indicator2);
+                    return core::makeArenaPtr<IndicatorCondition>(arena, indicator1, lookupSlot(slots, indicator1), op,
+                                                                       indicator2, lookupSlot(slots, indicator2));
                 } else {
                     throw std::invalid_argument("Indicator condition requires 'value' (number) or 'indicator2' (string).");
                 }
@@ -116,7 +127,7 @@ namespace strategy_engine {
                 PriceField field = stringToPriceField(config["price_field"].get<std::string>());
                 ComparisonOp op = stringToCompOp(config["op"].get<std::string>());
                 std::string indicator_name = config["indicator"].get<std::string>();
-                return std::make_unique<PriceIndicatorCondition>(field, op, indicator_name);
+                return core::makeArenaPtr<PriceIndicatorCondition>(arena, field, op, indicator_name, lookupSlot(slots, indicator_name));
            } else if (type == "CrossesAbove" || type == "CrossesBelow") {
                 if (!config.contains("indicator1") || !config["indicator1"].is_string() ||
                     !config.contains("indicator2") || !config["indicator2"].is_string()) {
@@ -125,23 +136,24 @@ namespace strategy_engine {
                 std::string indicator1 = config["indicator1"].get<std::string>();
                 std::string indicator2 = config["indicator2"].get<std::string>();
                 CrossType cross_type = (type == "CrossesAbove") ? CrossType::CrossesAbove : CrossType::CrossesBelow;
-                return std::make_unique<IndicatorCrossCondition>(indicator1, cross_type, indicator2);
+                return core::makeArenaPtr<IndicatorCrossCondition>(arena, indicator1, lookupSlot(slots, indicator1), cross_type,
+                                                                            indicator2, lookupSlot(slots, indicator2));
             } else if (type == "AND" || type == "OR") {
                 if (!config.contains("conditions") || !config["conditions"].is_array() || config["conditions"].empty()) {
                     throw std::invalid_argument(fmt::format("{} condition requires 'conditions' (non-empty array).", type));
                 }
-                std::vector<std::unique_ptr<ICondition>> sub_conditions;
+                std::pmr::vector<ConditionPtr> sub_conditions(core::arenaResource(arena));
                 sub_conditions.reserve(config["conditions"].size()); // Optimization
                 for (const auto& sub_conf : config["conditions"]) {
-                    sub_conditions.push_back(parseCondition(sub_conf)); // Recursive call
+                    sub_conditions.push_back(parseCondition(sub_conf, slots, arena)); // Recursive call
                     if (!sub_conditions.back()) {
                         throw std::runtime_error(fmt::format("Failed to parse sub-condition within {} condition.", type));
                     }
                 }
                 if (type == "AND") {
-                    return std::make_unique<AndCondition>(std::move(sub_conditions));
+                    return core::makeArenaPtr<AndCondition>(arena, std::move(sub_conditions));
                 } else { // OR
-                    return std::make_unique<OrCondition>(std::move(sub_conditions));
+                    return core::makeArenaPtr<OrCondition>(arena, std::move(sub_conditions));
                 }
             }
             // TODO: Add parsing for other condition types like "CrossesAbove", "CrossesBelow"
@@ -158,7 +170,7 @@ namespace strategy_engine {
     }
 
     // --- Helper to Parse Rules ---
-    std::unique_ptr<IRule> StrategyFactory::parseRule(const json& config) {
+    RulePtr StrategyFactory::parseRule(const json& config, const IndicatorSlotMap& slots, core::Arena* arena) {
         if (!config.is_object() ||
             !config.contains("rule_name") || !config["rule_name"].is_string() ||
             !config.contains("action") || !config["action"].is_string() ||
@@ -175,13 +187,13 @@ namespace strategy_engine {
                 throw std::invalid_argument("Rule action cannot be 'None'.");
             }
    
-            auto condition = parseCondition(config["condition"]); // Delegate condition parsing
+            auto condition = parseCondition(config["condition"], slots, arena); // Delegate condition parsing
             if (!condition) {
                  // parseCondition should throw on failure, but double-check
                  throw std::runtime_error(fmt::format("Failed to parse condition for rule '{}'.", name));
             }
    
-            return std::make_unique<Rule>(name, std::move(condition), action);
+            return core::makeArenaPtr<Rule>(arena, name, std::move(condition), action);
    
         } catch (const std::invalid_argument& e) {
              core::logging::getLogger()->error("Invalid config for rule '{}': {}", name, e.what());
@@ -227,7 +239,32 @@ namespace strategy_engine {
      }
 
     // --- Main Factory Method ---
-    std::unique_ptr<IStrategy> StrategyFactory::createStrategy(const json& config) {
+    std::unique_ptr<IStrategy> StrategyFactory::createStrategy(const json& config, core::Arena* arena) {
+        auto logger = core::logging::getLogger();
+        try {
+            auto compiled = StrategyCache::shared().compile(config);
+            if (!compiled) return nullptr; // Invalid config, already logged by parseStrategy()
+
+            // Instruments are not part of the cache key, so they are checked on every call
+            if (!config.contains("instruments") || !config["instruments"].is_array() || config["instruments"].empty()) {
+                throw std::invalid_argument("Config missing 'instruments' array.");
+            }
+            auto instruments = config["instruments"].get<std::vector<std::string>>();
+            logger->debug("Instantiating compiled strategy '{}' for {} instrument(s)", compiled->name, instruments.size());
+            return compiled->instantiate(std::move(instruments), arena);
+        } catch (const json::exception& e) {
+            logger->error("JSON parsing error while creating strategy: {}", e.what());
+            return nullptr;
+        } catch (const std::invalid_argument& e) {
+            logger->error("Invalid strategy configuration: {}", e.what());
+            return nullptr;
+        } catch (const std::exception& e) {
+            logger->error("Unexpected error creating strategy: {}", e.what());
+            return nullptr;
+        }
+    }
+
+    std::unique_ptr<IStrategy> StrategyFactory::parseStrategy(const json& config, core::Arena* arena) {
         auto logger = core::logging::getLogger();
         logger->info("Attempting to create strategy from JSON config...");
 
@@ -281,23 +318,9 @@ namespace strategy_engine {
                 // Alternatively, make it required:
                 // throw std::invalid_argument("Strategy config requires 'position_sizing' object.");
         }
-             // --- Parse Rules --- // <<<--- UPDATED TO CALL HELPER ---
              if (!config.contains("entry_rules") || !config["entry_rules"].is_array()) throw std::invalid_argument("Config missing 'entry_rules' array.");
              if (!config.contains("exit_rules") || !config["exit_rules"].is_array()) throw std::invalid_argument("Config missing 'exit_rules' array.");
 
-             std::vector<std::unique_ptr<IRule>> entry_rules;
-             for (const auto& rule_conf : config["entry_rules"]) {
-                 entry_rules.push_back(parseRule(rule_conf)); // Use helper
-                 if (!entry_rules.back()) throw std::runtime_error("Failed to parse an entry rule.");
-             }
-
-             std::vector<std::unique_ptr<IRule>> exit_rules;
-              for (const auto& rule_conf : config["exit_rules"]) {
-                 exit_rules.push_back(parseRule(rule_conf)); // Use helper
-                  if (!exit_rules.back()) throw std::runtime_error("Failed to parse an exit rule.");
-             }
-
-
             // --- Collect Required Indicators --- // <<<--- UPDATED TO CALL HELPER ---
             // We recursively collect names from conditions instead of relying on a separate list
             std::set<std::string> indicator_name_set; // Use set to automatically handle duplicates
@@ -307,9 +330,37 @@ namespace strategy_engine {
              for (const auto& rule_conf : config["exit_rules"]) {
                   if (rule_conf.contains("condition")) collectIndicatorNames(rule_conf["condition"], indicator_name_set);
              }
-            // Convert set to vector
+            // Convert set to vector; the index of each name is its slot
             std::vector<std::string> indicator_names(indicator_name_set.begin(), indicator_name_set.end());
+            IndicatorSlotMap indicator_slots;
+            for (IndicatorSlot slot = 0; slot < indicator_names.size(); ++slot) {
+                indicator_slots.emplace(indicator_names[slot], slot);
+            }
             logger->debug("Collected required indicator names: {}", fmt::join(indicator_names, ", "));
+            // Higher-timeframe indicators must name one of the declared timeframes
+            for (const auto& indicator_name : indicator_names) {
+                const auto ref = splitIndicatorTimeframe(indicator_name);
+                if (ref.timeframe.empty()) continue;
+                if (ref.spec.empty() || std::find(timeframes.begin(), timeframes.end(), ref.timeframe) == timeframes.end()) {
+                    throw std::invalid_argument(fmt::format(
+                        "Indicator '{}' uses timeframe '{}', which is not listed in 'timeframes'.", indicator_name, ref.timeframe));
+                }
+            }
+
+             // --- Parse Rules (conditions bind to the slots above) ---
+             std::pmr::vector<RulePtr> entry_rules(core::arenaResource(arena));
+             entry_rules.reserve(config["entry_rules"].size());
+             for (const auto& rule_conf : config["entry_rules"]) {
+                 entry_rules.push_back(parseRule(rule_conf, indicator_slots, arena)); // Use helper
+                 if (!entry_rules.back()) throw std::runtime_error("Failed to parse an entry rule.");
+             }
+
+             std::pmr::vector<RulePtr> exit_rules(core::arenaResource(arena));
+             exit_rules.reserve(config["exit_rules"].size());
+              for (const auto& rule_conf : config["exit_rules"]) {
+                 exit_rules.push_back(parseRule(rule_conf, indicator_slots, arena)); // Use helper
+                  if (!exit_rules.back()) throw std::runtime_error("Failed to parse an exit rule.");
+             }
 
 
             // --- Create Strategy Instance ---
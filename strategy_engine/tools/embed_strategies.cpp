@@ -0,0 +1,117 @@
+// Build-time generator for the strategy_embedded library (TP_EMBED_STRATEGIES):
+// compiles strategy configs with StrategyFactory and writes their serialized
+// CompiledStrategy form as byte arrays in a C++ source that defines
+// strategy_engine::embeddedStrategies().
+//
+//   embed_strategies <output.cpp> [strategy.json ...]
+//
+// Files that are not valid strategies are skipped with a warning, so one broken
+// example does not break the build.
+
+#include "strategy_cache.hpp"
+#include "strategy_factory.hpp"
+#include "strategy.hpp"
+#include "logging.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct EmbeddedSource {
+    std::string file;
+    std::uint64_t key = 0;
+    std::string serialized;
+};
+
+// Escapes what can appear in a file name inside a string literal
+std::string cppString(const std::string& text) {
+    std::string out;
+    for (char c : text) {
+        if (c == '\\' || c == '"') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+std::string generate(const std::vector<EmbeddedSource>& sources) {
+    std::ostringstream out;
+    out << "// Generated by embed_strategies from strategies/*.json. Do not edit.\n\n"
+        << "#include \"strategy_cache.hpp\"\n\n"
+        << "namespace strategy_engine {\n\n";
+    if (!sources.empty()) out << "    namespace {\n\n";
+    for (std::size_t i = 0; i < sources.size(); ++i) {
+        out << "        // " << sources[i].file << "\n"
+            << "        constexpr unsigned char kStrategy" << i << "[] = {";
+        const std::string& bytes = sources[i].serialized;
+        for (std::size_t b = 0; b < bytes.size(); ++b) {
+            if (b % 16 == 0) out << "\n            ";
+            out << static_cast<unsigned>(static_cast<unsigned char>(bytes[b])) << ',';
+        }
+        out << "\n        };\n\n";
+    }
+    if (!sources.empty()) out << "    } // end anonymous namespace\n\n";
+    out << "    const std::vector<EmbeddedStrategy>& embeddedStrategies() {\n"
+        << "        static const std::vector<EmbeddedStrategy> strategies = {\n";
+    for (std::size_t i = 0; i < sources.size(); ++i) {
+        out << "            {\"" << cppString(sources[i].file) << "\", 0x" << std::hex << sources[i].key << std::dec
+            << "ULL, std::string_view(reinterpret_cast<const char*>(kStrategy" << i << "), sizeof(kStrategy" << i << "))},\n";
+    }
+    out << "        };\n"
+        << "        return strategies;\n"
+        << "    }\n\n"
+        << "} // namespace strategy_engine\n";
+    return out.str();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: embed_strategies <output.cpp> [strategy.json ...]" << std::endl;
+        return 2;
+    }
+    core::logging::initialize("embed_strategies", spdlog::level::warn, spdlog::level::off);
+    auto logger = core::logging::getLogger();
+
+    std::vector<EmbeddedSource> sources;
+    for (int i = 2; i < argc; ++i) {
+        const std::filesystem::path path(argv[i]);
+        std::ifstream in(path);
+        if (!in.is_open()) {
+            logger->error("embed_strategies: cannot open {}", path.string());
+            return 1;
+        }
+        nlohmann::json config;
+        try {
+            config = nlohmann::json::parse(in);
+        } catch (const nlohmann::json::exception& e) {
+            logger->warn("embed_strategies: skipping {} (not valid JSON: {})", path.string(), e.what());
+            continue;
+        }
+        auto parsed = strategy_engine::StrategyFactory::parseStrategy(config);
+        const auto* strategy = dynamic_cast<const strategy_engine::Strategy*>(parsed.get());
+        if (!strategy) {
+            logger->warn("embed_strategies: skipping {} (not a valid strategy)", path.string());
+            continue;
+        }
+        const auto compiled = strategy_engine::CompiledStrategy::fromStrategy(*strategy);
+        sources.push_back({path.filename().string(), strategy_engine::StrategyCache::key(config), compiled.serialize()});
+    }
+
+    const std::string output_path = argv[1];
+    std::ofstream out(output_path, std::ios::binary | std::ios::trunc);
+    out << generate(sources);
+    if (!out) {
+        logger->error("embed_strategies: failed writing {}", output_path);
+        return 1;
+    }
+    std::cout << "Embedded " << sources.size() << " of " << (argc - 2) << " strategy file(s) into " << output_path << std::endl;
+    return 0;
+}
@@ -0,0 +1,264 @@
+// data::parseUpstoxCandleJson (single pass, no DOM) against nlohmann::json::parse
+// plus a walk of data.candles under the same row rules, on generated responses:
+// open interest from the 7th field, null / missing OI, float and out-of-range
+// volumes, malformed rows, escaped strings and whitespace between every token.
+
+#include "check.hpp"
+#include "check_data.hpp"
+#include "upstox_candle_parser.hpp"
+#include "utils.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include <spdlog/fmt/bundled/core.h>
+
+namespace {
+
+    using json = nlohmann::json;
+
+    struct Parsed {
+        bool ok = false;
+        std::string status;
+        std::string message;
+        std::vector<core::Candle> candles;
+        std::size_t skipped_rows = 0;
+    };
+
+    // Volume / OI: integers as they are, floats truncated, nothing beyond int64
+    bool domInt64(const json& value, long long& out) {
+        if (value.is_number_unsigned()) {
+            if (value.get<std::uint64_t>() > static_cast<std::uint64_t>(std::numeric_limits<long long>::max())) return false;
+            out = static_cast<long long>(value.get<std::uint64_t>());
+            return true;
+        }
+        if (value.is_number_integer()) {
+            out = value.get<long long>();
+            return true;
+        }
+        if (!value.is_number_float()) return false;
+        const double d = value.get<double>();
+        if (!(d >= -9223372036854775808.0 && d < 9223372036854775808.0)) return false;
+        out = static_cast<long long>(d);
+        return true;
+    }
+
+    // The DOM reference: [ts, o, h, l, c, v(, oi)], OI may be null, extra fields ignored
+    Parsed parseWithDom(const std::string& body) {
+        Parsed parsed;
+        const json document = json::parse(body, nullptr, false);
+        if (document.is_discarded() || !document.is_object()) return parsed;
+        if (document.contains("status") && document["status"].is_string()) parsed.status = document["status"];
+        if (document.contains("message") && document["message"].is_string()) parsed.message = document["message"];
+        if (!document.contains("data") || !document["data"].is_object()) return parsed;
+        const json& data = document["data"];
+        if (!data.contains("candles") || !data["candles"].is_array()) return parsed;
+
+        for (const json& row : data["candles"]) {
+            core::Candle candle;
+            bool valid = row.is_array() && row.size() >= 6 && row[0].is_string() &&
+                         core::utils::parseTimestamp(row[0].get<std::string>(), candle.timestamp);
+            for (std::size_t f = 1; valid && f <= 4; ++f) valid = row[f].is_number();
+            if (valid) {
+                candle.open = row[1].get<double>();
+                candle.high = row[2].get<double>();
+                candle.low = row[3].get<double>();
+                candle.close = row[4].get<double>();
+                valid = row[5].is_number() && domInt64(row[5], candle.volume);
+            }
+            if (valid && row.size() > 6 && row[6].is_number()) {
+                long long oi = 0;
+                valid = domInt64(row[6], oi);
+                candle.open_interest = oi;
+            }
+            if (valid) {
+                parsed.candles.push_back(candle);
+            } else {
+                ++parsed.skipped_rows;
+            }
+        }
+        parsed.ok = parsed.status.empty() || parsed.status == "success";
+        return parsed;
+    }
+
+    const char* space(std::mt19937& rng) {
+        static const char* spaces[] = {"", "", "", " ", "\n  ", "\t", "\r\n"};
+        return spaces[std::uniform_int_distribution<int>(0, 6)(rng)];
+    }
+
+    std::string price(std::mt19937& rng) {
+        const double value = std::uniform_real_distribution<double>(1.0, 5000.0)(rng);
+        switch (std::uniform_int_distribution<int>(0, 3)(rng)) {
+            case 0: return fmt::format("{:.2f}", value);
+            case 1: return fmt::format("{}", value); // Shortest round-trip form
+            case 2: return fmt::format("{:e}", value);
+            default: return std::to_string(static_cast<long long>(value));
+        }
+    }
+
+    // Volume or OI as the API might send it, and now and then as it should not
+    std::string quantity(std::mt19937& rng) {
+        static const char* odd[] = {"1.5e3", "1234.75", "0", "-0.5", "1e19", "-1e19", "9223372036854775807",
+                                    "9223372036854775808", "-9223372036854775808", "9.2233720368547758e18", "1e300"};
+        if (std::uniform_int_distribution<int>(0, 7)(rng) == 0) {
+            return odd[std::uniform_int_distribution<int>(0, 10)(rng)];
+        }
+        return std::to_string(std::uniform_int_distribution<long long>(0, 5'000'000)(rng));
+    }
+
+    std::string timestampText(std::mt19937& rng, core::Timestamp ts) {
+        std::string text = core::utils::timestampToString(ts);
+        switch (std::uniform_int_distribution<int>(0, 9)(rng)) {
+            case 0: text.replace(text.find('+'), 1, "\\u002B"); break; // Escaped: decoded through the scratch buffer
+            case 1: text.replace(4, 1, "\\u002d"); break;
+            case 2: text = "not a timestamp"; break;
+            default: break;
+        }
+        return text;
+    }
+
+    std::string row(std::mt19937& rng, core::Timestamp ts) {
+        const int shape = std::uniform_int_distribution<int>(0, 19)(rng);
+        if (shape == 0) return "{\"ts\":1}";
+        if (shape == 1) return quantity(rng);
+        std::vector<std::string> fields = {"\"" + timestampText(rng, ts) + "\"", price(rng), price(rng), price(rng),
+                                           price(rng), quantity(rng)};
+        switch (std::uniform_int_distribution<int>(0, 5)(rng)) {
+            case 0: break;                                     // No OI
+            case 1: fields.push_back("null"); break;           // OI null
+            case 2: fields.push_back("\"12\""); break;         // OI of the wrong type: ignored
+            default: fields.push_back(quantity(rng)); break;   // OI from the 7th field
+        }
+        if (shape == 2) fields.push_back("[1,{\"x\":[2]}]");   // Extra field
+        if (shape == 3) fields[2] = "\"101.5\"";               // Price as a string
+        if (shape == 4) fields[3] = "null";
+        if (shape == 5) fields.resize(5);                      // Too few fields
+        if (shape == 6) fields[4] = "[1]";
+
+        std::string text = "[";
+        for (std::size_t i = 0; i < fields.size(); ++i) {
+            if (i > 0) text += ',';
+            text += space(rng) + fields[i] + space(rng);
+        }
+        return text + "]";
+    }
+
+    std::string response(std::mt19937& rng, std::size_t rows) {
+        const core::Timestamp start = core::utils::stringToTimestamp(checks::kCheckStartDate + "T09:15:00+05:30");
+        std::string body = "{";
+        body += space(rng) + std::string("\"status\"") + space(rng) + ":" + space(rng) + "\"success\",";
+        // Keys the parser skips, with escapes and a surrogate pair it must decode or skip
+        body += "\"meta\":{\"note\":\"tab\\there \\\"quoted\\\" \\ud83d\\ude00\",\"list\":[true,false,null,-1.5e-3,{}]},";
+        if (std::uniform_int_distribution<int>(0, 1)(rng)) body += "\"message\":\"ok \\u00e9\\ud83d\\udcc8\",";
+        body += "\"data\":" + std::string(space(rng)) + "{\"other\":[[1,2]],\"candles\":" + space(rng) + "[";
+        for (std::size_t i = 0; i < rows; ++i) {
+            if (i > 0) body += std::string(",") + space(rng);
+            body += row(rng, start + std::chrono::minutes(i));
+        }
+        body += "]" + std::string(space(rng)) + "}}";
+        return body;
+    }
+
+    bool sameCandle(const core::Candle& a, const core::Candle& b) {
+        return a.timestamp == b.timestamp && a.open == b.open && a.high == b.high && a.low == b.low &&
+               a.close == b.close && a.volume == b.volume && a.open_interest == b.open_interest;
+    }
+
+    Parsed parseStreaming(const std::string& body, std::string& error) {
+        Parsed parsed;
+        const data::UpstoxCandleParseResult result = data::parseUpstoxCandleJson(body, [&](const core::Candle& candle) {
+            parsed.candles.push_back(candle);
+        });
+        parsed.ok = result.ok;
+        parsed.status = result.status;
+        parsed.message = result.message;
+        parsed.skipped_rows = result.skipped_rows;
+        error = result.error;
+        if (result.rows != parsed.candles.size()) error += " (rows counter disagrees with the callback)";
+        return parsed;
+    }
+
+} // end anonymous namespace
+
+TP_CHECK_CASE(candleParserMatchesDom, "data.candle_parser") {
+    std::mt19937 rng(7);
+    std::size_t rows_seen = 0;
+    std::size_t with_oi = 0;
+    std::size_t skipped = 0;
+    for (int response_index = 0; response_index < 300; ++response_index) {
+        const std::string body = response(rng, std::uniform_int_distribution<std::size_t>(0, 200)(rng));
+        const Parsed dom = parseWithDom(body);
+        std::string error;
+        const Parsed streaming = parseStreaming(body, error);
+
+        TP_CHECK_MSG(error.empty(), "response " << response_index << ": " << error);
+        TP_CHECK_MSG(dom.ok && streaming.ok, "response " << response_index << " not accepted");
+        TP_CHECK_MSG(streaming.status == dom.status && streaming.message == dom.message,
+                     "response " << response_index << ": message '" << streaming.message << "' vs '" << dom.message << "'");
+        TP_CHECK_MSG(streaming.candles.size() == dom.candles.size() && streaming.skipped_rows == dom.skipped_rows,
+                     "response " << response_index << ": " << streaming.candles.size() << " rows (" << streaming.skipped_rows
+                                 << " skipped) vs DOM " << dom.candles.size() << " (" << dom.skipped_rows << ")");
+        for (std::size_t i = 0; i < streaming.candles.size() && i < dom.candles.size(); ++i) {
+            TP_CHECK_MSG(sameCandle(streaming.candles[i], dom.candles[i]),
+                         "response " << response_index << " row " << i << " at "
+                                     << core::utils::timestampToString(dom.candles[i].timestamp) << " differs");
+            with_oi += dom.candles[i].open_interest.has_value();
+        }
+        rows_seen += dom.candles.size();
+        skipped += dom.skipped_rows;
+    }
+    // Both kinds of rows must occur, or the comparison proves little
+    TP_CHECK_MSG(rows_seen > 10000 && with_oi > rows_seen / 4 && skipped > 1000,
+                 rows_seen << " rows, " << with_oi << " with OI, " << skipped << " skipped");
+}
+
+TP_CHECK_CASE(candleParserEdgeValues, "data.candle_parser.edges") {
+    const std::string ts = "\"2024-01-01T09:15:00+05:30\"";
+    auto body = [&](const std::string& row) {
+        return "{\"status\":\"success\",\"data\":{\"candles\":[" + row + "]}}";
+    };
+    struct Case { std::string volume; std::string oi; std::optional<long long> expected_volume; std::optional<long long> expected_oi; };
+    const Case cases[] = {
+        {"9223372036854775807", "7", 9223372036854775807LL, 7},
+        {"-9223372036854775808", "null", std::numeric_limits<long long>::min(), std::nullopt},
+        {"-9.223372036854775808e18", "1.9e3", std::numeric_limits<long long>::min(), 1900},
+        {"9223372036854775808", "1", std::nullopt, std::nullopt},    // 2^63: out of range, row skipped
+        {"9.2233720368547758e18", "1", std::nullopt, std::nullopt},
+        {"1e300", "1", std::nullopt, std::nullopt},
+        {"10", "1e19", std::nullopt, std::nullopt},                  // Out-of-range OI skips the row too
+        {"10", "-1e300", std::nullopt, std::nullopt},
+    };
+    for (const auto& c : cases) {
+        const std::string text = body("[" + ts + ",1,2,0.5,1.5," + c.volume + "," + c.oi + "]");
+        std::string error;
+        const Parsed streaming = parseStreaming(text, error);
+        const Parsed dom = parseWithDom(text);
+        TP_CHECK_MSG(error.empty() && streaming.ok, c.volume << ": " << error);
+        if (c.expected_volume) {
+            TP_CHECK_MSG(streaming.candles.size() == 1 && streaming.candles[0].volume == *c.expected_volume &&
+                             streaming.candles[0].open_interest == c.expected_oi,
+                         "volume " << c.volume << ", OI " << c.oi);
+        } else {
+            TP_CHECK_MSG(streaming.candles.empty() && streaming.skipped_rows == 1, "volume " << c.volume << ", OI " << c.oi << " accepted");
+        }
+        TP_CHECK_MSG(dom.candles.size() == streaming.candles.size(), "DOM disagrees on volume " << c.volume << ", OI " << c.oi);
+    }
+
+    // Surrogates: a valid pair decodes like nlohmann does; an unpaired or invalid one fails both
+    const std::string pair = "{\"message\":\"\\ud83d\\ude00\",\"data\":{\"candles\":[]}}";
+    std::string error;
+    const Parsed decoded = parseStreaming(pair, error);
+    TP_CHECK_MSG(error.empty() && decoded.message == json::parse(pair)["message"].get<std::string>(), error);
+    for (const char* escape : {"\\ud83d\\u0041", "\\ud83d\\ud83d", "\\ud83d", "\\ud83dx", "\\ude00", "\\udfff\\ud83d"}) {
+        const std::string text = std::string("{\"message\":\"") + escape + "\",\"data\":{\"candles\":[]}}";
+        const Parsed streaming = parseStreaming(text, error);
+        TP_CHECK_MSG(!error.empty() && !streaming.ok, escape << " accepted");
+        TP_CHECK_MSG(json::parse(text, nullptr, false).is_discarded(), escape << " accepted by nlohmann");
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+// Minimal self-registering checks, run by tp_checks (see tests/CMakeLists.txt).
+// Each check is a function registered under a dotted name ("indicators.streaming");
+// ctest runs one test per name prefix. A failed TP_CHECK records the failure and
+// continues, so one run reports every mismatch of a check.
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+
+namespace checks {
+
+    using CheckFunction = void (*)();
+
+    struct Registration {
+        Registration(const char* name, CheckFunction function);
+    };
+
+    // Records a failure of the running check
+    void fail(const char* file, int line, const std::string& message);
+
+    // Failures recorded by the running check so far
+    std::size_t failureCount();
+
+} // namespace checks
+
+#define TP_CHECK_CONCAT_INNER(a, b) a##b
+#define TP_CHECK_CONCAT(a, b) TP_CHECK_CONCAT_INNER(a, b)
+
+// TP_CHECK_CASE(indicatorStreaming, "indicators.streaming") { ... }
+#define TP_CHECK_CASE(function, name)                                                          \
+    static void function();                                                                    \
+    static const ::checks::Registration TP_CHECK_CONCAT(function, _registration)(name, function); \
+    static void function()
+
+#define TP_CHECK(condition)                                                                    \
+    do {                                                                                       \
+        if (!(condition)) ::checks::fail(__FILE__, __LINE__, #condition);                      \
+    } while (0)
+
+// 'message' is streamed: TP_CHECK_MSG(a == b, "bar " << i << ": " << a << " != " << b)
+#define TP_CHECK_MSG(condition, message)                                                       \
+    do {                                                                                       \
+        if (!(condition)) {                                                                    \
+            std::ostringstream tp_check_stream_;                                               \
+            tp_check_stream_ << #condition << " -- " << message;                               \
+            ::checks::fail(__FILE__, __LINE__, tp_check_stream_.str());                        \
+        }                                                                                      \
+    } while (0)
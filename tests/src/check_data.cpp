@@ -0,0 +1,80 @@
+#include "check_data.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <utility>
+
+namespace checks {
+
+    core::CandleSeries randomWalkSeries(std::size_t count, unsigned seed, double flat_share) {
+        std::mt19937_64 rng(seed);
+        std::normal_distribution<double> step(0.0, 0.002);
+        std::uniform_real_distribution<double> coin(0.0, 1.0);
+        const core::Timestamp start = core::utils::stringToTimestamp(kCheckStartDate + "T09:15:00+05:30");
+
+        core::CandleSeries::Builder builder;
+        builder.reserve(count);
+        double log_price = std::log(100.0);
+        for (std::size_t i = 0; i < count; ++i) {
+            const double open = std::exp(log_price);
+            if (coin(rng) >= flat_share) log_price += step(rng);
+            const double close = std::exp(log_price);
+            core::Candle candle;
+            candle.timestamp = start + std::chrono::minutes(i);
+            candle.open = open;
+            candle.close = close;
+            candle.high = std::max(open, close) * 1.001;
+            candle.low = std::min(open, close) * 0.999;
+            candle.volume = 1000 + static_cast<long long>(i % 89);
+            builder.push_back(candle);
+        }
+        return builder.build();
+    }
+
+    core::CandleSeries seriesFromCloses(const std::vector<double>& closes) {
+        const core::Timestamp start = core::utils::stringToTimestamp(kCheckStartDate + "T09:15:00+05:30");
+        core::CandleSeries::Builder builder;
+        builder.reserve(closes.size());
+        for (std::size_t i = 0; i < closes.size(); ++i) {
+            core::Candle candle;
+            candle.timestamp = start + std::chrono::minutes(i);
+            candle.open = i > 0 ? closes[i - 1] : closes[i];
+            candle.close = closes[i];
+            candle.high = std::max(candle.open, candle.close);
+            candle.low = std::min(candle.open, candle.close);
+            candle.volume = 1000;
+            builder.push_back(candle);
+        }
+        return builder.build();
+    }
+
+    void MemoryCandleSource::add(const std::string& instrument_key, core::CandleSeries series) {
+        series_[instrument_key] = std::move(series);
+    }
+
+    core::TimeSeries<core::Candle> MemoryCandleSource::queryCandles(const std::string& instrument_key,
+                                                                    const std::string& interval,
+                                                                    core::Timestamp start_time,
+                                                                    core::Timestamp end_time)
+    {
+        return queryCandleSeries(instrument_key, interval, start_time, end_time).toCandles();
+    }
+
+    core::CandleSeries MemoryCandleSource::queryCandleSeries(const std::string& instrument_key,
+                                                             const std::string& /*interval*/,
+                                                             core::Timestamp start_time,
+                                                             core::Timestamp end_time)
+    {
+        const auto it = series_.find(instrument_key);
+        if (it == series_.end()) return {};
+        const auto timestamps = it->second.timestampsNs();
+        const auto first = std::lower_bound(timestamps.begin(), timestamps.end(), core::utils::timestampToEpochNanos(start_time));
+        const auto last = std::upper_bound(first, timestamps.end(), core::utils::timestampToEpochNanos(end_time));
+        return it->second.slice(static_cast<std::size_t>(first - timestamps.begin()),
+                                static_cast<std::size_t>(last - timestamps.begin()));
+    }
+
+} // namespace checks
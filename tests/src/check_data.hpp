@@ -0,0 +1,48 @@
+#pragma once
+
+// Deterministic inputs shared by the checks
+
+#include "candle_source.hpp"
+#include "candle_series.hpp"
+#include "datatypes.hpp"
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace checks {
+
+    // First bar of every generated series (09:15 IST on this date, 1-minute bars)
+    inline const std::string kCheckStartDate = "2000-01-03";
+
+    // 'count' minute bars of a seeded random walk. With flat_share > 0 that share of
+    // bars repeats the previous close, so zero-change runs (RSI's edge cases) occur.
+    core::CandleSeries randomWalkSeries(std::size_t count, unsigned seed, double flat_share = 0.0);
+
+    // Minute bars with the given closes (open = previous close), from kCheckStartDate
+    core::CandleSeries seriesFromCloses(const std::vector<double>& closes);
+
+    // ICandleSource over series held in memory; the interval is ignored
+    class MemoryCandleSource : public data::ICandleSource {
+    public:
+        void add(const std::string& instrument_key, core::CandleSeries series);
+
+        bool connect() override { return true; }
+        bool isConnected() const override { return true; }
+        bool supportsConcurrentQueries() const override { return true; }
+
+        core::TimeSeries<core::Candle> queryCandles(const std::string& instrument_key,
+                                                    const std::string& interval,
+                                                    core::Timestamp start_time,
+                                                    core::Timestamp end_time) override;
+        core::CandleSeries queryCandleSeries(const std::string& instrument_key,
+                                             const std::string& interval,
+                                             core::Timestamp start_time,
+                                             core::Timestamp end_time) override;
+
+    private:
+        std::map<std::string, core::CandleSeries> series_;
+    };
+
+} // namespace checks
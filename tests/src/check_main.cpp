@@ -0,0 +1,74 @@
+// tp_checks: runs every registered check, or those whose name starts with argv[1].
+// Exit code 0 only if at least one check ran and none failed.
+
+#include "check.hpp"
+#include "logging.hpp"
+
+#include <cstdio>
+#include <exception>
+#include <string>
+#include <vector>
+
+namespace checks {
+
+    namespace { // File-local helpers
+
+        struct RegisteredCheck {
+            std::string name;
+            CheckFunction function;
+        };
+
+        // Function-local, so registrations from other translation units never see it unconstructed
+        std::vector<RegisteredCheck>& registry() {
+            static std::vector<RegisteredCheck> checks;
+            return checks;
+        }
+
+        std::size_t current_failures = 0;
+        constexpr std::size_t kMaxReportedFailures = 20; // Per check; the count is always reported
+
+    } // end anonymous namespace
+
+    Registration::Registration(const char* name, CheckFunction function) {
+        registry().push_back({name, function});
+    }
+
+    void fail(const char* file, int line, const std::string& message) {
+        if (++current_failures <= kMaxReportedFailures) {
+            std::fprintf(stderr, "  %s:%d: %s\n", file, line, message.c_str());
+        }
+    }
+
+    std::size_t failureCount() { return current_failures; }
+
+} // namespace checks
+
+int main(int argc, char** argv) {
+    const std::string prefix = argc > 1 ? argv[1] : "";
+    core::logging::initialize("tp_checks", spdlog::level::warn, spdlog::level::off);
+
+    std::size_t ran = 0;
+    std::size_t failed = 0;
+    for (const auto& check : checks::registry()) {
+        if (check.name.compare(0, prefix.size(), prefix) != 0) continue;
+        checks::current_failures = 0;
+        try {
+            check.function();
+        } catch (const std::exception& e) {
+            checks::fail(__FILE__, __LINE__, std::string("unexpected exception: ") + e.what());
+        }
+        ++ran;
+        if (checks::current_failures > 0) {
+            ++failed;
+            std::printf("[FAIL] %s (%zu failure(s))\n", check.name.c_str(), checks::current_failures);
+        } else {
+            std::printf("[ OK ] %s\n", check.name.c_str());
+        }
+    }
+    if (ran == 0) {
+        std::printf("No check matches '%s'.\n", prefix.c_str());
+        return 1;
+    }
+    std::printf("%zu check(s), %zu failed.\n", ran, failed);
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,248 @@
+// data::ColumnarCandleFile: write() then materialize() / series() return the candles
+// that went in (with and without open interest, and through ColumnarCandleStore);
+// findRange() against a binary search over all timestamps, for ranges starting and
+// ending on, next to and between block boundaries, with duplicate timestamps across
+// a boundary; and headers whose sizes would wrap a naive bounds check are rejected.
+
+#include "check.hpp"
+#include "check_data.hpp"
+#include "columnar_candle_store.hpp"
+#include "exceptions.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    // Removes the directory and every file written into it
+    struct TemporaryDirectory {
+        std::string path;
+        TemporaryDirectory()
+            : path(core::utils::uniqueTempPath((std::filesystem::temp_directory_path() / "tp_checks_columnar").string())) {
+            std::filesystem::create_directories(path);
+        }
+        ~TemporaryDirectory() {
+            std::error_code ec;
+            std::filesystem::remove_all(path, ec);
+        }
+        std::string file(const std::string& name) const { return (std::filesystem::path(path) / name).string(); }
+    };
+
+    // Random walk candles; every third bar carries open interest when 'with_oi'
+    core::TimeSeries<core::Candle> sampleCandles(std::size_t count, bool with_oi) {
+        const auto series = checks::randomWalkSeries(count, 31);
+        core::TimeSeries<core::Candle> candles = series.toCandles();
+        for (std::size_t i = 0; i < candles.size(); ++i) {
+            candles[i].volume = static_cast<long long>(i * 1'000'003 % 9'999'991);
+            if (with_oi && i % 3 == 0) candles[i].open_interest = static_cast<long long>(5'000'000 + i);
+        }
+        return candles;
+    }
+
+    bool sameCandle(const core::Candle& a, const core::Candle& b) {
+        return a.timestamp == b.timestamp && a.open == b.open && a.high == b.high && a.low == b.low &&
+               a.close == b.close && a.volume == b.volume && a.open_interest == b.open_interest;
+    }
+
+    void checkSameCandles(const core::TimeSeries<core::Candle>& actual, const core::TimeSeries<core::Candle>& expected,
+                          std::size_t offset, const char* what) {
+        TP_CHECK_MSG(actual.size() == expected.size(), what << ": " << actual.size() << " candles, expected " << expected.size());
+        std::size_t mismatches = 0;
+        for (std::size_t i = 0; i < actual.size() && i < expected.size(); ++i) {
+            if (sameCandle(actual[i], expected[i])) continue;
+            if (++mismatches <= 3) TP_CHECK_MSG(false, what << ": row " << (offset + i) << " differs");
+        }
+    }
+
+    std::shared_ptr<const data::ColumnarCandleFile> openFile(const std::string& path) {
+        return std::make_shared<const data::ColumnarCandleFile>(path);
+    }
+
+    // Rows [first, last) with start <= timestamp <= end, by binary search over the whole column
+    std::pair<std::size_t, std::size_t> expectedRange(const std::vector<std::int64_t>& ts, std::int64_t start, std::int64_t end) {
+        if (start > end) return {0, 0};
+        const auto first = std::lower_bound(ts.begin(), ts.end(), start);
+        const auto last = std::upper_bound(first, ts.end(), end);
+        return {static_cast<std::size_t>(first - ts.begin()), static_cast<std::size_t>(last - ts.begin())};
+    }
+
+    // Overwrites sizeof(T) bytes of the file at 'offset'
+    template <typename T>
+    void patch(const std::string& path, std::size_t offset, T value) {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(static_cast<std::streamoff>(offset));
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    bool rejected(const std::string& path) {
+        try {
+            openFile(path);
+            return false;
+        } catch (const core::DataLoadException&) {
+            return true;
+        }
+    }
+
+} // end anonymous namespace
+
+TP_CHECK_CASE(columnarRoundTrip, "data.columnar_store") {
+    TemporaryDirectory directory;
+    for (const bool with_oi : {false, true}) {
+        const auto candles = sampleCandles(1000, with_oi);
+        const std::string path = directory.file(with_oi ? "oi.tpcol" : "plain.tpcol");
+        TP_CHECK(data::ColumnarCandleFile::write(path, "NSE_EQ|ROUNDTRIP", "1minute", candles, 64));
+        const auto file = openFile(path);
+        TP_CHECK(file->size() == candles.size());
+        TP_CHECK(file->hasOpenInterest() == with_oi);
+        TP_CHECK(file->openInterest().empty() != with_oi);
+        TP_CHECK(file->header().block_rows == 64);
+        TP_CHECK(file->header().block_count == (candles.size() + 63) / 64);
+        TP_CHECK(std::string(file->header().instrument_key) == "NSE_EQ|ROUNDTRIP");
+        TP_CHECK(std::string(file->header().interval) == "1minute");
+
+        checkSameCandles(file->materialize(0, file->size()), candles, 0, "materialize");
+        const core::TimeSeries<core::Candle> middle(candles.begin() + 63, candles.begin() + 700);
+        checkSameCandles(file->materialize(63, 700), middle, 63, "materialize(63, 700)");
+        TP_CHECK(file->materialize(5, 5).empty());
+
+        // The zero-copy view holds the same columns, and keeps its mapping alive on its own
+        const core::CandleSeries view = openFile(path)->series(63, 700);
+        TP_CHECK(view.size() == middle.size());
+        checkSameCandles(view.toCandles(), middle, 63, "series(63, 700)");
+        TP_CHECK(file->series(700, 700).size() == 0);
+    }
+
+    // An empty series writes and maps
+    const std::string empty_path = directory.file("empty.tpcol");
+    TP_CHECK(data::ColumnarCandleFile::write(empty_path, "NSE_EQ|EMPTY", "day", {}));
+    const auto empty = openFile(empty_path);
+    TP_CHECK(empty->size() == 0 && empty->header().block_count == 0);
+    TP_CHECK(empty->findRange(std::numeric_limits<std::int64_t>::min(), std::numeric_limits<std::int64_t>::max()) ==
+             std::make_pair(std::size_t{0}, std::size_t{0}));
+
+    // Unsorted candles are refused
+    auto unsorted = sampleCandles(10, false);
+    std::swap(unsorted[3], unsorted[4]);
+    TP_CHECK(!data::ColumnarCandleFile::write(directory.file("unsorted.tpcol"), "NSE_EQ|X", "day", unsorted));
+
+    // Through the store: file naming, the key check and a timestamp range query
+    const auto candles = sampleCandles(500, true);
+    data::ColumnarCandleStore store(directory.path);
+    TP_CHECK(store.connect());
+    TP_CHECK(data::ColumnarCandleFile::write(store.pathFor("NSE_EQ|STORE", "1minute"), "NSE_EQ|STORE", "1minute", candles, 32));
+    const auto queried = store.queryCandles("NSE_EQ|STORE", "1minute", candles[100].timestamp, candles[399].timestamp);
+    checkSameCandles(queried, core::TimeSeries<core::Candle>(candles.begin() + 100, candles.begin() + 400), 100, "queryCandles");
+    const auto series = store.queryCandleSeries("NSE_EQ|STORE", "1minute", candles[100].timestamp, candles[399].timestamp);
+    TP_CHECK(series.size() == 300);
+    TP_CHECK(store.openSeries("NSE_EQ|MISSING", "1minute") == nullptr);
+}
+
+TP_CHECK_CASE(columnarFindRangeAtBlockBoundaries, "data.columnar_store.find_range") {
+    TemporaryDirectory directory;
+    constexpr std::uint32_t kBlockRows = 16;
+    // 10 ns apart, with rows 31 and 32 sharing a timestamp across the second block boundary
+    // and a run of equal timestamps filling the whole fourth block
+    auto candles = sampleCandles(100, false);
+    std::vector<std::int64_t> ts(candles.size());
+    const std::int64_t base = core::utils::timestampToEpochNanos(candles.front().timestamp);
+    for (std::size_t i = 0; i < candles.size(); ++i) {
+        std::int64_t offset = static_cast<std::int64_t>(i) * 10;
+        if (i == 32) offset = 31 * 10;
+        if (i >= 48 && i < 64) offset = 48 * 10;
+        ts[i] = base + offset;
+        candles[i].timestamp = core::utils::epochNanosToTimestamp(ts[i]);
+    }
+    const std::string path = directory.file("blocks.tpcol");
+    TP_CHECK(data::ColumnarCandleFile::write(path, "NSE_EQ|BLOCKS", "1minute", candles, kBlockRows));
+    const auto file = openFile(path);
+    TP_CHECK(file->header().block_count == 7);
+
+    // Range ends on, one row around and between the timestamps next to every boundary,
+    // plus the ends of the file and beyond
+    std::vector<std::int64_t> probes = {ts.front() - 1000, ts.front(), ts.back(), ts.back() + 1, ts.back() + 1000};
+    for (std::size_t boundary = 0; boundary <= candles.size(); boundary += kBlockRows) {
+        for (std::size_t row : {boundary, boundary + 1}) {
+            if (row == 0 || row > candles.size()) continue;
+            for (std::int64_t delta : {-1, 0, 1}) {
+                probes.push_back(ts[row - 1] + delta);
+                if (row < candles.size()) probes.push_back(ts[row] + delta);
+            }
+        }
+    }
+    std::size_t mismatches = 0;
+    for (const std::int64_t start : probes) {
+        for (const std::int64_t end : probes) {
+            const auto actual = file->findRange(start, end);
+            const auto expected = expectedRange(ts, start, end);
+            if (actual == expected) continue;
+            if (++mismatches <= 5) {
+                TP_CHECK_MSG(false, "findRange(" << start - base << ", " << end - base << ") = [" << actual.first << ", "
+                                    << actual.second << "), expected [" << expected.first << ", " << expected.second << ")");
+            }
+        }
+    }
+    TP_CHECK_MSG(mismatches == 0, mismatches << " of " << probes.size() * probes.size() << " ranges differ");
+
+    // Whole blocks: first row to last row of each block
+    for (std::size_t first = 0; first < candles.size(); first += kBlockRows) {
+        const std::size_t last = std::min(candles.size(), first + kBlockRows) - 1;
+        TP_CHECK(file->findRange(ts[first], ts[last]) == expectedRange(ts, ts[first], ts[last]));
+    }
+}
+
+TP_CHECK_CASE(columnarRejectsCorruptHeaders, "data.columnar_store.corrupt") {
+    TemporaryDirectory directory;
+    const auto candles = sampleCandles(200, true);
+    const std::string valid = directory.file("valid.tpcol");
+    TP_CHECK(data::ColumnarCandleFile::write(valid, "NSE_EQ|CORRUPT", "1minute", candles, 64));
+    TP_CHECK(!rejected(valid));
+
+    std::size_t variant = 0;
+    const auto corrupted = [&](auto&& apply) {
+        const std::string path = directory.file("corrupt" + std::to_string(variant++) + ".tpcol");
+        std::filesystem::copy_file(valid, path);
+        apply(path);
+        return rejected(path);
+    };
+    const auto header = openFile(valid)->header();
+
+    // row_count * 8 wraps to 8: offset + 8 fits the file, so only the division catches it
+    TP_CHECK(corrupted([](const std::string& path) {
+        patch<std::uint64_t>(path, offsetof(data::ColumnarFileHeader, row_count), (std::uint64_t{1} << 61) + 1);
+    }));
+    // More rows than the columns hold (the last one would run past the end of the file)
+    TP_CHECK(corrupted([](const std::string& path) {
+        patch<std::uint64_t>(path, offsetof(data::ColumnarFileHeader, row_count), 400);
+    }));
+    // A block index offset that wraps back into the file once the entries are added
+    TP_CHECK(corrupted([](const std::string& path) {
+        patch<std::uint64_t>(path, offsetof(data::ColumnarFileHeader, block_index_offset),
+                             std::numeric_limits<std::uint64_t>::max() - 7);
+    }));
+    TP_CHECK(corrupted([](const std::string& path) {
+        patch<std::uint32_t>(path, offsetof(data::ColumnarFileHeader, block_count), std::numeric_limits<std::uint32_t>::max());
+    }));
+    // A column offset past the end of the file
+    TP_CHECK(corrupted([](const std::string& path) {
+        patch<std::uint64_t>(path, offsetof(data::ColumnarFileHeader, column_offsets) + 8 * data::kColClose,
+                             std::numeric_limits<std::uint64_t>::max() - 63);
+    }));
+    // A block whose first row lies beyond the rows
+    TP_CHECK(corrupted([&](const std::string& path) {
+        patch<std::uint64_t>(path, header.block_index_offset + offsetof(data::ColumnarBlockIndexEntry, first_row), 5000);
+    }));
+    TP_CHECK(corrupted([](const std::string& path) { patch<char>(path, 0, 'X'); }));
+    TP_CHECK(corrupted([](const std::string& path) {
+        std::filesystem::resize_file(path, std::filesystem::file_size(path) - 8);
+    }));
+}
@@ -0,0 +1,154 @@
+// Concurrent readers on DatabaseManager's read pool: results must equal the
+// single-threaded ones while a writer inserts, and the pool must never open more
+// than its maximum of connections.
+
+#include "check.hpp"
+#include "check_data.hpp"
+#include "database_manager.hpp"
+#include "sqlite_connection_pool.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    // Removes the database and its WAL / shared-memory files
+    struct TemporaryDatabase {
+        std::string path;
+        TemporaryDatabase()
+            : path(core::utils::uniqueTempPath((std::filesystem::temp_directory_path() / "tp_checks_pool.db").string())) {}
+        ~TemporaryDatabase() {
+            std::error_code ec;
+            for (const char* suffix : {"", "-wal", "-shm"}) std::filesystem::remove(path + suffix, ec);
+        }
+    };
+
+    constexpr std::size_t kSeriesCount = 6;
+    constexpr std::size_t kBarsPerSeries = 3000;
+    constexpr std::size_t kReaderThreads = 8;
+    constexpr std::size_t kPoolSize = 3; // Fewer than the readers, so they queue for leases
+
+    std::string seriesKey(std::size_t s) { return "NSE_EQ|POOL" + std::to_string(s); }
+
+    bool sameCandles(const core::TimeSeries<core::Candle>& a, const core::TimeSeries<core::Candle>& b) {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](const core::Candle& x, const core::Candle& y) {
+            return x.timestamp == y.timestamp && x.open == y.open && x.high == y.high && x.low == y.low &&
+                   x.close == y.close && x.volume == y.volume;
+        });
+    }
+
+} // end anonymous namespace
+
+TP_CHECK_CASE(concurrentReadersMatchSerialReads, "data.connection_pool") {
+    TemporaryDatabase database;
+    data::SqliteOptions options;
+    options.max_read_connections = kPoolSize;
+    data::DatabaseManager db(database.path, options);
+    TP_CHECK(db.connect() && db.initializeSchema());
+
+    std::vector<core::TimeSeries<core::Candle>> stored(kSeriesCount);
+    for (std::size_t s = 0; s < kSeriesCount; ++s) {
+        stored[s] = checks::randomWalkSeries(kBarsPerSeries, 200 + static_cast<unsigned>(s)).toCandles();
+        TP_CHECK(db.saveCandles(stored[s], seriesKey(s), "1minute"));
+    }
+
+    // Query windows and their single-threaded answers
+    struct Query { std::size_t series; std::size_t first; std::size_t last; };
+    std::vector<Query> queries;
+    std::mt19937 rng(5);
+    for (int q = 0; q < 64; ++q) {
+        Query query;
+        query.series = rng() % kSeriesCount;
+        query.first = rng() % kBarsPerSeries;
+        query.last = std::min(kBarsPerSeries - 1, query.first + rng() % 1500);
+        queries.push_back(query);
+    }
+    auto run = [&](const Query& q) {
+        return db.queryCandles(seriesKey(q.series), "1minute", stored[q.series][q.first].timestamp, stored[q.series][q.last].timestamp);
+    };
+    std::vector<core::TimeSeries<core::Candle>> expected;
+    for (const auto& q : queries) {
+        expected.push_back(run(q));
+        TP_CHECK_MSG(expected.back().size() == q.last - q.first + 1, "serial query returned " << expected.back().size() << " rows");
+    }
+
+    // Readers replay the queries in different orders while a writer adds new series
+    std::atomic<std::size_t> mismatches{0};
+    std::atomic<std::size_t> completed{0};
+    std::atomic<bool> writing{true};
+    std::thread writer([&]() {
+        for (std::size_t s = kSeriesCount; s < kSeriesCount + 4; ++s) {
+            db.saveCandles(checks::randomWalkSeries(kBarsPerSeries, 300 + static_cast<unsigned>(s)).toCandles(), seriesKey(s), "1minute");
+        }
+        writing = false;
+    });
+    std::vector<std::thread> readers;
+    for (std::size_t t = 0; t < kReaderThreads; ++t) {
+        readers.emplace_back([&, t]() {
+            std::mt19937 order(static_cast<unsigned>(t));
+            for (int round = 0; round < 8; ++round) {
+                for (std::size_t k = 0; k < queries.size(); ++k) {
+                    const std::size_t q = (k * (t + 1) + order()) % queries.size();
+                    if (!sameCandles(run(queries[q]), expected[q])) ++mismatches;
+                    ++completed;
+                }
+            }
+        });
+    }
+    for (auto& reader : readers) reader.join();
+    writer.join();
+
+    TP_CHECK_MSG(mismatches == 0, mismatches.load() << " of " << completed.load() << " concurrent reads differ");
+    TP_CHECK(!writing);
+    // The writer's series are all there afterwards
+    for (std::size_t s = kSeriesCount; s < kSeriesCount + 4; ++s) {
+        const auto rows = db.queryCandles(seriesKey(s), "1minute", stored[0].front().timestamp, stored[0].back().timestamp);
+        TP_CHECK_MSG(rows.size() == kBarsPerSeries, seriesKey(s) << ": " << rows.size() << " rows");
+    }
+    db.disconnect();
+}
+
+TP_CHECK_CASE(poolNeverExceedsMaximum, "data.connection_pool.limit") {
+    TemporaryDatabase database;
+    {   // Create the file with a table in WAL mode
+        data::DatabaseManager db(database.path);
+        TP_CHECK(db.connect() && db.initializeSchema());
+        db.disconnect();
+    }
+
+    const std::size_t maximum = 2;
+    data::SqliteOptions options;
+    options.max_read_connections = maximum;
+    data::SqliteConnectionPool pool(database.path, options);
+    TP_CHECK(pool.maxConnections() == maximum);
+
+    std::atomic<std::size_t> leased{0};
+    std::atomic<std::size_t> peak{0};
+    std::atomic<std::size_t> over_limit{0};
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < kReaderThreads; ++t) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < 200; ++i) {
+                auto lease = pool.acquire();
+                const std::size_t now = ++leased;
+                std::size_t seen = peak.load();
+                while (now > seen && !peak.compare_exchange_weak(seen, now)) {}
+                if (now > maximum || pool.openConnections() > maximum) ++over_limit;
+                auto stmt = lease->statement("SELECT COUNT(*) FROM historical_candles;");
+                if (stmt) sqlite3_step(stmt.get());
+                --leased;
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    TP_CHECK_MSG(over_limit == 0, over_limit.load() << " leases above the maximum of " << maximum);
+    TP_CHECK_MSG(peak >= 1 && peak <= maximum, "peak of " << peak.load() << " concurrent leases");
+    TP_CHECK(pool.openConnections() >= 1 && pool.openConnections() <= maximum);
+}
@@ -0,0 +1,162 @@
+// Backtester runs in EvaluationMode::PerBar (IStrategy::evaluate per bar) and
+// EvaluationMode::Vectorized (IStrategy::generateSignals over whole columns) must
+// produce the same trades and metrics, in particular around the warm-up boundary
+// where crosses have no previous value yet.
+
+#include "check.hpp"
+#include "check_data.hpp"
+#include "backtester.hpp"
+#include "utils.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace {
+
+    using backtester::EvaluationMode;
+    using json = nlohmann::json;
+
+    const std::string kEndDate = "2000-01-31";
+
+    json strategyConfig(const std::string& name, const std::vector<std::string>& indicators,
+                        const json& entry, const json& exit, const std::vector<std::string>& instruments)
+    {
+        json config;
+        config["strategy_name"] = name;
+        config["timeframes"] = {"1minute"};
+        config["instruments"] = instruments;
+        config["position_sizing"] = {{"method", "Quantity"}, {"value", 10}};
+        config["indicators"] = json::array();
+        for (const auto& indicator : indicators) config["indicators"].push_back({{"name", indicator}});
+        config["entry_rules"] = {{{"rule_name", "Enter"}, {"action", "EnterLong"}, {"condition", entry}}};
+        config["exit_rules"] = {{{"rule_name", "Exit"}, {"action", "ExitLong"}, {"condition", exit}}};
+        return config;
+    }
+
+    json cross(const std::string& type, const std::string& a, const std::string& b) {
+        return {{"type", type}, {"indicator1", a}, {"indicator2", b}};
+    }
+
+    struct RunResult {
+        bool ok = false;
+        backtester::BacktestMetrics metrics;
+        std::vector<core::Trade> trades;
+    };
+
+    RunResult runIn(EvaluationMode mode, data::ICandleSource& source, const json& config,
+                    const core::Timestamp* range_from = nullptr)
+    {
+        backtester::Backtester backtester(source);
+        backtester.setEvaluationMode(mode);
+        if (range_from) backtester.setEvaluationRange(*range_from, core::utils::stringToTimestamp(kEndDate + "T23:59:59+05:30"));
+        RunResult result;
+        result.ok = backtester.run(config, checks::kCheckStartDate, kEndDate);
+        result.metrics = backtester.getMetrics();
+        const auto& log = backtester.getPortfolio().getTradeLog();
+        result.trades.assign(log.begin(), log.end());
+        return result;
+    }
+
+    // Same inputs, same arithmetic: everything must match exactly. Returns the trade count.
+    std::size_t compareModes(const std::string& label, data::ICandleSource& source, const json& config,
+                      const core::Timestamp* range_from = nullptr)
+    {
+        const RunResult per_bar = runIn(EvaluationMode::PerBar, source, config, range_from);
+        const RunResult vectorized = runIn(EvaluationMode::Vectorized, source, config, range_from);
+        TP_CHECK_MSG(per_bar.ok && vectorized.ok, label << ": run failed");
+
+        TP_CHECK_MSG(per_bar.trades.size() == vectorized.trades.size(),
+                     label << ": " << per_bar.trades.size() << " trades per bar, " << vectorized.trades.size() << " vectorized");
+        for (std::size_t i = 0; i < per_bar.trades.size() && i < vectorized.trades.size(); ++i) {
+            const core::Trade& a = per_bar.trades[i];
+            const core::Trade& b = vectorized.trades[i];
+            TP_CHECK_MSG(a.instrument_key == b.instrument_key && a.entry_time == b.entry_time && a.exit_time == b.exit_time &&
+                         a.quantity == b.quantity && a.entry_price == b.entry_price && a.exit_price == b.exit_price &&
+                         a.pnl == b.pnl,
+                         label << ": trade " << i << " differs (" << core::utils::timestampToString(a.entry_time) << " vs "
+                               << core::utils::timestampToString(b.entry_time) << ")");
+        }
+
+        const auto& m = per_bar.metrics;
+        const auto& v = vectorized.metrics;
+        TP_CHECK_MSG(m.total_executions == v.total_executions && m.round_trip_trades == v.round_trip_trades,
+                     label << ": executions " << m.total_executions << " vs " << v.total_executions);
+        TP_CHECK_MSG(m.total_pnl == v.total_pnl && m.total_return_pct == v.total_return_pct &&
+                     m.max_drawdown_pct == v.max_drawdown_pct && m.win_rate == v.win_rate &&
+                     m.profit_factor == v.profit_factor && m.avg_win_pnl == v.avg_win_pnl && m.avg_loss_pnl == v.avg_loss_pnl,
+                     label << ": pnl " << m.total_pnl << " vs " << v.total_pnl);
+        TP_CHECK_MSG(m.sharpe_ratio == v.sharpe_ratio && m.sortino_ratio == v.sortino_ratio && m.cagr_pct == v.cagr_pct &&
+                     m.exposure_pct == v.exposure_pct && m.max_drawdown_duration_bars == v.max_drawdown_duration_bars,
+                     label << ": risk metrics differ (sharpe " << m.sharpe_ratio << " vs " << v.sharpe_ratio << ")");
+        return per_bar.trades.size();
+    }
+
+} // end anonymous namespace
+
+TP_CHECK_CASE(evaluationModesMatchOnRandomSeries, "backtester.evaluation_modes") {
+    checks::MemoryCandleSource source;
+    std::vector<std::string> instruments;
+    for (unsigned seed = 0; seed < 4; ++seed) {
+        const std::string key = "NSE_EQ|CHECK" + std::to_string(seed);
+        source.add(key, checks::randomWalkSeries(6000, 100 + seed, seed == 3 ? 0.3 : 0.0));
+        instruments.push_back(key);
+    }
+
+    std::vector<json> configs;
+    configs.push_back(strategyConfig("SmaCrossFiltered", {"SMA(10)", "SMA(30)"},
+        {{"type", "AND"}, {"conditions", {cross("CrossesAbove", "SMA(10)", "SMA(30)"),
+            {{"type", "PriceIndicator"}, {"price_field", "Close"}, {"op", "GT"}, {"indicator", "SMA(30)"}}}}},
+        cross("CrossesBelow", "SMA(10)", "SMA(30)"), instruments));
+    configs.push_back(strategyConfig("RsiBands", {"RSI(14)"},
+        {{"type", "Indicator"}, {"indicator1", "RSI(14)"}, {"op", "LT"}, {"value", 35}},
+        {{"type", "Indicator"}, {"indicator1", "RSI(14)"}, {"op", "GTE"}, {"value", 60}}, instruments));
+    // Short crosses evaluated from the long indicator's lookback on
+    configs.push_back(strategyConfig("ShortCrossLongFilter", {"SMA(2)", "SMA(3)", "SMA(50)"},
+        {{"type", "OR"}, {"conditions", {cross("CrossesAbove", "SMA(2)", "SMA(3)"),
+            {{"type", "Price"}, {"field1", "Close"}, {"op", "GT"}, {"field2", "Open"}}}}},
+        {{"type", "AND"}, {"conditions", {cross("CrossesBelow", "SMA(2)", "SMA(3)"),
+            {{"type", "Indicator"}, {"indicator1", "SMA(2)"}, {"op", "LT"}, {"indicator2", "SMA(50)"}}}}}, instruments));
+
+    for (const auto& config : configs) {
+        const std::string name = config["strategy_name"];
+        // A comparison of two empty trade logs would prove nothing
+        TP_CHECK_MSG(compareModes(name, source, config) > 0, name << ": no trades");
+        // Evaluation range: first_bar comes from the range, with warm indicators
+        const core::Timestamp from = core::utils::stringToTimestamp(checks::kCheckStartDate + "T12:00:00+05:30");
+        TP_CHECK_MSG(compareModes(name + " (range)", source, config, &from) > 0, name << " (range): no trades");
+    }
+}
+
+TP_CHECK_CASE(evaluationModesWarmupBoundary, "backtester.evaluation_modes.warmup") {
+    // SMA(5) has no value before bar 4, so on bar 4 (the first evaluated bar) the cross
+    // has no previous value and must not fire, although SMA(2) 12.5 > SMA(5) 11 there
+    // and SMA(2) 7.5 was below the SMA(5) that bar 3 would have had.
+    std::vector<double> closes = {10, 10, 10, 5, 20};
+    closes.resize(40, 20.0);
+    checks::MemoryCandleSource source;
+    source.add("NSE_EQ|EDGE", checks::seriesFromCloses(closes));
+
+    const json config = strategyConfig("BoundaryCross", {"SMA(2)", "SMA(5)"},
+        cross("CrossesAbove", "SMA(2)", "SMA(5)"), cross("CrossesBelow", "SMA(2)", "SMA(5)"), {"NSE_EQ|EDGE"});
+    for (EvaluationMode mode : {EvaluationMode::PerBar, EvaluationMode::Vectorized}) {
+        const RunResult result = runIn(mode, source, config);
+        TP_CHECK_MSG(result.ok && result.metrics.total_executions == 0,
+                     (mode == EvaluationMode::PerBar ? "per bar" : "vectorized") << ": "
+                         << result.metrics.total_executions << " executions at the warm-up boundary");
+    }
+
+    // One bar later the previous value exists: the same cross must fire in both modes
+    std::vector<double> later = {10, 10, 10, 10, 10, 5, 20};
+    later.resize(40, 20.0);
+    checks::MemoryCandleSource later_source;
+    later_source.add("NSE_EQ|EDGE", checks::seriesFromCloses(later));
+    for (EvaluationMode mode : {EvaluationMode::PerBar, EvaluationMode::Vectorized}) {
+        const RunResult result = runIn(mode, later_source, config);
+        TP_CHECK_MSG(result.ok && result.metrics.total_executions >= 1,
+                     (mode == EvaluationMode::PerBar ? "per bar" : "vectorized") << ": cross after the boundary did not fire");
+    }
+    compareModes("BoundaryCross", source, config);
+    compareModes("BoundaryCross (one bar later)", later_source, config);
+}
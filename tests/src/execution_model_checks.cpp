@@ -0,0 +1,281 @@
+// OrderBook::match() and FeeSchedule::calculate() against hand-worked bars and
+// charges: gap-through fills at the open, stops before limits on a bar that
+// reaches both, expiry after the last valid bar, and the brokerage cap with GST
+// on top. The end-to-end cases run the same rules through a Backtester.
+
+#include "check.hpp"
+#include "check_data.hpp"
+#include "backtester.hpp"
+#include "execution_model.hpp"
+#include "exceptions.hpp"
+#include "utils.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace {
+
+    using backtester::OrderBook;
+    using backtester::OrderFill;
+    using backtester::OrderType;
+    using backtester::PendingOrder;
+    using core::SignalAction;
+    using json = nlohmann::json;
+
+    bool near(double a, double b, double tolerance = 1e-9) { return std::fabs(a - b) <= tolerance; }
+
+    core::Candle bar(double open, double high, double low, double close) {
+        core::Candle candle;
+        candle.open = open;
+        candle.high = high;
+        candle.low = low;
+        candle.close = close;
+        candle.volume = 1000;
+        return candle;
+    }
+
+    PendingOrder order(SignalAction action, OrderType type, double price = 0.0) {
+        PendingOrder pending;
+        pending.action = action;
+        pending.type = type;
+        pending.price = price;
+        return pending;
+    }
+
+    // Minute bars from kCheckStartDate with the given prices
+    core::CandleSeries seriesFromBars(const std::vector<core::Candle>& bars) {
+        const core::Timestamp start = core::utils::stringToTimestamp(checks::kCheckStartDate + "T09:15:00+05:30");
+        core::CandleSeries::Builder builder;
+        builder.reserve(bars.size());
+        for (std::size_t i = 0; i < bars.size(); ++i) {
+            core::Candle candle = bars[i];
+            candle.timestamp = start + std::chrono::minutes(i);
+            builder.push_back(candle);
+        }
+        return builder.build();
+    }
+
+    // Enters long on the first bar that closes above its open (bar 1 of every series
+    // below, all other bars are flat) and never exits by signal
+    json executionStrategy(const json& execution) {
+        json config;
+        config["strategy_name"] = "ExecutionCheck";
+        config["timeframes"] = {"1minute"};
+        config["instruments"] = {"NSE_EQ|EXEC"};
+        config["position_sizing"] = {{"method", "Quantity"}, {"value", 10}};
+        config["indicators"] = json::array();
+        config["entry_rules"] = {{{"rule_name", "Enter"}, {"action", "EnterLong"},
+            {"condition", {{"type", "Price"}, {"field1", "Close"}, {"op", "GT"}, {"field2", "Open"}}}}};
+        config["exit_rules"] = {{{"rule_name", "Exit"}, {"action", "ExitLong"},
+            {"condition", {{"type", "Price"}, {"field1", "Close"}, {"op", "LT"}, {"field2", "Open"}}}}};
+        config["execution"] = execution;
+        return config;
+    }
+
+    std::vector<core::Trade> runTrades(const std::vector<core::Candle>& bars, const json& execution) {
+        checks::MemoryCandleSource source;
+        source.add("NSE_EQ|EXEC", seriesFromBars(bars));
+        backtester::Backtester backtester(source);
+        TP_CHECK(backtester.run(executionStrategy(execution), checks::kCheckStartDate, checks::kCheckStartDate));
+        const auto& log = backtester.getPortfolio().getTradeLog();
+        return {log.begin(), log.end()};
+    }
+
+} // end anonymous namespace
+
+TP_CHECK_CASE(orderBookGapFills, "backtester.execution_model.gaps") {
+    OrderBook book;
+    std::vector<OrderFill> fills;
+
+    // Reached inside the bar: filled at the order price
+    book.submit(order(SignalAction::EnterLong, OrderType::Stop, 105.0));
+    book.submit(order(SignalAction::ExitLong, OrderType::Stop, 95.0));
+    book.submit(order(SignalAction::EnterLong, OrderType::Limit, 96.0));
+    book.submit(order(SignalAction::ExitLong, OrderType::Limit, 104.0));
+    book.match(bar(100.0, 106.0, 94.0, 100.0), 0, fills);
+    TP_CHECK_MSG(fills.size() == 4, fills.size() << " fills");
+    for (const OrderFill& fill : fills) {
+        TP_CHECK_MSG(near(fill.price, fill.order.price), "order at " << fill.order.price << " filled at " << fill.price);
+    }
+    TP_CHECK(book.empty());
+
+    // Gapped through: every order fills at the open, stops worse and limits better than their price
+    fills.clear();
+    book.submit(order(SignalAction::EnterLong, OrderType::Stop, 105.0));
+    book.submit(order(SignalAction::ExitLong, OrderType::Limit, 104.0));
+    book.match(bar(110.0, 112.0, 109.0, 111.0), 1, fills);
+    TP_CHECK(fills.size() == 2);
+    for (const OrderFill& fill : fills) TP_CHECK_MSG(near(fill.price, 110.0), "filled at " << fill.price);
+
+    fills.clear();
+    book.submit(order(SignalAction::ExitLong, OrderType::Stop, 95.0));
+    book.submit(order(SignalAction::EnterLong, OrderType::Limit, 96.0));
+    book.match(bar(90.0, 91.0, 88.0, 90.0), 2, fills);
+    TP_CHECK(fills.size() == 2);
+    for (const OrderFill& fill : fills) TP_CHECK_MSG(near(fill.price, 90.0), "filled at " << fill.price);
+
+    // Not reached: everything rests
+    fills.clear();
+    book.submit(order(SignalAction::EnterLong, OrderType::Stop, 105.0));
+    book.submit(order(SignalAction::EnterLong, OrderType::Limit, 95.0));
+    book.match(bar(100.0, 104.99, 95.01, 100.0), 3, fills);
+    TP_CHECK(fills.empty() && book.size() == 2);
+}
+
+TP_CHECK_CASE(orderBookExecutionOrder, "backtester.execution_model.order") {
+    OrderBook book;
+    std::vector<OrderFill> fills;
+
+    // Long from 100 with a stop-loss at 98 and a target at 104; the bar reaches both
+    PendingOrder target = order(SignalAction::ExitLong, OrderType::Limit, 104.0);
+    target.protective = true;
+    PendingOrder stop = order(SignalAction::ExitLong, OrderType::Stop, 98.0);
+    stop.protective = true;
+    book.submit(target); // Submitted first, still matched after the stop
+    book.submit(stop);
+    const backtester::OrderId market = book.submit(order(SignalAction::EnterShort, OrderType::Market));
+    book.match(bar(100.0, 105.0, 97.0, 101.0), 0, fills);
+    TP_CHECK_MSG(fills.size() == 3, fills.size() << " fills");
+    if (fills.size() == 3) {
+        TP_CHECK_MSG(fills[0].order.id == market && near(fills[0].price, 100.0), "market order not first at the open");
+        TP_CHECK_MSG(fills[1].order.type == OrderType::Stop && near(fills[1].price, 98.0), "stop not before the limit");
+        TP_CHECK_MSG(fills[2].order.type == OrderType::Limit && near(fills[2].price, 104.0), "limit not last");
+    }
+
+    // Several orders on one side trigger nearest first; the first one not reached ends the walk
+    fills.clear();
+    for (double price : {103.0, 101.0, 107.0, 102.0}) book.submit(order(SignalAction::EnterLong, OrderType::Stop, price));
+    book.match(bar(100.0, 103.5, 99.0, 103.0), 1, fills);
+    TP_CHECK(fills.size() == 3 && book.size() == 1);
+    for (std::size_t i = 0; i < fills.size(); ++i) {
+        TP_CHECK_MSG(near(fills[i].price, 101.0 + static_cast<double>(i)), "fill " << i << " at " << fills[i].price);
+    }
+
+    // Cancelled orders never fill
+    book.clear();
+    fills.clear();
+    const backtester::OrderId cancelled = book.submit(order(SignalAction::EnterLong, OrderType::Limit, 99.0));
+    TP_CHECK(book.cancel(cancelled) && !book.cancel(cancelled));
+    book.match(bar(100.0, 100.0, 90.0, 95.0), 2, fills);
+    TP_CHECK(fills.empty() && book.empty());
+}
+
+TP_CHECK_CASE(orderBookExpiry, "backtester.execution_model.expiry") {
+    OrderBook book;
+    std::vector<OrderFill> fills;
+    const core::Candle quiet = bar(100.0, 100.5, 99.5, 100.0);
+
+    // May fill up to and including bar 5
+    PendingOrder limit = order(SignalAction::EnterLong, OrderType::Limit, 98.0);
+    limit.expires_after_bar = 5;
+    book.submit(limit);
+    for (std::size_t i = 3; i <= 4; ++i) book.match(quiet, i, fills);
+    TP_CHECK(fills.empty() && book.size() == 1 && book.hasEntry());
+    book.match(quiet, 5, fills);
+    TP_CHECK_MSG(fills.empty() && book.empty(), "still " << book.size() << " order(s) after the last valid bar");
+    book.match(bar(100.0, 100.0, 90.0, 95.0), 6, fills);
+    TP_CHECK(fills.empty());
+
+    // Reached on its last bar: fills
+    limit.expires_after_bar = 8;
+    book.submit(limit);
+    book.match(bar(100.0, 100.0, 97.0, 99.0), 8, fills);
+    TP_CHECK(fills.size() == 1 && book.empty());
+
+    // An order filled (or cancelled) before its expiry leaves no stale entry behind
+    fills.clear();
+    limit.expires_after_bar = 12;
+    const backtester::OrderId early = book.submit(limit);
+    book.cancel(early);
+    PendingOrder later = order(SignalAction::EnterLong, OrderType::Limit, 98.0);
+    book.submit(later);
+    book.match(quiet, 12, fills);
+    TP_CHECK(fills.empty() && book.size() == 1);
+}
+
+TP_CHECK_CASE(feeSchedules, "backtester.execution_model.fees") {
+    using backtester::FeeSchedule;
+    TP_CHECK(near(FeeSchedule::perShare(0.01).calculate(true, 250, 1234.5), 2.5));
+
+    // Intraday, 1000 @ 500: turnover 500000, brokerage 0.03% = 150 capped at 20
+    const FeeSchedule intraday = FeeSchedule::indiaEquityIntraday();
+    const double exchange = 500000.0 * 0.0000297;
+    const double sebi = 500000.0 * 0.000001;
+    const double capped_gst = 0.18 * (20.0 + exchange + sebi);
+    const double intraday_buy = 20.0 + exchange + sebi + 500000.0 * 0.00003 + capped_gst;
+    const double intraday_sell = 20.0 + exchange + sebi + 500000.0 * 0.00025 + capped_gst;
+    TP_CHECK_MSG(near(intraday.calculate(true, 1000, 500.0), intraday_buy, 1e-6), intraday.calculate(true, 1000, 500.0));
+    TP_CHECK_MSG(near(intraday.calculate(false, 1000, 500.0), intraday_sell, 1e-6), intraday.calculate(false, 1000, 500.0));
+    TP_CHECK(near(intraday_buy, 56.713, 1e-6) && near(intraday_sell, 166.713, 1e-6));
+
+    // Below the cap: 10 @ 100, brokerage 0.30 and GST on it
+    const double small_brokerage = 1000.0 * 0.0003;
+    const double small_gst = 0.18 * (small_brokerage + 1000.0 * 0.0000297 + 1000.0 * 0.000001);
+    TP_CHECK(near(intraday.calculate(false, 10, 100.0),
+                  small_brokerage + 1000.0 * (0.00025 + 0.0000297 + 0.000001) + small_gst, 1e-9));
+
+    // Delivery, 100 @ 1000: no brokerage, STT 0.1% both sides, stamp duty on the buy only
+    const FeeSchedule delivery = FeeSchedule::indiaEquityDelivery();
+    TP_CHECK_MSG(near(delivery.calculate(true, 100, 1000.0), 118.6226, 1e-6), delivery.calculate(true, 100, 1000.0));
+    TP_CHECK_MSG(near(delivery.calculate(false, 100, 1000.0), 103.6226, 1e-6), delivery.calculate(false, 100, 1000.0));
+
+    // Overrides on top of a preset; unknown models are refused
+    const auto custom = backtester::ExecutionConfig::fromJson(
+        {{"fees", {{"model", "india_equity_intraday"}, {"brokerage_cap", 0.0}, {"gst_rate", 0.0}}}});
+    TP_CHECK(near(custom.fees.calculate(true, 1000, 500.0), 150.0 + exchange + sebi + 500000.0 * 0.00003, 1e-6));
+    bool refused = false;
+    try {
+        backtester::ExecutionConfig::fromJson({{"fees", "flat_rate"}});
+    } catch (const core::ConfigException&) {
+        refused = true;
+    }
+    TP_CHECK(refused);
+}
+
+TP_CHECK_CASE(backtesterProtectiveOrders, "backtester.execution_model.backtest") {
+    const json protective = {{"fees", {{"model", "per_share"}, {"per_share", 0.0}}}, {"stop_loss_pct", 2.0}, {"take_profit_pct", 2.0}};
+    const core::Candle flat = bar(101.0, 101.0, 101.0, 101.0);
+
+    // Entry at bar 1's close (101); bar 2 reaches the stop (98.98) and the target (103.02)
+    {
+        const auto trades = runTrades({bar(100, 100, 100, 100), bar(100, 101, 100, 101), bar(101, 104, 98, 101), flat, flat}, protective);
+        TP_CHECK_MSG(trades.size() == 1, trades.size() << " trades");
+        if (!trades.empty()) TP_CHECK_MSG(near(trades[0].exit_price, 101.0 * 0.98), "exit at " << trades[0].exit_price);
+    }
+    // Bar 2 opens below the stop: out at the open
+    {
+        const auto trades = runTrades({bar(100, 100, 100, 100), bar(100, 101, 100, 101), bar(97, 97, 96, 97),
+                                       bar(97, 97, 97, 97), bar(97, 97, 97, 97)}, protective);
+        TP_CHECK_MSG(trades.size() == 1, trades.size() << " trades");
+        if (!trades.empty()) TP_CHECK_MSG(near(trades[0].exit_price, 97.0), "exit at " << trades[0].exit_price);
+    }
+    // Only the target is reached
+    {
+        const auto trades = runTrades({bar(100, 100, 100, 100), bar(100, 101, 100, 101), bar(101, 104, 100, 101), flat, flat}, protective);
+        TP_CHECK_MSG(trades.size() == 1, trades.size() << " trades");
+        if (!trades.empty()) TP_CHECK_MSG(near(trades[0].exit_price, 101.0 * 1.02), "exit at " << trades[0].exit_price);
+    }
+}
+
+TP_CHECK_CASE(backtesterEntryExpiry, "backtester.execution_model.backtest_expiry") {
+    // Limit entry 1% below bar 1's close (99.99), valid for 2 bars: bars 2 and 3
+    const json limit = {{"fees", {{"model", "per_share"}, {"per_share", 0.0}}},
+                        {"entry_order", {{"type", "limit"}, {"offset_pct", 1.0}, {"valid_bars", 2}}}};
+    const core::Candle rest = bar(101.0, 101.0, 100.0, 101.0);
+    const core::Candle dip = bar(101.0, 101.0, 99.0, 101.0);
+    const core::Candle start = bar(100, 100, 100, 100);
+    const core::Candle signal = bar(100, 101, 100, 101);
+    const core::Candle exit = bar(101, 101, 100, 100.5); // Closes the position by signal, if there is one
+
+    // Dip on bar 3, the last valid bar: filled at the limit price
+    const auto filled = runTrades({start, signal, rest, dip, rest, exit, rest}, limit);
+    TP_CHECK_MSG(filled.size() == 1, filled.size() << " trades");
+    if (!filled.empty()) TP_CHECK_MSG(near(filled[0].entry_price, 101.0 * 0.99), "entry at " << filled[0].entry_price);
+    // Dip on bar 4: expired
+    const auto expired = runTrades({start, signal, rest, rest, dip, exit, rest}, limit);
+    TP_CHECK_MSG(expired.empty(), expired.size() << " trades after the entry order expired");
+}
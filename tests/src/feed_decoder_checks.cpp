@@ -0,0 +1,358 @@
+// data::decodeUpstoxFeed against the messages it has to read: appendUpstoxFeedMessage
+// round trips through the LTPC and MarketFullFeed layouts, hand-encoded
+// FirstLevelWithGreeks / IndexFullFeed feeds, unknown fields of every wire type at
+// every level, and malformed messages (truncated varints, lengths past the end,
+// wrong wire types), including every truncation of a valid message.
+
+#include "check.hpp"
+#include "upstox_feed_decoder.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    using data::UpstoxFeedTick;
+    using data::UpstoxFeedType;
+
+    // Owning copy of a decoded tick, so it outlives the callback
+    struct Tick {
+        std::string instrument_key;
+        double ltp = 0.0;
+        std::int64_t ltt_ms = 0;
+        std::int64_t ltq = 0;
+        double close_price = 0.0;
+        std::int64_t vtt = -1;
+        double open_interest = 0.0;
+        bool has_open_interest = false;
+    };
+
+    struct Decoded {
+        data::UpstoxFeedDecodeResult result;
+        std::vector<Tick> ticks;
+    };
+
+    Decoded decode(std::string_view message) {
+        Decoded decoded;
+        decoded.result = data::decodeUpstoxFeed(message, [&](const UpstoxFeedTick& tick) {
+            decoded.ticks.push_back({std::string(tick.instrument_key), tick.ltp, tick.ltt_ms, tick.ltq,
+                                     tick.close_price, tick.vtt, tick.open_interest, tick.has_open_interest});
+        });
+        return decoded;
+    }
+
+    std::string_view errorOf(const Decoded& decoded) {
+        return decoded.result.error ? std::string_view(decoded.result.error) : std::string_view();
+    }
+
+    void checkTick(const Tick& actual, const UpstoxFeedTick& expected) {
+        TP_CHECK_MSG(actual.instrument_key == expected.instrument_key, actual.instrument_key << " != " << expected.instrument_key);
+        TP_CHECK_MSG(actual.ltp == expected.ltp, actual.instrument_key << ": ltp " << actual.ltp << " != " << expected.ltp);
+        TP_CHECK_MSG(actual.ltt_ms == expected.ltt_ms, actual.instrument_key << ": ltt " << actual.ltt_ms << " != " << expected.ltt_ms);
+        TP_CHECK_MSG(actual.ltq == expected.ltq, actual.instrument_key << ": ltq " << actual.ltq << " != " << expected.ltq);
+        TP_CHECK_MSG(actual.close_price == expected.close_price, actual.instrument_key << ": cp " << actual.close_price << " != " << expected.close_price);
+        TP_CHECK_MSG(actual.vtt == expected.vtt, actual.instrument_key << ": vtt " << actual.vtt << " != " << expected.vtt);
+        TP_CHECK_MSG(actual.has_open_interest == expected.has_open_interest, actual.instrument_key << ": has_open_interest");
+        TP_CHECK_MSG(actual.open_interest == expected.open_interest, actual.instrument_key << ": oi " << actual.open_interest << " != " << expected.open_interest);
+    }
+
+    // --- Wire format, written out by hand for the layouts appendUpstoxFeedMessage does not produce ---
+
+    void varint(std::string& out, std::uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    void key(std::string& out, std::uint32_t field, std::uint32_t wire_type) {
+        varint(out, (static_cast<std::uint64_t>(field) << 3) | wire_type);
+    }
+
+    void int64Field(std::string& out, std::uint32_t field, std::int64_t value) {
+        key(out, field, 0);
+        varint(out, static_cast<std::uint64_t>(value));
+    }
+
+    void doubleField(std::string& out, std::uint32_t field, double value) {
+        key(out, field, 1);
+        char bytes[8];
+        std::memcpy(bytes, &value, sizeof(bytes));
+        out.append(bytes, sizeof(bytes));
+    }
+
+    void fixed32Field(std::string& out, std::uint32_t field, std::uint32_t value) {
+        key(out, field, 5);
+        char bytes[4];
+        std::memcpy(bytes, &value, sizeof(bytes));
+        out.append(bytes, sizeof(bytes));
+    }
+
+    void bytesField(std::string& out, std::uint32_t field, std::string_view bytes) {
+        key(out, field, 2);
+        varint(out, bytes.size());
+        out.append(bytes);
+    }
+
+    std::string ltpcMessage(const UpstoxFeedTick& tick) {
+        std::string ltpc;
+        doubleField(ltpc, 1, tick.ltp);
+        int64Field(ltpc, 2, tick.ltt_ms);
+        int64Field(ltpc, 3, tick.ltq);
+        doubleField(ltpc, 4, tick.close_price);
+        return ltpc;
+    }
+
+    // FeedResponse { type = 1; feeds = 2 (map entries); currentTs = 3 }
+    std::string feedResponse(UpstoxFeedType type, std::int64_t current_ts_ms,
+                             const std::vector<std::pair<std::string, std::string>>& feeds) {
+        std::string body;
+        int64Field(body, 1, static_cast<std::int64_t>(type));
+        for (const auto& [instrument_key, feed] : feeds) {
+            std::string entry;
+            bytesField(entry, 1, instrument_key);
+            bytesField(entry, 2, feed);
+            bytesField(body, 2, entry);
+        }
+        int64Field(body, 3, current_ts_ms);
+        return body;
+    }
+
+    std::vector<UpstoxFeedTick> sampleTicks() {
+        UpstoxFeedTick equity;
+        equity.instrument_key = "NSE_EQ|INE002A01018";
+        equity.ltp = 2456.35;
+        equity.ltt_ms = 1'718'942'400'123;
+        equity.ltq = 25;
+        equity.close_price = 2440.1;
+
+        UpstoxFeedTick future = equity;
+        future.instrument_key = "NSE_FO|53001";
+        future.ltp = 2471.05;
+        future.ltq = 250;
+        future.vtt = 1'234'567;
+        future.open_interest = 8'765'432.0;
+        future.has_open_interest = true;
+
+        UpstoxFeedTick full_without_oi = equity;
+        full_without_oi.instrument_key = "NSE_EQ|INE467B01029";
+        full_without_oi.ltp = 3899.0;
+        full_without_oi.vtt = 0;
+
+        UpstoxFeedTick zero = {};
+        zero.instrument_key = "NSE_EQ|ZERO";
+        return {equity, future, full_without_oi, zero};
+    }
+
+} // end anonymous namespace
+
+TP_CHECK_CASE(feedDecoderRoundTrip, "data.feed_decoder") {
+    const std::vector<UpstoxFeedTick> ticks = sampleTicks();
+    for (const UpstoxFeedType type : {UpstoxFeedType::InitialFeed, UpstoxFeedType::LiveFeed}) {
+        std::string message;
+        data::appendUpstoxFeedMessage(message, type, 1'718'942'400'500, ticks);
+
+        const Decoded decoded = decode(message);
+        TP_CHECK_MSG(decoded.result.ok, "error: " << errorOf(decoded));
+        TP_CHECK(decoded.result.type == type);
+        TP_CHECK(decoded.result.current_ts_ms == 1'718'942'400'500);
+        TP_CHECK(decoded.result.feeds == ticks.size());
+        TP_CHECK(decoded.result.ticks == ticks.size());
+        TP_CHECK(decoded.ticks.size() == ticks.size());
+        for (std::size_t i = 0; i < ticks.size() && i < decoded.ticks.size(); ++i) checkTick(decoded.ticks[i], ticks[i]);
+    }
+
+    // Zero-copy: the instrument key handed to the callback points into the message
+    std::string message;
+    data::appendUpstoxFeedMessage(message, UpstoxFeedType::LiveFeed, 1, ticks);
+    bool inside = true;
+    data::decodeUpstoxFeed(message, [&](const UpstoxFeedTick& tick) {
+        inside = inside && tick.instrument_key.data() >= message.data()
+                        && tick.instrument_key.data() + tick.instrument_key.size() <= message.data() + message.size();
+    });
+    TP_CHECK(inside);
+
+    // A message without feeds (market info only) decodes to no ticks
+    std::string empty;
+    data::appendUpstoxFeedMessage(empty, UpstoxFeedType::MarketInfo, 42, {});
+    const Decoded empty_decoded = decode(empty);
+    TP_CHECK(empty_decoded.result.ok);
+    TP_CHECK(empty_decoded.result.type == UpstoxFeedType::MarketInfo);
+    TP_CHECK(empty_decoded.result.current_ts_ms == 42);
+    TP_CHECK(empty_decoded.result.feeds == 0 && empty_decoded.ticks.empty());
+}
+
+TP_CHECK_CASE(feedDecoderModes, "data.feed_decoder.modes") {
+    const std::vector<UpstoxFeedTick> ticks = sampleTicks();
+    const UpstoxFeedTick& option = ticks[1];
+
+    // Feed.firstLevelWithGreeks = 3: { ltpc = 1; firstDepth = 2; optionGreeks = 3; vtt = 4; oi = 5; iv = 6 }
+    std::string depth, greeks, first_level;
+    doubleField(depth, 1, 2471.0);
+    int64Field(depth, 2, 100);
+    doubleField(greeks, 1, 0.55);
+    doubleField(greeks, 2, 0.0012);
+    bytesField(first_level, 1, ltpcMessage(option));
+    bytesField(first_level, 2, depth);
+    bytesField(first_level, 3, greeks);
+    int64Field(first_level, 4, option.vtt);
+    doubleField(first_level, 5, option.open_interest);
+    doubleField(first_level, 6, 0.18);
+    std::string greeks_feed;
+    bytesField(greeks_feed, 3, first_level);
+
+    // Feed.fullFeed = 2 -> FullFeed.indexFF = 2: { ltpc = 1; marketOHLC = 2 }, no volume or OI
+    const UpstoxFeedTick& index = ticks[0];
+    std::string index_full, full_feed, index_feed;
+    bytesField(index_full, 1, ltpcMessage(index));
+    bytesField(index_full, 2, depth);
+    bytesField(full_feed, 2, index_full);
+    bytesField(index_feed, 2, full_feed);
+
+    // Greeks without LTPC: counted as a feed, not reported as a tick
+    std::string greeks_only, greeks_only_feed;
+    bytesField(greeks_only, 3, greeks);
+    bytesField(greeks_only_feed, 3, greeks_only);
+
+    const std::string message = feedResponse(UpstoxFeedType::LiveFeed, 7,
+                                             {{std::string(option.instrument_key), greeks_feed},
+                                              {"NSE_FO|GREEKS", greeks_only_feed},
+                                              {std::string(index.instrument_key), index_feed}});
+    const Decoded decoded = decode(message);
+    TP_CHECK_MSG(decoded.result.ok, "error: " << errorOf(decoded));
+    TP_CHECK(decoded.result.feeds == 3);
+    TP_CHECK(decoded.result.ticks == 2);
+    TP_CHECK(decoded.ticks.size() == 2);
+    if (decoded.ticks.size() == 2) {
+        checkTick(decoded.ticks[0], option);
+        checkTick(decoded.ticks[1], index);
+    }
+
+    // A map entry with its value before its key, as protobuf allows
+    std::string reversed_entry, body;
+    std::string ltpc_feed;
+    bytesField(ltpc_feed, 1, ltpcMessage(index));
+    bytesField(reversed_entry, 2, ltpc_feed);
+    bytesField(reversed_entry, 1, index.instrument_key);
+    bytesField(body, 2, reversed_entry);
+    const Decoded reversed = decode(body);
+    TP_CHECK(reversed.result.ok);
+    TP_CHECK(reversed.ticks.size() == 1);
+    if (reversed.ticks.size() == 1) checkTick(reversed.ticks[0], index);
+}
+
+TP_CHECK_CASE(feedDecoderSkipsUnknownFields, "data.feed_decoder.unknown_fields") {
+    const std::vector<UpstoxFeedTick> ticks = sampleTicks();
+    const UpstoxFeedTick& future = ticks[1];
+
+    // One unknown field of each wire type, spliced into every level of the message
+    const auto unknown = [](std::string& out, std::uint32_t field) {
+        int64Field(out, field, 300);
+        doubleField(out, field + 1, -1.5);
+        bytesField(out, field + 2, std::string("\x08\x01\x12\x00", 4));
+        fixed32Field(out, field + 3, 0xDEADBEEF);
+    };
+
+    std::string ltpc;
+    unknown(ltpc, 10);
+    ltpc += ltpcMessage(future);
+    unknown(ltpc, 20);
+    std::string market_ff;
+    bytesField(market_ff, 1, ltpc);
+    unknown(market_ff, 2); // fields 2..5: marketLevel, optionGreeks, marketOHLC, atp
+    int64Field(market_ff, 6, future.vtt);
+    doubleField(market_ff, 7, future.open_interest);
+    unknown(market_ff, 8); // iv, tbq, tsq and a field not in the schema
+    std::string full_feed;
+    unknown(full_feed, 3);
+    bytesField(full_feed, 1, market_ff);
+    std::string feed;
+    bytesField(feed, 2, full_feed);
+    int64Field(feed, 4, 2); // requestMode
+    unknown(feed, 5);
+    std::string entry;
+    unknown(entry, 3);
+    bytesField(entry, 1, future.instrument_key);
+    bytesField(entry, 2, feed);
+
+    std::string market_info;
+    bytesField(market_info, 1, std::string("\x0A\x06NSE_EQ\x10\x02", 10));
+    std::string body;
+    unknown(body, 5);
+    int64Field(body, 1, static_cast<std::int64_t>(UpstoxFeedType::LiveFeed));
+    bytesField(body, 4, market_info);
+    bytesField(body, 2, entry);
+    int64Field(body, 3, 99);
+    unknown(body, 9);
+
+    const Decoded decoded = decode(body);
+    TP_CHECK_MSG(decoded.result.ok, "error: " << errorOf(decoded));
+    TP_CHECK(decoded.result.type == UpstoxFeedType::LiveFeed);
+    TP_CHECK(decoded.result.current_ts_ms == 99);
+    TP_CHECK(decoded.result.feeds == 1);
+    TP_CHECK(decoded.ticks.size() == 1);
+    if (decoded.ticks.size() == 1) checkTick(decoded.ticks[0], future);
+}
+
+TP_CHECK_CASE(feedDecoderMalformed, "data.feed_decoder.malformed") {
+    const std::vector<UpstoxFeedTick> ticks = sampleTicks();
+
+    // Truncated varint: currentTs is the last field, cut inside its multi-byte value
+    std::string message;
+    data::appendUpstoxFeedMessage(message, UpstoxFeedType::LiveFeed, 1'718'942'400'500, ticks);
+    const Decoded truncated = decode(std::string_view(message).substr(0, message.size() - 1));
+    TP_CHECK(!truncated.result.ok);
+    TP_CHECK_MSG(errorOf(truncated) == "truncated varint", errorOf(truncated));
+    TP_CHECK(truncated.ticks.size() == ticks.size()); // Ticks before the bad part stay delivered
+
+    // A varint whose continuation bit never clears
+    const Decoded overlong = decode(std::string(11, '\xFF'));
+    TP_CHECK(!overlong.result.ok);
+    TP_CHECK_MSG(errorOf(overlong) == "varint longer than 10 bytes", errorOf(overlong));
+
+    // Length past the end: a map entry claiming more bytes than the message holds
+    std::string past_end;
+    key(past_end, 2, 2);
+    varint(past_end, 1'000);
+    past_end += "NSE_EQ";
+    const Decoded long_entry = decode(past_end);
+    TP_CHECK(!long_entry.result.ok);
+    TP_CHECK_MSG(errorOf(long_entry) == "length past the end of the message", errorOf(long_entry));
+    TP_CHECK(long_entry.result.feeds == 0 && long_entry.ticks.empty());
+
+    // ... and one nested in an LTPC; the feed before it is still delivered
+    std::string good_feed, bad_ltpc, bad_feed;
+    bytesField(good_feed, 1, ltpcMessage(ticks[0]));
+    key(bad_ltpc, 1, 1);
+    bad_ltpc += "\x01\x02\x03"; // fixed64 with three of its eight bytes
+    bytesField(bad_feed, 1, bad_ltpc);
+    const Decoded nested = decode(feedResponse(UpstoxFeedType::LiveFeed, 1, {{"A", good_feed}, {"B", bad_feed}}));
+    TP_CHECK(!nested.result.ok);
+    TP_CHECK_MSG(errorOf(nested) == "truncated fixed64", errorOf(nested));
+    TP_CHECK(nested.result.ticks == 1 && nested.ticks.size() == 1);
+
+    // Wrong wire type of a known field, field number 0, and the deprecated group wire types
+    std::string wrong_type;
+    key(wrong_type, 3, 2);
+    varint(wrong_type, 0);
+    TP_CHECK_MSG(errorOf(decode(wrong_type)) == "int64 field with wrong wire type", errorOf(decode(wrong_type)));
+    TP_CHECK_MSG(errorOf(decode(std::string("\x00\x01", 2))) == "field number 0", errorOf(decode(std::string("\x00\x01", 2))));
+    std::string group;
+    key(group, 9, 3);
+    TP_CHECK_MSG(errorOf(decode(group)) == "unsupported wire type", errorOf(decode(group)));
+
+    // Every truncation of a valid message either decodes cleanly (on a field boundary)
+    // or reports an error, and never hands out more ticks than the full message has
+    for (std::size_t length = 0; length < message.size(); ++length) {
+        const Decoded prefix = decode(std::string_view(message).substr(0, length));
+        TP_CHECK_MSG(prefix.result.ok == (prefix.result.error == nullptr), "length " << length);
+        TP_CHECK_MSG(prefix.ticks.size() <= ticks.size(), "length " << length);
+        for (std::size_t i = 0; i < prefix.ticks.size(); ++i) checkTick(prefix.ticks[i], ticks[i]);
+    }
+}
@@ -0,0 +1,85 @@
+// Streaming (IStreamingIndicator::update) against batch (calculate/getResult)
+// SMA and RSI: the live engine and the screener rely on both producing the same
+// values bar for bar.
+
+#include "check.hpp"
+#include "check_data.hpp"
+#include "sma_indicator.hpp"
+#include "rsi_indicator.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace {
+
+    // Feeds 'bars' through update() and compares every bar with the batch result,
+    // aligned to the end of the series as getResult() is
+    template <typename Indicator>
+    void compareStreamingWithBatch(int period, const core::CandleSeries& bars) {
+        Indicator batch(period);
+        batch.calculate(bars);
+        const auto& expected = batch.getResult();
+        const std::size_t lookback = static_cast<std::size_t>(batch.getLookback());
+        TP_CHECK_MSG(expected.size() == bars.size() - lookback,
+                     batch.getName() << ": " << expected.size() << " results for " << bars.size() << " bars");
+        if (expected.size() != bars.size() - lookback) return;
+
+        Indicator streaming(period);
+        TP_CHECK_MSG(std::isnan(streaming.currentValue()) && !streaming.isReady(), streaming.getName() << " before any bar");
+        for (int pass = 0; pass < 2; ++pass) { // Second pass checks reset()
+            for (std::size_t i = 0; i < bars.size(); ++i) {
+                const double value = streaming.update(bars.at(i));
+                if (i < lookback) {
+                    TP_CHECK_MSG(std::isnan(value) && !streaming.isReady(), streaming.getName() << " bar " << i << " = " << value);
+                    continue;
+                }
+                const double want = expected[i - lookback];
+                TP_CHECK_MSG(value == want && streaming.currentValue() == value && streaming.isReady(),
+                             streaming.getName() << " pass " << pass << " bar " << i << ": " << value << " != " << want);
+            }
+            streaming.reset();
+            TP_CHECK_MSG(std::isnan(streaming.currentValue()) && !streaming.isReady(), streaming.getName() << " after reset()");
+        }
+
+        // warmUp() over a prefix, then live updates
+        const std::size_t split = bars.size() / 3;
+        streaming.warmUp(bars.slice(0, split));
+        for (std::size_t i = split; i < bars.size(); ++i) streaming.update(bars.at(i));
+        TP_CHECK_MSG(streaming.currentValue() == expected.back(),
+                     streaming.getName() << " after warmUp: " << streaming.currentValue() << " != " << expected.back());
+    }
+
+    // Fewer bars than the lookback: never ready, always NaN
+    template <typename Indicator>
+    void checkShortHistory(int period) {
+        Indicator streaming(period);
+        const auto bars = checks::randomWalkSeries(static_cast<std::size_t>(streaming.getLookback()), 3);
+        for (std::size_t i = 0; i < bars.size(); ++i) {
+            TP_CHECK_MSG(std::isnan(streaming.update(bars.at(i))), streaming.getName() << " bar " << i);
+        }
+        TP_CHECK_MSG(!streaming.isReady(), streaming.getName() << " ready after " << bars.size() << " bars");
+    }
+
+} // end anonymous namespace
+
+TP_CHECK_CASE(smaStreamingMatchesBatch, "indicators.streaming.sma") {
+    const auto bars = checks::randomWalkSeries(5000, 11);
+    for (int period : {1, 2, 5, 20, 200}) {
+        compareStreamingWithBatch<indicators::SmaIndicator>(period, bars);
+        checkShortHistory<indicators::SmaIndicator>(period);
+    }
+}
+
+TP_CHECK_CASE(rsiStreamingMatchesBatch, "indicators.streaming.rsi") {
+    // A quarter of the bars are unchanged, so zero gains / losses and flat runs occur
+    const auto bars = checks::randomWalkSeries(5000, 12, 0.25);
+    for (int period : {2, 5, 14, 50}) {
+        compareStreamingWithBatch<indicators::RsiIndicator>(period, bars);
+        checkShortHistory<indicators::RsiIndicator>(period);
+    }
+    // Fully flat stretch: RSI of no movement at all
+    const auto flat = checks::randomWalkSeries(500, 13, 1.0);
+    compareStreamingWithBatch<indicators::RsiIndicator>(14, flat);
+}
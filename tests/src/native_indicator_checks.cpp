@@ -0,0 +1,478 @@
+// The native indicators (EMA, WMA, MACD, ATR, ADX, STOCH, BBANDS, SUPERTREND, VWAP)
+// against straightforward reference implementations that follow TA-Lib's definitions
+// (SMA seeds, Wilder smoothing, TA_ADX's partial first sum) computed over whole
+// arrays, bar by bar, and against hand-computed values for the seeding and warm-up
+// of EMA, WMA, MACD, ATR and ADX. The references index by input bar and hold NaN
+// over the warm-up, so the lookbacks are checked as well as the values.
+
+#include "check.hpp"
+#include "check_data.hpp"
+#include "native_indicators.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace {
+
+    using Column = std::vector<double>;
+    constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+    bool near(double a, double b, double tolerance = 1e-9) {
+        return std::fabs(a - b) <= tolerance * std::max(1.0, std::fabs(b));
+    }
+
+    Column column(std::span<const double> values) { return Column(values.begin(), values.end()); }
+
+    // TA-Lib's TA_IS_ZERO
+    bool isZero(double value) { return -0.00000001 < value && value < 0.00000001; }
+
+    // --- References ---
+
+    Column referenceSma(const Column& in, int period, std::size_t first = 0) {
+        Column out(in.size(), kNaN);
+        for (std::size_t i = first + period - 1; i < in.size(); ++i) {
+            double total = 0.0;
+            for (std::size_t j = i + 1 - period; j <= i; ++j) total += in[j];
+            out[i] = total / period;
+        }
+        return out;
+    }
+
+    // EMA seeded with the SMA of the 'period' values ending at 'seed_end', as TA_INT_EMA
+    // seeds from its start index
+    Column referenceEma(const Column& in, int period, std::size_t seed_end) {
+        Column out(in.size(), kNaN);
+        if (seed_end >= in.size()) return out;
+        double total = 0.0;
+        for (std::size_t j = seed_end + 1 - period; j <= seed_end; ++j) total += in[j];
+        out[seed_end] = total / period;
+        const double k = 2.0 / (period + 1);
+        for (std::size_t i = seed_end + 1; i < in.size(); ++i) out[i] = out[i - 1] + k * (in[i] - out[i - 1]);
+        return out;
+    }
+
+    Column referenceWma(const Column& in, int period) {
+        Column out(in.size(), kNaN);
+        const double divider = period * (period + 1) / 2.0;
+        for (std::size_t i = period - 1; i < in.size(); ++i) {
+            double weighted = 0.0;
+            for (int w = 1; w <= period; ++w) weighted += w * in[i + 1 - period + (w - 1)];
+            out[i] = weighted / divider;
+        }
+        return out;
+    }
+
+    Column referenceTrueRange(const core::CandleSeries& bars) {
+        Column out(bars.size(), kNaN);
+        for (std::size_t i = 1; i < bars.size(); ++i) {
+            const double high = bars.high()[i], low = bars.low()[i], prev_close = bars.close()[i - 1];
+            out[i] = std::max({high - low, std::fabs(high - prev_close), std::fabs(low - prev_close)});
+        }
+        return out;
+    }
+
+    // Wilder's ATR: mean of the first 'period' true ranges (bar 0 has none), then (prev * (n - 1) + tr) / n
+    Column referenceAtr(const core::CandleSeries& bars, int period) {
+        const Column ranges = referenceTrueRange(bars);
+        Column out(bars.size(), kNaN);
+        if (bars.size() <= static_cast<std::size_t>(period)) return out;
+        double total = 0.0;
+        for (int i = 1; i <= period; ++i) total += ranges[i];
+        out[period] = total / period;
+        for (std::size_t i = period + 1; i < bars.size(); ++i) out[i] = (out[i - 1] * (period - 1) + ranges[i]) / period;
+        return out;
+    }
+
+    struct AdxReference {
+        Column adx, plus_di, minus_di;
+    };
+
+    // TA_ADX: +DM / -DM / TR summed over bars 1..period-1, then Wilder-smoothed
+    // (s - s / n + x) from bar 'period'; DX from bar 'period' on; ADX starts as the mean
+    // of the first 'period' DX values and is Wilder-smoothed after that
+    AdxReference referenceAdx(const core::CandleSeries& bars, int period) {
+        const std::size_t n = bars.size();
+        const auto high = bars.high();
+        const auto low = bars.low();
+        const Column ranges = referenceTrueRange(bars);
+        Column plus_dm(n, 0.0), minus_dm(n, 0.0);
+        for (std::size_t i = 1; i < n; ++i) {
+            const double up = high[i] - high[i - 1];
+            const double down = low[i - 1] - low[i];
+            if (down > 0 && up < down) minus_dm[i] = down;
+            else if (up > 0 && up > down) plus_dm[i] = up;
+        }
+
+        AdxReference out{Column(n, kNaN), Column(n, kNaN), Column(n, kNaN)};
+        Column dx(n, kNaN);
+        double smooth_plus = 0.0, smooth_minus = 0.0, smooth_range = 0.0;
+        for (std::size_t i = 1; i < n; ++i) {
+            if (i < static_cast<std::size_t>(period)) {
+                smooth_plus += plus_dm[i];
+                smooth_minus += minus_dm[i];
+                smooth_range += ranges[i];
+                continue;
+            }
+            smooth_plus = smooth_plus - smooth_plus / period + plus_dm[i];
+            smooth_minus = smooth_minus - smooth_minus / period + minus_dm[i];
+            smooth_range = smooth_range - smooth_range / period + ranges[i];
+            if (isZero(smooth_range)) {
+                out.plus_di[i] = out.minus_di[i] = 0.0;
+                continue;
+            }
+            out.plus_di[i] = 100.0 * smooth_plus / smooth_range;
+            out.minus_di[i] = 100.0 * smooth_minus / smooth_range;
+            const double total = out.plus_di[i] + out.minus_di[i];
+            if (!isZero(total)) dx[i] = 100.0 * std::fabs(out.plus_di[i] - out.minus_di[i]) / total;
+        }
+
+        const std::size_t first = 2 * static_cast<std::size_t>(period) - 1;
+        if (n <= first) return out;
+        double dx_total = 0.0;
+        for (std::size_t i = period; i <= first; ++i) {
+            if (!std::isnan(dx[i])) dx_total += dx[i]; // An undefined DX counts as zero in the seed
+        }
+        out.adx[first] = dx_total / period;
+        for (std::size_t i = first + 1; i < n; ++i) {
+            out.adx[i] = std::isnan(dx[i]) ? out.adx[i - 1] : (out.adx[i - 1] * (period - 1) + dx[i]) / period;
+        }
+        for (std::size_t i = 0; i < first; ++i) out.plus_di[i] = out.minus_di[i] = kNaN;
+        return out;
+    }
+
+    // Slow %K = SMA(fast %K), %D = SMA(slow %K); fast %K is 0 over a flat window (TA_STOCH)
+    std::array<Column, 2> referenceStochastic(const core::CandleSeries& bars, int k_period, int k_smoothing, int d_period) {
+        const std::size_t n = bars.size();
+        Column fast_k(n, kNaN);
+        for (std::size_t i = k_period - 1; i < n; ++i) {
+            const auto high = bars.high().subspan(i + 1 - k_period, k_period);
+            const auto low = bars.low().subspan(i + 1 - k_period, k_period);
+            const double highest = *std::max_element(high.begin(), high.end());
+            const double lowest = *std::min_element(low.begin(), low.end());
+            fast_k[i] = highest != lowest ? 100.0 * (bars.close()[i] - lowest) / (highest - lowest) : 0.0;
+        }
+        const Column slow_k = referenceSma(fast_k, k_smoothing, k_period - 1);
+        const Column d = referenceSma(slow_k, d_period, k_period - 1 + k_smoothing - 1);
+        Column k(n, kNaN);
+        for (std::size_t i = 0; i < n; ++i) {
+            if (!std::isnan(d[i])) k[i] = slow_k[i];
+        }
+        return {k, d};
+    }
+
+    // Bands of mean +- deviations * population standard deviation, two-pass per window
+    std::array<Column, 3> referenceBollinger(const Column& close, int period, double deviations) {
+        const Column middle = referenceSma(close, period);
+        Column upper(close.size(), kNaN), lower(close.size(), kNaN);
+        for (std::size_t i = period - 1; i < close.size(); ++i) {
+            double squares = 0.0;
+            for (std::size_t j = i + 1 - period; j <= i; ++j) squares += (close[j] - middle[i]) * (close[j] - middle[i]);
+            const double variance = squares / period;
+            const double deviation = variance < 0.00000001 ? 0.0 : std::sqrt(variance); // TA_IS_ZERO_OR_NEG
+            upper[i] = middle[i] + deviations * deviation;
+            lower[i] = middle[i] - deviations * deviation;
+        }
+        return {middle, upper, lower};
+    }
+
+    // The usual formulation: final bands that only tighten while the previous close is
+    // inside them; the line stays on the upper band until a close above it, and on the
+    // lower band until a close below it. The first bar is up if it closes at or above hl2.
+    std::array<Column, 3> referenceSupertrend(const core::CandleSeries& bars, int period, double multiplier) {
+        const std::size_t n = bars.size();
+        const Column atr = referenceAtr(bars, period);
+        Column line(n, kNaN), direction(n, kNaN);
+        double final_upper = 0.0, final_lower = 0.0;
+        bool on_upper = false;
+        for (std::size_t i = period; i < n; ++i) {
+            const double hl2 = (bars.high()[i] + bars.low()[i]) / 2.0;
+            const double basic_upper = hl2 + multiplier * atr[i];
+            const double basic_lower = hl2 - multiplier * atr[i];
+            const double close = bars.close()[i];
+            if (i == static_cast<std::size_t>(period)) {
+                final_upper = basic_upper;
+                final_lower = basic_lower;
+                on_upper = close < hl2;
+            } else {
+                const double prev_close = bars.close()[i - 1];
+                if (basic_upper < final_upper || prev_close > final_upper) final_upper = basic_upper;
+                if (basic_lower > final_lower || prev_close < final_lower) final_lower = basic_lower;
+                on_upper = on_upper ? close <= final_upper : close < final_lower;
+            }
+            line[i] = on_upper ? final_upper : final_lower;
+            direction[i] = on_upper ? -1.0 : 1.0;
+        }
+        return {line, direction, atr};
+    }
+
+    // Cumulative typical price * volume / volume per UTC day; the typical price until a session has volume
+    Column referenceVwap(const core::CandleSeries& bars) {
+        constexpr std::int64_t kNanosPerDay = 86'400'000'000'000LL;
+        Column out(bars.size(), kNaN);
+        double price_volume = 0.0, volume = 0.0;
+        for (std::size_t i = 0; i < bars.size(); ++i) {
+            if (i == 0 || bars.timestampsNs()[i] / kNanosPerDay != bars.timestampsNs()[i - 1] / kNanosPerDay) {
+                price_volume = volume = 0.0;
+            }
+            const double typical = (bars.high()[i] + bars.low()[i] + bars.close()[i]) / 3.0;
+            price_volume += typical * bars.volume()[i];
+            volume += bars.volume()[i];
+            out[i] = volume > 0.0 ? price_volume / volume : typical;
+        }
+        return out;
+    }
+
+    // --- Comparison ---
+
+    // Output k of 'indicator' against reference[k + lookback]; the reference must be NaN
+    // exactly over the first 'lookback' bars, so both agree on the warm-up
+    void compareOutput(const indicators::IIndicator& indicator, std::size_t output, const Column& reference,
+                       double tolerance = 1e-9) {
+        const std::string name = indicator.getName() + (indicator.getOutputName(output).empty() ? "" : "." + indicator.getOutputName(output));
+        const auto& actual = indicator.getOutput(output);
+        const std::size_t lookback = static_cast<std::size_t>(indicator.getLookback());
+        TP_CHECK_MSG(actual.size() + lookback == reference.size(),
+                     name << ": " << actual.size() << " values for " << reference.size() << " bars, lookback " << lookback);
+        std::size_t reference_lookback = 0;
+        while (reference_lookback < reference.size() && std::isnan(reference[reference_lookback])) ++reference_lookback;
+        TP_CHECK_MSG(reference_lookback == lookback, name << ": lookback " << lookback << ", reference warm-up " << reference_lookback);
+        std::size_t mismatches = 0;
+        for (std::size_t k = 0; k < actual.size() && k + lookback < reference.size(); ++k) {
+            const double want = reference[k + lookback];
+            if (near(actual[k], want, tolerance)) continue;
+            if (++mismatches <= 3) TP_CHECK_MSG(false, name << " bar " << (k + lookback) << ": " << actual[k] << " != " << want);
+        }
+        TP_CHECK_MSG(mismatches == 0, name << ": " << mismatches << " mismatching bars");
+    }
+
+    void checkValues(const indicators::IIndicator& indicator, std::size_t output, const std::vector<double>& expected) {
+        const auto& actual = indicator.getOutput(output);
+        TP_CHECK_MSG(actual.size() == expected.size(), indicator.getName() << ": " << actual.size() << " values, expected " << expected.size());
+        for (std::size_t k = 0; k < actual.size() && k < expected.size(); ++k) {
+            TP_CHECK_MSG(near(actual[k], expected[k], 1e-12),
+                         indicator.getName() << " output " << output << " [" << k << "]: " << actual[k] << " != " << expected[k]);
+        }
+    }
+
+    // With exactly 'lookback' bars nothing is produced; one more bar gives one value per output
+    void checkWarmUp(indicators::IIndicator& indicator, int expected_lookback, const core::CandleSeries& bars) {
+        TP_CHECK_MSG(indicator.getLookback() == expected_lookback,
+                     indicator.getName() << ": lookback " << indicator.getLookback() << " != " << expected_lookback);
+        const std::size_t lookback = static_cast<std::size_t>(indicator.getLookback());
+        indicator.calculate(bars.slice(0, lookback));
+        for (std::size_t output = 0; output < indicator.getOutputCount(); ++output) {
+            TP_CHECK_MSG(indicator.getOutput(output).empty(), indicator.getName() << " output " << output << " with " << lookback << " bars");
+        }
+        indicator.calculate(bars.slice(0, lookback + 1));
+        for (std::size_t output = 0; output < indicator.getOutputCount(); ++output) {
+            TP_CHECK_MSG(indicator.getOutput(output).size() == 1, indicator.getName() << " output " << output << " with " << lookback + 1 << " bars");
+        }
+    }
+
+    // Bars with the given high, low and close (open = previous close), one minute apart
+    core::CandleSeries seriesFromBars(const std::vector<std::array<double, 3>>& bars) {
+        const core::Timestamp start = core::utils::stringToTimestamp(checks::kCheckStartDate + "T09:15:00+05:30");
+        core::CandleSeries::Builder builder;
+        for (std::size_t i = 0; i < bars.size(); ++i) {
+            core::Candle candle;
+            candle.timestamp = start + std::chrono::minutes(i);
+            candle.high = bars[i][0];
+            candle.low = bars[i][1];
+            candle.close = bars[i][2];
+            candle.open = i > 0 ? bars[i - 1][2] : bars[i][2];
+            candle.volume = 1000;
+            builder.push_back(candle);
+        }
+        return builder.build();
+    }
+
+    // A random walk with a flat stretch in the middle (zero ranges: STOCH's and ADX's edge cases)
+    core::CandleSeries mixedSeries() {
+        const auto walk = checks::randomWalkSeries(3000, 21, 0.2);
+        core::CandleSeries::Builder builder;
+        for (std::size_t i = 0; i < walk.size(); ++i) {
+            core::Candle candle = walk.at(i);
+            if (i >= 1200 && i < 1260) candle.open = candle.high = candle.low = candle.close = walk.at(1199).close;
+            builder.push_back(candle);
+        }
+        return builder.build();
+    }
+
+} // end anonymous namespace
+
+TP_CHECK_CASE(nativeEmaMatchesReference, "indicators.native.ema") {
+    // Seed = SMA of the first 'period' closes, then k = 2 / (n + 1)
+    const auto fixture = checks::seriesFromCloses({10, 11, 12, 9, 8, 14});
+    indicators::EmaIndicator ema3(3);
+    ema3.calculate(fixture);
+    checkValues(ema3, 0, {11.0, 10.0, 9.0, 11.5});
+    checkWarmUp(ema3, 2, fixture);
+
+    const auto bars = mixedSeries();
+    const Column close = column(bars.close());
+    for (int period : {1, 2, 5, 14, 50, 200}) {
+        indicators::EmaIndicator ema(period);
+        ema.calculate(bars);
+        compareOutput(ema, 0, referenceEma(close, period, period - 1));
+        checkWarmUp(ema, period - 1, bars);
+    }
+}
+
+TP_CHECK_CASE(nativeWmaMatchesReference, "indicators.native.wma") {
+    indicators::WmaIndicator wma3(3);
+    wma3.calculate(checks::seriesFromCloses({1, 2, 3, 4, 5}));
+    checkValues(wma3, 0, {14.0 / 6.0, 20.0 / 6.0, 26.0 / 6.0});
+
+    const auto bars = mixedSeries();
+    const Column close = column(bars.close());
+    for (int period : {1, 2, 9, 30, 100}) {
+        indicators::WmaIndicator wma(period);
+        wma.calculate(bars);
+        compareOutput(wma, 0, referenceWma(close, period));
+        checkWarmUp(wma, period - 1, bars);
+    }
+}
+
+TP_CHECK_CASE(nativeMacdMatchesReference, "indicators.native.macd") {
+    // MACD(2,3,2): both EMAs are seeded at bar 2 (the fast one from closes 1..2, not
+    // from bar 0), the signal EMA from the MACD values of bars 2..3
+    const auto fixture = checks::seriesFromCloses({1, 2, 4, 8, 16});
+    indicators::MacdIndicator small(2, 3, 2);
+    small.calculate(fixture);
+    checkValues(small, 0, {7.0 / 6.0, 79.0 / 36.0});
+    checkValues(small, 1, {11.0 / 12.0, 191.0 / 108.0});
+    checkValues(small, 2, {1.0 / 4.0, 23.0 / 54.0});
+    checkWarmUp(small, 3, fixture);
+
+    const auto bars = mixedSeries();
+    const Column close = column(bars.close());
+    const std::vector<std::array<int, 3>> configurations = {{12, 26, 9}, {5, 35, 5}, {1, 2, 1}, {3, 10, 16}};
+    for (const auto& [fast, slow, signal] : configurations) {
+        indicators::MacdIndicator macd(fast, slow, signal);
+        macd.calculate(bars);
+        const std::size_t line_start = static_cast<std::size_t>(slow - 1);
+        const Column fast_ema = referenceEma(close, fast, line_start);
+        const Column slow_ema = referenceEma(close, slow, line_start);
+        Column line(close.size(), kNaN);
+        for (std::size_t i = line_start; i < close.size(); ++i) line[i] = fast_ema[i] - slow_ema[i];
+        const Column signal_ema = referenceEma(line, signal, line_start + signal - 1);
+        Column macd_line(close.size(), kNaN), hist(close.size(), kNaN);
+        for (std::size_t i = 0; i < close.size(); ++i) {
+            if (std::isnan(signal_ema[i])) continue;
+            macd_line[i] = line[i];
+            hist[i] = line[i] - signal_ema[i];
+        }
+        compareOutput(macd, 0, macd_line);
+        compareOutput(macd, 1, signal_ema);
+        compareOutput(macd, 2, hist);
+        checkWarmUp(macd, slow - 1 + signal - 1, bars);
+    }
+}
+
+TP_CHECK_CASE(nativeAtrMatchesReference, "indicators.native.atr") {
+    // True ranges 2, 2, 4, 2, 4 from bar 1; bar 0's high - low is not part of the seed
+    const auto fixture = seriesFromBars({{10, 8, 9}, {11, 9, 10}, {12, 10, 11}, {15, 11, 14}, {14, 12, 13}, {13, 9, 10}});
+    indicators::AtrIndicator atr3(3);
+    atr3.calculate(fixture);
+    checkValues(atr3, 0, {8.0 / 3.0, 22.0 / 9.0, 80.0 / 27.0});
+    checkWarmUp(atr3, 3, fixture);
+
+    const auto bars = mixedSeries();
+    for (int period : {1, 2, 14, 50}) {
+        indicators::AtrIndicator atr(period);
+        atr.calculate(bars);
+        compareOutput(atr, 0, referenceAtr(bars, period));
+        checkWarmUp(atr, period, bars);
+    }
+}
+
+TP_CHECK_CASE(nativeAdxMatchesReference, "indicators.native.adx") {
+    // ADX(2): sums over bar 1 only, DX at bars 2 and 3 (100/3, 300/7), ADX from bar 3
+    const auto fixture = seriesFromBars({{10, 8, 9}, {12, 9, 11}, {11, 7, 8}, {13, 8, 12}, {12, 10, 11}});
+    indicators::AdxIndicator adx2(2);
+    adx2.calculate(fixture);
+    checkValues(adx2, 0, {800.0 / 21.0, 850.0 / 21.0});
+    checkValues(adx2, 1, {1000.0 / 31.0, 1000.0 / 47.0});
+    checkValues(adx2, 2, {400.0 / 31.0, 400.0 / 47.0});
+    checkWarmUp(adx2, 3, fixture);
+
+    const auto bars = mixedSeries();
+    for (int period : {1, 2, 5, 14, 30}) {
+        indicators::AdxIndicator adx(period);
+        adx.calculate(bars);
+        const AdxReference reference = referenceAdx(bars, period);
+        compareOutput(adx, 0, reference.adx, 1e-8);
+        compareOutput(adx, 1, reference.plus_di, 1e-8);
+        compareOutput(adx, 2, reference.minus_di, 1e-8);
+        checkWarmUp(adx, 2 * period - 1, bars);
+    }
+}
+
+TP_CHECK_CASE(nativeStochasticMatchesReference, "indicators.native.stoch") {
+    const auto bars = mixedSeries();
+    const std::vector<std::array<int, 3>> configurations = {{5, 3, 3}, {14, 3, 3}, {1, 1, 1}, {14, 1, 5}};
+    for (const auto& [k_period, k_smoothing, d_period] : configurations) {
+        indicators::StochasticIndicator stoch(k_period, k_smoothing, d_period);
+        stoch.calculate(bars);
+        const auto reference = referenceStochastic(bars, k_period, k_smoothing, d_period);
+        compareOutput(stoch, 0, reference[0]);
+        compareOutput(stoch, 1, reference[1]);
+        checkWarmUp(stoch, k_period + k_smoothing + d_period - 3, bars);
+    }
+}
+
+TP_CHECK_CASE(nativeBollingerMatchesReference, "indicators.native.bbands") {
+    const auto bars = mixedSeries();
+    const Column close = column(bars.close());
+    for (int period : {2, 20, 50}) {
+        for (double deviations : {0.0, 2.0, 2.5}) {
+            indicators::BollingerBandsIndicator bands(period, deviations);
+            bands.calculate(bars);
+            const auto reference = referenceBollinger(close, period, deviations);
+            // The kernel's one-pass E[x^2] - mean^2 loses a few digits against the two-pass reference
+            for (std::size_t output = 0; output < 3; ++output) compareOutput(bands, output, reference[output], 1e-7);
+            checkWarmUp(bands, period - 1, bars);
+        }
+    }
+}
+
+TP_CHECK_CASE(nativeSupertrendMatchesReference, "indicators.native.supertrend") {
+    const auto bars = mixedSeries();
+    for (int period : {1, 7, 10, 20}) {
+        for (double multiplier : {1.0, 3.0}) {
+            indicators::SupertrendIndicator supertrend(period, multiplier);
+            supertrend.calculate(bars);
+            const auto reference = referenceSupertrend(bars, period, multiplier);
+            for (std::size_t output = 0; output < 3; ++output) compareOutput(supertrend, output, reference[output]);
+            checkWarmUp(supertrend, period, bars);
+        }
+    }
+}
+
+TP_CHECK_CASE(nativeVwapMatchesReference, "indicators.native.vwap") {
+    // Bars 7 minutes apart span several UTC days; some bars, including session opens, carry no volume
+    const auto walk = checks::randomWalkSeries(2000, 22);
+    const core::Timestamp start = core::utils::stringToTimestamp(checks::kCheckStartDate + "T09:15:00+05:30");
+    core::CandleSeries::Builder builder;
+    for (std::size_t i = 0; i < walk.size(); ++i) {
+        core::Candle candle = walk.at(i);
+        candle.timestamp = start + std::chrono::minutes(7 * i);
+        candle.volume = (i < 3 || i % 11 == 0 || (i >= 200 && i < 210)) ? 0 : 100 + static_cast<long long>(i % 37);
+        builder.push_back(candle);
+    }
+    const auto bars = builder.build();
+
+    indicators::VwapIndicator vwap;
+    vwap.calculate(bars);
+    compareOutput(vwap, 0, referenceVwap(bars));
+    checkWarmUp(vwap, 0, bars);
+}
@@ -0,0 +1,180 @@
+// Rule::evaluate (the compiled ConditionProgram) against Rule::evaluateReference
+// (the ICondition tree) on random condition trees and random snapshots, including
+// NaN values, slots beyond the snapshot's span, missing candles and crosses.
+
+#include "check.hpp"
+#include "rule.hpp"
+#include "and_condition.hpp"
+#include "or_condition.hpp"
+#include "price_condition.hpp"
+#include "indicator_condition.hpp"
+#include "price_indicator_condition.hpp"
+#include "indicator_cross_condition.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+    using namespace strategy_engine;
+
+    constexpr std::size_t kSlotCount = 4;
+
+    // Few distinct values, so equalities and crosses happen often
+    double randomValue(std::mt19937& rng) {
+        static const double values[] = {std::numeric_limits<double>::quiet_NaN(), 1.0, 2.0, 2.5, 3.0};
+        return values[std::uniform_int_distribution<int>(0, 4)(rng)];
+    }
+
+    PriceField randomField(std::mt19937& rng) {
+        return static_cast<PriceField>(std::uniform_int_distribution<int>(0, 3)(rng));
+    }
+
+    ComparisonOp randomOp(std::mt19937& rng) {
+        return static_cast<ComparisonOp>(std::uniform_int_distribution<int>(0, 4)(rng));
+    }
+
+    // One slot past the snapshot's span now and then, to hit the missing-slot path
+    IndicatorSlot randomSlot(std::mt19937& rng) {
+        return static_cast<IndicatorSlot>(std::uniform_int_distribution<std::size_t>(0, kSlotCount)(rng));
+    }
+
+    // A slot other than 'slot' (conditions reject comparing an indicator with itself)
+    IndicatorSlot otherSlot(std::mt19937& rng, IndicatorSlot slot) {
+        return static_cast<IndicatorSlot>((slot + 1 + randomSlot(rng) % kSlotCount) % (kSlotCount + 1));
+    }
+
+    std::string slotName(IndicatorSlot slot) { return "IND" + std::to_string(slot); }
+
+    ConditionPtr randomCondition(std::mt19937& rng, int depth) {
+        const int kind = std::uniform_int_distribution<int>(0, depth > 0 ? 8 : 5)(rng);
+        switch (kind) {
+            case 0:
+                return core::makeArenaPtr<PriceCondition>(nullptr, randomField(rng), randomOp(rng), randomValue(rng));
+            case 1:
+                return core::makeArenaPtr<PriceCondition>(nullptr, randomField(rng), randomOp(rng), randomField(rng));
+            case 2: {
+                const IndicatorSlot slot = randomSlot(rng);
+                return core::makeArenaPtr<IndicatorCondition>(nullptr, slotName(slot), slot, randomOp(rng), randomValue(rng));
+            }
+            case 3: {
+                const IndicatorSlot a = randomSlot(rng), b = otherSlot(rng, a);
+                return core::makeArenaPtr<IndicatorCondition>(nullptr, slotName(a), a, randomOp(rng), slotName(b), b);
+            }
+            case 4: {
+                const IndicatorSlot slot = randomSlot(rng);
+                return core::makeArenaPtr<PriceIndicatorCondition>(nullptr, randomField(rng), randomOp(rng), slotName(slot), slot);
+            }
+            case 5: {
+                const IndicatorSlot a = randomSlot(rng), b = otherSlot(rng, a);
+                const CrossType type = std::uniform_int_distribution<int>(0, 1)(rng) ? CrossType::CrossesAbove : CrossType::CrossesBelow;
+                return core::makeArenaPtr<IndicatorCrossCondition>(nullptr, slotName(a), a, type, slotName(b), b);
+            }
+            default: { // AND / OR of 1..3 children, now and then a null child
+                std::pmr::vector<ConditionPtr> children;
+                const int count = std::uniform_int_distribution<int>(1, 3)(rng);
+                for (int i = 0; i < count; ++i) {
+                    if (std::uniform_int_distribution<int>(0, 9)(rng) == 0) {
+                        children.push_back(nullptr);
+                    } else {
+                        children.push_back(randomCondition(rng, depth - 1));
+                    }
+                }
+                if (kind == 6) return core::makeArenaPtr<AndCondition>(nullptr, std::move(children));
+                return core::makeArenaPtr<OrCondition>(nullptr, std::move(children));
+            }
+        }
+    }
+
+    core::Candle randomCandle(std::mt19937& rng) {
+        core::Candle candle;
+        candle.open = randomValue(rng);
+        candle.high = randomValue(rng);
+        candle.low = randomValue(rng);
+        candle.close = randomValue(rng);
+        return candle;
+    }
+
+} // end anonymous namespace
+
+TP_CHECK_CASE(ruleProgramMatchesReference, "strategy.rule_program") {
+    std::mt19937 rng(20240508);
+    std::size_t evaluations = 0;
+    std::size_t triggered = 0;
+    for (int tree = 0; tree < 2000; ++tree) {
+        Rule rule("check", randomCondition(rng, 3), core::SignalAction::EnterLong);
+        const std::string description = rule.describe();
+        for (int sample = 0; sample < 50; ++sample) {
+            const core::Candle current = randomCandle(rng);
+            const core::Candle previous = randomCandle(rng);
+            std::vector<double> now(kSlotCount), prev(kSlotCount);
+            for (double& v : now) v = randomValue(rng);
+            for (double& v : prev) v = randomValue(rng);
+
+            MarketDataSnapshot snapshot;
+            // Usually all slots, sometimes a short span so trailing slots are missing
+            const std::size_t now_size = std::uniform_int_distribution<int>(0, 3)(rng) ? kSlotCount
+                                             : std::uniform_int_distribution<std::size_t>(0, kSlotCount)(rng);
+            const std::size_t prev_size = std::uniform_int_distribution<int>(0, 3)(rng) ? kSlotCount
+                                              : std::uniform_int_distribution<std::size_t>(0, kSlotCount)(rng);
+            snapshot.indicator_values = std::span<const double>(now.data(), now_size);
+            snapshot.indicator_values_prev = std::span<const double>(prev.data(), prev_size);
+            snapshot.current_candle = std::uniform_int_distribution<int>(0, 19)(rng) ? &current : nullptr;
+            snapshot.previous_candle = std::uniform_int_distribution<int>(0, 9)(rng) ? &previous : nullptr;
+
+            const core::SignalAction compiled = rule.evaluate(snapshot);
+            const core::SignalAction reference = rule.evaluateReference(snapshot);
+            TP_CHECK_MSG(compiled == reference, description << " tree " << tree << " sample " << sample);
+            ++evaluations;
+            triggered += reference != core::SignalAction::None;
+        }
+    }
+    // Random trees must exercise both outcomes, or the comparison proves little
+    TP_CHECK_MSG(triggered > evaluations / 20 && triggered < evaluations - evaluations / 20,
+                 triggered << " of " << evaluations << " evaluations triggered");
+}
+
+TP_CHECK_CASE(ruleProgramCrossEdges, "strategy.rule_program.cross") {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    Rule above("above", core::makeArenaPtr<IndicatorCrossCondition>(nullptr, "A", 0, CrossType::CrossesAbove, "B", 1),
+               core::SignalAction::EnterLong);
+    Rule below("below", core::makeArenaPtr<IndicatorCrossCondition>(nullptr, "A", 0, CrossType::CrossesBelow, "B", 1),
+               core::SignalAction::ExitLong);
+    struct Case { double a_prev, b_prev, a_now, b_now; bool crosses_above, crosses_below; };
+    const Case cases[] = {
+        {1, 2, 3, 2, true, false},     // Crosses above
+        {2, 2, 3, 2, true, false},     // From equal: counts as a cross
+        {1, 2, 2, 2, false, false},    // Touches only: no cross
+        {3, 2, 1, 2, false, true},     // Crosses below
+        {2, 2, 1, 2, false, true},
+        {nan, 2, 3, 2, false, false},  // Any NaN: no cross
+        {1, nan, 3, 2, false, false},
+        {1, 2, nan, 2, false, false},
+        {1, 2, 3, nan, false, false},
+    };
+    for (const auto& c : cases) {
+        const double now[] = {c.a_now, c.b_now};
+        const double prev[] = {c.a_prev, c.b_prev};
+        MarketDataSnapshot snapshot;
+        snapshot.indicator_values = now;
+        snapshot.indicator_values_prev = prev;
+        const bool want[] = {c.crosses_above, c.crosses_below};
+        const Rule* rules[] = {&above, &below};
+        for (int r = 0; r < 2; ++r) {
+            const core::SignalAction expected = want[r] ? rules[r]->getAction() : core::SignalAction::None;
+            TP_CHECK_MSG(rules[r]->evaluate(snapshot) == expected && rules[r]->evaluateReference(snapshot) == expected,
+                         rules[r]->getName() << " prev (" << c.a_prev << ", " << c.b_prev << ") now (" << c.a_now << ", " << c.b_now << ")");
+        }
+        // No previous values at all (first bar)
+        snapshot.indicator_values_prev = {};
+        for (const Rule* rule : {&above, &below}) {
+            TP_CHECK(rule->evaluate(snapshot) == core::SignalAction::None);
+            TP_CHECK(rule->evaluateReference(snapshot) == core::SignalAction::None);
+        }
+    }
+}
@@ -0,0 +1,226 @@
+// core::utils::parseTimestamp / formatTimestamp against the std::get_time /
+// std::put_time implementation they replaced (copied below unchanged, minus
+// comments), on random timestamps and on random well-formed and malformed text.
+//
+// Known, documented differences (see core/src/utils.cpp):
+// - Fractions are exact integer nanoseconds; the old code went through a double
+//   and may be 1 ns off.
+// - The offset must be two-digit HH:MM; the old code also took "+5:30" or
+//   "+05:300" (300 minutes), and single-digit date fields. Text the new parser
+//   accepts, the old one accepts with the same value; the reverse holds only for
+//   fixed-width fields.
+// - Text after the offset is ignored by both.
+// Years stay within 1700..2199: a nanosecond Timestamp spans 1677..2262 only, and
+// formatTimestamp writes four-digit years.
+
+#include "check.hpp"
+#include "utils.hpp"
+
+#include <chrono>
+#include <cctype>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <iomanip>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+    // --- Reference: the previous stringToTimestamp() ---
+    core::Timestamp legacyStringToTimestamp(const std::string& iso_string) {
+        std::tm tm = {};
+        std::istringstream ss(iso_string);
+        ss >> std::get_time(&tm, "%Y-%m-%dT%H:%M:%S");
+        if (ss.fail()) throw std::runtime_error("date/time part");
+
+        double fractional_seconds = 0.0;
+        if (ss.peek() == '.') {
+            ss.ignore();
+            std::string digits;
+            int digit_count = 0;
+            while (std::isdigit(ss.peek()) && digit_count < 9) {
+                digits += static_cast<char>(ss.get());
+                digit_count++;
+            }
+            while (std::isdigit(ss.peek())) ss.ignore();
+            if (!digits.empty()) fractional_seconds = std::stod(digits) / std::pow(10.0, digits.length());
+        }
+
+        std::chrono::seconds offset_duration = std::chrono::seconds(0);
+        char sign_or_z = 0;
+        if (ss >> sign_or_z) {
+            if (sign_or_z == '+' || sign_or_z == '-') {
+                int offset_h = 0;
+                int offset_m = 0;
+                char colon = ' ';
+                if (!(ss >> std::setw(2) >> offset_h >> colon >> std::setw(2) >> offset_m) || colon != ':') {
+                    throw std::runtime_error("timezone offset");
+                }
+                offset_duration = std::chrono::hours(offset_h) + std::chrono::minutes(offset_m);
+                if (sign_or_z == '-') offset_duration *= -1;
+            } else if (sign_or_z != 'Z') {
+                throw std::runtime_error("timezone indicator");
+            }
+        } else {
+            throw std::runtime_error("missing timezone");
+        }
+
+#ifdef _WIN32
+        time_t tt = _mkgmtime(&tm);
+#else
+        time_t tt = timegm(&tm);
+#endif
+        if (tt == (time_t)-1) throw std::runtime_error("timegm");
+        auto base_tp_utc = std::chrono::system_clock::from_time_t(tt);
+        base_tp_utc += std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::duration<double>(fractional_seconds));
+        return base_tp_utc - offset_duration;
+    }
+
+    // --- Reference: the previous timestampToString() ---
+    std::string legacyTimestampToString(const core::Timestamp& ts) {
+        auto ist_time_point = ts + std::chrono::hours(5) + std::chrono::minutes(30);
+        auto tt_ist = std::chrono::system_clock::to_time_t(ist_time_point);
+        std::tm time_tm;
+#ifdef _WIN32
+        gmtime_s(&time_tm, &tt_ist);
+#else
+        gmtime_r(&tt_ist, &time_tm);
+#endif
+        std::ostringstream oss;
+        oss << std::put_time(&time_tm, "%Y-%m-%dT%H:%M:%S");
+        oss << "+05:30";
+        return oss.str();
+    }
+
+    std::optional<core::Timestamp> legacyParse(const std::string& text) {
+        try {
+            return legacyStringToTimestamp(text);
+        } catch (const std::exception&) {
+            return std::nullopt;
+        }
+    }
+
+    std::optional<core::Timestamp> newParse(const std::string& text) {
+        core::Timestamp ts;
+        if (!core::utils::parseTimestamp(text, ts)) return std::nullopt;
+        return ts;
+    }
+
+    std::string twoDigits(unsigned value) {
+        return std::string(1, static_cast<char>('0' + value / 10 % 10)) + static_cast<char>('0' + value % 10);
+    }
+
+    // Well-formed text with random fields: any day 01..31 (rolls over), second 60,
+    // fractions of 0..12 digits, Z or +/-HH:MM, spaces before the offset
+    std::string wellFormed(std::mt19937_64& rng, bool& has_fraction) {
+        auto pick = [&](unsigned lo, unsigned hi) { return std::uniform_int_distribution<unsigned>(lo, hi)(rng); };
+        std::string text = std::to_string(pick(1700, 2199)) + "-" + twoDigits(pick(1, 12)) + "-" + twoDigits(pick(1, 31)) +
+                           "T" + twoDigits(pick(0, 23)) + ":" + twoDigits(pick(0, 59)) + ":" + twoDigits(pick(0, 60));
+        has_fraction = pick(0, 2) == 0;
+        if (has_fraction) {
+            text += '.';
+            for (unsigned digits = pick(0, 12); digits > 0; --digits) text += static_cast<char>('0' + pick(0, 9));
+        }
+        if (pick(0, 9) == 0) text += "  ";
+        switch (pick(0, 3)) {
+            case 0: text += 'Z'; break;
+            case 1: text += "+05:30"; break;
+            default: text += (pick(0, 1) ? "+" : "-") + twoDigits(pick(0, 23)) + ":" + twoDigits(pick(0, 59)); break;
+        }
+        if (pick(0, 19) == 0) text += pick(0, 1) ? " trailing" : "[Asia/Kolkata]"; // Ignored by both
+        return text;
+    }
+
+    // A well-formed string with 1..3 characters replaced, inserted or removed
+    std::string mutated(std::mt19937_64& rng) {
+        bool ignored = false;
+        std::string text = wellFormed(rng, ignored);
+        static const char alphabet[] = "0123456789-+:.TZ x";
+        const int edits = std::uniform_int_distribution<int>(1, 3)(rng);
+        for (int e = 0; e < edits && !text.empty(); ++e) {
+            const std::size_t at = std::uniform_int_distribution<std::size_t>(0, text.size() - 1)(rng);
+            const char c = alphabet[std::uniform_int_distribution<std::size_t>(0, sizeof(alphabet) - 2)(rng)];
+            switch (std::uniform_int_distribution<int>(0, 2)(rng)) {
+                case 0: text[at] = c; break;
+                case 1: text.insert(text.begin() + static_cast<std::ptrdiff_t>(at), c); break;
+                default: text.erase(at, 1); break;
+            }
+        }
+        return text;
+    }
+
+    // 1700-01-01T00:00:00Z .. 2200-01-01T00:00:00Z, in seconds since the epoch
+    constexpr std::int64_t kFirstSecond = -8520336000LL;
+    constexpr std::int64_t kLastSecond = 7258118400LL;
+
+} // end anonymous namespace
+
+TP_CHECK_CASE(timestampParseMatchesStreams, "core.timestamps") {
+    std::mt19937_64 rng(17);
+    std::size_t fraction_cases = 0;
+    for (int i = 0; i < 200000; ++i) {
+        bool has_fraction = false;
+        const std::string text = wellFormed(rng, has_fraction);
+        const auto expected = legacyParse(text);
+        const auto actual = newParse(text);
+        TP_CHECK_MSG(expected && actual, text << ": accepted by old " << expected.has_value() << ", new " << actual.has_value());
+        if (!expected || !actual) continue;
+        // The old code rounded fractions through a double
+        const auto difference = std::chrono::abs(*actual - *expected);
+        TP_CHECK_MSG(has_fraction ? difference <= std::chrono::nanoseconds(1) : difference.count() == 0,
+                     text << ": differs by " << std::chrono::duration_cast<std::chrono::nanoseconds>(difference).count() << " ns");
+        fraction_cases += has_fraction;
+    }
+    TP_CHECK(fraction_cases > 10000);
+}
+
+TP_CHECK_CASE(timestampParseMalformedText, "core.timestamps.malformed") {
+    std::mt19937_64 rng(23);
+    std::size_t rejected = 0;
+    for (int i = 0; i < 200000; ++i) {
+        const std::string text = mutated(rng);
+        const auto expected = legacyParse(text);
+        const auto actual = newParse(text);
+        if (!actual) {
+            ++rejected;
+            continue;
+        }
+        // Whatever the fixed-format parser accepts, the old one accepted with the same value
+        TP_CHECK_MSG(expected.has_value(), "'" << text << "' accepted, the old parser rejected it");
+        if (expected) {
+            TP_CHECK_MSG(std::chrono::abs(*actual - *expected) <= std::chrono::nanoseconds(1), "'" << text << "' differs");
+        }
+    }
+    TP_CHECK_MSG(rejected > 20000, rejected << " of 200000 mutated strings rejected");
+    for (const char* text : {"", "2024-01-01", "2024-01-01T09:15:00", "2024-01-01T09:15:00+5:30", "2024-01-01T09:15:00+05:300", "2024-13-01T09:15:00Z",
+                             "2024-01-32T09:15:00Z", "2024-01-01T24:00:00Z", "2024-01-01T09:60:00Z", "2024-01-01T09:15:61Z",
+                             "2024-01-01 09:15:00Z", "2024-01-01T09:15:00X"}) {
+        TP_CHECK_MSG(!newParse(text), "'" << text << "' accepted");
+    }
+    for (const char* text : {"2024-01-01T09:15:00+05:30 IST", "2024-01-01T09:15:00Z0", "2024-01-01T09:15:00 +05:30"}) {
+        TP_CHECK_MSG(newParse(text) && newParse(text) == legacyParse(text), "'" << text << "' rejected or differs");
+    }
+}
+
+TP_CHECK_CASE(timestampFormatMatchesStreams, "core.timestamps.format") {
+    std::mt19937_64 rng(29);
+    std::uniform_int_distribution<std::int64_t> second(kFirstSecond, kLastSecond);
+    std::uniform_int_distribution<std::int64_t> nanos(0, 999'999'999);
+    for (int i = 0; i < 200000; ++i) {
+        const std::int64_t s = second(rng);
+        // Sub-second parts only after 1970: to_time_t truncated towards zero before it
+        const std::int64_t ns = s >= 0 && i % 2 == 0 ? nanos(rng) : 0;
+        const core::Timestamp ts = core::utils::epochNanosToTimestamp(0) + std::chrono::seconds(s) +
+                                   std::chrono::duration_cast<core::Timestamp::duration>(std::chrono::nanoseconds(ns));
+        const std::string expected = legacyTimestampToString(ts);
+        const std::string actual = core::utils::timestampToString(ts);
+        TP_CHECK_MSG(actual == expected, s << " s: '" << actual << "' vs '" << expected << "'");
+        // And back: whole seconds survive the round trip
+        TP_CHECK_MSG(newParse(actual) == std::chrono::floor<std::chrono::seconds>(ts), actual << " does not round-trip");
+    }
+}